@@ -42,12 +42,48 @@ NRF_LOG_MODULE_REGISTER();
 #define NEXT_CONN_PARAMS_UPDATE_DELAY_MS    30000                                       /**< Time between each call to sd_ble_gap_conn_param_update after the first call (30 seconds). */
 #define MAX_CONN_PARAMS_UPDATE_COUNT        3                                           /**< Number of attempts before giving up the connection parameter negotiation. */
 
+#define IDLE_MIN_CONN_INTERVAL              MSEC_TO_UNITS(75, UNIT_1_25_MS)             /**< Minimum connection interval while the session is idle. */
+#define IDLE_MAX_CONN_INTERVAL              MSEC_TO_UNITS(100, UNIT_1_25_MS)            /**< Maximum connection interval while the session is idle. */
+#define IDLE_SLAVE_LATENCY                  2                                           /**< Slave latency while the session is idle, a command waits 300 ms at most. */
+
+#define CONN_PROFILE_CHECK_MS               1000                                        /**< Period of checking the traffic of the connection. */
+#define CONN_PROFILE_BULK_BYTES             512                                         /**< Traffic in one check period that switches to the fast profile. */
+#define CONN_PROFILE_IDLE_BYTES             64                                          /**< Traffic in one check period below which the session counts as idle. */
+#define CONN_PROFILE_IDLE_COUNT             10                                          /**< Idle check periods in a row that switch to the idle profile. */
+#define CONN_PROFILE_IDLE_COUNT_MAX         160                                         /**< The most idle check periods in a row asked for, after the central has rejected the idle profile. */
+
 #define APP_BLE_PACKET_DATA_LEN             (BLE_GATT_ATT_MTU_DEFAULT - OPCODE_LENGTH - HANDLE_LENGTH)
 
 NRF_BLE_GATT_DEF(m_gatt);                                                           /**< GATT module instance. */
 NRF_BLE_QWR_DEF(m_qwr);                                                             /**< Context for the Queued Write module.*/
 APP_TIMER_DEF(sec_check_tmr);
 app_timer_t* p_sec_check_tmr = (app_timer_t*)sec_check_tmr;
+APP_TIMER_DEF(conn_profile_tmr);
+
+typedef enum
+{
+    CONN_PROFILE_FAST,      /**< Short interval without latency, for bulk transfers and streaming. */
+    CONN_PROFILE_IDLE,      /**< Long interval with slave latency, for idle sessions. */
+} conn_profile_t;
+
+static const ble_gap_conn_params_t conn_profile_params[] = {
+    [CONN_PROFILE_FAST] = {
+        .min_conn_interval = MIN_CONN_INTERVAL,
+        .max_conn_interval = MAX_CONN_INTERVAL,
+        .slave_latency     = SLAVE_LATENCY,
+        .conn_sup_timeout  = CONN_SUP_TIMEOUT,
+    },
+    [CONN_PROFILE_IDLE] = {
+        .min_conn_interval = IDLE_MIN_CONN_INTERVAL,
+        .max_conn_interval = IDLE_MAX_CONN_INTERVAL,
+        .slave_latency     = IDLE_SLAVE_LATENCY,
+        .conn_sup_timeout  = CONN_SUP_TIMEOUT,
+    },
+};
+
+static conn_profile_t m_conn_profile = CONN_PROFILE_FAST;                           /**< The connection parameters requested for the current workload. */
+static uint8_t        m_conn_idle_count = 0;                                        /**< The number of check periods without traffic. */
+static uint8_t        m_conn_idle_limit = CONN_PROFILE_IDLE_COUNT;                  /**< The idle check periods in a row that switch to the idle profile, doubled each time the central rejects it. */
 
 static uint16_t   m_conn_handle          = BLE_CONN_HANDLE_INVALID;                 /**< Handle of the current connection. */
 static uint16_t   m_ble_nus_max_data_len = APP_BLE_PACKET_DATA_LEN;                 /**< Maximum length of data (in bytes) that can be transmitted to the peer by the Nordic UART service module. */
@@ -85,10 +121,18 @@ static void ble_evt_handler(ble_evt_t const * p_ble_evt, void * p_context)
             NRF_LOG_INFO("Connected...");
             ble_status.disconnection_reason = 0;
             m_conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+            m_ble_nus_max_data_len = APP_BLE_PACKET_DATA_LEN;
+            m_conn_profile = CONN_PROFILE_FAST;
+            m_conn_idle_count = 0;
+            m_conn_idle_limit = CONN_PROFILE_IDLE_COUNT;
+            (void)app_ble_nus_traffic_get();
 
             err_code = nrf_ble_qwr_conn_handle_assign(&m_qwr, m_conn_handle);
             APP_ERROR_CHECK(err_code);
 
+            err_code = app_timer_start(conn_profile_tmr, APP_TIMER_TICKS(CONN_PROFILE_CHECK_MS), NULL);
+            APP_ERROR_CHECK(err_code);
+
             if (sec_check_timeout > 0)
             {
                 err_code = app_timer_start(sec_check_tmr, APP_TIMER_TICKS(sec_check_timeout*1000), NULL);
@@ -103,6 +147,8 @@ static void ble_evt_handler(ble_evt_t const * p_ble_evt, void * p_context)
 
             err_code = app_timer_stop(sec_check_tmr);
             APP_ERROR_CHECK(err_code);
+            err_code = app_timer_stop(conn_profile_tmr);
+            APP_ERROR_CHECK(err_code);
 
             m_conn_handle = BLE_CONN_HANDLE_INVALID;
             break;
@@ -173,6 +219,13 @@ static void ble_stack_init(void)
 
     // Register a handler for BLE events.
     NRF_SDH_BLE_OBSERVER(m_ble_observer, APP_BLE_OBSERVER_PRIO, ble_evt_handler, NULL);
+
+    // Extend the connection event while there are notifications to send.
+    ble_opt_t opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.common_opt.conn_evt_ext.enable = 1;
+    err_code = sd_ble_opt_set(BLE_COMMON_OPT_CONN_EVT_EXT, &opt);
+    APP_ERROR_CHECK(err_code);
 }
 
 /**
@@ -245,9 +298,19 @@ static void on_conn_params_evt(ble_conn_params_evt_t * p_evt)
     {
         NRF_LOG_DEBUG("BLE_CONN_PARAMS_EVT_SUCCEEDED");
     }
+    else if (p_evt->evt_type == BLE_CONN_PARAMS_EVT_FAILED && m_conn_profile == CONN_PROFILE_IDLE)
+    {
+        //The central keeps the fast interval, which is still acceptable.
+        //The idle profile is asked for again only after twice as long idle, so a central that always rejects it is not asked every check period.
+        NRF_LOG_INFO("Idle connection parameters rejected");
+        m_conn_profile = CONN_PROFILE_FAST;
+        m_conn_idle_count = 0;
+        m_conn_idle_limit = (m_conn_idle_limit < (CONN_PROFILE_IDLE_COUNT_MAX / 2)) ? (uint8_t)(m_conn_idle_limit * 2) : CONN_PROFILE_IDLE_COUNT_MAX;
+        (void)ble_conn_params_change_conn_params(m_conn_handle, (ble_gap_conn_params_t*)&conn_profile_params[CONN_PROFILE_FAST]);
+    }
     else if (p_evt->evt_type == BLE_CONN_PARAMS_EVT_FAILED)
     {
-        NRF_LOG_DEBUG("BLE_CONN_PARAMS_EVT_SUCCEEDED");
+        NRF_LOG_DEBUG("BLE_CONN_PARAMS_EVT_FAILED");
         err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_CONN_INTERVAL_UNACCEPTABLE);
         APP_ERROR_CHECK(err_code);
     }
@@ -290,6 +353,67 @@ static void conn_params_init(void)
     ble_conn_state_init();
 }
 
+/**
+ * @brief Request the connection parameters of the profile.
+ * 
+ * @param profile The connection profile.
+ */
+static void conn_profile_set(conn_profile_t profile)
+{
+    if (profile == m_conn_profile)
+    {
+        return;
+    }
+
+    ret_code_t err_code = ble_conn_params_change_conn_params(m_conn_handle, (ble_gap_conn_params_t*)&conn_profile_params[profile]);
+    if (err_code == NRF_SUCCESS)
+    {
+        NRF_LOG_INFO("Connection profile %d", profile);
+        m_conn_profile = profile;
+        if (profile == CONN_PROFILE_FAST)
+        {
+            //Ask for the largest data length again, the central may have kept the default
+            (void)sd_ble_gap_data_length_update(m_conn_handle, NULL, NULL);
+        }
+    }
+    else
+    {
+        //A procedure is still in progress, try again in the next check
+        NRF_LOG_DEBUG("Connection profile %d: 0x%x", profile, err_code);
+    }
+}
+
+/**
+ * @brief Timer handler for choosing the connection parameters by the traffic of the connection.
+ * The fast profile is used as soon as a bulk transfer or stream runs, and the idle profile
+ * after a while with little traffic.
+ * 
+ * @param p_context Unused
+ */
+static void conn_profile_timer_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    uint32_t bytes = app_ble_nus_traffic_get();
+    if (bytes >= CONN_PROFILE_BULK_BYTES)
+    {
+        m_conn_idle_count = 0;
+        conn_profile_set(CONN_PROFILE_FAST);
+    }
+    else if (bytes >= CONN_PROFILE_IDLE_BYTES)
+    {
+        m_conn_idle_count = 0;
+    }
+    else if (m_conn_idle_count < m_conn_idle_limit)
+    {
+        m_conn_idle_count++;
+    }
+    else
+    {
+        conn_profile_set(CONN_PROFILE_IDLE);
+    }
+}
+
 /**
  * @brief Timer handler for Security check.
  * 
@@ -335,6 +459,7 @@ void app_ble_init(void)
     app_ble_adv_init();
 
     APP_ERROR_CHECK(app_timer_create(&sec_check_tmr, APP_TIMER_MODE_SINGLE_SHOT, sec_check_timer_handler));
+    APP_ERROR_CHECK(app_timer_create(&conn_profile_tmr, APP_TIMER_MODE_REPEATED, conn_profile_timer_handler));
 }
 
 /**
@@ -373,6 +498,18 @@ void app_ble_stop_adv(void)
     app_ble_adv_stop();
 }
 
+/**
+ * @brief Update the manufacturer specific data of the running advertising.
+ * 
+ * @param p_ma_sp_data Manufacturer specific data of advertising data
+ * @param data_len Length of manufacturer specific data
+ * @return uint32_t NRF_SUCCESS if updated, NRF_ERROR_INVALID_STATE if not advertising.
+ */
+uint32_t app_ble_update_adv(uint8_t* p_ma_sp_data, uint8_t data_len)
+{
+    return app_ble_adv_msd_update(p_ma_sp_data, data_len);
+}
+
 /**
  * @brief Add an address to the whitelist
  * 
@@ -405,6 +542,16 @@ uint32_t app_ble_data_send(uint8_t* p_data, uint16_t* p_length)
     return app_ble_nus_data_send(p_data, p_length);
 }
 
+/**
+ * @brief Get the maximum length of data that can be sent in a notification.
+ * 
+ * @return uint16_t The maximum length of data.
+ */
+uint16_t app_ble_data_len_get(void)
+{
+    return m_ble_nus_max_data_len;
+}
+
 /**
  * @brief Get the status of BLE
  * 
@@ -59,6 +59,15 @@ void app_ble_start_adv(uint8_t* passkey, bool whitelist_enable, uint32_t adv_tim
  */
 void app_ble_stop_adv(void);
 
+/**
+ * @brief Update the manufacturer specific data of the running advertising.
+ * 
+ * @param p_ma_sp_data Manufacturer specific data of advertising data
+ * @param data_len Length of manufacturer specific data
+ * @return uint32_t NRF_SUCCESS if updated, NRF_ERROR_INVALID_STATE if not advertising.
+ */
+uint32_t app_ble_update_adv(uint8_t* p_ma_sp_data, uint8_t data_len);
+
 /**
  * @brief Add an address to the whitelist
  * 
@@ -82,6 +91,13 @@ void app_ble_peers_del(void);
  */
 uint32_t  app_ble_data_send(uint8_t* p_data, uint16_t* p_length);
 
+/**
+ * @brief Get the maximum length of data that can be sent in a notification.
+ * 
+ * @return uint16_t The maximum length of data.
+ */
+uint16_t app_ble_data_len_get(void);
+
 /**
  * @brief Get the status of BLE
  * 
@@ -147,6 +147,21 @@ void app_ble_adv_init(void)
     ble_advertising_conn_cfg_tag_set(&m_advertising, APP_BLE_CONN_CFG_TAG);
 }
 
+/**
+ * @brief Set the manufacturer specific data of the advertising data.
+ * 
+ * @param p_ma_sp_data Manufacturer specific data of advertising data
+ * @param data_len Length of manufacturer specific data
+ */
+static void app_ble_adv_msd_set(uint8_t* p_ma_sp_data, uint8_t data_len)
+{
+    ble_advdata_t const * const p_advdata = &adv_init.advdata;
+    p_advdata->p_manuf_specific_data->company_identifier = *((uint16_t*)p_ma_sp_data);
+    uint8_t ma_sp_data_data_len = data_len - AD_TYPE_MANUF_SPEC_DATA_ID_SIZE;
+    p_advdata->p_manuf_specific_data->data.size = ma_sp_data_data_len;
+    memcpy(p_advdata->p_manuf_specific_data->data.p_data, &p_ma_sp_data[AD_TYPE_MANUF_SPEC_DATA_ID_SIZE], ma_sp_data_data_len);
+}
+
 /**
  * @brief Function for start the Advertising functionality.
  * 
@@ -175,10 +190,7 @@ void app_ble_adv_start(bool whitelist_enable, uint32_t adv_timeout, uint8_t* p_m
 
         ble_advdata_t const * const p_advdata = &adv_init.advdata;
         ble_advdata_t const * const p_srdata = &adv_init.srdata;
-        p_advdata->p_manuf_specific_data->company_identifier = *((uint16_t*)p_ma_sp_data);
-        uint8_t ma_sp_data_data_len = data_len - AD_TYPE_MANUF_SPEC_DATA_ID_SIZE;
-        p_advdata->p_manuf_specific_data->data.size = ma_sp_data_data_len;
-        memcpy(p_advdata->p_manuf_specific_data->data.p_data, &p_ma_sp_data[AD_TYPE_MANUF_SPEC_DATA_ID_SIZE], ma_sp_data_data_len);
+        app_ble_adv_msd_set(p_ma_sp_data, data_len);
 
         if (adv_enable)
             sd_ble_gap_adv_stop(m_advertising.adv_handle);
@@ -190,6 +202,24 @@ void app_ble_adv_start(bool whitelist_enable, uint32_t adv_timeout, uint8_t* p_m
     }
 }
 
+/**
+ * @brief Update the manufacturer specific data of the running advertising.
+ * The data is encoded into the other buffer of the advertising module and swapped in,
+ * so the advertising mode and its timeout carry on.
+ * 
+ * @param p_ma_sp_data Manufacturer specific data of advertising data
+ * @param data_len Length of manufacturer specific data
+ * @return uint32_t NRF_SUCCESS if updated, NRF_ERROR_INVALID_STATE if not advertising.
+ */
+uint32_t app_ble_adv_msd_update(uint8_t* p_ma_sp_data, uint8_t data_len)
+{
+    if (!adv_enable || m_conn_handle != BLE_CONN_HANDLE_INVALID)
+        return NRF_ERROR_INVALID_STATE;
+
+    app_ble_adv_msd_set(p_ma_sp_data, data_len);
+    return ble_advertising_advdata_update(&m_advertising, &adv_init.advdata, &adv_init.srdata);
+}
+
 /**
  * @brief Function for stop the Advertising functionality.
  * 
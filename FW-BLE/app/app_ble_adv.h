@@ -42,6 +42,17 @@ void app_ble_adv_start(bool whitelist_enable, uint32_t adv_timeout, uint8_t* p_m
  */
 void app_ble_adv_stop(void);
 
+/**
+ * @brief Update the manufacturer specific data of the running advertising.
+ * The data is encoded into the other buffer of the advertising module and swapped in,
+ * so the advertising mode and its timeout carry on.
+ * 
+ * @param p_ma_sp_data Manufacturer specific data of advertising data
+ * @param data_len Length of manufacturer specific data
+ * @return uint32_t NRF_SUCCESS if updated, NRF_ERROR_INVALID_STATE if not advertising.
+ */
+uint32_t app_ble_adv_msd_update(uint8_t* p_ma_sp_data, uint8_t data_len);
+
 /**
  * @brief Get the status of the advertising
  * 
@@ -11,6 +11,7 @@
 #include "app_ble_nus.h"
 
 #include "app_sp.h"
+#include "app_util_platform.h"
 
 #define NRF_LOG_MODULE_NAME APP_BLE_NUS
 #define NRF_LOG_LEVEL       3
@@ -28,6 +29,8 @@ static uint16_t m_conn_handle = BLE_CONN_HANDLE_INVALID;
 
 static bool sec_enable = false;
 
+static uint32_t traffic_bytes = 0;      /**< The number of data bytes sent and received since the last check. */
+
 /**
  * @brief Function for handling Queued Write Module errors.
  * 
@@ -50,6 +53,7 @@ static void nus_data_handler(ble_nus_evt_t * p_evt)
     if (p_evt->type == BLE_NUS_EVT_RX_DATA)
     {
         NRF_LOG_INFO("Rx(%d)[0x%02x]", p_evt->params.rx_data.length, p_evt->params.rx_data.p_data[0]);
+        traffic_bytes += p_evt->params.rx_data.length;
 
         if (sec_enable)
         {
@@ -115,7 +119,12 @@ uint32_t app_ble_nus_data_send(uint8_t* p_data, uint16_t* p_length)
     if (sec_enable)
     {
         NRF_LOG_INFO("Tx(%d)[0x%02x]", *p_length, p_data[0]);
-        return ble_nus_data_send(&m_nus, p_data, p_length, m_conn_handle);
+        uint32_t err_code = ble_nus_data_send(&m_nus, p_data, p_length, m_conn_handle);
+        if (err_code == NRF_SUCCESS)
+        {
+            traffic_bytes += *p_length;
+        }
+        return err_code;
     }
     else
     {
@@ -145,6 +154,21 @@ bool app_ble_nus_is_ready(void)
     return is_ready;
 }
 
+/**
+ * @brief Get the number of data bytes sent and received since the last call.
+ * 
+ * @return uint32_t The number of data bytes.
+ */
+uint32_t app_ble_nus_traffic_get(void)
+{
+    uint32_t bytes;
+    CRITICAL_REGION_ENTER();
+    bytes = traffic_bytes;
+    traffic_bytes = 0;
+    CRITICAL_REGION_EXIT();
+    return bytes;
+}
+
 /**
  * @brief Function for handling BLE events.
  *
@@ -43,4 +43,11 @@ uint32_t  app_ble_nus_data_send(uint8_t* p_data, uint16_t* p_length);
  */
 bool      app_ble_nus_is_ready(void);
 
+/**
+ * @brief Get the number of data bytes sent and received since the last call.
+ * 
+ * @return uint32_t The number of data bytes.
+ */
+uint32_t  app_ble_nus_traffic_get(void);
+
 #endif
\ No newline at end of file
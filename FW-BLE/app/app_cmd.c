@@ -131,6 +131,21 @@ app_cmd_resp_t* app_cmd_parse_request(uint8_t* p_cmd, uint16_t cmd_len)
                 }
                 break;
 
+            case OPCODE_BLE_ADV_MSD_UPDATE:
+                if (req_payload_length >= APP_BLE_MA_SP_DATA_LEN_MIN &&
+                    req_payload_length <= APP_BLE_MA_SP_DATA_LEN_MAX)
+                {
+                    if (app_ble_update_adv(&p_cmd[req_payload_offset], req_payload_length) != NRF_SUCCESS)
+                    {
+                        resp_status = STATUS_INVALID;
+                    }
+                }
+                else
+                {
+                    resp_status = STATUS_PAYLOAD_LEN_ERR;
+                }
+                break;
+
             case OPCODE_BLE_ADV_STOP:
                 if (req_payload_length == 0)
                 {
@@ -201,6 +216,18 @@ app_cmd_resp_t* app_cmd_parse_request(uint8_t* p_cmd, uint16_t cmd_len)
                 }
                 break;
 
+            case OPCODE_BLE_SP_STAT_GET:
+                if (req_payload_length == 0)
+                {
+                    resp_payload = (uint8_t*)app_sp_stat_get();
+                    resp_payload_length = sizeof(app_sp_stat_t);
+                }
+                else
+                {
+                    resp_status = STATUS_PAYLOAD_LEN_ERR;
+                }
+                break;
+
             default:
                 resp_status = STATUS_OPCODE_ERR;
                 break;
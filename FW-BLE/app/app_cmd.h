@@ -20,6 +20,8 @@
 #define OPCODE_BLE_DISCONNECT                       0x53
 #define OPCODE_BLE_WL_ADD                           0x54
 #define OPCODE_BLE_DEL_PEERS                        0x55
+#define OPCODE_BLE_SP_STAT_GET                      0x56
+#define OPCODE_BLE_ADV_MSD_UPDATE                   0x57
 
 #define STATUS_SUCCESS                              0x00
 #define STATUS_INVALID                              0x01
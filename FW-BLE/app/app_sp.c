@@ -16,6 +16,7 @@
 #include "app_cmd.h"
 
 #include "app_timer.h"
+#include "app_util_platform.h"
 
 
 
@@ -32,10 +33,13 @@ NRF_LOG_MODULE_REGISTER();
 
 static uint8_t data_buffer[DATA_BUFFER_GROUP_COUNT][DATA_BUFFER_MAX_SIZE];
 static uint16_t data_lengths[DATA_BUFFER_GROUP_COUNT];
+static uint8_t packet[DATA_BUFFER_MAX_SIZE];
 
 static uint8_t write_idx = 0;
 static uint8_t read_idx = 0;
-static uint8_t data_count = 0;
+static volatile uint8_t data_count = 0;
+
+static app_sp_stat_t stat;
 
 static bool init = false;
 
@@ -47,7 +51,21 @@ typedef struct
 
 static app_sp_cmd_resp_t response;
 
+/**
+ * @brief Add the frame to the forwarding buffer.
+ * The SPIS stops receiving while the buffer is full, so a frame is only dropped
+ * if it arrives on a port without flow control, and then it is counted.
+ * 
+ * @param data The frame to add.
+ * @param size The size of the frame.
+ */
 static void buffer_add(const uint8_t* data, uint16_t size) {
+    if (data_count >= DATA_BUFFER_GROUP_COUNT) {
+        stat.frames_dropped++;
+        NRF_LOG_WARNING("Frame dropped(%d)", stat.frames_dropped);
+        return;
+    }
+
     if (size > DATA_BUFFER_MAX_SIZE) {
         size = DATA_BUFFER_MAX_SIZE; 
     }
@@ -57,11 +75,9 @@ static void buffer_add(const uint8_t* data, uint16_t size) {
 
     write_idx = (write_idx + 1) % DATA_BUFFER_GROUP_COUNT;
 
-    if (data_count < DATA_BUFFER_GROUP_COUNT) {
-        data_count++;
-    } else {
-        read_idx = (read_idx + 1) % DATA_BUFFER_GROUP_COUNT;
-    }
+    CRITICAL_REGION_ENTER();
+    data_count++;
+    CRITICAL_REGION_EXIT();
 }
 
 /**
@@ -152,22 +168,97 @@ void app_sp_on_tx_ready(uint8_t port)
     }
 }
 
+/**
+ * @brief Pack the frames from the read index of the forwarding buffer into one notification.
+ * Only whole frames are packed, so the peer splits the notification by the length of each frame.
+ * 
+ * @param pp_data The data of the notification.
+ * @param p_size The size of the notification.
+ * @return uint8_t The number of frames packed.
+ */
+static uint8_t buffer_pack(uint8_t** pp_data, uint16_t* p_size)
+{
+    uint8_t idx = read_idx;
+    uint8_t num = 1;
+    uint16_t size = data_lengths[idx];
+
+    *pp_data = data_buffer[idx];
+    if (APP_BLE_NUS_PACK_ENABLE)
+    {
+        uint16_t len_max = app_ble_data_len_get();
+        idx = (idx + 1) % DATA_BUFFER_GROUP_COUNT;
+        while ((num < data_count) && ((size + data_lengths[idx]) <= len_max))
+        {
+            if (num == 1)
+            {
+                memcpy(packet, data_buffer[read_idx], size);
+                *pp_data = packet;
+            }
+            memcpy(&packet[size], data_buffer[idx], data_lengths[idx]);
+            size += data_lengths[idx];
+            num++;
+            idx = (idx + 1) % DATA_BUFFER_GROUP_COUNT;
+        }
+    }
+    *p_size = size;
+    return num;
+}
+
 /**
  * @brief Handler for transferring data from serial port to BLE.
+ * The notifications are sent until the BLE stack has no room, so every connection event is filled.
+ * The frames of a notification not taken are kept in the forwarding buffer and sent again
+ * after the next BLE event.
  * 
  */
 void app_sp_ble_handler(void)
 {
-    if (data_count == 0) {
-        return;
-    }
+    app_sp_spis_rx_handler();
+
+    while (data_count > 0)
+    {
+        uint8_t* data;
+        uint16_t size;
+        uint8_t num = buffer_pack(&data, &size);
+
+        uint32_t err_code = app_ble_data_send(data, &size);
+        if (err_code == NRF_ERROR_RESOURCES)
+        {
+            stat.tx_busy++;
+            break;
+        }
+        else if (err_code != NRF_SUCCESS)
+        {
+            stat.frames_dropped += num;
+            NRF_LOG_WARNING("Tx failed(0x%x)", err_code);
+        }
 
-    uint8_t* data = data_buffer[read_idx];
-    uint16_t size = data_lengths[read_idx];
+        read_idx = (read_idx + num) % DATA_BUFFER_GROUP_COUNT;
+        CRITICAL_REGION_ENTER();
+        data_count -= num;
+        CRITICAL_REGION_EXIT();
+
+        app_sp_spis_resume();
+    }
+}
 
-    app_ble_data_send(data, &size);
+/**
+ * @brief Get the number of frames the forwarding buffer can still take from the serial port.
+ * 
+ * @return uint8_t The number of free frames in the forwarding buffer.
+ */
+uint8_t app_sp_rx_space_get(void)
+{
+    return (uint8_t)(DATA_BUFFER_GROUP_COUNT - data_count);
+}
 
-    read_idx = (read_idx + 1) % DATA_BUFFER_GROUP_COUNT;
-    data_count--;
+/**
+ * @brief Get the statistics of the forwarding buffer.
+ * 
+ * @return app_sp_stat_t* The statistics of the forwarding buffer.
+ */
+app_sp_stat_t* app_sp_stat_get(void)
+{
+    return &stat;
 }
 
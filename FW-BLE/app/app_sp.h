@@ -12,6 +12,7 @@
 #define APP_SP_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #define SP_ALL    0
 #define SP_SPI    1
@@ -20,6 +21,13 @@
 #define DATA_BUFFER_MAX_SIZE      256
 #define DATA_BUFFER_GROUP_COUNT   10
 
+typedef struct
+{
+    uint32_t frames_dropped;    /**< The number of frames dropped because the forwarding buffer was full. */
+    uint32_t rx_paused;         /**< The number of times the SPIS stopped receiving until the forwarding buffer had room. */
+    uint32_t tx_busy;           /**< The number of times a notification was kept for retry because the BLE stack had no room. */
+} app_sp_stat_t;
+
 /**
  * @brief Initialization of the serial port.
  * 
@@ -57,4 +65,18 @@ void app_sp_on_tx_ready(uint8_t port);
  */
 void app_sp_ble_handler(void);
 
+/**
+ * @brief Get the number of frames the forwarding buffer can still take from the serial port.
+ * 
+ * @return uint8_t The number of free frames in the forwarding buffer.
+ */
+uint8_t app_sp_rx_space_get(void);
+
+/**
+ * @brief Get the statistics of the forwarding buffer.
+ * 
+ * @return app_sp_stat_t* The statistics of the forwarding buffer.
+ */
+app_sp_stat_t* app_sp_stat_get(void);
+
 #endif
\ No newline at end of file
@@ -15,6 +15,7 @@
 #include "nrf_drv_spis.h"
 #include "nrf_gpio.h"
 #include "app_error.h"
+#include "app_util_platform.h"
 
 #define NRF_LOG_MODULE_NAME APP_SP_SPIS
 #define NRF_LOG_LEVEL       3
@@ -29,16 +30,105 @@ NRF_LOG_MODULE_REGISTER();
 static const nrf_drv_spis_t spis = NRF_DRV_SPIS_INSTANCE(SPIS_INSTANCE);/**< SPIS instance. */
 
 #define RX_BUF_SIZE                DATA_BUFFER_MAX_SIZE
-#define TX_BUF_SIZE                (DATA_BUFFER_MAX_SIZE + 1)    //1 byte data length + data
+#define RX_QUEUE_NUM               4                             //The number of received data waiting for the main context
+#define TX_RING_SIZE               (DATA_BUFFER_MAX_SIZE * 2)    //Slot 0 + data slots 1 ~ TX_RING_SIZE-1
+#define TX_RING_LAST               (TX_RING_SIZE - 1)
+#define TX_RING_CAPACITY           (TX_RING_LAST - 1)            //The slot before the tail is kept free for the data length
+#define TX_XFER_DATA_MAX           0xFF                          //The data length of one transfer is sent in 1 byte
 
-static volatile uint8_t m_tx_buf[TX_BUF_SIZE];
-static volatile uint8_t m_rx_buf[RX_BUF_SIZE];
+/*
+ * The interrupt only hands the received data over and sets the buffers again. The data is parsed,
+ * forwarded and logged in the main context, so the time until BLE_RDY is set again does not depend
+ * on the command or the log backend.
+ *
+ * The tx data is queued in a ring and sent straight from it, so nothing is moved after a transfer.
+ * Each transfer starts at the slot before the tail, which holds the length of the contiguous data
+ * after it, so the master reads [length][data] as before. Slot 0 is the length slot when the tail
+ * wraps back to slot 1.
+ */
+static volatile uint8_t m_tx_ring[TX_RING_SIZE];
+static volatile uint8_t m_rx_queue[RX_QUEUE_NUM][RX_BUF_SIZE];
+static volatile uint16_t m_rx_lengths[RX_QUEUE_NUM];
+
+static volatile uint16_t tx_head = 1;   /**< The slot to put the next data. */
+static volatile uint16_t tx_tail = 1;   /**< The slot of the first data not sent yet. */
+static volatile uint16_t tx_count = 0;  /**< The number of data not sent yet. */
+static volatile uint32_t tx_sent = 0;   /**< The number of data sent since the last log. */
 
-static uint8_t tx_offset = 0;
+static volatile uint8_t rx_head = 0;    /**< The rx buffer set for the next transfer. */
+static volatile uint8_t rx_tail = 0;    /**< The first rx buffer not processed yet. */
+static volatile uint8_t rx_count = 0;   /**< The number of rx buffers not processed yet. */
 
 static volatile bool spis_xfer_done; /**< Flag used to indicate that SPIS instance completed the transfer. */
+static volatile bool spis_paused = false; /**< Flag used to indicate that SPIS instance waits for room in the forwarding buffer. */
 static bool init = false;
 
+/**
+ * @brief Get the length of the contiguous space from the tail of the tx ring that one transfer can cover.
+ *
+ * @return uint16_t The length of the space.
+ */
+static uint16_t app_sp_spis_tx_span_get(void)
+{
+    uint16_t span = TX_RING_SIZE - tx_tail;
+    return (span > TX_XFER_DATA_MAX) ? TX_XFER_DATA_MAX : span;
+}
+
+/**
+ * @brief Update the data length of the transfer in the slot before the tail of the tx ring.
+ *
+ */
+static void app_sp_spis_tx_len_update(void)
+{
+    uint16_t span = app_sp_spis_tx_span_get();
+    m_tx_ring[tx_tail - 1] = (uint8_t)((tx_count > span) ? span : tx_count);
+}
+
+/**
+ * @brief Advance the tail of the tx ring over the data sent by a transfer.
+ *
+ * @param sent The length of the data sent, without the length slot.
+ */
+static void app_sp_spis_tx_advance(uint16_t sent)
+{
+    if (sent > tx_count)
+    {
+        sent = tx_count;
+    }
+    tx_sent += sent;
+    tx_count -= sent;
+    tx_tail += sent;
+    if (tx_tail > TX_RING_LAST)
+    {
+        tx_tail = 1;
+    }
+}
+
+/**
+ * @brief Check whether the next data can be received.
+ * Every rx buffer not processed yet may still take a frame of the forwarding buffer.
+ *
+ * @return true There is room for the next data.
+ * @return false The rx buffers or the forwarding buffer are full.
+ */
+static bool app_sp_spis_rx_ready(void)
+{
+    return (rx_count < RX_QUEUE_NUM) && (app_sp_rx_space_get() > rx_count);
+}
+
+/**
+ * @brief Set the tx ring from the slot before the tail and the rx buffer for the next transfer.
+ * The rx buffer is left out while there is no room for the next data, so only the tx data can be read.
+ *
+ */
+static void app_sp_spis_buffers_set(void)
+{
+    app_sp_spis_tx_len_update();
+    APP_ERROR_CHECK(nrf_drv_spis_buffers_set(&spis, 
+                                            (uint8_t*)&m_tx_ring[tx_tail - 1], 1 + app_sp_spis_tx_span_get(), 
+                                            (uint8_t*)m_rx_queue[rx_head], app_sp_spis_rx_ready() ? RX_BUF_SIZE : 0));
+}
+
 /**
  * @brief SPIS user event handler.
  *
@@ -50,21 +140,17 @@ static void spis_event_handler(nrf_drv_spis_event_t event)
     switch(evt_type)
     {
         case NRFX_SPIS_BUFFERS_SET_DONE:
-            NRF_LOG_DEBUG("NRFX_SPIS_BUFFERS_SET_DONE");
-            nrf_gpio_pin_set(BLE_RDY_PIN);
-            init = true;
-            spis_xfer_done = false;
-            app_sp_on_tx_ready(SP_SPI);
-            if (tx_offset > 0)
+            //BLE_REQ is set before BLE_RDY, so the master does not write when only the tx data can be read
+            if (tx_count > 0)
             {
                 nrf_gpio_pin_set(BLE_REQ_PIN);
-                NRF_LOG_INFO("BLE_REQ_PIN[H]");
-                NRF_LOG_FLUSH();
             }
+            nrf_gpio_pin_set(BLE_RDY_PIN);
+            init = true;
+            spis_xfer_done = false;
             break;
 
         case NRF_DRV_SPIS_XFER_DONE:
-            NRF_LOG_DEBUG("NRF_DRV_SPIS_XFER_DONE");
             nrf_gpio_pin_clear(BLE_RDY_PIN);
 
             spis_xfer_done = true;
@@ -72,38 +158,32 @@ static void spis_event_handler(nrf_drv_spis_event_t event)
             size_t rx_size = event.rx_amount;
             if (nrf_gpio_pin_out_read(BLE_REQ_PIN) == 0 && rx_size > 0)
             {
-              NRF_LOG_INFO("Rx(%d)[0x%02x]", rx_size, m_rx_buf[0]);
-              NRF_LOG_HEXDUMP_INFO((uint8_t*)m_rx_buf, rx_size);
-              NRF_LOG_FLUSH();
-              app_sp_on_rx_data(SP_SPI, (uint8_t*)m_rx_buf, rx_size);
-              memset((uint8_t*)m_rx_buf, 0, rx_size);
-              memset((uint8_t*)m_tx_buf, 0, tx_size);
+              m_rx_lengths[rx_head] = (uint16_t)rx_size;
+              rx_head = (rx_head + 1) % RX_QUEUE_NUM;
+              rx_count++;
             }
             else if (nrf_gpio_pin_out_read(BLE_REQ_PIN) > 0 && tx_size > 1)
             {
-              NRF_LOG_INFO("Tx(%d)[0x%02x]", tx_size-1, m_tx_buf[1]);
-              NRF_LOG_HEXDUMP_INFO((uint8_t*)m_tx_buf+1, tx_size-1);
-              NRF_LOG_FLUSH();
               nrf_gpio_pin_clear(BLE_REQ_PIN);
-              NRF_LOG_INFO("BLE_REQ_PIN[L]");
-              NRF_LOG_FLUSH();
-              tx_offset -= (tx_size-1);
-              for(int i = (int)tx_size;i < TX_BUF_SIZE;i++)
-                m_tx_buf[i-tx_size+1] = m_tx_buf[i];
-             
-              m_tx_buf[0] = tx_offset;
-              //NRF_LOG_INFO("tx_offset: %d", tx_offset);
+              app_sp_spis_tx_advance((uint16_t)(tx_size - 1));
+            }
+
+            //BLE_RDY stays low while the forwarding buffer is full, so the master holds the next frame
+            if (app_sp_spis_rx_ready() || tx_count > 0)
+            {
+              app_sp_spis_buffers_set();
+            }
+            else
+            {
+              app_sp_stat_get()->rx_paused++;
+              spis_paused = true;
+              spis_xfer_done = false;
             }
-            APP_ERROR_CHECK(nrf_drv_spis_buffers_set(&spis, 
-                                                    (uint8_t*)m_tx_buf, TX_BUF_SIZE, 
-                                                    (uint8_t*)m_rx_buf, RX_BUF_SIZE));
             break;
 
         case NRFX_SPIS_EVT_TYPE_MAX:
-            NRF_LOG_DEBUG("NRFX_SPIS_EVT_TYPE_MAX");
             break;
     }
-    NRF_LOG_FLUSH();
 }
 
 /**
@@ -123,9 +203,15 @@ void app_sp_spis_init(void)
     nrf_gpio_pin_clear(BLE_RDY_PIN);
     nrf_gpio_pin_clear(BLE_REQ_PIN);
 
-    memset((uint8_t*)m_tx_buf, 0, TX_BUF_SIZE);
-    memset((uint8_t*)m_rx_buf, 0, RX_BUF_SIZE);
-    tx_offset = 0;
+    memset((uint8_t*)m_tx_ring, 0, TX_RING_SIZE);
+    memset((uint8_t*)m_rx_queue, 0, sizeof(m_rx_queue));
+    tx_head = 1;
+    tx_tail = 1;
+    tx_count = 0;
+    tx_sent = 0;
+    rx_head = 0;
+    rx_tail = 0;
+    rx_count = 0;
 
     nrf_gpio_cfg_input(BLE_CSn_PIN, NRF_GPIO_PIN_PULLUP);
     while(nrf_gpio_pin_read(BLE_CSn_PIN) == 0)
@@ -135,9 +221,7 @@ void app_sp_spis_init(void)
 
     init = false;
     APP_ERROR_CHECK(nrf_drv_spis_init(&spis, &spis_config, spis_event_handler));
-    APP_ERROR_CHECK(nrf_drv_spis_buffers_set(&spis, 
-                                            (uint8_t*)m_tx_buf, TX_BUF_SIZE, 
-                                            (uint8_t*)m_rx_buf, RX_BUF_SIZE));
+    app_sp_spis_buffers_set();
     while(!init)
     {
         __NOP();
@@ -145,21 +229,52 @@ void app_sp_spis_init(void)
 }
 
 /**
- * @brief Put byte to the buffer of the spis port.
+ * @brief Put as much data as fits to the tx ring of the spis port.
  * 
- * @param byte The byte to put.
- * @return uint32_t Error Codes number
+ * @param data The data to put.
+ * @param size The size of the data to put.
+ * @return uint16_t The size of the data put, 0 if the tx ring is full.
  */
-static uint32_t app_sp_spis_put_byte(uint8_t byte)
+static uint16_t app_sp_spis_put_data(uint8_t const* data, uint16_t size)
 {
-    if (tx_offset == TX_BUF_SIZE-1)
-        return NRF_ERROR_BUSY;
+    uint16_t len = 0;
+    CRITICAL_REGION_ENTER();
+    uint16_t space = TX_RING_CAPACITY - tx_count;
+    len = (size > space) ? space : size;
+
+    uint16_t first = TX_RING_SIZE - tx_head;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy((uint8_t*)&m_tx_ring[tx_head], data, first);
+    memcpy((uint8_t*)&m_tx_ring[1], &data[first], len - first);
 
-    m_tx_buf[tx_offset + 1] = byte;
-    tx_offset++;
-    m_tx_buf[0] = tx_offset;
+    tx_head += len;
+    if (tx_head > TX_RING_LAST)
+    {
+        tx_head -= TX_RING_LAST;
+    }
+    tx_count += len;
+    app_sp_spis_tx_len_update();
+    CRITICAL_REGION_EXIT();
+    return len;
+}
 
-    return NRF_SUCCESS;
+/**
+ * @brief Set the SPI slave again if it stopped because the forwarding buffer was full,
+ * once there is room for the next data or tx data to send.
+ * 
+ */
+void app_sp_spis_resume(void)
+{
+    CRITICAL_REGION_ENTER();
+    if (spis_paused && (app_sp_spis_rx_ready() || tx_count > 0))
+    {
+        spis_paused = false;
+        app_sp_spis_buffers_set();
+    }
+    CRITICAL_REGION_EXIT();
 }
 
 /**
@@ -169,35 +284,82 @@ static uint32_t app_sp_spis_put_byte(uint8_t byte)
  */
 void app_sp_spis_put(uint8_t* data, uint16_t size)
 {
-        uint32_t err_code;
-        for (uint16_t i = 0; i < size; i++)
+        uint16_t offset = 0;
+        while (offset < size)
         {
-            do
+            while(spis_xfer_done);
+            uint16_t len = app_sp_spis_put_data(&data[offset], size - offset);
+            if (len == 0)
             {
-                while(spis_xfer_done);
-                err_code = app_sp_spis_put_byte(data[i]);
-                if (err_code == NRF_ERROR_BUSY)
-                {
-                    if (nrf_gpio_pin_out_read(BLE_RDY_PIN) == 1)
-                    {
-                        nrf_gpio_pin_set(BLE_REQ_PIN);
-                        NRF_LOG_INFO("BLE_REQ_PIN[H]");
-                        NRF_LOG_FLUSH();
-                    }
-                }
-                else if (err_code != NRF_SUCCESS)
+                app_sp_spis_resume();
+                if (nrf_gpio_pin_out_read(BLE_RDY_PIN) == 1)
                 {
-                    NRF_LOG_ERROR("Failed receiving message. Error 0x%x. ", err_code);
-                    APP_ERROR_CHECK(err_code);
+                    nrf_gpio_pin_set(BLE_REQ_PIN);
                 }
-            } 
-            while (err_code == NRF_ERROR_BUSY);
+            }
+            offset += len;
         }
 
+        app_sp_spis_resume();
         if (nrf_gpio_pin_out_read(BLE_RDY_PIN) == 1)
         {
           nrf_gpio_pin_set(BLE_REQ_PIN);
-          NRF_LOG_INFO("BLE_REQ_PIN[H]");
-          NRF_LOG_FLUSH();
         }
+}
+
+#if (APP_UNITY_TEST_ENABLE)
+/**
+ * @brief Take the tx data of one transfer as the master reads it, for the unit tests.
+ * The buffers are set again from the new tail, as after a transfer.
+ *
+ * @param p_data The buffer for the data, at least TX_XFER_DATA_MAX bytes.
+ * @return uint16_t The length of the data taken, 0 if there is no tx data.
+ */
+uint16_t app_sp_spis_tx_take(uint8_t* p_data)
+{
+    uint16_t len;
+    CRITICAL_REGION_ENTER();
+    len = m_tx_ring[tx_tail - 1];
+    memcpy(p_data, (uint8_t*)&m_tx_ring[tx_tail], len);
+    app_sp_spis_tx_advance(len);
+    app_sp_spis_buffers_set();
+    CRITICAL_REGION_EXIT();
+    return len;
+}
+#endif
+
+/**
+ * @brief Handler for processing the data received by the SPI slave, called from the main context.
+ * 
+ */
+void app_sp_spis_rx_handler(void)
+{
+    if (tx_sent > 0)
+    {
+        uint32_t sent;
+        CRITICAL_REGION_ENTER();
+        sent = tx_sent;
+        tx_sent = 0;
+        CRITICAL_REGION_EXIT();
+        NRF_LOG_INFO("Tx(%d)", sent);
+    }
+
+    while (rx_count > 0)
+    {
+        uint8_t* data = (uint8_t*)m_rx_queue[rx_tail];
+        uint16_t size = m_rx_lengths[rx_tail];
+        NRF_LOG_INFO("Rx(%d)[0x%02x]", size, data[0]);
+        NRF_LOG_HEXDUMP_INFO(data, size);
+
+        app_sp_on_rx_data(SP_SPI, data, size);
+        memset(data, 0, size);
+
+        rx_tail = (rx_tail + 1) % RX_QUEUE_NUM;
+        CRITICAL_REGION_ENTER();
+        rx_count--;
+        CRITICAL_REGION_EXIT();
+
+        app_sp_spis_resume();
+        app_sp_on_tx_ready(SP_SPI);
+    }
 }
\ No newline at end of file
@@ -27,4 +27,25 @@ void app_sp_spis_init(void);
  */
 void app_sp_spis_put(uint8_t* data, uint16_t size);
 
+/**
+ * @brief Set the SPI slave again if it stopped because the forwarding buffer was full,
+ * once there is room for the next data or tx data to send.
+ * 
+ */
+void app_sp_spis_resume(void);
+
+/**
+ * @brief Handler for processing the data received by the SPI slave, called from the main context.
+ * 
+ */
+void app_sp_spis_rx_handler(void);
+
+/**
+ * @brief Take the tx data of one transfer as the master reads it, for the unit tests.
+ * 
+ * @param p_data The buffer for the data, at least 255 bytes.
+ * @return uint16_t The length of the data taken, 0 if there is no tx data.
+ */
+uint16_t app_sp_spis_tx_take(uint8_t* p_data);
+
 #endif
\ No newline at end of file
@@ -11,9 +11,64 @@
 #include "test_app_sp.h"
 
 #include "app_sp.h"
+#include "app_sp_spis.h"
 #include <stdbool.h>
 #include "nrf_delay.h"
 #include "custom_board.h"
+#include "app_timer.h"
+
+#define TEST_SPIS_FRAME_SIZE        32      /**< The size of each frame put back to back. */
+#define TEST_SPIS_FRAME_NUM         8       /**< The number of frames put back to back. */
+#define TEST_SPIS_PUT_TICKS_MAX     APP_TIMER_TICKS(2)  /**< The longest time to put all frames. */
+#define TEST_SPIS_WRAP_FRAME_SIZE   29      /**< The size of the frames put across the end of the tx ring, not a divisor of its size. */
+#define TEST_SPIS_WRAP_FRAME_NUM    48      /**< The number of frames put across the end of the tx ring, more than twice its size. */
+#define TEST_SPIS_WRAP_BATCH        3       /**< The number of frames put before the master reads them. */
+
+/**
+ * @brief Fill a frame with data that tells it from the frames before and after it.
+ * 
+ * @param frame The frame to fill.
+ * @param size The size of the frame.
+ * @param seq The sequence number of the frame.
+ */
+static void test_app_sp_spis_frame_fill (uint8_t* frame, uint16_t size, uint8_t seq)
+{
+    for(uint16_t i=0;i<size;i++)
+        frame[i] = (uint8_t)(seq * 31 + i);
+}
+
+/**
+ * @brief Read the tx data of the SPIS as the master does, and check that it is exactly
+ * the frames from the sequence number on, whole and in order.
+ * 
+ * @param size The size of each frame.
+ * @param seq The sequence number of the first frame.
+ * @param num The number of frames.
+ * @return uint8_t The sequence number of the next frame.
+ */
+static uint8_t test_app_sp_spis_frames_check (uint16_t size, uint8_t seq, uint8_t num)
+{
+    uint8_t data[0xFF];
+    uint16_t offset = 0;
+    uint32_t taken = 0;
+    uint16_t len;
+    while ((len = app_sp_spis_tx_take(data)) > 0)
+    {
+        for(uint16_t i=0;i<len;i++)
+        {
+            TEST_ASSERT_EQUAL_UINT8((uint8_t)(seq * 31 + offset), data[i]);
+            offset++;
+            if (offset == size)
+            {
+                offset = 0;
+                seq++;
+            }
+        }
+        taken += len;
+    }
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)size * num, taken);
+    return seq;
+}
 
 /**
  * @brief Test the input data application of SPIS
@@ -39,6 +94,58 @@ static void test_app_sp_spis_put (void)
     nrf_delay_ms(500);
 }
 
+/**
+ * @brief Test putting frames back to back to SPIS, each frame is queued as a whole
+ * and the time to put them does not depend on the data already queued.
+ * The frames are then read as the master does, also after the tx ring has wrapped
+ * many times, and must come out whole and in order.
+ * 
+ */
+static void test_app_sp_spis_put_frames (void)
+{
+    uint8_t frame[TEST_SPIS_FRAME_SIZE];
+    uint8_t data[0xFF];
+    uint8_t seq = 0;
+
+    //Start from an empty tx ring
+    while (app_sp_spis_tx_take(data) > 0);
+
+    uint32_t start = app_timer_cnt_get();
+    for(int i=0;i<TEST_SPIS_FRAME_NUM;i++)
+    {
+        test_app_sp_spis_frame_fill(frame, sizeof(frame), seq + i);
+        app_sp_put(SP_SPI, frame, sizeof(frame));
+    }
+    uint32_t ticks = app_timer_cnt_diff_compute(app_timer_cnt_get(), start);
+
+    UnityPrint("SPIS put ticks: ");
+    UnityPrintNumberUnsigned(ticks);
+    UNITY_PRINT_EOL();
+
+    bool req = false;
+    for(uint32_t i=0;i<10000;i++)
+    {
+        req |= nrf_gpio_pin_out_read(BLE_REQ_PIN);
+    }
+
+    TEST_ASSERT_TRUE(req);
+    TEST_ASSERT_LESS_THAN(TEST_SPIS_PUT_TICKS_MAX, ticks);
+    seq = test_app_sp_spis_frames_check(sizeof(frame), seq, TEST_SPIS_FRAME_NUM);
+
+    //Frames of a size that does not divide the ring, so they are split at its end at different offsets
+    uint8_t frame_wrap[TEST_SPIS_WRAP_FRAME_SIZE];
+    for(int i=0;i<TEST_SPIS_WRAP_FRAME_NUM;i+=TEST_SPIS_WRAP_BATCH)
+    {
+        for(int j=0;j<TEST_SPIS_WRAP_BATCH;j++)
+        {
+            test_app_sp_spis_frame_fill(frame_wrap, sizeof(frame_wrap), seq + j);
+            app_sp_put(SP_SPI, frame_wrap, sizeof(frame_wrap));
+        }
+        seq = test_app_sp_spis_frames_check(sizeof(frame_wrap), seq, TEST_SPIS_WRAP_BATCH);
+    }
+    nrf_delay_ms(500);
+}
+
 /**
  * @brief Run all test items for serial port applications
  * 
@@ -50,6 +157,7 @@ void test_run_app_sp (void)
 
     UnityBegin("[SP]");
     RUN_TEST(test_app_sp_spis_put, __LINE__);
+    RUN_TEST(test_app_sp_spis_put_frames, __LINE__);
     UNITY_END();
     nrf_delay_ms(500);
 }
\ No newline at end of file
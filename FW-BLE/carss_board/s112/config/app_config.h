@@ -16,6 +16,8 @@
 
 #define APP_SP_DEBUG_ENABLE                 true
 
+#define APP_BLE_NUS_PACK_ENABLE             false       //Pack the forwarded frames into notifications of the data length, only for centrals that split notifications by frame length
+
 #define APP_UNITY_TEST_ENABLE               false
 
 #endif
\ No newline at end of file
@@ -19,6 +19,10 @@
 
 #define ADDR_SYS_CONFIG					0xA0000UL	/*!< The address of the system configuration */
 
+#define ADDR_PARA_BASE					0xB0000UL	/*!< The base address of the parameters */
+#define SIZE_PARA						0x1000UL	/*!< The FRAM size of each copy of the parameters */
+#define ADDR_PARA_BACKUP				(ADDR_PARA_BASE + SIZE_PARA)	/*!< The address of the backup copy of the parameters */
+
 typedef struct {
 	uint32_t 	ImageDataOffset;					/*!< The offset of the data in the image */
 	uint8_t 	ImageData[SIZE_FW_IMG_PKG];			/*!< The data of the packet */
@@ -36,6 +40,8 @@ typedef struct {
 
 typedef void (*Log_Write_Callback)(uint32_t write_addr, uint16_t write_size);
 
+typedef void (*FRAM_Read_Callback)(uint32_t read_addr, uint16_t read_size);
+
 /**
  * @brief Initialization of FRAM
  *
@@ -53,9 +59,9 @@ void bsp_fram_deinit(void);
  * @brief Write data to FRAM
  *
  * @param addr The address where data is written in FRAM
- * @param p_data Data written in FRAM
+ * @param p_data Data written in FRAM, it is not copied and must stay unchanged until the write completes
  * @param data_len The length of data written in FRAM
- * @param waitfor_cplt Wait for writing to complete
+ * @param waitfor_cplt Wait for all queued writes to complete
  */
 void bsp_fram_write(uint32_t addr, const uint8_t* p_data, uint16_t data_len, bool waitfor_cplt);
 
@@ -68,6 +74,24 @@ void bsp_fram_write(uint32_t addr, const uint8_t* p_data, uint16_t data_len, boo
  */
 void bsp_fram_read(uint32_t addr, uint8_t* p_data, uint16_t data_len);
 
+/**
+ * @brief Read data from FRAM in non-blocking mode
+ *
+ * @param addr The address to read data from FRAM
+ * @param p_data Data read from FRAM, it must stay valid until the callback
+ * @param data_len The length of data read from FRAM
+ * @param callback Read completion callback, called in interrupt context
+ */
+void bsp_fram_read_IT(uint32_t addr, uint8_t* p_data, uint16_t data_len, FRAM_Read_Callback callback);
+
+/**
+ * @brief Confirm whether FRAM is busy with a non-blocking transfer
+ *
+ * @return true FRAM is busy
+ * @return false FRAM is not busy
+ */
+bool bsp_fram_is_busy(void);
+
 /**
  * @brief Erase data in FRAM
  *
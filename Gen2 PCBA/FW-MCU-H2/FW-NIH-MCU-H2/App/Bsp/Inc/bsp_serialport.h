@@ -13,6 +13,7 @@
 typedef struct {
 	uint8_t data[SP_BUF_SIZE];		/*!< The data buffer of the serial port */
 	uint8_t len;					/*!< The effective length of the serial port data buffer */
+	uint8_t head;					/*!< The index of the first effective data in the buffer */
 } Buffer_t;
 
 typedef struct {
@@ -20,10 +21,12 @@ typedef struct {
 	Buffer_t rx;					/*!< The serial port's receive buffer */
 } Serialport_Buffer_t;
 
-typedef uint8_t (*Cmd_Parser)(uint8_t* p_data_rx, uint8_t* p_data_rx_len, uint8_t* p_data_tx);	/*!< The format of the command parser */
+typedef uint8_t (*Cmd_Parser)(uint8_t* p_data_rx, uint8_t* p_data_rx_head, uint8_t* p_data_rx_len, uint8_t* p_data_tx);	/*!< The format of the command parser */
 
 typedef void (*CY15B108QN_Write_Callback)(uint32_t write_addr, uint16_t write_size);	/*!< The format of the CY15B108QN write completion callback */
 
+typedef void (*CY15B108QN_Read_Callback)(uint32_t read_addr, uint16_t read_size);		/*!< The format of the CY15B108QN read completion callback */
+
 extern Serialport_Buffer_t sp_uart;
 
 /**
@@ -48,6 +51,23 @@ void bsp_sp_deinit(void);
  */
 void bsp_sp_cmd_send(const uint8_t* data, uint8_t data_len);
 
+/**
+ * @brief Check whether the command sent on the serial port is still waiting for the nRF52810
+ * 
+ * @return true The command has not been written yet
+ * @return false The command has been written
+ */
+bool bsp_sp_cmd_is_pending(void);
+
+/**
+ * @brief Check whether the remote end is waiting for the handler for command communication,
+ * because a request command is waiting in the nRF52810 or on the debug port, or a response command is not written yet
+ *
+ * @return true The handler needs to be called
+ * @return false Nothing to do
+ */
+bool bsp_sp_cmd_is_requested(void);
+
 /**
  * @brief Write data to DAC80502 on serial port
  * 
@@ -87,10 +107,12 @@ uint8_t bsp_sp_ISL23315T_write(uint16_t reg_addr, uint8_t reg_data);
  * @brief Write data to the CY15B108QN on the serial port in non-blocking mode
  * 
  * @param addr The address to be written to CY15B108QN.
- * @param p_data The data to be written to the CY15B108QN
+ * @param p_data The data to be written to the CY15B108QN, it is not copied and must stay unchanged until the write completes
  * @param data_len The length of data to be written to CY15B108QN
+ * @return true The write is queued, or there is nothing to write
+ * @return false The queue is full and the write is not queued, it does not wait so it can be called in interrupt context
  */
-void bsp_sp_CY15B108QN_write_IT(uint32_t addr, const uint8_t* p_data, uint16_t data_len);
+bool bsp_sp_CY15B108QN_write_IT(uint32_t addr, const uint8_t* p_data, uint16_t data_len);
 
 /**
  * @brief Read data from CY15B108QN on the serial port
@@ -101,6 +123,16 @@ void bsp_sp_CY15B108QN_write_IT(uint32_t addr, const uint8_t* p_data, uint16_t d
  */
 void bsp_sp_CY15B108QN_read(uint32_t addr, uint8_t* p_data, uint16_t data_len);
 
+/**
+ * @brief Read data from CY15B108QN on the serial port in non-blocking mode
+ *
+ * @param addr The address of reading data from CY15B108QN.
+ * @param p_data Data to be read from CY15B108QN, it must stay valid until the callback
+ * @param data_len The length of data to be read from CY15B108QN
+ * @param CY15B108QN_rd_cb The CY15B108QN read completion callback, called in interrupt context
+ */
+void bsp_sp_CY15B108QN_read_IT(uint32_t addr, uint8_t* p_data, uint16_t data_len, CY15B108QN_Read_Callback CY15B108QN_rd_cb);
+
 /**
  * @brief Erase the data of CY15B108QN on the serial port
  * 
@@ -117,6 +149,14 @@ void bsp_sp_CY15B108QN_erase(uint32_t addr, uint32_t erase_size);
  */
 bool bsp_sp_CY15B108QN_is_busy(void);
 
+/**
+ * @brief Confirm whether a non-blocking read of CY15B108QN is in flight
+ *
+ * @return true A read is in flight
+ * @return false No read is in flight
+ */
+bool bsp_sp_CY15B108QN_is_reading(void);
+
 /**
  * @brief Write data to the nRF52810 on the serial port
  *
@@ -126,12 +166,14 @@ bool bsp_sp_CY15B108QN_is_busy(void);
 void bsp_sp_nRF52810_write(uint8_t* p_data, uint16_t data_len);
 
 /**
- * @brief Read data from nRF52810 on the serial port
+ * @brief Read data from nRF52810 on the serial port.
+ * The nRF52810 only drops the data clocked out, so the data beyond the maximum length is read by the next transfer.
  *
  * @param p_data Data to be read from nRF52810
+ * @param data_max The maximum length of data to be read
  * @return uint16_t The length of data to be read from nRF52810
  */
-uint16_t bsp_sp_nRF52810_read(uint8_t* p_data);
+uint16_t bsp_sp_nRF52810_read(uint8_t* p_data, uint16_t data_max);
 
 /**
  * @brief Enable / disable the XL I2C serial port
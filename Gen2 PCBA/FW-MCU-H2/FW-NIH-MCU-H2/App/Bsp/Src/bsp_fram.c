@@ -6,8 +6,6 @@
 #include "bsp_fram.h"
 #include "bsp_config.h"
 
-static bool write_cplt = false;
-
 static Log_Write_Callback log_writeCallback = NULL;
 
 /**
@@ -36,19 +34,26 @@ void bsp_fram_deinit(void) {
  * @brief Write data to FRAM
  * 
  * @param addr The address where data is written in FRAM
- * @param p_data Data written in FRAM
+ * @param p_data Data written in FRAM, it is not copied and must stay unchanged until the write completes
  * @param data_len The length of data written in FRAM
- * @param waitfor_cplt Wait for writing to complete
+ * @param waitfor_cplt Wait for all queued writes to complete
  */
 __weak void bsp_fram_write(uint32_t addr, const uint8_t* p_data, uint16_t data_len, bool waitfor_cplt) {
 	if (HAL_GPIO_ReadPin(FRAM_EN_GPIO_Port, FRAM_EN_Pin) == GPIO_PIN_RESET) {
 		return;
 	}
-	write_cplt = false;
-	bsp_sp_CY15B108QN_write_IT(addr, p_data, data_len);
+	//The queued writes keep going, only the read in flight is waited for
+	while(bsp_sp_CY15B108QN_is_reading()) {
+		__NOP();
+	};
+	//The queue holds every write the callers can have outstanding, so a write is only refused here if that changes.
+	//A completion callback can always queue one more write, because the finished entry is popped before the callback runs.
+	while(!bsp_sp_CY15B108QN_write_IT(addr, p_data, data_len)) {
+		(void)bsp_sp_CY15B108QN_is_busy();
+	};
 
 	if (waitfor_cplt) {
-		while(!write_cplt) {
+		while(bsp_sp_CY15B108QN_is_busy()) {
 			__NOP();
 		};
 		HAL_Delay(1);
@@ -63,9 +68,37 @@ __weak void bsp_fram_write(uint32_t addr, const uint8_t* p_data, uint16_t data_l
  * @param data_len The length of data read from FRAM
  */
 __weak void bsp_fram_read(uint32_t addr, uint8_t* p_data, uint16_t data_len) {
+	while(bsp_sp_CY15B108QN_is_busy()) {
+		__NOP();
+	};
 	bsp_sp_CY15B108QN_read(addr, p_data, data_len);
 }
 
+/**
+ * @brief Read data from FRAM in non-blocking mode
+ *
+ * @param addr The address to read data from FRAM
+ * @param p_data Data read from FRAM, it must stay valid until the callback
+ * @param data_len The length of data read from FRAM
+ * @param callback Read completion callback, called in interrupt context
+ */
+__weak void bsp_fram_read_IT(uint32_t addr, uint8_t* p_data, uint16_t data_len, FRAM_Read_Callback callback) {
+	while(bsp_sp_CY15B108QN_is_busy()) {
+		__NOP();
+	};
+	bsp_sp_CY15B108QN_read_IT(addr, p_data, data_len, callback);
+}
+
+/**
+ * @brief Confirm whether FRAM is busy with a non-blocking transfer
+ *
+ * @return true FRAM is busy
+ * @return false FRAM is not busy
+ */
+bool bsp_fram_is_busy(void) {
+	return bsp_sp_CY15B108QN_is_busy();
+}
+
 /**
  * @brief Erase data in FRAM
  * 
@@ -73,6 +106,9 @@ __weak void bsp_fram_read(uint32_t addr, uint8_t* p_data, uint16_t data_len) {
  * @param erase_size The size of the data to erase
  */
 __weak void bsp_fram_erase(uint32_t addr, uint32_t erase_size) {
+	while(bsp_sp_CY15B108QN_is_busy()) {
+		__NOP();
+	};
 	bsp_sp_CY15B108QN_erase(addr, erase_size);
 }
 
@@ -84,5 +120,4 @@ __weak void bsp_fram_erase(uint32_t addr, uint32_t erase_size) {
  */
 void bsp_fram_write_cplt_cb(uint32_t write_addr, uint16_t write_size) {
 	log_writeCallback(write_addr, write_size);
-	write_cplt = true;
 }
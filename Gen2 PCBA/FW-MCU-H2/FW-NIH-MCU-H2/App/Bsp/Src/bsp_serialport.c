@@ -6,16 +6,45 @@
 #include "bsp_serialport.h"
 #include "bsp_config.h"
 
-Serialport_Buffer_t sp_spi;
+#define CY15B108QN_ERASE_BLOCK_SIZE		256U		/*!< The size of each block streamed when erasing CY15B108QN */
+#define CY15B108QN_WR_QUEUE_SIZE		12U			/*!< The number of CY15B108QN writes that can be outstanding: 2 for each of the 4 log buffers, 2 to clear the log ring when it wraps, the log pointer and one write waited for */
+#define SP_SPI_RESP_QUEUE_SIZE			4U			/*!< The number of response commands that can wait for the nRF52810 */
+#define SP_SPI_RX_WAIT_TIMEOUT			500U		/*!< The time a command not complete waits for the rest of it, longer than the connection interval times (slave latency + 1) of every connection profile, unit: ms */
+
+#define CY15B108QN_WR_STATE_IDLE		0U			/*!< No CY15B108QN write is being transferred */
+#define CY15B108QN_WR_STATE_WREN		1U			/*!< The write enable latch command is being transferred */
+#define CY15B108QN_WR_STATE_HEADER		2U			/*!< The write command and address are being transferred */
+#define CY15B108QN_WR_STATE_DATA		3U			/*!< The write data is being transferred */
+
+typedef struct {
+	uint32_t 		addr;			/*!< The address to be written to CY15B108QN */
+	const uint8_t* 	p_data;			/*!< The data to be written, owned by the caller until the write completes */
+	uint16_t 		data_len;		/*!< The length of data to be written */
+} CY15B108QN_Write_Req_t;
+
+Buffer_t	sp_spi_rx;
 Buffer_t	active_spi_tx;
 
 Serialport_Buffer_t sp_uart;
 
-static uint8_t CY15B108QN_mem_wr_opcode = 0;
-static uint8_t CY15B108QN_mem_wr_buffer[500];
-static uint16_t CY15B108QN_mem_wr_len = 0;
-static uint32_t CY15B108QN_mem_wr_address = 0;
-static uint16_t CY15B108QN_mem_wr_datalen = 0;
+static const uint8_t CY15B108QN_mem_wr_opcode = CY15B108QN_CMD_WREN;
+static uint8_t CY15B108QN_mem_wr_header[4];
+static uint8_t CY15B108QN_mem_wr_state = CY15B108QN_WR_STATE_IDLE;
+static CY15B108QN_Write_Req_t CY15B108QN_mem_wr_queue[CY15B108QN_WR_QUEUE_SIZE];
+static uint8_t CY15B108QN_mem_wr_head = 0;
+static uint8_t CY15B108QN_mem_wr_tail = 0;
+static volatile uint8_t CY15B108QN_mem_wr_count = 0;
+static const uint8_t CY15B108QN_mem_erase_block[CY15B108QN_ERASE_BLOCK_SIZE] = {0};
+static volatile bool CY15B108QN_mem_rd_busy = false;
+static uint32_t CY15B108QN_mem_rd_address = 0;
+static uint16_t CY15B108QN_mem_rd_len = 0;
+static CY15B108QN_Read_Callback CY15B108QN_readCallback = NULL;
+static Buffer_t sp_spi_resp_queue[SP_SPI_RESP_QUEUE_SIZE];
+static uint8_t sp_spi_resp_head = 0;
+static uint8_t sp_spi_resp_tail = 0;
+static uint8_t sp_spi_resp_count = 0;
+static bool sp_spi_rx_wait = false;
+static uint32_t sp_spi_rx_tick = 0;
 
 static bool init = true;
 static Cmd_Parser cmdParser = NULL;
@@ -33,9 +62,13 @@ static bool XL_en = false;
  * @param CY15B108QN_wr_cb The CY15B108QN write completion callback
  */
 void bsp_sp_init(Cmd_Parser cmd_parser, CY15B108QN_Write_Callback CY15B108QN_wr_cb) {
-	(void)memset(&sp_spi, 0, sizeof(sp_spi));
+	(void)memset(&sp_spi_rx, 0, sizeof(sp_spi_rx));
 	(void)memset(&sp_uart, 0, sizeof(sp_uart));
 	(void)memset(&active_spi_tx, 0, sizeof(active_spi_tx));
+	sp_spi_resp_head = 0;
+	sp_spi_resp_tail = 0;
+	sp_spi_resp_count = 0;
+	sp_spi_rx_wait = false;
 	cmdParser = cmd_parser;
 	CY15B108QN_writeCallback = CY15B108QN_wr_cb;
 
@@ -69,7 +102,10 @@ void bsp_sp_deinit(void) {
 
 	HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_RESET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
 	HAL_GPIO_WritePin(SPI1_BLE_CSn_GPIO_Port, SPI1_BLE_CSn_Pin, GPIO_PIN_RESET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
-	CY15B108QN_mem_wr_opcode = 0;
+	CY15B108QN_mem_wr_state = CY15B108QN_WR_STATE_IDLE;
+	CY15B108QN_mem_wr_head = 0;
+	CY15B108QN_mem_wr_tail = 0;
+	CY15B108QN_mem_wr_count = 0;
 }
 
 /**
@@ -83,6 +119,28 @@ void bsp_sp_cmd_send(const uint8_t* data, uint8_t data_len) {
 	active_spi_tx.len = data_len;
 }
 
+/**
+ * @brief Check whether the command sent on the serial port is still waiting for the nRF52810
+ * The nRF52810 keeps BLE_RDY low while its forwarding buffer is full, so the command stays pending until it has room.
+ * 
+ * @return true The command has not been written yet
+ * @return false The command has been written
+ */
+bool bsp_sp_cmd_is_pending(void) {
+	return (active_spi_tx.len > 0U);
+}
+
+/**
+ * @brief Check whether the remote end is waiting for the handler for command communication,
+ * because a request command is waiting in the nRF52810 or on the debug port, or a response command is not written yet
+ *
+ * @return true The handler needs to be called
+ * @return false Nothing to do
+ */
+bool bsp_sp_cmd_is_requested(void) {
+	return ((HAL_GPIO_ReadPin(BLE_REQ_GPIO_Port, BLE_REQ_Pin) == GPIO_PIN_SET) || (sp_spi_rx.len > 0U) || (sp_spi_resp_count > 0U) || (sp_uart.rx.len > 0U)); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
+}
+
 /**
  * @brief Write data to DAC80502 on serial port
  * 
@@ -129,21 +187,62 @@ __weak uint8_t bsp_sp_ISL23315T_write(uint16_t reg_addr, uint8_t reg_data) {
 	return (uint8_t)HAL_I2C_Mem_Write(&HANDLE_ISL23315T_DAC8050x_I2C, BSP_ISL23315T_DEVICE_ADDR, reg_addr, I2C_MEMADD_SIZE_8BIT, &data, 1, 5);
 }
 
+/**
+ * @brief Start transferring the oldest queued CY15B108QN write, if the serial port is free.
+ * A write is not started while a non-blocking read is in flight, the read completion starts it.
+ * If the serial port is taken by another transfer, the write stays queued and is started again later.
+ * The serial port is taken while the SPI is not ready or a CS is low, CS is only driven once both are checked.
+ * It must be called with the interrupts disabled or in interrupt context.
+ *
+ */
+static void bsp_sp_CY15B108QN_write_next(void) {
+	if ((CY15B108QN_mem_wr_state != CY15B108QN_WR_STATE_IDLE) || (CY15B108QN_mem_wr_count == 0U) || CY15B108QN_mem_rd_busy) {
+		return;
+	}
+	if ((HAL_SPI_GetState(&HANDLE_NRF52810_CY15B108QN_SPI) != HAL_SPI_STATE_READY)
+			|| (HAL_GPIO_ReadPin(SPI1_BLE_CSn_GPIO_Port, SPI1_BLE_CSn_Pin) == GPIO_PIN_RESET) /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
+			|| (HAL_GPIO_ReadPin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin) == GPIO_PIN_RESET)) { /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
+		return;
+	}
+	(void)CY15B108QN_write_spi_header_get(CY15B108QN_mem_wr_header, CY15B108QN_mem_wr_queue[CY15B108QN_mem_wr_tail].addr);
+
+	CY15B108QN_mem_wr_state = CY15B108QN_WR_STATE_WREN;
+    HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_RESET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
+    if (HAL_SPI_Transmit_IT(&HANDLE_NRF52810_CY15B108QN_SPI, &CY15B108QN_mem_wr_opcode, 1) != HAL_OK) {
+    	HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_SET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
+    	CY15B108QN_mem_wr_state = CY15B108QN_WR_STATE_IDLE;
+    }
+}
+
 /**
  * @brief Write data to the CY15B108QN on the serial port in non-blocking mode
  * 
  * @param addr The address to be written to CY15B108QN.
- * @param p_data The data to be written to the CY15B108QN
+ * @param p_data The data to be written to the CY15B108QN, it is not copied and must stay unchanged until the write completes
  * @param data_len The length of data to be written to CY15B108QN
+ * @return true The write is queued, or there is nothing to write
+ * @return false The queue is full and the write is not queued, it does not wait so it can be called in interrupt context
  */
-void bsp_sp_CY15B108QN_write_IT(uint32_t addr, const uint8_t* p_data, uint16_t data_len) {
-	CY15B108QN_mem_wr_len = CY15B108QN_write_spi_frame_get(CY15B108QN_mem_wr_buffer, addr, p_data, data_len);
-	CY15B108QN_mem_wr_datalen = CY15B108QN_mem_wr_len - 4U;
-	CY15B108QN_mem_wr_address = addr;
+bool bsp_sp_CY15B108QN_write_IT(uint32_t addr, const uint8_t* p_data, uint16_t data_len) {
+	if ((p_data == NULL) || (data_len == 0U)) {
+		return true;
+	}
 
-    CY15B108QN_mem_wr_opcode = CY15B108QN_CMD_WREN;
-    HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_RESET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
-    (void)HAL_SPI_Transmit_IT(&HANDLE_NRF52810_CY15B108QN_SPI, &CY15B108QN_mem_wr_opcode, 1);
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if (CY15B108QN_mem_wr_count >= CY15B108QN_WR_QUEUE_SIZE) {
+		__set_PRIMASK(primask);
+		return false;
+	}
+	CY15B108QN_mem_wr_queue[CY15B108QN_mem_wr_head].addr = addr;
+	CY15B108QN_mem_wr_queue[CY15B108QN_mem_wr_head].p_data = p_data;
+	CY15B108QN_mem_wr_queue[CY15B108QN_mem_wr_head].data_len = data_len;
+	CY15B108QN_mem_wr_head = (CY15B108QN_mem_wr_head + 1U) % CY15B108QN_WR_QUEUE_SIZE;
+	CY15B108QN_mem_wr_count++;
+
+	bsp_sp_CY15B108QN_write_next();
+	__set_PRIMASK(primask);
+	return true;
 }
 
 /**
@@ -163,6 +262,28 @@ void bsp_sp_CY15B108QN_read(uint32_t addr, uint8_t* p_data, uint16_t data_len) {
 	HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_SET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
 }
 
+/**
+ * @brief Read data from CY15B108QN on the serial port in non-blocking mode
+ *
+ * @param addr The address of reading data from CY15B108QN.
+ * @param p_data Data to be read from CY15B108QN, it must stay valid until the callback
+ * @param data_len The length of data to be read from CY15B108QN
+ * @param CY15B108QN_rd_cb The CY15B108QN read completion callback, called in interrupt context
+ */
+void bsp_sp_CY15B108QN_read_IT(uint32_t addr, uint8_t* p_data, uint16_t data_len, CY15B108QN_Read_Callback CY15B108QN_rd_cb) {
+	uint8_t buffer[4] = {0,0,0,0};
+	(void)CY15B108QN_read_spi_frame_get(buffer, addr);
+
+	CY15B108QN_mem_rd_busy = true;
+	CY15B108QN_mem_rd_address = addr;
+	CY15B108QN_mem_rd_len = data_len;
+	CY15B108QN_readCallback = CY15B108QN_rd_cb;
+
+    HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_RESET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
+    HAL_ERROR_CHECK(HAL_SPI_Transmit(&HANDLE_NRF52810_CY15B108QN_SPI, buffer, (uint16_t)sizeof(buffer), 5));
+    HAL_ERROR_CHECK(HAL_SPI_Receive_IT(&HANDLE_NRF52810_CY15B108QN_SPI, p_data, data_len));
+}
+
 /**
  * @brief Erase the data of CY15B108QN on the serial port
  * 
@@ -186,8 +307,12 @@ void bsp_sp_CY15B108QN_erase(uint32_t addr, uint32_t erase_size) {
 
     HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_RESET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
     HAL_ERROR_CHECK(HAL_SPI_Transmit(&HANDLE_NRF52810_CY15B108QN_SPI, CY15B108QN_mem_erase_buffer, 5, 5));
-    for(uint32_t i = (addr + 1U);i<(addr+erase_size);i++) {
-    	HAL_ERROR_CHECK(HAL_SPI_Transmit(&HANDLE_NRF52810_CY15B108QN_SPI, &CY15B108QN_mem_erase_data, 1, 5));
+    //The FRAM keeps incrementing the address while CS is low, so the rest of the range is streamed in blocks of a constant pattern
+    uint32_t remain_size = (erase_size > 0U) ? (erase_size - 1U) : 0U;
+    while(remain_size > 0U) {
+    	uint16_t block_size = (remain_size > CY15B108QN_ERASE_BLOCK_SIZE) ? (uint16_t)CY15B108QN_ERASE_BLOCK_SIZE : (uint16_t)remain_size;
+    	HAL_ERROR_CHECK(HAL_SPI_Transmit(&HANDLE_NRF52810_CY15B108QN_SPI, CY15B108QN_mem_erase_block, block_size, 5));
+    	remain_size -= block_size;
     }
     HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_SET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
 }
@@ -200,12 +325,28 @@ void bsp_sp_CY15B108QN_erase(uint32_t addr, uint32_t erase_size) {
  */
 bool bsp_sp_CY15B108QN_is_busy(void) {
 	bool ret = false;
-	if (CY15B108QN_mem_wr_opcode > 0U) {
+	//A queued write that could not start while the serial port was taken is started here
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	bsp_sp_CY15B108QN_write_next();
+	__set_PRIMASK(primask);
+
+	if ((CY15B108QN_mem_wr_state != CY15B108QN_WR_STATE_IDLE) || (CY15B108QN_mem_wr_count > 0U) || CY15B108QN_mem_rd_busy) {
 		ret = true;
 	}
 	return ret;
 }
 
+/**
+ * @brief Confirm whether a non-blocking read of CY15B108QN is in flight
+ *
+ * @return true A read is in flight
+ * @return false No read is in flight
+ */
+bool bsp_sp_CY15B108QN_is_reading(void) {
+	return CY15B108QN_mem_rd_busy;
+}
+
 /**
  * @brief Write data to the nRF52810 on the serial port
  *
@@ -220,15 +361,20 @@ void bsp_sp_nRF52810_write(uint8_t* p_data, uint16_t data_len) {
 }
 
 /**
- * @brief Read data from nRF52810 on the serial port
+ * @brief Read data from nRF52810 on the serial port.
+ * The nRF52810 only drops the data clocked out, so the data beyond the maximum length is read by the next transfer.
  *
  * @param p_data Data to be read from nRF52810
+ * @param data_max The maximum length of data to be read
  * @return uint16_t The length of data to be read from nRF52810
  */
-uint16_t bsp_sp_nRF52810_read(uint8_t* p_data) {
+uint16_t bsp_sp_nRF52810_read(uint8_t* p_data, uint16_t data_max) {
 	uint8_t data_len = 0;
 	HAL_GPIO_WritePin(SPI1_BLE_CSn_GPIO_Port, SPI1_BLE_CSn_Pin, GPIO_PIN_RESET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
 	HAL_ERROR_CHECK(HAL_SPI_Receive(&HANDLE_NRF52810_CY15B108QN_SPI, &data_len, 1, 5));
+	if (data_len > data_max) {
+		data_len = (uint8_t)data_max;
+	}
 	if (data_len > 0U) {
 		HAL_ERROR_CHECK(HAL_SPI_Receive(&HANDLE_NRF52810_CY15B108QN_SPI, (uint8_t*)p_data, data_len, 10));
 	}
@@ -291,14 +437,67 @@ __weak bool bsp_sp_cmd_handler(void) {
 		__NOP();
 	}
 
-	if (HAL_GPIO_ReadPin(BLE_REQ_GPIO_Port, BLE_REQ_Pin) == GPIO_PIN_SET) { /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
+	//The commands not parsed yet are kept until they are all parsed, then the next data is read from the start of the buffer.
+	//The rest of a command split over two transfers is read in place after it. Only a command that reaches the end of the buffer
+	//is moved to the start of it, the rest of it cannot be read otherwise.
+	if (((sp_spi_rx.len == 0U) || sp_spi_rx_wait) && (HAL_GPIO_ReadPin(BLE_REQ_GPIO_Port, BLE_REQ_Pin) == GPIO_PIN_SET)) { /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
 		HAL_Delay(1);
-		sp_spi.rx.len = bsp_sp_nRF52810_read(sp_spi.rx.data);
+		if (sp_spi_rx.len == 0U) {
+			sp_spi_rx.head = 0U;
+		}
+		else if (((uint16_t)sp_spi_rx.head + sp_spi_rx.len) == SP_BUF_SIZE) {
+			(void)memmove(sp_spi_rx.data, &sp_spi_rx.data[sp_spi_rx.head], sp_spi_rx.len);
+			sp_spi_rx.head = 0U;
+		}
+		else {
+			__NOP();
+		}
+		uint16_t rx_end = (uint16_t)sp_spi_rx.head + sp_spi_rx.len;
+		uint16_t rd_len = bsp_sp_nRF52810_read(&sp_spi_rx.data[rx_end], SP_BUF_SIZE - rx_end);
+		if (rd_len > 0U) {
+			sp_spi_rx_tick = HAL_GetTick();
+		}
+		sp_spi_rx.len += (uint8_t)rd_len;
 	}
 
-	if (sp_spi.rx.len > 0U) {
-		sp_spi.tx.len = cmdParser((uint8_t*)sp_spi.rx.data, &sp_spi.rx.len, (uint8_t*)sp_spi.tx.data);
-		activated = true;
+	//The responses wait in the queue while BLE_REQ is set, because nothing is written until the nRF52810 data is read.
+	//When more commands are outstanding than the queue holds, the next command is not run, so the data can still be read,
+	//and the parser replies it busy once the queue has room.
+	bool resp_full = (sp_spi_resp_count == SP_SPI_RESP_QUEUE_SIZE);
+	if ((sp_spi_rx.len > 0U) && ((resp_full == false) || (HAL_GPIO_ReadPin(BLE_REQ_GPIO_Port, BLE_REQ_Pin) == GPIO_PIN_SET))) { /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
+		Buffer_t* p_resp = &sp_spi_resp_queue[sp_spi_resp_head];
+		uint8_t rx_len = sp_spi_rx.len;
+		uint8_t resp_len = cmdParser((uint8_t*)sp_spi_rx.data, &sp_spi_rx.head, &sp_spi_rx.len, resp_full ? NULL : (uint8_t*)p_resp->data);
+		if (resp_len > 0U) {
+			p_resp->len = resp_len;
+			sp_spi_resp_head = (sp_spi_resp_head + 1U) % SP_SPI_RESP_QUEUE_SIZE;
+			sp_spi_resp_count++;
+		}
+		//Nothing is parsed while the command is not complete, it waits for the rest of it.
+		//If no data comes within the timeout, the data is resynchronized from the next byte, one byte per call.
+		if (sp_spi_rx.len != rx_len) {
+			sp_spi_rx_wait = false;
+			activated = true;
+		}
+		else if ((HAL_GetTick() - sp_spi_rx_tick) < SP_SPI_RX_WAIT_TIMEOUT) {
+			sp_spi_rx_wait = true;
+		}
+		else {
+			sp_spi_rx.head++;
+			sp_spi_rx.len--;
+		}
+	}
+	else if ((sp_spi_rx.len == 0U) && (resp_full == false)) {
+		//The busy responses of the commands not run
+		Buffer_t* p_resp = &sp_spi_resp_queue[sp_spi_resp_head];
+		p_resp->len = cmdParser((uint8_t*)sp_spi_rx.data, &sp_spi_rx.head, &sp_spi_rx.len, (uint8_t*)p_resp->data);
+		if (p_resp->len > 0U) {
+			sp_spi_resp_head = (sp_spi_resp_head + 1U) % SP_SPI_RESP_QUEUE_SIZE;
+			sp_spi_resp_count++;
+		}
+	}
+	else {
+		__NOP();
 	}
 
 	while(bsp_sp_CY15B108QN_is_busy()) {
@@ -306,9 +505,10 @@ __weak bool bsp_sp_cmd_handler(void) {
 	}
 
 	if ((HAL_GPIO_ReadPin(BLE_RDY_GPIO_Port, BLE_RDY_Pin) == GPIO_PIN_SET) && (HAL_GPIO_ReadPin(BLE_REQ_GPIO_Port, BLE_REQ_Pin) == GPIO_PIN_RESET)) { /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
-		if (sp_spi.tx.len > 0U) {
-			bsp_sp_nRF52810_write(sp_spi.tx.data, sp_spi.tx.len);
-			sp_spi.tx.len = 0U;
+		if (sp_spi_resp_count > 0U) {
+			bsp_sp_nRF52810_write(sp_spi_resp_queue[sp_spi_resp_tail].data, sp_spi_resp_queue[sp_spi_resp_tail].len);
+			sp_spi_resp_tail = (sp_spi_resp_tail + 1U) % SP_SPI_RESP_QUEUE_SIZE;
+			sp_spi_resp_count--;
 		}
 		else if (active_spi_tx.len > 0U){
 			bsp_sp_nRF52810_write(active_spi_tx.data, active_spi_tx.len);
@@ -321,7 +521,12 @@ __weak bool bsp_sp_cmd_handler(void) {
 
 	//Debug Port
 	if (sp_uart.rx.len > 0U) {
-		sp_uart.tx.len = cmdParser((uint8_t*)sp_uart.rx.data, &sp_uart.rx.len, (uint8_t*)sp_uart.tx.data);
+		uint8_t rx_len = sp_uart.rx.len;
+		sp_uart.tx.len = cmdParser((uint8_t*)sp_uart.rx.data, &sp_uart.rx.head, &sp_uart.rx.len, (uint8_t*)sp_uart.tx.data);
+		//The debug port receives each command at once, a command not complete is dropped
+		if (sp_uart.rx.len == rx_len) {
+			sp_uart.rx.len = 0U;
+		}
 		activated = true;
 	}
 
@@ -351,10 +556,18 @@ void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi) {
   */
 void HAL_SPI_AbortCpltCallback(SPI_HandleTypeDef *hspi) { /* parasoft-suppress MISRAC2012-RULE_8_13-a "This definition comes from HAL." */
 	if (hspi == &HANDLE_NRF52810_CY15B108QN_SPI) {
-		(void)memset(&sp_spi, 0, sizeof(sp_spi));
+		(void)memset(&sp_spi_rx, 0, sizeof(sp_spi_rx));
+		sp_spi_rx_wait = false;
+		sp_spi_resp_head = 0;
+		sp_spi_resp_tail = 0;
+		sp_spi_resp_count = 0;
 		HAL_GPIO_WritePin(SPI1_BLE_CSn_GPIO_Port, SPI1_BLE_CSn_Pin, GPIO_PIN_SET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
 		HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_SET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
-		CY15B108QN_mem_wr_opcode = 0;
+		CY15B108QN_mem_wr_state = CY15B108QN_WR_STATE_IDLE;
+		CY15B108QN_mem_wr_head = 0;
+		CY15B108QN_mem_wr_tail = 0;
+		CY15B108QN_mem_wr_count = 0;
+		CY15B108QN_mem_rd_busy = false;
 	}
 }
 
@@ -368,22 +581,37 @@ void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi) /* parasoft-suppress MISRAC
 {
 	if (hspi == &HANDLE_NRF52810_CY15B108QN_SPI) {
 		if (HAL_GPIO_ReadPin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin) == GPIO_PIN_RESET) { /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
-			HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_SET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
-			if (CY15B108QN_mem_wr_opcode == CY15B108QN_CMD_WREN) {
-				CY15B108QN_mem_wr_opcode = CY15B108QN_CMD_WRITE;
+			const CY15B108QN_Write_Req_t* p_req = &CY15B108QN_mem_wr_queue[CY15B108QN_mem_wr_tail];
+			if (CY15B108QN_mem_wr_state == CY15B108QN_WR_STATE_WREN) {
+				HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_SET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
+				CY15B108QN_mem_wr_state = CY15B108QN_WR_STATE_HEADER;
 				uint32_t micros = HAL_RCC_GetSysClockFreq() / 4000000UL;
 			    while(micros > 0U) {
 			    	micros--;
 			    }
 				HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_RESET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
-				HAL_ERROR_CHECK(HAL_SPI_Transmit_IT(&HANDLE_NRF52810_CY15B108QN_SPI, CY15B108QN_mem_wr_buffer, CY15B108QN_mem_wr_len));
+				HAL_ERROR_CHECK(HAL_SPI_Transmit_IT(&HANDLE_NRF52810_CY15B108QN_SPI, CY15B108QN_mem_wr_header, (uint16_t)sizeof(CY15B108QN_mem_wr_header)));
+			}
+			else if (CY15B108QN_mem_wr_state == CY15B108QN_WR_STATE_HEADER) {
+				//CS stays low, the data is sent straight from the caller's buffer
+				CY15B108QN_mem_wr_state = CY15B108QN_WR_STATE_DATA;
+				HAL_ERROR_CHECK(HAL_SPI_Transmit_IT(&HANDLE_NRF52810_CY15B108QN_SPI, p_req->p_data, p_req->data_len));
 			}
-			else if (CY15B108QN_mem_wr_opcode == CY15B108QN_CMD_WRITE) {
-				CY15B108QN_mem_wr_opcode = 0;
-				CY15B108QN_writeCallback(CY15B108QN_mem_wr_address, CY15B108QN_mem_wr_datalen);
+			else if (CY15B108QN_mem_wr_state == CY15B108QN_WR_STATE_DATA) {
+				HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_SET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
+				uint32_t write_addr = p_req->addr;
+				uint16_t write_size = p_req->data_len;
+				CY15B108QN_mem_wr_tail = (CY15B108QN_mem_wr_tail + 1U) % CY15B108QN_WR_QUEUE_SIZE;
+				CY15B108QN_mem_wr_count--;
+				CY15B108QN_mem_wr_state = CY15B108QN_WR_STATE_IDLE;
+
+				//The callback may queue another write, which then starts by itself
+				CY15B108QN_writeCallback(write_addr, write_size);
+				bsp_sp_CY15B108QN_write_next();
 			}
 			else {
-				CY15B108QN_mem_wr_opcode = 0;
+				HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_SET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
+				CY15B108QN_mem_wr_state = CY15B108QN_WR_STATE_IDLE;
 			}
 		}
 	}
@@ -392,6 +620,28 @@ void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi) /* parasoft-suppress MISRAC
 	}
 }
 
+/**
+  * @brief Rx Transfer completed callback.
+  * @param  hspi: pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @retval None
+  */
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi) /* parasoft-suppress MISRAC2012-RULE_8_13-a "This definition comes from HAL." */
+{
+	if ((hspi == &HANDLE_NRF52810_CY15B108QN_SPI) && CY15B108QN_mem_rd_busy) {
+		HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_SET); /* parasoft-suppress MISRAC2012-RULE_11_4-a "This definition comes from HAL." */
+		CY15B108QN_mem_rd_busy = false;
+		if (CY15B108QN_readCallback != NULL) {
+			CY15B108QN_readCallback(CY15B108QN_mem_rd_address, CY15B108QN_mem_rd_len);
+		}
+		//The writes queued while the read was in flight start now
+		bsp_sp_CY15B108QN_write_next();
+	}
+	else {
+		__NOP();
+	}
+}
+
 /**
   * @brief  UART error callback.
   * @param  huart UART handle.
@@ -411,6 +661,7 @@ void HAL_UART_AbortCpltCallback(UART_HandleTypeDef *huart) /* parasoft-suppress
 {
 	if (huart == &HANDLE_DEBUG_UART) {
 		sp_uart.rx.len = 0;
+		sp_uart.rx.head = 0;
 		HAL_ERROR_CHECK(HAL_UARTEx_ReceiveToIdle_IT(&HANDLE_DEBUG_UART, sp_uart.rx.data, (uint16_t)sizeof(sp_uart.rx.data)));
 	}
 }
@@ -425,6 +676,7 @@ void HAL_UART_AbortCpltCallback(UART_HandleTypeDef *huart) /* parasoft-suppress
 void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) /* parasoft-suppress MISRAC2012-RULE_8_13-a "This definition comes from HAL." */
 {
 	if (huart == &HANDLE_DEBUG_UART) {
+		sp_uart.rx.head = 0;
 		sp_uart.rx.len = (uint8_t)Size;
 		HAL_ERROR_CHECK(HAL_UARTEx_ReceiveToIdle_IT(&HANDLE_DEBUG_UART, sp_uart.rx.data, (uint16_t)sizeof(sp_uart.rx.data)));
 	}
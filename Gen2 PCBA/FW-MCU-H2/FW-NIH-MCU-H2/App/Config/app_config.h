@@ -11,6 +11,7 @@
 #include "app_func_authentication.h"
 #include "app_func_ble.h"
 #include "app_func_command.h"
+#include "app_func_job.h"
 #include "app_func_logs.h"
 #include "app_func_measurement.h"
 #include "app_func_parameter.h"
@@ -30,6 +30,31 @@ typedef struct {
  */
 bool app_func_auth_verify_sign_admin(ECDSA_Data_t ecdsa_data);
 
+/**
+ * @brief Start hashing the firmware image in FRAM, the first packet is read
+ *
+ * @param img_size The size of the firmware image to verify, larger than 0
+ */
+void app_func_auth_fram_hash_start(uint32_t img_size);
+
+/**
+ * @brief Hash the next packets of the firmware image in FRAM, so a long verification can be split into steps
+ *
+ * @param pkt_num The maximum number of packets to hash in this step
+ * @param p_progress The progress of the verification, unit: %
+ * @return true Only the last packet is left, app_func_auth_fram_hash_end() finishes the verification
+ * @return false More packets are left to hash
+ */
+bool app_func_auth_fram_hash_step(uint16_t pkt_num, uint8_t* p_progress);
+
+/**
+ * @brief Hash the last packet of the firmware image in FRAM and compare the hash message with the ECDSA signature
+ *
+ * @param abort Whether the verification is aborted, the hash is finished but neither compared nor counted as a failure
+ * @return uint8_t* Pointer of the number of failed verifications, 0 means verification passed. It is reset when verifying the ECDSA signature.
+ */
+uint8_t* app_func_auth_fram_hash_end(bool abort);
+
 /**
  * @brief Compare the hash message from FRAM and the ECDSA signature
  *
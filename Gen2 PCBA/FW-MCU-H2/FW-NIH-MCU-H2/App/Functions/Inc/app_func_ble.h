@@ -51,6 +51,13 @@ void app_func_ble_enable(bool enable);
  */
 void app_func_ble_adv_start(BLE_ADV_Setting_t* p_setting);
 
+/**
+ * @brief Update the Manufacturer Specific Data of the running BLE advertising
+ * 
+ * @param p_setting BLE advertising settings
+ */
+void app_func_ble_adv_msd_update(BLE_ADV_Setting_t* p_setting);
+
 /**
  * @brief Disconnect BLE connection
  * 
@@ -14,6 +14,7 @@
 #define OP_BLE_DISCONNECT     						0x53U	/*!< The opcode of the command "BLE_DISCONNECT" */
 #define OP_BLE_WL_ADD         						0x54U	/*!< The opcode of the command "BLE_WL_ADD" */
 #define OP_BLE_DEL_PEERS                        	0x55U	/*!< The opcode of the command "BLE_DEL_PEERS" */
+#define OP_BLE_ADV_MSD_UPDATE                      	0x57U	/*!< The opcode of the command "BLE_ADV_MSD_UPDATE" */
 
 //SYS Commands
 #define OP_AUTH                        				0xF0U	/*!< The opcode of the command "AUTH" */
@@ -43,6 +44,17 @@
 #define OP_ERASE_IPG_LOG                			0xAFU	/*!< The opcode of the command "ERASE_IPG_LOG" */
 #define OP_READ_TIME_AND_DATE           			0xB0U	/*!< The opcode of the command "READ_TIME_AND_DATE" */
 #define OP_WRITE_TIME_AND_DATE          			0xB1U	/*!< The opcode of the command "WRITE_TIME_AND_DATE" */
+#define OP_MEASURE_IMPEDANCE_SURVEY        			0xB2U	/*!< The opcode of the command "MEASURE_IMPEDANCE_SURVEY" */
+#define OP_READ_PARAMETERS_BATCH        			0xB3U	/*!< The opcode of the command "READ_PARAMETERS_BATCH" */
+#define OP_WRITE_PARAMETERS_BATCH        			0xB4U	/*!< The opcode of the command "WRITE_PARAMETERS_BATCH" */
+#define OP_SELECT_THERAPY_PROFILE        			0xB5U	/*!< The opcode of the command "SELECT_THERAPY_PROFILE" */
+#define OP_READ_THERAPY_PROFILE        				0xB6U	/*!< The opcode of the command "READ_THERAPY_PROFILE" */
+#define OP_WRITE_THERAPY_PROFILE        			0xB7U	/*!< The opcode of the command "WRITE_THERAPY_PROFILE" */
+#define OP_JOB_START        						0xB8U	/*!< The opcode of the command "JOB_START" */
+#define OP_JOB_STATUS        						0xB9U	/*!< The opcode of the command "JOB_STATUS" */
+#define OP_JOB_ABORT        						0xBAU	/*!< The opcode of the command "JOB_ABORT" */
+#define OP_JOB_NOTIFY        						0xBBU	/*!< The opcode of the notification "JOB_NOTIFY", only sent by the IPG */
+#define OP_SEQ        								0xBCU	/*!< The opcode of the command "SEQ", carries the sequence number and another command, so the remote end can keep several commands outstanding */
 
 //DVT Commands
 #define OP_PING                                    	0x00U	/*!< The opcode of the command "PING" */
@@ -130,6 +142,7 @@
 #define STATUS_PAYLOAD_LEN_ERR    					0xF1U	/*!< Code for payload length error status */
 #define STATUS_OPCODE_ERR            				0xF2U	/*!< Code for opcode error status */
 #define STATUS_USER_CLASS_ERR    					0xF3U	/*!< Code for user class error status */
+#define STATUS_BUSY    								0xF4U	/*!< Code for busy status, the command was not run because too many responses were waiting, it can be sent again */
 
 //XL board error status
 #define STATUS_START_ACC_BUFFER_OVERFLOW	        0x01U	/*!< Code for buffer overflow */
@@ -148,6 +161,7 @@
 #define LEN_CRC 	 								2U											/*!< The length of the command CRC */
 #define LEN_REQ_PAYLOAD_MAX							(LEN_CMD_MAX - LEN_REQ_HEADER - LEN_CRC)	/*!< The maximum length of the request command payload */
 #define LEN_RESP_PAYLOAD_MAX						(LEN_CMD_MAX - LEN_RESP_HEADER - LEN_CRC)	/*!< The maximum length of the response command payload */
+#define LEN_SEQ_HEADER								2U											/*!< The length of the header of the command "SEQ": the sequence number and the opcode of the command carried */
 
 typedef struct {
 	uint8_t Opcode;			/*!< The opcode of the command */
@@ -162,8 +176,21 @@ typedef struct {
 	uint8_t PayloadLen;		/*!< The payload length of the command */
 } Cmd_Resp_t;
 
-typedef Cmd_Resp_t (*Cmd_Req_Parser)(Cmd_Req_t cmd_req);	/*!< The format of the request command parser */
-typedef void (*Cmd_Resp_Parser)(Cmd_Resp_t cmd_resp);		/*!< The format of the request command parser */
+typedef void (*Cmd_Req_Parser)(const Cmd_Req_t* p_cmd_req, Cmd_Resp_t* p_cmd_resp);	/*!< The format of the request command parser, the response payload points to LEN_RESP_PAYLOAD_MAX bytes in the response command */
+typedef void (*Cmd_Resp_Parser)(const Cmd_Resp_t* p_cmd_resp);						/*!< The format of the response command parser */
+
+typedef struct {
+	Cmd_Req_Parser	Handler;		/*!< The handler of the request command, NULL if the opcode is not supported */
+	uint8_t 		LenMin;			/*!< The minimum payload length of the request command */
+	uint8_t 		LenMax;			/*!< The maximum payload length of the request command */
+	uint8_t 		UserClass;		/*!< The minimum user class of the remote end to run the request command */
+} Cmd_Entry_t;
+
+typedef struct {
+	const Cmd_Entry_t*	Entries;		/*!< The entries of the table, indexed by the opcode minus OpcodeFirst */
+	uint8_t 			OpcodeFirst;	/*!< The opcode of the first entry */
+	uint8_t 			Num;			/*!< The number of entries */
+} Cmd_Table_t;
 
 /**
  * @brief Update parser for request commands
@@ -180,27 +207,43 @@ void app_func_command_req_parser_set(Cmd_Req_Parser new_cmd_req_parser);
 void app_func_command_resp_parser_set(Cmd_Resp_Parser new_cmd_resp_parser);
 
 /**
- * @brief Parser for all commands, used to confirm whether the command is a request command or a response command
- * 
+ * @brief Parser for all commands, used to confirm whether the command is a request command or a response command.
+ * One command is parsed in place each call and the received data is never moved, only the head index advances.
+ * Without room for the response, the data to be transferred is NULL: a request command is not run and is replied
+ * busy by a later call with no data received, which writes the reply of one such command.
+ *
  * @param p_data_rx The data received
- * @param p_data_rx_len The length of data received
- * @param p_data_tx The data to be transferred
+ * @param p_data_rx_head The index of the first data not parsed yet, reset to 0 when all data is parsed
+ * @param p_data_rx_len The length of data received and not parsed yet
+ * @param p_data_tx The data to be transferred, NULL if a response cannot be transferred
  * @return uint8_t The length of data to be transferred
  */
-uint8_t app_func_command_parser(uint8_t* p_data_rx, uint8_t* p_data_rx_len, uint8_t* p_data_tx);
+uint8_t app_func_command_parser(uint8_t* p_data_rx, uint8_t* p_data_rx_head, uint8_t* p_data_rx_len, uint8_t* p_data_tx);
+
+/**
+ * @brief Dispatch the request command to its handler in the command tables.
+ * The payload length and the user class are checked against the entry before the handler runs.
+ *
+ * @param p_tables The command tables, each covering a contiguous range of opcodes
+ * @param table_num The number of command tables
+ * @param user_class The user class of the remote end
+ * @param p_req Request command to be dispatched
+ * @param p_resp The response command to be replied
+ */
+void app_func_command_dispatch(const Cmd_Table_t* p_tables, uint8_t table_num, uint8_t user_class, const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp);
 
 /**
  * @brief Generate and send a request command
  * 
- * @param cmd The definition of the request command to be generated
+ * @param p_cmd The definition of the request command to be generated
  */
-void app_func_command_req_send(Cmd_Req_t cmd);
+void app_func_command_req_send(const Cmd_Req_t* p_cmd);
 
 /**
  * @brief Generate and send a response command
  *
- * @param cmd The definition of the response command to be generated
+ * @param p_cmd The definition of the response command to be generated
  */
-void app_func_command_resp_send(Cmd_Resp_t cmd);
+void app_func_command_resp_send(const Cmd_Resp_t* p_cmd);
 
 #endif /* FUNCTIONS_INC_APP_FUNC_COMMAND_H_ */
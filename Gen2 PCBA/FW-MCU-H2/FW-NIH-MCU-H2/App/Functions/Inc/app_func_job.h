@@ -0,0 +1,107 @@
+/**
+ * @file app_func_job.h
+ * @brief This file contains all the function prototypes for the app_func_job.c file
+ * @copyright Copyright (c) 2024
+ */
+#ifndef FUNCTIONS_INC_APP_FUNC_JOB_H_
+#define FUNCTIONS_INC_APP_FUNC_JOB_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_func_command.h"
+
+#define JOB_STATE_IDLE				0x00U		/*!< No job has been started */
+#define JOB_STATE_RUNNING			0x01U		/*!< The job is running */
+#define JOB_STATE_DONE				0x02U		/*!< The job is finished and its result is available */
+#define JOB_STATE_ABORTED			0x03U		/*!< The job was aborted before finishing */
+
+#define JOB_NOTIFY_PROGRESS_STEP	10U			/*!< The progress notification is sent each time the progress passes a multiple of this step, unit: % */
+
+#define LEN_JOB_INFO				4U										/*!< The length of the job information: job ID, opcode, state and progress */
+#define LEN_JOB_RESULT_MAX			(LEN_RESP_PAYLOAD_MAX - LEN_JOB_INFO)	/*!< The maximum length of the job result, following the job information */
+
+/**
+ * @brief The format of a job step, one slice of a long-running command run from the main loop.
+ * The result payload points to LEN_JOB_RESULT_MAX bytes that are kept between the steps.
+ *
+ * @param p_result The status and the payload of the job result, valid when the job is finished
+ * @param p_progress The progress of the job, unit: %
+ * @return true The job is finished
+ * @return false The job needs more steps
+ */
+typedef bool (*Job_Step)(Cmd_Resp_t* p_result, uint8_t* p_progress);
+
+/**
+ * @brief The format of a job abort, used to put the hardware back to idle when the job is not finished
+ *
+ */
+typedef void (*Job_Abort)(void);
+
+/**
+ * @brief Start a job for the long-running command, the response command is replied with the job information at once
+ *
+ * @param opcode The opcode of the long-running command
+ * @param step The step of the job
+ * @param abort The abort of the job, NULL if nothing needs to be undone
+ * @param user_class The user class of the remote end, only the same or a higher user class can access the job
+ * @param p_resp The response command to be replied
+ */
+void app_func_job_start(uint8_t opcode, Job_Step step, Job_Abort abort, uint8_t user_class, Cmd_Resp_t* p_resp);
+
+/**
+ * @brief Check whether a job is running
+ *
+ * @return true A job is running
+ * @return false No job is running
+ */
+bool app_func_job_is_running(void);
+
+/**
+ * @brief Abort the running job and forget the result of the last job, used when the remote end that started it is gone
+ *
+ */
+void app_func_job_clear(void);
+
+/**
+ * @brief Abort the running job, nothing happens if no job is running
+ *
+ */
+void app_func_job_abort(void);
+
+/**
+ * @brief Handler for jobs, runs one step of the running job and sends the notification "JOB_NOTIFY" on progress or completion
+ *
+ * @return true A job is running or its notification is not sent yet, call again from the main loop
+ * @return false Nothing to do
+ */
+bool app_func_job_handler(void);
+
+/**
+ * @brief Handler for the command "JOB_START", the payload is the opcode and the payload of the long-running command
+ *
+ * @param p_tables The command tables of the long-running commands
+ * @param table_num The number of command tables
+ * @param user_class The user class of the remote end
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+void app_func_job_cmd_start(const Cmd_Table_t* p_tables, uint8_t table_num, uint8_t user_class, const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp);
+
+/**
+ * @brief Handler for the command "JOB_STATUS", the payload is the job ID
+ *
+ * @param user_class The user class of the remote end
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+void app_func_job_cmd_status(uint8_t user_class, const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp);
+
+/**
+ * @brief Handler for the command "JOB_ABORT", the payload is the job ID
+ *
+ * @param user_class The user class of the remote end
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+void app_func_job_cmd_abort(uint8_t user_class, const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp);
+
+#endif /* FUNCTIONS_INC_APP_FUNC_JOB_H_ */
@@ -41,6 +41,12 @@ typedef struct {
  */
 void app_func_logs_init(void);
 
+/**
+ * @brief Save the log pointer of all logs written to FRAM
+ *
+ */
+void app_func_logs_flush(void);
+
 /**
  * @brief Write the event to the log
  * 
@@ -64,6 +70,14 @@ void app_func_logs_batt_volt_write(uint16_t vbatA, uint16_t vbatB);
  */
 void app_func_logs_imped_write(uint32_t imp);
 
+/**
+ * @brief Write the impedance survey of all electrode pairs to log as a single record
+ *
+ * @param p_imp The impedance of each electrode pair, unit: ohm
+ * @param num The number of electrode pairs
+ */
+void app_func_logs_imped_survey_write(const uint16_t* p_imp, uint8_t num);
+
 /**
  * @brief Write the update of parameters to the log
  * 
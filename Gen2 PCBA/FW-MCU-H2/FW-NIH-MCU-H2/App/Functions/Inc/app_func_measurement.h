@@ -30,6 +30,9 @@
 #define	IMPIN_CH_P			ADC4_CHANNEL_IMP_INA
 #define	IMPIN_CH_N			ADC4_CHANNEL_IMP_INB
 
+#define	BATT_MON_SAMPLE_NUM		100U	/*!< The number of samples of each battery in a battery measurement */
+#define	BATT_MON_SAMPLE_FREQ	100U	/*!< The sampling frequency of the battery monitor, unit: Hz */
+
 /**
  * @brief Enable / Disable battery monitor
  * 
@@ -45,6 +48,24 @@ void app_func_meas_batt_mon_enable(bool enable);
  */
 void app_func_meas_batt_mon_meas(uint16_t* p_vbatA, uint16_t* p_vbatB);
 
+/**
+ * @brief The battery monitor samples both batteries and adds the samples to the sums, so a measurement can be split into slices
+ *
+ * @param sample_num The number of samples of each battery, up to BATT_MON_SAMPLE_NUM
+ * @param p_sumA The sum of the samples of battery 1
+ * @param p_sumB The sum of the samples of battery 2
+ */
+void app_func_meas_batt_mon_sum(uint16_t sample_num, uint32_t* p_sumA, uint32_t* p_sumB);
+
+/**
+ * @brief Convert the sum of the battery monitor samples to the battery voltage
+ *
+ * @param sum The sum of the samples
+ * @param sample_num The number of samples
+ * @return uint16_t The battery voltage, unit: mV
+ */
+uint16_t app_func_meas_batt_mon_volt_calc(uint32_t sum, uint16_t sample_num);
+
 /**
  * @brief Enable / disable the impedance monitor.
  *
@@ -89,6 +89,12 @@
 #define LEN_ID							4U					/*!< The length of the parameter ID */
 #define LEN_FORMAT_VALUE				sizeof(_Float64)	/*!< The length of the parameter value */
 #define LEN_STEP						sizeof(uint16_t)	/*!< The length of the parameter step */
+#define LEN_PARA_DATA_MAX				2048U				/*!< The maximum data length of all parameters */
+#define THERAPY_PROFILE_NUM				4U					/*!< The number of therapy profiles, each with its own stimulation parameters */
+#define THERAPY_PROFILE_ACTIVE			0xFFU				/*!< Refer to the therapy profile that is active */
+#define PARA_SUBSCRIBER_NUM_MAX			8U					/*!< The maximum number of parameter change subscribers */
+
+typedef void (*Parameter_Change_Callback)(const uint8_t* p_id);
 
 typedef struct {
 	uint64_t buffer;					/*!< Data buffer for each virtual address */
@@ -114,16 +120,46 @@ typedef struct {
 
 typedef struct {
 	uint8_t 			id[LEN_ID];		/*!< The ID of the parameter */
-	uint16_t 			virtAddress;	/*!< The virtual address of the parameter */
+	uint16_t 			virtAddress;	/*!< The virtual address of the parameter in the EEPROM, only used to migrate from earlier firmware */
 	Parameter_Format_t 	format;			/*!< The data format of the parameter */
+	uint16_t 			dataOffset;		/*!< The offset of the parameter data in the parameter image */
 } Parameter_t;
 
+typedef struct {
+	uint32_t 	Magic;					/*!< The magic number of the parameter image */
+	uint16_t 	IdCrc;					/*!< The CRC of the parameter IDs, changed with the parameter layout */
+	uint16_t 	DataLen;				/*!< The data length of all parameters */
+	uint8_t 	Profile;				/*!< The therapy profile that is active */
+	uint8_t 	Reserved[3];			/*!< Reserved */
+} Parameter_Image_Header_t;
+
+typedef struct {
+	uint8_t 					id[LEN_ID];		/*!< The ID of the parameter subscribed */
+	Parameter_Change_Callback 	callback;		/*!< Callback when the parameter changes */
+} Parameter_Subscriber_t;
+
+typedef struct {
+	Parameter_Image_Header_t 	Header;						/*!< The header of the parameter image */
+	uint8_t 					Data[LEN_PARA_DATA_MAX];	/*!< The data of all parameters, followed by the CRC of the image in FRAM */
+} Parameter_Image_t;
+
 /**
  * @brief Parameter buffer initialization
  * 
  */
 void app_func_para_init (void);
 
+/**
+ * @brief Subscribe to the changes of the parameter. The callback is called once at subscription with the current data,
+ * then after each change of the parameter.
+ *
+ * @param p_id Parameter ID
+ * @param callback Callback when the parameter changes
+ * @return true The subscription is added
+ * @return false The parameter ID is invalid or there are too many subscribers
+ */
+bool app_func_para_subscribe(const uint8_t* p_id, Parameter_Change_Callback callback);
+
 /**
  * @brief Get the data type based on the parameter ID
  *
@@ -146,6 +182,15 @@ uint8_t app_func_para_datalen_get(const uint8_t* p_id);
  */
 void app_func_para_data_set(const uint8_t* p_id, uint8_t* p_data);
 
+/**
+ * @brief Set the data of several parameters with a single update of the parameter image in FRAM
+ *
+ * @param p_ids The IDs of the parameters
+ * @param p_datas The data corresponding to each parameter ID. If an entry is null, the default data is written
+ * @param num The number of parameters
+ */
+void app_func_para_data_set_batch(const uint8_t* const p_ids[], const uint8_t* const p_datas[], uint8_t num);
+
 /**
  * @brief Get the data based on the parameter ID
  *
@@ -155,6 +200,52 @@ void app_func_para_data_set(const uint8_t* p_id, uint8_t* p_data);
  */
 void app_func_para_data_get(const uint8_t* p_id, uint8_t* p_data, uint8_t buff_size);
 
+/**
+ * @brief Check whether the parameter is kept separately for each therapy profile
+ *
+ * @param p_id Parameter ID
+ * @return true The parameter is a stimulation parameter of the therapy profiles
+ * @return false The parameter is shared by all therapy profiles, or the parameter ID is invalid
+ */
+bool app_func_para_profile_contains(const uint8_t* p_id);
+
+/**
+ * @brief Get the therapy profile that is active
+ *
+ * @return uint8_t The index of the active therapy profile
+ */
+uint8_t app_func_para_profile_get(void);
+
+/**
+ * @brief Select the active therapy profile. Only the profile index in the parameter image is written,
+ * so the stimulation parameters switch all at once and are used from the next therapy start.
+ *
+ * @param profile The index of the therapy profile
+ * @return true The therapy profile is selected
+ * @return false The profile index is invalid
+ */
+bool app_func_para_profile_select(uint8_t profile);
+
+/**
+ * @brief Set the data of several parameters of a therapy profile with a single update of the parameter image in FRAM
+ *
+ * @param profile The index of the therapy profile, or THERAPY_PROFILE_ACTIVE
+ * @param p_ids The IDs of the parameters
+ * @param p_datas The data corresponding to each parameter ID. If an entry is null, the default data is written
+ * @param num The number of parameters
+ */
+void app_func_para_profile_data_set_batch(uint8_t profile, const uint8_t* const p_ids[], const uint8_t* const p_datas[], uint8_t num);
+
+/**
+ * @brief Get the data of a therapy profile based on the parameter ID
+ *
+ * @param profile The index of the therapy profile, or THERAPY_PROFILE_ACTIVE
+ * @param p_id Parameter ID
+ * @param p_data The data corresponding to the parameter ID
+ * @param buff_size The data buffer size of p_data
+ */
+void app_func_para_profile_data_get(uint8_t profile, const uint8_t* p_id, uint8_t* p_data, uint8_t buff_size);
+
 /**
  * @brief Get the default data based on the parameter ID
  *
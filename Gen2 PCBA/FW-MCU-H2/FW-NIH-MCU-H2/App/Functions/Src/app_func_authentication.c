@@ -24,6 +24,20 @@ static const ECC_PublicKey_t PublicKey_Admin = {
 
 static ECDSA_Data_t fw_image_ecdsa_data;
 static uint8_t hash_verify_fail_num = 0;
+static uint8_t image_data_next[SIZE_FW_IMG_PKG];
+static volatile bool image_read_cplt = false;
+static uint8_t* p_hash_data_curr = imagePacket.ImageData;
+static uint8_t* p_hash_data_next = image_data_next;
+
+/**
+ * @brief FRAM read completion callback of the image data
+ *
+ * @param read_addr The address of the data read
+ * @param read_size The size of the data read
+ */
+static void app_func_auth_image_read_cplt_cb(uint32_t read_addr, uint16_t read_size) {
+	image_read_cplt = true;
+}
 
 /**
  * @brief Verify ECDSA signature is Admin class
@@ -61,31 +75,74 @@ bool app_func_auth_verify_sign_admin(ECDSA_Data_t ecdsa_data) {
 }
 
 /**
- * @brief Compare the hash message from FRAM and the ECDSA signature
- * 
- * @param img_size The size of the firmware image to verify
+ * @brief Start hashing the firmware image in FRAM, the first packet is read
+ *
+ * @param img_size The size of the firmware image to verify, larger than 0
+ */
+void app_func_auth_fram_hash_start(uint32_t img_size) {
+	imagePacket.ImageDataOffset = 0;
+	image_info.ImageSize = img_size;
+
+	uint32_t datasize = SIZE_FW_IMG_PKG;
+	p_hash_data_curr = imagePacket.ImageData;
+	p_hash_data_next = image_data_next;
+	bool last_packet = (img_size <= datasize);
+	bsp_fram_read((uint32_t)ADDR_FW_IMG_BASE, p_hash_data_curr, (uint16_t)(last_packet ? img_size : datasize));
+}
+
+/**
+ * @brief Hash the next packets of the firmware image in FRAM, so a long verification can be split into steps
+ *
+ * @param pkt_num The maximum number of packets to hash in this step
+ * @param p_progress The progress of the verification, unit: %
+ * @return true Only the last packet is left, app_func_auth_fram_hash_end() finishes the verification
+ * @return false More packets are left to hash
+ */
+bool app_func_auth_fram_hash_step(uint16_t pkt_num, uint8_t* p_progress) {
+	uint32_t img_size = image_info.ImageSize;
+	uint32_t datasize = SIZE_FW_IMG_PKG;
+	bool last_packet = ((img_size - imagePacket.ImageDataOffset) <= datasize);
+
+	//The next packet is read from FRAM while the current one is being hashed
+	for(uint16_t i=0;(i<pkt_num) && !last_packet;i++) {
+		bsp_wdg_refresh();
+		uint32_t next_offset = imagePacket.ImageDataOffset + datasize;
+		last_packet = ((img_size - next_offset) <= datasize);
+		image_read_cplt = false;
+		bsp_fram_read_IT((uint32_t)ADDR_FW_IMG_BASE + next_offset, p_hash_data_next, (uint16_t)(last_packet ? (img_size - next_offset) : datasize), &app_func_auth_image_read_cplt_cb);
+
+		while(HAL_HASH_GetState(&hhash) != HAL_HASH_STATE_READY) {
+			__NOP();
+		};
+		HAL_ERROR_CHECK(HAL_HASHEx_SHA256_Accmlt(&hhash, p_hash_data_curr, datasize));
+		while(!image_read_cplt) {
+			__NOP();
+		};
+
+		uint8_t* p_data_swap = p_hash_data_curr;
+		p_hash_data_curr = p_hash_data_next;
+		p_hash_data_next = p_data_swap;
+		imagePacket.ImageDataOffset = next_offset;
+	}
+
+	*p_progress = (uint8_t)(((uint64_t)imagePacket.ImageDataOffset * 100U) / img_size);
+	return last_packet;
+}
+
+/**
+ * @brief Hash the last packet of the firmware image in FRAM and compare the hash message with the ECDSA signature
+ *
+ * @param abort Whether the verification is aborted, the hash is finished but neither compared nor counted as a failure
  * @return uint8_t* Pointer of the number of failed verifications, 0 means verification passed. It is reset when verifying the ECDSA signature.
  */
-uint8_t* app_func_auth_compare_fram_hash(uint32_t img_size) {
-	if (img_size > 0U) {
-		imagePacket.ImageDataOffset = 0;
-		image_info.ImageSize = img_size;
-
-		uint32_t accmlt_size = img_size - 1U;
-		uint32_t datasize = SIZE_FW_IMG_PKG;
-		while((accmlt_size - imagePacket.ImageDataOffset) > datasize) {
-			bsp_wdg_refresh();
-			bsp_fram_read((uint32_t)ADDR_FW_IMG_BASE + imagePacket.ImageDataOffset, imagePacket.ImageData, (uint16_t)datasize);
-			while(HAL_HASH_GetState(&hhash) != HAL_HASH_STATE_READY) {
-				__NOP();
-			};
-			HAL_ERROR_CHECK(HAL_HASHEx_SHA256_Accmlt(&hhash, imagePacket.ImageData, datasize));
-			imagePacket.ImageDataOffset += datasize;
-		}
-		datasize = img_size - imagePacket.ImageDataOffset;
-		bsp_fram_read((uint32_t)ADDR_FW_IMG_BASE + imagePacket.ImageDataOffset, imagePacket.ImageData, (uint16_t)datasize);
-		HAL_ERROR_CHECK(HAL_HASHEx_SHA256_Accmlt_End(&hhash, imagePacket.ImageData, datasize, image_info.ImageHash, 10));
+uint8_t* app_func_auth_fram_hash_end(bool abort) {
+	uint32_t datasize = image_info.ImageSize - imagePacket.ImageDataOffset;
+	HAL_ERROR_CHECK(HAL_HASHEx_SHA256_Accmlt_End(&hhash, p_hash_data_curr, datasize, image_info.ImageHash, 10));
 
+	if (abort) {
+		(void)memset(&image_info, 0, sizeof(image_info));
+	}
+	else {
 		if (memcmp(fw_image_ecdsa_data.HashMsg, image_info.ImageHash, sizeof(fw_image_ecdsa_data.HashMsg)) == 0) {
 			hash_verify_fail_num = 0;
 		}
@@ -95,10 +152,29 @@ uint8_t* app_func_auth_compare_fram_hash(uint32_t img_size) {
 		}
 		bsp_fram_write((uint32_t)ADDR_FW_IMG_INFO, (uint8_t*)&image_info, (uint16_t)(sizeof(image_info)), true);
 	}
+	return &hash_verify_fail_num;
+}
+
+/**
+ * @brief Compare the hash message from FRAM and the ECDSA signature
+ * 
+ * @param img_size The size of the firmware image to verify
+ * @return uint8_t* Pointer of the number of failed verifications, 0 means verification passed. It is reset when verifying the ECDSA signature.
+ */
+uint8_t* app_func_auth_compare_fram_hash(uint32_t img_size) {
+	uint8_t* p_fail_num = &hash_verify_fail_num;
+	if (img_size > 0U) {
+		uint8_t progress = 0;
+		app_func_auth_fram_hash_start(img_size);
+		while(!app_func_auth_fram_hash_step(UINT16_MAX, &progress)) {
+			__NOP();
+		}
+		p_fail_num = app_func_auth_fram_hash_end(false);
+	}
 	else {
 		hash_verify_fail_num++;
 	}
-	return &hash_verify_fail_num;
+	return p_fail_num;
 }
 
 /**
@@ -15,22 +15,22 @@ uint8_t magnet_reset_counter = 0;
 bool	ble_whitelist_added = false;
 bool	ble_peers_is_deleted = false;
 
-static void app_func_ble_resp_cmd_parser(Cmd_Resp_t resp) {
+static void app_func_ble_resp_cmd_parser(const Cmd_Resp_t* p_resp) {
     uint8_t len_payload_min = 0;
     uint8_t len_payload_max = 0;
 
-    switch(resp.Opcode) {
+    switch(p_resp->Opcode) {
 	case OP_BLE_STAT_GET:
 	{
-		if(resp.Status == STATUS_SUCCESS) {
+		if(p_resp->Status == STATUS_SUCCESS) {
 			len_payload_min = 1;
 			len_payload_max = 2;
-			if ((resp.PayloadLen >= len_payload_min) && (resp.PayloadLen <= len_payload_max)) {
-				uint8_t ble_state = *(resp.Payload);
+			if ((p_resp->PayloadLen >= len_payload_min) && (p_resp->PayloadLen <= len_payload_max)) {
+				uint8_t ble_state = *(p_resp->Payload);
 				app_func_ble_curr_state_update(ble_state);
 
-				if(resp.PayloadLen == 2U) {
-					uint8_t reason = resp.Payload[1];
+				if(p_resp->PayloadLen == 2U) {
+					uint8_t reason = p_resp->Payload[1];
 					app_func_ble_disc_reason_update(reason);
 				}
 			}
@@ -40,10 +40,10 @@ static void app_func_ble_resp_cmd_parser(Cmd_Resp_t resp) {
 
 	case OP_BLE_ADV_START:
 	{
-		if(resp.Status == STATUS_SUCCESS) {
+		if(p_resp->Status == STATUS_SUCCESS) {
 			len_payload_min = 0;
 			len_payload_max = 0;
-			if ((resp.PayloadLen >= len_payload_min) && (resp.PayloadLen <= len_payload_max)) {
+			if ((p_resp->PayloadLen >= len_payload_min) && (p_resp->PayloadLen <= len_payload_max)) {
 				app_func_ble_curr_state_update(BLE_STATE_ADV_START);
 			}
 		}
@@ -52,10 +52,10 @@ static void app_func_ble_resp_cmd_parser(Cmd_Resp_t resp) {
 
 	case OP_BLE_ADV_STOP:
 	{
-		if(resp.Status == STATUS_SUCCESS) {
+		if(p_resp->Status == STATUS_SUCCESS) {
 			len_payload_min = 0;
 			len_payload_max = 0;
-			if ((resp.PayloadLen >= len_payload_min) && (resp.PayloadLen <= len_payload_max)) {
+			if ((p_resp->PayloadLen >= len_payload_min) && (p_resp->PayloadLen <= len_payload_max)) {
 				app_func_ble_curr_state_update(BLE_STATE_ADV_STOP);
 			}
 		}
@@ -64,10 +64,10 @@ static void app_func_ble_resp_cmd_parser(Cmd_Resp_t resp) {
 
 	case OP_BLE_DISCONNECT:
 	{
-		if(resp.Status == STATUS_SUCCESS) {
+		if(p_resp->Status == STATUS_SUCCESS) {
 			len_payload_min = 0;
 			len_payload_max = 0;
-			if ((resp.PayloadLen >= len_payload_min) && (resp.PayloadLen <= len_payload_max)) {
+			if ((p_resp->PayloadLen >= len_payload_min) && (p_resp->PayloadLen <= len_payload_max)) {
 				app_func_ble_curr_state_update(BLE_STATE_ADV_STOP);
 			}
 		}
@@ -76,10 +76,10 @@ static void app_func_ble_resp_cmd_parser(Cmd_Resp_t resp) {
 
 	case OP_BLE_WL_ADD:
 	{
-		if(resp.Status == STATUS_SUCCESS) {
+		if(p_resp->Status == STATUS_SUCCESS) {
 			len_payload_min = 0;
 			len_payload_max = 0;
-			if ((resp.PayloadLen >= len_payload_min) && (resp.PayloadLen <= len_payload_max)) {
+			if ((p_resp->PayloadLen >= len_payload_min) && (p_resp->PayloadLen <= len_payload_max)) {
 				ble_whitelist_added = true;
 			}
 		}
@@ -88,10 +88,10 @@ static void app_func_ble_resp_cmd_parser(Cmd_Resp_t resp) {
 
 	case OP_BLE_DEL_PEERS:
 	{
-		if(resp.Status == STATUS_SUCCESS) {
+		if(p_resp->Status == STATUS_SUCCESS) {
 			len_payload_min = 0;
 			len_payload_max = 0;
-			if ((resp.PayloadLen >= len_payload_min) && (resp.PayloadLen <= len_payload_max)) {
+			if ((p_resp->PayloadLen >= len_payload_min) && (p_resp->PayloadLen <= len_payload_max)) {
 				ble_peers_is_deleted = true;
 			}
 		}
@@ -156,7 +156,22 @@ void app_func_ble_adv_start(BLE_ADV_Setting_t* p_setting) {
 			.Payload = (uint8_t*)p_setting,
 			.PayloadLen = (uint8_t)sizeof(BLE_ADV_Setting_t),
 	};
-	app_func_command_req_send(cmd);
+	app_func_command_req_send(&cmd);
+}
+
+/**
+ * @brief Update the Manufacturer Specific Data of the running BLE advertising
+ * The advertising keeps its mode and timeout, only the company ID and MSD are replaced.
+ * 
+ * @param p_setting BLE advertising settings
+ */
+void app_func_ble_adv_msd_update(BLE_ADV_Setting_t* p_setting) {
+	Cmd_Req_t cmd = {
+			.Opcode = OP_BLE_ADV_MSD_UPDATE,
+			.Payload = p_setting->companyid,
+			.PayloadLen = (uint8_t)(sizeof(p_setting->companyid) + sizeof(p_setting->msd)),
+	};
+	app_func_command_req_send(&cmd);
 }
 
 /**
@@ -169,7 +184,7 @@ void app_func_ble_disconnect(void) {
 			.Payload = NULL,
 			.PayloadLen = 0,
 	};
-	app_func_command_req_send(cmd);
+	app_func_command_req_send(&cmd);
 }
 
 /**
@@ -222,7 +237,7 @@ void app_func_ble_new_state_get(void) {
 			.Payload = NULL,
 			.PayloadLen = 0,
 	};
-	app_func_command_req_send(cmd);
+	app_func_command_req_send(&cmd);
 }
 
 /**
@@ -236,7 +251,7 @@ void app_func_ble_peers_del(void) {
 			.Payload = NULL,
 			.PayloadLen = 0,
 	};
-	app_func_command_req_send(cmd);
+	app_func_command_req_send(&cmd);
 }
 
 /**
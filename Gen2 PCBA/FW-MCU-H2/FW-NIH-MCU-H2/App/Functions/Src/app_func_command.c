@@ -8,32 +8,183 @@
 
 static Cmd_Req_Parser 	curr_cmd_req_parser = NULL;
 static Cmd_Resp_Parser	curr_cmd_resp_parser = NULL;
-static uint32_t crc_buffer[LEN_CMD_MAX/sizeof(uint32_t)];
+static uint8_t busy_seq[32];			/*!< The sequence numbers of the commands "SEQ" not run because the responses could not wait, a bit each */
+static uint8_t busy_seq_opcode[256];	/*!< The opcode carried by each command "SEQ" not run */
+static uint8_t busy_seq_last = 255U;		/*!< The sequence number replied busy last */
+static uint8_t busy_opcode = 0;			/*!< The opcode of the last other command not replied, with busy_status */
+static uint8_t busy_status = STATUS_SUCCESS;
 Cmd_Resp_t 	cmd_resp;
 Cmd_Req_t 	cmd_req;
 
 /**
- * @brief Confirm the CRC value of the command
- * 
- * @param p_cmd Command to confirm CRC value
- * @param cmd_len The length of the command to confirm the CRC value
- * @return true Confirmation is passed
- * @return false Confirmation is failed
+ * @brief Calculate the CRC value of the command directly over the header and the payload.
+ * The CRC peripheral takes the input by bytes, so the buffers need no alignment.
+ *
+ * @param p_header The header of the command
+ * @param header_len The length of the header
+ * @param p_payload The payload of the command, accumulated after the header
+ * @param payload_len The length of the payload
+ * @return uint16_t The CRC value of the command
+ */
+static uint16_t app_func_command_crc_calc(const uint8_t* p_header, uint8_t header_len, const uint8_t* p_payload, uint8_t payload_len) {
+	uint16_t cal_crc16 = (uint16_t)HAL_CRC_Calculate(&hcrc, (uint32_t*)p_header, header_len);
+	if ((payload_len > 0U) && (p_payload != NULL)) {
+		cal_crc16 = (uint16_t)HAL_CRC_Accumulate(&hcrc, (uint32_t*)p_payload, payload_len);
+	}
+	return cal_crc16;
+}
+
+/**
+ * @brief Check whether a complete command with a valid CRC value starts at the data, as a response command or as a request command.
+ * A response command covers the same bytes as a request command with the same payload length plus one,
+ * so both CRC values are calculated in one pass. The response command is checked first.
+ *
+ * @param p_cmd The data to check
+ * @param data_len The length of the data available
+ * @param p_is_resp Whether the command is a response command
+ * @return uint16_t The length of the command, 0 if no valid command starts at the data
  */
-static bool app_func_command_crc_confirm(const uint8_t* p_cmd, uint8_t cmd_len) {
-	bool result = false;
+static uint16_t app_func_command_frame_check(const uint8_t* p_cmd, uint16_t data_len, bool* p_is_resp) {
 	uint16_t cmd_crc16 = 0;
+	if (data_len < (LEN_REQ_HEADER + LEN_CRC)) {
+		return 0;
+	}
 
-	(void)memcpy((uint8_t*)crc_buffer, p_cmd, (uint32_t)cmd_len - LEN_CRC);
-	(void)memcpy((uint8_t*)&cmd_crc16, &p_cmd[cmd_len - LEN_CRC], LEN_CRC);
-    uint16_t cal_crc16 = (uint16_t)HAL_CRC_Calculate(&hcrc, crc_buffer, (uint32_t)cmd_len - LEN_CRC);
-    if (cmd_crc16 == cal_crc16) {
-    	result = true;
-    }
-    else {
-    	result = false;
-    }
-    return result;
+	uint16_t req_len = LEN_REQ_HEADER + (uint16_t)p_cmd[1];
+	uint16_t resp_len = LEN_RESP_HEADER + (uint16_t)p_cmd[1];
+	if (data_len < (req_len + LEN_CRC)) {
+		return 0;
+	}
+
+	uint16_t cal_crc16 = (uint16_t)HAL_CRC_Calculate(&hcrc, (uint32_t*)p_cmd, req_len);
+	(void)memcpy((uint8_t*)&cmd_crc16, &p_cmd[req_len], LEN_CRC);
+	bool req_passed = (cmd_crc16 == cal_crc16);
+
+	if (data_len >= (resp_len + LEN_CRC)) {
+		cal_crc16 = (uint16_t)HAL_CRC_Accumulate(&hcrc, (uint32_t*)&p_cmd[req_len], resp_len - req_len);
+		(void)memcpy((uint8_t*)&cmd_crc16, &p_cmd[resp_len], LEN_CRC);
+		if (cmd_crc16 == cal_crc16) {
+			*p_is_resp = true;
+			return resp_len + LEN_CRC;
+		}
+	}
+	if (req_passed) {
+		*p_is_resp = false;
+		return req_len + LEN_CRC;
+	}
+	return 0;
+}
+
+/**
+ * @brief Check whether a command may start at the data, before its CRC value is calculated.
+ * The opcode is in one of the command groups (DVT, BLE, IPG and SYS, each contiguous)
+ * and the payload length is not longer than the maximum.
+ *
+ * @param p_cmd The data to check, at least the command header
+ * @return true A command may start at the data
+ * @return false No command starts at the data
+ */
+static bool app_func_command_header_check(const uint8_t* p_cmd) {
+	uint8_t opcode = p_cmd[0];
+	bool opcode_known = ((opcode <= OP_DISABLE_VCHG_RAIL_SUPPLY) ||
+			((opcode >= OP_BLE_STAT_GET) && (opcode <= OP_BLE_ADV_MSD_UPDATE)) ||
+			((opcode >= OP_SHUTDOWN_SYSTEM) && (opcode <= OP_SEQ)) ||
+			((opcode >= OP_AUTH) && (opcode <= OP_SET_START_STATE)));
+	return (opcode_known && (p_cmd[1] <= LEN_REQ_PAYLOAD_MAX));
+}
+
+/**
+ * @brief Check whether the parser can resynchronize at the data, where a valid command starts
+ * or where the data may still be the start of a command not complete yet.
+ *
+ * @param p_cmd The data to check
+ * @param data_len The length of the data available
+ * @param p_partial Whether the command is not complete yet
+ * @return true A command starts at the data
+ * @return false No command starts at the data
+ */
+static bool app_func_command_resync_check(const uint8_t* p_cmd, uint16_t data_len, bool* p_partial) {
+	bool is_resp = false;
+	*p_partial = true;
+	if (data_len < LEN_REQ_HEADER) {
+		uint8_t header[LEN_REQ_HEADER] = {p_cmd[0], 0U};
+		return app_func_command_header_check(header);
+	}
+	if (app_func_command_header_check(p_cmd) == false) {
+		return false;
+	}
+	if (data_len < (LEN_RESP_HEADER + (uint16_t)p_cmd[1] + LEN_CRC)) {
+		return true;
+	}
+	*p_partial = false;
+	return (app_func_command_frame_check(p_cmd, data_len, &is_resp) > 0U);
+}
+
+/**
+ * @brief Write a response command with a status and no payload, after the sequence header if the request command was "SEQ"
+ *
+ * @param p_cmd_resp The response command to be replied
+ * @param opcode The opcode of the request command
+ * @param status The status of the response command
+ * @param p_seq_header The sequence number and the opcode carried, NULL if the request command was not "SEQ"
+ * @return uint8_t The length of the response command
+ */
+static uint8_t app_func_command_status_reply(uint8_t* p_cmd_resp, uint8_t opcode, uint8_t status, const uint8_t* p_seq_header) {
+	uint8_t resp_payload_len = (p_seq_header != NULL) ? LEN_SEQ_HEADER : 0U;
+	p_cmd_resp[0] = opcode;
+	p_cmd_resp[1] = resp_payload_len;
+	p_cmd_resp[2] = status;
+	if (p_seq_header != NULL) {
+		(void)memcpy(&p_cmd_resp[LEN_RESP_HEADER], p_seq_header, LEN_SEQ_HEADER);
+	}
+	uint16_t cal_crc16 = app_func_command_crc_calc(p_cmd_resp, LEN_RESP_HEADER, &p_cmd_resp[LEN_RESP_HEADER], resp_payload_len);
+	(void)memcpy(&p_cmd_resp[LEN_RESP_HEADER + resp_payload_len], (uint8_t*)&cal_crc16, LEN_CRC);
+	return LEN_RESP_HEADER + resp_payload_len + LEN_CRC;
+}
+
+/**
+ * @brief Keep a request command that is not run because its response cannot wait, it is replied busy later.
+ * A command "SEQ" is kept by its sequence number, which the remote end does not reuse while it is outstanding,
+ * so every one of them is replied. Only the last other command is kept, the remote end sends those one at a time.
+ *
+ * @param p_cmd_req The request command
+ * @param status The status of the reply
+ */
+static void app_func_command_busy_add(const uint8_t* p_cmd_req, uint8_t status) {
+	if ((p_cmd_req[0] == OP_SEQ) && (p_cmd_req[1] >= LEN_SEQ_HEADER) && (status == STATUS_BUSY)) {
+		uint8_t seq = p_cmd_req[LEN_REQ_HEADER];
+		busy_seq[seq / 8U] |= (uint8_t)(1U << (seq % 8U));
+		busy_seq_opcode[seq] = p_cmd_req[LEN_REQ_HEADER + 1U];
+	}
+	else {
+		busy_opcode = p_cmd_req[0];
+		busy_status = status;
+	}
+}
+
+/**
+ * @brief Write the reply of one request command kept by app_func_command_busy_add
+ *
+ * @param p_cmd_resp The response command to be replied
+ * @return uint8_t The length of the response command, 0 if no command is kept
+ */
+static uint8_t app_func_command_busy_reply(uint8_t* p_cmd_resp) {
+	if (busy_status != STATUS_SUCCESS) {
+		uint8_t status = busy_status;
+		busy_status = STATUS_SUCCESS;
+		return app_func_command_status_reply(p_cmd_resp, busy_opcode, status, NULL);
+	}
+	//The sequence numbers are replied in the order they are used, from the one after the last replied
+	for(uint16_t i=1;i<=256U;i++) {
+		uint8_t seq = (uint8_t)(busy_seq_last + i);
+		if ((busy_seq[seq / 8U] & (1U << (seq % 8U))) != 0U) {
+			busy_seq[seq / 8U] &= (uint8_t)~(1U << (seq % 8U));
+			busy_seq_last = seq;
+			uint8_t seq_header[LEN_SEQ_HEADER] = {seq, busy_seq_opcode[seq]};
+			return app_func_command_status_reply(p_cmd_resp, OP_SEQ, STATUS_BUSY, seq_header);
+		}
+	}
+	return 0U;
 }
 
 /**
@@ -52,13 +203,16 @@ static void app_func_command_resp_parser(uint8_t* p_cmd_resp, uint8_t cmd_resp_l
 		if (cmd_resp.PayloadLen > 0) {
 			cmd_resp.Payload = &p_cmd_resp[LEN_RESP_HEADER];
 		}
-		curr_cmd_resp_parser(cmd_resp);
+		curr_cmd_resp_parser(&cmd_resp);
 	}
 }
 
 /**
- * @brief Parser for request commands, used to communicate with the remote end
- * 
+ * @brief Parser for request commands, used to communicate with the remote end.
+ * The response payload is written by the parser straight into the response command, unless it points the payload elsewhere.
+ * The command "SEQ" carries the sequence number and another command, which is parsed as usual and replied
+ * with the same sequence number and opcode ahead of its payload, so the remote end can match the responses of several outstanding commands.
+ *
  * @param p_cmd_req Request command to be parsed
  * @param cmd_req_len The length of the request command to be parsed
  * @param p_cmd_resp The response command to be replied after parsing the request command
@@ -66,31 +220,52 @@ static void app_func_command_resp_parser(uint8_t* p_cmd_resp, uint8_t cmd_resp_l
  */
 static uint8_t app_func_command_req_parser(uint8_t* p_cmd_req, uint8_t cmd_req_len, uint8_t* p_cmd_resp) {
 	UNUSED(cmd_req_len);
+	uint8_t seq_len = 0U;
 	cmd_resp.Opcode = p_cmd_req[0];
 	cmd_resp.Status = STATUS_OPCODE_ERR;
 	cmd_resp.Payload = NULL;
 	cmd_resp.PayloadLen = 0;
 
-	if (curr_cmd_req_parser != NULL) {
+	if ((p_cmd_req[0] == OP_SEQ) && (p_cmd_req[1] < LEN_SEQ_HEADER)) {
+		cmd_resp.Status = STATUS_PAYLOAD_LEN_ERR;
+	}
+	else if (curr_cmd_req_parser != NULL) {
+		uint8_t req_payload_head = LEN_REQ_HEADER;
 		cmd_req.Opcode = p_cmd_req[0];
 		cmd_req.Payload = NULL;
 		cmd_req.PayloadLen = p_cmd_req[1];
+		if (cmd_req.Opcode == OP_SEQ) {
+			seq_len = LEN_SEQ_HEADER;
+			p_cmd_resp[LEN_RESP_HEADER] = p_cmd_req[LEN_REQ_HEADER];
+			p_cmd_resp[LEN_RESP_HEADER + 1U] = p_cmd_req[LEN_REQ_HEADER + 1U];
+			cmd_req.Opcode = p_cmd_req[LEN_REQ_HEADER + 1U];
+			cmd_req.PayloadLen -= LEN_SEQ_HEADER;
+			req_payload_head += LEN_SEQ_HEADER;
+		}
 		if (cmd_req.PayloadLen > 0) {
-			cmd_req.Payload = &p_cmd_req[LEN_REQ_HEADER];
+			cmd_req.Payload = &p_cmd_req[req_payload_head];
+		}
+		cmd_resp.Status = STATUS_SUCCESS;
+		cmd_resp.Payload = &p_cmd_resp[LEN_RESP_HEADER + seq_len];
+		curr_cmd_req_parser(&cmd_req, &cmd_resp);
+
+		//The sequence header takes room from the response payload, a longer response is refused rather than cut
+		if ((seq_len > 0U) && (cmd_resp.PayloadLen > (LEN_RESP_PAYLOAD_MAX - LEN_SEQ_HEADER))) {
+			cmd_resp.Status = STATUS_PAYLOAD_LEN_ERR;
+			cmd_resp.PayloadLen = 0;
 		}
-		cmd_resp = curr_cmd_req_parser(cmd_req);
 	}
 
-    uint8_t cmd_resp_len = LEN_RESP_HEADER + cmd_resp.PayloadLen + LEN_CRC;
+    uint8_t resp_payload_len = seq_len + cmd_resp.PayloadLen;
+    uint8_t cmd_resp_len = LEN_RESP_HEADER + resp_payload_len + LEN_CRC;
     p_cmd_resp[0] = cmd_resp.Opcode;
-    p_cmd_resp[1] = cmd_resp.PayloadLen;
+    p_cmd_resp[1] = resp_payload_len;
     p_cmd_resp[2] = cmd_resp.Status;
-    if ((cmd_resp.PayloadLen > 0U) && (cmd_resp.Payload != NULL)) {
-        (void)memcpy(&p_cmd_resp[LEN_RESP_HEADER], cmd_resp.Payload, cmd_resp.PayloadLen);
+    if ((cmd_resp.PayloadLen > 0U) && (cmd_resp.Payload != NULL) && (cmd_resp.Payload != &p_cmd_resp[LEN_RESP_HEADER + seq_len])) {
+        (void)memcpy(&p_cmd_resp[LEN_RESP_HEADER + seq_len], cmd_resp.Payload, cmd_resp.PayloadLen);
     }
 
-	(void)memcpy((uint8_t*)crc_buffer, p_cmd_resp, (uint32_t)cmd_resp_len - LEN_CRC);
-    uint16_t cal_crc16 = (uint16_t)HAL_CRC_Calculate(&hcrc, crc_buffer, (uint32_t)cmd_resp_len - LEN_CRC);
+    uint16_t cal_crc16 = app_func_command_crc_calc(p_cmd_resp, LEN_RESP_HEADER, &p_cmd_resp[LEN_RESP_HEADER], resp_payload_len);
     (void)memcpy(&p_cmd_resp[cmd_resp_len - LEN_CRC], (uint8_t*)&cal_crc16, LEN_CRC);
     return cmd_resp_len;
 }
@@ -114,82 +289,145 @@ void app_func_command_resp_parser_set(Cmd_Resp_Parser new_cmd_resp_parser) {
 }
 
 /**
- * @brief Parser for all commands, used to confirm whether the command is a request command or a response command
- * 
+ * @brief Parser for all commands, used to confirm whether the command is a request command or a response command.
+ * One command is parsed in place each call and the received data is never moved, only the head index advances.
+ * A command not complete yet is left in place and nothing is parsed, so the rest of it can be received after it.
+ * Without room for the response, the data to be transferred is NULL: a request command is not run and is replied
+ * busy by a later call with no data received, which writes the reply of one such command.
+ *
  * @param p_data_rx The data received
- * @param p_data_rx_len The length of data received
- * @param p_data_tx The data to be transferred
+ * @param p_data_rx_head The index of the first data not parsed yet, reset to 0 when all data is parsed
+ * @param p_data_rx_len The length of data received and not parsed yet
+ * @param p_data_tx The data to be transferred, NULL if a response cannot be transferred
  * @return uint8_t The length of data to be transferred
  */
-uint8_t app_func_command_parser(uint8_t* p_data_rx, uint8_t* p_data_rx_len, uint8_t* p_data_tx) {
+uint8_t app_func_command_parser(uint8_t* p_data_rx, uint8_t* p_data_rx_head, uint8_t* p_data_rx_len, uint8_t* p_data_tx) {
 	uint8_t data_tx_len = 0;
-	uint8_t cmd_len = 0;
-	uint8_t payload_length = p_data_rx[1];
+	uint16_t cmd_len = 0;
+	bool is_resp = false;
+	uint8_t* p_cmd = &p_data_rx[*p_data_rx_head];
 
-	if (app_func_command_crc_confirm(p_data_rx, LEN_RESP_HEADER + payload_length + LEN_CRC)) {
-		cmd_len = (LEN_RESP_HEADER + payload_length + LEN_CRC);
-		app_func_command_resp_parser(p_data_rx, cmd_len);
-		(void)memmove(p_data_rx, &p_data_rx[cmd_len], (size_t)SP_BUF_SIZE - cmd_len);
-		*p_data_rx_len -= cmd_len;
+	if (*p_data_rx_len == 0U) {
+		return (p_data_tx != NULL) ? app_func_command_busy_reply(p_data_tx) : 0U;
 	}
-	else if (app_func_command_crc_confirm(p_data_rx, LEN_REQ_HEADER + payload_length + LEN_CRC)) {
-		cmd_len = (LEN_REQ_HEADER + payload_length + LEN_CRC);
-		data_tx_len = app_func_command_req_parser(p_data_rx, cmd_len, p_data_tx);
-		(void)memmove(p_data_rx, &p_data_rx[cmd_len], (size_t)SP_BUF_SIZE - cmd_len);
-		*p_data_rx_len -= cmd_len;
+
+	cmd_len = app_func_command_frame_check(p_cmd, *p_data_rx_len, &is_resp);
+	if ((cmd_len > 0U) && is_resp) {
+		app_func_command_resp_parser(p_cmd, (uint8_t)cmd_len);
+	}
+	else if ((cmd_len > 0U) && (p_data_tx == NULL)) {
+		app_func_command_busy_add(p_cmd, STATUS_BUSY);
+	}
+	else if (cmd_len > 0U) {
+		data_tx_len = app_func_command_req_parser(p_cmd, (uint8_t)cmd_len, p_data_tx);
+	}
+	else if ((*p_data_rx_len < LEN_REQ_HEADER) || ((p_cmd[1] <= LEN_REQ_PAYLOAD_MAX) && (*p_data_rx_len < (LEN_RESP_HEADER + (uint16_t)p_cmd[1] + LEN_CRC)))) {
+		//The data may still be the start of a command, as long as a response command, so it waits for the rest of it.
+		//The length of a command longer than the maximum is not trusted, that data is resynchronized below.
+		return 0U;
 	}
 	else {
-		p_data_tx[0] = p_data_rx[0];
-		p_data_tx[1] = 0;
-		p_data_tx[2] = STATUS_CRC_ERR;
+		if (p_data_tx != NULL) {
+			data_tx_len = app_func_command_status_reply(p_data_tx, p_cmd[0], STATUS_CRC_ERR, NULL);
+		}
+		else {
+			app_func_command_busy_add(p_cmd, STATUS_CRC_ERR);
+		}
 
-		(void)memcpy((uint8_t*)crc_buffer, p_data_tx, (uint32_t)LEN_RESP_HEADER);
-	    uint16_t cal_crc16 = (uint16_t)HAL_CRC_Calculate(&hcrc, crc_buffer, LEN_RESP_HEADER);
-	    (void)memcpy(&p_data_tx[LEN_RESP_HEADER], (uint8_t*)&cal_crc16, LEN_CRC);
-	    data_tx_len = LEN_RESP_HEADER + LEN_CRC;
-	    *p_data_rx_len = 0;
+	    //Resynchronize at the next byte where a valid command starts, the data before it is discarded.
+	    //Without one, the data from the first command not complete yet is kept, it may be the start of a command split over two transfers,
+	    //and it is resynchronized again once the rest of the data is received.
+	    //The CRC value is only calculated where the header is plausible.
+	    uint16_t partial_len = 0;
+	    bool partial = false;
+	    bool found = false;
+	    cmd_len = 1;
+	    while ((cmd_len < *p_data_rx_len) && (found == false)) {
+	    	if (app_func_command_resync_check(&p_cmd[cmd_len], *p_data_rx_len - cmd_len, &partial)) {
+	    		found = (partial == false);
+	    		partial_len = ((partial_len == 0U) && partial) ? cmd_len : partial_len;
+	    	}
+	    	cmd_len = found ? cmd_len : (cmd_len + 1U);
+	    }
+	    if ((found == false) && (partial_len > 0U)) {
+	    	cmd_len = partial_len;
+	    }
 	}
+
+	*p_data_rx_len -= (uint8_t)cmd_len;
+	*p_data_rx_head = (*p_data_rx_len > 0U) ? (*p_data_rx_head + (uint8_t)cmd_len) : 0U;
 	return data_tx_len;
 }
 
+/**
+ * @brief Dispatch the request command to its handler in the command tables.
+ * The payload length and the user class are checked against the entry before the handler runs.
+ *
+ * @param p_tables The command tables, each covering a contiguous range of opcodes
+ * @param table_num The number of command tables
+ * @param user_class The user class of the remote end
+ * @param p_req Request command to be dispatched
+ * @param p_resp The response command to be replied
+ */
+void app_func_command_dispatch(const Cmd_Table_t* p_tables, uint8_t table_num, uint8_t user_class, const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	const Cmd_Entry_t* p_entry = NULL;
+	for(uint8_t i=0;(i<table_num) && (p_entry == NULL);i++) {
+		uint8_t index = p_req->Opcode - p_tables[i].OpcodeFirst;
+		if ((p_req->Opcode >= p_tables[i].OpcodeFirst) && (index < p_tables[i].Num)) {
+			p_entry = &p_tables[i].Entries[index];
+		}
+	}
+
+	if ((p_entry == NULL) || (p_entry->Handler == NULL)) {
+		p_resp->Status = STATUS_OPCODE_ERR;
+	}
+	else if ((p_req->PayloadLen < p_entry->LenMin) || (p_req->PayloadLen > p_entry->LenMax)) {
+		p_resp->Status = STATUS_PAYLOAD_LEN_ERR;
+	}
+	else if (user_class < p_entry->UserClass) {
+		p_resp->Status = STATUS_USER_CLASS_ERR;
+	}
+	else {
+		p_entry->Handler(p_req, p_resp);
+	}
+}
+
 /**
  * @brief Generate and send a request command
  * 
- * @param cmd The definition of the request command to be generated
+ * @param p_cmd The definition of the request command to be generated
  */
-void app_func_command_req_send(Cmd_Req_t cmd) {
+void app_func_command_req_send(const Cmd_Req_t* p_cmd) {
 	uint8_t req_cmd[LEN_CMD_MAX];
-	req_cmd[0] = cmd.Opcode;
-	req_cmd[1] = cmd.PayloadLen;
+	req_cmd[0] = p_cmd->Opcode;
+	req_cmd[1] = p_cmd->PayloadLen;
 
-    if ((cmd.PayloadLen > 0U) && (cmd.Payload != NULL)) {
-        (void)memcpy(&req_cmd[LEN_REQ_HEADER], cmd.Payload, cmd.PayloadLen);
+    if ((p_cmd->PayloadLen > 0U) && (p_cmd->Payload != NULL)) {
+        (void)memcpy(&req_cmd[LEN_REQ_HEADER], p_cmd->Payload, p_cmd->PayloadLen);
     }
 
-	(void)memcpy((uint8_t*)crc_buffer, req_cmd, (uint32_t)LEN_REQ_HEADER + cmd.PayloadLen);
-    uint16_t cal_crc16 = (uint16_t)HAL_CRC_Calculate(&hcrc, crc_buffer, (uint32_t)LEN_REQ_HEADER + cmd.PayloadLen);
-    (void)memcpy(&req_cmd[LEN_REQ_HEADER + cmd.PayloadLen], (uint8_t*)&cal_crc16, LEN_CRC);
-    bsp_sp_cmd_send(req_cmd, LEN_REQ_HEADER + cmd.PayloadLen + LEN_CRC);
+    uint16_t cal_crc16 = app_func_command_crc_calc(req_cmd, LEN_REQ_HEADER, &req_cmd[LEN_REQ_HEADER], p_cmd->PayloadLen);
+    (void)memcpy(&req_cmd[LEN_REQ_HEADER + p_cmd->PayloadLen], (uint8_t*)&cal_crc16, LEN_CRC);
+    bsp_sp_cmd_send(req_cmd, LEN_REQ_HEADER + p_cmd->PayloadLen + LEN_CRC);
 }
 
 /**
  * @brief Generate and send a response command
  *
- * @param cmd The definition of the response command to be generated
+ * @param p_cmd The definition of the response command to be generated
  */
-void app_func_command_resp_send(Cmd_Resp_t cmd) {
+void app_func_command_resp_send(const Cmd_Resp_t* p_cmd) {
 	uint8_t resp_cmd[LEN_CMD_MAX];
-	resp_cmd[0] = cmd.Opcode;
-	resp_cmd[1] = cmd.PayloadLen;
-	resp_cmd[2] = cmd.Status;
+	resp_cmd[0] = p_cmd->Opcode;
+	resp_cmd[1] = p_cmd->PayloadLen;
+	resp_cmd[2] = p_cmd->Status;
 
-    if ((cmd.PayloadLen > 0U) && (cmd.Payload != NULL)) {
-        (void)memcpy(&resp_cmd[LEN_RESP_HEADER], cmd.Payload, cmd.PayloadLen);
+    if ((p_cmd->PayloadLen > 0U) && (p_cmd->Payload != NULL)) {
+        (void)memcpy(&resp_cmd[LEN_RESP_HEADER], p_cmd->Payload, p_cmd->PayloadLen);
     }
 
-	(void)memcpy((uint8_t*)crc_buffer, resp_cmd, (uint32_t)LEN_RESP_HEADER + cmd.PayloadLen);
-    uint16_t cal_crc16 = (uint16_t)HAL_CRC_Calculate(&hcrc, crc_buffer, (uint32_t)LEN_RESP_HEADER + cmd.PayloadLen);
-    (void)memcpy(&resp_cmd[LEN_RESP_HEADER + cmd.PayloadLen], (uint8_t*)&cal_crc16, LEN_CRC);
-    bsp_sp_cmd_send(resp_cmd, LEN_RESP_HEADER + cmd.PayloadLen + LEN_CRC);
+    uint16_t cal_crc16 = app_func_command_crc_calc(resp_cmd, LEN_RESP_HEADER, &resp_cmd[LEN_RESP_HEADER], p_cmd->PayloadLen);
+    (void)memcpy(&resp_cmd[LEN_RESP_HEADER + p_cmd->PayloadLen], (uint8_t*)&cal_crc16, LEN_CRC);
+    bsp_sp_cmd_send(resp_cmd, LEN_RESP_HEADER + p_cmd->PayloadLen + LEN_CRC);
 }
 
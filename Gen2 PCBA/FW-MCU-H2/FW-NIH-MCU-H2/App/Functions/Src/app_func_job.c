@@ -0,0 +1,206 @@
+/**
+ * @file app_func_job.c
+ * @brief This file provides management of the long-running commands, run as jobs from the main loop
+ * @copyright Copyright (c) 2024
+ */
+#include "app_func_job.h"
+#include "app_config.h"
+
+typedef struct {
+	Job_Step	Step;			/*!< The step of the job */
+	Job_Abort	Abort;			/*!< The abort of the job */
+	Cmd_Resp_t	Result;			/*!< The result of the job, the payload follows the job information */
+	bool		Notify;			/*!< The notification "JOB_NOTIFY" is not sent yet */
+	uint8_t		UserClass;		/*!< The user class of the remote end that started the job */
+} Job_t;
+
+static uint8_t job_payload[LEN_RESP_PAYLOAD_MAX];		/*!< The job information followed by the job result */
+static Job_t job;
+
+/**
+ * @brief Put the job information and the job result into the response payload, the status is the result status when the job is finished
+ *
+ * @param p_resp The response command to be replied
+ */
+static void app_func_job_info_get(Cmd_Resp_t* p_resp) {
+	uint8_t len = LEN_JOB_INFO;
+	if (job_payload[2] == JOB_STATE_DONE) {
+		len += job.Result.PayloadLen;
+		p_resp->Status = job.Result.Status;
+	}
+	if (p_resp->Payload != job_payload) {
+		(void)memcpy(p_resp->Payload, job_payload, len);
+	}
+	p_resp->PayloadLen = len;
+}
+
+/**
+ * @brief Check whether the job ID in the request command is the current job, and the remote end may access it
+ *
+ * @param user_class The user class of the remote end
+ * @param p_req Request command with the job ID as payload
+ * @return true The job ID is the current job, started by a user class not above the remote end
+ * @return false There is no such job for the remote end
+ */
+static bool app_func_job_id_check(uint8_t user_class, const Cmd_Req_t* p_req) {
+	return ((job_payload[2] != JOB_STATE_IDLE) && (p_req->Payload[0] == job_payload[0]) && (user_class >= job.UserClass));
+}
+
+/**
+ * @brief Start a job for the long-running command, the response command is replied with the job information at once
+ *
+ * @param opcode The opcode of the long-running command
+ * @param step The step of the job
+ * @param abort The abort of the job, NULL if nothing needs to be undone
+ * @param user_class The user class of the remote end, only the same or a higher user class can access the job
+ * @param p_resp The response command to be replied
+ */
+void app_func_job_start(uint8_t opcode, Job_Step step, Job_Abort abort, uint8_t user_class, Cmd_Resp_t* p_resp) {
+	if (app_func_job_is_running()) {
+		p_resp->Status = STATUS_INVALID;
+	}
+	else {
+		//The job ID 0 is never used, so the remote end can tell a job from no job
+		job_payload[0] = (job_payload[0] == UINT8_MAX) ? 1U : (job_payload[0] + 1U);
+		job_payload[1] = opcode;
+		job_payload[2] = JOB_STATE_RUNNING;
+		job_payload[3] = 0U;
+
+		job.Step = step;
+		job.Abort = abort;
+		job.Result.Status = STATUS_SUCCESS;
+		job.Result.Payload = &job_payload[LEN_JOB_INFO];
+		job.Result.PayloadLen = 0;
+		job.Notify = false;
+		job.UserClass = user_class;
+
+		app_func_job_info_get(p_resp);
+	}
+}
+
+/**
+ * @brief Check whether a job is running
+ *
+ * @return true A job is running
+ * @return false No job is running
+ */
+bool app_func_job_is_running(void) {
+	return (job_payload[2] == JOB_STATE_RUNNING);
+}
+
+/**
+ * @brief Abort the running job and forget the result of the last job, used when the remote end that started it is gone
+ *
+ */
+void app_func_job_clear(void) {
+	app_func_job_abort();
+	job_payload[2] = JOB_STATE_IDLE;
+	job.Notify = false;
+}
+
+/**
+ * @brief Abort the running job, nothing happens if no job is running
+ *
+ */
+void app_func_job_abort(void) {
+	if (app_func_job_is_running()) {
+		if (job.Abort != NULL) {
+			job.Abort();
+		}
+		job_payload[2] = JOB_STATE_ABORTED;
+		job.Notify = false;
+	}
+}
+
+/**
+ * @brief Handler for jobs, runs one step of the running job and sends the notification "JOB_NOTIFY" on progress or completion
+ *
+ * @return true A job is running or its notification is not sent yet, call again from the main loop
+ * @return false Nothing to do
+ */
+bool app_func_job_handler(void) {
+	if (app_func_job_is_running()) {
+		uint8_t progress = job_payload[3];
+		if (job.Step(&job.Result, &progress)) {
+			job_payload[2] = JOB_STATE_DONE;
+			job_payload[3] = 100U;
+			job.Notify = true;
+		}
+		else {
+			if ((progress / JOB_NOTIFY_PROGRESS_STEP) != (job_payload[3] / JOB_NOTIFY_PROGRESS_STEP)) {
+				job.Notify = true;
+			}
+			job_payload[3] = progress;
+		}
+	}
+
+	//Only the latest notification is sent, so the notifications never overwrite a response command not taken yet
+	if (job.Notify && (bsp_sp_cmd_is_pending() == false)) {
+		Cmd_Resp_t notify = {
+				.Opcode = OP_JOB_NOTIFY,
+				.Status = STATUS_SUCCESS,
+				.Payload = job_payload,
+				.PayloadLen = 0,
+		};
+		app_func_job_info_get(&notify);
+		app_func_command_resp_send(&notify);
+		job.Notify = false;
+	}
+	return (app_func_job_is_running() || job.Notify);
+}
+
+/**
+ * @brief Handler for the command "JOB_START", the payload is the opcode and the payload of the long-running command
+ *
+ * @param p_tables The command tables of the long-running commands
+ * @param table_num The number of command tables
+ * @param user_class The user class of the remote end
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+void app_func_job_cmd_start(const Cmd_Table_t* p_tables, uint8_t table_num, uint8_t user_class, const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	if (app_func_job_is_running()) {
+		p_resp->Status = STATUS_INVALID;
+	}
+	else {
+		Cmd_Req_t job_req = {
+				.Opcode = p_req->Payload[0],
+				.Payload = &p_req->Payload[1],
+				.PayloadLen = p_req->PayloadLen - 1U,
+		};
+		app_func_command_dispatch(p_tables, table_num, user_class, &job_req, p_resp);
+	}
+}
+
+/**
+ * @brief Handler for the command "JOB_STATUS", the payload is the job ID
+ *
+ * @param user_class The user class of the remote end
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+void app_func_job_cmd_status(uint8_t user_class, const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	if (app_func_job_id_check(user_class, p_req) == false) {
+		p_resp->Status = STATUS_INVALID;
+	}
+	else {
+		app_func_job_info_get(p_resp);
+	}
+}
+
+/**
+ * @brief Handler for the command "JOB_ABORT", the payload is the job ID
+ *
+ * @param user_class The user class of the remote end
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+void app_func_job_cmd_abort(uint8_t user_class, const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	if (app_func_job_id_check(user_class, p_req) == false) {
+		p_resp->Status = STATUS_INVALID;
+	}
+	else {
+		app_func_job_abort();
+		app_func_job_info_get(p_resp);
+	}
+}
@@ -10,21 +10,37 @@
 #define DATA_TYPE_BATT_VOLT				"<BA>"		/*!< Label message for data type "BATT_VOLT" */
 #define DATA_TYPE_PARAMETER				"<PA>"		/*!< Label message for data type "PARAMETER" */
 #define DATA_TYPE_IMPEDANCE				"<IM>"		/*!< Label message for data type "IMPEDANCE" */
+#define DATA_TYPE_IMPED_SURVEY			"<IS>"		/*!< Label message for data type "IMPED_SURVEY" */
 
 #define PATTERN_TIMESTAMP				"[20YY-MM-DDThh:mm:ssZ(uuu)]"	//UTC format (www.utctime.net)
 
+#define LEN_LOG_SCAN_CHUNK				32U			/*!< The number of bytes read from FRAM at a time when looking for the start of a log */
+#define LOG_WRITE_BUFF_NUM				4U			/*!< The number of log buffers that can be waiting to be written to FRAM */
+#define LEN_LOG_WRITE_BUFF				256U		/*!< The length of each log buffer */
+#define LEN_LOG_TIMESTAMP				(sizeof(PATTERN_TIMESTAMP) - 1U)	/*!< The length of the timestamp string at the start of each log */
+#define LOG_INFO_SAVE_INTERVAL			16U			/*!< The number of logs written to FRAM between saves of the log pointer */
+
 Log_Info_t logInfo = {
 		.LogPointer = ADDR_LOG_BASE,
 };
 
-char log_buff_write[512];
+static Log_Info_t logInfoWritten = {
+		.LogPointer = ADDR_LOG_BASE,
+};
+
+static volatile uint8_t log_info_unsaved = 0;
+static uint32_t log_write_end = ADDR_LOG_BASE;
+
+static char log_buff_write_pool[LOG_WRITE_BUFF_NUM][LEN_LOG_WRITE_BUFF];
+static uint8_t log_buff_write_index = 0;
+static volatile uint8_t log_write_pending = 0;
+static volatile bool log_wrap_pending = false;
+static char* log_buff_write = log_buff_write_pool[0];
+static const uint8_t log_erase_data[LEN_LOG_WRITE_BUFF] = {0};
 char log_buff_read[512];
 
 const char log_end[] = "\r\n";
 
-static uint32_t lastReadAddress = ADDR_LOG_BASE;
-static char lastReadTimeStamp[] = PATTERN_TIMESTAMP;
-
 /**
  * @brief Generate timestamp string
  *
@@ -51,7 +67,16 @@ static uint16_t app_func_logs_timestamp_gen(const uint8_t* p_timestamp) {
 		p_log_buff = log_buff_read;
 	}
 	else {
-		(void)memset(log_buff_write, 0, sizeof(log_buff_write));
+		//Each log is written from its own buffer, so a buffer is only reused after its log has been written to FRAM
+		while((log_write_pending >= LOG_WRITE_BUFF_NUM) && bsp_fram_is_busy()) {
+			__NOP();
+		};
+		if (!bsp_fram_is_busy()) {
+			log_write_pending = 0;
+		}
+		log_buff_write_index = (log_buff_write_index + 1U) % LOG_WRITE_BUFF_NUM;
+		log_buff_write = log_buff_write_pool[log_buff_write_index];
+		(void)memset(log_buff_write, 0, LEN_LOG_WRITE_BUFF);
 		p_log_buff = log_buff_write;
 	}
 
@@ -81,10 +106,143 @@ static void app_func_logs_write(char* str, uint16_t len_str) {
 	uint8_t* p_log = (uint8_t*)str;
 
 	if ((logInfo.LogPointer + len_str) >= (ADDR_LOG_BASE + SIZE_LOG)) {
+		//Clear the unused tail so that older logs left there do not break the time order of the ring.
+		//The tail is shorter than this log, so it is queued as one write of zeros ahead of the log instead of erased while the queue drains.
+		bsp_fram_write(logInfo.LogPointer, log_erase_data, (uint16_t)((ADDR_LOG_BASE + SIZE_LOG) - logInfo.LogPointer), false);
+		//The '[' left at the base by the oldest log must not make the first log look complete
+		log_wrap_pending = true;
+		bsp_fram_write(ADDR_LOG_BASE, log_erase_data, 1U, false);
 		logInfo.LogPointer = ADDR_LOG_BASE;
 	}
 
-	bsp_fram_write(logInfo.LogPointer, p_log, len_str, false);
+	log_write_pending++;
+	//The first byte overwrites the terminating null character of the previous log, so it is written after the rest of the log.
+	//A log only starts with '[' in FRAM once it is complete, and the previous log stays terminated until then.
+	bsp_fram_write(logInfo.LogPointer + 1U, &p_log[1], len_str - 1U, false);
+	bsp_fram_write(logInfo.LogPointer, p_log, 1U, false);
+	logInfo.LogPointer += ((uint32_t)len_str - 1U);
+}
+
+/**
+ * @brief Check whether a complete log starts at this address
+ *
+ * @param addr The FRAM address to check
+ * @param p_timestamp_prev The timestamp string of the previous log. If null, the time order is not checked
+ * @param newer_only If true, a log with the same timestamp as the previous log is not accepted
+ * @param p_addr_end The address where the next log starts, at the terminating null character of the log found
+ * @return true A complete log starts at this address, and its timestamp string is left at the start of log_buff_read
+ * @return false No complete log starts at this address
+ */
+static bool app_func_logs_record_check(uint32_t addr, const char* p_timestamp_prev, bool newer_only, uint32_t* p_addr_end) {
+	uint16_t len_read = LEN_LOG_WRITE_BUFF;
+	if (len_read > ((ADDR_LOG_BASE + SIZE_LOG) - addr)) {
+		len_read = (uint16_t)((ADDR_LOG_BASE + SIZE_LOG) - addr);
+	}
+	if (len_read <= LEN_LOG_TIMESTAMP) {
+		return false;
+	}
+
+	bsp_fram_read(addr, (uint8_t*)log_buff_read, len_read);
+	if ((log_buff_read[0] != '[') || (log_buff_read[LEN_LOG_TIMESTAMP - 1U] != ']')) {
+		return false;
+	}
+	if (p_timestamp_prev != NULL) {
+		int32_t cmp = memcmp(log_buff_read, p_timestamp_prev, LEN_LOG_TIMESTAMP);
+		if ((cmp < 0) || (newer_only && (cmp == 0))) {
+			return false;
+		}
+	}
+	//The first byte of a log is written last, so a log starting with '[' is complete and ends at its first "\r\n".
+	//Only the last log still ends with "\r\n\0", the null character of the others is overwritten by the '[' of the next log.
+	for(uint16_t i=LEN_LOG_TIMESTAMP + 2U;i<len_read;i++) {
+		if (((log_buff_read[i] == '\0') || (log_buff_read[i] == '[')) && (log_buff_read[i - 1U] == '\n') && (log_buff_read[i - 2U] == '\r')) {
+			*p_addr_end = addr + i;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Get the timestamp string of the log that ends at this address
+ *
+ * @param addr_end The address of the terminating null character of the log
+ * @param p_timestamp The timestamp string of the log
+ * @return true The log is found
+ * @return false There is no log before this address
+ */
+static bool app_func_logs_last_timestamp_get(uint32_t addr_end, char* p_timestamp) {
+	uint32_t addr = ADDR_LOG_BASE;
+	if ((addr_end - ADDR_LOG_BASE) > LEN_LOG_WRITE_BUFF) {
+		addr = addr_end - LEN_LOG_WRITE_BUFF;
+	}
+	uint16_t len_read = (uint16_t)(addr_end - addr);
+	if (len_read < LEN_LOG_TIMESTAMP) {
+		return false;
+	}
+
+	bsp_fram_read(addr, (uint8_t*)log_buff_read, len_read);
+	for(uint16_t i=len_read - (uint16_t)LEN_LOG_TIMESTAMP + 1U;i>0U;i--) {
+		if ((log_buff_read[i - 1U] == '[') && (log_buff_read[i - 1U + LEN_LOG_TIMESTAMP - 1U] == ']')) {
+			(void)memcpy(p_timestamp, &log_buff_read[i - 1U], LEN_LOG_TIMESTAMP);
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Check whether a log ends at this address
+ *
+ * @param addr_end The address to check, the log pointer
+ * @return true No log is written yet or a log ends at this address
+ * @return false No log ends at this address
+ */
+static bool app_func_logs_end_check(uint32_t addr_end) {
+	if (addr_end == ADDR_LOG_BASE) {
+		return true;
+	}
+	if ((addr_end - ADDR_LOG_BASE) < 2U) {
+		return false;
+	}
+	char end[3];
+	bsp_fram_read(addr_end - 2U, (uint8_t*)end, (uint16_t)sizeof(end));
+	return ((end[0] == '\r') && (end[1] == '\n') && ((end[2] == '\0') || (end[2] == '[')));
+}
+
+/**
+ * @brief Find the end of the logs written after the log pointer was last saved
+ *
+ * @param addr_saved The saved log pointer
+ * @return uint32_t The log pointer after the last complete log
+ */
+static uint32_t app_func_logs_recover(uint32_t addr_saved) {
+	char timestamp_prev[LEN_LOG_TIMESTAMP];
+	bool timestamp_valid = app_func_logs_last_timestamp_get(addr_saved, timestamp_prev);
+	uint32_t addr = addr_saved;
+	uint32_t addr_end = addr_saved;
+	bool wrapped = false;
+
+	//Each log overwrites the terminating null character of the previous one, so the logs written after the save follow it back to back
+	//and are walked one by one, however many were written.
+	//When the ring wraps, the next log starts at the base and is newer than the last log before the wrap.
+	while (true) {
+		bsp_wdg_refresh();
+		if (app_func_logs_record_check(addr, timestamp_valid ? timestamp_prev : NULL, false, &addr_end)) {
+			//continue after this log
+		}
+		else if (!wrapped && timestamp_valid && (addr != ADDR_LOG_BASE) &&
+				app_func_logs_record_check(ADDR_LOG_BASE, timestamp_prev, true, &addr_end)) {
+			wrapped = true;
+		}
+		else {
+			break;
+		}
+		(void)memcpy(timestamp_prev, log_buff_read, LEN_LOG_TIMESTAMP);
+		timestamp_valid = true;
+		addr = addr_end;
+	}
+	return addr;
 }
 
 /**
@@ -97,6 +255,33 @@ void app_func_logs_init(void) {
 		logInfo.LogPointer = ADDR_LOG_BASE;
 		bsp_fram_write(ADDR_LOG_INFO, (uint8_t*)&logInfo, sizeof(logInfo), false);
 	}
+	else {
+		//The log pointer is only saved every few logs, so the logs written after it are found from their own content.
+		//A log pointer cut by a power loss while it was saved does not end a log, then the logs are walked from the base.
+		uint32_t addr_saved = app_func_logs_end_check(logInfo.LogPointer) ? logInfo.LogPointer : ADDR_LOG_BASE;
+		uint32_t addr_recovered = app_func_logs_recover(addr_saved);
+		if (addr_recovered != logInfo.LogPointer) {
+			logInfo.LogPointer = addr_recovered;
+			bsp_fram_write(ADDR_LOG_INFO, (uint8_t*)&logInfo, sizeof(logInfo), true);
+		}
+	}
+	logInfoWritten = logInfo;
+	log_info_unsaved = 0;
+}
+
+/**
+ * @brief Save the log pointer of all logs written to FRAM
+ *
+ */
+void app_func_logs_flush(void) {
+	while(bsp_fram_is_busy()) {
+		__NOP();
+	}
+	if (log_info_unsaved > 0U) {
+		log_info_unsaved = 0;
+		logInfoWritten = logInfo;
+		bsp_fram_write(ADDR_LOG_INFO, (uint8_t*)&logInfoWritten, sizeof(logInfoWritten), true);
+	}
 }
 
 /**
@@ -191,6 +376,48 @@ void app_func_logs_imped_write(uint32_t imp) {
 	app_func_logs_write(log_buff_write, offset);
 }
 
+/**
+ * @brief Write the impedance survey of all electrode pairs to log as a single record
+ *
+ * @param p_imp The impedance of each electrode pair, unit: ohm
+ * @param num The number of electrode pairs
+ */
+void app_func_logs_imped_survey_write(const uint16_t* p_imp, uint8_t num) {
+	uint16_t offset = app_func_logs_timestamp_gen(NULL);
+
+	(void)memcpy(&log_buff_write[offset], DATA_TYPE_IMPED_SURVEY, LEN_DATA_TYPE_STR);
+	offset += LEN_DATA_TYPE_STR;
+
+	for(uint8_t i=0;i<num;i++) {
+		char str_pattern[] = "XXXXX,";
+		str_pattern[0] = '0' + (p_imp[i] % 100000U / 10000U);
+		str_pattern[1] = '0' + (p_imp[i] % 10000U / 1000U);
+		str_pattern[2] = '0' + (p_imp[i] % 1000U / 100U);
+		str_pattern[3] = '0' + (p_imp[i] % 100U / 10U);
+		str_pattern[4] = '0' + (p_imp[i] % 10U);
+
+		uint8_t str_offset = 0;
+		while ((str_offset < 4U) && (str_pattern[str_offset] == '0')) {
+			str_offset++;
+		}
+		uint8_t str_len = (uint8_t)strlen(str_pattern) - str_offset;
+		if ((i + 1U) == num) {
+			str_len--;	//No separator after the last pair
+		}
+
+		(void)memcpy(&log_buff_write[offset], &str_pattern[str_offset], str_len);
+		offset += str_len;
+	}
+
+	(void)memcpy(&log_buff_write[offset], "ohm", 3U);
+	offset += 3U;
+
+	(void)memcpy(&log_buff_write[offset], log_end, sizeof(log_end));
+	offset += (uint16_t)(sizeof(log_end));
+
+	app_func_logs_write(log_buff_write, offset);
+}
+
 /**
  * @brief Write the update of parameters to the log
  * 
@@ -254,9 +481,8 @@ void app_func_logs_parameter_write(uint8_t* p_id, uint8_t data_format, const uin
  */
 bool app_func_logs_event_search(const char* event_type) {
 	bool result = false;
-	(void)memset(log_buff_write, 0, sizeof(log_buff_write));
+	char str_event[LEN_DATA_TYPE_STR + LEN_EVENT_TYPE_STR] = {0};
 	uint16_t offset = 0;
-	char* str_event = log_buff_write;
 
 	(void)memcpy(&str_event[offset], DATA_TYPE_EVENT, LEN_DATA_TYPE_STR);
 	offset += LEN_DATA_TYPE_STR;
@@ -275,6 +501,70 @@ bool app_func_logs_event_search(const char* event_type) {
 	return result;
 }
 
+/**
+ * @brief Convert an offset in the log ring into a FRAM address
+ *
+ * @param offset The offset from the oldest position of the ring, which is the current log pointer
+ * @return uint32_t The FRAM address
+ */
+static uint32_t app_func_logs_addr_get(uint32_t offset) {
+	return ADDR_LOG_BASE + (((logInfo.LogPointer - ADDR_LOG_BASE) + offset) % SIZE_LOG);
+}
+
+/**
+ * @brief Get the offset of the oldest data that can hold a log
+ *
+ * @return uint32_t The offset in the log ring. Before the ring wraps, the area after the log pointer has never been written.
+ */
+static uint32_t app_func_logs_oldest_offset_get(void) {
+	uint8_t data = 0;
+	bsp_fram_read(app_func_logs_addr_get(1U), &data, 1);
+	if (data != 0U) {
+		return 0U;
+	}
+	return SIZE_LOG - (logInfo.LogPointer - ADDR_LOG_BASE);
+}
+
+/**
+ * @brief Find the first log starting within [*p_offset, offset_end) of the log ring
+ *
+ * @param p_offset The offset to start searching from, and the offset of the log found
+ * @param offset_end The offset to stop searching at
+ * @param p_timestamp The timestamp string of the log found
+ * @param len_timestamp The length of the timestamp string
+ * @return true A log is found
+ * @return false No log starts in this range
+ */
+static bool app_func_logs_record_find(uint32_t* p_offset, uint32_t offset_end, uint8_t* p_timestamp, uint16_t len_timestamp) {
+	uint8_t chunk[LEN_LOG_SCAN_CHUNK];
+	uint32_t offset = *p_offset;
+
+	while (offset < offset_end) {
+		uint32_t addr = app_func_logs_addr_get(offset);
+		uint32_t len_chunk = LEN_LOG_SCAN_CHUNK;
+		if (len_chunk > ((ADDR_LOG_BASE + SIZE_LOG) - addr)) {
+			len_chunk = (ADDR_LOG_BASE + SIZE_LOG) - addr;
+		}
+		if (len_chunk > (offset_end - offset)) {
+			len_chunk = offset_end - offset;
+		}
+
+		bsp_fram_read(addr, chunk, (uint16_t)len_chunk);
+		for(uint32_t i=0;i<len_chunk;i++) {
+			if ((chunk[i] == (uint8_t)'[') && ((addr + i + len_timestamp) <= (ADDR_LOG_BASE + SIZE_LOG))) {
+				bsp_fram_read(addr + i, p_timestamp, len_timestamp);
+				if (p_timestamp[len_timestamp - 1U] == (uint8_t)']') {
+					*p_offset = offset + i;
+					return true;
+				}
+			}
+		}
+		offset += len_chunk;
+		bsp_wdg_refresh();
+	}
+	return false;
+}
+
 /**
  * @brief Read a log after this timestamp
  * 
@@ -283,37 +573,40 @@ bool app_func_logs_event_search(const char* event_type) {
  * @return uint8_t The length of the log data read
  */
 uint8_t app_func_logs_read(const uint8_t* p_timestamp, uint8_t* p_data) {
-	uint8_t len_read = 0U;
 	uint16_t len_timestamp = app_func_logs_timestamp_gen(p_timestamp);
 	char* str_timestamp = log_buff_read;
-	uint32_t addr_base = logInfo.LogPointer;
-	if (memcmp((uint8_t*)lastReadTimeStamp, (uint8_t*)str_timestamp, len_timestamp) == 0) {
-		addr_base = lastReadAddress;
+
+	//Logs are in chronological order from the log pointer around the ring, so a binary search finds the first log after this timestamp.
+	uint32_t offset_low = app_func_logs_oldest_offset_get();
+	uint32_t offset_high = SIZE_LOG;
+	uint32_t offset_found = SIZE_LOG;
+	while (offset_low < offset_high) {
+		uint32_t offset = offset_low + ((offset_high - offset_low) / 2U);
+		uint32_t offset_mid = offset;
+		if (!app_func_logs_record_find(&offset, offset_high, p_data, len_timestamp)) {
+			offset_high = offset_mid;
+		}
+		else if (memcmp(p_data, (uint8_t*)str_timestamp, len_timestamp) > 0) {
+			offset_found = offset;
+			offset_high = offset_mid;
+		}
+		else {
+			offset_low = offset + 1U;
+		}
 	}
 
-	uint32_t addr_pointer = 0U;
-	for(uint32_t i=0;i<SIZE_LOG;i++) {
-		addr_pointer = ((addr_base + i)%(ADDR_LOG_BASE + SIZE_LOG)) + ADDR_LOG_BASE;
-		bsp_fram_read(addr_pointer, p_data, 1);
-		if (p_data[0] == '[') {
-			bsp_fram_read(addr_pointer, p_data, len_timestamp);
-			if (p_data[len_timestamp - 1U] == ']') {
-				if (memcmp(p_data, (uint8_t*)str_timestamp, len_timestamp) > 0) {
-					len_read = len_timestamp;
-					for(uint8_t j=0;j<LEN_RESP_PAYLOAD_MAX;j++) {
-						bsp_wdg_refresh();
-						bsp_fram_read(addr_pointer + len_read, &p_data[len_read], 1);
-						if ((char)p_data[len_read] == '\n' || (char)p_data[len_read] == '\0') {
-							memcpy((uint8_t*)lastReadTimeStamp, p_data, len_timestamp);
-							lastReadAddress = addr_pointer;
-							return len_read + 1U;
-						}
-						len_read++;
-					}
-				}
+	if (offset_found < SIZE_LOG) {
+		uint32_t addr = app_func_logs_addr_get(offset_found);
+		uint16_t len_read = LEN_RESP_PAYLOAD_MAX;
+		if (len_read > ((ADDR_LOG_BASE + SIZE_LOG) - addr)) {
+			len_read = (uint16_t)((ADDR_LOG_BASE + SIZE_LOG) - addr);
+		}
+		bsp_fram_read(addr, p_data, len_read);
+		for(uint16_t i=len_timestamp;i<len_read;i++) {
+			if ((char)p_data[i] == '\n' || (char)p_data[i] == '\0') {
+				return (uint8_t)(i + 1U);
 			}
 		}
-		bsp_wdg_refresh();
 	}
 	return 0;
 }
@@ -328,6 +621,8 @@ void app_func_logs_erase(void) {
 	bsp_fram_erase(ADDR_LOG_INFO, sizeof(Log_Info_t));
 	memset(&logInfo, 0, sizeof(Log_Info_t));
 	logInfo.LogPointer = ADDR_LOG_BASE;
+	logInfoWritten = logInfo;
+	log_info_unsaved = 0;
 }
 
 /**
@@ -338,7 +633,30 @@ void app_func_logs_erase(void) {
  */
 void app_func_logs_write_cplt_cb(uint32_t write_addr, uint16_t write_size) {
 	if ((write_addr >= ADDR_LOG_BASE) && (write_addr < (ADDR_LOG_BASE + SIZE_LOG))) {
-		logInfo.LogPointer += ((uint32_t)write_size - 1U);
-		bsp_fram_write(ADDR_LOG_INFO, (uint8_t*)&logInfo, sizeof(logInfo), false);
+		//The tail and the base cleared when the ring wraps are not logs, a log never reaches the end of the ring.
+		//The writes complete in order, so the base cleared is the first write of one byte at the base after the wrap.
+		if ((write_addr + write_size) == (ADDR_LOG_BASE + SIZE_LOG)) {
+			__NOP();
+		}
+		else if ((write_addr == ADDR_LOG_BASE) && (write_size == 1U) && log_wrap_pending) {
+			log_wrap_pending = false;
+		}
+		//The rest of a log is written before its first byte, which completes it
+		else if (write_size > 1U) {
+			log_write_end = write_addr + ((uint32_t)write_size - 1U);
+		}
+		else {
+			if (log_write_pending > 0U) {
+				log_write_pending--;
+			}
+			//Only the end of a log that is already in FRAM is saved, later logs may still be queued.
+			//Logs written after the last save are found again by app_func_logs_init.
+			logInfoWritten.LogPointer = log_write_end;
+			log_info_unsaved++;
+			if (log_info_unsaved >= LOG_INFO_SAVE_INTERVAL) {
+				log_info_unsaved = 0;
+				bsp_fram_write(ADDR_LOG_INFO, (uint8_t*)&logInfoWritten, sizeof(logInfoWritten), false);
+			}
+		}
 	}
 }
@@ -9,8 +9,8 @@
 #include <math.h>
 #include <stdlib.h>
 
-uint16_t battA[100];
-uint16_t battB[100];
+uint16_t battA[BATT_MON_SAMPLE_NUM];
+uint16_t battB[BATT_MON_SAMPLE_NUM];
 
 /**
  * @brief Enable / Disable battery monitor
@@ -28,18 +28,38 @@ void app_func_meas_batt_mon_enable(bool enable) {
  * @param p_vbatB The battery voltage of battery 2, unit: mV
  */
 void app_func_meas_batt_mon_meas(uint16_t* p_vbatA, uint16_t* p_vbatB) {
-	bsp_adc_single_sampling(HANDLE_ID_ADC1, ADC1_CHANNEL_BATT_MON1, battA, 100, 100);
-	bsp_adc_single_sampling(HANDLE_ID_ADC1, ADC1_CHANNEL_BATT_MON2, battB, 100, 100);
-	uint32_t vAavg = 0;
-	uint32_t vBavg = 0;
-	for(uint8_t i=0;i<100;i++) {
-		vAavg += battA[i];
-		vBavg += battB[i];
+	uint32_t vAsum = 0;
+	uint32_t vBsum = 0;
+	app_func_meas_batt_mon_sum(BATT_MON_SAMPLE_NUM, &vAsum, &vBsum);
+	p_vbatA[0] = app_func_meas_batt_mon_volt_calc(vAsum, BATT_MON_SAMPLE_NUM);
+	p_vbatB[0] = app_func_meas_batt_mon_volt_calc(vBsum, BATT_MON_SAMPLE_NUM);
+}
+
+/**
+ * @brief The battery monitor samples both batteries and adds the samples to the sums, so a measurement can be split into slices
+ *
+ * @param sample_num The number of samples of each battery, up to BATT_MON_SAMPLE_NUM
+ * @param p_sumA The sum of the samples of battery 1
+ * @param p_sumB The sum of the samples of battery 2
+ */
+void app_func_meas_batt_mon_sum(uint16_t sample_num, uint32_t* p_sumA, uint32_t* p_sumB) {
+	bsp_adc_single_sampling(HANDLE_ID_ADC1, ADC1_CHANNEL_BATT_MON1, battA, sample_num, BATT_MON_SAMPLE_FREQ);
+	bsp_adc_single_sampling(HANDLE_ID_ADC1, ADC1_CHANNEL_BATT_MON2, battB, sample_num, BATT_MON_SAMPLE_FREQ);
+	for(uint16_t i=0;i<sample_num;i++) {
+		*p_sumA += battA[i];
+		*p_sumB += battB[i];
 	}
-	vAavg /= 100;
-	vBavg /= 100;
-	p_vbatA[0] = vAavg * BSP_BATT_FACTOR;
-	p_vbatB[0] = vBavg * BSP_BATT_FACTOR;
+}
+
+/**
+ * @brief Convert the sum of the battery monitor samples to the battery voltage
+ *
+ * @param sum The sum of the samples
+ * @param sample_num The number of samples
+ * @return uint16_t The battery voltage, unit: mV
+ */
+uint16_t app_func_meas_batt_mon_volt_calc(uint32_t sum, uint16_t sample_num) {
+	return (uint16_t)((sum / sample_num) * BSP_BATT_FACTOR);
 }
 
 /**
@@ -8,6 +8,8 @@
 
 #define FORCED_FACTORY_RESET	false
 #define BYTE_PER_ADDRESS		8U		/*!< The data size of each address in the EEPROM */
+#define PARA_IMAGE_MAGIC		0x41524150UL	/*!< The magic number of the parameter image in FRAM, "PARA" */
+#define LEN_PARA_IMAGE_CRC		2U		/*!< The length of the CRC after the parameter data */
 
 static uint16_t def_sample_id = 0x0000;
 static Parameter_Format_Rawdata_t format_sample_id = {
@@ -215,47 +217,15 @@ Parameter_t parameters_list[] = {
 
 const uint16_t parameters_list_size = (uint16_t)(sizeof(parameters_list) / sizeof(Parameter_t));
 
-/**
- * @brief Writes/updates parameter data
- * 
- * @param virtAddress virtual address on 16 bits (can't be 0x0000 or 0xFFFF)
- * @param p_id Parameter ID
- * @param p_data Parameter data
- * @param datalen Parameter data length
- * @return uint16_t Next EEPROM virtual address
- */
-static uint16_t app_func_para_write (uint16_t virtAddress, const uint8_t* p_id, const uint8_t* p_data, uint8_t datalen) {
-	uint16_t addr = virtAddress;
-	Parameter_Data96bits_t data;
-	uint8_t datalen_ofbuff = (uint8_t)sizeof(data.buffer);
-	(void)memcpy(data.id, p_id, sizeof(data.id));
-
-	EE_Status ee_status = EE_OK;
-	for(uint8_t i = 0;i < datalen;i+=datalen_ofbuff) {
-		data.buffer = 0;
-		uint8_t datalen_inbuff = datalen - i;
-		if (datalen_inbuff < datalen_ofbuff) {
-			(void)memcpy((uint8_t*)&data.buffer, &p_data[i], datalen_inbuff);
-		}
-		else {
-			(void)memcpy((uint8_t*)&data.buffer, &p_data[i], datalen_ofbuff);
-		}
-
-	    ee_status = EE_WriteVariable96bits(addr, &data.buffer);
+static uint16_t parameters_index[sizeof(parameters_list) / sizeof(Parameter_t)];	/*!< The indexes of parameters_list sorted by parameter ID */
+static bool parameters_index_ready = false;
 
-	    /* Start cleanup mode, if cleanup is needed */
-	    if (((uint16_t)ee_status & EE_STATUSMASK_CLEANUP) == EE_STATUSMASK_CLEANUP) {
-	    	ee_status = EE_CleanUp();
-	    }
+static Parameter_Image_t para_image;
+static uint16_t para_image_crc = 0;
+static uint16_t para_profile_len = 0;		/*!< The data length of the stimulation parameters of one therapy profile */
 
-	    if (ee_status != EE_OK) {
-	    	Error_Handler();
-	    }
-	    addr++;
-	}
-	HAL_ERROR_CHECK(HAL_ICACHE_Invalidate());
-	return addr;
-}
+static Parameter_Subscriber_t para_subscribers[PARA_SUBSCRIBER_NUM_MAX];
+static uint8_t para_subscriber_num = 0;
 
 /**
  * @brief Returns the last stored parameter data
@@ -298,6 +268,34 @@ static uint16_t app_func_para_read (uint16_t virtAddress, uint8_t* p_id, uint8_t
 	return addr;
 }
 
+/**
+ * @brief Get the sort key of the parameter ID
+ *
+ * @param p_id Parameter ID
+ * @return uint32_t The sort key, the parameter ID read as a big-endian number
+ */
+static uint32_t app_func_para_id_key(const uint8_t* p_id) {
+	return ((uint32_t)p_id[0] << 24) | ((uint32_t)p_id[1] << 16) | ((uint32_t)p_id[2] << 8) | (uint32_t)p_id[3];
+}
+
+/**
+ * @brief Sort the indexes of the parameter list by parameter ID
+ *
+ * The order of parameters_list is kept, since it sets the layout of the parameters in the EEPROM and FRAM.
+ */
+static void app_func_para_index_build(void) {
+	for(uint16_t i=0;i<parameters_list_size;i++) {
+		uint32_t key = app_func_para_id_key(parameters_list[i].id);
+		uint16_t j = i;
+		while ((j > 0U) && (app_func_para_id_key(parameters_list[parameters_index[j - 1U]].id) > key)) {
+			parameters_index[j] = parameters_index[j - 1U];
+			j--;
+		}
+		parameters_index[j] = i;
+	}
+	parameters_index_ready = true;
+}
+
 /**
  * @brief Get the corresponding parameter based on the parameter ID
  *
@@ -308,42 +306,146 @@ static Parameter_t* app_func_para_get(const uint8_t* p_id) {
 	Parameter_t* p_para = NULL;
 
 	if (p_id != NULL) {
-		uint16_t amount = (uint16_t)(sizeof(parameters_list) / sizeof(Parameter_t));
-		for(uint16_t i=0;i<amount;i++) {
-			if (memcmp(parameters_list[i].id, p_id, LEN_ID) == 0) {
-				p_para = &parameters_list[i];
+		if (!parameters_index_ready) {
+			app_func_para_index_build();
+		}
+
+		uint32_t key = app_func_para_id_key(p_id);
+		uint16_t low = 0;
+		uint16_t high = parameters_list_size;
+		while (low < high) {
+			uint16_t mid = low + ((high - low) / 2U);
+			Parameter_t* p_mid = &parameters_list[parameters_index[mid]];
+			uint32_t key_mid = app_func_para_id_key(p_mid->id);
+			if (key_mid == key) {
+				p_para = p_mid;
 				break;
 			}
+			else if (key_mid < key) {
+				low = mid + 1U;
+			}
+			else {
+				high = mid;
+			}
 		}
 	}
 	return p_para;
 }
 
 /**
- * @brief Parameter buffer initialization
- * 
+ * @brief Check whether the parameter is a stimulation parameter, kept separately for each therapy profile
+ *
+ * @param p_para The parameter
+ * @return true The parameter is kept for each therapy profile
+ * @return false The parameter is shared by all therapy profiles
  */
-void app_func_para_init (void) {
-    uint32_t pid = 0;
-    uint16_t fw_elements = 0;
-    uint16_t fw_id_crc = (uint16_t)hcrc.Instance->INIT;
-    uint8_t fw_id_times = 0;
-    __HAL_CRC_DR_RESET(&hcrc);
+static bool app_func_para_is_profile(const Parameter_t* p_para) {
+	return ((memcmp(p_para->id, (uint8_t*)SPID_PREFIX, 2) == 0) || (memcmp(p_para->id, (uint8_t*)SPID_PREFIX_ST, 2) == 0));
+}
+
+/**
+ * @brief Get the offset of the parameter data of a therapy profile in the parameter data.
+ * The stimulation parameters of all therapy profiles are at the end of the parameter data, one profile after the other.
+ *
+ * @param p_para The parameter
+ * @param profile The index of the therapy profile, or THERAPY_PROFILE_ACTIVE
+ * @return uint16_t The offset of the parameter data
+ */
+static uint16_t app_func_para_offset_get(const Parameter_t* p_para, uint8_t profile) {
+	uint16_t offset = p_para->dataOffset;
+	if (app_func_para_is_profile(p_para)) {
+		uint8_t index = (profile == THERAPY_PROFILE_ACTIVE) ? para_image.Header.Profile : profile;
+		if (index < THERAPY_PROFILE_NUM) {
+			offset += (uint16_t)index * para_profile_len;
+		}
+	}
+	return offset;
+}
+
+/**
+ * @brief Write a part of the parameter image and its CRC to one copy in FRAM
+ *
+ * @param addr The FRAM address of the copy
+ * @param offset The offset of the part in the parameter image
+ * @param len The length of the part
+ */
+static void app_func_para_image_save(uint32_t addr, uint16_t offset, uint16_t len) {
+	uint16_t len_image = (uint16_t)sizeof(para_image.Header) + para_image.Header.DataLen;
+	bsp_fram_write(addr + offset, &((uint8_t*)&para_image)[offset], len, true);
+	bsp_fram_write(addr + len_image, (uint8_t*)&para_image_crc, LEN_PARA_IMAGE_CRC, true);
+}
+
+/**
+ * @brief Write a part of the parameter image to both copies in FRAM.
+ * The second copy is only written after the first one is complete, so one of them is always valid.
+ *
+ * @param offset The offset of the part in the parameter image
+ * @param len The length of the part
+ */
+static void app_func_para_image_commit(uint16_t offset, uint16_t len) {
+	uint16_t len_image = (uint16_t)sizeof(para_image.Header) + para_image.Header.DataLen;
+	para_image_crc = (uint16_t)HAL_CRC_Calculate(&hcrc, (uint32_t*)&para_image, len_image);
+	app_func_para_image_save(ADDR_PARA_BASE, offset, len);
+	app_func_para_image_save(ADDR_PARA_BACKUP, offset, len);
+}
+
+/**
+ * @brief Load a copy of the parameter image from FRAM
+ *
+ * @param addr The FRAM address of the copy
+ * @param id_crc The CRC of the parameter IDs of this firmware
+ * @param data_len The data length of all parameters of this firmware
+ * @return true The copy is valid and has the same parameter layout as this firmware
+ * @return false The copy is invalid
+ */
+static bool app_func_para_image_load(uint32_t addr, uint16_t id_crc, uint16_t data_len) {
+	bsp_fram_read(addr, (uint8_t*)&para_image.Header, (uint16_t)sizeof(para_image.Header));
+	if ((para_image.Header.Magic != PARA_IMAGE_MAGIC) || (para_image.Header.IdCrc != id_crc) || (para_image.Header.DataLen != data_len)) {
+		return false;
+	}
+
+	uint16_t len_image = (uint16_t)sizeof(para_image.Header) + data_len;
+	bsp_fram_read(addr + sizeof(para_image.Header), para_image.Data, data_len);
+	bsp_fram_read(addr + len_image, (uint8_t*)&para_image_crc, LEN_PARA_IMAGE_CRC);
+	return (para_image_crc == (uint16_t)HAL_CRC_Calculate(&hcrc, (uint32_t*)&para_image, len_image));
+}
+
+/**
+ * @brief Load a copy of the parameter image of earlier firmware with a single therapy profile.
+ * The data of all parameters is in the order of the parameter list there, it is moved to the offsets of this firmware.
+ *
+ * @param addr The FRAM address of the copy
+ * @param id_crc The CRC of the parameter IDs of this firmware
+ * @param data_len The data length of all parameters with a single therapy profile
+ * @return true The parameters are copied to the parameter image
+ * @return false The copy is invalid or has a different parameter layout
+ */
+static bool app_func_para_image_single_load(uint32_t addr, uint16_t id_crc, uint16_t data_len) {
+	if (!app_func_para_image_load(addr, id_crc, data_len)) {
+		return false;
+	}
 
+	//The copy is valid, its data is read again parameter by parameter to the offsets of this firmware
+	uint16_t offset = 0;
 	for(uint16_t i=0;i<parameters_list_size;i++) {
 		uint8_t datalen = app_func_para_datalen_get(parameters_list[i].id);
-		if ((datalen % BYTE_PER_ADDRESS) > 0U) {
-			fw_id_times = (datalen / BYTE_PER_ADDRESS) + 1U;
-		}
-		else {
-			fw_id_times = datalen / BYTE_PER_ADDRESS;
-		}
-		for(uint8_t j=0;j<fw_id_times;j++) {
-			(void)memcpy((uint8_t*)&pid, parameters_list[i].id, LEN_ID);
-			fw_id_crc = (uint16_t)HAL_CRC_Accumulate(&hcrc, &pid, LEN_ID);
-			fw_elements++;
-		}
+		bsp_fram_read(addr + sizeof(para_image.Header) + offset, &para_image.Data[parameters_list[i].dataOffset], datalen);
+		offset += datalen;
 	}
+	return true;
+}
+
+/**
+ * @brief Copy the parameters from the EEPROM emulation used by earlier firmware
+ *
+ * @param id_crc The CRC of the parameter IDs of this firmware
+ * @param elements The number of EEPROM variables of this firmware
+ * @return true The parameters are copied to the parameter image
+ * @return false The EEPROM is empty or has a different parameter layout
+ */
+static bool app_func_para_eeprom_migrate(uint16_t id_crc, uint16_t elements) {
+	uint32_t pid = 0;
+	bool migrated = false;
 
 	HAL_ERROR_CHECK(HAL_FLASH_Unlock());
 	EE_Status ee_status = EE_OK;
@@ -352,7 +454,6 @@ void app_func_para_init (void) {
     	Error_Handler();
     }
 
-	ee_status = EE_OK;
 	Parameter_Data96bits_t eeData;
 	uint16_t ee_elements = 0;
 	uint16_t ee_id_crc = (uint16_t)hcrc.Instance->INIT;
@@ -371,54 +472,126 @@ void app_func_para_init (void) {
 		}
 	}
 
-	if (FORCED_FACTORY_RESET)
-		fw_elements = ee_elements + 1;
-
-	if (((virtAddr == 1U) && (ee_status == EE_NO_DATA)) || (memcmp(&fw_id_crc, &ee_id_crc, sizeof(uint16_t)) != 0) || (fw_elements != ee_elements)) {
-	    ee_status = EE_Format(EE_FORCED_ERASE);
-	    if(ee_status != EE_OK) {
-	    	Error_Handler();
-	    }
+	if ((ee_elements > 0U) && (ee_id_crc == id_crc) && (ee_elements == elements)) {
 		virtAddr = 1;
 		for(uint16_t i=0;i<parameters_list_size;i++) {
 			parameters_list[i].virtAddress = virtAddr;
-			uint8_t* p_data_def = NULL;
-			uint8_t datalen = 0;
-			if (parameters_list[i].format.spec_Rawdata != NULL) {
-				Parameter_Format_Rawdata_t* format = parameters_list[i].format.spec_Rawdata;
-				p_data_def = (uint8_t*)(format->data_def);
-				datalen = format->data_len;
-			}
-			else {
-				Parameter_Format_Value_t* format = parameters_list[i].format.spec_Value;
-				p_data_def = (uint8_t*)(&format->def);
-				datalen = (uint8_t)LEN_FORMAT_VALUE;
-			}
-			virtAddr = app_func_para_write(virtAddr, parameters_list[i].id, p_data_def, datalen);
+			uint8_t datalen = app_func_para_datalen_get(parameters_list[i].id);
+			virtAddr = app_func_para_read(virtAddr, NULL, &para_image.Data[parameters_list[i].dataOffset], datalen);
+		}
+		migrated = true;
+	}
+	HAL_ERROR_CHECK(HAL_FLASH_Lock());
+	return migrated;
+}
+
+/**
+ * @brief Erase the EEPROM emulation used by earlier firmware, once its parameters are in the parameter image.
+ * A stale copy would otherwise be migrated again if both copies in FRAM are lost, over a newer parameter layout.
+ *
+ */
+static void app_func_para_eeprom_erase(void) {
+	HAL_ERROR_CHECK(HAL_FLASH_Unlock());
+	if (EE_Format(EE_FORCED_ERASE) != EE_OK) {
+		Error_Handler();
+	}
+	HAL_ERROR_CHECK(HAL_FLASH_Lock());
+}
+
+/**
+ * @brief Parameter buffer initialization
+ * 
+ */
+void app_func_para_init (void) {
+    uint32_t pid = 0;
+    uint16_t fw_elements = 0;
+    uint16_t fw_id_crc = (uint16_t)hcrc.Instance->INIT;
+    uint8_t fw_id_times = 0;
+    uint16_t data_len = 0;
+    __HAL_CRC_DR_RESET(&hcrc);
+
+    app_func_para_index_build();
+
+    para_profile_len = 0;
+	for(uint16_t i=0;i<parameters_list_size;i++) {
+		uint8_t datalen = app_func_para_datalen_get(parameters_list[i].id);
+		if ((datalen % BYTE_PER_ADDRESS) > 0U) {
+			fw_id_times = (datalen / BYTE_PER_ADDRESS) + 1U;
+		}
+		else {
+			fw_id_times = datalen / BYTE_PER_ADDRESS;
+		}
+		for(uint8_t j=0;j<fw_id_times;j++) {
+			(void)memcpy((uint8_t*)&pid, parameters_list[i].id, LEN_ID);
+			fw_id_crc = (uint16_t)HAL_CRC_Accumulate(&hcrc, &pid, LEN_ID);
+			fw_elements++;
+		}
+		if (!app_func_para_is_profile(&parameters_list[i])) {
+			parameters_list[i].dataOffset = data_len;
+			data_len += datalen;
+		}
+	}
+	for(uint16_t i=0;i<parameters_list_size;i++) {
+		if (app_func_para_is_profile(&parameters_list[i])) {
+			parameters_list[i].dataOffset = data_len + para_profile_len;
+			para_profile_len += app_func_para_datalen_get(parameters_list[i].id);
+		}
+	}
+	uint16_t profile_base = data_len;
+	data_len += (uint16_t)THERAPY_PROFILE_NUM * para_profile_len;
+	if (data_len > LEN_PARA_DATA_MAX) {
+		Error_Handler();
+	}
+
+	if (!FORCED_FACTORY_RESET && app_func_para_image_load(ADDR_PARA_BASE, fw_id_crc, data_len)) {
+		//The backup is repaired if a write was interrupted before it was updated
+		uint16_t crc_backup = 0;
+		bsp_fram_read(ADDR_PARA_BACKUP + sizeof(para_image.Header) + data_len, (uint8_t*)&crc_backup, LEN_PARA_IMAGE_CRC);
+		if (crc_backup != para_image_crc) {
+			app_func_para_image_save(ADDR_PARA_BACKUP, 0U, (uint16_t)sizeof(para_image.Header) + data_len);
 		}
 	}
+	else if (!FORCED_FACTORY_RESET && app_func_para_image_load(ADDR_PARA_BACKUP, fw_id_crc, data_len)) {
+		app_func_para_image_save(ADDR_PARA_BASE, 0U, (uint16_t)sizeof(para_image.Header) + data_len);
+	}
 	else {
-		virtAddr = 1;
-		for(uint16_t i=0;i<parameters_list_size;i++) {
-			parameters_list[i].virtAddress = virtAddr;
-			uint8_t datalen = app_func_para_datalen_get(parameters_list[i].id);
-			uint16_t addroffset = (uint16_t)datalen / BYTE_PER_ADDRESS;
-			if ((datalen % BYTE_PER_ADDRESS) > 0U) {
-				virtAddr += (addroffset + 1U);
-			}
-			else {
-				virtAddr += addroffset;
+		bool migrated = false;
+		if (!FORCED_FACTORY_RESET) {
+			//Earlier firmware kept a single therapy profile, with the data in the order of the parameter list
+			uint16_t data_len_single = profile_base + para_profile_len;
+			migrated = app_func_para_image_single_load(ADDR_PARA_BASE, fw_id_crc, data_len_single) ||
+					app_func_para_image_single_load(ADDR_PARA_BACKUP, fw_id_crc, data_len_single) ||
+					app_func_para_eeprom_migrate(fw_id_crc, fw_elements);
+		}
+		para_image.Header.Magic = PARA_IMAGE_MAGIC;
+		para_image.Header.IdCrc = fw_id_crc;
+		para_image.Header.DataLen = data_len;
+		para_image.Header.Profile = 0;
+		(void)memset(para_image.Header.Reserved, 0, sizeof(para_image.Header.Reserved));
+		if (!migrated) {
+			for(uint16_t i=0;i<parameters_list_size;i++) {
+				app_func_para_defdata_get(parameters_list[i].id, &para_image.Data[parameters_list[i].dataOffset]);
 			}
 		}
-
-		uint8_t def_ipg_fw_ver[6] = APP_FW_VER_STR;
-		uint8_t hp_ipg_fw_ver[6];
-		app_func_para_data_get((const uint8_t*)HPID_IPG_FW_VERSION, hp_ipg_fw_ver, (uint8_t)sizeof(hp_ipg_fw_ver));
-		if (memcmp(hp_ipg_fw_ver, def_ipg_fw_ver, sizeof(def_ipg_fw_ver)) != 0) {
-			app_func_para_data_set((const uint8_t*)HPID_IPG_FW_VERSION, NULL);
+		//All therapy profiles start with the stimulation parameters of the first one
+		for(uint8_t i=1;i<THERAPY_PROFILE_NUM;i++) {
+			(void)memcpy(&para_image.Data[profile_base + ((uint16_t)i * para_profile_len)], &para_image.Data[profile_base], para_profile_len);
+		}
+		app_func_para_image_commit(0U, (uint16_t)sizeof(para_image.Header) + data_len);
+		if (migrated) {
+			app_func_para_eeprom_erase();
 		}
 	}
-	HAL_ERROR_CHECK(HAL_FLASH_Lock());
+	if (para_image.Header.Profile >= THERAPY_PROFILE_NUM) {
+		Error_Handler();
+	}
+
+	uint8_t def_ipg_fw_ver[6] = APP_FW_VER_STR;
+	uint8_t hp_ipg_fw_ver[6];
+	app_func_para_data_get((const uint8_t*)HPID_IPG_FW_VERSION, hp_ipg_fw_ver, (uint8_t)sizeof(hp_ipg_fw_ver));
+	if (memcmp(hp_ipg_fw_ver, def_ipg_fw_ver, sizeof(def_ipg_fw_ver)) != 0) {
+		app_func_para_data_set((const uint8_t*)HPID_IPG_FW_VERSION, NULL);
+	}
 }
 
 /**
@@ -469,6 +642,56 @@ uint8_t app_func_para_datalen_get(const uint8_t* p_id) {
 	return datalen;
 }
 
+/**
+ * @brief Update the data of the parameter in the parameter image
+ *
+ * @param profile The index of the therapy profile, or THERAPY_PROFILE_ACTIVE
+ * @param p_id Parameter ID
+ * @param p_data The data corresponding to the parameter ID. If null, the default data is used
+ * @param p_offset The offset of the data in the parameter image
+ * @return uint8_t The data length of the parameter, 0 if the parameter ID is invalid
+ */
+static uint8_t app_func_para_data_update(uint8_t profile, const uint8_t* p_id, const uint8_t* p_data, uint16_t* p_offset) {
+	Parameter_t* p_para = app_func_para_get(p_id);
+	if (p_para == NULL) {
+		return 0;
+	}
+
+	uint8_t datalen = 0;
+	const uint8_t* p_data_set = p_data;
+	if (p_para->format.spec_Rawdata != NULL) {
+		Parameter_Format_Rawdata_t* format = p_para->format.spec_Rawdata;
+		datalen = format->data_len;
+		if (p_data_set == NULL) {
+			p_data_set = (uint8_t*)format->data_def;
+		}
+	}
+	else {
+		datalen = (uint8_t)LEN_FORMAT_VALUE;
+		if (p_data_set == NULL) {
+			Parameter_Format_Value_t* format = p_para->format.spec_Value;
+			p_data_set = (uint8_t*)&format->def;
+		}
+	}
+	uint16_t offset = app_func_para_offset_get(p_para, profile);
+	(void)memmove(&para_image.Data[offset], p_data_set, datalen);
+	*p_offset = (uint16_t)sizeof(para_image.Header) + offset;
+	return datalen;
+}
+
+/**
+ * @brief Notify the subscribers of the parameter that it has changed
+ *
+ * @param p_id Parameter ID
+ */
+static void app_func_para_notify(const uint8_t* p_id) {
+	for(uint8_t i=0;i<para_subscriber_num;i++) {
+		if (memcmp(para_subscribers[i].id, p_id, LEN_ID) == 0) {
+			para_subscribers[i].callback(p_id);
+		}
+	}
+}
+
 /**
  * @brief Set the data based on the parameter ID
  *
@@ -477,27 +700,64 @@ uint8_t app_func_para_datalen_get(const uint8_t* p_id) {
  */
 void app_func_para_data_set(const uint8_t* p_id, uint8_t* p_data) {
 	if (p_id != NULL) {
-		Parameter_t* p_para = app_func_para_get(p_id);
-		if (p_para != NULL) {
+		uint16_t offset = 0;
+		uint8_t datalen = app_func_para_data_update(THERAPY_PROFILE_ACTIVE, p_id, p_data, &offset);
+		if (datalen > 0U) {
+			app_func_para_image_commit(offset, datalen);
+			app_func_para_notify(p_id);
+		}
+	}
+}
+
+/**
+ * @brief Set the data of several parameters with a single update of the parameter image in FRAM
+ *
+ * @param p_ids The IDs of the parameters
+ * @param p_datas The data corresponding to each parameter ID. If an entry is null, the default data is written
+ * @param num The number of parameters
+ */
+void app_func_para_data_set_batch(const uint8_t* const p_ids[], const uint8_t* const p_datas[], uint8_t num) {
+	app_func_para_profile_data_set_batch(THERAPY_PROFILE_ACTIVE, p_ids, p_datas, num);
+}
+
+/**
+ * @brief Set the data of several parameters of a therapy profile with a single update of the parameter image in FRAM
+ *
+ * @param profile The index of the therapy profile, or THERAPY_PROFILE_ACTIVE
+ * @param p_ids The IDs of the parameters
+ * @param p_datas The data corresponding to each parameter ID. If an entry is null, the default data is written
+ * @param num The number of parameters
+ */
+void app_func_para_profile_data_set_batch(uint8_t profile, const uint8_t* const p_ids[], const uint8_t* const p_datas[], uint8_t num) {
+	if ((p_ids != NULL) && (p_datas != NULL) && (num > 0U) && ((profile < THERAPY_PROFILE_NUM) || (profile == THERAPY_PROFILE_ACTIVE))) {
+		//The stimulation parameters of an inactive therapy profile are not in use, so their subscribers are not notified
+		bool notify = ((profile == THERAPY_PROFILE_ACTIVE) || (profile == para_image.Header.Profile));
+		uint16_t offset_start = UINT16_MAX;
+		uint16_t offset_end = 0;
+		for(uint8_t i=0;i<num;i++) {
+			uint16_t offset = 0;
 			uint8_t datalen = 0;
-			uint8_t* p_data_set = p_data;
-			if (p_para->format.spec_Rawdata != NULL) {
-				Parameter_Format_Rawdata_t* format = p_para->format.spec_Rawdata;
-				datalen = format->data_len;
-				if (p_data_set == NULL) {
-					p_data_set = (uint8_t*)format->data_def;
+			if (p_ids[i] != NULL) {
+				datalen = app_func_para_data_update(profile, p_ids[i], p_datas[i], &offset);
+			}
+			if (datalen > 0U) {
+				if (offset < offset_start) {
+					offset_start = offset;
+				}
+				if ((offset + datalen) > offset_end) {
+					offset_end = offset + datalen;
 				}
 			}
-			else {
-				datalen = (uint8_t)LEN_FORMAT_VALUE;
-				if (p_data_set == NULL) {
-					Parameter_Format_Value_t* format = p_para->format.spec_Value;
-					p_data_set = (uint8_t*)&format->def;
+		}
+		//All parameters of the batch are in one range of the image, so either all or none of them are in a valid copy
+		if (offset_end > offset_start) {
+			app_func_para_image_commit(offset_start, offset_end - offset_start);
+			for(uint8_t i=0;i<num;i++) {
+				if ((p_ids[i] != NULL) && (app_func_para_get(p_ids[i]) != NULL) &&
+						(notify || !app_func_para_profile_contains(p_ids[i]))) {
+					app_func_para_notify(p_ids[i]);
 				}
 			}
-			HAL_ERROR_CHECK(HAL_FLASH_Unlock());
-			(void)app_func_para_write(p_para->virtAddress, p_id, p_data_set, datalen);
-			HAL_ERROR_CHECK(HAL_FLASH_Lock());
 		}
 	}
 }
@@ -510,6 +770,65 @@ void app_func_para_data_set(const uint8_t* p_id, uint8_t* p_data) {
  * @param buff_size The data buffer size of p_data
  */
 void app_func_para_data_get(const uint8_t* p_id, uint8_t* p_data, uint8_t buff_size) {
+	app_func_para_profile_data_get(THERAPY_PROFILE_ACTIVE, p_id, p_data, buff_size);
+}
+
+/**
+ * @brief Check whether the parameter is kept separately for each therapy profile
+ *
+ * @param p_id Parameter ID
+ * @return true The parameter is a stimulation parameter of the therapy profiles
+ * @return false The parameter is shared by all therapy profiles, or the parameter ID is invalid
+ */
+bool app_func_para_profile_contains(const uint8_t* p_id) {
+	Parameter_t* p_para = app_func_para_get(p_id);
+	return ((p_para != NULL) && app_func_para_is_profile(p_para));
+}
+
+/**
+ * @brief Get the therapy profile that is active
+ *
+ * @return uint8_t The index of the active therapy profile
+ */
+uint8_t app_func_para_profile_get(void) {
+	return para_image.Header.Profile;
+}
+
+/**
+ * @brief Select the active therapy profile. Only the profile index in the parameter image is written,
+ * so the stimulation parameters switch all at once and are used from the next therapy start.
+ *
+ * @param profile The index of the therapy profile
+ * @return true The therapy profile is selected
+ * @return false The profile index is invalid
+ */
+bool app_func_para_profile_select(uint8_t profile) {
+	if (profile >= THERAPY_PROFILE_NUM) {
+		return false;
+	}
+
+	if (profile != para_image.Header.Profile) {
+		para_image.Header.Profile = profile;
+		uint16_t offset = (uint16_t)((uint8_t*)&para_image.Header.Profile - (uint8_t*)&para_image);
+		app_func_para_image_commit(offset, (uint16_t)sizeof(para_image.Header.Profile));
+		for(uint8_t i=0;i<para_subscriber_num;i++) {
+			if (app_func_para_profile_contains(para_subscribers[i].id)) {
+				para_subscribers[i].callback(para_subscribers[i].id);
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Get the data of a therapy profile based on the parameter ID
+ *
+ * @param profile The index of the therapy profile, or THERAPY_PROFILE_ACTIVE
+ * @param p_id Parameter ID
+ * @param p_data The data corresponding to the parameter ID
+ * @param buff_size The data buffer size of p_data
+ */
+void app_func_para_profile_data_get(uint8_t profile, const uint8_t* p_id, uint8_t* p_data, uint8_t buff_size) {
 	if ((p_id != NULL) && (p_data != NULL)) {
 		Parameter_t* p_para = app_func_para_get(p_id);
 		if (p_para != NULL) {
@@ -524,9 +843,41 @@ void app_func_para_data_get(const uint8_t* p_id, uint8_t* p_data, uint8_t buff_s
 			if (buff_size < datalen) {
 				datalen = buff_size;
 			}
-			(void)app_func_para_read(p_para->virtAddress, NULL, p_data, datalen);
+			(void)memcpy(p_data, &para_image.Data[app_func_para_offset_get(p_para, profile)], datalen);
+		}
+	}
+}
+
+/**
+ * @brief Subscribe to the changes of the parameter. The callback is called once at subscription with the current data,
+ * then after each change of the parameter.
+ *
+ * @param p_id Parameter ID
+ * @param callback Callback when the parameter changes
+ * @return true The subscription is added
+ * @return false The parameter ID is invalid or there are too many subscribers
+ */
+bool app_func_para_subscribe(const uint8_t* p_id, Parameter_Change_Callback callback) {
+	if ((p_id == NULL) || (callback == NULL) || (app_func_para_get(p_id) == NULL)) {
+		return false;
+	}
+
+	bool subscribed = false;
+	for(uint8_t i=0;i<para_subscriber_num;i++) {
+		if ((memcmp(para_subscribers[i].id, p_id, LEN_ID) == 0) && (para_subscribers[i].callback == callback)) {
+			subscribed = true;
+		}
+	}
+	if (!subscribed) {
+		if (para_subscriber_num >= PARA_SUBSCRIBER_NUM_MAX) {
+			return false;
 		}
+		(void)memcpy(para_subscribers[para_subscriber_num].id, p_id, LEN_ID);
+		para_subscribers[para_subscriber_num].callback = callback;
+		para_subscriber_num++;
 	}
+	callback(p_id);
+	return true;
 }
 
 /**
@@ -13,6 +13,9 @@ uint16_t curr_state = STATE_INVALID;
 int32_t impedance_test_hour_timer = -1;
 int32_t battery_test_hour_timer = -1;
 
+static int32_t impedance_test_interval_hour = 0;
+static int32_t battery_test_interval_hour = 0;
+
 const uint8_t* stid_start[6] = {
 		(const uint8_t*)SPID_THERAPY_SESSION_1_START,
 		(const uint8_t*)SPID_THERAPY_SESSION_2_START,
@@ -59,9 +62,7 @@ uint16_t app_func_sm_current_state_get(void) {
  *
  */
 void app_func_sm_impedance_timer_enable(void) {
-	_Float64 impedance_test_interval = 0.0;
-	app_func_para_data_get((const uint8_t*)HPID_IMPEDANCE_TEST_INTERVAL, (uint8_t*)&impedance_test_interval, (uint8_t)sizeof(impedance_test_interval));
-	impedance_test_hour_timer = (int32_t)impedance_test_interval;
+	impedance_test_hour_timer = impedance_test_interval_hour;
 }
 
 /**
@@ -69,9 +70,26 @@ void app_func_sm_impedance_timer_enable(void) {
  *
  */
 void app_func_sm_battery_timer_enable(void) {
-	_Float64 batterry_test_interval = 0.0;
-	app_func_para_data_get((const uint8_t*)HPID_IMPEDANCE_TEST_INTERVAL, (uint8_t*)&batterry_test_interval, (uint8_t)sizeof(batterry_test_interval));
-	battery_test_hour_timer = (int32_t)batterry_test_interval;
+	battery_test_hour_timer = battery_test_interval_hour;
+}
+
+/**
+ * @brief Callback when a parameter used by the state machine changes
+ *
+ * @param p_id Parameter ID
+ */
+static void app_func_sm_para_change_cb(const uint8_t* p_id) {
+	_Float64 interval = 0.0;
+	app_func_para_data_get(p_id, (uint8_t*)&interval, (uint8_t)sizeof(interval));
+	if (memcmp(p_id, (uint8_t*)HPID_IMPEDANCE_TEST_INTERVAL, LEN_ID) == 0) {
+		impedance_test_interval_hour = (int32_t)interval;
+	}
+	else if (memcmp(p_id, (uint8_t*)HPID_BATTERY_TEST_INTERVAL, LEN_ID) == 0) {
+		battery_test_interval_hour = (int32_t)interval;
+	}
+	else {
+		//Not used by the state machine
+	}
 }
 
 /**
@@ -79,6 +97,9 @@ void app_func_sm_battery_timer_enable(void) {
  *
  */
 void app_func_sm_init(void) {
+	(void)app_func_para_subscribe((const uint8_t*)HPID_IMPEDANCE_TEST_INTERVAL, &app_func_sm_para_change_cb);
+	(void)app_func_para_subscribe((const uint8_t*)HPID_BATTERY_TEST_INTERVAL, &app_func_sm_para_change_cb);
+
 	bsp_fram_read(ADDR_SYS_CONFIG, (uint8_t*)&sc, sizeof(sc));
 	if (sc.DefaultState == STATE_INVALID || sc.StartState == STATE_INVALID) {
 		sc.DefaultState = DEFAULT_STATE;
@@ -6,6 +6,7 @@
 #ifndef INC_APP_MODE_BATTERY_TEST_H_
 #define INC_APP_MODE_BATTERY_TEST_H_
 #include <stdint.h>
+#include <stdbool.h>
 
 #define COUNT_MAX_EOS	3U		/*!< Consecutive readings below EOS threshold required to confirm EOS */
 
@@ -17,6 +18,31 @@
  */
 void app_mode_battery_test_volt_get(uint16_t* p_vbatA, uint16_t* p_vbatB);
 
+/**
+ * @brief Measure, obtain and record battery voltages one step at a time, so the measurement can run from the main loop
+ *
+ * @param p_vbatA The battery voltage of battery 1, unit: mV, valid when the measurement is finished
+ * @param p_vbatB The battery voltage of battery 2, unit: mV, valid when the measurement is finished
+ * @param p_progress The progress of the measurement, unit: %
+ * @return true The measurement is finished
+ * @return false The measurement needs more steps
+ */
+bool app_mode_battery_test_volt_step(uint16_t* p_vbatA, uint16_t* p_vbatB, uint8_t* p_progress);
+
+/**
+ * @brief Abort the battery voltage measurement run by steps
+ *
+ */
+void app_mode_battery_test_volt_abort(void);
+
+/**
+ * @brief Check whether the battery has reached the elective replacement level
+ *
+ * @return true The "ER" event has been triggered by the battery tests
+ * @return false The battery is above the elective replacement level
+ */
+bool app_mode_battery_test_er_get(void);
+
 /**
  * @brief Handler for battery test mode
  *
@@ -8,14 +8,48 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#define	MSD_LAYOUT_VERSION			1U		/*!< The version of the status layout in the MSD, 0 for firmware without it */
+
+#define	MSD_IDX_GPIO				8U		/*!< MSD index of the GPIO and WPT flags, 2 bytes */
+#define	MSD_IDX_BLE_ID				10U		/*!< MSD index of the BLE ID, 4 bytes */
+#define	MSD_IDX_LAYOUT_VERSION		14U		/*!< MSD index of the layout version */
+#define	MSD_IDX_THERAPY				15U		/*!< MSD index of the therapy state, MSD_THERAPY_xxx */
+#define	MSD_IDX_BATT_A				16U		/*!< MSD index of battery A, 10 mV / LSB above MSD_BATT_BASE_MV */
+#define	MSD_IDX_BATT_B				17U		/*!< MSD index of battery B, 10 mV / LSB above MSD_BATT_BASE_MV */
+#define	MSD_IDX_IMPED				18U		/*!< MSD index of the last impedance, ohm, 2 bytes little-endian */
+#define	MSD_IDX_TEMP				20U		/*!< MSD index of the temperature, 0.25 degC / LSB above MSD_TEMP_BASE_C */
+#define	MSD_IDX_FAULTS				21U		/*!< MSD index of the fault flags, MSD_FAULT_xxx */
+#define	MSD_IDX_CHANGE_COUNT		22U		/*!< MSD index of the counter incremented every time the MSD changes */
+#define	MSD_IDX_HW_VERSION			23U		/*!< MSD index of the hardware version */
+
+#define	MSD_BATT_BASE_MV			2000U	/*!< Battery voltage of the value 0 */
+#define	MSD_TEMP_BASE_C				20.0f	/*!< Temperature of the value 0 */
+#define	MSD_TEMP_INVALID			0xFFU	/*!< Temperature value when the thermistor is unpowered */
+
+#define	MSD_THERAPY_MODE_MASK		0x0FU	/*!< The low nibble of the current state, e.g. 0x3 therapy session, 0x9 WPT charging */
+#define	MSD_THERAPY_ACTIVE			0x10U	/*!< The therapy session is running */
+#define	MSD_THERAPY_SCHEDULED		0x20U	/*!< The scheduled therapy is enabled */
+#define	MSD_THERAPY_VNSB			0x40U	/*!< The VNS blocking sine wave is enabled */
+
+#define	MSD_FAULT_SHORT_CIRCUIT		0x01U	/*!< The last impedance test found a short circuit */
+#define	MSD_FAULT_HIGH_IMPED		0x02U	/*!< The last impedance test found a high impedance */
+#define	MSD_FAULT_BATT_ER			0x04U	/*!< The battery has reached the elective replacement level */
+#define	MSD_FAULT_CHG1_OVP			0x08U	/*!< Charger 1 over-voltage error */
+#define	MSD_FAULT_CHG2_OVP			0x10U	/*!< Charger 2 over-voltage error */
+#define	MSD_FAULT_VRECT_OVP			0x20U	/*!< Wireless rectifier over-voltage */
+#define	MSD_FAULT_OVER_TEMP			0x40U	/*!< The temperature is above the WPT pause threshold */
+#define	MSD_FAULT_WPT_PAUSED		0x80U	/*!< WPT charging is paused */
+
 /**
  * @brief Update the Manufacturer Specific Data (MSD) field of a BLE advertising packet.
+ * The BLE ID at MSD_IDX_BLE_ID and the hardware version at MSD_IDX_HW_VERSION are left to the caller.
  *
  * @param p_msd Pointer to the msd field of BLE advertising settings structure
  *
- * @return uint8_t 	The number of used bytes in the MSD buffer
+ * @return true 	The MSD changed, the change counter has been incremented
+ * @return false 	The MSD is the same as before
  */
-uint8_t app_mode_ble_act_adv_msd_update(uint8_t* p_msd);
+bool app_mode_ble_act_adv_msd_update(uint8_t* p_msd);
 
 /**
  * @brief Get the current user class
@@ -6,6 +6,12 @@
 #ifndef INC_APP_MODE_BLE_CONNECTION_H_
 #define INC_APP_MODE_BLE_CONNECTION_H_
 
+/**
+ * @brief Initialization of BLE connection mode
+ *
+ */
+void app_mode_ble_conn_init(void);
+
 /**
  * @brief Handler for BLE connection mode
  *
@@ -6,6 +6,13 @@
 #ifndef APP_MODE_IMPEDANCE_TEST_H_
 #define APP_MODE_IMPEDANCE_TEST_H_
 #include <stdint.h>
+#include <stdbool.h>
+
+#define	IMP_ELECTRODE_NUM		5U												/*!< The number of electrodes that can be selected for impedance measurement */
+#define	IMP_SURVEY_PAIR_NUM		((IMP_ELECTRODE_NUM * (IMP_ELECTRODE_NUM - 1U)) / 2U)	/*!< The number of electrode pairs measured by the impedance survey */
+
+#define	IMP_FAULT_SHORT_CIRCUIT	0x01U	/*!< The last impedance was below the minimum safe impedance */
+#define	IMP_FAULT_HIGH_IMPED	0x02U	/*!< The last impedance lowered the maximum safe amplitude */
 
 /**
  * @brief Measure, obtain and record impedance
@@ -14,6 +21,41 @@
  */
 _Float64 app_mode_impedance_test_get(void);
 
+/**
+ * @brief Measure the impedance of every electrode pair one step at a time, the first step powers up and each next step measures one pair
+ *
+ * @param p_imp_matrix The impedance of each pair, unit: ohm, saturated at UINT16_MAX, kept between the steps.
+ * 			The pairs are ordered (1,2),(1,3),...,(1,5),(2,3),...,(4,5), IMP_SURVEY_PAIR_NUM entries in total.
+ * @param p_pair_num The number of pairs measured, valid when the survey is finished
+ * @param p_progress The progress of the survey, unit: %
+ * @return true The survey is finished and recorded as a single log
+ * @return false The survey needs more steps
+ */
+bool app_mode_impedance_test_survey_step(uint16_t* p_imp_matrix, uint8_t* p_pair_num, uint8_t* p_progress);
+
+/**
+ * @brief Abort the impedance survey run by steps, the stimulus and the impedance monitor are turned off
+ *
+ */
+void app_mode_impedance_test_survey_abort(void);
+
+/**
+ * @brief Measure the impedance of every electrode pair in one pass and record it as a single log
+ *
+ * @param p_imp_matrix The impedance of each pair, unit: ohm, saturated at UINT16_MAX.
+ * 			The pairs are ordered (1,2),(1,3),...,(1,5),(2,3),...,(4,5), IMP_SURVEY_PAIR_NUM entries in total.
+ * @return uint8_t The number of pairs measured
+ */
+uint8_t app_mode_impedance_test_survey(uint16_t* p_imp_matrix);
+
+/**
+ * @brief Get the result of the last impedance test since reset
+ *
+ * @param p_imp_ohm The impedance of the last test, unit: ohm, saturated at UINT16_MAX. 0 if not measured yet.
+ * @return uint8_t The faults found by the last impedance test, IMP_FAULT_xxx
+ */
+uint8_t app_mode_impedance_test_last_get(uint16_t* p_imp_ohm);
+
 /**
  * @brief Handler for impedance test mode
  * 
@@ -29,6 +29,12 @@ void app_mode_therapy_stop(void);
  */
 bool app_mode_therapy_confirm(void);
 
+/**
+ * @brief Initialization of therapy session mode
+ *
+ */
+void app_mode_therapy_init(void);
+
 /**
  * @brief Handler for therapy session mode
  *
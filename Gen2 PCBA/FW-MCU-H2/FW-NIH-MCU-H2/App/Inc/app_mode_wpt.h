@@ -15,6 +15,16 @@
 #define WPT_OVP_PAUSE_HOLD_MS            5000U    /*!< ms to hold in PAUSED after an OVP event before allowing resume */
 #define WPT_THERM_SENSE_RESISTOR_OHM     49900.0f /*!< 49.9kΩ series sense resistor (104AP-2) */
 
+/**
+ * @brief Calculate thermistor temperature using the 104AP-2 NTC curve.
+ *
+ * @param therm_ref_mv   THERM_REF ADC reading, mV
+ * @param therm_out_mv   THERM_OUT ADC reading, mV
+ * @param therm_ofst_mv  THERM_OFST ADC reading, mV
+ * @return float         Calculated temperature in °C, 0 if the thermistor is unpowered
+ */
+float app_mode_wpt_calc_temperature(uint16_t therm_ref_mv, uint16_t therm_out_mv, uint16_t therm_ofst_mv);
+
 /**
  * @brief Handler for WPT charging mode
  *
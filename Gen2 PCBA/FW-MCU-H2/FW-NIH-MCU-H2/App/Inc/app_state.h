@@ -8,6 +8,12 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/**
+ * @brief Initialization of the states
+ *
+ */
+void app_state_init(void);
+
 /**
  * @brief Handler for shutdown state
  *
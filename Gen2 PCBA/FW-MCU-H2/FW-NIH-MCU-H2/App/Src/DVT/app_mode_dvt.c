@@ -135,1449 +135,876 @@ static uint8_t* copyPayloadToStructField(uint8_t* p_payload, uint8_t* p_field, u
 	return (p_payload + field_size);
 }
 
-static Cmd_Resp_t app_mode_dvt_command_req_parser(Cmd_Req_t req) {
-	Cmd_Resp_t resp = {
-			.Opcode 		= req.Opcode,
-			.Status 		= STATUS_SUCCESS,
-			.Payload 		= NULL,
-			.PayloadLen 	= 0,
-	};
-	uint8_t len_payload;
+static void app_mode_dvt_cmd_set_start_state(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint16_t state = STATE_INVALID;
+	(void)memcpy((void*)&state, (void*)p_req->Payload, sizeof(uint16_t));
+	switch(state) {
+	case STATE_SLEEP:
+	case STATE_ACT:
+	case STATE_ACT_MODE_BLE_ACT:
+	case STATE_ACT_MODE_THERAPY_SESSION:
+	case STATE_ACT_MODE_IMPED_TEST:
+	case STATE_ACT_MODE_BATT_TEST:
+	case STATE_ACT_MODE_DVT:
+	{
+		Sys_Config_t sc = {
+				.DefaultState = DEFAULT_STATE,
+				.StartState = state,
+		};
+		bsp_fram_write(ADDR_SYS_CONFIG, (uint8_t*)&sc, sizeof(sc), true);
+		sw_reset = true;
+	}	break;
 
-	switch(req.Opcode) {
-	case OP_SET_START_STATE:
+	default:
 	{
-		len_payload = 2;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			uint16_t state = STATE_INVALID;
-			(void)memcpy((void*)&state, (void*)req.Payload, sizeof(uint16_t));
-			switch(state) {
-			case STATE_SLEEP:
-			case STATE_ACT:
-			case STATE_ACT_MODE_BLE_ACT:
-			case STATE_ACT_MODE_THERAPY_SESSION:
-			case STATE_ACT_MODE_IMPED_TEST:
-			case STATE_ACT_MODE_BATT_TEST:
-			case STATE_ACT_MODE_DVT:
-			{
-				Sys_Config_t sc = {
-						.DefaultState = DEFAULT_STATE,
-						.StartState = state,
-				};
-				bsp_fram_write(ADDR_SYS_CONFIG, (uint8_t*)&sc, sizeof(sc), true);
-				sw_reset = true;
-			}	break;
-
-			default:
-			{
-				resp.Status = STATUS_INVALID;
-			}
-				break;
-			}
-		}
+		p_resp->Status = STATUS_INVALID;
 	}
 		break;
-
-	case OP_PING:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			//TBD
-		}
 	}
-		break;
+}
 
-	case OP_GET_TEST_INFORMATION:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			uint8_t resp_payload[sizeof(TestInformation)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&TestInformation.hvSupplyEnable, sizeof(TestInformation.hvSupplyEnable));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&TestInformation.vddsSupplyEnable, sizeof(TestInformation.vddsSupplyEnable));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&TestInformation.vddaSupplyEnable, sizeof(TestInformation.vddaSupplyEnable));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)TestInformation.reserved, sizeof(TestInformation.reserved));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_ping(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	//TBD
+}
 
-	case OP_SET_SAMPLE_ID:
-	{
-		len_payload = 2;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			SampleId_t sampleid;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&sampleid.id, sizeof(sampleid.id));
+static void app_mode_dvt_cmd_get_test_information(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&TestInformation.hvSupplyEnable, sizeof(TestInformation.hvSupplyEnable));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&TestInformation.vddsSupplyEnable, sizeof(TestInformation.vddsSupplyEnable));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&TestInformation.vddaSupplyEnable, sizeof(TestInformation.vddaSupplyEnable));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)TestInformation.reserved, sizeof(TestInformation.reserved));
 
-			app_func_para_data_set((const uint8_t*)TPID_SAMPLE_ID, (uint8_t*)&sampleid.id);
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_GET_SAMPLE_ID:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			SampleId_t sampleid;
-			app_func_para_data_get((const uint8_t*)TPID_SAMPLE_ID, (uint8_t*)&sampleid.id, (uint8_t)sizeof(sampleid.id));
-			uint8_t resp_payload[sizeof(sampleid)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&sampleid.id, sizeof(sampleid.id));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_set_sample_id(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	SampleId_t sampleid;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&sampleid.id, sizeof(sampleid.id));
 
-	case OP_SET_DVT_MODE:
-	{
-		len_payload = 1;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			//TBD
-		}
-	}
-		break;
+	app_func_para_data_set((const uint8_t*)TPID_SAMPLE_ID, (uint8_t*)&sampleid.id);
+}
 
-	case OP_TURN_ON_HV_SUPPLY:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			hvSupplyTurnOn = 1;
-			app_func_stim_hv_supply_set(hvSupplyTurnOn, TestInformation.hvSupplyEnable);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_sample_id(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	SampleId_t sampleid;
+	app_func_para_data_get((const uint8_t*)TPID_SAMPLE_ID, (uint8_t*)&sampleid.id, (uint8_t)sizeof(sampleid.id));
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&sampleid.id, sizeof(sampleid.id));
 
-	case OP_SET_HV_SUPPLY_VOLTAGE_VALUE:
-	{
-		len_payload = 2;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			HvSupplyVoltageValue_t hvsupplyvoltagevalue;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&hvsupplyvoltagevalue.voltage_mv, sizeof(hvsupplyvoltagevalue.voltage_mv));
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-			if (app_func_stim_hv_sup_volt_set(hvsupplyvoltagevalue.voltage_mv) != HAL_OK)
-				resp.Status = STATUS_INVALID;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_set_dvt_mode(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	//TBD
+}
 
-	case OP_ENABLE_HV_SUPPLY:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			TestInformation.hvSupplyEnable = 1;
-			app_func_stim_hv_supply_set(hvSupplyTurnOn, TestInformation.hvSupplyEnable);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_turn_on_hv_supply(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	hvSupplyTurnOn = 1;
+	app_func_stim_hv_supply_set(hvSupplyTurnOn, TestInformation.hvSupplyEnable);
+}
 
-	case OP_IPG_SHUTDOWN:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			shutdown = true;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_set_hv_supply_voltage_value(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	HvSupplyVoltageValue_t hvsupplyvoltagevalue;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&hvsupplyvoltagevalue.voltage_mv, sizeof(hvsupplyvoltagevalue.voltage_mv));
 
-	case OP_ENABLE_VDDS_SUPPLY:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			TestInformation.vddsSupplyEnable = 1;
-			app_func_stim_vdds_sup_enable(TestInformation.vddsSupplyEnable);
-		}
-	}
-		break;
+	if (app_func_stim_hv_sup_volt_set(hvsupplyvoltagevalue.voltage_mv) != HAL_OK)
+		p_resp->Status = STATUS_INVALID;
+}
 
-	case OP_ENABLE_VDDA_SUPPLY:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			TestInformation.vddaSupplyEnable = 1;
-			app_func_meas_vdda_sup_enable(TestInformation.vddaSupplyEnable);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_enable_hv_supply(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	TestInformation.hvSupplyEnable = 1;
+	app_func_stim_hv_supply_set(hvSupplyTurnOn, TestInformation.hvSupplyEnable);
+}
 
-	case OP_ENABLE_BATTERY_MONITOR:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_meas_batt_mon_enable(true);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_ipg_shutdown(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	shutdown = true;
+}
 
-	case OP_GET_BATTERY_VOLTAGE_MEASUREMENT:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			BatteryVoltageMeasurement_t batteryvoltagemeasurement;
-			app_func_meas_batt_mon_meas(&batteryvoltagemeasurement.batteryAvoltage_mv, &batteryvoltagemeasurement.batteryBvoltage_mv);
-			app_func_meas_batt_mon_enable(false);
+static void app_mode_dvt_cmd_enable_vdds_supply(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	TestInformation.vddsSupplyEnable = 1;
+	app_func_stim_vdds_sup_enable(TestInformation.vddsSupplyEnable);
+}
 
-			uint8_t resp_payload[sizeof(batteryvoltagemeasurement)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&batteryvoltagemeasurement.batteryAvoltage_mv, sizeof(batteryvoltagemeasurement.batteryAvoltage_mv));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&batteryvoltagemeasurement.batteryBvoltage_mv, sizeof(batteryvoltagemeasurement.batteryBvoltage_mv));
+static void app_mode_dvt_cmd_enable_vdda_supply(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	TestInformation.vddaSupplyEnable = 1;
+	app_func_meas_vdda_sup_enable(TestInformation.vddaSupplyEnable);
+}
 
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_enable_battery_monitor(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_batt_mon_enable(true);
+}
 
-	case OP_SET_STIMULUS_CIRCUIT_PARAMETERS:
-	{
-		len_payload = 13;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			StimulusCircuitParameters_t stimuluscircuitparameters;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.pulseWidth1_us, sizeof(stimuluscircuitparameters.pulseWidth1_us));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.stimDuration1_ms, sizeof(stimuluscircuitparameters.stimDuration1_ms));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.pulsePeriod1_us, sizeof(stimuluscircuitparameters.pulsePeriod1_us));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.pulseWidth2_us, sizeof(stimuluscircuitparameters.pulseWidth2_us));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.stimDuration2_ms, sizeof(stimuluscircuitparameters.stimDuration2_ms));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.pulsePeriod2_us, sizeof(stimuluscircuitparameters.pulsePeriod2_us));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.stimFreqVNS_hz, sizeof(stimuluscircuitparameters.stimFreqVNS_hz));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.stimDurationVNS_ms, sizeof(stimuluscircuitparameters.stimDurationVNS_ms));
-
-			memcpy(&StimulusCircuitParameters, &stimuluscircuitparameters, sizeof(StimulusCircuitParameters_t));
-			Stimulus_Waveform_t para1 = {
-					.pulseWidth_us 			= StimulusCircuitParameters.pulseWidth1_us,
-					.pulsePeriod_us 		= StimulusCircuitParameters.pulsePeriod1_us,
-					.trainOnDuration_ms 	= StimulusCircuitParameters.stimDuration1_ms,
-					.trainOffDuration_ms 	= StimulusCircuitParameters.stimDuration1_ms,
-			};
-			Stimulus_Waveform_t para2 = {
-					.pulseWidth_us 			= StimulusCircuitParameters.pulseWidth2_us,
-					.pulsePeriod_us 		= StimulusCircuitParameters.pulsePeriod2_us,
-					.trainOnDuration_ms 	= StimulusCircuitParameters.stimDuration2_ms,
-					.trainOffDuration_ms 	= StimulusCircuitParameters.stimDuration2_ms,
-			};
-			NerveBlock_Waveform_t sine_para = {
-					.sinePeriod_us			= (uint32_t)(1000000.0 / (_Float64)StimulusCircuitParameters.stimFreqVNS_hz),
-					.sinePhaseShift_us		= 0,
-					.amplitude_mV 			= DacAbOutputVoltage.bDacOutputVoltage_mv,
-					.trainOnDuration_ms 	= StimulusCircuitParameters.stimDurationVNS_ms,
-					.trainOffDuration_ms 	= StimulusCircuitParameters.stimDurationVNS_ms,
-			};
-			app_func_stim_circuit_para1_set(para1);
-			app_func_stim_circuit_para2_set(para2);
-			app_func_stim_sine_para_set(sine_para);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_battery_voltage_measurement(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	BatteryVoltageMeasurement_t batteryvoltagemeasurement;
+	app_func_meas_batt_mon_meas(&batteryvoltagemeasurement.batteryAvoltage_mv, &batteryvoltagemeasurement.batteryBvoltage_mv);
+	app_func_meas_batt_mon_enable(false);
 
-	case OP_GET_STIMULUS_CIRCUIT_PARAMETERS:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			uint8_t resp_payload[sizeof(StimulusCircuitParameters)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.pulseWidth1_us, sizeof(StimulusCircuitParameters.pulseWidth1_us));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.stimDuration1_ms, sizeof(StimulusCircuitParameters.stimDuration1_ms));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.pulsePeriod1_us, sizeof(StimulusCircuitParameters.pulsePeriod1_us));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.pulseWidth2_us, sizeof(StimulusCircuitParameters.pulseWidth2_us));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.stimDuration2_ms, sizeof(StimulusCircuitParameters.stimDuration2_ms));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.pulsePeriod2_us, sizeof(StimulusCircuitParameters.pulsePeriod2_us));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.stimFreqVNS_hz, sizeof(StimulusCircuitParameters.stimFreqVNS_hz));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.stimDurationVNS_ms, sizeof(StimulusCircuitParameters.stimDurationVNS_ms));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&batteryvoltagemeasurement.batteryAvoltage_mv, sizeof(batteryvoltagemeasurement.batteryAvoltage_mv));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&batteryvoltagemeasurement.batteryBvoltage_mv, sizeof(batteryvoltagemeasurement.batteryBvoltage_mv));
 
-	case OP_SET_DAC_AB_OUTPUT_VOLTAGE:
-	{
-		len_payload = 4;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			DacAbOutputVoltage_t dacaboutputvoltage;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&dacaboutputvoltage.aDacOutputVoltage_mv, sizeof(dacaboutputvoltage.aDacOutputVoltage_mv));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&dacaboutputvoltage.bDacOutputVoltage_mv, sizeof(dacaboutputvoltage.bDacOutputVoltage_mv));
-
-			memcpy(&DacAbOutputVoltage, &dacaboutputvoltage, sizeof(DacAbOutputVoltage_t));
-			if (app_func_stim_dac_init() != HAL_OK) {
-				resp.Status = STATUS_INVALID;
-			}
-			if (app_func_stim_dac_volt_set(DacAbOutputVoltage.aDacOutputVoltage_mv, DacAbOutputVoltage.bDacOutputVoltage_mv) != HAL_OK) {
-				resp.Status = STATUS_INVALID;
-			}
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_ENABLE_VNS_STIMULATION:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_stim_vnsb_enable(true);
-			mocked.vnsb_en = true;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_set_stimulus_circuit_parameters(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	StimulusCircuitParameters_t stimuluscircuitparameters;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.pulseWidth1_us, sizeof(stimuluscircuitparameters.pulseWidth1_us));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.stimDuration1_ms, sizeof(stimuluscircuitparameters.stimDuration1_ms));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.pulsePeriod1_us, sizeof(stimuluscircuitparameters.pulsePeriod1_us));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.pulseWidth2_us, sizeof(stimuluscircuitparameters.pulseWidth2_us));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.stimDuration2_ms, sizeof(stimuluscircuitparameters.stimDuration2_ms));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.pulsePeriod2_us, sizeof(stimuluscircuitparameters.pulsePeriod2_us));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.stimFreqVNS_hz, sizeof(stimuluscircuitparameters.stimFreqVNS_hz));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimuluscircuitparameters.stimDurationVNS_ms, sizeof(stimuluscircuitparameters.stimDurationVNS_ms));
+
+	memcpy(&StimulusCircuitParameters, &stimuluscircuitparameters, sizeof(StimulusCircuitParameters_t));
+	Stimulus_Waveform_t para1 = {
+			.pulseWidth_us 			= StimulusCircuitParameters.pulseWidth1_us,
+			.pulsePeriod_us 		= StimulusCircuitParameters.pulsePeriod1_us,
+			.trainOnDuration_ms 	= StimulusCircuitParameters.stimDuration1_ms,
+			.trainOffDuration_ms 	= StimulusCircuitParameters.stimDuration1_ms,
+	};
+	Stimulus_Waveform_t para2 = {
+			.pulseWidth_us 			= StimulusCircuitParameters.pulseWidth2_us,
+			.pulsePeriod_us 		= StimulusCircuitParameters.pulsePeriod2_us,
+			.trainOnDuration_ms 	= StimulusCircuitParameters.stimDuration2_ms,
+			.trainOffDuration_ms 	= StimulusCircuitParameters.stimDuration2_ms,
+	};
+	NerveBlock_Waveform_t sine_para = {
+			.sinePeriod_us			= (uint32_t)(1000000.0 / (_Float64)StimulusCircuitParameters.stimFreqVNS_hz),
+			.sinePhaseShift_us		= 0,
+			.amplitude_mV 			= DacAbOutputVoltage.bDacOutputVoltage_mv,
+			.trainOnDuration_ms 	= StimulusCircuitParameters.stimDurationVNS_ms,
+			.trainOffDuration_ms 	= StimulusCircuitParameters.stimDurationVNS_ms,
+	};
+	app_func_stim_circuit_para1_set(para1);
+	app_func_stim_circuit_para2_set(para2);
+	app_func_stim_sine_para_set(sine_para);
+}
 
-	case OP_DISABLE_VNS_STIMULATION:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_stim_vnsb_enable(false);
-			mocked.vnsb_en = false;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_stimulus_circuit_parameters(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.pulseWidth1_us, sizeof(StimulusCircuitParameters.pulseWidth1_us));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.stimDuration1_ms, sizeof(StimulusCircuitParameters.stimDuration1_ms));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.pulsePeriod1_us, sizeof(StimulusCircuitParameters.pulsePeriod1_us));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.pulseWidth2_us, sizeof(StimulusCircuitParameters.pulseWidth2_us));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.stimDuration2_ms, sizeof(StimulusCircuitParameters.stimDuration2_ms));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.pulsePeriod2_us, sizeof(StimulusCircuitParameters.pulsePeriod2_us));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.stimFreqVNS_hz, sizeof(StimulusCircuitParameters.stimFreqVNS_hz));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimulusCircuitParameters.stimDurationVNS_ms, sizeof(StimulusCircuitParameters.stimDurationVNS_ms));
+
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_ENABLE_STIMULUS_CIRCUIT:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_stim_stimulus_enable(true);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_set_dac_ab_output_voltage(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	DacAbOutputVoltage_t dacaboutputvoltage;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&dacaboutputvoltage.aDacOutputVoltage_mv, sizeof(dacaboutputvoltage.aDacOutputVoltage_mv));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&dacaboutputvoltage.bDacOutputVoltage_mv, sizeof(dacaboutputvoltage.bDacOutputVoltage_mv));
 
-	case OP_SET_CURRENT_SOURCES_CONFIGURATION:
-	{
-		len_payload = 7;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			CurrentSourcesConfiguration_t currentsourcesconfiguration;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&currentsourcesconfiguration.src1, sizeof(currentsourcesconfiguration.src1));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&currentsourcesconfiguration.src2, sizeof(currentsourcesconfiguration.src2));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&currentsourcesconfiguration.snk1, sizeof(currentsourcesconfiguration.snk1));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&currentsourcesconfiguration.snk2, sizeof(currentsourcesconfiguration.snk2));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&currentsourcesconfiguration.snk3, sizeof(currentsourcesconfiguration.snk3));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&currentsourcesconfiguration.snk4, sizeof(currentsourcesconfiguration.snk4));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&currentsourcesconfiguration.snk5, sizeof(currentsourcesconfiguration.snk5));
-
-			memcpy(&CurrentSourcesConfiguration, &currentsourcesconfiguration, sizeof(CurrentSourcesConfiguration_t));
-			Current_Sources_t config = {
-					.src1 	= CurrentSourcesConfiguration.src1,
-					.src2 	= CurrentSourcesConfiguration.src2,
-					.snk1 	= CurrentSourcesConfiguration.snk1,
-					.snk2 	= CurrentSourcesConfiguration.snk2,
-					.snk3 	= CurrentSourcesConfiguration.snk3,
-					.snk4 	= CurrentSourcesConfiguration.snk4,
-					.snk5 	= CurrentSourcesConfiguration.snk5,
-			};
-			app_func_stim_curr_src_set(config);
-			mocked.src1 = CurrentSourcesConfiguration.src1;
-			mocked.src2 = CurrentSourcesConfiguration.src2;
-		}
+	memcpy(&DacAbOutputVoltage, &dacaboutputvoltage, sizeof(DacAbOutputVoltage_t));
+	if (app_func_stim_dac_init() != HAL_OK) {
+		p_resp->Status = STATUS_INVALID;
 	}
-		break;
-
-	case OP_GET_CURRENT_SOURCES_CONFIGURATION:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			uint8_t resp_payload[sizeof(CurrentSourcesConfiguration)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&CurrentSourcesConfiguration.src1, sizeof(CurrentSourcesConfiguration.src1));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&CurrentSourcesConfiguration.src2, sizeof(CurrentSourcesConfiguration.src2));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&CurrentSourcesConfiguration.snk1, sizeof(CurrentSourcesConfiguration.snk1));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&CurrentSourcesConfiguration.snk2, sizeof(CurrentSourcesConfiguration.snk2));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&CurrentSourcesConfiguration.snk3, sizeof(CurrentSourcesConfiguration.snk3));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&CurrentSourcesConfiguration.snk4, sizeof(CurrentSourcesConfiguration.snk4));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&CurrentSourcesConfiguration.snk5, sizeof(CurrentSourcesConfiguration.snk5));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
+	if (app_func_stim_dac_volt_set(DacAbOutputVoltage.aDacOutputVoltage_mv, DacAbOutputVoltage.bDacOutputVoltage_mv) != HAL_OK) {
+		p_resp->Status = STATUS_INVALID;
 	}
-		break;
+}
 
-	case OP_GENERATE_MOCKED_STIMULUS:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			if (mocked.src1) {
-				app_func_stim_stim1_start(mocked.imp_en);
-			}
-			if (mocked.src2) {
-				if (mocked.vnsb_en) {
-					app_func_stim_sine_start();
-				}
-				else {
-					app_func_stim_stim2_start();
-				}
-			}
-			app_func_stim_sync();
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_enable_vns_stimulation(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_stim_vnsb_enable(true);
+	mocked.vnsb_en = true;
+}
 
-	case OP_ENABLE_CHANNEL_MUX:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_stim_mux_enable(true);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_disable_vns_stimulation(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_stim_vnsb_enable(false);
+	mocked.vnsb_en = false;
+}
 
-	case OP_SET_STIM_SEL_POSITIONS:
-	{
-		len_payload = 7;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			StimSelPositions_t stimselpositions;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimselpositions.stima_sel, sizeof(stimselpositions.stima_sel));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimselpositions.stimb_sel, sizeof(stimselpositions.stimb_sel));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimselpositions.stim_sel_encl, sizeof(stimselpositions.stim_sel_encl));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimselpositions.stim_sel_ch1, sizeof(stimselpositions.stim_sel_ch1));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimselpositions.stim_sel_ch2, sizeof(stimselpositions.stim_sel_ch2));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimselpositions.stim_sel_ch3, sizeof(stimselpositions.stim_sel_ch3));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimselpositions.stim_sel_ch4, sizeof(stimselpositions.stim_sel_ch4));
-
-			memcpy(&StimSelPositions, &stimselpositions, sizeof(StimSelPositions_t));
-			Stim_Sel_t sel = {
-					.stimA 			= StimSelPositions.stima_sel,
-					.stimB 			= StimSelPositions.stimb_sel,
-					.sel_ch.encl 	= StimSelPositions.stim_sel_encl,
-					.sel_ch.ch1 	= StimSelPositions.stim_sel_ch1,
-					.sel_ch.ch2 	= StimSelPositions.stim_sel_ch2,
-					.sel_ch.ch3 	= StimSelPositions.stim_sel_ch3,
-					.sel_ch.ch4 	= StimSelPositions.stim_sel_ch4,
-			};
-			app_func_stim_sel_set(sel);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_enable_stimulus_circuit(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_stim_stimulus_enable(true);
+}
 
-	case OP_GET_STIM_SEL_POSITIONS:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			uint8_t resp_payload[sizeof(StimSelPositions)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimSelPositions.stima_sel, sizeof(StimSelPositions.stima_sel));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimSelPositions.stimb_sel, sizeof(StimSelPositions.stimb_sel));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimSelPositions.stim_sel_encl, sizeof(StimSelPositions.stim_sel_encl));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimSelPositions.stim_sel_ch1, sizeof(StimSelPositions.stim_sel_ch1));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimSelPositions.stim_sel_ch2, sizeof(StimSelPositions.stim_sel_ch2));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimSelPositions.stim_sel_ch3, sizeof(StimSelPositions.stim_sel_ch3));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimSelPositions.stim_sel_ch4, sizeof(StimSelPositions.stim_sel_ch4));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_set_current_sources_configuration(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	CurrentSourcesConfiguration_t currentsourcesconfiguration;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&currentsourcesconfiguration.src1, sizeof(currentsourcesconfiguration.src1));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&currentsourcesconfiguration.src2, sizeof(currentsourcesconfiguration.src2));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&currentsourcesconfiguration.snk1, sizeof(currentsourcesconfiguration.snk1));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&currentsourcesconfiguration.snk2, sizeof(currentsourcesconfiguration.snk2));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&currentsourcesconfiguration.snk3, sizeof(currentsourcesconfiguration.snk3));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&currentsourcesconfiguration.snk4, sizeof(currentsourcesconfiguration.snk4));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&currentsourcesconfiguration.snk5, sizeof(currentsourcesconfiguration.snk5));
+
+	memcpy(&CurrentSourcesConfiguration, &currentsourcesconfiguration, sizeof(CurrentSourcesConfiguration_t));
+	Current_Sources_t config = {
+			.src1 	= CurrentSourcesConfiguration.src1,
+			.src2 	= CurrentSourcesConfiguration.src2,
+			.snk1 	= CurrentSourcesConfiguration.snk1,
+			.snk2 	= CurrentSourcesConfiguration.snk2,
+			.snk3 	= CurrentSourcesConfiguration.snk3,
+			.snk4 	= CurrentSourcesConfiguration.snk4,
+			.snk5 	= CurrentSourcesConfiguration.snk5,
+	};
+	app_func_stim_curr_src_set(config);
+	mocked.src1 = CurrentSourcesConfiguration.src1;
+	mocked.src2 = CurrentSourcesConfiguration.src2;
+}
 
-	case OP_DISABLE_ECG_HR_AFE:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_meas_sensor_enable(SENSOR_ID_ECG_HR, false);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_current_sources_configuration(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&CurrentSourcesConfiguration.src1, sizeof(CurrentSourcesConfiguration.src1));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&CurrentSourcesConfiguration.src2, sizeof(CurrentSourcesConfiguration.src2));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&CurrentSourcesConfiguration.snk1, sizeof(CurrentSourcesConfiguration.snk1));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&CurrentSourcesConfiguration.snk2, sizeof(CurrentSourcesConfiguration.snk2));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&CurrentSourcesConfiguration.snk3, sizeof(CurrentSourcesConfiguration.snk3));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&CurrentSourcesConfiguration.snk4, sizeof(CurrentSourcesConfiguration.snk4));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&CurrentSourcesConfiguration.snk5, sizeof(CurrentSourcesConfiguration.snk5));
+
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_DISABLE_ECG_RR_AFE:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_meas_sensor_enable(SENSOR_ID_ECG_RR, false);
-		}
+static void app_mode_dvt_cmd_generate_mocked_stimulus(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	if (mocked.src1) {
+		app_func_stim_stim1_start(mocked.imp_en);
 	}
-		break;
-
-	case OP_ENABLE_ECG_HR_AFE:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
+	if (mocked.src2) {
+		if (mocked.vnsb_en) {
+			app_func_stim_sine_start();
 		}
 		else {
-			app_func_meas_sensor_enable(SENSOR_ID_ECG_HR, true);
+			app_func_stim_stim2_start();
 		}
 	}
-		break;
+	app_func_stim_sync();
+}
 
-	case OP_ENABLE_ECG_RR_AFE:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_meas_sensor_enable(SENSOR_ID_ECG_RR, true);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_enable_channel_mux(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_stim_mux_enable(true);
+}
 
-	case OP_GET_ECG_HR_LOD:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			EcgHrLod_t ecghrlod = {
-					.ecgHrLod = HAL_GPIO_ReadPin(ECG_HR_LOD_GPIO_Port, ECG_HR_LOD_Pin),
-			};
-			uint8_t resp_payload[sizeof(ecghrlod)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&ecghrlod.ecgHrLod, sizeof(ecghrlod.ecgHrLod));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_set_stim_sel_positions(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	StimSelPositions_t stimselpositions;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimselpositions.stima_sel, sizeof(stimselpositions.stima_sel));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimselpositions.stimb_sel, sizeof(stimselpositions.stimb_sel));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimselpositions.stim_sel_encl, sizeof(stimselpositions.stim_sel_encl));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimselpositions.stim_sel_ch1, sizeof(stimselpositions.stim_sel_ch1));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimselpositions.stim_sel_ch2, sizeof(stimselpositions.stim_sel_ch2));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimselpositions.stim_sel_ch3, sizeof(stimselpositions.stim_sel_ch3));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&stimselpositions.stim_sel_ch4, sizeof(stimselpositions.stim_sel_ch4));
+
+	memcpy(&StimSelPositions, &stimselpositions, sizeof(StimSelPositions_t));
+	Stim_Sel_t sel = {
+			.stimA 			= StimSelPositions.stima_sel,
+			.stimB 			= StimSelPositions.stimb_sel,
+			.sel_ch.encl 	= StimSelPositions.stim_sel_encl,
+			.sel_ch.ch1 	= StimSelPositions.stim_sel_ch1,
+			.sel_ch.ch2 	= StimSelPositions.stim_sel_ch2,
+			.sel_ch.ch3 	= StimSelPositions.stim_sel_ch3,
+			.sel_ch.ch4 	= StimSelPositions.stim_sel_ch4,
+	};
+	app_func_stim_sel_set(sel);
+}
 
-	case OP_GET_ECG_RR_LOD:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			EcgRrLod_t ecgrrlod = {
-					.ecgRrLod = HAL_GPIO_ReadPin(ECG_RR_LOD_GPIO_Port, ECG_RR_LOD_Pin),
-			};
-			uint8_t resp_payload[sizeof(ecgrrlod)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&ecgrrlod.ecgRrLod, sizeof(ecgrrlod.ecgRrLod));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_stim_sel_positions(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimSelPositions.stima_sel, sizeof(StimSelPositions.stima_sel));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimSelPositions.stimb_sel, sizeof(StimSelPositions.stimb_sel));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimSelPositions.stim_sel_encl, sizeof(StimSelPositions.stim_sel_encl));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimSelPositions.stim_sel_ch1, sizeof(StimSelPositions.stim_sel_ch1));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimSelPositions.stim_sel_ch2, sizeof(StimSelPositions.stim_sel_ch2));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimSelPositions.stim_sel_ch3, sizeof(StimSelPositions.stim_sel_ch3));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&StimSelPositions.stim_sel_ch4, sizeof(StimSelPositions.stim_sel_ch4));
+
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_GET_ECG_HR_AFE_OUTPUT:
-	{
-		len_payload = 3;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			EcgHrAfeOutputReq_t ecghrafeoutputreq;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&ecghrafeoutputreq.bufferSize, sizeof(ecghrafeoutputreq.bufferSize));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&ecghrafeoutputreq.samplingFrequency_hz, sizeof(ecghrafeoutputreq.samplingFrequency_hz));
-
-			EcgHrAfeOutputResp_t ecghrafeoutputresp;
-			memset(&ecghrafeoutputresp, 0, sizeof(EcgHrAfeOutputResp_t));
-			ecghrafeoutputresp.bufferSize = ecghrafeoutputreq.bufferSize;
-			app_func_meas_sensor_meas(SENSOR_ID_ECG_HR, ecghrafeoutputresp.buffer, ecghrafeoutputresp.bufferSize, ecghrafeoutputreq.samplingFrequency_hz);
-
-			uint8_t resp_payload[sizeof(ecghrafeoutputresp)];
-			payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&ecghrafeoutputresp.bufferSize, sizeof(ecghrafeoutputresp.bufferSize));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)ecghrafeoutputresp.buffer, sizeof(ecghrafeoutputresp.buffer));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_disable_ecg_hr_afe(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_sensor_enable(SENSOR_ID_ECG_HR, false);
+}
 
-	case OP_GET_ECG_RR_AFE_OUTPUT:
-	{
-		len_payload = 3;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			EcgRrAfeOutputReq_t ecgrrafeoutputreq;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&ecgrrafeoutputreq.bufferSize, sizeof(ecgrrafeoutputreq.bufferSize));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&ecgrrafeoutputreq.samplingFrequency_hz, sizeof(ecgrrafeoutputreq.samplingFrequency_hz));
-
-			EcgRrAfeOutputResp_t ecgrrafeoutputresp;
-			memset(&ecgrrafeoutputresp, 0, sizeof(EcgRrAfeOutputResp_t));
-			ecgrrafeoutputresp.bufferSize = ecgrrafeoutputreq.bufferSize;
-			app_func_meas_sensor_meas(SENSOR_ID_ECG_RR, ecgrrafeoutputresp.buffer, ecgrrafeoutputresp.bufferSize, ecgrrafeoutputreq.samplingFrequency_hz);
-
-			uint8_t resp_payload[sizeof(ecgrrafeoutputresp)];
-			payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&ecgrrafeoutputresp.bufferSize, sizeof(ecgrrafeoutputresp.bufferSize));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)ecgrrafeoutputresp.buffer, sizeof(ecgrrafeoutputresp.buffer));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_disable_ecg_rr_afe(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_sensor_enable(SENSOR_ID_ECG_RR, false);
+}
 
-	case OP_ENABLE_WPT_VRECT_MON_CIRCUIT:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_meas_vrect_enable(true);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_enable_ecg_hr_afe(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_sensor_enable(SENSOR_ID_ECG_HR, true);
+}
 
-	case OP_DISABLE_WPT_VRECT_MON_CIRCUIT:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_meas_vrect_enable(false);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_enable_ecg_rr_afe(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_sensor_enable(SENSOR_ID_ECG_RR, true);
+}
 
-	case OP_GET_WPT_VRECT_MON_CIRCUIT_OUTPUT:
-	{
-		len_payload = 3;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			WptVrectOutputReq_t wptvrectoutputreq;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&wptvrectoutputreq.bufferSize, sizeof(wptvrectoutputreq.bufferSize));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&wptvrectoutputreq.samplingFrequency_hz, sizeof(wptvrectoutputreq.samplingFrequency_hz));
-
-			WptVrectOutputResp_t wptvrectoutputresp;
-			memset(&wptvrectoutputresp, 0, sizeof(WptVrectOutputResp_t));
-			wptvrectoutputresp.bufferSize = wptvrectoutputreq.bufferSize;
-			app_func_meas_vrect_mon_meas(wptvrectoutputresp.buffer, wptvrectoutputresp.bufferSize, wptvrectoutputreq.samplingFrequency_hz);
-
-			uint8_t resp_payload[sizeof(wptvrectoutputresp)];
-			payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&wptvrectoutputresp.bufferSize, sizeof(wptvrectoutputresp.bufferSize));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)wptvrectoutputresp.buffer, sizeof(wptvrectoutputresp.buffer));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_ecg_hr_lod(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	EcgHrLod_t ecghrlod = {
+			.ecgHrLod = HAL_GPIO_ReadPin(ECG_HR_LOD_GPIO_Port, ECG_HR_LOD_Pin),
+	};
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&ecghrlod.ecgHrLod, sizeof(ecghrlod.ecgHrLod));
 
-	case OP_GET_VRECT_DET:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			VrectDet_t vrectdet = {
-					.det = (!HAL_GPIO_ReadPin(VRECT_DETn_GPIO_Port, VRECT_DETn_Pin)),
-			};
-			uint8_t resp_payload[sizeof(vrectdet)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&vrectdet.det, sizeof(vrectdet.det));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_GET_VRECT_OVP:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			VrectOvp_t vrectovp = {
-					.ovp = (!HAL_GPIO_ReadPin(VRECT_OVPn_GPIO_Port, VRECT_OVPn_Pin)),
-			};
-			uint8_t resp_payload[sizeof(vrectovp)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&vrectovp.ovp, sizeof(vrectovp.ovp));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_ecg_rr_lod(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	EcgRrLod_t ecgrrlod = {
+			.ecgRrLod = HAL_GPIO_ReadPin(ECG_RR_LOD_GPIO_Port, ECG_RR_LOD_Pin),
+	};
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&ecgrrlod.ecgRrLod, sizeof(ecgrrlod.ecgRrLod));
 
-	case OP_GET_VCHG_RAIL_SUPPLY_CIRCUIT_POWER_GOOD:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			VchgRailSupplyPowerGood_t vchgrailsupplypowergood = {
-					.pGood = HAL_GPIO_ReadPin(VCHG_PGOOD_GPIO_Port, VCHG_PGOOD_Pin),
-			};
-			uint8_t resp_payload[sizeof(vchgrailsupplypowergood)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&vchgrailsupplypowergood.pGood, sizeof(vchgrailsupplypowergood.pGood));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_ENABLE_CHARGE_CONTROL_1_CIRCUIT:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			HAL_GPIO_WritePin(CHG1_EN_GPIO_Port, CHG1_EN_Pin, true);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_ecg_hr_afe_output(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	EcgHrAfeOutputReq_t ecghrafeoutputreq;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&ecghrafeoutputreq.bufferSize, sizeof(ecghrafeoutputreq.bufferSize));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&ecghrafeoutputreq.samplingFrequency_hz, sizeof(ecghrafeoutputreq.samplingFrequency_hz));
 
-	case OP_DISABLE_CHARGE_CONTROL_1_CIRCUIT:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			HAL_GPIO_WritePin(CHG1_EN_GPIO_Port, CHG1_EN_Pin, false);
-		}
-	}
-		break;
+	EcgHrAfeOutputResp_t ecghrafeoutputresp;
+	memset(&ecghrafeoutputresp, 0, sizeof(EcgHrAfeOutputResp_t));
+	ecghrafeoutputresp.bufferSize = ecghrafeoutputreq.bufferSize;
+	app_func_meas_sensor_meas(SENSOR_ID_ECG_HR, ecghrafeoutputresp.buffer, ecghrafeoutputresp.bufferSize, ecghrafeoutputreq.samplingFrequency_hz);
 
-	case OP_CHARGE_RATE_CONTROL:
-	{
-		len_payload = 2;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			ChargeRateControl_t chargeratecontrol;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&chargeratecontrol.chgRate1, sizeof(chargeratecontrol.chgRate1));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&chargeratecontrol.chgRate2, sizeof(chargeratecontrol.chgRate2));
+	uint8_t* resp_payload = p_resp->Payload;
+	payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&ecghrafeoutputresp.bufferSize, sizeof(ecghrafeoutputresp.bufferSize));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)ecghrafeoutputresp.buffer, sizeof(ecghrafeoutputresp.buffer));
 
-			HAL_GPIO_WritePin(CHG_RATE1_GPIO_Port, CHG_RATE1_Pin, chargeratecontrol.chgRate1);
-			HAL_GPIO_WritePin(CHG_RATE2_GPIO_Port, CHG_RATE2_Pin, chargeratecontrol.chgRate2);
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_GET_CHG1_STATUS:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			Chg1Status_t chg1status = {
-					.status = HAL_GPIO_ReadPin(CHG1_STATUS_GPIO_Port, CHG1_STATUS_Pin),
-			};
-			uint8_t resp_payload[sizeof(chg1status)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&chg1status.status, sizeof(chg1status.status));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_ecg_rr_afe_output(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	EcgRrAfeOutputReq_t ecgrrafeoutputreq;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&ecgrrafeoutputreq.bufferSize, sizeof(ecgrrafeoutputreq.bufferSize));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&ecgrrafeoutputreq.samplingFrequency_hz, sizeof(ecgrrafeoutputreq.samplingFrequency_hz));
 
-	case OP_GET_CHG1_OVP_ERR:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			Chg1OvpErr_t chg1ovperr = {
-					.ovpErr = (!HAL_GPIO_ReadPin(CHG1_OVP_ERRn_GPIO_Port, CHG1_OVP_ERRn_Pin)),
-			};
-			uint8_t resp_payload[sizeof(chg1ovperr)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&chg1ovperr.ovpErr, sizeof(chg1ovperr.ovpErr));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+	EcgRrAfeOutputResp_t ecgrrafeoutputresp;
+	memset(&ecgrrafeoutputresp, 0, sizeof(EcgRrAfeOutputResp_t));
+	ecgrrafeoutputresp.bufferSize = ecgrrafeoutputreq.bufferSize;
+	app_func_meas_sensor_meas(SENSOR_ID_ECG_RR, ecgrrafeoutputresp.buffer, ecgrrafeoutputresp.bufferSize, ecgrrafeoutputreq.samplingFrequency_hz);
 
-	case OP_ENABLE_CHARGE_CONTROL_2_CIRCUIT:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			HAL_GPIO_WritePin(CHG2_EN_GPIO_Port, CHG2_EN_Pin, true);
-		}
-	}
-		break;
+	uint8_t* resp_payload = p_resp->Payload;
+	payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&ecgrrafeoutputresp.bufferSize, sizeof(ecgrrafeoutputresp.bufferSize));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)ecgrrafeoutputresp.buffer, sizeof(ecgrrafeoutputresp.buffer));
 
-	case OP_DISABLE_CHARGE_CONTROL_2_CIRCUIT:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			HAL_GPIO_WritePin(CHG2_EN_GPIO_Port, CHG2_EN_Pin, false);
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_GET_CHG2_STATUS:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			Chg2Status_t chg2status = {
-					.status = HAL_GPIO_ReadPin(CHG2_STATUS_GPIO_Port, CHG2_STATUS_Pin),
-			};
-			uint8_t resp_payload[sizeof(chg2status)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&chg2status.status, sizeof(chg2status.status));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_enable_wpt_vrect_mon_circuit(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_vrect_enable(true);
+}
 
-	case OP_GET_CHG2_OVP_ERR:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			Chg2OvpErr_t chg2ovperr = {
-					.ovpErr = (!HAL_GPIO_ReadPin(CHG2_OVP_ERRn_GPIO_Port, CHG2_OVP_ERRn_Pin)),
-			};
-			uint8_t resp_payload[sizeof(chg2ovperr)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&chg2ovperr.ovpErr, sizeof(chg2ovperr.ovpErr));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_disable_wpt_vrect_mon_circuit(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_vrect_enable(false);
+}
 
-	case OP_ENABLE_THERMISTOR_INTERFACE_CIRCUIT:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_meas_therm_enable(true);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_wpt_vrect_mon_circuit_output(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	WptVrectOutputReq_t wptvrectoutputreq;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&wptvrectoutputreq.bufferSize, sizeof(wptvrectoutputreq.bufferSize));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&wptvrectoutputreq.samplingFrequency_hz, sizeof(wptvrectoutputreq.samplingFrequency_hz));
 
-	case OP_DISABLE_THERMISTOR_INTERFACE_CIRCUIT:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_meas_therm_enable(false);
-		}
-	}
-		break;
+	WptVrectOutputResp_t wptvrectoutputresp;
+	memset(&wptvrectoutputresp, 0, sizeof(WptVrectOutputResp_t));
+	wptvrectoutputresp.bufferSize = wptvrectoutputreq.bufferSize;
+	app_func_meas_vrect_mon_meas(wptvrectoutputresp.buffer, wptvrectoutputresp.bufferSize, wptvrectoutputreq.samplingFrequency_hz);
 
-	case OP_GET_THERM_REF:
-	{
-		len_payload = 3;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			ThermRefReq_t thermrefreq;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&thermrefreq.bufferSize, sizeof(thermrefreq.bufferSize));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&thermrefreq.samplingFrequency_hz, sizeof(thermrefreq.samplingFrequency_hz));
-
-			ThermRefResp_t thermrefresp;
-			memset(&thermrefresp, 0, sizeof(ThermRefResp_t));
-			thermrefresp.bufferSize = thermrefreq.bufferSize;
-			app_func_meas_therm_meas(THERM_ID_REF, thermrefresp.buffer, thermrefresp.bufferSize, thermrefreq.samplingFrequency_hz);
-
-			uint8_t resp_payload[sizeof(thermrefresp)];
-			payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&thermrefresp.bufferSize, sizeof(thermrefresp.bufferSize));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)thermrefresp.buffer, sizeof(thermrefresp.buffer));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+	uint8_t* resp_payload = p_resp->Payload;
+	payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&wptvrectoutputresp.bufferSize, sizeof(wptvrectoutputresp.bufferSize));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)wptvrectoutputresp.buffer, sizeof(wptvrectoutputresp.buffer));
 
-	case OP_GET_THERM_OUT:
-	{
-		len_payload = 3;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			ThermOutReq_t thermoutreq;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&thermoutreq.bufferSize, sizeof(thermoutreq.bufferSize));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&thermoutreq.samplingFrequency_hz, sizeof(thermoutreq.samplingFrequency_hz));
-
-			ThermOutResp_t thermoutresp;
-			memset(&thermoutresp, 0, sizeof(ThermOutResp_t));
-			thermoutresp.bufferSize = thermoutreq.bufferSize;
-			app_func_meas_therm_meas(THERM_ID_OUT, thermoutresp.buffer, thermoutresp.bufferSize, thermoutreq.samplingFrequency_hz);
-
-			uint8_t resp_payload[sizeof(thermoutresp)];
-			payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&thermoutresp.bufferSize, sizeof(thermoutresp.bufferSize));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)thermoutresp.buffer, sizeof(thermoutresp.buffer));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_GET_THERM_OFST:
-	{
-		len_payload = 3;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			ThermOffstReq_t thermofstreq;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&thermofstreq.bufferSize, sizeof(thermofstreq.bufferSize));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&thermofstreq.samplingFrequency_hz, sizeof(thermofstreq.samplingFrequency_hz));
-
-			ThermOffstResp_t thermofstresp;
-			memset(&thermofstresp, 0, sizeof(ThermOffstResp_t));
-			thermofstresp.bufferSize = thermofstreq.bufferSize;
-			app_func_meas_therm_meas(THERM_ID_OFST, thermofstresp.buffer, thermofstresp.bufferSize, thermofstreq.samplingFrequency_hz);
-
-			uint8_t resp_payload[sizeof(thermofstresp)];
-			payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&thermofstresp.bufferSize, sizeof(thermofstresp.bufferSize));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)thermofstresp.buffer, sizeof(thermofstresp.buffer));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_vrect_det(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	VrectDet_t vrectdet = {
+			.det = (!HAL_GPIO_ReadPin(VRECT_DETn_GPIO_Port, VRECT_DETn_Pin)),
+	};
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&vrectdet.det, sizeof(vrectdet.det));
 
-	case OP_DISABLE_ENG1_AFE:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_meas_sensor_enable(SENSOR_ID_ENG1, false);
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_DISABLE_ENG2_AFE:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_meas_sensor_enable(SENSOR_ID_ENG2, false);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_vrect_ovp(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	VrectOvp_t vrectovp = {
+			.ovp = (!HAL_GPIO_ReadPin(VRECT_OVPn_GPIO_Port, VRECT_OVPn_Pin)),
+	};
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&vrectovp.ovp, sizeof(vrectovp.ovp));
 
-	case OP_ENABLE_ENG1_AFE:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_meas_sensor_enable(SENSOR_ID_ENG1, true);
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_ENABLE_ENG2_AFE:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_meas_sensor_enable(SENSOR_ID_ENG2, true);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_vchg_rail_supply_circuit_power_good(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	VchgRailSupplyPowerGood_t vchgrailsupplypowergood = {
+			.pGood = HAL_GPIO_ReadPin(VCHG_PGOOD_GPIO_Port, VCHG_PGOOD_Pin),
+	};
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&vchgrailsupplypowergood.pGood, sizeof(vchgrailsupplypowergood.pGood));
 
-	case OP_GET_ENG1_LOD:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			Eng1Lod_t eng1lod = {
-					.eng1Lod = HAL_GPIO_ReadPin(ENG1_LOD_GPIO_Port, ENG1_LOD_Pin),
-			};
-			uint8_t resp_payload[sizeof(eng1lod)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&eng1lod.eng1Lod, sizeof(eng1lod.eng1Lod));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_GET_ENG2_LOD:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			Eng2Lod_t eng2lod = {
-					.eng2Lod = HAL_GPIO_ReadPin(ENG2_LOD_GPIO_Port, ENG2_LOD_Pin),
-			};
-			uint8_t resp_payload[sizeof(eng2lod)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&eng2lod.eng2Lod, sizeof(eng2lod.eng2Lod));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_enable_charge_control_1_circuit(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	HAL_GPIO_WritePin(CHG1_EN_GPIO_Port, CHG1_EN_Pin, true);
+}
 
-	case OP_GET_ENG1_AFE_OUTPUT:
-	{
-		len_payload = 3;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			Eng1AfeOutputReq_t eng1afeoutputreq;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&eng1afeoutputreq.bufferSize, sizeof(eng1afeoutputreq.bufferSize));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&eng1afeoutputreq.samplingFrequency_hz, sizeof(eng1afeoutputreq.samplingFrequency_hz));
-
-			Eng1AfeOutputResp_t eng1afeoutputresp;
-			memset(&eng1afeoutputresp, 0, sizeof(Eng1AfeOutputResp_t));
-			eng1afeoutputresp.bufferSize = eng1afeoutputreq.bufferSize;
-			app_func_meas_sensor_meas(SENSOR_ID_ENG1, eng1afeoutputresp.buffer, eng1afeoutputresp.bufferSize, eng1afeoutputreq.samplingFrequency_hz);
-
-			uint8_t resp_payload[sizeof(eng1afeoutputresp)];
-			payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&eng1afeoutputresp.bufferSize, sizeof(eng1afeoutputresp.bufferSize));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)eng1afeoutputresp.buffer, sizeof(eng1afeoutputresp.buffer));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_disable_charge_control_1_circuit(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	HAL_GPIO_WritePin(CHG1_EN_GPIO_Port, CHG1_EN_Pin, false);
+}
 
-	case OP_GET_ENG2_AFE_OUTPUT:
-	{
-		len_payload = 3;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			Eng2AfeOutputReq_t eng2afeoutputreq;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&eng2afeoutputreq.bufferSize, sizeof(eng2afeoutputreq.bufferSize));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&eng2afeoutputreq.samplingFrequency_hz, sizeof(eng2afeoutputreq.samplingFrequency_hz));
-
-			Eng2AfeOutputResp_t eng2afeoutputresp;
-			memset(&eng2afeoutputresp, 0, sizeof(Eng2AfeOutputResp_t));
-			eng2afeoutputresp.bufferSize = eng2afeoutputreq.bufferSize;
-			app_func_meas_sensor_meas(SENSOR_ID_ENG2, eng2afeoutputresp.buffer, eng2afeoutputresp.bufferSize, eng2afeoutputreq.samplingFrequency_hz);
-
-			uint8_t resp_payload[sizeof(eng2afeoutputresp)];
-			payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&eng2afeoutputresp.bufferSize, sizeof(eng2afeoutputresp.bufferSize));
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)eng2afeoutputresp.buffer, sizeof(eng2afeoutputresp.buffer));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_charge_rate_control(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	ChargeRateControl_t chargeratecontrol;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&chargeratecontrol.chgRate1, sizeof(chargeratecontrol.chgRate1));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&chargeratecontrol.chgRate2, sizeof(chargeratecontrol.chgRate2));
 
-	case OP_GET_MAG_STATUS:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			MagStatus_t magstatus = {
-					.status = HAL_GPIO_ReadPin(MAG_DET_GPIO_Port, MAG_DET_Pin),
-			};
-			uint8_t resp_payload[sizeof(magstatus)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&magstatus.status, sizeof(magstatus.status));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+	HAL_GPIO_WritePin(CHG_RATE1_GPIO_Port, CHG_RATE1_Pin, chargeratecontrol.chgRate1);
+	HAL_GPIO_WritePin(CHG_RATE2_GPIO_Port, CHG_RATE2_Pin, chargeratecontrol.chgRate2);
+}
 
-	case OP_ENABLE_IMC:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_meas_imp_enable(true);
-			mocked.imp_en = true;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_chg1_status(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	Chg1Status_t chg1status = {
+			.status = HAL_GPIO_ReadPin(CHG1_STATUS_GPIO_Port, CHG1_STATUS_Pin),
+	};
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&chg1status.status, sizeof(chg1status.status));
 
-	case OP_DISABLE_IMC:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_meas_imp_enable(false);
-			mocked.imp_en = false;
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_SET_IMP_SEL_POSITIONS:
-	{
-		len_payload = 4;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			ImpSelPositions_t impselpositions;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&impselpositions.imp_in_n_sel0, sizeof(impselpositions.imp_in_n_sel0));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&impselpositions.imp_in_n_sel1, sizeof(impselpositions.imp_in_n_sel1));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&impselpositions.imp_in_n_sel2, sizeof(impselpositions.imp_in_n_sel2));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&impselpositions.imp_in_p_sel0, sizeof(impselpositions.imp_in_p_sel0));
-
-			memcpy(&ImpSelPositions, &impselpositions, sizeof(ImpSelPositions_t));
-			app_func_meas_imp_sel_set(	ImpSelPositions.imp_in_n_sel0,
-										ImpSelPositions.imp_in_n_sel1,
-										ImpSelPositions.imp_in_n_sel2,
-										ImpSelPositions.imp_in_p_sel0	);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_chg1_ovp_err(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	Chg1OvpErr_t chg1ovperr = {
+			.ovpErr = (!HAL_GPIO_ReadPin(CHG1_OVP_ERRn_GPIO_Port, CHG1_OVP_ERRn_Pin)),
+	};
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&chg1ovperr.ovpErr, sizeof(chg1ovperr.ovpErr));
 
-	case OP_GET_IMP_SEL_POSITIONS:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			uint8_t resp_payload[sizeof(ImpSelPositions)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload (payload_offset, (uint8_t*)&ImpSelPositions.imp_in_n_sel0, sizeof(ImpSelPositions.imp_in_n_sel0));
-			payload_offset = copyStructFieldToPayload (payload_offset, (uint8_t*)&ImpSelPositions.imp_in_n_sel1, sizeof(ImpSelPositions.imp_in_n_sel1));
-			payload_offset = copyStructFieldToPayload (payload_offset, (uint8_t*)&ImpSelPositions.imp_in_n_sel2, sizeof(ImpSelPositions.imp_in_n_sel2));
-			payload_offset = copyStructFieldToPayload (payload_offset, (uint8_t*)&ImpSelPositions.imp_in_p_sel0, sizeof(ImpSelPositions.imp_in_p_sel0));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_GET_IMC_MEASURE:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			const uint16_t samplingFrequency_hz = 50000;
-			static uint16_t impVoltageBufferA[ADC_MAX_SAMPLE_POINTS];
-			static uint16_t impVoltageBufferB[ADC_MAX_SAMPLE_POINTS];
-			uint16_t periodPoints = app_func_meas_imp_sampPoints_get(samplingFrequency_hz, StimulusCircuitParameters.pulsePeriod1_us);
-			uint16_t pulsePoints = app_func_meas_imp_sampPoints_get(samplingFrequency_hz, StimulusCircuitParameters.pulseWidth1_us);
-
-			HAL_Delay(StimulusCircuitParameters.stimDuration1_ms);
-			app_func_stim_sync();
-			app_func_meas_imp_volt_meas(IMPIN_CH_P, impVoltageBufferA, periodPoints, samplingFrequency_hz);
-			app_func_stim_sync();
-			app_func_meas_imp_volt_meas(IMPIN_CH_N, impVoltageBufferB, periodPoints, samplingFrequency_hz);
-
-			_Float64 impVoltageA = app_func_meas_imp_volt_calc(impVoltageBufferA, periodPoints, pulsePoints);
-			_Float64 impVoltageB = app_func_meas_imp_volt_calc(impVoltageBufferB, periodPoints, pulsePoints);
-			_Float64 impVoltage = impVoltageA + impVoltageB;
-
-			_Float64 dacStimA_mV = ((StimSelPositions.stima_sel == STIMA_SEL_STIM1)
-					?(_Float64)DacAbOutputVoltage.aDacOutputVoltage_mv:(_Float64)DacAbOutputVoltage.bDacOutputVoltage_mv);
-
-			_Float64 dacStimB_mV = ((StimSelPositions.stimb_sel == STIMB_SEL_STIM1)
-					?(_Float64)DacAbOutputVoltage.aDacOutputVoltage_mv:(_Float64)DacAbOutputVoltage.bDacOutputVoltage_mv);
-
-			_Float64 dacStim_mV = ((ImpSelPositions.imp_in_p_sel0 == IMPIN_P_STIMA)?dacStimA_mV:dacStimB_mV);
-			_Float64 impedance = app_func_meas_imp_calc(dacStim_mV, impVoltage);
-
-			ImcMeasure_t ImcMeasure  = {
-					.imc_measure = (uint16_t)impedance
-			};
-			uint8_t resp_payload[sizeof(ImcMeasure)];
-			uint8_t* payload_offset = resp_payload;
-			payload_offset = copyStructFieldToPayload (payload_offset, (uint8_t*)&ImcMeasure.imc_measure, sizeof(ImcMeasure.imc_measure));
-
-			resp.PayloadLen = payload_offset - resp_payload;
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_enable_charge_control_2_circuit(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	HAL_GPIO_WritePin(CHG2_EN_GPIO_Port, CHG2_EN_Pin, true);
+}
 
-	case OP_DISABLE_HV_SUPPLY:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			TestInformation.hvSupplyEnable = 0;
-			app_func_stim_hv_supply_set(hvSupplyTurnOn, TestInformation.hvSupplyEnable);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_disable_charge_control_2_circuit(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	HAL_GPIO_WritePin(CHG2_EN_GPIO_Port, CHG2_EN_Pin, false);
+}
 
-	case OP_DISABLE_VDDS_SUPPLY:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			TestInformation.vddsSupplyEnable = 0;
-			app_func_stim_vdds_sup_enable(TestInformation.vddsSupplyEnable);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_chg2_status(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	Chg2Status_t chg2status = {
+			.status = HAL_GPIO_ReadPin(CHG2_STATUS_GPIO_Port, CHG2_STATUS_Pin),
+	};
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&chg2status.status, sizeof(chg2status.status));
 
-	case OP_DISABLE_VDDA_SUPPLY:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			TestInformation.vddaSupplyEnable = 0;
-			app_func_meas_vdda_sup_enable(TestInformation.vddaSupplyEnable);
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_DISABLE_STIMULUS_CIRCUIT:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			app_func_stim_stimulus_enable(false);
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_get_chg2_ovp_err(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	Chg2OvpErr_t chg2ovperr = {
+			.ovpErr = (!HAL_GPIO_ReadPin(CHG2_OVP_ERRn_GPIO_Port, CHG2_OVP_ERRn_Pin)),
+	};
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&chg2ovperr.ovpErr, sizeof(chg2ovperr.ovpErr));
 
-	case OP_START_ACC:
-	{
-		len_payload = 2;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			FreqModeDeviceID_t freqModedeviceID;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&freqModedeviceID.FreqSampling, sizeof(freqModedeviceID.FreqSampling));
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&freqModedeviceID.ModeDeviceID, sizeof(freqModedeviceID.ModeDeviceID));
-
-			uint8_t resp_payload[sizeof(AccMeasure_t)];
-			resp.Status = app_mode_dvt_acc_start(freqModedeviceID, (uint8_t*)resp_payload, &resp.PayloadLen);
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	case OP_GET_DATA_ACC:
-	{
-		len_payload = 1;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			DeviceID_t deviceID;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&deviceID.DeviceID, sizeof(deviceID.DeviceID));
+static void app_mode_dvt_cmd_enable_thermistor_interface_circuit(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_therm_enable(true);
+}
 
-			uint8_t resp_payload[sizeof(InfoData_t)];
-			resp.Status = app_mode_dvt_acc_data_get(deviceID, (uint8_t*)resp_payload, &resp.PayloadLen);
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+static void app_mode_dvt_cmd_disable_thermistor_interface_circuit(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_therm_enable(false);
+}
 
-	case OP_STOP_ACC:
-	{
-		len_payload = 1;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			DeviceID_t deviceID;
-			uint8_t* payload_offset = req.Payload;
-			payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&deviceID.DeviceID, sizeof(deviceID.DeviceID));
+static void app_mode_dvt_cmd_get_therm_ref(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	ThermRefReq_t thermrefreq;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&thermrefreq.bufferSize, sizeof(thermrefreq.bufferSize));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&thermrefreq.samplingFrequency_hz, sizeof(thermrefreq.samplingFrequency_hz));
 
-			uint8_t resp_payload[sizeof(DeviceID_t)];
-			resp.Status = app_mode_dvt_acc_stop(deviceID, (uint8_t*)resp_payload, &resp.PayloadLen);
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
+	ThermRefResp_t thermrefresp;
+	memset(&thermrefresp, 0, sizeof(ThermRefResp_t));
+	thermrefresp.bufferSize = thermrefreq.bufferSize;
+	app_func_meas_therm_meas(THERM_ID_REF, thermrefresp.buffer, thermrefresp.bufferSize, thermrefreq.samplingFrequency_hz);
 
-	case OP_ENABLE_VCHG_RAIL_SUPPLY:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			HAL_GPIO_WritePin(VCHG_DISABLE_GPIO_Port, VCHG_DISABLE_Pin, false);
-		}
-	}
-		break;
+	uint8_t* resp_payload = p_resp->Payload;
+	payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&thermrefresp.bufferSize, sizeof(thermrefresp.bufferSize));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)thermrefresp.buffer, sizeof(thermrefresp.buffer));
 
-	case OP_DISABLE_VCHG_RAIL_SUPPLY:
-	{
-		len_payload = 0;
-		if (req.PayloadLen != len_payload) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else {
-			HAL_GPIO_WritePin(VCHG_DISABLE_GPIO_Port, VCHG_DISABLE_Pin, true);
-		}
-	}
-		break;
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
 
-	default:
-	{
-		resp.Status = STATUS_OPCODE_ERR;
-	}
-		break;
-	}
+static void app_mode_dvt_cmd_get_therm_out(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	ThermOutReq_t thermoutreq;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&thermoutreq.bufferSize, sizeof(thermoutreq.bufferSize));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&thermoutreq.samplingFrequency_hz, sizeof(thermoutreq.samplingFrequency_hz));
+
+	ThermOutResp_t thermoutresp;
+	memset(&thermoutresp, 0, sizeof(ThermOutResp_t));
+	thermoutresp.bufferSize = thermoutreq.bufferSize;
+	app_func_meas_therm_meas(THERM_ID_OUT, thermoutresp.buffer, thermoutresp.bufferSize, thermoutreq.samplingFrequency_hz);
+
+	uint8_t* resp_payload = p_resp->Payload;
+	payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&thermoutresp.bufferSize, sizeof(thermoutresp.bufferSize));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)thermoutresp.buffer, sizeof(thermoutresp.buffer));
+
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
+
+static void app_mode_dvt_cmd_get_therm_ofst(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	ThermOffstReq_t thermofstreq;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&thermofstreq.bufferSize, sizeof(thermofstreq.bufferSize));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&thermofstreq.samplingFrequency_hz, sizeof(thermofstreq.samplingFrequency_hz));
+
+	ThermOffstResp_t thermofstresp;
+	memset(&thermofstresp, 0, sizeof(ThermOffstResp_t));
+	thermofstresp.bufferSize = thermofstreq.bufferSize;
+	app_func_meas_therm_meas(THERM_ID_OFST, thermofstresp.buffer, thermofstresp.bufferSize, thermofstreq.samplingFrequency_hz);
+
+	uint8_t* resp_payload = p_resp->Payload;
+	payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&thermofstresp.bufferSize, sizeof(thermofstresp.bufferSize));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)thermofstresp.buffer, sizeof(thermofstresp.buffer));
+
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
+
+static void app_mode_dvt_cmd_disable_eng1_afe(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_sensor_enable(SENSOR_ID_ENG1, false);
+}
+
+static void app_mode_dvt_cmd_disable_eng2_afe(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_sensor_enable(SENSOR_ID_ENG2, false);
+}
+
+static void app_mode_dvt_cmd_enable_eng1_afe(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_sensor_enable(SENSOR_ID_ENG1, true);
+}
+
+static void app_mode_dvt_cmd_enable_eng2_afe(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_sensor_enable(SENSOR_ID_ENG2, true);
+}
+
+static void app_mode_dvt_cmd_get_eng1_lod(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	Eng1Lod_t eng1lod = {
+			.eng1Lod = HAL_GPIO_ReadPin(ENG1_LOD_GPIO_Port, ENG1_LOD_Pin),
+	};
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&eng1lod.eng1Lod, sizeof(eng1lod.eng1Lod));
+
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
+
+static void app_mode_dvt_cmd_get_eng2_lod(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	Eng2Lod_t eng2lod = {
+			.eng2Lod = HAL_GPIO_ReadPin(ENG2_LOD_GPIO_Port, ENG2_LOD_Pin),
+	};
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&eng2lod.eng2Lod, sizeof(eng2lod.eng2Lod));
+
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
+
+static void app_mode_dvt_cmd_get_eng1_afe_output(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	Eng1AfeOutputReq_t eng1afeoutputreq;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&eng1afeoutputreq.bufferSize, sizeof(eng1afeoutputreq.bufferSize));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&eng1afeoutputreq.samplingFrequency_hz, sizeof(eng1afeoutputreq.samplingFrequency_hz));
+
+	Eng1AfeOutputResp_t eng1afeoutputresp;
+	memset(&eng1afeoutputresp, 0, sizeof(Eng1AfeOutputResp_t));
+	eng1afeoutputresp.bufferSize = eng1afeoutputreq.bufferSize;
+	app_func_meas_sensor_meas(SENSOR_ID_ENG1, eng1afeoutputresp.buffer, eng1afeoutputresp.bufferSize, eng1afeoutputreq.samplingFrequency_hz);
+
+	uint8_t* resp_payload = p_resp->Payload;
+	payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&eng1afeoutputresp.bufferSize, sizeof(eng1afeoutputresp.bufferSize));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)eng1afeoutputresp.buffer, sizeof(eng1afeoutputresp.buffer));
+
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
+
+static void app_mode_dvt_cmd_get_eng2_afe_output(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	Eng2AfeOutputReq_t eng2afeoutputreq;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&eng2afeoutputreq.bufferSize, sizeof(eng2afeoutputreq.bufferSize));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&eng2afeoutputreq.samplingFrequency_hz, sizeof(eng2afeoutputreq.samplingFrequency_hz));
+
+	Eng2AfeOutputResp_t eng2afeoutputresp;
+	memset(&eng2afeoutputresp, 0, sizeof(Eng2AfeOutputResp_t));
+	eng2afeoutputresp.bufferSize = eng2afeoutputreq.bufferSize;
+	app_func_meas_sensor_meas(SENSOR_ID_ENG2, eng2afeoutputresp.buffer, eng2afeoutputresp.bufferSize, eng2afeoutputreq.samplingFrequency_hz);
+
+	uint8_t* resp_payload = p_resp->Payload;
+	payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&eng2afeoutputresp.bufferSize, sizeof(eng2afeoutputresp.bufferSize));
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)eng2afeoutputresp.buffer, sizeof(eng2afeoutputresp.buffer));
+
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
+
+static void app_mode_dvt_cmd_get_mag_status(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	MagStatus_t magstatus = {
+			.status = HAL_GPIO_ReadPin(MAG_DET_GPIO_Port, MAG_DET_Pin),
+	};
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload(payload_offset, (uint8_t*)&magstatus.status, sizeof(magstatus.status));
+
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
+
+static void app_mode_dvt_cmd_enable_imc(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_imp_enable(true);
+	mocked.imp_en = true;
+}
+
+static void app_mode_dvt_cmd_disable_imc(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_meas_imp_enable(false);
+	mocked.imp_en = false;
+}
+
+static void app_mode_dvt_cmd_set_imp_sel_positions(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	ImpSelPositions_t impselpositions;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&impselpositions.imp_in_n_sel0, sizeof(impselpositions.imp_in_n_sel0));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&impselpositions.imp_in_n_sel1, sizeof(impselpositions.imp_in_n_sel1));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&impselpositions.imp_in_n_sel2, sizeof(impselpositions.imp_in_n_sel2));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&impselpositions.imp_in_p_sel0, sizeof(impselpositions.imp_in_p_sel0));
+
+	memcpy(&ImpSelPositions, &impselpositions, sizeof(ImpSelPositions_t));
+	app_func_meas_imp_sel_set(	ImpSelPositions.imp_in_n_sel0,
+								ImpSelPositions.imp_in_n_sel1,
+								ImpSelPositions.imp_in_n_sel2,
+								ImpSelPositions.imp_in_p_sel0	);
+}
+
+static void app_mode_dvt_cmd_get_imp_sel_positions(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload (payload_offset, (uint8_t*)&ImpSelPositions.imp_in_n_sel0, sizeof(ImpSelPositions.imp_in_n_sel0));
+	payload_offset = copyStructFieldToPayload (payload_offset, (uint8_t*)&ImpSelPositions.imp_in_n_sel1, sizeof(ImpSelPositions.imp_in_n_sel1));
+	payload_offset = copyStructFieldToPayload (payload_offset, (uint8_t*)&ImpSelPositions.imp_in_n_sel2, sizeof(ImpSelPositions.imp_in_n_sel2));
+	payload_offset = copyStructFieldToPayload (payload_offset, (uint8_t*)&ImpSelPositions.imp_in_p_sel0, sizeof(ImpSelPositions.imp_in_p_sel0));
+
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
+
+static void app_mode_dvt_cmd_get_imc_measure(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	const uint16_t samplingFrequency_hz = 50000;
+	static uint16_t impVoltageBufferA[ADC_MAX_SAMPLE_POINTS];
+	static uint16_t impVoltageBufferB[ADC_MAX_SAMPLE_POINTS];
+	uint16_t periodPoints = app_func_meas_imp_sampPoints_get(samplingFrequency_hz, StimulusCircuitParameters.pulsePeriod1_us);
+	uint16_t pulsePoints = app_func_meas_imp_sampPoints_get(samplingFrequency_hz, StimulusCircuitParameters.pulseWidth1_us);
+
+	HAL_Delay(StimulusCircuitParameters.stimDuration1_ms);
+	app_func_stim_sync();
+	app_func_meas_imp_volt_meas(IMPIN_CH_P, impVoltageBufferA, periodPoints, samplingFrequency_hz);
+	app_func_stim_sync();
+	app_func_meas_imp_volt_meas(IMPIN_CH_N, impVoltageBufferB, periodPoints, samplingFrequency_hz);
+
+	_Float64 impVoltageA = app_func_meas_imp_volt_calc(impVoltageBufferA, periodPoints, pulsePoints);
+	_Float64 impVoltageB = app_func_meas_imp_volt_calc(impVoltageBufferB, periodPoints, pulsePoints);
+	_Float64 impVoltage = impVoltageA + impVoltageB;
+
+	_Float64 dacStimA_mV = ((StimSelPositions.stima_sel == STIMA_SEL_STIM1)
+			?(_Float64)DacAbOutputVoltage.aDacOutputVoltage_mv:(_Float64)DacAbOutputVoltage.bDacOutputVoltage_mv);
+
+	_Float64 dacStimB_mV = ((StimSelPositions.stimb_sel == STIMB_SEL_STIM1)
+			?(_Float64)DacAbOutputVoltage.aDacOutputVoltage_mv:(_Float64)DacAbOutputVoltage.bDacOutputVoltage_mv);
+
+	_Float64 dacStim_mV = ((ImpSelPositions.imp_in_p_sel0 == IMPIN_P_STIMA)?dacStimA_mV:dacStimB_mV);
+	_Float64 impedance = app_func_meas_imp_calc(dacStim_mV, impVoltage);
+
+	ImcMeasure_t ImcMeasure  = {
+			.imc_measure = (uint16_t)impedance
+	};
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* payload_offset = resp_payload;
+	payload_offset = copyStructFieldToPayload (payload_offset, (uint8_t*)&ImcMeasure.imc_measure, sizeof(ImcMeasure.imc_measure));
+
+	p_resp->PayloadLen = payload_offset - resp_payload;
+}
+
+static void app_mode_dvt_cmd_disable_hv_supply(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	TestInformation.hvSupplyEnable = 0;
+	app_func_stim_hv_supply_set(hvSupplyTurnOn, TestInformation.hvSupplyEnable);
+}
+
+static void app_mode_dvt_cmd_disable_vdds_supply(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	TestInformation.vddsSupplyEnable = 0;
+	app_func_stim_vdds_sup_enable(TestInformation.vddsSupplyEnable);
+}
+
+static void app_mode_dvt_cmd_disable_vdda_supply(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	TestInformation.vddaSupplyEnable = 0;
+	app_func_meas_vdda_sup_enable(TestInformation.vddaSupplyEnable);
+}
+
+static void app_mode_dvt_cmd_disable_stimulus_circuit(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_stim_stimulus_enable(false);
+}
+
+static void app_mode_dvt_cmd_start_acc(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	FreqModeDeviceID_t freqModedeviceID;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&freqModedeviceID.FreqSampling, sizeof(freqModedeviceID.FreqSampling));
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&freqModedeviceID.ModeDeviceID, sizeof(freqModedeviceID.ModeDeviceID));
+
+	uint8_t* resp_payload = p_resp->Payload;
+	p_resp->Status = app_mode_dvt_acc_start(freqModedeviceID, (uint8_t*)resp_payload, &p_resp->PayloadLen);
+}
+
+static void app_mode_dvt_cmd_get_data_acc(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	DeviceID_t deviceID;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&deviceID.DeviceID, sizeof(deviceID.DeviceID));
+
+	uint8_t* resp_payload = p_resp->Payload;
+	p_resp->Status = app_mode_dvt_acc_data_get(deviceID, (uint8_t*)resp_payload, &p_resp->PayloadLen);
+}
+
+static void app_mode_dvt_cmd_stop_acc(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	DeviceID_t deviceID;
+	uint8_t* payload_offset = p_req->Payload;
+	payload_offset = copyPayloadToStructField (payload_offset, (uint8_t*)&deviceID.DeviceID, sizeof(deviceID.DeviceID));
+
+	uint8_t* resp_payload = p_resp->Payload;
+	p_resp->Status = app_mode_dvt_acc_stop(deviceID, (uint8_t*)resp_payload, &p_resp->PayloadLen);
+}
+
+static void app_mode_dvt_cmd_enable_vchg_rail_supply(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	HAL_GPIO_WritePin(VCHG_DISABLE_GPIO_Port, VCHG_DISABLE_Pin, false);
+}
+
+static void app_mode_dvt_cmd_disable_vchg_rail_supply(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	HAL_GPIO_WritePin(VCHG_DISABLE_GPIO_Port, VCHG_DISABLE_Pin, true);
+}
+
+//The DVT commands run without authentication, so every entry takes USER_CLASS_INVALID
+static const Cmd_Entry_t dvt_cmd_entries[] = {
+	[OP_PING] = {&app_mode_dvt_cmd_ping, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_TEST_INFORMATION] = {&app_mode_dvt_cmd_get_test_information, 0, 0, USER_CLASS_INVALID},
+	[OP_SET_SAMPLE_ID] = {&app_mode_dvt_cmd_set_sample_id, 2, 2, USER_CLASS_INVALID},
+	[OP_GET_SAMPLE_ID] = {&app_mode_dvt_cmd_get_sample_id, 0, 0, USER_CLASS_INVALID},
+	[OP_SET_DVT_MODE] = {&app_mode_dvt_cmd_set_dvt_mode, 1, 1, USER_CLASS_INVALID},
+	[OP_TURN_ON_HV_SUPPLY] = {&app_mode_dvt_cmd_turn_on_hv_supply, 0, 0, USER_CLASS_INVALID},
+	[OP_SET_HV_SUPPLY_VOLTAGE_VALUE] = {&app_mode_dvt_cmd_set_hv_supply_voltage_value, 2, 2, USER_CLASS_INVALID},
+	[OP_ENABLE_HV_SUPPLY] = {&app_mode_dvt_cmd_enable_hv_supply, 0, 0, USER_CLASS_INVALID},
+	[OP_IPG_SHUTDOWN] = {&app_mode_dvt_cmd_ipg_shutdown, 0, 0, USER_CLASS_INVALID},
+	[OP_ENABLE_VDDS_SUPPLY] = {&app_mode_dvt_cmd_enable_vdds_supply, 0, 0, USER_CLASS_INVALID},
+	[OP_ENABLE_VDDA_SUPPLY] = {&app_mode_dvt_cmd_enable_vdda_supply, 0, 0, USER_CLASS_INVALID},
+	[OP_ENABLE_BATTERY_MONITOR] = {&app_mode_dvt_cmd_enable_battery_monitor, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_BATTERY_VOLTAGE_MEASUREMENT] = {&app_mode_dvt_cmd_get_battery_voltage_measurement, 0, 0, USER_CLASS_INVALID},
+	[OP_SET_STIMULUS_CIRCUIT_PARAMETERS] = {&app_mode_dvt_cmd_set_stimulus_circuit_parameters, 13, 13, USER_CLASS_INVALID},
+	[OP_GET_STIMULUS_CIRCUIT_PARAMETERS] = {&app_mode_dvt_cmd_get_stimulus_circuit_parameters, 0, 0, USER_CLASS_INVALID},
+	[OP_SET_DAC_AB_OUTPUT_VOLTAGE] = {&app_mode_dvt_cmd_set_dac_ab_output_voltage, 4, 4, USER_CLASS_INVALID},
+	[OP_ENABLE_VNS_STIMULATION] = {&app_mode_dvt_cmd_enable_vns_stimulation, 0, 0, USER_CLASS_INVALID},
+	[OP_DISABLE_VNS_STIMULATION] = {&app_mode_dvt_cmd_disable_vns_stimulation, 0, 0, USER_CLASS_INVALID},
+	[OP_ENABLE_STIMULUS_CIRCUIT] = {&app_mode_dvt_cmd_enable_stimulus_circuit, 0, 0, USER_CLASS_INVALID},
+	[OP_SET_CURRENT_SOURCES_CONFIGURATION] = {&app_mode_dvt_cmd_set_current_sources_configuration, 7, 7, USER_CLASS_INVALID},
+	[OP_GET_CURRENT_SOURCES_CONFIGURATION] = {&app_mode_dvt_cmd_get_current_sources_configuration, 0, 0, USER_CLASS_INVALID},
+	[OP_GENERATE_MOCKED_STIMULUS] = {&app_mode_dvt_cmd_generate_mocked_stimulus, 0, 0, USER_CLASS_INVALID},
+	[OP_ENABLE_CHANNEL_MUX] = {&app_mode_dvt_cmd_enable_channel_mux, 0, 0, USER_CLASS_INVALID},
+	[OP_SET_STIM_SEL_POSITIONS] = {&app_mode_dvt_cmd_set_stim_sel_positions, 7, 7, USER_CLASS_INVALID},
+	[OP_GET_STIM_SEL_POSITIONS] = {&app_mode_dvt_cmd_get_stim_sel_positions, 0, 0, USER_CLASS_INVALID},
+	[OP_DISABLE_ECG_HR_AFE] = {&app_mode_dvt_cmd_disable_ecg_hr_afe, 0, 0, USER_CLASS_INVALID},
+	[OP_DISABLE_ECG_RR_AFE] = {&app_mode_dvt_cmd_disable_ecg_rr_afe, 0, 0, USER_CLASS_INVALID},
+	[OP_ENABLE_ECG_HR_AFE] = {&app_mode_dvt_cmd_enable_ecg_hr_afe, 0, 0, USER_CLASS_INVALID},
+	[OP_ENABLE_ECG_RR_AFE] = {&app_mode_dvt_cmd_enable_ecg_rr_afe, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_ECG_HR_LOD] = {&app_mode_dvt_cmd_get_ecg_hr_lod, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_ECG_RR_LOD] = {&app_mode_dvt_cmd_get_ecg_rr_lod, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_ECG_HR_AFE_OUTPUT] = {&app_mode_dvt_cmd_get_ecg_hr_afe_output, 3, 3, USER_CLASS_INVALID},
+	[OP_GET_ECG_RR_AFE_OUTPUT] = {&app_mode_dvt_cmd_get_ecg_rr_afe_output, 3, 3, USER_CLASS_INVALID},
+	[OP_ENABLE_WPT_VRECT_MON_CIRCUIT] = {&app_mode_dvt_cmd_enable_wpt_vrect_mon_circuit, 0, 0, USER_CLASS_INVALID},
+	[OP_DISABLE_WPT_VRECT_MON_CIRCUIT] = {&app_mode_dvt_cmd_disable_wpt_vrect_mon_circuit, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_WPT_VRECT_MON_CIRCUIT_OUTPUT] = {&app_mode_dvt_cmd_get_wpt_vrect_mon_circuit_output, 3, 3, USER_CLASS_INVALID},
+	[OP_GET_VRECT_DET] = {&app_mode_dvt_cmd_get_vrect_det, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_VRECT_OVP] = {&app_mode_dvt_cmd_get_vrect_ovp, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_VCHG_RAIL_SUPPLY_CIRCUIT_POWER_GOOD] = {&app_mode_dvt_cmd_get_vchg_rail_supply_circuit_power_good, 0, 0, USER_CLASS_INVALID},
+	[OP_ENABLE_CHARGE_CONTROL_1_CIRCUIT] = {&app_mode_dvt_cmd_enable_charge_control_1_circuit, 0, 0, USER_CLASS_INVALID},
+	[OP_DISABLE_CHARGE_CONTROL_1_CIRCUIT] = {&app_mode_dvt_cmd_disable_charge_control_1_circuit, 0, 0, USER_CLASS_INVALID},
+	[OP_CHARGE_RATE_CONTROL] = {&app_mode_dvt_cmd_charge_rate_control, 2, 2, USER_CLASS_INVALID},
+	[OP_GET_CHG1_STATUS] = {&app_mode_dvt_cmd_get_chg1_status, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_CHG1_OVP_ERR] = {&app_mode_dvt_cmd_get_chg1_ovp_err, 0, 0, USER_CLASS_INVALID},
+	[OP_ENABLE_CHARGE_CONTROL_2_CIRCUIT] = {&app_mode_dvt_cmd_enable_charge_control_2_circuit, 0, 0, USER_CLASS_INVALID},
+	[OP_DISABLE_CHARGE_CONTROL_2_CIRCUIT] = {&app_mode_dvt_cmd_disable_charge_control_2_circuit, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_CHG2_STATUS] = {&app_mode_dvt_cmd_get_chg2_status, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_CHG2_OVP_ERR] = {&app_mode_dvt_cmd_get_chg2_ovp_err, 0, 0, USER_CLASS_INVALID},
+	[OP_ENABLE_THERMISTOR_INTERFACE_CIRCUIT] = {&app_mode_dvt_cmd_enable_thermistor_interface_circuit, 0, 0, USER_CLASS_INVALID},
+	[OP_DISABLE_THERMISTOR_INTERFACE_CIRCUIT] = {&app_mode_dvt_cmd_disable_thermistor_interface_circuit, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_THERM_REF] = {&app_mode_dvt_cmd_get_therm_ref, 3, 3, USER_CLASS_INVALID},
+	[OP_GET_THERM_OUT] = {&app_mode_dvt_cmd_get_therm_out, 3, 3, USER_CLASS_INVALID},
+	[OP_GET_THERM_OFST] = {&app_mode_dvt_cmd_get_therm_ofst, 3, 3, USER_CLASS_INVALID},
+	[OP_DISABLE_ENG1_AFE] = {&app_mode_dvt_cmd_disable_eng1_afe, 0, 0, USER_CLASS_INVALID},
+	[OP_DISABLE_ENG2_AFE] = {&app_mode_dvt_cmd_disable_eng2_afe, 0, 0, USER_CLASS_INVALID},
+	[OP_ENABLE_ENG1_AFE] = {&app_mode_dvt_cmd_enable_eng1_afe, 0, 0, USER_CLASS_INVALID},
+	[OP_ENABLE_ENG2_AFE] = {&app_mode_dvt_cmd_enable_eng2_afe, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_ENG1_LOD] = {&app_mode_dvt_cmd_get_eng1_lod, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_ENG2_LOD] = {&app_mode_dvt_cmd_get_eng2_lod, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_ENG1_AFE_OUTPUT] = {&app_mode_dvt_cmd_get_eng1_afe_output, 3, 3, USER_CLASS_INVALID},
+	[OP_GET_ENG2_AFE_OUTPUT] = {&app_mode_dvt_cmd_get_eng2_afe_output, 3, 3, USER_CLASS_INVALID},
+	[OP_GET_MAG_STATUS] = {&app_mode_dvt_cmd_get_mag_status, 0, 0, USER_CLASS_INVALID},
+	[OP_ENABLE_IMC] = {&app_mode_dvt_cmd_enable_imc, 0, 0, USER_CLASS_INVALID},
+	[OP_DISABLE_IMC] = {&app_mode_dvt_cmd_disable_imc, 0, 0, USER_CLASS_INVALID},
+	[OP_SET_IMP_SEL_POSITIONS] = {&app_mode_dvt_cmd_set_imp_sel_positions, 4, 4, USER_CLASS_INVALID},
+	[OP_GET_IMP_SEL_POSITIONS] = {&app_mode_dvt_cmd_get_imp_sel_positions, 0, 0, USER_CLASS_INVALID},
+	[OP_GET_IMC_MEASURE] = {&app_mode_dvt_cmd_get_imc_measure, 0, 0, USER_CLASS_INVALID},
+	[OP_DISABLE_HV_SUPPLY] = {&app_mode_dvt_cmd_disable_hv_supply, 0, 0, USER_CLASS_INVALID},
+	[OP_DISABLE_VDDS_SUPPLY] = {&app_mode_dvt_cmd_disable_vdds_supply, 0, 0, USER_CLASS_INVALID},
+	[OP_DISABLE_VDDA_SUPPLY] = {&app_mode_dvt_cmd_disable_vdda_supply, 0, 0, USER_CLASS_INVALID},
+	[OP_DISABLE_STIMULUS_CIRCUIT] = {&app_mode_dvt_cmd_disable_stimulus_circuit, 0, 0, USER_CLASS_INVALID},
+	[OP_START_ACC] = {&app_mode_dvt_cmd_start_acc, 2, 2, USER_CLASS_INVALID},
+	[OP_GET_DATA_ACC] = {&app_mode_dvt_cmd_get_data_acc, 1, 1, USER_CLASS_INVALID},
+	[OP_STOP_ACC] = {&app_mode_dvt_cmd_stop_acc, 1, 1, USER_CLASS_INVALID},
+	[OP_ENABLE_VCHG_RAIL_SUPPLY] = {&app_mode_dvt_cmd_enable_vchg_rail_supply, 0, 0, USER_CLASS_INVALID},
+	[OP_DISABLE_VCHG_RAIL_SUPPLY] = {&app_mode_dvt_cmd_disable_vchg_rail_supply, 0, 0, USER_CLASS_INVALID},
+};
+
+static const Cmd_Entry_t dvt_sys_cmd_entries[] = {
+	[OP_SET_START_STATE - OP_SET_START_STATE] = {&app_mode_dvt_cmd_set_start_state, 2, 2, USER_CLASS_INVALID},
+};
+
+static const Cmd_Table_t dvt_cmd_tables[] = {
+	{dvt_cmd_entries, 		OP_PING, 			(uint8_t)(sizeof(dvt_cmd_entries) / sizeof(dvt_cmd_entries[0]))},
+	{dvt_sys_cmd_entries, 	OP_SET_START_STATE, (uint8_t)(sizeof(dvt_sys_cmd_entries) / sizeof(dvt_sys_cmd_entries[0]))},
+};
+#define DVT_CMD_TABLE_NUM	((uint8_t)(sizeof(dvt_cmd_tables) / sizeof(dvt_cmd_tables[0])))
 
-	return resp;
+static void app_mode_dvt_command_req_parser(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_command_dispatch(dvt_cmd_tables, DVT_CMD_TABLE_NUM, USER_CLASS_INVALID, p_req, p_resp);
 }
 
 static BLE_ADV_Setting_t setting = {
@@ -1680,7 +1107,7 @@ void app_mode_dvt_handler(void) {
 				ble_peers_del = true;
 			}
 			else {
-				app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
+				(void)app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
 				app_func_ble_adv_start(&setting);
 			}
 		}
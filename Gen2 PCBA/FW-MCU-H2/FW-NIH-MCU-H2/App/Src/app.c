@@ -48,6 +48,9 @@ void app_init(void) {
 	app_func_logs_init();
 	app_func_para_init();
 	app_func_sm_init();
+	app_state_init();
+	app_mode_ble_conn_init();
+	app_mode_therapy_init();
 
 	app_func_logs_event_write(EVENT_POWER_ON, NULL);
 
@@ -8,9 +8,15 @@
 
 #define	COUNT_MAX_ER	3		/*!< The maximum count value that triggers the "ER" event */
 
+#define	VOLT_STEP_SAMPLE_NUM	5U											/*!< The number of samples of each battery in one step of the measurement */
+#define	VOLT_STEP_NUM			(BATT_MON_SAMPLE_NUM / VOLT_STEP_SAMPLE_NUM)	/*!< The number of steps of the measurement */
+
 uint32_t battery_er_counter = 0;
 uint32_t battery_eos_counter = 0;
 
+static uint8_t volt_step_count = 0;
+static uint32_t volt_step_sum[2] = {0};
+
 /**
  * @brief Measure, obtain and record battery voltages
  * 
@@ -26,6 +32,58 @@ void app_mode_battery_test_volt_get(uint16_t* p_vbatA, uint16_t* p_vbatB) {
 	app_func_logs_batt_volt_write(*p_vbatA, *p_vbatB);
 }
 
+/**
+ * @brief Measure, obtain and record battery voltages one step at a time, so the measurement can run from the main loop
+ *
+ * @param p_vbatA The battery voltage of battery 1, unit: mV, valid when the measurement is finished
+ * @param p_vbatB The battery voltage of battery 2, unit: mV, valid when the measurement is finished
+ * @param p_progress The progress of the measurement, unit: %
+ * @return true The measurement is finished
+ * @return false The measurement needs more steps
+ */
+bool app_mode_battery_test_volt_step(uint16_t* p_vbatA, uint16_t* p_vbatB, uint8_t* p_progress) {
+	if (volt_step_count == 0U) {
+		app_func_meas_batt_mon_enable(true);
+		HAL_Delay(10);
+		volt_step_sum[0] = 0;
+		volt_step_sum[1] = 0;
+	}
+	app_func_meas_batt_mon_sum(VOLT_STEP_SAMPLE_NUM, &volt_step_sum[0], &volt_step_sum[1]);
+	volt_step_count++;
+	*p_progress = (uint8_t)((volt_step_count * 100U) / VOLT_STEP_NUM);
+
+	if (volt_step_count < VOLT_STEP_NUM) {
+		return false;
+	}
+
+	app_func_meas_batt_mon_enable(false);
+	volt_step_count = 0;
+	*p_vbatA = app_func_meas_batt_mon_volt_calc(volt_step_sum[0], BATT_MON_SAMPLE_NUM);
+	*p_vbatB = app_func_meas_batt_mon_volt_calc(volt_step_sum[1], BATT_MON_SAMPLE_NUM);
+
+	app_func_logs_batt_volt_write(*p_vbatA, *p_vbatB);
+	return true;
+}
+
+/**
+ * @brief Abort the battery voltage measurement run by steps
+ *
+ */
+void app_mode_battery_test_volt_abort(void) {
+	app_func_meas_batt_mon_enable(false);
+	volt_step_count = 0;
+}
+
+/**
+ * @brief Check whether the battery has reached the elective replacement level
+ *
+ * @return true The "ER" event has been triggered by the battery tests
+ * @return false The battery is above the elective replacement level
+ */
+bool app_mode_battery_test_er_get(void) {
+	return (HAL_RTCEx_BKUPRead(&hrtc, RTC_BKP_DR1) >= (uint32_t)COUNT_MAX_ER);
+}
+
 /**
  * @brief Handler for battery test mode
  * 
@@ -9,9 +9,13 @@
 const uint32_t msd_update_interval_s = 1U;
 
 static uint32_t adv_ms_timer = 0U;
+static uint32_t msd_ms_timer = 0U;
 static uint8_t ble_act_user_class = USER_CLASS_INVALID;
 static bool active_disconnect = false;
 
+extern bool schd_therapy_enable;
+extern bool vnsb_en;
+
 /**
  * @brief Set or clear a bit in a buffer based on a GPIO pin state.
  *
@@ -49,68 +53,79 @@ static HAL_StatusTypeDef setBitFromGpioState(uint8_t *buffer, size_t buffer_size
 /**
  * @brief Parser for request commands in BLE active mode, used to communicate with the remote end
  * 
- * @param req Request command to be parsed
- * @return Cmd_Resp_t The response command to be replied after parsing the request command
+ * @param p_req Request command to be parsed
+ * @param p_resp The response command to be replied after parsing the request command
  */
-static Cmd_Resp_t app_mode_ble_act_cmd_parser(Cmd_Req_t req) {
-	Cmd_Resp_t resp = {
-			.Opcode 		= req.Opcode,
-			.Status 		= STATUS_SUCCESS,
-			.Payload 		= NULL,
-			.PayloadLen 	= 0,
-	};
-
-	switch(req.Opcode) {
+static void app_mode_ble_act_cmd_parser(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+
+	switch(p_req->Opcode) {
 	case OP_AUTH:
 	{
 		uint8_t datalen_ipg_fw_version 	= app_func_para_datalen_get((const uint8_t*)HPID_IPG_FW_VERSION);
 		uint8_t datalen_ble_id 			= app_func_para_datalen_get((const uint8_t*)HPID_IPG_BLE_ID);
 		uint8_t len_payload_min = (uint8_t)sizeof(ECDSA_Data_t) + datalen_ipg_fw_version + datalen_ble_id;
 		uint8_t len_payload_max = (uint8_t)sizeof(ECDSA_Data_t) + datalen_ipg_fw_version + datalen_ble_id;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
+		if ((p_req->PayloadLen < len_payload_min) || (p_req->PayloadLen > len_payload_max)) {
+			p_resp->Status = STATUS_PAYLOAD_LEN_ERR;
 		}
 		else {
 			ECDSA_Data_t ecdsa_data = {0};
-			(void)memcpy((uint8_t*)&ecdsa_data, req.Payload, sizeof(ECDSA_Data_t));
+			(void)memcpy((uint8_t*)&ecdsa_data, p_req->Payload, sizeof(ECDSA_Data_t));
 			ble_act_user_class = app_func_auth_user_class_get(ecdsa_data);
 
 			if (ble_act_user_class == USER_CLASS_INVALID) {
-				resp.Status = STATUS_INVALID;
+				p_resp->Status = STATUS_INVALID;
 				active_disconnect = true;
 			}
 			else {
 				if (ble_act_user_class == USER_CLASS_CLINICIAN || ble_act_user_class == USER_CLASS_PATIENT) {
-					app_func_para_data_set((const uint8_t*)HPID_LINKED_PRC_FW_VERSION, 	&req.Payload[sizeof(ECDSA_Data_t)]);
-					app_func_para_data_set((const uint8_t*)HPID_LINKED_PRC_BLE_ID, 		&req.Payload[sizeof(ECDSA_Data_t) + datalen_ipg_fw_version]);
+					app_func_para_data_set((const uint8_t*)HPID_LINKED_PRC_FW_VERSION, 	&p_req->Payload[sizeof(ECDSA_Data_t)]);
+					app_func_para_data_set((const uint8_t*)HPID_LINKED_PRC_BLE_ID, 		&p_req->Payload[sizeof(ECDSA_Data_t) + datalen_ipg_fw_version]);
 				}
 				app_func_sm_current_state_set(STATE_ACT_MODE_BLE_CONN);
 			app_func_logs_event_write(EVENT_BLE_CONNECT, NULL);
 			}
-			resp.PayloadLen = (uint8_t)sizeof(uint8_t);
-			resp.Payload = &ble_act_user_class;
+			p_resp->PayloadLen = (uint8_t)sizeof(uint8_t);
+			p_resp->Payload = &ble_act_user_class;
 		}
 	}
 		break;
 
 	default:
 	{
-		resp.Status = STATUS_USER_CLASS_ERR;
+		p_resp->Status = STATUS_USER_CLASS_ERR;
 	}
 		break;
 	}
+}
 
-	return resp;
+/**
+ * @brief Convert a battery voltage to its MSD value
+ *
+ * @param vbat_mv The battery voltage, unit: mV
+ * @return uint8_t The voltage above MSD_BATT_BASE_MV, 10 mV / LSB, clamped to 0 ~ 0xFF
+ */
+static uint8_t app_mode_ble_act_msd_batt_get(uint16_t vbat_mv) {
+	if (vbat_mv <= MSD_BATT_BASE_MV) {
+		return 0U;
+	}
+	uint16_t batt_10mv = (vbat_mv - MSD_BATT_BASE_MV) / 10U;
+	return (batt_10mv > 0xFFU) ? 0xFFU : (uint8_t)batt_10mv;
 }
 
 /**
  * @brief Update the Manufacturer Specific Data (MSD) field of a BLE advertising packet.
+ * The BLE ID at MSD_IDX_BLE_ID and the hardware version at MSD_IDX_HW_VERSION are left to the caller.
  *
  * @param p_msd Pointer to the msd field of BLE advertising settings structure
  *
- * @return uint8_t 	The number of used bytes in the MSD buffer
+ * @return true 	The MSD changed, the change counter has been incremented
+ * @return false 	The MSD is the same as before
  */
-uint8_t app_mode_ble_act_adv_msd_update(uint8_t* p_msd) {
+bool app_mode_ble_act_adv_msd_update(uint8_t* p_msd) {
+	uint8_t msd_prev[LEN_BLE_MSD_MAX];
+	(void)memcpy(msd_prev, p_msd, LEN_BLE_MSD_MAX);
+
 	static uint16_t dvdd_div4;
 	static uint16_t batt[2];
 	static uint16_t imp[2];
@@ -181,7 +196,67 @@ uint8_t app_mode_ble_act_adv_msd_update(uint8_t* p_msd) {
 		buff_offset[1] &= (uint8_t)(~(1U << 7));
 	}
 
-	return ((uint8_t)(buff_offset - p_msd));
+	/* Status layout, after the BLE ID */
+	uint8_t therapy = (uint8_t)(wpt_state & MSD_THERAPY_MODE_MASK);
+	if (app_mode_therapy_confirm()) {
+		therapy |= MSD_THERAPY_ACTIVE;
+	}
+	if (schd_therapy_enable) {
+		therapy |= MSD_THERAPY_SCHEDULED;
+	}
+	if (vnsb_en) {
+		therapy |= MSD_THERAPY_VNSB;
+	}
+
+	uint16_t imp_ohm = 0U;
+	uint8_t imp_faults = app_mode_impedance_test_last_get(&imp_ohm);
+	uint8_t faults = 0U;
+	if ((imp_faults & IMP_FAULT_SHORT_CIRCUIT) != 0U) {
+		faults |= MSD_FAULT_SHORT_CIRCUIT;
+	}
+	if ((imp_faults & IMP_FAULT_HIGH_IMPED) != 0U) {
+		faults |= MSD_FAULT_HIGH_IMPED;
+	}
+	if (app_mode_battery_test_er_get()) {
+		faults |= MSD_FAULT_BATT_ER;
+	}
+	if (HAL_GPIO_ReadPin(CHG1_OVP_ERRn_GPIO_Port, CHG1_OVP_ERRn_Pin) == GPIO_PIN_RESET) {
+		faults |= MSD_FAULT_CHG1_OVP;
+	}
+	if (HAL_GPIO_ReadPin(CHG2_OVP_ERRn_GPIO_Port, CHG2_OVP_ERRn_Pin) == GPIO_PIN_RESET) {
+		faults |= MSD_FAULT_CHG2_OVP;
+	}
+	if (HAL_GPIO_ReadPin(VRECT_OVPn_GPIO_Port, VRECT_OVPn_Pin) == GPIO_PIN_RESET) {
+		faults |= MSD_FAULT_VRECT_OVP;
+	}
+
+	//The thermistor table starts at MSD_TEMP_BASE_C, so anything below is an unpowered thermistor
+	float temp_c = app_mode_wpt_calc_temperature(threm[0], threm[1], threm[2]);
+	uint8_t temp = MSD_TEMP_INVALID;
+	if (temp_c >= MSD_TEMP_BASE_C) {
+		temp = (uint8_t)((temp_c - MSD_TEMP_BASE_C) * 4.0f + 0.5f);
+		if (temp_c > WPT_THERM_PAUSE_THRESHOLD_C) {
+			faults |= MSD_FAULT_OVER_TEMP;
+		}
+	}
+	if (wpt_paused) {
+		faults |= MSD_FAULT_WPT_PAUSED;
+	}
+
+	p_msd[MSD_IDX_LAYOUT_VERSION] 	= MSD_LAYOUT_VERSION;
+	p_msd[MSD_IDX_THERAPY] 			= therapy;
+	p_msd[MSD_IDX_BATT_A] 			= app_mode_ble_act_msd_batt_get(batt[0]);
+	p_msd[MSD_IDX_BATT_B] 			= app_mode_ble_act_msd_batt_get(batt[1]);
+	p_msd[MSD_IDX_IMPED] 			= (uint8_t)(imp_ohm & 0xFFU);
+	p_msd[MSD_IDX_IMPED + 1U] 		= (uint8_t)(imp_ohm >> 8);
+	p_msd[MSD_IDX_TEMP] 			= temp;
+	p_msd[MSD_IDX_FAULTS] 			= faults;
+
+	if (memcmp(msd_prev, p_msd, LEN_BLE_MSD_MAX) == 0) {
+		return false;
+	}
+	p_msd[MSD_IDX_CHANGE_COUNT]++;
+	return true;
 }
 
 /**
@@ -212,21 +287,21 @@ void app_mode_ble_act_handler(void) {
 	_Float64 adv_timeout_f = 0.0;
 
 	uint8_t bleid_len = app_func_para_datalen_get((const uint8_t*)HPID_IPG_BLE_ID);
-	uint8_t offset = app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
+	(void)app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
 
 	app_func_para_data_get((const uint8_t*)BPID_BLE_PASSKEY, setting.advance.passkey, (uint8_t)sizeof(setting.advance.passkey));
 	app_func_para_data_get((const uint8_t*)BPID_BLE_WHITELIST, &setting.advance.whitelist_enable, (uint8_t)sizeof(setting.advance.whitelist_enable));
 	app_func_para_data_get((const uint8_t*)HPID_BLE_BROADCAST_TIMEOUT, (uint8_t*)&adv_timeout_f, (uint8_t)sizeof(adv_timeout_f));
-	app_func_para_data_get((const uint8_t*)HPID_IPG_BLE_ID, (uint8_t*)(&setting.msd[offset]), bleid_len);
+	app_func_para_data_get((const uint8_t*)HPID_IPG_BLE_ID, (uint8_t*)(&setting.msd[MSD_IDX_BLE_ID]), bleid_len);
 	app_func_para_data_get((const uint8_t*)BPID_BLE_COMPANY_ID, setting.companyid, (uint8_t)sizeof(setting.companyid));
 
 	uint32_t adv_timeout = (uint32_t)adv_timeout_f;
 	uint32_t passkey_timeout = adv_timeout / 2U;
 
 	(void)memcpy((uint8_t*)setting.passkey_timeout, (uint8_t*)&passkey_timeout, sizeof(uint32_t));
-	(void)memcpy((uint8_t*)setting.adv_timeout, (uint8_t*)&msd_update_interval_s, sizeof(uint32_t));
+	(void)memcpy((uint8_t*)setting.adv_timeout, (uint8_t*)&adv_timeout, sizeof(uint32_t));
 
-	setting.msd[LEN_BLE_MSD_MAX - 1] = HW_VERSION;
+	setting.msd[MSD_IDX_HW_VERSION] = HW_VERSION;
 
 	if (app_func_ble_is_default()) {
 		app_func_para_defdata_get((const uint8_t*)BPID_BLE_PASSKEY, (uint8_t*)setting.advance.passkey);
@@ -235,12 +310,14 @@ void app_mode_ble_act_handler(void) {
 
 	app_func_ble_enable(true);
 	uint8_t curr_ble_state = app_func_ble_curr_state_get();
-	app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
+	(void)app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
 	app_func_ble_adv_start(&setting);
 	while(!bsp_sp_cmd_handler()) {
 		HAL_Delay(1);
 	}
 	adv_ms_timer = adv_timeout * 1000U;
+	msd_ms_timer = msd_update_interval_s * 1000U;
+	bool msd_pending = false;
 	while((curr_ble_state != BLE_STATE_ADV_START) && (adv_ms_timer > 0U)) {
 		bsp_wdg_refresh();
 		app_func_ble_new_state_get();
@@ -267,14 +344,30 @@ void app_mode_ble_act_handler(void) {
 				active_disconnect = false;
 			}
 			else {
-				app_func_ble_new_state_get();
+				//The MSD is measured every interval but only sent when it changed
+				if ((msd_ms_timer == 0U) && (curr_ble_state == BLE_STATE_ADV_START)) {
+					msd_pending |= app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
+					msd_ms_timer = msd_update_interval_s * 1000U;
+				}
+				//The MSD is swapped in the running advertising, so it stays in its current phase
+				if (msd_pending && (curr_ble_state == BLE_STATE_ADV_START)) {
+					app_func_ble_adv_msd_update(&setting);
+					msd_pending = false;
+				}
+				else {
+					app_func_ble_new_state_get();
+				}
 			}
 			bsp_sp_cmd_handler();
 			HAL_Delay(50);
 			curr_ble_state = app_func_ble_curr_state_get();
 			if (curr_ble_state == BLE_STATE_ADV_STOP) {
-				app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
+				uint32_t adv_remain_s = (adv_ms_timer / 1000U) + 1U;
+				(void)memcpy((uint8_t*)setting.adv_timeout, (uint8_t*)&adv_remain_s, sizeof(uint32_t));
+				(void)app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
 				app_func_ble_adv_start(&setting);
+				msd_ms_timer = msd_update_interval_s * 1000U;
+				msd_pending = false;
 				while(!bsp_sp_cmd_handler()) {
 					HAL_Delay(1);
 				}
@@ -301,4 +394,7 @@ void app_mode_ble_act_timer_cb(void) {
 	if (adv_ms_timer > 0U) {
 		adv_ms_timer--;
 	}
+	if (msd_ms_timer > 0U) {
+		msd_ms_timer--;
+	}
 }
@@ -12,6 +12,10 @@
 
 #define BLE_ACCESS_TIME_MS	1000
 
+#define LEN_SENSOR_VOLTAGE_FREQ	5U		/*!< The payload length of MEASURE_SENSOR_VOLTAGE with the sampling frequency specified */
+
+#define PARA_BATCH_NUM_MAX	(LEN_REQ_PAYLOAD_MAX / (LEN_ID + 1U))	/*!< The maximum number of parameters in a batch, each with at least 1 byte of data */
+
 int32_t idle_connection_ms_timer = -1;
 int32_t disconnect_request_ms_timer = -1;
 
@@ -27,700 +31,923 @@ static bool sens_en = false;
 static uint8_t sensor_resp_payload[LEN_RESP_PAYLOAD_MAX];
 static Cmd_Resp_t sensor_resp;
 
-extern bool vnsb_en;
+static RTC_TimeTypeDef rtc_time;
+static RTC_DateTypeDef rtc_date;
 
-/**
- * @brief Parser for request commands in BLE connection mode, used to communicate with the remote end
- * 
- * @param req Request command to be parsed
- * @return Cmd_Resp_t The response command to be replied after parsing the request command
- */
-static Cmd_Resp_t app_mode_ble_conn_cmd_parser(Cmd_Req_t req) {
-	Cmd_Resp_t resp = {
-			.Opcode 		= req.Opcode,
-			.Status 		= STATUS_SUCCESS,
-			.Payload 		= NULL,
-			.PayloadLen 	= 0,
-	};
-	uint8_t len_payload_min = 0;
-	uint8_t len_payload_max = 0;
-	uint8_t	user_class_cmd = 0;
+static const uint8_t* para_batch_ids[PARA_BATCH_NUM_MAX];
+static const uint8_t* para_batch_datas[PARA_BATCH_NUM_MAX];
+static _Float64 para_batch_vals[PARA_BATCH_NUM_MAX];
 
-	uint8_t user_class = app_mode_ble_act_userclass_get();
+static uint16_t survey_imp_matrix[IMP_SURVEY_PAIR_NUM];	/*!< The impedance survey is measured here and copied to the payload, which is not aligned for uint16_t */
 
-	app_func_para_data_get((const uint8_t*)HPID_BLE_IDLE_CONNECTION, (uint8_t*)&ble_idle_connection_f, (uint8_t)sizeof(ble_idle_connection_f));
-	ble_idle_connection_f *= 1000.0;
-	idle_connection_ms_timer = (int32_t)ble_idle_connection_f;
+extern bool vnsb_en;
 
-	static RTC_TimeTypeDef rtc_time;
-	static RTC_DateTypeDef rtc_date;
-	static uint8_t resp_payload[LEN_RESP_PAYLOAD_MAX];
+/**
+ * @brief Check whether the user class can access the parameter
+ *
+ * @param p_id Parameter ID
+ * @param user_class The user class of the remote end
+ * @return true The hardware parameter is accessed by the admin, or the stimulation parameter is accessed by the clinician or admin
+ * @return false The parameter cannot be accessed
+ */
+static bool app_mode_ble_conn_para_access_check(const uint8_t* p_id, uint8_t user_class) {
+	if (memcmp(p_id, (uint8_t*)HPID_PREFIX, 2) == 0) {
+		return (user_class >= USER_CLASS_ADMIN);
+	}
+	if ((memcmp(p_id, (uint8_t*)SPID_PREFIX, 2) == 0) || (memcmp(p_id, (uint8_t*)SPID_PREFIX_ST, 2) == 0)) {
+		return (user_class >= USER_CLASS_CLINICIAN);
+	}
+	return false;
+}
 
-	switch(req.Opcode) {
-	case OP_SET_START_STATE:
-	{
-		len_payload_min = 2;
-		len_payload_max = 2;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
+/**
+ * @brief Put the parameter ID and its data into the response payload
+ *
+ * @param profile The index of the therapy profile, or THERAPY_PROFILE_ACTIVE
+ * @param p_id Parameter ID
+ * @param p_buff The buffer of the response payload
+ * @param buff_size The size of the buffer
+ * @return uint8_t The length put into the buffer, 0 if the parameter is invalid or does not fit
+ */
+static uint8_t app_mode_ble_conn_para_encode(uint8_t profile, const uint8_t* p_id, uint8_t* p_buff, uint8_t buff_size) {
+	uint8_t datatype = app_func_para_datatype_get(p_id);
+	uint8_t len = 0;
+
+	if (datatype == FORMAT_TYPE_RAWDATA) {
+		uint8_t datalen = app_func_para_datalen_get(p_id);
+		if (buff_size >= (LEN_ID + datalen)) {
+			(void)memcpy(p_buff, p_id, LEN_ID);
+			app_func_para_profile_data_get(profile, p_id, &p_buff[LEN_ID], datalen);
+			len = LEN_ID + datalen;
 		}
-		else {
-			uint16_t state = STATE_INVALID;
-			(void)memcpy((void*)&state, (void*)req.Payload, sizeof(uint16_t));
-			switch(state) {
-			case STATE_SLEEP:
-			case STATE_ACT:
-			case STATE_ACT_MODE_BLE_ACT:
-			case STATE_ACT_MODE_THERAPY_SESSION:
-			case STATE_ACT_MODE_IMPED_TEST:
-			case STATE_ACT_MODE_BATT_TEST:
-			case STATE_ACT_MODE_DVT:
-			{
-				Sys_Config_t sc = {
-						.DefaultState = DEFAULT_STATE,
-						.StartState = state,
-				};
-				bsp_fram_write(ADDR_SYS_CONFIG, (uint8_t*)&sc, sizeof(sc), true);
-				sw_reset = true;
-			}	break;
-
-			default:
-			{
-				resp.Status = STATUS_INVALID;
-			}
-				break;
-			}
+	}
+	else if (datatype == FORMAT_TYPE_VALUE) {
+		if (buff_size >= (LEN_ID + LEN_STEP)) {
+			_Float64 val = 0.0;
+			app_func_para_profile_data_get(profile, p_id, (uint8_t*)&val, (uint8_t)sizeof(val));
+			_Float64 stepsize = app_func_para_stepsize_get(p_id);
+			_Float64 step_f = val / stepsize;
+			uint16_t step = (uint16_t)step_f;
+			(void)memcpy(p_buff, p_id, LEN_ID);
+			(void)memcpy((void*)&p_buff[LEN_ID], (void*)&step, LEN_STEP);
+			len = LEN_ID + (uint8_t)LEN_STEP;
 		}
 	}
-		break;
+	else {
+		len = 0;
+	}
+	return len;
+}
 
-	case OP_READ_BLE_ADVANCE:
+/**
+ * @brief Handler for the command "SET_START_STATE"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_set_start_state(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint16_t state = STATE_INVALID;
+	(void)memcpy((void*)&state, (void*)p_req->Payload, sizeof(uint16_t));
+	switch(state) {
+	case STATE_SLEEP:
+	case STATE_ACT:
+	case STATE_ACT_MODE_BLE_ACT:
+	case STATE_ACT_MODE_THERAPY_SESSION:
+	case STATE_ACT_MODE_IMPED_TEST:
+	case STATE_ACT_MODE_BATT_TEST:
+	case STATE_ACT_MODE_DVT:
 	{
-		len_payload_min = 0;
-		len_payload_max = 0;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			BLE_Advance_t* p_advance = (BLE_Advance_t*)resp_payload;
-			app_func_para_data_get((const uint8_t*)BPID_BLE_PASSKEY, p_advance->passkey, (uint8_t)sizeof(p_advance->passkey));
-			app_func_para_data_get((const uint8_t*)BPID_BLE_WHITELIST, &p_advance->whitelist_enable, (uint8_t)sizeof(p_advance->whitelist_enable));
+		Sys_Config_t sc = {
+				.DefaultState = DEFAULT_STATE,
+				.StartState = state,
+		};
+		bsp_fram_write(ADDR_SYS_CONFIG, (uint8_t*)&sc, sizeof(sc), true);
+		sw_reset = true;
+	}	break;
 
-			resp.PayloadLen = (uint8_t)sizeof(BLE_Advance_t);
-			resp.Payload = resp_payload;
-		}
-	}
-		break;
-
-	case OP_WRITE_BLE_ADVANCE:
+	default:
 	{
-		len_payload_min = (uint8_t)sizeof(BLE_Advance_t);
-		len_payload_max = (uint8_t)sizeof(BLE_Advance_t);
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			BLE_Advance_t advance;
-			(void)memcpy((void*)&advance, (void*)req.Payload, sizeof(BLE_Advance_t));
-			app_func_para_data_set((const uint8_t*)BPID_BLE_PASSKEY, advance.passkey);
-			app_func_para_data_set((const uint8_t*)BPID_BLE_WHITELIST, &advance.whitelist_enable);
-		}
+		p_resp->Status = STATUS_INVALID;
 	}
 		break;
+	}
+}
 
-	case OP_AUTH_FW_IMAGE:
-	{
-		len_payload_min = (uint8_t)sizeof(ECDSA_Data_t);
-		len_payload_max = (uint8_t)sizeof(ECDSA_Data_t);
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			ECDSA_Data_t data;
-			(void)memcpy((void*)&data, (void*)req.Payload, sizeof(ECDSA_Data_t));
-			if (app_func_auth_verify_sign_admin(data) == false) {
-				resp.Status = STATUS_INVALID;
-			}
-			else {
-				app_func_sm_current_state_set(STATE_ACT_MODE_OAD);
-			}
-		}
+/**
+ * @brief Handler for the command "READ_BLE_ADVANCE"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_read_ble_advance(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* resp_payload = p_resp->Payload;
+	BLE_Advance_t* p_advance = (BLE_Advance_t*)resp_payload;
+	app_func_para_data_get((const uint8_t*)BPID_BLE_PASSKEY, p_advance->passkey, (uint8_t)sizeof(p_advance->passkey));
+	app_func_para_data_get((const uint8_t*)BPID_BLE_WHITELIST, &p_advance->whitelist_enable, (uint8_t)sizeof(p_advance->whitelist_enable));
+
+	p_resp->PayloadLen = (uint8_t)sizeof(BLE_Advance_t);
+}
+
+/**
+ * @brief Handler for the command "WRITE_BLE_ADVANCE"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_write_ble_advance(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	BLE_Advance_t advance;
+	(void)memcpy((void*)&advance, (void*)p_req->Payload, sizeof(BLE_Advance_t));
+	app_func_para_data_set((const uint8_t*)BPID_BLE_PASSKEY, advance.passkey);
+	app_func_para_data_set((const uint8_t*)BPID_BLE_WHITELIST, &advance.whitelist_enable);
+}
+
+/**
+ * @brief Handler for the command "AUTH_FW_IMAGE"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_auth_fw_image(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	ECDSA_Data_t data;
+	(void)memcpy((void*)&data, (void*)p_req->Payload, sizeof(ECDSA_Data_t));
+	if (app_func_auth_verify_sign_admin(data) == false) {
+		p_resp->Status = STATUS_INVALID;
 	}
-		break;
+	else {
+		app_func_sm_current_state_set(STATE_ACT_MODE_OAD);
+	}
+}
 
-	case OP_SHUTDOWN_SYSTEM:
-	{
-		len_payload_min = 0;
-		len_payload_max = 0;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			app_func_logs_event_write(EVENT_SHUTDOWN, NULL);
-			app_func_sm_current_state_set(STATE_SHUTDOWN);
-		}
+/**
+ * @brief Handler for the command "SHUTDOWN_SYSTEM"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_shutdown_system(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_logs_event_write(EVENT_SHUTDOWN, NULL);
+	app_func_sm_current_state_set(STATE_SHUTDOWN);
+}
+
+/**
+ * @brief Handler for the command "REBOOT_SYSTEM"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_reboot_system(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_sm_current_state_set(STATE_ACT_MODE_BSL);
+}
+
+/**
+ * @brief Handler for the command "BLE_DISCONNECT_REQUEST"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_ble_disconnect_request(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	_Float64 ble_disconnect_request_f = 0.0;
+	app_func_para_data_get((const uint8_t*)HPID_BLE_DISCONNECT_REQUEST, (uint8_t*)&ble_disconnect_request_f, (uint8_t)sizeof(ble_disconnect_request_f));
+	ble_disconnect_request_f *= 1000.0;
+	disconnect_request_ms_timer = (int32_t)ble_disconnect_request_f;
+}
+
+/**
+ * @brief Handler for the command "START_SCHED_THERAPY_SESSION"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_start_sched_therapy_session(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	if (p_req->PayloadLen == 1U)
+		vnsb_en = (p_req->Payload[0] > 0)?true:false;
+	else
+		vnsb_en = false;
+
+	app_func_sm_schd_therapy_enable(true);
+}
+
+/**
+ * @brief Handler for the command "END_SCHED_THERAPY_SESSION"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_end_sched_therapy_session(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_sm_schd_therapy_enable(false);
+}
+
+/**
+ * @brief Handler for the command "START_MANUAL_THERAPY_SESSION"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_start_manual_therapy_session(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	if (p_req->PayloadLen == 1U)
+		vnsb_en = (p_req->Payload[0] > 0)?true:false;
+	else
+		vnsb_en = false;
+
+	if (app_func_job_is_running() || (app_mode_therapy_start() != true)) {
+		p_resp->Status = STATUS_INVALID;
 	}
-		break;
+	else {
+		app_func_sm_schd_therapy_enable(false);
 
-	case OP_REBOOT_SYSTEM:
-	{
-		len_payload_min = 0;
-		len_payload_max = 0;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			app_func_sm_current_state_set(STATE_ACT_MODE_BSL);
-		}
+		stim_en = true;
 	}
-		break;
+}
 
-	case OP_BLE_DISCONNECT_REQUEST:
-	{
-		len_payload_min = 0;
-		len_payload_max = 0;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			_Float64 ble_disconnect_request_f = 0.0;
-			app_func_para_data_get((const uint8_t*)HPID_BLE_DISCONNECT_REQUEST, (uint8_t*)&ble_disconnect_request_f, (uint8_t)sizeof(ble_disconnect_request_f));
-			ble_disconnect_request_f *= 1000.0;
-			disconnect_request_ms_timer = (int32_t)ble_disconnect_request_f;
-		}
+/**
+ * @brief Handler for the command "STOP_MANUAL_THERAPY_SESSION"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_stop_manual_therapy_session(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_mode_therapy_stop();
+	stim_en = false;
+}
+
+/**
+ * @brief Handler for the command "MEASURE_IMPEDANCE"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_measure_impedance(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* resp_payload = p_resp->Payload;
+	if (sens_en || app_func_job_is_running()) {
+		p_resp->Status = STATUS_INVALID;
 	}
-		break;
+	else {
+		app_func_sm_schd_therapy_enable(false);
 
-	case OP_START_SCHED_THERAPY_SESSION:
-	{
-		len_payload_min = 0;
-		len_payload_max = 1;
-		user_class_cmd = USER_CLASS_PATIENT;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			if (req.PayloadLen == len_payload_max)
-				vnsb_en = (req.Payload[0] > 0)?true:false;
-			else
-				vnsb_en = false;
+		uint16_t* p_imp = (uint16_t*)resp_payload;
+		*p_imp = (uint16_t)app_mode_impedance_test_get();
 
-			app_func_sm_schd_therapy_enable(true);
-		}
+		p_resp->PayloadLen = (uint8_t)sizeof(uint16_t);
 	}
-		break;
+}
 
-	case OP_END_SCHED_THERAPY_SESSION:
-	{
-		len_payload_min = 0;
-		len_payload_max = 0;
-		user_class_cmd = USER_CLASS_PATIENT;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			app_func_sm_schd_therapy_enable(false);
-		}
+/**
+ * @brief Handler for the command "MEASURE_IMPEDANCE_SURVEY"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_measure_impedance_survey(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* resp_payload = p_resp->Payload;
+	if (sens_en || app_func_job_is_running()) {
+		p_resp->Status = STATUS_INVALID;
 	}
-		break;
+	else {
+		app_func_sm_schd_therapy_enable(false);
 
-	case OP_START_MANUAL_THERAPY_SESSION:
-	{
-		len_payload_min = 0;
-		len_payload_max = 1;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			if (req.PayloadLen == len_payload_max)
-				vnsb_en = (req.Payload[0] > 0)?true:false;
-			else
-				vnsb_en = false;
+		uint8_t pair_num = app_mode_impedance_test_survey(survey_imp_matrix);
+		(void)memcpy(resp_payload, (uint8_t*)survey_imp_matrix, pair_num * sizeof(uint16_t));
 
-			if (app_mode_therapy_start() != true) {
-				resp.Status = STATUS_INVALID;
-			}
-			else {
-				app_func_sm_schd_therapy_enable(false);
+		p_resp->PayloadLen = (uint8_t)(pair_num * sizeof(uint16_t));
+	}
+}
 
-				stim_en = true;
-			}
-		}
+/**
+ * @brief Handler for the command "MEASURE_BATTERY_VOLTAGE"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_measure_battery_voltage(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* resp_payload = p_resp->Payload;
+	if (sens_en || app_func_job_is_running()) {
+		p_resp->Status = STATUS_INVALID;
 	}
-		break;
+	else {
+		uint16_t* p_vbatA = (uint16_t*)resp_payload;
+		uint16_t* p_vbatB = &p_vbatA[1];
+		app_mode_battery_test_volt_get(p_vbatA, p_vbatB);
 
-	case OP_STOP_MANUAL_THERAPY_SESSION:
-	{
-		len_payload_min = 0;
-		len_payload_max = 0;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			app_mode_therapy_stop();
-			stim_en = false;
-		}
+		p_resp->PayloadLen = (uint8_t)(sizeof(uint16_t) + sizeof(uint16_t));
 	}
-		break;
+}
 
-	case OP_MEASURE_IMPEDANCE:
-	{
-		len_payload_min = 0;
-		len_payload_max = 0;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else if (sens_en) {
-			resp.Status = STATUS_INVALID;
+/**
+ * @brief Handler for the command "MEASURE_SENSOR_VOLTAGE"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_measure_sensor_voltage(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	//The payload is the sensor ID, optionally followed by the sampling frequency, so only 1 or 5 bytes are valid
+	uint8_t sensorID = p_req->Payload[0];
+	float specifySamplingFrequency = 0.0;
+	if (p_req->PayloadLen == LEN_SENSOR_VOLTAGE_FREQ) {
+		memcpy(&specifySamplingFrequency, &p_req->Payload[1], sizeof(float));
+	}
+
+	if ((p_req->PayloadLen != 1U) && (p_req->PayloadLen != LEN_SENSOR_VOLTAGE_FREQ)) {
+		p_resp->Status = STATUS_PAYLOAD_LEN_ERR;
+	}
+	else if ((p_req->PayloadLen == LEN_SENSOR_VOLTAGE_FREQ) && (specifySamplingFrequency < 1.5f || specifySamplingFrequency > 6553.5f)) {
+		p_resp->Status = STATUS_INVALID;
+	}
+	else {
+		uint16_t samplingFrequency_hz;
+		uint8_t* buff = &sensor_resp_payload[1];
+		sensor_resp_payload[0] = 0U;
+		uint8_t bufferSize = SAMPLE_POINTS * sizeof(uint16_t);
+
+		if (app_func_job_is_running() && (sensorID != SENSOR_ID_IDLE)) {
+		    p_resp->Status = STATUS_INVALID;
+		}
+		else if (sensorID == SENSOR_ID_ECG_HR || sensorID == SENSOR_ID_ECG_RR || sensorID == SENSOR_ID_ENG1 || sensorID == SENSOR_ID_ENG2) {
+		    sens_en = true;
+	        if (specifySamplingFrequency == 0.0) {
+			    samplingFrequency_hz = (sensorID == SENSOR_ID_ENG1 || sensorID == SENSOR_ID_ENG2) ? SAMPLE_FREQ_ENG : SAMPLE_FREQ_ECG;
+	        }
+	        else {
+	        	samplingFrequency_hz = (uint16_t)specifySamplingFrequency;
+	        }
+	        app_func_meas_vdda_sup_enable(true);
+		    app_func_meas_sensor_enable(sensorID, true);
+		    app_func_meas_sensor_sampling(sensorID, buff, bufferSize, samplingFrequency_hz);
+
+		    p_resp->PayloadLen = bufferSize + 1U;
+		    p_resp->Payload = sensor_resp_payload;
+		    sensor_resp = *p_resp;
+		}
+		else if (sensorID == SENSOR_ID_IDLE) {
+		    sens_en = false;
+		    app_func_meas_vdda_sup_enable(false);
+		    app_func_meas_sensor_enable(SENSOR_ID_ECG_HR, false);
+		    app_func_meas_sensor_enable(SENSOR_ID_ECG_RR, false);
+		    app_func_meas_sensor_enable(SENSOR_ID_ENG1, false);
+		    app_func_meas_sensor_enable(SENSOR_ID_ENG2, false);
 		}
 		else {
-			app_func_sm_schd_therapy_enable(false);
-
-			uint16_t* p_imp = (uint16_t*)resp_payload;
-			*p_imp = (uint16_t)app_mode_impedance_test_get();
-
-			resp.PayloadLen = (uint8_t)sizeof(uint16_t);
-			resp.Payload = resp_payload;
+		    p_resp->Status = STATUS_INVALID;
 		}
 	}
-		break;
+}
 
-	case OP_MEASURE_BATTERY_VOLTAGE:
-	{
-		len_payload_min = 0;
-		len_payload_max = 0;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else if (sens_en) {
-			resp.Status = STATUS_INVALID;
+/**
+ * @brief Handler for the commands "READ_HARDWARE_PARAMETERS" and "READ_STIMULATION_PARAMETERS"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_read_parameters(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t* parameter_id = p_req->Payload;
+	(void)memcpy(resp_payload, parameter_id, LEN_ID);
+
+	if (p_req->Opcode == OP_READ_HARDWARE_PARAMETERS &&
+			memcmp(parameter_id, (uint8_t*)HPID_PREFIX, 2) != 0) {
+		p_resp->Status = STATUS_INVALID;
+	}
+	else if (p_req->Opcode == OP_READ_STIMULATION_PARAMETERS &&
+			memcmp(parameter_id, (uint8_t*)SPID_PREFIX, 2) != 0 &&
+			memcmp(parameter_id, (uint8_t*)SPID_PREFIX_ST, 2) != 0) {
+		p_resp->Status = STATUS_INVALID;
+	}
+	else {
+		uint8_t len = app_mode_ble_conn_para_encode(THERAPY_PROFILE_ACTIVE, (const uint8_t*)parameter_id, resp_payload, (uint8_t)LEN_RESP_PAYLOAD_MAX);
+		if (len == 0U) {
+			p_resp->Status = STATUS_INVALID;
 		}
 		else {
-			uint16_t* p_vbatA = (uint16_t*)resp_payload;
-			uint16_t* p_vbatB = &p_vbatA[1];
-			app_mode_battery_test_volt_get(p_vbatA, p_vbatB);
-
-			resp.PayloadLen = (uint8_t)(sizeof(uint16_t) + sizeof(uint16_t));
-			resp.Payload = resp_payload;
+			p_resp->PayloadLen = len;
 		}
 	}
-		break;
+}
 
-	case OP_MEASURE_SENSOR_VOLTAGE:
-	{
-		len_payload_min = 1;
-		len_payload_max = 5;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen != len_payload_min) && (req.PayloadLen != len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			uint8_t sensorID = req.Payload[0];
-			float specifySamplingFrequency = 0.0;
-			if (req.PayloadLen == len_payload_max) {
-				memcpy(&specifySamplingFrequency, &req.Payload[1], sizeof(float));
-				if (specifySamplingFrequency < 1.5f || specifySamplingFrequency > 6553.5f) {
-					resp.Status = STATUS_INVALID;
-					break;
-				}
-			}
+/**
+ * @brief Handler for the commands "READ_PARAMETERS_BATCH" and "READ_THERAPY_PROFILE"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_read_parameters_batch(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	//Request: ID1, ID2, ... Response: ID1, data1, ID2, data2, ... with the same data format as the single parameter read.
+	//READ_THERAPY_PROFILE has the index of the therapy profile before the IDs in both request and response,
+	//only the stimulation parameters can be read, and THERAPY_PROFILE_ACTIVE refers to the active profile.
+	uint8_t* resp_payload = p_resp->Payload;
+	uint8_t user_class = app_mode_ble_act_userclass_get();
+	uint8_t len_profile = (p_req->Opcode == OP_READ_THERAPY_PROFILE) ? 1U : 0U;
+	uint8_t profile = (len_profile > 0U) ? p_req->Payload[0] : THERAPY_PROFILE_ACTIVE;
 
-			uint16_t samplingFrequency_hz;
-			uint8_t* buff = &sensor_resp_payload[1];
-			sensor_resp_payload[0] = 0U;
-			uint8_t bufferSize = SAMPLE_POINTS * sizeof(uint16_t);
-
-			if (sensorID == SENSOR_ID_ECG_HR || sensorID == SENSOR_ID_ECG_RR || sensorID == SENSOR_ID_ENG1 || sensorID == SENSOR_ID_ENG2) {
-			    sens_en = true;
-		        if (specifySamplingFrequency == 0.0) {
-				    samplingFrequency_hz = (sensorID == SENSOR_ID_ENG1 || sensorID == SENSOR_ID_ENG2) ? SAMPLE_FREQ_ENG : SAMPLE_FREQ_ECG;
-		        }
-		        else {
-		        	samplingFrequency_hz = (uint16_t)specifySamplingFrequency;
-		        }
-		        app_func_meas_vdda_sup_enable(true);
-			    app_func_meas_sensor_enable(sensorID, true);
-			    app_func_meas_sensor_sampling(sensorID, buff, bufferSize, samplingFrequency_hz);
-
-			    resp.PayloadLen = bufferSize + 1U;
-			    resp.Payload = sensor_resp_payload;
-			    sensor_resp = resp;
-			}
-			else if (sensorID == SENSOR_ID_IDLE) {
-			    sens_en = false;
-			    app_func_meas_vdda_sup_enable(false);
-			    app_func_meas_sensor_enable(SENSOR_ID_ECG_HR, false);
-			    app_func_meas_sensor_enable(SENSOR_ID_ECG_RR, false);
-			    app_func_meas_sensor_enable(SENSOR_ID_ENG1, false);
-			    app_func_meas_sensor_enable(SENSOR_ID_ENG2, false);
+	if (((p_req->PayloadLen - len_profile) % LEN_ID) != 0U) {
+		p_resp->Status = STATUS_PAYLOAD_LEN_ERR;
+	}
+	else if ((profile >= THERAPY_PROFILE_NUM) && (profile != THERAPY_PROFILE_ACTIVE)) {
+		p_resp->Status = STATUS_INVALID;
+	}
+	else {
+		uint8_t len_resp = 0;
+		if (len_profile > 0U) {
+			resp_payload[0] = (profile == THERAPY_PROFILE_ACTIVE) ? app_func_para_profile_get() : profile;
+			len_resp = len_profile;
+		}
+		for(uint8_t i=len_profile;(i<p_req->PayloadLen) && (p_resp->Status == STATUS_SUCCESS);i+=LEN_ID) {
+			const uint8_t* parameter_id = &p_req->Payload[i];
+			if ((app_mode_ble_conn_para_access_check(parameter_id, user_class) == false) ||
+					(app_func_para_datatype_get(parameter_id) == FORMAT_TYPE_INVALID) ||
+					((len_profile > 0U) && (app_func_para_profile_contains(parameter_id) == false))) {
+				p_resp->Status = STATUS_INVALID;
 			}
 			else {
-			    resp.Status = STATUS_INVALID;
+				uint8_t len = app_mode_ble_conn_para_encode(profile, parameter_id, &resp_payload[len_resp], (uint8_t)(LEN_RESP_PAYLOAD_MAX - len_resp));
+				if (len == 0U) {
+					p_resp->Status = STATUS_PAYLOAD_LEN_ERR;
+				}
+				len_resp += len;
 			}
 		}
-	}
-		break;
-
-	case OP_READ_HARDWARE_PARAMETERS:
-	case OP_READ_STIMULATION_PARAMETERS:
-	{
-		len_payload_min = LEN_ID;
-		len_payload_max = LEN_ID;
-		user_class_cmd = USER_CLASS_ADMIN;
-
-		if (req.Opcode == OP_READ_STIMULATION_PARAMETERS) {
-			user_class_cmd = USER_CLASS_CLINICIAN;
+		if (p_resp->Status == STATUS_SUCCESS) {
+			p_resp->PayloadLen = len_resp;
 		}
+	}
+}
 
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			uint8_t* parameter_id = req.Payload;
-			(void)memcpy(resp_payload, parameter_id, LEN_ID);
+/**
+ * @brief Handler for the commands "WRITE_HARDWARE_PARAMETERS" and "WRITE_STIMULATION_PARAMETERS"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_write_parameters(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* parameter_id = p_req->Payload;
+	uint8_t* p_data = NULL;
 
-			if (req.Opcode == OP_READ_HARDWARE_PARAMETERS &&
-					memcmp(parameter_id, (uint8_t*)HPID_PREFIX, 2) != 0) {
-				resp.Status = STATUS_INVALID;
+	if (p_req->Opcode == OP_WRITE_HARDWARE_PARAMETERS &&
+			memcmp(parameter_id, (uint8_t*)HPID_PREFIX, 2) != 0) {
+		p_resp->Status = STATUS_INVALID;
+	}
+	else if (p_req->Opcode == OP_WRITE_STIMULATION_PARAMETERS &&
+			memcmp(parameter_id, (uint8_t*)SPID_PREFIX, 2) != 0 &&
+			memcmp(parameter_id, (uint8_t*)SPID_PREFIX_ST, 2) != 0) {
+		p_resp->Status = STATUS_INVALID;
+	}
+	else {
+		uint8_t datatype = app_func_para_datatype_get((const uint8_t*)parameter_id);
+		if (p_req->PayloadLen == LEN_ID) {
+			app_func_para_data_set((const uint8_t*)parameter_id, NULL);
+		}
+		else if (datatype == FORMAT_TYPE_RAWDATA) {
+			uint8_t datalen = app_func_para_datalen_get((const uint8_t*)parameter_id);
+			if (p_req->PayloadLen != (LEN_ID + datalen)) {
+				p_resp->Status = STATUS_PAYLOAD_LEN_ERR;
 			}
-			else if (req.Opcode == OP_READ_STIMULATION_PARAMETERS &&
-					memcmp(parameter_id, (uint8_t*)SPID_PREFIX, 2) != 0 &&
-					memcmp(parameter_id, (uint8_t*)SPID_PREFIX_ST, 2) != 0) {
-				resp.Status = STATUS_INVALID;
+			else {
+				p_data = &p_req->Payload[LEN_ID];
+				app_func_para_data_set((const uint8_t*)parameter_id, p_data);
+				app_func_logs_parameter_write(parameter_id, FORMAT_TYPE_RAWDATA, p_data, datalen);
+			}
+		}
+		else if (datatype == FORMAT_TYPE_VALUE) {
+			if (p_req->PayloadLen != (LEN_ID + LEN_STEP)) {
+				p_resp->Status = STATUS_PAYLOAD_LEN_ERR;
 			}
 			else {
-				uint8_t datatype = app_func_para_datatype_get((const uint8_t*)parameter_id);
-				if (datatype == FORMAT_TYPE_RAWDATA) {
-					app_func_para_data_get((const uint8_t*)parameter_id, &resp_payload[LEN_ID], (uint8_t)(LEN_RESP_PAYLOAD_MAX - LEN_ID));
-					resp.PayloadLen = LEN_ID + app_func_para_datalen_get((const uint8_t*)parameter_id);;
-					resp.Payload = resp_payload;
-				}
-				else if (datatype == FORMAT_TYPE_VALUE) {
-					_Float64 val = 0.0;
-					app_func_para_data_get((const uint8_t*)parameter_id, (uint8_t*)&val, (uint8_t)sizeof(val));
-					_Float64 stepsize = app_func_para_stepsize_get((const uint8_t*)parameter_id);
-					_Float64 step_f = val / stepsize;
-					uint16_t step = (uint16_t)step_f;
-					(void)memcpy((void*)&resp_payload[LEN_ID], (void*)&step, LEN_STEP);
-					resp.PayloadLen = LEN_ID + (uint8_t)LEN_STEP;
-					resp.Payload = resp_payload;
+				p_data = &p_req->Payload[LEN_ID];
+				uint16_t steps = 0U;
+				(void)memcpy((void*)&steps, (void*)p_data, sizeof(uint16_t));
+				_Float64 steps_f = (_Float64)steps;
+				_Float64 stepsize = app_func_para_stepsize_get((const uint8_t*)parameter_id);
+				_Float64 val = steps_f * stepsize;
+				if (app_func_para_val_in_range((const uint8_t*)parameter_id, val) == false) {
+					p_resp->Status = STATUS_INVALID;
 				}
 				else {
-					resp.Status = STATUS_INVALID;
+					app_func_para_data_set((const uint8_t*)parameter_id, (uint8_t*)&val);
+					app_func_logs_parameter_write(parameter_id, FORMAT_TYPE_VALUE, (uint8_t*)&val, (uint16_t)LEN_FORMAT_VALUE);
 				}
 			}
 		}
+		else {
+			p_resp->Status = STATUS_INVALID;
+		}
 	}
-		break;
-
-	case OP_WRITE_HARDWARE_PARAMETERS:
-	case OP_WRITE_STIMULATION_PARAMETERS:
-	{
-		len_payload_min = LEN_ID;
-		len_payload_max = LEN_REQ_PAYLOAD_MAX;
-		user_class_cmd = USER_CLASS_ADMIN;
+}
 
-		if (req.Opcode == OP_WRITE_STIMULATION_PARAMETERS) {
-			user_class_cmd = USER_CLASS_CLINICIAN;
-		}
+/**
+ * @brief Handler for the commands "WRITE_PARAMETERS_BATCH" and "WRITE_THERAPY_PROFILE"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_write_parameters_batch(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	//Request: ID1, data1, ID2, data2, ... with the same data format as the single parameter write.
+	//WRITE_THERAPY_PROFILE has the index of the therapy profile before the IDs, and only the stimulation parameters can be written.
+	//The whole batch is checked before any parameter is written.
+	uint8_t user_class = app_mode_ble_act_userclass_get();
+	uint8_t len_profile = (p_req->Opcode == OP_WRITE_THERAPY_PROFILE) ? 1U : 0U;
+	uint8_t profile = (len_profile > 0U) ? p_req->Payload[0] : THERAPY_PROFILE_ACTIVE;
 
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			uint8_t* parameter_id = req.Payload;
-			uint8_t* p_data = NULL;
+	if ((profile >= THERAPY_PROFILE_NUM) && (profile != THERAPY_PROFILE_ACTIVE)) {
+		p_resp->Status = STATUS_INVALID;
+	}
+	else {
+		uint8_t num = 0;
+		uint8_t offset = len_profile;
+		while ((offset < p_req->PayloadLen) && (p_resp->Status == STATUS_SUCCESS)) {
+			const uint8_t* parameter_id = &p_req->Payload[offset];
+			uint8_t datatype = FORMAT_TYPE_INVALID;
+			uint8_t datalen = 0;
+			if ((p_req->PayloadLen - offset) > LEN_ID) {
+				datatype = app_func_para_datatype_get(parameter_id);
+				datalen = (datatype == FORMAT_TYPE_VALUE) ? (uint8_t)LEN_STEP : app_func_para_datalen_get(parameter_id);
+			}
 
-			if (req.Opcode == OP_WRITE_HARDWARE_PARAMETERS &&
-					memcmp(parameter_id, (uint8_t*)HPID_PREFIX, 2) != 0) {
-				resp.Status = STATUS_INVALID;
+			if ((p_req->PayloadLen - offset) <= LEN_ID) {
+				p_resp->Status = STATUS_PAYLOAD_LEN_ERR;
 			}
-			else if (req.Opcode == OP_WRITE_STIMULATION_PARAMETERS &&
-					memcmp(parameter_id, (uint8_t*)SPID_PREFIX, 2) != 0 &&
-					memcmp(parameter_id, (uint8_t*)SPID_PREFIX_ST, 2) != 0) {
-				resp.Status = STATUS_INVALID;
+			else if ((app_mode_ble_conn_para_access_check(parameter_id, user_class) == false) || (datatype == FORMAT_TYPE_INVALID) ||
+					((len_profile > 0U) && (app_func_para_profile_contains(parameter_id) == false))) {
+				p_resp->Status = STATUS_INVALID;
 			}
-			else {
-				uint8_t datatype = app_func_para_datatype_get((const uint8_t*)parameter_id);
-				if (req.PayloadLen == LEN_ID) {
-					app_func_para_data_set((const uint8_t*)parameter_id, NULL);
-				}
-				else if (datatype == FORMAT_TYPE_RAWDATA) {
-					uint8_t datalen = app_func_para_datalen_get((const uint8_t*)parameter_id);
-					if (req.PayloadLen != (LEN_ID + datalen)) {
-						resp.Status = STATUS_PAYLOAD_LEN_ERR;
-					}
-					else {
-						p_data = &req.Payload[LEN_ID];
-						app_func_para_data_set((const uint8_t*)parameter_id, p_data);
-						app_func_logs_parameter_write(parameter_id, FORMAT_TYPE_RAWDATA, p_data, datalen);
-					}
+			else if ((num >= PARA_BATCH_NUM_MAX) || ((p_req->PayloadLen - offset - LEN_ID) < datalen)) {
+				p_resp->Status = STATUS_PAYLOAD_LEN_ERR;
+			}
+			else if (datatype == FORMAT_TYPE_VALUE) {
+				uint16_t steps = 0U;
+				(void)memcpy((void*)&steps, (void*)&p_req->Payload[offset + LEN_ID], sizeof(uint16_t));
+				_Float64 steps_f = (_Float64)steps;
+				_Float64 stepsize = app_func_para_stepsize_get(parameter_id);
+				para_batch_vals[num] = steps_f * stepsize;
+				if (app_func_para_val_in_range(parameter_id, para_batch_vals[num]) == false) {
+					p_resp->Status = STATUS_INVALID;
 				}
-				else if (datatype == FORMAT_TYPE_VALUE) {
-					if (req.PayloadLen != (LEN_ID + LEN_STEP)) {
-						resp.Status = STATUS_PAYLOAD_LEN_ERR;
-					}
-					else {
-						p_data = &req.Payload[LEN_ID];
-						uint16_t steps = 0U;
-						(void)memcpy((void*)&steps, (void*)p_data, sizeof(uint16_t));
-						_Float64 steps_f = (_Float64)steps;
-						_Float64 stepsize = app_func_para_stepsize_get((const uint8_t*)parameter_id);
-						_Float64 val = steps_f * stepsize;
-						if (app_func_para_val_in_range((const uint8_t*)parameter_id, val) == false) {
-							resp.Status = STATUS_INVALID;
-						}
-						else {
-							app_func_para_data_set((const uint8_t*)parameter_id, (uint8_t*)&val);
-							app_func_logs_parameter_write(parameter_id, FORMAT_TYPE_VALUE, (uint8_t*)&val, (uint16_t)LEN_FORMAT_VALUE);
-						}
-					}
+				para_batch_datas[num] = (uint8_t*)&para_batch_vals[num];
+			}
+			else {
+				para_batch_datas[num] = &p_req->Payload[offset + LEN_ID];
+			}
+			para_batch_ids[num] = parameter_id;
+			num++;
+			offset += LEN_ID + datalen;
+		}
+
+		if (p_resp->Status == STATUS_SUCCESS) {
+			app_func_para_profile_data_set_batch(profile, para_batch_ids, para_batch_datas, num);
+			for(uint8_t i=0;i<num;i++) {
+				if (app_func_para_datatype_get(para_batch_ids[i]) == FORMAT_TYPE_VALUE) {
+					app_func_logs_parameter_write((uint8_t*)para_batch_ids[i], FORMAT_TYPE_VALUE, para_batch_datas[i], (uint16_t)LEN_FORMAT_VALUE);
 				}
 				else {
-					resp.Status = STATUS_INVALID;
+					app_func_logs_parameter_write((uint8_t*)para_batch_ids[i], FORMAT_TYPE_RAWDATA, para_batch_datas[i], app_func_para_datalen_get(para_batch_ids[i]));
 				}
 			}
 		}
 	}
-		break;
+}
 
-	case OP_READ_IPG_LOG:
-	{
-		len_payload_min = 7;
-		len_payload_max = 7;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			resp.PayloadLen = app_func_logs_read(req.Payload, resp_payload);
-			resp.Payload = resp_payload;
-		}
+/**
+ * @brief Handler for the command "SELECT_THERAPY_PROFILE"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_select_therapy_profile(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	//The stimulation parameters of the selected therapy profile are used from the next therapy start
+	if (app_func_para_profile_select(p_req->Payload[0]) == false) {
+		p_resp->Status = STATUS_INVALID;
 	}
-		break;
+}
 
-	case OP_ERASE_IPG_LOG:
-	{
-		len_payload_min = 0;
-		len_payload_max = 0;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			app_func_logs_erase();
-		}
-	}
-		break;
+/**
+ * @brief Handler for the command "READ_IPG_LOG"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_read_ipg_log(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* resp_payload = p_resp->Payload;
+	p_resp->PayloadLen = app_func_logs_read(p_req->Payload, resp_payload);
+}
 
-	case OP_READ_TIME_AND_DATE:
-	{
-		len_payload_min = 0;
-		len_payload_max = 0;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			HAL_ERROR_CHECK(HAL_RTC_GetTime(&hrtc, &rtc_time, RTC_FORMAT_BIN));
-			HAL_ERROR_CHECK(HAL_RTC_GetDate(&hrtc, &rtc_date, RTC_FORMAT_BIN));
-			uint8_t date_time[6] = {rtc_date.Year, rtc_date.Month, rtc_date.Date, rtc_time.Hours, rtc_time.Minutes, rtc_time.Seconds};
-			resp.PayloadLen = (uint8_t)sizeof(date_time);
-			resp.Payload = (uint8_t*)date_time;
-		}
+/**
+ * @brief Handler for the command "ERASE_IPG_LOG"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_erase_ipg_log(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_logs_erase();
+}
+
+/**
+ * @brief Handler for the command "READ_TIME_AND_DATE"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_read_time_and_date(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	HAL_ERROR_CHECK(HAL_RTC_GetTime(&hrtc, &rtc_time, RTC_FORMAT_BIN));
+	HAL_ERROR_CHECK(HAL_RTC_GetDate(&hrtc, &rtc_date, RTC_FORMAT_BIN));
+	uint8_t* date_time = p_resp->Payload;
+	date_time[0] = rtc_date.Year;
+	date_time[1] = rtc_date.Month;
+	date_time[2] = rtc_date.Date;
+	date_time[3] = rtc_time.Hours;
+	date_time[4] = rtc_time.Minutes;
+	date_time[5] = rtc_time.Seconds;
+	p_resp->PayloadLen = 6U;
+}
+
+/**
+ * @brief Handler for the command "WRITE_TIME_AND_DATE"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_write_time_and_date(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	if(!IS_RTC_YEAR(*(p_req->Payload)))
+		p_resp->Status = STATUS_INVALID;
+
+	if(!IS_RTC_MONTH(*(p_req->Payload + 1)))
+		p_resp->Status = STATUS_INVALID;
+
+	if(!IS_RTC_DATE(*(p_req->Payload + 2)))
+		p_resp->Status = STATUS_INVALID;
+
+	if(!IS_RTC_HOUR24(*(p_req->Payload + 3)))
+		p_resp->Status = STATUS_INVALID;
+
+	if(!IS_RTC_MINUTES(*(p_req->Payload + 4)))
+		p_resp->Status = STATUS_INVALID;
+
+	if(!IS_RTC_SECONDS(*(p_req->Payload + 5)))
+		p_resp->Status = STATUS_INVALID;
+
+	if (p_resp->Status == STATUS_SUCCESS) {
+		rtc_date.Year 		= p_req->Payload[0];
+		rtc_date.Month 		= p_req->Payload[1];
+		rtc_date.Date 		= p_req->Payload[2];
+		rtc_time.Hours 		= p_req->Payload[3];
+		rtc_time.Minutes 	= p_req->Payload[4];
+		rtc_time.Seconds 	= p_req->Payload[5];
+		HAL_ERROR_CHECK(HAL_RTC_SetTime(&hrtc, &rtc_time, RTC_FORMAT_BIN));
+		HAL_ERROR_CHECK(HAL_RTC_SetDate(&hrtc, &rtc_date, RTC_FORMAT_BIN));
 	}
-		break;
+}
 
-	case OP_WRITE_TIME_AND_DATE:
-	{
-		len_payload_min = 6;
-		len_payload_max = 6;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			if(!IS_RTC_YEAR(*(req.Payload)))
-				resp.Status = STATUS_INVALID;
+/**
+ * @brief Handler for the command "START_ACC"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_start_acc(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* resp_payload = p_resp->Payload;
+	FreqModeDeviceID_t freqModedeviceID = {
+			.FreqSampling = p_req->Payload[0],
+			.ModeDeviceID = p_req->Payload[1],
+	};
 
-			if(!IS_RTC_MONTH(*(req.Payload + 1)))
-				resp.Status = STATUS_INVALID;
+	p_resp->Status = app_mode_dvt_acc_start(freqModedeviceID, (uint8_t*)resp_payload, &p_resp->PayloadLen);
+}
 
-			if(!IS_RTC_DATE(*(req.Payload + 2)))
-				resp.Status = STATUS_INVALID;
+/**
+ * @brief Handler for the command "GET_DATA_ACC"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_get_data_acc(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* resp_payload = p_resp->Payload;
+	DeviceID_t deviceID = {
+			.DeviceID = p_req->Payload[0],
+	};
 
-			if(!IS_RTC_HOUR24(*(req.Payload + 3)))
-				resp.Status = STATUS_INVALID;
+	p_resp->Status = app_mode_dvt_acc_data_get(deviceID, (uint8_t*)resp_payload, &p_resp->PayloadLen);
+}
 
-			if(!IS_RTC_MINUTES(*(req.Payload + 4)))
-				resp.Status = STATUS_INVALID;
+/**
+ * @brief Handler for the command "STOP_ACC"
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_stop_acc(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint8_t* resp_payload = p_resp->Payload;
+	DeviceID_t deviceID = {
+			.DeviceID = p_req->Payload[0],
+	};
 
-			if(!IS_RTC_SECONDS(*(req.Payload + 5)))
-				resp.Status = STATUS_INVALID;
+	p_resp->PayloadLen = sizeof(DeviceID_t);
+	p_resp->Status = app_mode_dvt_acc_stop(deviceID, (uint8_t*)resp_payload, &p_resp->PayloadLen);
+}
 
-			if (resp.Status == STATUS_SUCCESS) {
-				rtc_date.Year 		= req.Payload[0];
-				rtc_date.Month 		= req.Payload[1];
-				rtc_date.Date 		= req.Payload[2];
-				rtc_time.Hours 		= req.Payload[3];
-				rtc_time.Minutes 	= req.Payload[4];
-				rtc_time.Seconds 	= req.Payload[5];
-				HAL_ERROR_CHECK(HAL_RTC_SetTime(&hrtc, &rtc_time, RTC_FORMAT_BIN));
-				HAL_ERROR_CHECK(HAL_RTC_SetDate(&hrtc, &rtc_date, RTC_FORMAT_BIN));
-			}
-		}
-	}
-		break;
+/**
+ * @brief Job step for the command "MEASURE_IMPEDANCE", the impedance is measured in a single step
+ *
+ * @param p_result The result of the job
+ * @param p_progress The progress of the job, unit: %
+ * @return true The job is finished
+ * @return false The job needs more steps
+ */
+static bool app_mode_ble_conn_job_measure_impedance(Cmd_Resp_t* p_result, uint8_t* p_progress) {
+	uint16_t imp = (uint16_t)app_mode_impedance_test_get();
+	(void)memcpy(p_result->Payload, (uint8_t*)&imp, sizeof(imp));
+	p_result->PayloadLen = (uint8_t)sizeof(uint16_t);
+	return true;
+}
 
-	case OP_START_ACC:
-	{
-		len_payload_min = 2;
-		len_payload_max = 2;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			FreqModeDeviceID_t freqModedeviceID = {
-					.FreqSampling = req.Payload[0],
-					.ModeDeviceID = req.Payload[1],
-			};
-
-			uint8_t resp_payload[sizeof(AccMeasure_t)];
-			resp.Status = app_mode_dvt_acc_start(freqModedeviceID, (uint8_t*)resp_payload, &resp.PayloadLen);
-			resp.Payload = resp_payload;
-		}
+/**
+ * @brief Job step for the command "MEASURE_IMPEDANCE_SURVEY", one electrode pair is measured in each step
+ *
+ * @param p_result The result of the job
+ * @param p_progress The progress of the job, unit: %
+ * @return true The job is finished
+ * @return false The job needs more steps
+ */
+static bool app_mode_ble_conn_job_measure_impedance_survey(Cmd_Resp_t* p_result, uint8_t* p_progress) {
+	uint8_t pair_num = 0;
+	if (app_mode_impedance_test_survey_step(survey_imp_matrix, &pair_num, p_progress) == false) {
+		return false;
 	}
-		break;
-
-	case OP_GET_DATA_ACC:
-	{
-		len_payload_min = 1;
-		len_payload_max = 1;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
-		}
-		else {
-			DeviceID_t deviceID = {
-					.DeviceID = req.Payload[0],
-			};
+	(void)memcpy(p_result->Payload, (uint8_t*)survey_imp_matrix, pair_num * sizeof(uint16_t));
+	p_result->PayloadLen = (uint8_t)(pair_num * sizeof(uint16_t));
+	return true;
+}
 
-			uint8_t resp_payload[sizeof(InfoData_t)];
-			resp.Status = app_mode_dvt_acc_data_get(deviceID, (uint8_t*)resp_payload, &resp.PayloadLen);
-			resp.Payload = resp_payload;
-		}
+/**
+ * @brief Job step for the command "MEASURE_BATTERY_VOLTAGE", a slice of the samples is taken in each step
+ *
+ * @param p_result The result of the job
+ * @param p_progress The progress of the job, unit: %
+ * @return true The job is finished
+ * @return false The job needs more steps
+ */
+static bool app_mode_ble_conn_job_measure_battery_voltage(Cmd_Resp_t* p_result, uint8_t* p_progress) {
+	uint16_t vbat[2] = {0};
+	if (app_mode_battery_test_volt_step(&vbat[0], &vbat[1], p_progress) == false) {
+		return false;
 	}
-		break;
+	(void)memcpy(p_result->Payload, (uint8_t*)vbat, sizeof(vbat));
+	p_result->PayloadLen = (uint8_t)sizeof(vbat);
+	return true;
+}
 
-	case OP_STOP_ACC:
-	{
-		len_payload_min = 1;
-		len_payload_max = 1;
-		user_class_cmd = USER_CLASS_ADMIN;
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
-		}
-		else if (user_class < user_class_cmd) {
-			resp.Status = STATUS_USER_CLASS_ERR;
+/**
+ * @brief Handler for the commands "MEASURE_IMPEDANCE" and "MEASURE_IMPEDANCE_SURVEY" started as jobs
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_job_cmd_measure_impedance(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	if (sens_en) {
+		p_resp->Status = STATUS_INVALID;
+	}
+	else {
+		app_func_sm_schd_therapy_enable(false);
+		if (p_req->Opcode == OP_MEASURE_IMPEDANCE_SURVEY) {
+			app_func_job_start(p_req->Opcode, &app_mode_ble_conn_job_measure_impedance_survey, &app_mode_impedance_test_survey_abort, app_mode_ble_act_userclass_get(), p_resp);
 		}
 		else {
-			DeviceID_t deviceID = {
-					.DeviceID = req.Payload[0],
-			};
-
-			resp.PayloadLen = sizeof(DeviceID_t);
-			resp.Status = app_mode_dvt_acc_stop(deviceID, (uint8_t*)resp_payload, &resp.PayloadLen);
-			resp.Payload = resp_payload;
+			app_func_job_start(p_req->Opcode, &app_mode_ble_conn_job_measure_impedance, NULL, app_mode_ble_act_userclass_get(), p_resp);
 		}
 	}
-		break;
+}
 
-	default:
-	{
-		resp.Status = STATUS_OPCODE_ERR;
+/**
+ * @brief Handler for the command "MEASURE_BATTERY_VOLTAGE" started as a job
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_job_cmd_measure_battery_voltage(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	if (sens_en) {
+		p_resp->Status = STATUS_INVALID;
 	}
-		break;
+	else {
+		app_func_job_start(p_req->Opcode, &app_mode_ble_conn_job_measure_battery_voltage, &app_mode_battery_test_volt_abort, app_mode_ble_act_userclass_get(), p_resp);
 	}
+}
 
-	return resp;
+static const Cmd_Entry_t ble_conn_job_cmd_entries[] = {
+	[OP_MEASURE_IMPEDANCE - OP_MEASURE_IMPEDANCE] = {&app_mode_ble_conn_job_cmd_measure_impedance, 0, 0, USER_CLASS_ADMIN},
+	[OP_MEASURE_BATTERY_VOLTAGE - OP_MEASURE_IMPEDANCE] = {&app_mode_ble_conn_job_cmd_measure_battery_voltage, 0, 0, USER_CLASS_ADMIN},
+	[OP_MEASURE_IMPEDANCE_SURVEY - OP_MEASURE_IMPEDANCE] = {&app_mode_ble_conn_job_cmd_measure_impedance, 0, 0, USER_CLASS_ADMIN},
+};
+
+static const Cmd_Table_t ble_conn_job_cmd_tables[] = {
+	{ble_conn_job_cmd_entries, 	OP_MEASURE_IMPEDANCE, 	(uint8_t)(sizeof(ble_conn_job_cmd_entries) / sizeof(ble_conn_job_cmd_entries[0]))},
+};
+#define BLE_CONN_JOB_CMD_TABLE_NUM	((uint8_t)(sizeof(ble_conn_job_cmd_tables) / sizeof(ble_conn_job_cmd_tables[0])))
+
+/**
+ * @brief Handler for the command "JOB_START", the long-running command keeps its own user class
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_job_start(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_job_cmd_start(ble_conn_job_cmd_tables, BLE_CONN_JOB_CMD_TABLE_NUM, app_mode_ble_act_userclass_get(), p_req, p_resp);
+}
+
+/**
+ * @brief Handler for the command "JOB_STATUS", a job is only reported to the user class that started it or a higher one
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_job_status(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_job_cmd_status(app_mode_ble_act_userclass_get(), p_req, p_resp);
+}
+
+/**
+ * @brief Handler for the command "JOB_ABORT", a job is only aborted by the user class that started it or a higher one
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_ble_conn_cmd_job_abort(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	app_func_job_cmd_abort(app_mode_ble_act_userclass_get(), p_req, p_resp);
+}
+
+static const Cmd_Entry_t ble_conn_ipg_cmd_entries[] = {
+	[OP_SHUTDOWN_SYSTEM - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_shutdown_system, 0, 0, USER_CLASS_ADMIN},
+	[OP_REBOOT_SYSTEM - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_reboot_system, 0, 0, USER_CLASS_ADMIN},
+	[OP_BLE_DISCONNECT_REQUEST - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_ble_disconnect_request, 0, 0, USER_CLASS_ADMIN},
+	[OP_START_SCHED_THERAPY_SESSION - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_start_sched_therapy_session, 0, 1, USER_CLASS_PATIENT},
+	[OP_END_SCHED_THERAPY_SESSION - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_end_sched_therapy_session, 0, 0, USER_CLASS_PATIENT},
+	[OP_START_MANUAL_THERAPY_SESSION - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_start_manual_therapy_session, 0, 1, USER_CLASS_ADMIN},
+	[OP_STOP_MANUAL_THERAPY_SESSION - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_stop_manual_therapy_session, 0, 0, USER_CLASS_ADMIN},
+	[OP_MEASURE_IMPEDANCE - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_measure_impedance, 0, 0, USER_CLASS_ADMIN},
+	[OP_MEASURE_BATTERY_VOLTAGE - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_measure_battery_voltage, 0, 0, USER_CLASS_ADMIN},
+	[OP_MEASURE_SENSOR_VOLTAGE - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_measure_sensor_voltage, 1, LEN_SENSOR_VOLTAGE_FREQ, USER_CLASS_ADMIN},
+	[OP_READ_HARDWARE_PARAMETERS - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_read_parameters, LEN_ID, LEN_ID, USER_CLASS_ADMIN},
+	[OP_WRITE_HARDWARE_PARAMETERS - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_write_parameters, LEN_ID, LEN_REQ_PAYLOAD_MAX, USER_CLASS_ADMIN},
+	[OP_READ_STIMULATION_PARAMETERS - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_read_parameters, LEN_ID, LEN_ID, USER_CLASS_CLINICIAN},
+	[OP_WRITE_STIMULATION_PARAMETERS - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_write_parameters, LEN_ID, LEN_REQ_PAYLOAD_MAX, USER_CLASS_CLINICIAN},
+	[OP_READ_IPG_LOG - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_read_ipg_log, 7, 7, USER_CLASS_ADMIN},
+	[OP_ERASE_IPG_LOG - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_erase_ipg_log, 0, 0, USER_CLASS_ADMIN},
+	[OP_READ_TIME_AND_DATE - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_read_time_and_date, 0, 0, USER_CLASS_ADMIN},
+	[OP_WRITE_TIME_AND_DATE - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_write_time_and_date, 6, 6, USER_CLASS_ADMIN},
+	[OP_MEASURE_IMPEDANCE_SURVEY - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_measure_impedance_survey, 0, 0, USER_CLASS_ADMIN},
+	[OP_READ_PARAMETERS_BATCH - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_read_parameters_batch, LEN_ID, LEN_REQ_PAYLOAD_MAX, USER_CLASS_CLINICIAN},
+	[OP_WRITE_PARAMETERS_BATCH - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_write_parameters_batch, LEN_ID + 1U, LEN_REQ_PAYLOAD_MAX, USER_CLASS_CLINICIAN},
+	[OP_SELECT_THERAPY_PROFILE - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_select_therapy_profile, 1, 1, USER_CLASS_CLINICIAN},
+	[OP_READ_THERAPY_PROFILE - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_read_parameters_batch, 1U + LEN_ID, LEN_REQ_PAYLOAD_MAX, USER_CLASS_CLINICIAN},
+	[OP_WRITE_THERAPY_PROFILE - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_write_parameters_batch, 1U + LEN_ID + 1U, LEN_REQ_PAYLOAD_MAX, USER_CLASS_CLINICIAN},
+	[OP_JOB_START - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_job_start, 1, LEN_REQ_PAYLOAD_MAX, USER_CLASS_PATIENT},
+	[OP_JOB_STATUS - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_job_status, 1, 1, USER_CLASS_PATIENT},
+	[OP_JOB_ABORT - OP_SHUTDOWN_SYSTEM] = {&app_mode_ble_conn_cmd_job_abort, 1, 1, USER_CLASS_PATIENT},
+};
+
+static const Cmd_Entry_t ble_conn_sys_cmd_entries[] = {
+	[OP_READ_BLE_ADVANCE - OP_READ_BLE_ADVANCE] = {&app_mode_ble_conn_cmd_read_ble_advance, 0, 0, USER_CLASS_ADMIN},
+	[OP_WRITE_BLE_ADVANCE - OP_READ_BLE_ADVANCE] = {&app_mode_ble_conn_cmd_write_ble_advance, (uint8_t)sizeof(BLE_Advance_t), (uint8_t)sizeof(BLE_Advance_t), USER_CLASS_ADMIN},
+	[OP_AUTH_FW_IMAGE - OP_READ_BLE_ADVANCE] = {&app_mode_ble_conn_cmd_auth_fw_image, (uint8_t)sizeof(ECDSA_Data_t), (uint8_t)sizeof(ECDSA_Data_t), USER_CLASS_ADMIN},
+	[OP_SET_START_STATE - OP_READ_BLE_ADVANCE] = {&app_mode_ble_conn_cmd_set_start_state, 2, 2, USER_CLASS_ADMIN},
+};
+
+static const Cmd_Entry_t ble_conn_acc_cmd_entries[] = {
+	[OP_START_ACC - OP_START_ACC] = {&app_mode_ble_conn_cmd_start_acc, 2, 2, USER_CLASS_ADMIN},
+	[OP_GET_DATA_ACC - OP_START_ACC] = {&app_mode_ble_conn_cmd_get_data_acc, 1, 1, USER_CLASS_ADMIN},
+	[OP_STOP_ACC - OP_START_ACC] = {&app_mode_ble_conn_cmd_stop_acc, 1, 1, USER_CLASS_ADMIN},
+};
+
+static const Cmd_Table_t ble_conn_cmd_tables[] = {
+	{ble_conn_ipg_cmd_entries, 	OP_SHUTDOWN_SYSTEM, 	(uint8_t)(sizeof(ble_conn_ipg_cmd_entries) / sizeof(ble_conn_ipg_cmd_entries[0]))},
+	{ble_conn_sys_cmd_entries, 	OP_READ_BLE_ADVANCE, 	(uint8_t)(sizeof(ble_conn_sys_cmd_entries) / sizeof(ble_conn_sys_cmd_entries[0]))},
+	{ble_conn_acc_cmd_entries, 	OP_START_ACC, 			(uint8_t)(sizeof(ble_conn_acc_cmd_entries) / sizeof(ble_conn_acc_cmd_entries[0]))},
+};
+#define BLE_CONN_CMD_TABLE_NUM	((uint8_t)(sizeof(ble_conn_cmd_tables) / sizeof(ble_conn_cmd_tables[0])))
+
+/**
+ * @brief Parser for request commands in BLE connection mode, used to communicate with the remote end
+ * 
+ * @param p_req Request command to be parsed
+ * @param p_resp The response command to be replied after parsing the request command
+ */
+static void app_mode_ble_conn_cmd_parser(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	idle_connection_ms_timer = (int32_t)ble_idle_connection_f;
+	app_func_command_dispatch(ble_conn_cmd_tables, BLE_CONN_CMD_TABLE_NUM, app_mode_ble_act_userclass_get(), p_req, p_resp);
+}
+
+/**
+ * @brief Callback when the idle connection time changes
+ *
+ * @param p_id Parameter ID
+ */
+static void app_mode_ble_conn_para_change_cb(const uint8_t* p_id) {
+	app_func_para_data_get(p_id, (uint8_t*)&ble_idle_connection_f, (uint8_t)sizeof(ble_idle_connection_f));
+	ble_idle_connection_f *= 1000.0;
+	if (idle_connection_ms_timer > 0) {
+		idle_connection_ms_timer = (int32_t)ble_idle_connection_f;
+	}
+}
+
+/**
+ * @brief Initialization of BLE connection mode
+ *
+ */
+void app_mode_ble_conn_init(void) {
+	(void)app_func_para_subscribe((const uint8_t*)HPID_BLE_IDLE_CONNECTION, &app_mode_ble_conn_para_change_cb);
 }
 
 /**
@@ -732,8 +959,6 @@ void app_mode_ble_conn_handler(void) {
 	app_func_command_req_parser_set(&app_mode_ble_conn_cmd_parser);
 	uint8_t curr_ble_state = app_func_ble_curr_state_get();
 
-	app_func_para_data_get((const uint8_t*)HPID_BLE_IDLE_CONNECTION, (uint8_t*)&ble_idle_connection_f, (uint8_t)sizeof(ble_idle_connection_f));
-	ble_idle_connection_f *= 1000.0;
 	idle_connection_ms_timer = (int32_t)ble_idle_connection_f;
 	disconnect_request_ms_timer = -1;
 	ble_access_ms_timer = BLE_ACCESS_TIME_MS;
@@ -748,9 +973,12 @@ void app_mode_ble_conn_handler(void) {
 			app_func_sm_current_state_set(STATE_ACT);
 		}
 		else if (sens_en == true && bsp_adc_sampling_is_completed() == true) {
-			app_func_meas_sensor_continue();
-			sensor_resp_payload[0] = (sensor_resp_payload[0] + 1U) % 100U;
-			app_func_command_resp_send(sensor_resp);
+			//The next sampling waits until the previous data has been taken by the nRF52810
+			if (bsp_sp_cmd_is_pending() == false) {
+				app_func_meas_sensor_continue();
+				sensor_resp_payload[0] = (sensor_resp_payload[0] + 1U) % 100U;
+				app_func_command_resp_send(&sensor_resp);
+			}
 			idle_connection_ms_timer = (int32_t)ble_idle_connection_f;
 			bsp_sp_cmd_handler();
 		}
@@ -761,8 +989,18 @@ void app_mode_ble_conn_handler(void) {
 			}
 			ble_access_ms_timer = BLE_ACCESS_TIME_MS;
 		}
+		else if (app_func_job_handler()) {
+			//The commands are served between the steps of the job, so the remote end is never blocked by it
+			idle_connection_ms_timer = (int32_t)ble_idle_connection_f;
+			bsp_sp_cmd_handler();
+		}
+		else if (bsp_sp_cmd_is_requested()) {
+			//The commands are served as soon as the nRF52810 has them, the access time only paces the BLE state polling
+			bsp_sp_cmd_handler();
+		}
 
 		if (sw_reset) {
+			app_func_logs_flush();
 			HAL_NVIC_SystemReset();
 		}
 		curr_ble_state = app_func_ble_curr_state_get();
@@ -773,12 +1011,16 @@ void app_mode_ble_conn_handler(void) {
 		else if (curr_ble_state == BLE_STATE_ADV_STOP) {
 			app_func_logs_event_write(EVENT_BLE_DISCONNECT, NULL);
 			sens_en = false;
+			app_func_job_clear();
 			app_func_sm_current_state_set(STATE_ACT_MODE_BLE_ACT);
 		}
 		app_func_sm_active_eos_check();
 		curr_state = app_func_sm_current_state_get();
 	}
 
+	//A job never outlives the connection mode, its hardware is put back to idle and its result is not kept for the next remote end
+	app_func_job_clear();
+
 	/* ---- WPT entry cleanup -------------------------------------------------
 	 * If the VRECT EXTI fired while connected, the state is now WPT_HIGH.
 	 * Stop stimulation and sensors before returning, then wait for BLE to
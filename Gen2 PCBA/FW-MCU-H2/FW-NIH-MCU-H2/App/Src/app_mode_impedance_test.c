@@ -8,6 +8,7 @@
 
 #define IMP_MEAS_HV_SUPPLY_MV	4200U
 #define	IMP_MEAS_SAMPLE_FQ_HZ	50000U
+#define	IMP_SURVEY_SWITCH_SETTLE_MS	10U
 
 static Stimulus_Waveform_t parameters = {
 		.pulseWidth_us 			= 500,
@@ -20,29 +21,28 @@ static uint16_t impVoltageBufferA[ADC_MAX_SAMPLE_POINTS];
 static uint16_t impVoltageBufferB[ADC_MAX_SAMPLE_POINTS];
 
 static _Float64 impVoltage;
+static uint16_t imp_last_ohm = 0U;
+static uint8_t imp_last_faults = 0U;
+
+static uint8_t survey_snkP = 0U;		/*!< The anode electrode of the next pair of the survey, 0 if the survey is not started */
+static uint8_t survey_snkN = 0U;		/*!< The cathode electrode of the next pair of the survey */
+static uint8_t survey_pair_num = 0U;	/*!< The number of pairs measured by the survey */
+static uint16_t survey_dacVoltage_mv = 0U;
 
 #ifdef SWV_TRACE
 static uint16_t swvTrace = 0;
 #endif
 
 /**
- * @brief Measure, obtain and record impedance
- * 
- * @return _Float64 The impedance of the load, unit: ohm
+ * @brief Get the current source, STIM_SEL and IMP_SEL configuration of an electrode pair
+ *
+ * @param snkP_select The anode electrode number, 1 ~ IMP_ELECTRODE_NUM
+ * @param snkN_select The cathode electrode number, 1 ~ IMP_ELECTRODE_NUM
+ * @param p_configuration The current source configuration
+ * @param p_sel The STIM_SEL configuration
+ * @param p_imp_sel The IMP_SEL configuration, {n_sel0, n_sel1, n_sel2, p_sel}
  */
-_Float64 app_mode_impedance_test_get(void) {
-	_Float64 sns_cathode_electrode_number = 0.0;
-	_Float64 sns_anode_electrode_number = 0.0;
-	_Float64 max_safe_amplitude_mA = 0.0;
-
-	app_func_para_data_get((const uint8_t*)SPID_SNS_CATHODE_ELECTRODE_NUMBER, (uint8_t*)&sns_cathode_electrode_number, (uint8_t)sizeof(_Float64));
-	app_func_para_data_get((const uint8_t*)SPID_SNS_ANODE_ELECTRODE_NUMBER, (uint8_t*)&sns_anode_electrode_number, (uint8_t)sizeof(_Float64));
-	app_func_para_data_get((const uint8_t*)SPID_MAX_SAFE_AMPLITUDE, (uint8_t*)&max_safe_amplitude_mA, (uint8_t)sizeof(_Float64));
-
-	uint16_t dacVoltage_mv = (uint16_t)app_func_stim_iout_to_dac(max_safe_amplitude_mA);
-
-	uint8_t sns_snkP_select = (uint8_t)sns_anode_electrode_number;
-	uint8_t sns_snkN_select = (uint8_t)sns_cathode_electrode_number;
+static void app_mode_impedance_test_pair_config(uint8_t snkP_select, uint8_t snkN_select, Current_Sources_t* p_configuration, Stim_Sel_t* p_sel, bool* p_imp_sel) {
 	Current_Sources_t configuration = {
 			.src1 = true,
 			.src2 = false,
@@ -63,50 +63,50 @@ _Float64 app_mode_impedance_test_get(void) {
 			.sel_ch.ch4 	= STIM_SEL_CH4_SINK_CH4,
 	};
 
-	bool imp_n_sel0 = ((sns_snkN_select - 1) >> 0) & 0x01;
-	bool imp_n_sel1 = ((sns_snkN_select - 1) >> 1) & 0x01;
-	bool imp_n_sel2 = ((sns_snkN_select - 1) >> 2) & 0x01;
-	bool imp_p_sel  = IMPIN_P_STIMA;
+	p_imp_sel[0] = ((snkN_select - 1) >> 0) & 0x01;
+	p_imp_sel[1] = ((snkN_select - 1) >> 1) & 0x01;
+	p_imp_sel[2] = ((snkN_select - 1) >> 2) & 0x01;
+	p_imp_sel[3] = IMPIN_P_STIMA;
 
-	switch(sns_snkP_select) {
+	switch(snkP_select) {
 	case 1:
 		configuration.snk1 = true;
 		sel.stimA = STIMA_SEL_STIM1;
 		sel.stimB = STIMB_SEL_STIM2;
 		sel.sel_ch.ch1 = STIM_SEL_CH1_STIMA;
-		imp_p_sel  = IMPIN_P_STIMA;
+		p_imp_sel[3] = IMPIN_P_STIMA;
 		break;
 	case 2:
 		configuration.snk2 = true;
 		sel.stimA = STIMA_SEL_STIM1;
 		sel.stimB = STIMB_SEL_STIM2;
 		sel.sel_ch.ch2 = STIM_SEL_CH2_STIMA;
-		imp_p_sel  = IMPIN_P_STIMA;
+		p_imp_sel[3] = IMPIN_P_STIMA;
 		break;
 	case 3:
 		configuration.snk3 = true;
 		sel.stimA = STIMA_SEL_STIM2;
 		sel.stimB = STIMB_SEL_STIM1;
 		sel.sel_ch.ch3 = STIM_SEL_CH3_STIMB;
-		imp_p_sel  = IMPIN_P_STIMB;
+		p_imp_sel[3] = IMPIN_P_STIMB;
 		break;
 	case 4:
 		configuration.snk4 = true;
 		sel.stimA = STIMA_SEL_STIM2;
 		sel.stimB = STIMB_SEL_STIM1;
 		sel.sel_ch.ch4 = STIM_SEL_CH4_STIMB;
-		imp_p_sel  = IMPIN_P_STIMB;
+		p_imp_sel[3] = IMPIN_P_STIMB;
 		break;
 	case 5:
 		configuration.snk5 = true;
 		sel.stimA = STIMA_SEL_STIM1;
 		sel.stimB = STIMB_SEL_STIM2;
 		sel.sel_ch.encl = STIM_SEL_ENCL_STIMA;
-		imp_p_sel  = IMPIN_P_STIMA;
+		p_imp_sel[3] = IMPIN_P_STIMA;
 		break;
 	}
 
-	switch(sns_snkN_select) {
+	switch(snkN_select) {
 	case 1:
 		configuration.snk1 = true;
 		break;
@@ -124,11 +124,88 @@ _Float64 app_mode_impedance_test_get(void) {
 		break;
 	}
 
+	*p_configuration = configuration;
+	*p_sel = sel;
+}
+
+/**
+ * @brief Bring up the HV supply, VDDS supply and DAC used by the impedance measurement
+ *
+ * @param dacVoltage_mv The output voltage of DAC A, unit: mV
+ */
+static void app_mode_impedance_test_supply_on(uint16_t dacVoltage_mv) {
+	app_func_stim_hv_supply_set(true, true);
+	HAL_ERROR_CHECK(app_func_stim_hv_sup_volt_set((uint16_t)IMP_MEAS_HV_SUPPLY_MV));
+	app_func_stim_vdds_sup_enable(true);
+	HAL_Delay(100);
+
+	HAL_ERROR_CHECK(app_func_stim_dac_init());
+	HAL_ERROR_CHECK(app_func_stim_dac_volt_set(dacVoltage_mv, 0));
+}
+
+/**
+ * @brief Run the probe pulse train on the selected electrode pair and sample both impedance channels
+ *
+ * @param periodPoints The number of sampling points in a pulse period
+ * @param samplingFrequency_hz The sampling frequency, unit: Hz
+ */
+static void app_mode_impedance_test_pulse_meas(uint16_t periodPoints, uint16_t samplingFrequency_hz) {
+	memset(impVoltageBufferA, 0, sizeof(impVoltageBufferA));
+	memset(impVoltageBufferB, 0, sizeof(impVoltageBufferB));
+
+	app_func_stim_stim1_start(true);
+	HAL_Delay(parameters.trainOnDuration_ms);
+	app_func_stim_sync();
+	app_func_meas_imp_volt_meas(IMPIN_CH_P, impVoltageBufferA, periodPoints, samplingFrequency_hz);
+	app_func_stim_sync();
+	app_func_meas_imp_volt_meas(IMPIN_CH_N, impVoltageBufferB, periodPoints, samplingFrequency_hz);
+}
+
+/**
+ * @brief Saturate a calculated impedance to the range of uint16_t
+ *
+ * @param impedance The calculated impedance, unit: ohm
+ * @return uint16_t The impedance saturated at UINT16_MAX, 0 if it is not positive or not a number
+ */
+static uint16_t app_mode_impedance_test_ohm_saturate(_Float64 impedance) {
+	//A NaN fails every comparison, so it is caught by the first check before the cast.
+	if (!(impedance > 0.0)) {
+		return 0U;
+	}
+	else if (impedance >= (_Float64)UINT16_MAX) {
+		return UINT16_MAX;
+	}
+	else {
+		return (uint16_t)impedance;
+	}
+}
+
+/**
+ * @brief Measure, obtain and record impedance
+ * 
+ * @return _Float64 The impedance of the load, unit: ohm
+ */
+_Float64 app_mode_impedance_test_get(void) {
+	_Float64 sns_cathode_electrode_number = 0.0;
+	_Float64 sns_anode_electrode_number = 0.0;
+	_Float64 max_safe_amplitude_mA = 0.0;
+
+	app_func_para_data_get((const uint8_t*)SPID_SNS_CATHODE_ELECTRODE_NUMBER, (uint8_t*)&sns_cathode_electrode_number, (uint8_t)sizeof(_Float64));
+	app_func_para_data_get((const uint8_t*)SPID_SNS_ANODE_ELECTRODE_NUMBER, (uint8_t*)&sns_anode_electrode_number, (uint8_t)sizeof(_Float64));
+	app_func_para_data_get((const uint8_t*)SPID_MAX_SAFE_AMPLITUDE, (uint8_t*)&max_safe_amplitude_mA, (uint8_t)sizeof(_Float64));
+
+	uint16_t dacVoltage_mv = (uint16_t)app_func_stim_iout_to_dac(max_safe_amplitude_mA);
+
+	uint8_t sns_snkP_select = (uint8_t)sns_anode_electrode_number;
+	uint8_t sns_snkN_select = (uint8_t)sns_cathode_electrode_number;
+	Current_Sources_t configuration;
+	Stim_Sel_t sel;
+	bool imp_sel[4];
+	app_mode_impedance_test_pair_config(sns_snkP_select, sns_snkN_select, &configuration, &sel, imp_sel);
+
 	uint16_t samplingFrequency_hz = IMP_MEAS_SAMPLE_FQ_HZ;
 	uint16_t periodPoints = app_func_meas_imp_sampPoints_get(samplingFrequency_hz, parameters.pulsePeriod_us);
 	uint16_t pulsePoints = app_func_meas_imp_sampPoints_get(samplingFrequency_hz, parameters.pulseWidth_us);
-	memset(impVoltageBufferA, 0, sizeof(impVoltageBufferA));
-	memset(impVoltageBufferB, 0, sizeof(impVoltageBufferB));
 
 	bsp_wdg_refresh();
 	app_func_stim_off();
@@ -137,30 +214,19 @@ _Float64 app_mode_impedance_test_get(void) {
 	app_func_stim_curr_src_set(configuration);
 	app_func_stim_circuit_para1_set(parameters);
 
-	app_func_stim_hv_supply_set(true, true);
-	HAL_ERROR_CHECK(app_func_stim_hv_sup_volt_set((uint16_t)IMP_MEAS_HV_SUPPLY_MV));
-	app_func_stim_vdds_sup_enable(true);
-	HAL_Delay(100);
-
-	HAL_ERROR_CHECK(app_func_stim_dac_init());
-	HAL_ERROR_CHECK(app_func_stim_dac_volt_set(dacVoltage_mv, 0));
+	app_mode_impedance_test_supply_on(dacVoltage_mv);
 
 	app_func_stim_sel_set(sel);
 	app_func_stim_stimulus_enable(true);
 
-	app_func_meas_imp_sel_set(imp_n_sel0, imp_n_sel1, imp_n_sel2, imp_p_sel);
+	app_func_meas_imp_sel_set(imp_sel[0], imp_sel[1], imp_sel[2], imp_sel[3]);
 	app_func_meas_imp_enable(true);
 
 	HAL_Delay(100);
 	bsp_wdg_refresh();
 
 	app_func_stim_mux_enable(true);
-	app_func_stim_stim1_start(true);
-	HAL_Delay(parameters.trainOnDuration_ms);
-	app_func_stim_sync();
-	app_func_meas_imp_volt_meas(IMPIN_CH_P, impVoltageBufferA, periodPoints, samplingFrequency_hz);
-	app_func_stim_sync();
-	app_func_meas_imp_volt_meas(IMPIN_CH_N, impVoltageBufferB, periodPoints, samplingFrequency_hz);
+	app_mode_impedance_test_pulse_meas(periodPoints, samplingFrequency_hz);
 	app_func_stim_off();
 	app_func_meas_imp_enable(false);
 
@@ -188,10 +254,130 @@ _Float64 app_mode_impedance_test_get(void) {
 
 	_Float64 impedance = app_func_meas_imp_calc(dacVoltage_mv, impVoltage);
 	app_func_logs_imped_write((uint32_t)impedance);
+	imp_last_ohm = app_mode_impedance_test_ohm_saturate(impedance);
 
 	return impedance;
 }
 
+/**
+ * @brief Measure the impedance of every electrode pair one step at a time, the first step powers up and each next step measures one pair
+ *
+ * @param p_imp_matrix The impedance of each pair, unit: ohm, saturated at UINT16_MAX, kept between the steps.
+ * 			The pairs are ordered (1,2),(1,3),...,(1,5),(2,3),...,(4,5), IMP_SURVEY_PAIR_NUM entries in total.
+ * @param p_pair_num The number of pairs measured, valid when the survey is finished
+ * @param p_progress The progress of the survey, unit: %
+ * @return true The survey is finished and recorded as a single log
+ * @return false The survey needs more steps
+ */
+bool app_mode_impedance_test_survey_step(uint16_t* p_imp_matrix, uint8_t* p_pair_num, uint8_t* p_progress) {
+	uint16_t samplingFrequency_hz = IMP_MEAS_SAMPLE_FQ_HZ;
+	uint16_t periodPoints = app_func_meas_imp_sampPoints_get(samplingFrequency_hz, parameters.pulsePeriod_us);
+	uint16_t pulsePoints = app_func_meas_imp_sampPoints_get(samplingFrequency_hz, parameters.pulseWidth_us);
+
+	bsp_wdg_refresh();
+	if (survey_snkP == 0U) {
+		_Float64 max_safe_amplitude_mA = 0.0;
+		app_func_para_data_get((const uint8_t*)SPID_MAX_SAFE_AMPLITUDE, (uint8_t*)&max_safe_amplitude_mA, (uint8_t)sizeof(_Float64));
+		survey_dacVoltage_mv = (uint16_t)app_func_stim_iout_to_dac(max_safe_amplitude_mA);
+
+		app_func_stim_off();
+		HAL_Delay(100);
+
+		//The supplies, DAC and multiplexer stay up for the whole survey, only the switch matrix changes between pairs.
+		app_mode_impedance_test_supply_on(survey_dacVoltage_mv);
+		app_func_stim_stimulus_enable(true);
+		app_func_meas_imp_enable(true);
+		HAL_Delay(100);
+		app_func_stim_mux_enable(true);
+
+		survey_snkP = 1U;
+		survey_snkN = 2U;
+		survey_pair_num = 0U;
+		*p_progress = 0U;
+		return false;
+	}
+
+	Current_Sources_t configuration;
+	Stim_Sel_t sel;
+	bool imp_sel[4];
+	app_mode_impedance_test_pair_config(survey_snkP, survey_snkN, &configuration, &sel, imp_sel);
+
+	//Stopping stim1 clears its waveform settings, so they are reloaded for every pair.
+	app_func_stim_stim1_stop();
+	app_func_stim_curr_src_set(configuration);
+	app_func_stim_circuit_para1_set(parameters);
+	app_func_stim_sel_set(sel);
+	app_func_meas_imp_sel_set(imp_sel[0], imp_sel[1], imp_sel[2], imp_sel[3]);
+	HAL_Delay(IMP_SURVEY_SWITCH_SETTLE_MS);
+
+	app_mode_impedance_test_pulse_meas(periodPoints, samplingFrequency_hz);
+	app_func_stim_stim1_stop();
+
+	_Float64 impVoltageA = app_func_meas_imp_volt_calc(impVoltageBufferA, periodPoints, pulsePoints);
+	_Float64 impVoltageB = app_func_meas_imp_volt_calc(impVoltageBufferB, periodPoints, pulsePoints);
+	_Float64 impedance = app_func_meas_imp_calc(survey_dacVoltage_mv, impVoltageA + impVoltageB);
+
+	p_imp_matrix[survey_pair_num] = app_mode_impedance_test_ohm_saturate(impedance);
+	survey_pair_num++;
+	*p_progress = (uint8_t)((survey_pair_num * 100U) / IMP_SURVEY_PAIR_NUM);
+
+	survey_snkN++;
+	if (survey_snkN > IMP_ELECTRODE_NUM) {
+		survey_snkP++;
+		survey_snkN = survey_snkP + 1U;
+	}
+	if (survey_snkP < IMP_ELECTRODE_NUM) {
+		return false;
+	}
+
+	app_func_stim_off();
+	app_func_meas_imp_enable(false);
+	survey_snkP = 0U;
+
+	app_func_logs_imped_survey_write(p_imp_matrix, survey_pair_num);
+	*p_pair_num = survey_pair_num;
+	return true;
+}
+
+/**
+ * @brief Abort the impedance survey run by steps, the stimulus and the impedance monitor are turned off
+ *
+ */
+void app_mode_impedance_test_survey_abort(void) {
+	if (survey_snkP != 0U) {
+		app_func_stim_off();
+		app_func_meas_imp_enable(false);
+		survey_snkP = 0U;
+	}
+}
+
+/**
+ * @brief Measure the impedance of every electrode pair in one pass and record it as a single log
+ *
+ * @param p_imp_matrix The impedance of each pair, unit: ohm, saturated at UINT16_MAX.
+ * 			The pairs are ordered (1,2),(1,3),...,(1,5),(2,3),...,(4,5), IMP_SURVEY_PAIR_NUM entries in total.
+ * @return uint8_t The number of pairs measured
+ */
+uint8_t app_mode_impedance_test_survey(uint16_t* p_imp_matrix) {
+	uint8_t pair_num = 0;
+	uint8_t progress = 0;
+	while(!app_mode_impedance_test_survey_step(p_imp_matrix, &pair_num, &progress)) {
+		__NOP();
+	}
+	return pair_num;
+}
+
+/**
+ * @brief Get the result of the last impedance test since reset
+ *
+ * @param p_imp_ohm The impedance of the last test, unit: ohm, saturated at UINT16_MAX. 0 if not measured yet.
+ * @return uint8_t The faults found by the last impedance test, IMP_FAULT_xxx
+ */
+uint8_t app_mode_impedance_test_last_get(uint16_t* p_imp_ohm) {
+	*p_imp_ohm = imp_last_ohm;
+	return imp_last_faults;
+}
+
 /**
  * @brief Handler for impedance test mode
  *
@@ -204,8 +390,10 @@ void app_mode_impedance_test_handler(void) {
 	app_func_para_data_get((const uint8_t*)SPID_MIN_SAFE_IMPEDANCE, (uint8_t*)&min_safe_impedance_ohm, (uint8_t)sizeof(_Float64));
 
 	_Float64 impedance = app_mode_impedance_test_get();
+	imp_last_faults = 0U;
 	if (impedance < min_safe_impedance_ohm) {
 		app_func_logs_event_write((const char*)EVENT_SHORT_CIRCUIT, NULL);
+		imp_last_faults |= IMP_FAULT_SHORT_CIRCUIT;
 	}
 
 	_Float64 present_max_amplitude_mA = impVoltage / impedance;
@@ -214,6 +402,7 @@ void app_mode_impedance_test_handler(void) {
 	if (present_max_amplitude_mA != max_safe_amplitude_mA) {
 		if (present_max_amplitude_mA < max_safe_amplitude_mA) {
 			app_func_logs_event_write((const char*)EVENT_HIGH_IMPED, NULL);
+			imp_last_faults |= IMP_FAULT_HIGH_IMPED;
 		}
 		else if (present_max_amplitude_mA > max_safe_amplitude_mA) {
 			app_func_logs_event_write((const char*)EVENT_NORMAL_IMPED, NULL);
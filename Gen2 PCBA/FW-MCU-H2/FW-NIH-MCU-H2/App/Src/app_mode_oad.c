@@ -6,39 +6,110 @@
 #include "app_mode_oad.h"
 #include "app_config.h"
 
+#define	OAD_JOB_HASH_PKT_NUM	64U		/*!< The number of image packets hashed in one step of the job "VERIFY_FW_IMAGE" */
+
+/**
+ * @brief Set the response of the command "VERIFY_FW_IMAGE" from the number of failed verifications
+ *
+ * @param p_fail_num Pointer of the number of failed verifications, 0 means verification passed
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_oad_verify_resp_set(uint8_t* p_fail_num, Cmd_Resp_t* p_resp) {
+	if (*p_fail_num == 0U) {
+		app_func_sm_current_state_set(STATE_ACT_MODE_BSL);
+	}
+	else {
+		p_resp->Status = STATUS_INVALID;
+		p_resp->PayloadLen = (uint8_t)sizeof(uint8_t);
+		p_resp->Payload[0] = *p_fail_num;
+
+		if (*p_fail_num >= 3U) {
+			app_func_sm_current_state_set(STATE_ACT_MODE_BLE_CONN);
+		}
+	}
+}
+
+/**
+ * @brief Job step for the command "VERIFY_FW_IMAGE", OAD_JOB_HASH_PKT_NUM image packets are hashed in each step
+ *
+ * @param p_result The result of the job
+ * @param p_progress The progress of the job, unit: %
+ * @return true The job is finished
+ * @return false The job needs more steps
+ */
+static bool app_mode_oad_job_verify_fw_image(Cmd_Resp_t* p_result, uint8_t* p_progress) {
+	if (app_func_auth_fram_hash_step(OAD_JOB_HASH_PKT_NUM, p_progress) == false) {
+		return false;
+	}
+	app_mode_oad_verify_resp_set(app_func_auth_fram_hash_end(false), p_result);
+	return true;
+}
+
+/**
+ * @brief Job abort for the command "VERIFY_FW_IMAGE", the aborted verification is not counted as a failure
+ *
+ */
+static void app_mode_oad_job_verify_fw_image_abort(void) {
+	(void)app_func_auth_fram_hash_end(true);
+}
+
+/**
+ * @brief Handler for the command "VERIFY_FW_IMAGE" started as a job
+ *
+ * @param p_req Request command to be handled
+ * @param p_resp The response command to be replied
+ */
+static void app_mode_oad_job_cmd_verify_fw_image(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	uint32_t image_size = 0U;
+	(void)memcpy((uint8_t*)&image_size, p_req->Payload, sizeof(image_size));
+	if (image_size == 0U) {
+		p_resp->Status = STATUS_INVALID;
+	}
+	else {
+		app_func_auth_fram_hash_start(image_size);
+		app_func_job_start(p_req->Opcode, &app_mode_oad_job_verify_fw_image, &app_mode_oad_job_verify_fw_image_abort, app_mode_ble_act_userclass_get(), p_resp);
+	}
+}
+
+static const Cmd_Entry_t oad_job_cmd_entries[] = {
+	[OP_VERIFY_FW_IMAGE - OP_VERIFY_FW_IMAGE] = {&app_mode_oad_job_cmd_verify_fw_image, (uint8_t)sizeof(uint32_t), (uint8_t)sizeof(uint32_t), USER_CLASS_ADMIN},
+};
+
+static const Cmd_Table_t oad_job_cmd_tables[] = {
+	{oad_job_cmd_entries, 	OP_VERIFY_FW_IMAGE, 	(uint8_t)(sizeof(oad_job_cmd_entries) / sizeof(oad_job_cmd_entries[0]))},
+};
+#define OAD_JOB_CMD_TABLE_NUM	((uint8_t)(sizeof(oad_job_cmd_tables) / sizeof(oad_job_cmd_tables[0])))
+
 /**
  * @brief Parser for request commands in OAD mode, used to communicate with the remote end
  * 
- * @param req Request command to be parsed
- * @return Cmd_Resp_t The response command to be replied after parsing the request command
+ * @param p_req Request command to be parsed
+ * @param p_resp The response command to be replied after parsing the request command
  */
-static Cmd_Resp_t app_mode_oad_cmd_parser(Cmd_Req_t req) {
-	Cmd_Resp_t resp = {
-			.Opcode 		= req.Opcode,
-			.Status 		= STATUS_SUCCESS,
-			.Payload 		= NULL,
-			.PayloadLen 	= 0,
-	};
+static void app_mode_oad_cmd_parser(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
 	uint8_t len_payload_min = 0;
 	uint8_t len_payload_max = 0;
 
-	switch(req.Opcode) {
+	switch(p_req->Opcode) {
 	case OP_DOWNLOAD_FW_IMAGE:
 	{
 		len_payload_min = (uint8_t)sizeof(FW_Image_Packet_t);
 		len_payload_max = (uint8_t)sizeof(FW_Image_Packet_t);
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
+		if ((p_req->PayloadLen < len_payload_min) || (p_req->PayloadLen > len_payload_max)) {
+			p_resp->Status = STATUS_PAYLOAD_LEN_ERR;
+		}
+		else if (app_func_job_is_running()) {
+			p_resp->Status = STATUS_INVALID;
 		}
 		else {
 			FW_Image_Packet_t image_packet_write;
-			(void)memcpy((uint8_t*)&image_packet_write, req.Payload, sizeof(FW_Image_Packet_t));
+			(void)memcpy((uint8_t*)&image_packet_write, p_req->Payload, sizeof(FW_Image_Packet_t));
 			if ((image_packet_write.ImageDataOffset + SIZE_FW_IMG_PKG) > SIZE_FW_IMG) {
-				resp.Status = STATUS_INVALID;
+				p_resp->Status = STATUS_INVALID;
 			}
 			else {
 				FW_Image_Packet_t image_packet_read;
-				(void)memcpy((uint8_t*)&image_packet_read, req.Payload, sizeof(FW_Image_Packet_t));
+				(void)memcpy((uint8_t*)&image_packet_read, p_req->Payload, sizeof(FW_Image_Packet_t));
 				bsp_fram_read(ADDR_FW_IMG_BASE + image_packet_read.ImageDataOffset, image_packet_read.ImageData, SIZE_FW_IMG_PKG);
 
 				if (memcmp(image_packet_read.ImageData, image_packet_write.ImageData, sizeof(image_packet_read.ImageData)) != 0) {
@@ -53,37 +124,52 @@ static Cmd_Resp_t app_mode_oad_cmd_parser(Cmd_Req_t req) {
 	{
 		len_payload_min = (uint8_t)sizeof(uint32_t);
 		len_payload_max = (uint8_t)sizeof(uint32_t);
-		if ((req.PayloadLen < len_payload_min) || (req.PayloadLen > len_payload_max)) {
-			resp.Status = STATUS_PAYLOAD_LEN_ERR;
+		if ((p_req->PayloadLen < len_payload_min) || (p_req->PayloadLen > len_payload_max)) {
+			p_resp->Status = STATUS_PAYLOAD_LEN_ERR;
+		}
+		else if (app_func_job_is_running()) {
+			p_resp->Status = STATUS_INVALID;
 		}
 		else {
 			uint32_t image_size = 1U;
-			(void)memcpy((uint8_t*)&image_size, req.Payload, sizeof(image_size));
-			uint8_t* p_fail_num = app_func_auth_compare_fram_hash(image_size);
-			if (*p_fail_num == 0U) {
-				app_func_sm_current_state_set(STATE_ACT_MODE_BSL);
-			}
-			else {
-				resp.Status = STATUS_INVALID;
-				resp.PayloadLen = (uint8_t)sizeof(uint8_t);
-				resp.Payload = p_fail_num;
+			(void)memcpy((uint8_t*)&image_size, p_req->Payload, sizeof(image_size));
+			app_mode_oad_verify_resp_set(app_func_auth_compare_fram_hash(image_size), p_resp);
+		}
+	}
+		break;
 
-				if (*p_fail_num >= 3U) {
-					app_func_sm_current_state_set(STATE_ACT_MODE_BLE_CONN);
-				}
-			}
+	case OP_JOB_START:
+	{
+		if (p_req->PayloadLen < 1U) {
+			p_resp->Status = STATUS_PAYLOAD_LEN_ERR;
+		}
+		else {
+			app_func_job_cmd_start(oad_job_cmd_tables, OAD_JOB_CMD_TABLE_NUM, app_mode_ble_act_userclass_get(), p_req, p_resp);
+		}
+	}
+		break;
+
+	case OP_JOB_STATUS:
+	case OP_JOB_ABORT:
+	{
+		if (p_req->PayloadLen != 1U) {
+			p_resp->Status = STATUS_PAYLOAD_LEN_ERR;
+		}
+		else if (p_req->Opcode == OP_JOB_STATUS) {
+			app_func_job_cmd_status(app_mode_ble_act_userclass_get(), p_req, p_resp);
+		}
+		else {
+			app_func_job_cmd_abort(app_mode_ble_act_userclass_get(), p_req, p_resp);
 		}
 	}
 		break;
 
 	default:
 	{
-		resp.Status = STATUS_OPCODE_ERR;
+		p_resp->Status = STATUS_OPCODE_ERR;
 	}
 		break;
 	}
-
-	return resp;
 }
 
 /**
@@ -102,8 +188,12 @@ void app_mode_oad_handler(void) {
 			app_func_ble_new_state_get();
 			cmd_counter = 0xFF;
 		}
+		//The commands are served between the steps of the job, the loop only slows down when there is no job and no command
+		bool job_busy = app_func_job_handler();
 		bsp_sp_cmd_handler();
-		HAL_Delay(50);
+		if ((job_busy == false) && (bsp_sp_cmd_is_requested() == false)) {
+			HAL_Delay(50);
+		}
 		curr_ble_state = app_func_ble_curr_state_get();
 		curr_state = app_func_sm_current_state_get();
 		if (curr_state != STATE_ACT_MODE_OAD) {
@@ -112,6 +202,7 @@ void app_mode_oad_handler(void) {
 			HAL_Delay(100);
 		}
 		else if (curr_ble_state == BLE_STATE_ADV_STOP) {
+			app_func_job_clear();
 			app_func_sm_current_state_set(STATE_ACT_MODE_BLE_ACT);
 			curr_state = app_func_sm_current_state_get();
 		}
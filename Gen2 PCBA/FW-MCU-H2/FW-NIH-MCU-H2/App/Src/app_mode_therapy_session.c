@@ -7,6 +7,7 @@
 #include "app_config.h"
 
 static bool therapy_session_status = false;
+static uint32_t rtc_interrupt_period = 0;
 
 bool vnsb_en = false;
 
@@ -233,15 +234,31 @@ bool app_mode_therapy_confirm(void) {
 	return therapy_session_status;
 }
 
+/**
+ * @brief Callback when the RTC interrupt period changes
+ *
+ * @param p_id Parameter ID
+ */
+static void app_mode_therapy_para_change_cb(const uint8_t* p_id) {
+	_Float64 rtc_interrupt_period_f = 0.0;
+	app_func_para_data_get(p_id, (uint8_t*)&rtc_interrupt_period_f, (uint8_t)sizeof(rtc_interrupt_period_f));
+	rtc_interrupt_period = (uint32_t)rtc_interrupt_period_f;
+}
+
+/**
+ * @brief Initialization of therapy session mode
+ *
+ */
+void app_mode_therapy_init(void) {
+	(void)app_func_para_subscribe((const uint8_t*)HPID_RTC_INTERRUPT_PERIOD, &app_mode_therapy_para_change_cb);
+}
+
 /**
  * @brief Handler for therapy session mode
  * 
  */
 void app_mode_therapy_handler(void) {
 	if (app_mode_therapy_start() == true) {
-		_Float64 rtc_interrupt_period_f = 0.0;
-		app_func_para_data_get((const uint8_t*)HPID_RTC_INTERRUPT_PERIOD, (uint8_t*)&rtc_interrupt_period_f, (uint8_t)sizeof(rtc_interrupt_period_f));
-		uint32_t rtc_interrupt_period = (uint32_t)rtc_interrupt_period_f;
 		if (rtc_interrupt_period > 0) {
 			HAL_ERROR_CHECK(HAL_RTCEx_SetWakeUpTimer_IT(&hrtc, rtc_interrupt_period - 1, RTC_WAKEUPCLOCK_CK_SPRE_16BITS, 0));
 		}
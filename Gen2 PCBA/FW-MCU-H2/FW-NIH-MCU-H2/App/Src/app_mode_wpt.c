@@ -50,7 +50,7 @@ static const ThermEntry_t k_therm_table[] = {
  * @param therm_ofst_mv  THERM_OFST ADC reading, mV
  * @return float         Calculated temperature in °C
  */
-static float app_mode_wpt_calc_temperature(uint16_t therm_ref_mv, uint16_t therm_out_mv, uint16_t therm_ofst_mv)
+float app_mode_wpt_calc_temperature(uint16_t therm_ref_mv, uint16_t therm_out_mv, uint16_t therm_ofst_mv)
 {
     float voltage      = (float)therm_out_mv  - (float)therm_ofst_mv;  /* across thermistor */
     float voltage_drop = (float)therm_ref_mv  - (float)therm_out_mv;   /* across 49.9kΩ sense resistor */
@@ -151,21 +151,21 @@ void app_mode_wpt_handler(void)
     _Float64 adv_timeout_f = 0.0;
 
     uint8_t bleid_len = app_func_para_datalen_get((const uint8_t*)HPID_IPG_BLE_ID);
-    uint8_t offset    = app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
+    (void)app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
 
     app_func_para_data_get((const uint8_t*)BPID_BLE_PASSKEY,          setting.advance.passkey,              (uint8_t)sizeof(setting.advance.passkey));
     app_func_para_data_get((const uint8_t*)BPID_BLE_WHITELIST,        &setting.advance.whitelist_enable,    (uint8_t)sizeof(setting.advance.whitelist_enable));
     app_func_para_data_get((const uint8_t*)HPID_BLE_BROADCAST_TIMEOUT,(uint8_t*)&adv_timeout_f,             (uint8_t)sizeof(adv_timeout_f));
-    app_func_para_data_get((const uint8_t*)HPID_IPG_BLE_ID,           (uint8_t*)(&setting.msd[offset]),     bleid_len);
+    app_func_para_data_get((const uint8_t*)HPID_IPG_BLE_ID,           (uint8_t*)(&setting.msd[MSD_IDX_BLE_ID]), bleid_len);
     app_func_para_data_get((const uint8_t*)BPID_BLE_COMPANY_ID,        setting.companyid,                   (uint8_t)sizeof(setting.companyid));
 
-    /* 1-second advertisement burst interval */
-    const uint32_t wpt_adv_interval_s = 1U;
-    uint32_t passkey_timeout = (uint32_t)adv_timeout_f / 2U;
-    (void)memcpy((uint8_t*)setting.passkey_timeout, (uint8_t*)&passkey_timeout,    sizeof(uint32_t));
-    (void)memcpy((uint8_t*)setting.adv_timeout,     (uint8_t*)&wpt_adv_interval_s, sizeof(uint32_t));
+    /* Advertise for the broadcast timeout, the MSD is refreshed in place every second */
+    uint32_t adv_timeout     = (uint32_t)adv_timeout_f;
+    uint32_t passkey_timeout = adv_timeout / 2U;
+    (void)memcpy((uint8_t*)setting.passkey_timeout, (uint8_t*)&passkey_timeout, sizeof(uint32_t));
+    (void)memcpy((uint8_t*)setting.adv_timeout,     (uint8_t*)&adv_timeout,     sizeof(uint32_t));
 
-    setting.msd[LEN_BLE_MSD_MAX - 1] = HW_VERSION;
+    setting.msd[MSD_IDX_HW_VERSION] = HW_VERSION;
 
     if (app_func_ble_is_default()) {
         app_func_para_defdata_get((const uint8_t*)BPID_BLE_PASSKEY, (uint8_t*)setting.advance.passkey);
@@ -197,7 +197,7 @@ void app_mode_wpt_handler(void)
         }
     }
 
-    app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
+    (void)app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
     app_func_ble_adv_start(&setting);
     while (!bsp_sp_cmd_handler()) {
         HAL_Delay(1);
@@ -217,6 +217,7 @@ void app_mode_wpt_handler(void)
 
     /* ---- Main WPT charging loop ---- */
     wpt_ms_timer = 1000U;  /* first sample after 1 second */
+    bool msd_pending = false;
 
     while (curr_state == STATE_ACT_MODE_WPT_HIGH || curr_state == STATE_ACT_MODE_WPT_PAUSED) {
         bsp_wdg_refresh();
@@ -286,8 +287,8 @@ void app_mode_wpt_handler(void)
                     HAL_GPIO_WritePin(VCHG_DISABLE_GPIO_Port, VCHG_DISABLE_Pin, GPIO_PIN_SET);
                     HAL_GPIO_WritePin(CHG1_EN_GPIO_Port,      CHG1_EN_Pin,      GPIO_PIN_RESET);
                     HAL_GPIO_WritePin(CHG2_EN_GPIO_Port,      CHG2_EN_Pin,      GPIO_PIN_RESET);
-                    /* Hold in PAUSED for OVP events — gives the charger 2–3 BLE
-                     * advertisement cycles to see VRECT_OVP and reduce coil power
+                    /* Hold in PAUSED for OVP events — gives the charger 2–3 MSD
+                     * refreshes to see VRECT_OVP and reduce coil power
                      * before the IPG re-enables and re-triggers the fault. */
                     if (vrect_ovp) {
                         wpt_paused_hold_ms = WPT_OVP_PAUSE_HOLD_MS;
@@ -313,18 +314,27 @@ void app_mode_wpt_handler(void)
                 }
             }
 
-            /* Update BLE advertisement with fresh measurements + WPT state bits */
-            app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
+            /* Update BLE advertisement with fresh measurements + WPT state bits,
+             * only sent to the nRF when something changed */
+            msd_pending |= app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
         }
 
-        /* BLE state machine — restart advertising when a burst ends */
-        app_func_ble_new_state_get();
+        /* BLE state machine — swap the fresh MSD into the running advertising,
+         * restart advertising when it ends */
+        if (msd_pending && (curr_ble_state == BLE_STATE_ADV_START)) {
+            app_func_ble_adv_msd_update(&setting);
+            msd_pending = false;
+        }
+        else {
+            app_func_ble_new_state_get();
+        }
         bsp_sp_cmd_handler();
         HAL_Delay(50);
         curr_ble_state = app_func_ble_curr_state_get();
         if (curr_ble_state == BLE_STATE_ADV_STOP) {
-            app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
+            (void)app_mode_ble_act_adv_msd_update((uint8_t*)setting.msd);
             app_func_ble_adv_start(&setting);
+            msd_pending = false;
             while (!bsp_sp_cmd_handler()) {
                 HAL_Delay(1);
             }
@@ -8,6 +8,19 @@
 
 extern bool schd_therapy_enable;
 
+static uint32_t rtc_interrupt_period = 0;
+
+/**
+ * @brief Callback when the RTC interrupt period changes
+ *
+ * @param p_id Parameter ID
+ */
+static void app_state_para_change_cb(const uint8_t* p_id) {
+	_Float64 rtc_interrupt_period_f = 0.0;
+	app_func_para_data_get(p_id, (uint8_t*)&rtc_interrupt_period_f, (uint8_t)sizeof(rtc_interrupt_period_f));
+	rtc_interrupt_period = (uint32_t)rtc_interrupt_period_f;
+}
+
 /**
  * @brief Turn off the power to all peripheral circuits
  * 
@@ -21,11 +34,20 @@ static void app_state_power_off(void) {
 	app_func_ble_enable(false);
 }
 
+/**
+ * @brief Initialization of the states
+ *
+ */
+void app_state_init(void) {
+	(void)app_func_para_subscribe((const uint8_t*)HPID_RTC_INTERRUPT_PERIOD, &app_state_para_change_cb);
+}
+
 /**
  * @brief Handler for shutdown state
  * 
  */
 void app_state_shutdown_handler(void) {
+	app_func_logs_flush();
 	bsp_fram_deinit();
 	bsp_sp_deinit();
 	app_state_power_off();
@@ -40,6 +62,7 @@ void app_state_shutdown_handler(void) {
 void app_state_sleep_handler(void) {
 	bsp_wdg_refresh();
 	//app_func_logs_event_write(EVENT_SLEEP, NULL);		//Logging here gunks up the FRAM, causing a delay that triggeres watchdog timer
+	app_func_logs_flush();
 	bsp_fram_deinit();
 	bsp_sp_deinit();
 
@@ -101,9 +124,6 @@ void app_state_sleep_handler(void) {
 	HAL_ERROR_CHECK(HAL_LPTIM_Counter_Start_IT(&HANDLE_WAKEUP_LPTIM));
 	HAL_ERROR_CHECK(HAL_LPTIM_Counter_Start_IT(&HANDLE_WDG_REFRESH_LPTIM));
 
-	_Float64 rtc_interrupt_period_f = 0.0;
-	app_func_para_data_get((const uint8_t*)HPID_RTC_INTERRUPT_PERIOD, (uint8_t*)&rtc_interrupt_period_f, (uint8_t)sizeof(rtc_interrupt_period_f));
-	uint32_t rtc_interrupt_period = (uint32_t)rtc_interrupt_period_f;
 	if (rtc_interrupt_period > 0) {
 		HAL_ERROR_CHECK(HAL_RTCEx_SetWakeUpTimer_IT(&hrtc, rtc_interrupt_period - 1, RTC_WAKEUPCLOCK_CK_SPRE_16BITS, 0));
 	}
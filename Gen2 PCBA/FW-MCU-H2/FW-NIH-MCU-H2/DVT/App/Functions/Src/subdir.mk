@@ -8,6 +8,7 @@ C_SRCS += \
 ../App/Functions/Src/app_func_authentication.c \
 ../App/Functions/Src/app_func_ble.c \
 ../App/Functions/Src/app_func_command.c \
+../App/Functions/Src/app_func_job.c \
 ../App/Functions/Src/app_func_logs.c \
 ../App/Functions/Src/app_func_measurement.c \
 ../App/Functions/Src/app_func_parameter.c \
@@ -18,6 +19,7 @@ OBJS += \
 ./App/Functions/Src/app_func_authentication.o \
 ./App/Functions/Src/app_func_ble.o \
 ./App/Functions/Src/app_func_command.o \
+./App/Functions/Src/app_func_job.o \
 ./App/Functions/Src/app_func_logs.o \
 ./App/Functions/Src/app_func_measurement.o \
 ./App/Functions/Src/app_func_parameter.o \
@@ -28,6 +30,7 @@ C_DEPS += \
 ./App/Functions/Src/app_func_authentication.d \
 ./App/Functions/Src/app_func_ble.d \
 ./App/Functions/Src/app_func_command.d \
+./App/Functions/Src/app_func_job.d \
 ./App/Functions/Src/app_func_logs.d \
 ./App/Functions/Src/app_func_measurement.d \
 ./App/Functions/Src/app_func_parameter.d \
@@ -42,7 +45,7 @@ App/Functions/Src/%.o App/Functions/Src/%.su App/Functions/Src/%.cyclo: ../App/F
 clean: clean-App-2f-Functions-2f-Src
 
 clean-App-2f-Functions-2f-Src:
-	-$(RM) ./App/Functions/Src/app_func_authentication.cyclo ./App/Functions/Src/app_func_authentication.d ./App/Functions/Src/app_func_authentication.o ./App/Functions/Src/app_func_authentication.su ./App/Functions/Src/app_func_ble.cyclo ./App/Functions/Src/app_func_ble.d ./App/Functions/Src/app_func_ble.o ./App/Functions/Src/app_func_ble.su ./App/Functions/Src/app_func_command.cyclo ./App/Functions/Src/app_func_command.d ./App/Functions/Src/app_func_command.o ./App/Functions/Src/app_func_command.su ./App/Functions/Src/app_func_logs.cyclo ./App/Functions/Src/app_func_logs.d ./App/Functions/Src/app_func_logs.o ./App/Functions/Src/app_func_logs.su ./App/Functions/Src/app_func_measurement.cyclo ./App/Functions/Src/app_func_measurement.d ./App/Functions/Src/app_func_measurement.o ./App/Functions/Src/app_func_measurement.su ./App/Functions/Src/app_func_parameter.cyclo ./App/Functions/Src/app_func_parameter.d ./App/Functions/Src/app_func_parameter.o ./App/Functions/Src/app_func_parameter.su ./App/Functions/Src/app_func_state_machine.cyclo ./App/Functions/Src/app_func_state_machine.d ./App/Functions/Src/app_func_state_machine.o ./App/Functions/Src/app_func_state_machine.su ./App/Functions/Src/app_func_stimulation.cyclo ./App/Functions/Src/app_func_stimulation.d ./App/Functions/Src/app_func_stimulation.o ./App/Functions/Src/app_func_stimulation.su
+	-$(RM) ./App/Functions/Src/app_func_authentication.cyclo ./App/Functions/Src/app_func_authentication.d ./App/Functions/Src/app_func_authentication.o ./App/Functions/Src/app_func_authentication.su ./App/Functions/Src/app_func_ble.cyclo ./App/Functions/Src/app_func_ble.d ./App/Functions/Src/app_func_ble.o ./App/Functions/Src/app_func_ble.su ./App/Functions/Src/app_func_command.cyclo ./App/Functions/Src/app_func_command.d ./App/Functions/Src/app_func_command.o ./App/Functions/Src/app_func_command.su ./App/Functions/Src/app_func_job.cyclo ./App/Functions/Src/app_func_job.d ./App/Functions/Src/app_func_job.o ./App/Functions/Src/app_func_job.su ./App/Functions/Src/app_func_logs.cyclo ./App/Functions/Src/app_func_logs.d ./App/Functions/Src/app_func_logs.o ./App/Functions/Src/app_func_logs.su ./App/Functions/Src/app_func_measurement.cyclo ./App/Functions/Src/app_func_measurement.d ./App/Functions/Src/app_func_measurement.o ./App/Functions/Src/app_func_measurement.su ./App/Functions/Src/app_func_parameter.cyclo ./App/Functions/Src/app_func_parameter.d ./App/Functions/Src/app_func_parameter.o ./App/Functions/Src/app_func_parameter.su ./App/Functions/Src/app_func_state_machine.cyclo ./App/Functions/Src/app_func_state_machine.d ./App/Functions/Src/app_func_state_machine.o ./App/Functions/Src/app_func_state_machine.su ./App/Functions/Src/app_func_stimulation.cyclo ./App/Functions/Src/app_func_stimulation.d ./App/Functions/Src/app_func_stimulation.o ./App/Functions/Src/app_func_stimulation.su
 
 .PHONY: clean-App-2f-Functions-2f-Src
 
@@ -42,6 +42,15 @@
  */
 uint16_t CY15B108QN_write_spi_frame_get(uint8_t* p_buffer, uint32_t addr, const uint8_t* p_data, uint16_t data_len);
 
+/**
+ * @brief Get the SPI frame header of the write command to CY15B108QN, the data follows it in the same transfer
+ *
+ * @param p_buffer Buffer to store SPI frame header
+ * @param addr The address to write to
+ * @return uint16_t The length of the SPI frame header
+ */
+uint16_t CY15B108QN_write_spi_header_get(uint8_t* p_buffer, uint32_t addr);
+
 /**
  * @brief Get the SPI frame of the read command to CY15B108QN
  * 
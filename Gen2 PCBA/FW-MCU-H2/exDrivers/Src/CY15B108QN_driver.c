@@ -30,6 +30,27 @@ uint16_t CY15B108QN_write_spi_frame_get(uint8_t* p_buffer, uint32_t addr, const
 	return len;
 }
 
+/**
+ * @brief Get the SPI frame header of the write command to CY15B108QN, the data follows it in the same transfer
+ *
+ * @param p_buffer Buffer to store SPI frame header
+ * @param addr The address to write to
+ * @return uint16_t The length of the SPI frame header
+ */
+uint16_t CY15B108QN_write_spi_header_get(uint8_t* p_buffer, uint32_t addr) {
+	uint16_t len = 0U;
+	if ((p_buffer != NULL) && (addr <= CY15B108QN_MAX_ADDR)) {
+		uint8_t address[4];
+		(void)memcpy((uint8_t*)address, (uint8_t*)&addr, sizeof(uint32_t));
+		p_buffer[0] = CY15B108QN_CMD_WRITE;
+		p_buffer[1] = address[2];
+		p_buffer[2] = address[1];
+		p_buffer[3] = address[0];
+		len = 4U;
+	}
+	return len;
+}
+
 /**
  * @brief Get the SPI frame of the read command to CY15B108QN
  * 
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""
+OpenNerve IPG Gen2 — BLE Advertising Model
+Firmware source: FW-BLE/app/app_ble_adv.c :: app_ble_adv_msd_update()
+                 App/Src/app_mode_ble_active.c, App/Src/app_mode_wpt.c
+
+Estimates the radio-on time of the nRF52810 for the advertising of a simulated
+day, with the MSD refreshed by restarting the advertising and refreshed in place:
+
+  RESTART   the MCU advertises in 1 s bursts and sends OPCODE_BLE_ADV_START for
+            every burst, so the advertising never leaves the fast phase
+  IN PLACE  the MCU starts the advertising for the broadcast timeout and sends
+            OPCODE_BLE_ADV_MSD_UPDATE every second; WPT mode starts it again
+            when it stops, BLE active mode leaves the mode at the timeout
+
+Advertising model (defaults can be changed on the command line):
+  - the fast phase of FAST_ADV_DURATION at FAST_ADV_INTERVAL, then the slow
+    interval until the timeout (app_ble_adv_start)
+  - every advertising event costs EVENT_MS of radio time (3 channels, the PDU
+    and the listen for a scan request)
+  - advDelay adds DELAY_MS to every interval on average (0 ~ 10 ms)
+  - the time from a stop to the next start is left out
+"""
+
+import argparse
+
+FAST_INTERVAL_MS = 40.0         # FAST_ADV_INTERVAL 64 * 0.625 ms
+SLOW_INTERVAL_MS = 100.0        # SLOW_ADV_INTERVAL 160 * 0.625 ms
+FAST_DURATION_S = 10.0          # FAST_ADV_DURATION 1000 * 10 ms
+BROADCAST_TIMEOUT_S = 119       # default of HPID_BLE_BROADCAST_TIMEOUT
+RESTART_BURST_S = 1             # the burst of the MCU before the in-place update
+
+
+# ── Model ────────────────────────────────────────────────────────────────────
+
+def radio_s(window_s, restart_s, event_ms, delay_ms):
+    """Return the radio-on seconds of a window, advertising started again every restart_s."""
+    t = 0.0
+    on = 0.0
+    while t < window_s:
+        phase = t % restart_s
+        interval = (FAST_INTERVAL_MS if phase < FAST_DURATION_S else SLOW_INTERVAL_MS) + delay_ms
+        on += event_ms / 1000.0
+        t += interval / 1000.0
+    return on
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Radio-on time per day of the BLE advertising.")
+    parser.add_argument("--event-ms", type=float, default=2.0,
+                        help="radio time of an advertising event (default: 2.0)")
+    parser.add_argument("--delay-ms", type=float, default=5.0,
+                        help="average advDelay added to every interval (default: 5.0)")
+    parser.add_argument("--ble-windows", type=int, default=12,
+                        help="BLE active windows of the broadcast timeout per day (default: 12)")
+    parser.add_argument("--wpt-min", type=float, default=60.0,
+                        help="minutes of WPT charge per day (default: 60)")
+    parser.add_argument("--timeout-s", type=int, default=BROADCAST_TIMEOUT_S,
+                        help=f"broadcast timeout (default: {BROADCAST_TIMEOUT_S})")
+    args = parser.parse_args()
+
+    wpt_s = args.wpt_min * 60.0
+    # (name, window seconds, restart seconds before, restart seconds after)
+    windows = [("BLE active", args.timeout_s, RESTART_BURST_S, args.timeout_s)] * args.ble_windows
+    windows += [("WPT charge", wpt_s, RESTART_BURST_S, args.timeout_s)]
+    adv_s = sum(w[1] for w in windows)
+
+    print(f"  {'Window':<12} {'Count':>5} {'Time':>8} {'Restart':>10} {'In place':>10}")
+    print(f"  {'-' * 12} {'-' * 5} {'-' * 8} {'-' * 10} {'-' * 10}")
+    total = [0.0, 0.0]
+    for name in ("BLE active", "WPT charge"):
+        group = [w for w in windows if w[0] == name]
+        if not group:
+            continue
+        before = sum(radio_s(w[1], w[2], args.event_ms, args.delay_ms) for w in group)
+        after = sum(radio_s(w[1], w[3], args.event_ms, args.delay_ms) for w in group)
+        total[0] += before
+        total[1] += after
+        time_s = sum(w[1] for w in group)
+        print(f"  {name:<12} {len(group):>5} {time_s:>6.0f} s {before:>8.1f} s {after:>8.1f} s")
+    print(f"  {'Day':<12} {len(windows):>5} {adv_s:>6.0f} s {total[0]:>8.1f} s {total[1]:>8.1f} s")
+    print(f"  {'Duty cycle':<12} {'':>5} {'':>8} {100.0 * total[0] / adv_s:>9.2f}% {100.0 * total[1] / adv_s:>9.2f}%")
+
+
+if __name__ == "__main__":
+    main()
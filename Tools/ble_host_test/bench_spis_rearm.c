@@ -0,0 +1,134 @@
+/**
+ * @file bench_spis_rearm.c
+ * @brief Benchmark of the time from the end of a SPIS transfer until the buffers are set again, against the real app_sp_spis.c
+ *
+ * BLE_RDY is set again when the buffers are set, so this is the time the master waits before the next transfer.
+ * A log flush in the interrupt blocks until the backend has taken the characters, so the characters flushed
+ * before the re-arm are counted, and the time is given for a UART backend at 115200 baud, 86.8 us per character.
+ * The RTT backend of the board copies them to RAM instead, and only waits while its buffer is full.
+ * The host time of the handler is measured as well. Older sources are benchmarked by pointing FW of the Makefile
+ * to their tree.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <time.h>
+#include "app_sp.h"
+#include "app_sp_spis.h"
+#include "custom_board.h"
+#include "nrf_drv_spis.h"
+#include "nrf_gpio.h"
+#include "nrf_log_ctrl.h"
+
+#define BENCH_ROUNDS            2000U
+#define BENCH_FRAME_SIZE        64U
+#define BENCH_UART_NS_PER_CHAR  86806U          /*!< 10 bits at 115200 baud */
+
+static app_sp_stat_t sp_stat;
+static struct timespec set_time;
+static uint32_t set_flushed = 0;
+
+uint8_t app_sp_rx_space_get(void)
+{
+    return DATA_BUFFER_GROUP_COUNT;
+}
+
+/**
+ * @brief The room in the forwarding buffer, as asked by the sources before the rx queue
+ *
+ */
+bool app_sp_rx_ready(void)
+{
+    return true;
+}
+
+app_sp_stat_t* app_sp_stat_get(void)
+{
+    return &sp_stat;
+}
+
+void app_sp_on_tx_ready(uint8_t port)
+{
+    (void)port;
+}
+
+void app_sp_on_rx_data(uint8_t port, uint8_t const* data, uint16_t size)
+{
+    (void)port;
+    (void)data;
+    (void)size;
+}
+
+/**
+ * @brief The sources before the rx queue handle the data in the interrupt and have no handler in the main context
+ *
+ */
+__attribute__((weak)) void app_sp_spis_rx_handler(void)
+{
+}
+
+void nrf_drv_spis_stub_set_hook(void)
+{
+    (void)clock_gettime(CLOCK_MONOTONIC, &set_time);
+    set_flushed = nrf_log_stub_flushed;
+}
+
+typedef void (*Bench_Xfer)(void);
+
+static void xfer_write(void)
+{
+    uint8_t frame[BENCH_FRAME_SIZE];
+    for (uint8_t i = 0; i < BENCH_FRAME_SIZE; i++)
+    {
+        frame[i] = i;
+    }
+    (void)nrf_drv_spis_stub_write(frame, sizeof(frame));
+}
+
+static void xfer_read(void)
+{
+    uint8_t data[0xFF];
+    (void)nrf_drv_spis_stub_read(data);
+}
+
+/**
+ * @brief Prepare a tx frame for the master to read
+ *
+ */
+static void xfer_read_prepare(void)
+{
+    uint8_t frame[BENCH_FRAME_SIZE] = { 0 };
+    app_sp_spis_put(frame, sizeof(frame));
+}
+
+static void bench_run(const char* p_name, Bench_Xfer prepare, Bench_Xfer xfer)
+{
+    uint64_t chars_total = 0;
+    double ns_total = 0;
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++)
+    {
+        if (prepare != NULL)
+        {
+            prepare();
+        }
+        struct timespec t0;
+        uint32_t flushed = nrf_log_stub_flushed;
+        (void)clock_gettime(CLOCK_MONOTONIC, &t0);
+        xfer();
+        chars_total += set_flushed - flushed;
+        ns_total += ((double)(set_time.tv_sec - t0.tv_sec) * 1e9) + (double)(set_time.tv_nsec - t0.tv_nsec);
+        app_sp_spis_rx_handler();
+        NRF_LOG_FLUSH();
+    }
+    double chars = (double)chars_total / BENCH_ROUNDS;
+    (void)printf("  %-20s %6.0f chars flushed before the re-arm %9.1f us at 115200 baud %8.3f us host\n", p_name,
+            chars, chars * BENCH_UART_NS_PER_CHAR / 1000.0, ns_total / BENCH_ROUNDS / 1000.0);
+}
+
+int main(void)
+{
+    app_sp_spis_init();
+    (void)printf("bench_spis_rearm: per %u-byte transfer, average of %u rounds\n", BENCH_FRAME_SIZE, BENCH_ROUNDS);
+    bench_run("frame written", NULL, &xfer_write);
+    bench_run("tx data read", &xfer_read_prepare, &xfer_read);
+    return 0;
+}
@@ -0,0 +1,27 @@
+/**
+ * @file app_error.h
+ * @brief Host stand-in for the error module, an error stops the test
+ * @copyright Copyright (c) 2024
+ */
+#ifndef BLE_HOST_TEST_APP_ERROR_H_
+#define BLE_HOST_TEST_APP_ERROR_H_
+
+#include <stdint.h>
+
+typedef uint32_t ret_code_t;
+
+#define NRF_SUCCESS                 0U
+
+void app_error_stub_handler(ret_code_t err_code, const char* p_file, int line);
+
+#define APP_ERROR_CHECK(ERR_CODE)                                       \
+    do                                                                  \
+    {                                                                   \
+        const ret_code_t LOCAL_ERR_CODE = (ERR_CODE);                   \
+        if (LOCAL_ERR_CODE != NRF_SUCCESS)                              \
+        {                                                               \
+            app_error_stub_handler(LOCAL_ERR_CODE, __FILE__, __LINE__); \
+        }                                                               \
+    } while (0)
+
+#endif
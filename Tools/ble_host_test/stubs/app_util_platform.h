@@ -0,0 +1,15 @@
+/**
+ * @file app_util_platform.h
+ * @brief Host stand-in for the platform utilities, the tests run in one thread so nothing needs to be masked
+ * @copyright Copyright (c) 2024
+ */
+#ifndef BLE_HOST_TEST_APP_UTIL_PLATFORM_H_
+#define BLE_HOST_TEST_APP_UTIL_PLATFORM_H_
+
+#include <string.h>
+
+#define CRITICAL_REGION_ENTER()
+#define CRITICAL_REGION_EXIT()
+#define __NOP()                     ((void)0)
+
+#endif
@@ -0,0 +1,16 @@
+/**
+ * @file custom_board.h
+ * @brief Host stand-in for the board definition, the pins only need distinct numbers
+ * @copyright Copyright (c) 2024
+ */
+#ifndef BLE_HOST_TEST_CUSTOM_BOARD_H_
+#define BLE_HOST_TEST_CUSTOM_BOARD_H_
+
+#define BLE_RDY_PIN     1
+#define BLE_REQ_PIN     2
+#define BLE_CSn_PIN     3
+#define BLE_MISO_PIN    4
+#define BLE_MOSI_PIN    5
+#define BLE_SCK_PIN     6
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * @file nrf_drv_spis.h
+ * @brief Host stand-in for the SPIS driver, with a master the tests drive one transfer at a time
+ * @copyright Copyright (c) 2024
+ */
+#ifndef BLE_HOST_TEST_NRF_DRV_SPIS_H_
+#define BLE_HOST_TEST_NRF_DRV_SPIS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "sdk_config.h"
+#include "app_error.h"
+
+typedef enum
+{
+    NRFX_SPIS_BUFFERS_SET_DONE,
+    NRFX_SPIS_XFER_DONE,
+    NRFX_SPIS_EVT_TYPE_MAX
+} nrfx_spis_evt_type_t;
+
+#define NRF_DRV_SPIS_BUFFERS_SET_DONE   NRFX_SPIS_BUFFERS_SET_DONE
+#define NRF_DRV_SPIS_XFER_DONE          NRFX_SPIS_XFER_DONE
+
+typedef struct
+{
+    nrfx_spis_evt_type_t evt_type;
+    size_t rx_amount;
+    size_t tx_amount;
+} nrf_drv_spis_event_t;
+
+typedef struct
+{
+    uint8_t drv_inst_idx;
+} nrf_drv_spis_t;
+
+typedef struct
+{
+    uint32_t csn_pin;
+    uint32_t miso_pin;
+    uint32_t mosi_pin;
+    uint32_t sck_pin;
+} nrf_drv_spis_config_t;
+
+typedef void (*nrf_drv_spis_event_handler_t)(nrf_drv_spis_event_t event);
+
+#define NRF_DRV_SPIS_INSTANCE(ID)       { .drv_inst_idx = (ID) }
+#define NRF_DRV_SPIS_DEFAULT_CONFIG     { 0 }
+
+ret_code_t nrf_drv_spis_init(nrf_drv_spis_t const* p_instance, nrf_drv_spis_config_t const* p_config, nrf_drv_spis_event_handler_t event_handler);
+ret_code_t nrf_drv_spis_buffers_set(nrf_drv_spis_t const* p_instance, uint8_t* p_tx_buffer, size_t tx_buffer_length, uint8_t* p_rx_buffer, size_t rx_buffer_length);
+
+/**
+ * @brief Called when the buffers are set, before BUFFERS_SET_DONE is handled. It is weak, so a test can time the re-arm.
+ */
+void nrf_drv_spis_stub_set_hook(void);
+
+/**
+ * @brief Check whether the buffers are set, so the master may start a transfer.
+ */
+bool nrf_drv_spis_stub_armed(void);
+
+/**
+ * @brief A write by the master, the data goes into the rx buffer set by the slave.
+ *
+ * @return size_t The length received by the slave.
+ */
+size_t nrf_drv_spis_stub_write(const uint8_t* p_data, size_t length);
+
+/**
+ * @brief A read by the master as the MCU does it, the length byte and then that many data bytes.
+ *
+ * @return size_t The length of the data read, without the length byte.
+ */
+size_t nrf_drv_spis_stub_read(uint8_t* p_data);
+
+#endif
@@ -0,0 +1,23 @@
+/**
+ * @file nrf_gpio.h
+ * @brief Host stand-in for the GPIO, the output pins are kept in an array the tests read
+ * @copyright Copyright (c) 2024
+ */
+#ifndef BLE_HOST_TEST_NRF_GPIO_H_
+#define BLE_HOST_TEST_NRF_GPIO_H_
+
+#include <stdint.h>
+
+#define NRF_GPIO_PIN_PULLUP     3
+#define NRF_GPIO_PIN_NUM        8
+
+extern uint32_t nrf_gpio_stub_out[NRF_GPIO_PIN_NUM];
+
+static inline void nrf_gpio_cfg_output(uint32_t pin) { (void)pin; }
+static inline void nrf_gpio_cfg_input(uint32_t pin, uint32_t pull) { (void)pin; (void)pull; }
+static inline void nrf_gpio_pin_set(uint32_t pin) { nrf_gpio_stub_out[pin] = 1; }
+static inline void nrf_gpio_pin_clear(uint32_t pin) { nrf_gpio_stub_out[pin] = 0; }
+static inline uint32_t nrf_gpio_pin_out_read(uint32_t pin) { return nrf_gpio_stub_out[pin]; }
+static inline uint32_t nrf_gpio_pin_read(uint32_t pin) { (void)pin; return 1; }     //The master keeps CSn high between transfers
+
+#endif
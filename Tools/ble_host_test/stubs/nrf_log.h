@@ -0,0 +1,22 @@
+/**
+ * @file nrf_log.h
+ * @brief Host stand-in for the log module, the characters of each log are counted instead of printed.
+ * Only the info level and above is built, as NRF_LOG_LEVEL 3 of the tested sources.
+ * @copyright Copyright (c) 2024
+ */
+#ifndef BLE_HOST_TEST_NRF_LOG_H_
+#define BLE_HOST_TEST_NRF_LOG_H_
+
+#include <stdint.h>
+
+void nrf_log_stub_printf(const char* p_format, ...);
+void nrf_log_stub_hexdump(uint32_t length);
+
+#define NRF_LOG_MODULE_REGISTER()
+#define NRF_LOG_ERROR(...)                  nrf_log_stub_printf(__VA_ARGS__)
+#define NRF_LOG_WARNING(...)                nrf_log_stub_printf(__VA_ARGS__)
+#define NRF_LOG_INFO(...)                   nrf_log_stub_printf(__VA_ARGS__)
+#define NRF_LOG_DEBUG(...)
+#define NRF_LOG_HEXDUMP_INFO(P_DATA, LEN)   nrf_log_stub_hexdump((uint32_t)(LEN))
+
+#endif
@@ -0,0 +1,17 @@
+/**
+ * @file nrf_log_ctrl.h
+ * @brief Host stand-in for the log control, a flush hands the pending characters to the backend
+ * @copyright Copyright (c) 2024
+ */
+#ifndef BLE_HOST_TEST_NRF_LOG_CTRL_H_
+#define BLE_HOST_TEST_NRF_LOG_CTRL_H_
+
+#include <stdint.h>
+
+extern uint32_t nrf_log_stub_flushed;      /*!< The characters handed to the backend by a flush so far */
+
+void nrf_log_stub_flush(void);
+
+#define NRF_LOG_FLUSH()     nrf_log_stub_flush()
+
+#endif
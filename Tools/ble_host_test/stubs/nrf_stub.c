@@ -0,0 +1,149 @@
+/**
+ * @file nrf_stub.c
+ * @brief Host model of the SPIS driver, the GPIO and the log module used by the tested sources.
+ * The driver takes the buffers at once, and the master of the test clocks one transfer at a time
+ * through them, as the SPIS hardware does with the semaphore held by the CPU in between.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "nrf_drv_spis.h"
+#include "nrf_gpio.h"
+#include "nrf_log.h"
+#include "nrf_log_ctrl.h"
+
+#define NRF_LOG_STUB_PREFIX_LEN     (sizeof("<info> APP_SP_SPIS: ") - 1U)
+#define NRF_LOG_STUB_EOL_LEN        2U
+#define NRF_LOG_STUB_HEXDUMP_LINE   8U          /*!< The bytes in a line of a hexdump, each as 3 hex characters and 1 character */
+
+uint32_t nrf_gpio_stub_out[NRF_GPIO_PIN_NUM];
+uint32_t nrf_log_stub_pending = 0;      /*!< The characters formatted and not flushed yet */
+uint32_t nrf_log_stub_flushed = 0;      /*!< The characters handed to the backend by a flush */
+
+static nrf_drv_spis_event_handler_t spis_handler = NULL;
+static uint8_t* p_spis_tx = NULL;
+static size_t spis_tx_len = 0;
+static uint8_t* p_spis_rx = NULL;
+static size_t spis_rx_len = 0;
+static bool spis_armed = false;
+
+__attribute__((weak)) void nrf_drv_spis_stub_set_hook(void)
+{
+}
+
+void app_error_stub_handler(ret_code_t err_code, const char* p_file, int line)
+{
+    (void)fprintf(stderr, "APP_ERROR_CHECK 0x%lX at %s:%d\n", (unsigned long)err_code, p_file, line);
+    abort();
+}
+
+void nrf_log_stub_printf(const char* p_format, ...)
+{
+    char line[128];
+    va_list args;
+    va_start(args, p_format);
+    int len = vsnprintf(line, sizeof(line), p_format, args);
+    va_end(args);
+    nrf_log_stub_pending += (uint32_t)(NRF_LOG_STUB_PREFIX_LEN + (uint32_t)len + NRF_LOG_STUB_EOL_LEN);
+}
+
+void nrf_log_stub_hexdump(uint32_t length)
+{
+    //The hex column of every line is padded to the full line, then the separator and the characters
+    uint32_t lines = (length + NRF_LOG_STUB_HEXDUMP_LINE - 1U) / NRF_LOG_STUB_HEXDUMP_LINE;
+    nrf_log_stub_pending += (uint32_t)(lines * (NRF_LOG_STUB_PREFIX_LEN + (NRF_LOG_STUB_HEXDUMP_LINE * 3U) + 1U + NRF_LOG_STUB_EOL_LEN)) + length;
+}
+
+void nrf_log_stub_flush(void)
+{
+    nrf_log_stub_flushed += nrf_log_stub_pending;
+    nrf_log_stub_pending = 0;
+}
+
+ret_code_t nrf_drv_spis_init(nrf_drv_spis_t const* p_instance, nrf_drv_spis_config_t const* p_config, nrf_drv_spis_event_handler_t event_handler)
+{
+    (void)p_instance;
+    (void)p_config;
+    spis_handler = event_handler;
+    spis_armed = false;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_drv_spis_buffers_set(nrf_drv_spis_t const* p_instance, uint8_t* p_tx_buffer, size_t tx_buffer_length, uint8_t* p_rx_buffer, size_t rx_buffer_length)
+{
+    //Setting the buffers again before a transfer is allowed, as by the driver once the semaphore is acquired
+    (void)p_instance;
+    p_spis_tx = p_tx_buffer;
+    spis_tx_len = tx_buffer_length;
+    p_spis_rx = p_rx_buffer;
+    spis_rx_len = rx_buffer_length;
+    spis_armed = true;
+    nrf_drv_spis_stub_set_hook();
+
+    nrf_drv_spis_event_t event = { .evt_type = NRFX_SPIS_BUFFERS_SET_DONE, .rx_amount = 0, .tx_amount = 0 };
+    spis_handler(event);
+    return NRF_SUCCESS;
+}
+
+bool nrf_drv_spis_stub_armed(void)
+{
+    return spis_armed;
+}
+
+/**
+ * @brief Clock a transfer through the buffers and report it to the handler
+ *
+ * @param p_mosi The data of the master, NULL to send zeros.
+ * @param p_miso The buffer for the data of the slave, NULL to discard it.
+ * @param clocks The number of bytes clocked.
+ */
+static void nrf_drv_spis_stub_xfer(const uint8_t* p_mosi, uint8_t* p_miso, size_t clocks)
+{
+    nrf_drv_spis_event_t event = { .evt_type = NRFX_SPIS_XFER_DONE, .rx_amount = 0, .tx_amount = 0 };
+    event.rx_amount = (clocks > spis_rx_len) ? spis_rx_len : clocks;
+    event.tx_amount = (clocks > spis_tx_len) ? spis_tx_len : clocks;
+    if (p_mosi != NULL)
+    {
+        memcpy(p_spis_rx, p_mosi, event.rx_amount);
+    }
+    else
+    {
+        memset(p_spis_rx, 0, event.rx_amount);
+    }
+    if (p_miso != NULL)
+    {
+        memcpy(p_miso, p_spis_tx, event.tx_amount);
+    }
+    spis_armed = false;
+    spis_handler(event);
+}
+
+size_t nrf_drv_spis_stub_write(const uint8_t* p_data, size_t length)
+{
+    if (!spis_armed)
+    {
+        return 0;
+    }
+    size_t rx_len = (length > spis_rx_len) ? spis_rx_len : length;
+    nrf_drv_spis_stub_xfer(p_data, NULL, length);
+    return rx_len;
+}
+
+size_t nrf_drv_spis_stub_read(uint8_t* p_data)
+{
+    if (!spis_armed || spis_tx_len == 0)
+    {
+        return 0;
+    }
+    //The master reads the length byte first and keeps CSn low for the data
+    size_t len = p_spis_tx[0];
+    if (len + 1 > spis_tx_len)
+    {
+        len = spis_tx_len - 1;
+    }
+    uint8_t miso[1 + 0xFF];
+    nrf_drv_spis_stub_xfer(NULL, miso, 1 + len);
+    memcpy(p_data, &miso[1], len);
+    return len;
+}
@@ -0,0 +1,13 @@
+/**
+ * @file sdk_config.h
+ * @brief Host stand-in for the SDK configuration, with the application options the tested sources use
+ * @copyright Copyright (c) 2024
+ */
+#ifndef BLE_HOST_TEST_SDK_CONFIG_H_
+#define BLE_HOST_TEST_SDK_CONFIG_H_
+
+#define APP_SP_DEBUG_ENABLE                 false
+#define APP_BLE_NUS_PACK_ENABLE             false
+#define APP_UNITY_TEST_ENABLE               true        //Builds the test hooks of the tested sources
+
+#endif
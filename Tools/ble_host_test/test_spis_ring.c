@@ -0,0 +1,262 @@
+/**
+ * @file test_spis_ring.c
+ * @brief Test of the tx ring and rx queue of the SPI slave port, against the real app_sp_spis.c
+ *
+ * A master reads [length][data] while BLE_REQ is set and writes frames while it is clear, as the MCU does.
+ * Frames of random sizes are put whenever they fit, so the tx ring wraps at every offset, and each transfer
+ * is read either by the master or by app_sp_spis_tx_take of the on-target test. The data read must be the
+ * data put, in order, and every frame written must reach app_sp_on_rx_data intact and in order, also while
+ * the forwarding buffer has no room and the slave pauses.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <string.h>
+#include "app_sp.h"
+#include "app_sp_spis.h"
+#include "custom_board.h"
+#include "nrf_drv_spis.h"
+#include "nrf_gpio.h"
+
+#define TEST_ROUNDS             200000U
+#define TEST_STREAM_SIZE        (1U << 24)      /*!< The tx data put in a run, the stream index wraps over it */
+#define TEST_RING_CAPACITY      (DATA_BUFFER_MAX_SIZE * 2U - 2U)
+#define TEST_TX_FRAME_MAX       244U            /*!< The largest frame of one notification */
+#define TEST_RX_FRAME_MAX       240U            /*!< The largest frame of the MCU */
+#define TEST_RX_SPACE_MAX       DATA_BUFFER_GROUP_COUNT
+
+static uint32_t failures = 0;
+static uint32_t rng_state = 1;
+
+static uint32_t tx_put = 0;                     /*!< The tx data put so far */
+static uint32_t tx_read = 0;                    /*!< The tx data read so far */
+static uint32_t tx_xfers = 0;
+static uint32_t tx_takes = 0;
+
+static uint16_t rx_frame_len[8];                /*!< The lengths of the frames written and not received yet */
+static uint32_t rx_written = 0;
+static uint32_t rx_received = 0;
+static uint8_t rx_space = TEST_RX_SPACE_MAX;
+static app_sp_stat_t sp_stat;
+
+#define CHECK_EQ(EXPECTED, ACTUAL, ...)                                                 \
+    do                                                                                  \
+    {                                                                                   \
+        if ((uint32_t)(EXPECTED) != (uint32_t)(ACTUAL))                                 \
+        {                                                                               \
+            (void)printf("FAIL %s:%d expected %lu, got %lu: ", __FILE__, __LINE__,      \
+                    (unsigned long)(EXPECTED), (unsigned long)(ACTUAL));                \
+            (void)printf(__VA_ARGS__);                                                  \
+            (void)printf("\n");                                                         \
+            failures++;                                                                 \
+        }                                                                               \
+    } while (0)
+
+static uint32_t rng_next(uint32_t range)
+{
+    rng_state = (rng_state * 1103515245UL) + 12345UL;
+    return (rng_state >> 8) % range;
+}
+
+/**
+ * @brief The byte at an index of the tx stream, not a multiple of 256 so it does not line up with the ring
+ *
+ */
+static uint8_t tx_stream_byte(uint32_t index)
+{
+    return (uint8_t)((index * 7U) + (index / 251U));
+}
+
+static uint8_t rx_frame_byte(uint32_t seq, uint16_t i)
+{
+    return (uint8_t)((seq * 31U) + i);
+}
+
+uint8_t app_sp_rx_space_get(void)
+{
+    return rx_space;
+}
+
+app_sp_stat_t* app_sp_stat_get(void)
+{
+    return &sp_stat;
+}
+
+void app_sp_on_tx_ready(uint8_t port)
+{
+    (void)port;
+}
+
+/**
+ * @brief Check a received frame against the oldest frame written
+ *
+ */
+void app_sp_on_rx_data(uint8_t port, uint8_t const* data, uint16_t size)
+{
+    CHECK_EQ(SP_SPI, port, "rx port");
+    if (rx_received == rx_written)
+    {
+        CHECK_EQ(0, size, "rx frame %lu not written", (unsigned long)rx_received);
+        return;
+    }
+    uint32_t seq = rx_received++;
+    CHECK_EQ(rx_frame_len[seq % 8U], size, "rx frame %lu length", (unsigned long)seq);
+    for (uint16_t i = 0; i < size; i++)
+    {
+        if (data[i] != rx_frame_byte(seq, i))
+        {
+            CHECK_EQ(rx_frame_byte(seq, i), data[i], "rx frame %lu byte %u", (unsigned long)seq, i);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Put one frame to the tx ring if it fits, app_sp_spis_put waits for room otherwise
+ *
+ */
+static void tx_frame_put(void)
+{
+    uint16_t size = (uint16_t)(1U + rng_next(TEST_TX_FRAME_MAX));
+    if ((tx_put - tx_read) + size > TEST_RING_CAPACITY)
+    {
+        return;
+    }
+    uint8_t frame[TEST_TX_FRAME_MAX];
+    for (uint16_t i = 0; i < size; i++)
+    {
+        frame[i] = tx_stream_byte((tx_put + i) % TEST_STREAM_SIZE);
+    }
+    app_sp_spis_put(frame, size);
+    tx_put += size;
+}
+
+/**
+ * @brief Read one transfer of tx data, by the master or by the test hook of the on-target test
+ *
+ */
+static void tx_xfer_read(bool take)
+{
+    uint8_t data[0xFF];
+    size_t len;
+    if (take)
+    {
+        len = app_sp_spis_tx_take(data);
+        tx_takes++;
+    }
+    else
+    {
+        len = nrf_drv_spis_stub_read(data);
+        tx_xfers++;
+    }
+    uint32_t pending = tx_put - tx_read;
+    if ((len == 0) || (len > pending))
+    {
+        CHECK_EQ(pending < 0xFFU ? pending : 0xFFU, len, "tx transfer at %lu", (unsigned long)tx_read);
+        return;
+    }
+    for (size_t i = 0; i < len; i++)
+    {
+        if (data[i] != tx_stream_byte((tx_read + (uint32_t)i) % TEST_STREAM_SIZE))
+        {
+            CHECK_EQ(tx_stream_byte((tx_read + (uint32_t)i) % TEST_STREAM_SIZE), data[i],
+                    "tx byte %lu", (unsigned long)(tx_read + (uint32_t)i));
+            break;
+        }
+    }
+    tx_read += (uint32_t)len;
+}
+
+/**
+ * @brief Write one frame, the slave must take all of it whenever BLE_RDY is set and BLE_REQ is clear
+ *
+ */
+static void rx_frame_write(void)
+{
+    if ((rx_written - rx_received) >= 8U)
+    {
+        return;
+    }
+    uint32_t seq = rx_written;
+    uint16_t size = (uint16_t)(1U + rng_next(TEST_RX_FRAME_MAX));
+    uint8_t frame[TEST_RX_FRAME_MAX];
+    for (uint16_t i = 0; i < size; i++)
+    {
+        frame[i] = rx_frame_byte(seq, i);
+    }
+    rx_frame_len[seq % 8U] = size;
+    rx_written++;
+    CHECK_EQ(size, nrf_drv_spis_stub_write(frame, size), "rx frame %lu written while BLE_RDY is set", (unsigned long)seq);
+}
+
+/**
+ * @brief Read the tx data left, the ring must end empty with all the data read
+ *
+ */
+static void tx_drain(void)
+{
+    uint32_t guard = 0;
+    while ((tx_read != tx_put) && (guard++ < 8U))
+    {
+        if (nrf_gpio_pin_out_read(BLE_RDY_PIN) == 0)
+        {
+            rx_space = TEST_RX_SPACE_MAX;
+            app_sp_spis_rx_handler();
+        }
+        tx_xfer_read(false);
+    }
+    CHECK_EQ(tx_put, tx_read, "tx data left after the drain");
+    CHECK_EQ(0, nrf_gpio_pin_out_read(BLE_REQ_PIN), "BLE_REQ set with no tx data");
+}
+
+int main(void)
+{
+    app_sp_spis_init();
+    CHECK_EQ(1, nrf_gpio_pin_out_read(BLE_RDY_PIN), "BLE_RDY after the init");
+
+    for (uint32_t round = 0; round < TEST_ROUNDS; round++)
+    {
+        switch (rng_next(8))
+        {
+            case 0:
+            case 1:
+            case 2:
+                tx_frame_put();
+                break;
+
+            case 3:
+            case 4:
+                //The main context runs, the forwarding buffer may have less room now
+                rx_space = (uint8_t)rng_next(TEST_RX_SPACE_MAX + 1U);
+                app_sp_spis_rx_handler();
+                app_sp_spis_resume();
+                break;
+
+            default:
+                if (nrf_gpio_pin_out_read(BLE_RDY_PIN) == 0)
+                {
+                    CHECK_EQ(false, nrf_drv_spis_stub_armed(), "BLE_RDY clear with the buffers set");
+                }
+                else if (nrf_gpio_pin_out_read(BLE_REQ_PIN) == 1)
+                {
+                    tx_xfer_read(rng_next(4) == 0);
+                }
+                else
+                {
+                    rx_frame_write();
+                }
+                break;
+        }
+    }
+
+    rx_space = TEST_RX_SPACE_MAX;
+    app_sp_spis_rx_handler();
+    tx_drain();
+    CHECK_EQ(rx_written, rx_received, "rx frames not received");
+
+    (void)printf("test_spis_ring: %lu tx bytes in %lu transfers and %lu takes (ring wrapped %lu times), "
+                 "%lu rx frames, %lu pauses, %lu failures\n",
+                 (unsigned long)tx_read, (unsigned long)tx_xfers, (unsigned long)tx_takes,
+                 (unsigned long)(tx_read / (TEST_RING_CAPACITY + 1U)), (unsigned long)rx_received,
+                 (unsigned long)sp_stat.rx_paused, (unsigned long)failures);
+    return (failures == 0U) ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+OpenNerve IPG Gen2 — Command Pipelining Model
+Firmware source: App/Functions/Src/app_func_command.c :: app_func_command_req_parser()
+                 App/Bsp/Src/bsp_serialport.c :: bsp_sp_cmd_handler()
+
+Estimates the commands per second a host gets over the BLE link, for the ways
+the host and the MCU can exchange commands:
+
+  1 s polling   lockstep host, the MCU serves one command per BLE access (1000 ms)
+  lockstep      lockstep host, the MCU serves commands as soon as BLE_REQ is set
+  SEQ window N  N commands outstanding in OP_SEQ frames, matched by sequence number
+
+Link model (defaults can be changed on the command line):
+  - the central writes and the peripheral notifies only at connection events
+  - at most PACKETS_PER_EVENT packets each way per connection event
+  - the host BLE stack adds HOST_LATENCY_MS each way
+  - the MCU takes MCU_TURNAROUND_MS to read, parse and write a command
+    (the 1 ms delays of the handler) plus the service time of the command
+  - the MCU queues up to SP_SPI_RESP_QUEUE_SIZE responses, so the window is
+    limited to it
+"""
+
+import argparse
+import heapq
+import math
+
+BLE_ACCESS_TIME_MS     = 1000.0
+SP_SPI_RESP_QUEUE_SIZE = 4
+
+INTERVALS_MS = [7.5, 15.0, 30.0]
+MODES = [
+    ("1 s polling", "poll", 1),
+    ("lockstep", "req", 1),
+    ("SEQ window 2", "req", 2),
+    ("SEQ window 4", "req", 4),
+]
+
+
+# ── Model ────────────────────────────────────────────────────────────────────
+
+class Link:
+    """Packet slots of the connection events, one counter per direction."""
+
+    def __init__(self, interval_ms, packets_per_event):
+        self.interval_ms = interval_ms
+        self.packets_per_event = packets_per_event
+        self.used = {}
+
+    def send(self, direction, t_ms):
+        """Return the time of the first connection event at or after t_ms with a free slot."""
+        event = math.ceil(t_ms / self.interval_ms - 1e-9)
+        while self.used.get((direction, event), 0) >= self.packets_per_event:
+            event += 1
+        self.used[(direction, event)] = self.used.get((direction, event), 0) + 1
+        return event * self.interval_ms
+
+
+def commands_per_s(interval_ms, mode, window, args, duration_ms=20000.0):
+    link = Link(interval_ms, args.packets_per_event)
+    window = min(window, SP_SPI_RESP_QUEUE_SIZE)
+    mcu_free = 0.0
+    done = 0
+    # (time the host sends the command), one entry per outstanding command
+    sends = [0.0] * window
+    heapq.heapify(sends)
+    while sends:
+        t = heapq.heappop(sends)
+        at_nrf = link.send("up", t + args.host_latency_ms)
+        if mode == "poll":
+            # One command per BLE access, the access loop returns after the first command parsed
+            start = max(math.ceil(at_nrf / BLE_ACCESS_TIME_MS) * BLE_ACCESS_TIME_MS, mcu_free)
+            mcu_free = start + BLE_ACCESS_TIME_MS
+        else:
+            start = max(at_nrf, mcu_free)
+            mcu_free = start + args.mcu_turnaround_ms + args.service_us / 1000.0
+        at_host = link.send("down", start + args.mcu_turnaround_ms + args.service_us / 1000.0) + args.host_latency_ms
+        if at_host > duration_ms:
+            continue
+        done += 1
+        heapq.heappush(sends, at_host)
+    return done * 1000.0 / duration_ms
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Commands per second of lockstep and pipelined commands.")
+    parser.add_argument("--host-latency-ms", type=float, default=3.0,
+                        help="latency of the host BLE stack each way (default: 3)")
+    parser.add_argument("--packets-per-event", type=int, default=4,
+                        help="packets each way per connection event (default: 4)")
+    parser.add_argument("--mcu-turnaround-ms", type=float, default=2.0,
+                        help="time of the MCU to read, parse and write a command (default: 2)")
+    parser.add_argument("--service-us", type=float, default=300.0,
+                        help="service time of the command on the MCU (default: 300)")
+    args = parser.parse_args()
+
+    print(f"  {'Mode':<14}" + "".join(f" {f'CI {ci:g} ms':>12}" for ci in INTERVALS_MS))
+    print(f"  {'-' * 14}" + "".join(f" {'-' * 12}" for _ in INTERVALS_MS))
+    for name, mode, window in MODES:
+        rates = [commands_per_s(ci, mode, window, args) for ci in INTERVALS_MS]
+        print(f"  {name:<14}" + "".join(f" {rate:>9.1f} /s" for rate in rates))
+
+
+if __name__ == "__main__":
+    main()
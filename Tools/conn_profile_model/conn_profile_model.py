@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""
+OpenNerve IPG Gen2 — BLE Connection Profile Model
+Firmware source: FW-BLE/app/app_ble.c :: conn_profile_timer_handler()
+
+Estimates the radio-on time per minute of the nRF52810 for typical session
+scripts, with the connection parameters fixed at the fast profile and with the
+workload-aware profiles:
+
+  FAST   7.5 ~ 20 ms interval, slave latency 0   (bulk transfers, streaming)
+  IDLE   75 ~ 100 ms interval, slave latency 2   (idle sessions)
+
+Profile rules (mirrors the firmware):
+  - the traffic of the connection is checked every CONN_PROFILE_CHECK_MS
+  - >= CONN_PROFILE_BULK_BYTES in one check   -> FAST
+  - CONN_PROFILE_IDLE_COUNT checks in a row below CONN_PROFILE_IDLE_BYTES -> IDLE
+
+Radio model (1M PHY, defaults can be changed on the command line):
+  - every connection event the peripheral listens costs EVENT_BASE_US
+  - every notification / write of up to 244 bytes costs PACKET_US
+  - with slave latency the peripheral skips events while it has nothing to send
+  - the central uses the maximum interval of the requested range
+"""
+
+import argparse
+import math
+
+CONN_PROFILE_CHECK_MS   = 1000
+CONN_PROFILE_BULK_BYTES = 512
+CONN_PROFILE_IDLE_BYTES = 64
+CONN_PROFILE_IDLE_COUNT = 10
+
+PROFILES = {
+    "FAST": {"interval_ms": 20.0,  "latency": 0},
+    "IDLE": {"interval_ms": 100.0, "latency": 2},
+}
+
+DATA_LEN = 244
+
+# ── Session scripts ──────────────────────────────────────────────────────────
+# Each script is a list of (duration_s, bytes_per_s) phases.
+
+SESSIONS = {
+    "idle clinician session": [
+        (60, 10),           # status polls and the odd parameter read
+    ],
+    "clinician programming": [
+        (10, 2000), (20, 10), (10, 2000), (20, 10),
+    ],
+    "sensor streaming (ENG)": [
+        (60, 10300),        # 100 samples of 5 kHz every 20 ms, 206-byte frames
+    ],
+    "OTA download": [
+        (60, 8000),         # 240-byte chunks, limited by the FRAM write
+    ],
+    "stream then idle": [
+        (20, 10300), (40, 0),
+    ],
+}
+
+
+# ── Model ────────────────────────────────────────────────────────────────────
+
+def radio_on_ms(session, adaptive, event_base_us, packet_us):
+    """Return (radio-on ms per minute, bytes not sent at the end of the session)."""
+    profile = "FAST"
+    idle_count = 0
+    backlog = 0.0
+    radio_us = 0.0
+    total_s = 0
+
+    for duration_s, rate in session:
+        for _ in range(duration_s):
+            params = PROFILES[profile]
+            events = 1000.0 / params["interval_ms"]
+            backlog += rate
+            # Events the peripheral listens to: all of them while it has data,
+            # else one in (latency + 1).
+            packets = math.ceil(backlog / DATA_LEN)
+            capacity = int(params["interval_ms"] * 1000 // packet_us) * events
+            sent = min(packets, capacity)
+            busy_events = min(events, math.ceil(sent / max(1, capacity / events)))
+            quiet_events = (events - busy_events) / (params["latency"] + 1)
+            radio_us += (busy_events + quiet_events) * event_base_us + sent * packet_us
+            sent_bytes = min(backlog, sent * DATA_LEN)
+            backlog -= sent_bytes
+
+            if adaptive:
+                if sent_bytes >= CONN_PROFILE_BULK_BYTES:
+                    idle_count = 0
+                    profile = "FAST"
+                elif sent_bytes >= CONN_PROFILE_IDLE_BYTES:
+                    idle_count = 0
+                elif idle_count < CONN_PROFILE_IDLE_COUNT:
+                    idle_count += 1
+                else:
+                    profile = "IDLE"
+            total_s += 1
+
+    return radio_us / 1000.0 * 60.0 / total_s, backlog
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Radio-on time per minute of the BLE connection profiles.")
+    parser.add_argument("--event-base-us", type=float, default=400.0,
+                        help="radio time of a connection event without data (default: 400)")
+    parser.add_argument("--packet-us", type=float, default=2500.0,
+                        help="radio time of a 244-byte packet and its ack (default: 2500)")
+    args = parser.parse_args()
+
+    print(f"  {'Session':<26} {'Fixed FAST':>14} {'Adaptive':>14} {'Saved':>8}")
+    print(f"  {'-' * 26} {'-' * 14} {'-' * 14} {'-' * 8}")
+    for name, session in SESSIONS.items():
+        fixed, fixed_left = radio_on_ms(session, False, args.event_base_us, args.packet_us)
+        adaptive, adaptive_left = radio_on_ms(session, True, args.event_base_us, args.packet_us)
+        saved = 100.0 * (fixed - adaptive) / fixed
+        note = "" if adaptive_left <= fixed_left + DATA_LEN else "  (backlog!)"
+        print(f"  {name:<26} {fixed:>9.0f} ms/m {adaptive:>9.0f} ms/m {saved:>7.0f}%{note}")
+
+
+if __name__ == "__main__":
+    main()
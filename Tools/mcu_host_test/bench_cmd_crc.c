@@ -0,0 +1,336 @@
+/**
+ * @file bench_cmd_crc.c
+ * @brief Benchmark of the command CRC in cycles per frame, the in-place CRC of the real app_func_command.c against the copy
+ * into crc_buffer of earlier firmware, with a model of the CRC peripheral checked bit for bit against a software CRC
+ *
+ * app_func_command.c is included to reach app_func_command_frame_check and app_func_command_crc_calc. HAL_CRC_Calculate and
+ * HAL_CRC_Accumulate are replaced by a model of the peripheral as the firmware configures it, polynomial 0x1021, 16 bits,
+ * init 0xFFFF, no inversion, fed as CRC_Handle_8 feeds it: a 32-bit write per 4 bytes, then a 16-bit and an 8-bit write
+ * for the last bytes, each shifted in MSB first. Every value it gives is checked against a table-driven CRC-16/CCITT-FALSE
+ * over the same bytes, which must give the catalogue check value 0x29B1 over "123456789". The frame check must accept
+ * every request and response with a valid CRC value as what it is, and reject them with any single bit flipped.
+ * The cycles are counted from the calls, the register writes and the bytes copied, with costs assumed for a Cortex-M33
+ * at 160 MHz; they are to be replaced by the ones measured with DWT_CYCCNT on the board. A frame is LEN_CMD_MAX bytes,
+ * received as a request, alone in the buffer or followed by more data, and a response of LEN_CMD_MAX bytes sent.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include "app_func_command.c"
+
+#define BENCH_POLY				0x1021U
+#define BENCH_INIT				0xFFFFU
+#define BENCH_CHECK				0x29B1U		/*!< CRC-16/CCITT-FALSE of "123456789" */
+#define BENCH_FRAMES			500U		/*!< Frames of random lengths and kinds checked after every length */
+#define BENCH_CALL_CYCLES		40.0		/*!< A call of HAL_CRC_Calculate or HAL_CRC_Accumulate, lock, state and reset, assumed */
+#define BENCH_WR32_CYCLES		8.0			/*!< 4 byte loads packed into a 32-bit write of CRC_Handle_8, assumed */
+#define BENCH_WR16_CYCLES		5.0			/*!< 2 byte loads packed into a 16-bit write, assumed */
+#define BENCH_WR8_CYCLES		3.0			/*!< A byte load and an 8-bit write, assumed */
+#define BENCH_MEMCPY_CYCLES		10.0		/*!< A call of memcpy, assumed */
+#define BENCH_MEMCPY_PER_BYTE	0.5			/*!< Word copies of memcpy, assumed */
+
+typedef struct {
+	uint32_t	Calls;
+	uint32_t	Wr32;
+	uint32_t	Wr16;
+	uint32_t	Wr8;
+	uint32_t	Copies;
+	uint32_t	CopyBytes;
+} Bench_Count_t;
+
+static uint16_t crc_table[256];
+static uint16_t crc_ref = BENCH_INIT;		/*!< The software CRC of the bytes given to the peripheral since the last reset */
+static Bench_Count_t count;
+static uint32_t rng_state = 1;
+static uint32_t failures = 0;
+static uint32_t crc_checks = 0;			/*!< The values of the peripheral checked against the software CRC */
+static uint32_t crc_buffer[LEN_CMD_MAX / sizeof(uint32_t)];	/*!< The copy of earlier firmware */
+
+static uint8_t rng_byte(void) {
+	rng_state = (rng_state * 1103515245UL) + 12345UL;
+	return (uint8_t)(rng_state >> 16);
+}
+
+/* ---- The software CRC ---- */
+
+static void crc_table_build(void) {
+	for (uint32_t i = 0; i < 256U; i++) {
+		uint16_t crc = (uint16_t)(i << 8);
+		for (uint8_t b = 0; b < 8U; b++) {
+			crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((uint16_t)(crc << 1) ^ BENCH_POLY) : (uint16_t)(crc << 1);
+		}
+		crc_table[i] = crc;
+	}
+}
+
+static uint16_t crc_soft(uint16_t crc, const uint8_t* p_data, uint32_t length) {
+	for (uint32_t i = 0; i < length; i++) {
+		crc = (uint16_t)((uint16_t)(crc << 8) ^ crc_table[(uint8_t)(crc >> 8) ^ p_data[i]]);
+	}
+	return crc;
+}
+
+/* ---- The CRC peripheral ---- */
+
+/**
+ * @brief A write to CRC_DR of 8, 16 or 32 bits, shifted in MSB first
+ *
+ */
+static void crc_dr_write(uint32_t data, uint8_t bits) {
+	uint16_t crc = (uint16_t)hcrc.Instance->DR;
+	for (int32_t b = (int32_t)bits - 1; b >= 0; b--) {
+		uint16_t in = (uint16_t)((data >> (uint32_t)b) & 1U);
+		crc = ((((uint16_t)(crc >> 15) ^ in) & 1U) != 0U) ? (uint16_t)((uint16_t)(crc << 1) ^ BENCH_POLY) : (uint16_t)(crc << 1);
+	}
+	hcrc.Instance->DR = crc;
+	count.Wr32 += (bits == 32U) ? 1U : 0U;
+	count.Wr16 += (bits == 16U) ? 1U : 0U;
+	count.Wr8 += (bits == 8U) ? 1U : 0U;
+}
+
+/**
+ * @brief The writes of CRC_Handle_8, checked against the software CRC of the same bytes
+ *
+ */
+static uint32_t crc_handle_8(const uint8_t* p_buffer, uint32_t length) {
+	uint32_t i;
+	for (i = 0; i < (length / 4U); i++) {
+		crc_dr_write(((uint32_t)p_buffer[4U * i] << 24) | ((uint32_t)p_buffer[(4U * i) + 1U] << 16) |
+				((uint32_t)p_buffer[(4U * i) + 2U] << 8) | (uint32_t)p_buffer[(4U * i) + 3U], 32U);
+	}
+	if ((length % 4U) >= 2U) {
+		crc_dr_write(((uint32_t)p_buffer[4U * i] << 8) | (uint32_t)p_buffer[(4U * i) + 1U], 16U);
+	}
+	if ((length % 4U) == 1U) {
+		crc_dr_write(p_buffer[4U * i], 8U);
+	}
+	if ((length % 4U) == 3U) {
+		crc_dr_write(p_buffer[(4U * i) + 2U], 8U);
+	}
+
+	crc_ref = crc_soft(crc_ref, p_buffer, length);
+	if ((uint16_t)hcrc.Instance->DR != crc_ref) {
+		(void)printf("FAIL peripheral 0x%04X, software 0x%04X after %lu bytes\n", (unsigned)hcrc.Instance->DR, crc_ref,
+				(unsigned long)length);
+		failures++;
+	}
+	crc_checks++;
+	count.Calls++;
+	return hcrc.Instance->DR;
+}
+
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef* hcrc_, uint32_t* p_buffer, uint32_t length) {
+	hcrc_->Instance->DR = hcrc_->Instance->INIT;
+	crc_ref = BENCH_INIT;
+	return crc_handle_8((const uint8_t*)p_buffer, length);
+}
+
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef* hcrc_, uint32_t* p_buffer, uint32_t length) {
+	return crc_handle_8((const uint8_t*)p_buffer, length);
+}
+
+void bsp_sp_cmd_send(const uint8_t* data, uint8_t data_len) {
+}
+
+/* ---- Earlier firmware ---- */
+
+/**
+ * @brief The CRC check of earlier firmware, the command is copied into crc_buffer first
+ *
+ */
+static bool crc_confirm_copy(const uint8_t* p_cmd, uint16_t cmd_len) {
+	uint16_t cmd_crc16 = 0;
+	(void)memcpy((uint8_t*)crc_buffer, p_cmd, (uint32_t)cmd_len - LEN_CRC);
+	count.Copies++;
+	count.CopyBytes += (uint32_t)cmd_len - LEN_CRC;
+	(void)memcpy((uint8_t*)&cmd_crc16, &p_cmd[cmd_len - LEN_CRC], LEN_CRC);
+	uint16_t cal_crc16 = (uint16_t)HAL_CRC_Calculate(&hcrc, crc_buffer, (uint32_t)cmd_len - LEN_CRC);
+	return (cmd_crc16 == cal_crc16);
+}
+
+/**
+ * @brief The frame check of earlier firmware, as a response command first and then as a request command
+ *
+ */
+static uint16_t frame_check_copy(const uint8_t* p_cmd, uint16_t data_len, bool* p_is_resp) {
+	uint16_t resp_len = LEN_RESP_HEADER + (uint16_t)p_cmd[1] + LEN_CRC;
+	uint16_t req_len = LEN_REQ_HEADER + (uint16_t)p_cmd[1] + LEN_CRC;
+	if ((data_len >= resp_len) && crc_confirm_copy(p_cmd, resp_len)) {
+		*p_is_resp = true;
+		return resp_len;
+	}
+	if ((data_len >= req_len) && crc_confirm_copy(p_cmd, req_len)) {
+		*p_is_resp = false;
+		return req_len;
+	}
+	return 0;
+}
+
+/**
+ * @brief The CRC of a response of earlier firmware, copied into crc_buffer first
+ *
+ */
+static uint16_t crc_calc_copy(const uint8_t* p_cmd, uint16_t len) {
+	(void)memcpy((uint8_t*)crc_buffer, p_cmd, len);
+	count.Copies++;
+	count.CopyBytes += len;
+	return (uint16_t)HAL_CRC_Calculate(&hcrc, crc_buffer, len);
+}
+
+/* ---- The frames ---- */
+
+/**
+ * @brief Put a command with a valid CRC value into the buffer, followed by random data
+ *
+ * @return uint16_t The length of the command
+ */
+static uint16_t frame_put(uint8_t* p_data, uint8_t payload_len, bool is_resp, uint16_t buff_len) {
+	uint16_t header_len = is_resp ? LEN_RESP_HEADER : LEN_REQ_HEADER;
+	for (uint16_t i = 0; i < buff_len; i++) {
+		p_data[i] = rng_byte();
+	}
+	p_data[1] = payload_len;
+	uint16_t crc = crc_soft(BENCH_INIT, p_data, header_len + (uint32_t)payload_len);
+	(void)memcpy(&p_data[header_len + payload_len], &crc, LEN_CRC);
+	return (uint16_t)(header_len + payload_len + LEN_CRC);
+}
+
+/**
+ * @brief A valid command is found as what it is, and not found with any single bit of it flipped
+ *
+ */
+static void frame_check_flips(uint8_t payload_len, bool is_resp) {
+	uint8_t data[LEN_CMD_MAX + 8U];
+	uint16_t cmd_len = frame_put(data, payload_len, is_resp, (uint16_t)sizeof(data));
+	//A request is checked with one byte more, so that it is also checked as a response, which that byte must not make valid
+	uint16_t data_len = is_resp ? cmd_len : (uint16_t)(cmd_len + 1U);
+	while (!is_resp && (crc_soft(BENCH_INIT, data, cmd_len - 1U) == (uint16_t)(data[cmd_len - 1U] | ((uint16_t)data[cmd_len] << 8)))) {
+		data[cmd_len]++;
+	}
+	bool found_resp = !is_resp;
+	uint16_t len = app_func_command_frame_check(data, data_len, &found_resp);
+	if ((len != cmd_len) || (found_resp != is_resp)) {
+		(void)printf("FAIL %s of %u bytes found as %u bytes, %s\n", is_resp ? "response" : "request", cmd_len, len,
+				found_resp ? "response" : "request");
+		failures++;
+	}
+	for (uint16_t bit = 0; bit < (cmd_len * 8U); bit++) {
+		data[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+		//A flip of the length byte changes the frame, the CRC of the new frame is not the one checked
+		if ((bit / 8U) != 1U) {
+			bool resp = false;
+			len = app_func_command_frame_check(data, data_len, &resp);
+			if (len == cmd_len) {
+				(void)printf("FAIL %s of %u bytes found with bit %u flipped\n", is_resp ? "response" : "request", cmd_len, bit);
+				failures++;
+			}
+		}
+		data[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+	}
+}
+
+static double cycles_get(const Bench_Count_t* p_count) {
+	return ((double)p_count->Calls * BENCH_CALL_CYCLES) + ((double)p_count->Wr32 * BENCH_WR32_CYCLES) +
+			((double)p_count->Wr16 * BENCH_WR16_CYCLES) + ((double)p_count->Wr8 * BENCH_WR8_CYCLES) +
+			((double)p_count->Copies * BENCH_MEMCPY_CYCLES) + ((double)p_count->CopyBytes * BENCH_MEMCPY_PER_BYTE);
+}
+
+static void count_print(const char* p_name, double cycles_before) {
+	double cycles = cycles_get(&count);
+	(void)printf("  %-34s %5lu %5lu %6lu %8.0f", p_name, (unsigned long)count.Calls,
+			(unsigned long)((count.Wr32 * 4U) + (count.Wr16 * 2U) + count.Wr8), (unsigned long)count.CopyBytes, cycles);
+	if (cycles_before > 0.0) {
+		(void)printf(" %7.2fx\n", cycles_before / cycles);
+	}
+	else {
+		(void)printf("\n");
+	}
+}
+
+/**
+ * @brief Cycles of one LEN_CMD_MAX frame by earlier firmware and by app_func_command.c
+ *
+ */
+static void bench_frames(void) {
+	uint8_t data[SP_BUF_SIZE];
+	bool is_resp = false;
+	const uint8_t payload_req = (uint8_t)LEN_REQ_PAYLOAD_MAX;
+	const uint8_t payload_resp = (uint8_t)LEN_RESP_PAYLOAD_MAX;
+
+	(void)printf("  %-34s %5s %5s %6s %8s %8s\n", "Frame of LEN_CMD_MAX bytes", "calls", "CRC B", "copy B", "cycles", "speedup");
+	for (uint32_t k = 0; k < 2U; k++) {
+		//The request alone in the buffer, or followed by more data so that it is also checked as a response
+		uint16_t buff_len = (k == 0U) ? LEN_CMD_MAX : (uint16_t)sizeof(data);
+		const char* p_kind = (k == 0U) ? "alone" : "followed by data";
+		char name[48];
+		uint16_t cmd_len = frame_put(data, payload_req, false, buff_len);
+		//The byte after the request must not make it a valid response
+		while ((buff_len > cmd_len) && (crc_soft(BENCH_INIT, data, cmd_len - 1U) == (uint16_t)(data[cmd_len - 1U] | ((uint16_t)data[cmd_len] << 8)))) {
+			data[cmd_len]++;
+		}
+
+		(void)memset(&count, 0, sizeof(count));
+		uint16_t len = frame_check_copy(data, buff_len, &is_resp);
+		double cycles_before = cycles_get(&count);
+		(void)snprintf(name, sizeof(name), "request %s, copy", p_kind);
+		count_print(name, 0.0);
+		if ((len != cmd_len) || is_resp) {
+			(void)printf("FAIL earlier frame check of the request %s\n", p_kind);
+			failures++;
+		}
+
+		(void)memset(&count, 0, sizeof(count));
+		len = app_func_command_frame_check(data, buff_len, &is_resp);
+		(void)snprintf(name, sizeof(name), "request %s, in place", p_kind);
+		count_print(name, cycles_before);
+		if ((len != cmd_len) || is_resp) {
+			(void)printf("FAIL frame check of the request %s\n", p_kind);
+			failures++;
+		}
+	}
+
+	uint16_t resp_len = frame_put(data, payload_resp, true, LEN_CMD_MAX);
+	uint16_t crc_expected = 0;
+	(void)memcpy(&crc_expected, &data[resp_len - LEN_CRC], LEN_CRC);
+	(void)memset(&count, 0, sizeof(count));
+	uint16_t crc_before = crc_calc_copy(data, (uint16_t)(resp_len - LEN_CRC));
+	double cycles_before = cycles_get(&count);
+	count_print("response sent, copy", 0.0);
+	(void)memset(&count, 0, sizeof(count));
+	uint16_t crc = app_func_command_crc_calc(data, LEN_RESP_HEADER, &data[LEN_RESP_HEADER], payload_resp);
+	count_print("response sent, in place", cycles_before);
+	if ((crc != crc_expected) || (crc_before != crc_expected)) {
+		(void)printf("FAIL response CRC 0x%04X, earlier 0x%04X, expected 0x%04X\n", crc, crc_before, crc_expected);
+		failures++;
+	}
+}
+
+int main(void) {
+	crc_table_build();
+	if (crc_soft(BENCH_INIT, (const uint8_t*)"123456789", 9U) != BENCH_CHECK) {
+		(void)printf("FAIL software CRC of \"123456789\" is not 0x%04X\n", BENCH_CHECK);
+		failures++;
+	}
+	hcrc.Instance->INIT = BENCH_INIT;
+	if ((uint16_t)HAL_CRC_Calculate(&hcrc, (uint32_t*)"123456789", 9U) != BENCH_CHECK) {
+		(void)printf("FAIL peripheral CRC of \"123456789\" is not 0x%04X\n", BENCH_CHECK);
+		failures++;
+	}
+
+	//Every length of both kinds, then random ones
+	for (uint32_t p = 0; p <= LEN_REQ_PAYLOAD_MAX; p++) {
+		frame_check_flips((uint8_t)p, false);
+		if (p <= LEN_RESP_PAYLOAD_MAX) {
+			frame_check_flips((uint8_t)p, true);
+		}
+	}
+	for (uint32_t f = 0; f < BENCH_FRAMES; f++) {
+		frame_check_flips((uint8_t)(rng_byte() % (LEN_RESP_PAYLOAD_MAX + 1U)), (rng_byte() & 1U) != 0U);
+	}
+
+	(void)printf("bench_cmd_crc: %lu CRC values of the peripheral equal to the software CRC, cycles assumed for a Cortex-M33 at 160 MHz\n",
+			(unsigned long)crc_checks);
+	bench_frames();
+
+	(void)printf("bench_cmd_crc: %lu failures\n", (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+/**
+ * @file bench_cmd_parser.c
+ * @brief Benchmark of the resynchronization of app_func_command_parser, against the real app_func_command.c
+ *
+ * A receive buffer holding corrupted data is parsed until it is drained, as the serial port handler does.
+ * The CRC peripheral is the cost on the MCU, so the bytes given to it are counted, and the host time is
+ * measured as well. The cases are random data, valid commands behind a corrupted command, and a valid command
+ * behind a corrupted command split over two transfers, the start of it must be kept until the rest is received
+ * with the next commands.
+ * Older sources are benchmarked by pointing MCU of the Makefile to their tree.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "app_config.h"
+
+#define BENCH_ROUNDS			2000U
+#define BENCH_BUF_LEN			240U		/*!< The data of a full SPIS transfer */
+
+static uint16_t crc_value = 0xFFFFU;
+static uint64_t crc_bytes = 0;				/*!< The bytes given to the CRC peripheral */
+static uint32_t req_count = 0;
+static uint32_t rng_state = 1;
+
+static uint16_t crc_update(uint16_t crc, const uint8_t* p_data, uint32_t length) {
+	for(uint32_t i=0;i<length;i++) {
+		crc ^= (uint16_t)((uint16_t)p_data[i] << 8);
+		for(uint8_t b=0;b<8U;b++) {
+			crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((uint16_t)(crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef* hcrc_, uint32_t* p_buffer, uint32_t length) {
+	UNUSED(hcrc_);
+	crc_bytes += length;
+	crc_value = crc_update(0xFFFFU, (const uint8_t*)p_buffer, length);
+	return crc_value;
+}
+
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef* hcrc_, uint32_t* p_buffer, uint32_t length) {
+	UNUSED(hcrc_);
+	crc_bytes += length;
+	crc_value = crc_update(crc_value, (const uint8_t*)p_buffer, length);
+	return crc_value;
+}
+
+void bsp_sp_cmd_send(const uint8_t* data, uint8_t data_len) {
+	UNUSED(data);
+	UNUSED(data_len);
+}
+
+static uint8_t rng_byte(void) {
+	rng_state = (rng_state * 1103515245UL) + 12345UL;
+	return (uint8_t)(rng_state >> 16);
+}
+
+static void bench_req_parser(const Cmd_Req_t* p_cmd_req, Cmd_Resp_t* p_cmd_resp) {
+	UNUSED(p_cmd_req);
+	p_cmd_resp->PayloadLen = 0;
+	req_count++;
+}
+
+static void bench_resp_parser(const Cmd_Resp_t* p_cmd_resp) {
+	UNUSED(p_cmd_resp);
+}
+
+/**
+ * @brief Put a valid READ_TIME_AND_DATE request into the buffer
+ *
+ * @return uint8_t The length of the request
+ */
+static uint8_t req_put(uint8_t* p_data, uint8_t payload_len) {
+	p_data[0] = OP_READ_TIME_AND_DATE;
+	p_data[1] = payload_len;
+	for(uint8_t i=0;i<payload_len;i++) {
+		p_data[LEN_REQ_HEADER + i] = rng_byte();
+	}
+	uint16_t crc = crc_update(0xFFFFU, p_data, LEN_REQ_HEADER + (uint32_t)payload_len);
+	(void)memcpy(&p_data[LEN_REQ_HEADER + payload_len], &crc, LEN_CRC);
+	return (uint8_t)(LEN_REQ_HEADER + payload_len + LEN_CRC);
+}
+
+/**
+ * @brief Parse the buffer until it is drained, or until only a command not complete is left
+ *
+ */
+static void buffer_parse(uint8_t* p_data, uint8_t* p_head, uint8_t* p_len) {
+	uint8_t tx[LEN_CMD_MAX];
+	while(*p_len > 0U) {
+		uint8_t len_before = *p_len;
+		(void)app_func_command_parser(p_data, p_head, p_len, tx);
+		if (*p_len == len_before) {
+			break;
+		}
+	}
+}
+
+typedef void (*Bench_Fill)(uint8_t* p_data, uint8_t* p_len, uint32_t* p_reqs);
+
+static uint8_t split_rest[LEN_CMD_MAX];		/*!< The rest of the split request, received by the next transfer */
+static uint8_t split_rest_len = 0;
+
+static void fill_random(uint8_t* p_data, uint8_t* p_len, uint32_t* p_reqs) {
+	for(uint8_t i=0;i<BENCH_BUF_LEN;i++) {
+		p_data[i] = rng_byte();
+	}
+	*p_len = BENCH_BUF_LEN;
+	*p_reqs = 0;
+	split_rest_len = 0;
+}
+
+/**
+ * @brief A request with a corrupted byte, followed by valid requests
+ *
+ */
+static void fill_corrupted(uint8_t* p_data, uint8_t* p_len, uint32_t* p_reqs) {
+	uint8_t len = req_put(p_data, 40U);
+	p_data[10] ^= 0x5AU;
+	*p_reqs = 0;
+	while((len + LEN_REQ_HEADER + 16U + LEN_CRC) <= BENCH_BUF_LEN) {
+		len += req_put(&p_data[len], 16U);
+		(*p_reqs)++;
+	}
+	*p_len = len;
+	split_rest_len = 0;
+}
+
+/**
+ * @brief A request with a corrupted byte, followed by the start of a valid request split over two transfers.
+ * The next transfer holds the rest of it and valid requests.
+ *
+ */
+static void fill_split(uint8_t* p_data, uint8_t* p_len, uint32_t* p_reqs) {
+	uint8_t len = req_put(p_data, 40U);
+	p_data[10] ^= 0x5AU;
+	uint8_t req[LEN_REQ_HEADER + 16U + LEN_CRC];
+	(void)req_put(req, 16U);
+	uint8_t split_len = (uint8_t)(1U + (rng_byte() % (sizeof(req) - 1U)));
+	(void)memcpy(&p_data[len], req, split_len);
+	split_rest_len = (uint8_t)(sizeof(req) - split_len);
+	(void)memcpy(split_rest, &req[split_len], split_rest_len);
+	*p_len = len + split_len;
+	*p_reqs = 1;
+	while((split_rest_len + sizeof(req)) <= BENCH_BUF_LEN) {
+		split_rest_len += req_put(&split_rest[split_rest_len], 16U);
+		(*p_reqs)++;
+	}
+}
+
+static void bench_run(const char* p_name, Bench_Fill fill) {
+	uint8_t data[SP_BUF_SIZE];
+	uint8_t len = 0;
+	uint32_t reqs_expected = 0;
+	uint32_t reqs_total = 0;
+	double ns_total = 0;
+	crc_bytes = 0;
+	req_count = 0;
+
+	for(uint32_t r=0;r<BENCH_ROUNDS;r++) {
+		fill(data, &len, &reqs_expected);
+		reqs_total += reqs_expected;
+		struct timespec t0;
+		struct timespec t1;
+		(void)clock_gettime(CLOCK_MONOTONIC, &t0);
+		uint8_t head = 0;
+		buffer_parse(data, &head, &len);
+		//The next transfers, the data left is moved to the start of the buffer and the rest is read after it
+		uint8_t rest_index = 0;
+		while(rest_index < split_rest_len) {
+			(void)memmove(data, &data[head], len);
+			head = 0;
+			uint8_t rd_len = (uint8_t)(SP_BUF_SIZE - len);
+			rd_len = (rd_len < (split_rest_len - rest_index)) ? rd_len : (uint8_t)(split_rest_len - rest_index);
+			if (rd_len == 0U) {
+				break;
+			}
+			(void)memcpy(&data[len], &split_rest[rest_index], rd_len);
+			rest_index += rd_len;
+			len += rd_len;
+			buffer_parse(data, &head, &len);
+		}
+		(void)clock_gettime(CLOCK_MONOTONIC, &t1);
+		ns_total += ((double)(t1.tv_sec - t0.tv_sec) * 1e9) + (double)(t1.tv_nsec - t0.tv_nsec);
+	}
+	(void)printf("  %-34s %8.0f CRC bytes %8.1f us   %lu/%lu requests parsed\n", p_name,
+			(double)crc_bytes / BENCH_ROUNDS, ns_total / BENCH_ROUNDS / 1000.0,
+			(unsigned long)req_count, (unsigned long)reqs_total);
+}
+
+int main(void) {
+	app_func_command_req_parser_set(&bench_req_parser);
+	app_func_command_resp_parser_set(&bench_resp_parser);
+	(void)printf("bench_cmd_parser: per %u-byte buffer, average of %u rounds\n", BENCH_BUF_LEN, BENCH_ROUNDS);
+	bench_run("random data", &fill_random);
+	bench_run("corrupted request, valid requests", &fill_corrupted);
+	bench_run("corrupted request, split request", &fill_split);
+	return 0;
+}
@@ -0,0 +1,249 @@
+/**
+ * @file bench_cmd_stack.c
+ * @brief Benchmark of the stack and the copies of a command through the dispatch chain, from app_func_command_parser
+ * to the parser of the BLE connection mode, against the real app_func_command.c and app_mode_ble_connection.c
+ *
+ * app_mode_ble_connection.c is included to set its parser as the request parser, as its handler does.
+ * Each request is received with a valid CRC value and parsed as the serial port handler does, the response is written
+ * into the transmit frame. The parser runs on a stack of its own filled with a pattern, and the stack high-water mark is
+ * the depth the pattern is overwritten to. memcpy and memmove are wrapped to count the bytes they copy, the sources are
+ * built with -fno-builtin so that every copy goes through them; the structs passed by value are copied by the compiler
+ * and are not counted. The figures are for the host build, the stack of the Cortex-M33 build differs but follows the
+ * same frames. The bench is linked with -z now, a symbol bound lazily on its first call saves the vector registers on
+ * the stack of the caller and would add some KB to the first command that calls it.
+ * @copyright Copyright (c) 2024
+ */
+#include <ucontext.h>
+#include "app_mode_ble_connection.c"
+
+#define BENCH_STACK_SIZE		65536U
+#define BENCH_STACK_FILL		0xA5U
+#define BENCH_ROUNDS			100U		/*!< Requests of each command, the copies are averaged */
+
+typedef struct {
+	const char*	Name;
+	uint8_t		Opcode;
+	uint8_t		Payload[LEN_REQ_PAYLOAD_MAX];
+	uint8_t		PayloadLen;
+} Bench_Cmd_t;
+
+void* __real_memcpy(void* p_dst, const void* p_src, size_t len);
+void* __real_memmove(void* p_dst, const void* p_src, size_t len);
+
+static uint8_t fram[CY15B108QN_MAX_ADDR + 1UL];
+static uint8_t bench_stack[BENCH_STACK_SIZE];
+static ucontext_t ctx_main;
+static ucontext_t ctx_parser;
+static bool copies_counted = false;
+static uint64_t copy_bytes = 0;
+static uint64_t copy_calls = 0;
+static uint8_t rx[SP_BUF_SIZE];
+static uint8_t rx_head = 0;
+static uint8_t rx_len = 0;
+static uint8_t tx[LEN_CMD_MAX];
+static uint8_t tx_len = 0;
+static uint32_t failures = 0;
+
+extern Parameter_t parameters_list[];
+extern const uint16_t parameters_list_size;
+
+void* __wrap_memcpy(void* p_dst, const void* p_src, size_t len) {
+	if (copies_counted) {
+		copy_bytes += len;
+		copy_calls++;
+	}
+	return __real_memcpy(p_dst, p_src, len);
+}
+
+void* __wrap_memmove(void* p_dst, const void* p_src, size_t len) {
+	if (copies_counted) {
+		copy_bytes += len;
+		copy_calls++;
+	}
+	return __real_memmove(p_dst, p_src, len);
+}
+
+/* ---- Fakes of the functions the modules call, all of them succeed ---- */
+
+bool vnsb_en = false;
+
+uint8_t app_mode_ble_act_userclass_get(void) { return USER_CLASS_ADMIN; }
+bool app_func_auth_verify_sign_admin(ECDSA_Data_t ecdsa_data) { return true; }
+uint8_t app_func_ble_curr_state_get(void) { return BLE_STATE_INVALID; }
+void app_func_ble_disconnect(void) { }
+void app_func_ble_enable(bool enable) { }
+void app_func_ble_new_state_get(void) { }
+void app_func_logs_erase(void) { }
+bool app_func_logs_event_search(const char* event_type) { return false; }
+void app_func_logs_event_write(const char* event_type, Log_Event_Write_Callback callback) { }
+void app_func_logs_flush(void) { }
+void app_func_logs_parameter_write(uint8_t* p_id, uint8_t data_format, const uint8_t* p_data, uint16_t data_len) { }
+uint8_t app_func_logs_read(const uint8_t* p_timestamp, uint8_t* p_data) { return 0; }
+void app_func_meas_batt_mon_enable(bool enable) { }
+void app_func_meas_batt_mon_meas(uint16_t* p_vbatA, uint16_t* p_vbatB) { *p_vbatA = 0; *p_vbatB = 0; }
+void app_func_meas_sensor_continue(void) { }
+void app_func_meas_sensor_enable(uint8_t sensorID, bool enable) { }
+void app_func_meas_sensor_sampling(uint8_t sensorID, uint8_t* buff, uint8_t bufferSize, float samplingFrequency_hz) { }
+void app_func_meas_vdda_sup_enable(bool enable) { }
+void app_mode_battery_test_volt_abort(void) { }
+void app_mode_battery_test_volt_get(uint16_t* p_vbatA, uint16_t* p_vbatB) { *p_vbatA = 0; *p_vbatB = 0; }
+bool app_mode_battery_test_volt_step(uint16_t* p_vbatA, uint16_t* p_vbatB, uint8_t* p_progress) { return false; }
+uint8_t app_mode_dvt_acc_data_get(DeviceID_t deviceID, uint8_t* dataBuffer, uint8_t* dataSize) { *dataSize = 0; return STATUS_SUCCESS; }
+uint8_t app_mode_dvt_acc_start(FreqModeDeviceID_t freqModedeviceID, uint8_t* dataBuffer, uint8_t* dataSize) { *dataSize = 0; return STATUS_SUCCESS; }
+uint8_t app_mode_dvt_acc_stop(DeviceID_t deviceID, uint8_t* dataBuffer, uint8_t* dataSize) { *dataSize = 0; return STATUS_SUCCESS; }
+_Float64 app_mode_impedance_test_get(void) { return 0.0; }
+uint8_t app_mode_impedance_test_survey(uint16_t* p_imp_matrix) { return 0; }
+void app_mode_impedance_test_survey_abort(void) { }
+bool app_mode_impedance_test_survey_step(uint16_t* p_imp_matrix, uint8_t* p_pair_num, uint8_t* p_progress) { return false; }
+bool app_mode_therapy_confirm(void) { return true; }
+bool app_mode_therapy_start(void) { return true; }
+void app_mode_therapy_stop(void) { }
+bool bsp_adc_sampling_is_completed(void) { return false; }
+bool bsp_sp_cmd_handler(void) { return true; }
+bool bsp_sp_cmd_is_pending(void) { return false; }
+bool bsp_sp_cmd_is_requested(void) { return false; }
+void bsp_sp_cmd_send(const uint8_t* data, uint8_t data_len) { }
+void bsp_wdg_refresh(void) { }
+
+void bsp_fram_write(uint32_t addr, const uint8_t* p_data, uint16_t data_len, bool waitfor_cplt) {
+	(void)__real_memcpy(&fram[addr], p_data, data_len);
+}
+
+void bsp_fram_read(uint32_t addr, uint8_t* p_data, uint16_t data_len) {
+	(void)__real_memcpy(p_data, &fram[addr], data_len);
+}
+
+/* ---- The commands ---- */
+
+static uint16_t crc_update(uint16_t crc, const uint8_t* p_data, uint32_t length) {
+	for (uint32_t i = 0; i < length; i++) {
+		crc ^= (uint16_t)((uint16_t)p_data[i] << 8);
+		for (uint8_t b = 0; b < 8U; b++) {
+			crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((uint16_t)(crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+/**
+ * @brief The parser of the serial port handler, run on the bench stack
+ *
+ */
+static void bench_parse(void) {
+	tx_len = app_func_command_parser(rx, &rx_head, &rx_len, tx);
+}
+
+/**
+ * @brief Receive a request and parse it on a stack filled with the pattern
+ *
+ * @return uint32_t The depth of the stack used
+ */
+static uint32_t bench_request(const Bench_Cmd_t* p_cmd) {
+	rx[0] = p_cmd->Opcode;
+	rx[1] = p_cmd->PayloadLen;
+	(void)__real_memcpy(&rx[LEN_REQ_HEADER], p_cmd->Payload, p_cmd->PayloadLen);
+	uint16_t crc = crc_update(0xFFFFU, rx, LEN_REQ_HEADER + (uint32_t)p_cmd->PayloadLen);
+	(void)__real_memcpy(&rx[LEN_REQ_HEADER + p_cmd->PayloadLen], &crc, LEN_CRC);
+	rx_head = 0;
+	rx_len = (uint8_t)(LEN_REQ_HEADER + p_cmd->PayloadLen + LEN_CRC);
+
+	(void)memset(bench_stack, BENCH_STACK_FILL, sizeof(bench_stack));
+	(void)getcontext(&ctx_parser);
+	ctx_parser.uc_stack.ss_sp = bench_stack;
+	ctx_parser.uc_stack.ss_size = sizeof(bench_stack);
+	ctx_parser.uc_link = &ctx_main;
+	makecontext(&ctx_parser, &bench_parse, 0);
+	copies_counted = true;
+	(void)swapcontext(&ctx_main, &ctx_parser);
+	copies_counted = false;
+
+	//The stack grows down, the lowest byte overwritten is the high-water mark
+	uint32_t unused = 0;
+	while ((unused < sizeof(bench_stack)) && (bench_stack[unused] == BENCH_STACK_FILL)) {
+		unused++;
+	}
+
+	if ((tx_len < (LEN_RESP_HEADER + LEN_CRC)) || (tx[0] != p_cmd->Opcode) || (tx[2] != STATUS_SUCCESS)) {
+		(void)printf("FAIL %s: response of %u bytes, opcode 0x%02X, status 0x%02X\n", p_cmd->Name, tx_len, tx[0], tx[2]);
+		failures++;
+	}
+	return (uint32_t)sizeof(bench_stack) - unused;
+}
+
+/**
+ * @brief The requests of the BLE connection mode, from the smallest response to the largest
+ *
+ */
+static uint32_t bench_cmds_build(Bench_Cmd_t* p_cmds) {
+	uint32_t num = 0;
+	const uint8_t* p_stim_id = NULL;
+	for (uint16_t i = 0; (i < parameters_list_size) && (p_stim_id == NULL); i++) {
+		if (app_func_para_profile_contains(parameters_list[i].id) && (app_func_para_datatype_get(parameters_list[i].id) == FORMAT_TYPE_VALUE)) {
+			p_stim_id = parameters_list[i].id;
+		}
+	}
+
+	p_cmds[num] = (Bench_Cmd_t){.Name = "SELECT_THERAPY_PROFILE", .Opcode = OP_SELECT_THERAPY_PROFILE, .PayloadLen = 1U};
+	p_cmds[num++].Payload[0] = app_func_para_profile_get();
+
+	p_cmds[num] = (Bench_Cmd_t){.Name = "READ_STIMULATION_PARAMETERS", .Opcode = OP_READ_STIMULATION_PARAMETERS, .PayloadLen = LEN_ID};
+	(void)__real_memcpy(p_cmds[num++].Payload, p_stim_id, LEN_ID);
+
+	//The stimulation parameters up to a full response
+	Bench_Cmd_t* p_cmd = &p_cmds[num++];
+	*p_cmd = (Bench_Cmd_t){.Name = "READ_PARAMETERS_BATCH", .Opcode = OP_READ_PARAMETERS_BATCH};
+	uint16_t len_resp = 0;
+	for (uint16_t i = 0; i < parameters_list_size; i++) {
+		const uint8_t* p_id = parameters_list[i].id;
+		uint16_t len = (uint16_t)LEN_ID + ((app_func_para_datatype_get(p_id) == FORMAT_TYPE_VALUE) ? (uint16_t)LEN_STEP : app_func_para_datalen_get(p_id));
+		if (app_func_para_profile_contains(p_id) && ((len_resp + len) <= LEN_RESP_PAYLOAD_MAX) &&
+				((p_cmd->PayloadLen + LEN_ID) <= LEN_REQ_PAYLOAD_MAX)) {
+			(void)__real_memcpy(&p_cmd->Payload[p_cmd->PayloadLen], p_id, LEN_ID);
+			p_cmd->PayloadLen += LEN_ID;
+			len_resp += len;
+		}
+	}
+
+	//The value parameters of the profile written with their data, up to a full request
+	p_cmd = &p_cmds[num++];
+	*p_cmd = (Bench_Cmd_t){.Name = "WRITE_PARAMETERS_BATCH", .Opcode = OP_WRITE_PARAMETERS_BATCH};
+	for (uint16_t i = 0; i < parameters_list_size; i++) {
+		const uint8_t* p_id = parameters_list[i].id;
+		if (app_func_para_profile_contains(p_id) && (app_func_para_datatype_get(p_id) == FORMAT_TYPE_VALUE) &&
+				((p_cmd->PayloadLen + LEN_ID + LEN_STEP) <= LEN_REQ_PAYLOAD_MAX)) {
+			_Float64 val = 0.0;
+			app_func_para_data_get(p_id, (uint8_t*)&val, (uint8_t)sizeof(val));
+			uint16_t steps = (uint16_t)((val / app_func_para_stepsize_get(p_id)) + 0.5);
+			(void)__real_memcpy(&p_cmd->Payload[p_cmd->PayloadLen], p_id, LEN_ID);
+			(void)__real_memcpy(&p_cmd->Payload[p_cmd->PayloadLen + LEN_ID], &steps, LEN_STEP);
+			p_cmd->PayloadLen += (uint8_t)(LEN_ID + LEN_STEP);
+		}
+	}
+	return num;
+}
+
+int main(void) {
+	Bench_Cmd_t cmds[4];
+	(void)memset(fram, 0xFF, sizeof(fram));
+	app_func_para_init();
+	app_mode_ble_conn_init();
+	app_func_command_req_parser_set(&app_mode_ble_conn_cmd_parser);
+	uint32_t num = bench_cmds_build(cmds);
+
+	(void)printf("bench_cmd_stack: host build, %u-byte frames, copies averaged over %u requests\n", LEN_CMD_MAX, BENCH_ROUNDS);
+	(void)printf("  %-28s %8s %8s %11s %11s\n", "Request", "req B", "resp B", "stack B", "copied B");
+	for (uint32_t c = 0; c < num; c++) {
+		uint32_t stack_max = 0;
+		copy_bytes = 0;
+		copy_calls = 0;
+		for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+			uint32_t stack = bench_request(&cmds[c]);
+			stack_max = (stack > stack_max) ? stack : stack_max;
+		}
+		(void)printf("  %-28s %8u %8u %11lu %11.1f   in %.1f calls\n", cmds[c].Name, cmds[c].PayloadLen, tx[1], (unsigned long)stack_max,
+				(double)copy_bytes / BENCH_ROUNDS, (double)copy_calls / BENCH_ROUNDS);
+	}
+
+	(void)printf("bench_cmd_stack: %lu failures\n", (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
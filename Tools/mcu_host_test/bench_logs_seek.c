@@ -0,0 +1,270 @@
+/**
+ * @file bench_logs_seek.c
+ * @brief Benchmark of the log seek by timestamp, the binary search of the real app_func_logs.c against linear scans
+ *
+ * The log ring is filled with logs a second apart, half full and then wrapped, and each seek asks for the first log after
+ * a random time. Every FRAM read is one SPI transaction: CS, the 4-byte read command and the data at 5 MHz, so the FRAM time
+ * of a seek is given from the transactions and bytes it reads. The linear scans are the firmware before the binary search,
+ * one byte per transaction from the log pointer, and the same scan in 32-byte chunks. All three must find the same log.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <time.h>
+#include "app_config.h"
+
+#define BENCH_SEEKS				500U
+#define BENCH_NS_PER_BYTE		1600.0		/*!< 8 bits at the 5 MHz SPI clock */
+#define BENCH_XFER_US			2.0			/*!< CS and the HAL call of a transaction */
+#define BENCH_LEN_CMD			4U			/*!< The read command and the address */
+#define BENCH_LEN_TIMESTAMP		27U			/*!< "[20YY-MM-DDThh:mm:ssZ(uuu)]" */
+#define BENCH_LEN_CHUNK			32U
+#define BENCH_LEN_STR			40U			/*!< Room for the timestamp string of any byte values */
+
+extern Log_Info_t logInfo;
+
+typedef uint8_t (*Bench_Seek)(const uint8_t* p_timestamp, uint8_t* p_data);
+
+static uint8_t fram[ADDR_LOG_INFO + sizeof(Log_Info_t)];
+static uint32_t rtc_seconds = 0;
+static uint32_t rng_state = 1;
+static uint32_t failures = 0;
+static uint32_t read_xfers = 0;
+static uint64_t read_bytes = 0;
+
+static uint32_t rng_next(uint32_t range) {
+	rng_state = (rng_state * 1103515245UL) + 12345UL;
+	return (rng_state >> 8) % range;
+}
+
+void bsp_wdg_refresh(void) {
+}
+
+HAL_StatusTypeDef HAL_RTC_GetTime(RTC_HandleTypeDef* hrtc_, RTC_TimeTypeDef* p_time, uint32_t format) {
+	UNUSED(hrtc_);
+	UNUSED(format);
+	p_time->Hours = (uint8_t)((rtc_seconds / 3600U) % 24U);
+	p_time->Minutes = (uint8_t)((rtc_seconds / 60U) % 60U);
+	p_time->Seconds = (uint8_t)(rtc_seconds % 60U);
+	p_time->SubSeconds = 255U;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_GetDate(RTC_HandleTypeDef* hrtc_, RTC_DateTypeDef* p_date, uint32_t format) {
+	UNUSED(hrtc_);
+	UNUSED(format);
+	p_date->Year = 26U;
+	p_date->Month = 1U;
+	p_date->Date = (uint8_t)(1U + (rtc_seconds / 86400U));
+	return HAL_OK;
+}
+
+void bsp_fram_write(uint32_t addr, const uint8_t* p_data, uint16_t data_len, bool waitfor_cplt) {
+	UNUSED(waitfor_cplt);
+	(void)memcpy(&fram[addr], p_data, data_len);
+	app_func_logs_write_cplt_cb(addr, data_len);
+}
+
+void bsp_fram_read(uint32_t addr, uint8_t* p_data, uint16_t data_len) {
+	(void)memcpy(p_data, &fram[addr], data_len);
+	read_xfers++;
+	read_bytes += data_len;
+}
+
+bool bsp_fram_is_busy(void) {
+	return false;
+}
+
+void bsp_fram_erase(uint32_t addr, uint32_t erase_size) {
+	(void)memset(&fram[addr], 0, erase_size);
+}
+
+/**
+ * @brief The timestamp of a seek, as the host sends it
+ *
+ */
+static void timestamp_get(uint32_t seconds, uint8_t* p_timestamp) {
+	p_timestamp[0] = 26U;
+	p_timestamp[1] = 1U;
+	p_timestamp[2] = (uint8_t)(1U + (seconds / 86400U));
+	p_timestamp[3] = (uint8_t)((seconds / 3600U) % 24U);
+	p_timestamp[4] = (uint8_t)((seconds / 60U) % 60U);
+	p_timestamp[5] = (uint8_t)(seconds % 60U);
+	p_timestamp[6] = 0U;
+}
+
+/**
+ * @brief The timestamp string of a seek, as app_func_logs_timestamp_gen makes it
+ *
+ */
+static void timestamp_str_get(const uint8_t* p_timestamp, char* p_str) {
+	(void)snprintf(p_str, BENCH_LEN_STR, "[20%02u-%02u-%02uT%02u:%02u:%02uZ(%03u)]", p_timestamp[0], p_timestamp[1],
+			p_timestamp[2], p_timestamp[3], p_timestamp[4], p_timestamp[5], p_timestamp[6]);
+}
+
+/**
+ * @brief The seek of the firmware before the binary search, one byte per transaction from the log pointer
+ *
+ */
+static uint8_t seek_linear_byte(const uint8_t* p_timestamp, uint8_t* p_data) {
+	char str_timestamp[BENCH_LEN_STR];
+	timestamp_str_get(p_timestamp, str_timestamp);
+	for (uint32_t i = 0; i < SIZE_LOG; i++) {
+		uint32_t addr = ADDR_LOG_BASE + (((logInfo.LogPointer - ADDR_LOG_BASE) + i) % SIZE_LOG);
+		bsp_fram_read(addr, p_data, 1U);
+		if (p_data[0] != (uint8_t)'[') {
+			continue;
+		}
+		bsp_fram_read(addr, p_data, BENCH_LEN_TIMESTAMP);
+		if ((p_data[BENCH_LEN_TIMESTAMP - 1U] != (uint8_t)']') || (memcmp(p_data, str_timestamp, BENCH_LEN_TIMESTAMP) <= 0)) {
+			continue;
+		}
+		for (uint8_t len = BENCH_LEN_TIMESTAMP; len < LEN_RESP_PAYLOAD_MAX; len++) {
+			bsp_fram_read(addr + len, &p_data[len], 1U);
+			if ((p_data[len] == (uint8_t)'\n') || (p_data[len] == 0U)) {
+				return (uint8_t)(len + 1U);
+			}
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief The same linear scan, reading 32-byte chunks and the log found in one transaction
+ *
+ */
+static uint8_t seek_linear_chunk(const uint8_t* p_timestamp, uint8_t* p_data) {
+	char str_timestamp[BENCH_LEN_STR];
+	uint8_t chunk[BENCH_LEN_CHUNK];
+	timestamp_str_get(p_timestamp, str_timestamp);
+	for (uint32_t offset = 0; offset < SIZE_LOG; offset += BENCH_LEN_CHUNK) {
+		uint32_t addr = ADDR_LOG_BASE + (((logInfo.LogPointer - ADDR_LOG_BASE) + offset) % SIZE_LOG);
+		uint32_t len_chunk = ((ADDR_LOG_BASE + SIZE_LOG) - addr < BENCH_LEN_CHUNK) ? (ADDR_LOG_BASE + SIZE_LOG) - addr : BENCH_LEN_CHUNK;
+		bsp_fram_read(addr, chunk, (uint16_t)len_chunk);
+		for (uint32_t i = 0; i < len_chunk; i++) {
+			if ((chunk[i] != (uint8_t)'[') || ((addr + i + BENCH_LEN_TIMESTAMP) > (ADDR_LOG_BASE + SIZE_LOG))) {
+				continue;
+			}
+			bsp_fram_read(addr + i, p_data, BENCH_LEN_TIMESTAMP);
+			if ((p_data[BENCH_LEN_TIMESTAMP - 1U] != (uint8_t)']') || (memcmp(p_data, str_timestamp, BENCH_LEN_TIMESTAMP) <= 0)) {
+				continue;
+			}
+			uint16_t len_read = LEN_RESP_PAYLOAD_MAX;
+			if (len_read > ((ADDR_LOG_BASE + SIZE_LOG) - (addr + i))) {
+				len_read = (uint16_t)((ADDR_LOG_BASE + SIZE_LOG) - (addr + i));
+			}
+			bsp_fram_read(addr + i, p_data, len_read);
+			for (uint16_t len = BENCH_LEN_TIMESTAMP; len < len_read; len++) {
+				if ((p_data[len] == (uint8_t)'\n') || (p_data[len] == 0U)) {
+					return (uint8_t)(len + 1U);
+				}
+			}
+		}
+		//The chunks are aligned to the ring from the log pointer, a chunk cut by the end of the ring goes on from the base
+		if (len_chunk < BENCH_LEN_CHUNK) {
+			offset -= BENCH_LEN_CHUNK - len_chunk;
+		}
+	}
+	return 0;
+}
+
+typedef struct {
+	const char*	Name;
+	Bench_Seek	Seek;
+	uint64_t	Xfers;
+	uint64_t	Bytes;
+	double		HostNs;
+} Bench_Method_t;
+
+static Bench_Method_t methods[] = {
+	{"linear, 1 B reads",	&seek_linear_byte,	0, 0, 0.0},
+	{"linear, 32 B chunks",	&seek_linear_chunk,	0, 0, 0.0},
+	{"binary search",		&app_func_logs_read,	0, 0, 0.0},
+};
+
+static void bench_run(const char* p_name, uint32_t seconds_first, uint32_t seconds_last) {
+	uint8_t timestamp[7];
+	uint8_t data[3][LEN_RESP_PAYLOAD_MAX];
+	uint8_t len[3];
+	for (uint32_t m = 0; m < (sizeof(methods) / sizeof(methods[0])); m++) {
+		methods[m].Xfers = 0;
+		methods[m].Bytes = 0;
+		methods[m].HostNs = 0.0;
+	}
+	for (uint32_t s = 0; s < BENCH_SEEKS; s++) {
+		//Also before the oldest log and after the newest one
+		timestamp_get(seconds_first - 10U + rng_next(seconds_last - seconds_first + 20U), timestamp);
+		for (uint32_t m = 0; m < (sizeof(methods) / sizeof(methods[0])); m++) {
+			struct timespec t0;
+			struct timespec t1;
+			read_xfers = 0;
+			read_bytes = 0;
+			(void)clock_gettime(CLOCK_MONOTONIC, &t0);
+			len[m] = methods[m].Seek(timestamp, data[m]);
+			(void)clock_gettime(CLOCK_MONOTONIC, &t1);
+			methods[m].HostNs += ((double)(t1.tv_sec - t0.tv_sec) * 1e9) + (double)(t1.tv_nsec - t0.tv_nsec);
+			methods[m].Xfers += read_xfers;
+			methods[m].Bytes += read_bytes;
+		}
+		for (uint32_t m = 1; m < (sizeof(methods) / sizeof(methods[0])); m++) {
+			if ((len[m] != len[0]) || (memcmp(data[m], data[0], len[0]) != 0)) {
+				(void)printf("FAIL %s: seek %lu, %s found %u bytes, %s %u bytes\n", p_name, (unsigned long)s, methods[m].Name,
+						len[m], methods[0].Name, len[0]);
+				failures++;
+			}
+		}
+	}
+	(void)printf("  %s\n", p_name);
+	for (uint32_t m = 0; m < (sizeof(methods) / sizeof(methods[0])); m++) {
+		double xfers = (double)methods[m].Xfers / BENCH_SEEKS;
+		double bytes = (double)methods[m].Bytes / BENCH_SEEKS;
+		double fram_us = (xfers * (BENCH_XFER_US + (BENCH_LEN_CMD * BENCH_NS_PER_BYTE / 1000.0))) + (bytes * BENCH_NS_PER_BYTE / 1000.0);
+		(void)printf("    %-22s %9.0f reads %9.0f bytes %10.2f ms FRAM %9.1f us host\n", methods[m].Name, xfers, bytes,
+				fram_us / 1000.0, methods[m].HostNs / BENCH_SEEKS / 1000.0);
+	}
+}
+
+/**
+ * @brief Write logs a second apart until the log pointer passes this address, or the ring wraps and passes it again
+ *
+ * @return uint32_t The time of the last log
+ */
+static uint32_t logs_fill(uint32_t addr_end, bool wrap) {
+	bool wrapped = false;
+	uint32_t pointer_prev = logInfo.LogPointer;
+	while ((logInfo.LogPointer < addr_end) || (wrap && !wrapped)) {
+		rtc_seconds++;
+		app_func_logs_event_write(EVENT_STIM_START, NULL);
+		wrapped = wrapped || (logInfo.LogPointer < pointer_prev);
+		pointer_prev = logInfo.LogPointer;
+		if (wrapped && (logInfo.LogPointer >= addr_end)) {
+			break;
+		}
+	}
+	return rtc_seconds;
+}
+
+int main(void) {
+	app_func_logs_init();
+	rtc_seconds = 3600U;
+	(void)printf("bench_logs_seek: first log after a random time, average of %u seeks, FRAM at 5 MHz\n", BENCH_SEEKS);
+
+	uint32_t seconds_last = logs_fill(ADDR_LOG_BASE + (SIZE_LOG / 2U), false);
+	bench_run("ring half full", 3601U, seconds_last);
+
+	seconds_last = logs_fill(ADDR_LOG_BASE + (SIZE_LOG / 3U), true);
+	//The oldest log left is the first one after the log pointer
+	char oldest[BENCH_LEN_TIMESTAMP];
+	uint32_t addr = logInfo.LogPointer + 1U;
+	while ((fram[addr] != (uint8_t)'[') || (fram[addr + BENCH_LEN_TIMESTAMP - 1U] != (uint8_t)']')) {
+		addr++;
+	}
+	(void)memcpy(oldest, &fram[addr], sizeof(oldest));
+	uint32_t seconds_first = (((uint32_t)(oldest[9] - '0') * 10U) + (uint32_t)(oldest[10] - '0') - 1U) * 86400U;
+	seconds_first += (((uint32_t)(oldest[12] - '0') * 10U) + (uint32_t)(oldest[13] - '0')) * 3600U;
+	seconds_first += (((uint32_t)(oldest[15] - '0') * 10U) + (uint32_t)(oldest[16] - '0')) * 60U;
+	seconds_first += ((uint32_t)(oldest[18] - '0') * 10U) + (uint32_t)(oldest[19] - '0');
+	bench_run("ring wrapped", seconds_first, seconds_last);
+
+	(void)printf("bench_logs_seek: %lu failures\n", (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
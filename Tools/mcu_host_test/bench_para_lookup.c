@@ -0,0 +1,203 @@
+/**
+ * @file bench_para_lookup.c
+ * @brief Benchmark of the parameter lookup by ID, the binary search of the real app_func_parameter.c against the linear scan
+ *
+ * app_func_parameter.c is included to reach app_func_para_get and the sorted index behind it. The linear scan is the lookup
+ * of the firmware before the index, one memcmp per entry of parameters_list, and is kept here as it was. Every ID of the
+ * list must give the same entry with both lookups, and no two entries may share an ID. The invalid IDs are the valid ones
+ * with one character moved up or down, IDs of the same families with other numbers and random bytes; both lookups must
+ * reject them. The compares are counted for each lookup, and the host time is given for all IDs looked up in turn.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <time.h>
+#include "app_func_parameter.c"
+
+#define BENCH_ROUNDS			20000U		/*!< Lookups of every ID of the list for the host time */
+#define BENCH_RANDOM_IDS		100000U
+#define BENCH_ID_NUM			(sizeof(parameters_list) / sizeof(Parameter_t))
+
+typedef Parameter_t* (*Bench_Lookup)(const uint8_t* p_id);
+
+static uint32_t rng_state = 1;
+static uint32_t failures = 0;
+static Parameter_t* volatile sink = NULL;
+
+static uint32_t rng_next(uint32_t range) {
+	rng_state = (rng_state * 1103515245UL) + 12345UL;
+	return (rng_state >> 8) % range;
+}
+
+void bsp_fram_write(uint32_t addr, const uint8_t* p_data, uint16_t data_len, bool waitfor_cplt) {
+}
+
+void bsp_fram_read(uint32_t addr, uint8_t* p_data, uint16_t data_len) {
+	(void)memset(p_data, 0, data_len);
+}
+
+/**
+ * @brief The lookup of the firmware before the sorted index
+ *
+ */
+static Parameter_t* para_get_linear(const uint8_t* p_id) {
+	Parameter_t* p_para = NULL;
+
+	if (p_id != NULL) {
+		uint16_t amount = (uint16_t)(sizeof(parameters_list) / sizeof(Parameter_t));
+		for(uint16_t i=0;i<amount;i++) {
+			if (memcmp(parameters_list[i].id, p_id, LEN_ID) == 0) {
+				p_para = &parameters_list[i];
+				break;
+			}
+		}
+	}
+	return p_para;
+}
+
+/**
+ * @brief The compares of the linear scan for this ID
+ *
+ */
+static uint32_t linear_compares(const uint8_t* p_id) {
+	Parameter_t* p_para = para_get_linear(p_id);
+	return (p_para == NULL) ? (uint32_t)BENCH_ID_NUM : (uint32_t)(p_para - parameters_list) + 1U;
+}
+
+/**
+ * @brief The compares of the binary search for this ID, the same steps as app_func_para_get
+ *
+ */
+static uint32_t binary_compares(const uint8_t* p_id) {
+	uint32_t steps = 0;
+	uint32_t key = app_func_para_id_key(p_id);
+	uint16_t low = 0;
+	uint16_t high = parameters_list_size;
+	while (low < high) {
+		uint16_t mid = low + ((high - low) / 2U);
+		uint32_t key_mid = app_func_para_id_key(parameters_list[parameters_index[mid]].id);
+		steps++;
+		if (key_mid == key) {
+			break;
+		}
+		else if (key_mid < key) {
+			low = mid + 1U;
+		}
+		else {
+			high = mid;
+		}
+	}
+	return steps;
+}
+
+/**
+ * @brief Both lookups must give the same entry, or reject the ID
+ *
+ */
+static void lookup_check(const uint8_t* p_id, const Parameter_t* p_expected) {
+	Parameter_t* p_linear = para_get_linear(p_id);
+	Parameter_t* p_binary = app_func_para_get(p_id);
+	if ((p_linear != p_expected) || (p_binary != p_expected)) {
+		(void)printf("FAIL ID %02X %02X %02X %02X: linear %ld, binary %ld, expected %ld\n", p_id[0], p_id[1], p_id[2], p_id[3],
+				(p_linear == NULL) ? -1L : (long)(p_linear - parameters_list), (p_binary == NULL) ? -1L : (long)(p_binary - parameters_list),
+				(p_expected == NULL) ? -1L : (long)(p_expected - parameters_list));
+		failures++;
+	}
+}
+
+/**
+ * @brief The entry of a valid ID, by a scan that does not stop at the first match
+ *
+ */
+static const Parameter_t* id_expected(const uint8_t* p_id) {
+	const Parameter_t* p_para = NULL;
+	for (uint32_t i = 0; i < BENCH_ID_NUM; i++) {
+		if (memcmp(parameters_list[i].id, p_id, LEN_ID) == 0) {
+			if (p_para != NULL) {
+				(void)printf("FAIL entries %ld and %lu share an ID\n", (long)(p_para - parameters_list), (unsigned long)i);
+				failures++;
+			}
+			p_para = &parameters_list[i];
+		}
+	}
+	return p_para;
+}
+
+static double lookup_time_ns(Bench_Lookup lookup) {
+	struct timespec t0;
+	struct timespec t1;
+	(void)clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+		for (uint32_t i = 0; i < BENCH_ID_NUM; i++) {
+			sink = lookup(parameters_list[i].id);
+		}
+	}
+	(void)clock_gettime(CLOCK_MONOTONIC, &t1);
+	double ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9) + (double)(t1.tv_nsec - t0.tv_nsec);
+	return ns / ((double)BENCH_ROUNDS * (double)BENCH_ID_NUM);
+}
+
+int main(void) {
+	uint32_t invalid_ids = 0;
+	uint64_t compares_linear = 0;
+	uint64_t compares_binary = 0;
+	uint32_t compares_binary_max = 0;
+
+	//The index is built as app_func_para_init builds it, the rest of the init is not needed
+	app_func_para_index_build();
+
+	(void)printf("bench_para_lookup: %lu parameter IDs\n", (unsigned long)BENCH_ID_NUM);
+	for (uint32_t i = 0; i < BENCH_ID_NUM; i++) {
+		const uint8_t* p_id = parameters_list[i].id;
+		lookup_check(p_id, id_expected(p_id));
+		compares_linear += linear_compares(p_id);
+		uint32_t steps = binary_compares(p_id);
+		compares_binary += steps;
+		compares_binary_max = (steps > compares_binary_max) ? steps : compares_binary_max;
+
+		//One character moved up or down, which may be another valid ID
+		for (uint32_t c = 0; c < LEN_ID; c++) {
+			for (int32_t d = -1; d <= 1; d += 2) {
+				uint8_t id[LEN_ID];
+				(void)memcpy(id, p_id, LEN_ID);
+				id[c] = (uint8_t)((int32_t)id[c] + d);
+				const Parameter_t* p_expected = id_expected(id);
+				invalid_ids += (p_expected == NULL) ? 1U : 0U;
+				lookup_check(id, p_expected);
+			}
+		}
+	}
+
+	//IDs of the same families with other numbers, and random bytes
+	for (uint32_t i = 0; i < BENCH_RANDOM_IDS; i++) {
+		uint8_t id[LEN_ID];
+		if ((i % 2U) == 0U) {
+			(void)memcpy(id, parameters_list[rng_next(BENCH_ID_NUM)].id, 2U);
+			id[2] = (uint8_t)('0' + rng_next(10U));
+			id[3] = (uint8_t)('0' + rng_next(10U));
+		}
+		else {
+			for (uint32_t c = 0; c < LEN_ID; c++) {
+				id[c] = (uint8_t)rng_next(256U);
+			}
+		}
+		const Parameter_t* p_expected = id_expected(id);
+		invalid_ids += (p_expected == NULL) ? 1U : 0U;
+		lookup_check(id, p_expected);
+	}
+	if (app_func_para_get(NULL) != NULL) {
+		(void)printf("FAIL the NULL ID is not rejected\n");
+		failures++;
+	}
+
+	double ns_linear = lookup_time_ns(&para_get_linear);
+	double ns_binary = lookup_time_ns(&app_func_para_get);
+	(void)printf("  %lu invalid IDs rejected by both lookups\n", (unsigned long)invalid_ids);
+	(void)printf("  %-16s %16s %14s\n", "Lookup", "compares, mean", "host time");
+	(void)printf("  %-16s %16.1f %11.1f ns\n", "linear scan", (double)compares_linear / (double)BENCH_ID_NUM, ns_linear);
+	(void)printf("  %-16s %16.1f %11.1f ns   %lu compares at most\n", "binary search", (double)compares_binary / (double)BENCH_ID_NUM,
+			ns_binary, (unsigned long)compares_binary_max);
+	(void)printf("  speedup %.2fx\n", ns_linear / ns_binary);
+
+	(void)printf("bench_para_lookup: %lu failures\n", (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
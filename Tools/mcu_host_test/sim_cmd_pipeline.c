@@ -0,0 +1,486 @@
+/**
+ * @file sim_cmd_pipeline.c
+ * @brief Simulation of lockstep and pipelined commands over the BLE link, against the real
+ * app_func_command.c and bsp_serialport.c
+ *
+ * The nRF52810 is modelled by its SPIS TX ring towards the MCU, read at most 255 bytes at a time and
+ * split where the ring wraps, and by the notifications it sends to the host. The BLE link delivers
+ * up to a number of packets each way per connection event, and the host BLE stack adds a latency each way.
+ * The host keeps a window of READ_TIME_AND_DATE commands outstanding, plain or in SEQ frames,
+ * and checks every response. A command replied busy is sent again, and the host keeps one command fewer outstanding.
+ *
+ * Without arguments, the table of commands per second is printed for lockstep and SEQ windows, and the
+ * simulation fails if any response is wrong or the link stalls. A single case is run with key=value arguments:
+ *   ci=<ms> lat=<ms> svc=<us> pkt=<n> win=<n> seq=<0|1> req=<bytes> resp=<bytes> pack=<0|1>
+ *
+ * Firmware without bsp_sp_cmd_is_requested is simulated with -DSIM_POLL_ONLY, commands are then only
+ * served by the 1 s BLE access of the connection mode.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "app_config.h"
+
+//Firmware without the command SEQ is only simulated in lockstep
+#ifndef OP_SEQ
+#define OP_SEQ					0xBCU
+#define LEN_SEQ_HEADER			2U
+#endif
+
+#define NRF_RING_SIZE			510U		/*!< The size of the nRF52810 SPIS TX ring towards the MCU */
+#define NRF_XFER_MAX			255U		/*!< The maximum data length of a SPIS transfer */
+#define NRF_NOTIFY_MAX			244U		/*!< The maximum length of a notification */
+#define FRAME_QUEUE_SIZE		4096U
+#define BLE_ACCESS_TIME_US		1000000.0	/*!< The BLE access time of the connection mode */
+#define MAIN_LOOP_US			20.0		/*!< The time of one pass of the main loop without a command */
+#define SIM_DURATION_US			20000000.0
+#define SIM_STALL_US			5000000.0	/*!< No response for this long is a stalled link */
+
+typedef struct {
+	double		ci_us;			/*!< The connection interval */
+	double		latency_us;		/*!< The latency of the host BLE stack, each way */
+	double		service_us;		/*!< The service time of a command on the MCU */
+	uint32_t	packets;		/*!< The packets each way per connection event */
+	uint32_t	window;			/*!< The commands the host keeps outstanding */
+	bool		seq;			/*!< The commands are sent in SEQ frames */
+	uint8_t		req_len;		/*!< The payload length of the requests */
+	uint8_t		resp_len;		/*!< The payload length of the responses */
+	bool		pack;			/*!< The nRF52810 packs whole responses into one notification */
+} Sim_Config_t;
+
+typedef struct {
+	uint8_t		data[LEN_CMD_MAX + NRF_NOTIFY_MAX];
+	uint16_t	len;
+	double		time_us;		/*!< The time the frame arrives */
+} Frame_t;
+
+typedef struct {
+	Frame_t		frames[FRAME_QUEUE_SIZE];
+	uint32_t	head;
+	uint32_t	tail;
+} Frame_Queue_t;
+
+typedef struct {
+	double		cmd_per_s;
+	uint32_t	errors;
+	uint32_t	busy;
+	bool		stalled;
+} Sim_Result_t;
+
+static Sim_Config_t cfg;
+static double now_us = 0;
+static double next_event_us = 0;
+
+static uint8_t nrf_ring[NRF_RING_SIZE];
+static uint32_t nrf_ring_tail = 0;
+static uint32_t nrf_ring_count = 0;
+static bool nrf_selected = false;		/*!< The chip select of the nRF52810 is low */
+static bool nrf_xfer_read = false;		/*!< The SPIS transfer in progress is a read by the MCU */
+static uint32_t nrf_xfer_len = 0;		/*!< The data length of the read in progress */
+static uint8_t nrf_xfer_write[LEN_CMD_MAX];
+static uint16_t nrf_xfer_write_len = 0;
+
+static Frame_Queue_t nrf_notify;		/*!< The responses waiting for a notification */
+static Frame_Queue_t host_rx;			/*!< The notifications on their way to the host */
+static Frame_Queue_t host_tx;			/*!< The requests on their way to the nRF52810 */
+
+static uint32_t host_done = 0;
+static uint32_t host_errors = 0;
+static uint32_t host_busy = 0;			/*!< The responses busy, the commands are sent again */
+static uint32_t host_outstanding = 0;
+static uint8_t host_seq = 0;
+static bool host_inflight[256];
+static double host_progress_us = 0;
+
+static uint16_t crc16(const uint8_t* p_data, uint32_t len) {
+	return (uint16_t)HAL_CRC_Calculate(&hcrc, (uint32_t*)p_data, len);
+}
+
+static Frame_t* queue_push(Frame_Queue_t* p_queue) {
+	return &p_queue->frames[(p_queue->tail++) % FRAME_QUEUE_SIZE];
+}
+
+static Frame_t* queue_front(Frame_Queue_t* p_queue) {
+	return (p_queue->head == p_queue->tail) ? NULL : &p_queue->frames[p_queue->head % FRAME_QUEUE_SIZE];
+}
+
+/**
+ * @brief Put the data the host wrote into the SPIS TX ring of the nRF52810
+ *
+ */
+static void nrf_ring_put(const uint8_t* p_data, uint16_t len) {
+	for(uint16_t i=0;i<len;i++) {
+		nrf_ring[(nrf_ring_tail + nrf_ring_count + i) % NRF_RING_SIZE] = p_data[i];
+	}
+	nrf_ring_count += len;
+}
+
+/**
+ * @brief Send a request from the host, the frames wait for the host BLE stack and the next connection event
+ *
+ */
+static void host_send(void) {
+	while(host_outstanding < cfg.window) {
+		Frame_t* p_frame = queue_push(&host_tx);
+		uint16_t len = 0;
+		if (cfg.seq) {
+			p_frame->data[len++] = OP_SEQ;
+			p_frame->data[len++] = (uint8_t)(cfg.req_len + LEN_SEQ_HEADER);
+			p_frame->data[len++] = host_seq;
+			host_inflight[host_seq++] = true;
+		}
+		else {
+			p_frame->data[len++] = OP_READ_TIME_AND_DATE;
+			p_frame->data[len++] = cfg.req_len;
+		}
+		if (cfg.seq) {
+			p_frame->data[len++] = OP_READ_TIME_AND_DATE;
+		}
+		for(uint8_t i=0;i<cfg.req_len;i++) {
+			p_frame->data[len++] = i;
+		}
+		uint16_t crc = crc16(p_frame->data, len);
+		(void)memcpy(&p_frame->data[len], &crc, LEN_CRC);
+		p_frame->len = len + LEN_CRC;
+		p_frame->time_us = now_us + cfg.latency_us;
+		host_outstanding++;
+	}
+}
+
+/**
+ * @brief Check a response received by the host, and send the next request
+ *
+ */
+static void host_receive(const uint8_t* p_frame, uint16_t len) {
+	uint16_t crc = 0;
+	(void)memcpy(&crc, &p_frame[len - LEN_CRC], LEN_CRC);
+	if ((crc16(p_frame, len - LEN_CRC) == crc) && cfg.seq && (p_frame[2] == STATUS_BUSY) && host_inflight[p_frame[3]]) {
+		//The command was not run, it is sent again and the host keeps one command fewer outstanding
+		host_inflight[p_frame[3]] = false;
+		host_busy++;
+		cfg.window = (cfg.window > 1U) ? (cfg.window - 1U) : 1U;
+		host_outstanding--;
+		host_progress_us = now_us;
+		host_send();
+		return;
+	}
+	if ((crc16(p_frame, len - LEN_CRC) != crc) || (p_frame[2] != STATUS_SUCCESS)) {
+		host_errors++;
+	}
+	else if (cfg.seq) {
+		if ((p_frame[0] != OP_SEQ) || (p_frame[1] != (cfg.resp_len + LEN_SEQ_HEADER)) ||
+				(host_inflight[p_frame[3]] == false) || (p_frame[4] != OP_READ_TIME_AND_DATE)) {
+			host_errors++;
+		}
+		host_inflight[p_frame[3]] = false;
+	}
+	else if ((p_frame[0] != OP_READ_TIME_AND_DATE) || (p_frame[1] != cfg.resp_len)) {
+		host_errors++;
+	}
+	else {
+		__NOP();
+	}
+	host_done++;
+	host_outstanding--;
+	host_progress_us = now_us;
+	host_send();
+}
+
+/**
+ * @brief Run the connection events up to now, and deliver the notifications that reached the host
+ *
+ */
+static void link_run(void) {
+	while(next_event_us <= now_us) {
+		Frame_t* p_frame = queue_front(&host_tx);
+		for(uint32_t k=0;(k < cfg.packets) && (p_frame != NULL);k++) {
+			if ((p_frame->time_us > next_event_us) || ((NRF_RING_SIZE - nrf_ring_count) < p_frame->len)) {
+				break;
+			}
+			nrf_ring_put(p_frame->data, p_frame->len);
+			host_tx.head++;
+			p_frame = queue_front(&host_tx);
+		}
+
+		p_frame = queue_front(&nrf_notify);
+		for(uint32_t k=0;(k < cfg.packets) && (p_frame != NULL);k++) {
+			Frame_t* p_notify = queue_push(&host_rx);
+			p_notify->len = 0;
+			p_notify->time_us = next_event_us + cfg.latency_us;
+			do {
+				(void)memcpy(&p_notify->data[p_notify->len], p_frame->data, p_frame->len);
+				p_notify->len += p_frame->len;
+				nrf_notify.head++;
+				p_frame = queue_front(&nrf_notify);
+			} while(cfg.pack && (p_frame != NULL) && ((p_notify->len + p_frame->len) <= NRF_NOTIFY_MAX));
+		}
+		next_event_us += cfg.ci_us;
+	}
+
+	Frame_t* p_notify = queue_front(&host_rx);
+	while((p_notify != NULL) && (p_notify->time_us <= now_us)) {
+		host_rx.head++;
+		uint16_t offset = 0;
+		while(offset < p_notify->len) {
+			uint16_t len = (uint16_t)LEN_RESP_HEADER + p_notify->data[offset + 1U] + (uint16_t)LEN_CRC;
+			host_receive(&p_notify->data[offset], len);
+			offset += len;
+		}
+		p_notify = queue_front(&host_rx);
+	}
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(uint32_t port, uint16_t pin) {
+	UNUSED(port);
+	if (pin == BLE_REQ_Pin) {
+		return (nrf_ring_count > 0U) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+	}
+	return (pin == BLE_RDY_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+/**
+ * @brief The chip select of the nRF52810 starts and ends a SPIS transfer
+ *
+ */
+void HAL_GPIO_WritePin(uint32_t port, uint16_t pin, GPIO_PinState state) {
+	UNUSED(port);
+	if (pin != SPI1_BLE_CSn_Pin) {
+		return;
+	}
+	if (state == GPIO_PIN_RESET) {
+		nrf_selected = true;
+		nrf_xfer_read = false;
+		nrf_xfer_len = 0;
+		nrf_xfer_write_len = 0;
+		return;
+	}
+	if (nrf_selected == false) {
+		return;
+	}
+	nrf_selected = false;
+
+	if (nrf_xfer_read) {
+		//Only the data clocked out is dropped from the ring
+		nrf_ring_tail = (nrf_ring_tail + nrf_xfer_len) % NRF_RING_SIZE;
+		nrf_ring_count -= nrf_xfer_len;
+	}
+	else if ((nrf_xfer_write_len == (LEN_REQ_HEADER + LEN_CRC)) && (nrf_xfer_write[0] == OP_BLE_STAT_GET)) {
+		//The nRF52810 answers the BLE state itself: connected
+		uint8_t resp[LEN_RESP_HEADER + 1U + LEN_CRC] = {OP_BLE_STAT_GET, 1, STATUS_SUCCESS, 3};
+		uint16_t crc = crc16(resp, LEN_RESP_HEADER + 1U);
+		(void)memcpy(&resp[LEN_RESP_HEADER + 1U], &crc, LEN_CRC);
+		nrf_ring_put(resp, (uint16_t)sizeof(resp));
+	}
+	else if (nrf_xfer_write_len > 0U) {
+		Frame_t* p_frame = queue_push(&nrf_notify);
+		(void)memcpy(p_frame->data, nrf_xfer_write, nrf_xfer_write_len);
+		p_frame->len = nrf_xfer_write_len;
+	}
+	else {
+		__NOP();
+	}
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, const uint8_t* p_data, uint16_t size, uint32_t timeout) {
+	UNUSED(hspi);
+	UNUSED(timeout);
+	(void)memcpy(&nrf_xfer_write[nrf_xfer_write_len], p_data, size);
+	nrf_xfer_write_len += size;
+	now_us += 20.0 + size;
+	return HAL_OK;
+}
+
+/**
+ * @brief The first byte of a read is the data length, up to the transfer limit and the end of the ring
+ *
+ */
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef* hspi, uint8_t* p_data, uint16_t size, uint32_t timeout) {
+	UNUSED(hspi);
+	UNUSED(timeout);
+	if (nrf_xfer_read == false) {
+		uint32_t span = NRF_RING_SIZE - nrf_ring_tail;
+		span = (span > NRF_XFER_MAX) ? NRF_XFER_MAX : span;
+		p_data[0] = (uint8_t)((nrf_ring_count < span) ? nrf_ring_count : span);
+		nrf_xfer_read = true;
+		now_us += 20.0;
+	}
+	else {
+		for(uint16_t i=0;i<size;i++) {
+			p_data[i] = nrf_ring[(nrf_ring_tail + i) % NRF_RING_SIZE];
+		}
+		nrf_xfer_len = size;
+		now_us += size;
+	}
+	return HAL_OK;
+}
+
+void HAL_Delay(uint32_t delay) {
+	now_us += delay * 1000.0;
+	link_run();
+}
+
+uint32_t HAL_GetTick(void) {
+	return (uint32_t)(now_us / 1000.0);
+}
+
+static void sim_req_parser(const Cmd_Req_t* p_cmd_req, Cmd_Resp_t* p_cmd_resp) {
+	now_us += cfg.service_us;
+	if ((p_cmd_req->Opcode != OP_READ_TIME_AND_DATE) || (p_cmd_req->PayloadLen != cfg.req_len)) {
+		p_cmd_resp->Status = STATUS_INVALID;
+		return;
+	}
+	for(uint8_t i=0;i<cfg.resp_len;i++) {
+		p_cmd_resp->Payload[i] = i;
+	}
+	p_cmd_resp->PayloadLen = cfg.resp_len;
+}
+
+static void sim_resp_parser(const Cmd_Resp_t* p_cmd_resp) {
+	UNUSED(p_cmd_resp);
+}
+
+/**
+ * @brief Run the connection mode loop with the host for the simulation time
+ *
+ */
+static Sim_Result_t sim_run(const Sim_Config_t* p_cfg) {
+	Sim_Result_t result = {0};
+	cfg = *p_cfg;
+	//The time goes on from the last run, as HAL_GetTick never goes back on the MCU
+	double start_us = now_us;
+	next_event_us = now_us;
+	nrf_ring_tail = 0;
+	nrf_ring_count = 0;
+	(void)memset(&nrf_notify, 0, sizeof(nrf_notify));
+	(void)memset(&host_rx, 0, sizeof(host_rx));
+	(void)memset(&host_tx, 0, sizeof(host_tx));
+	(void)memset(host_inflight, 0, sizeof(host_inflight));
+	host_done = 0;
+	host_errors = 0;
+	host_busy = 0;
+	host_outstanding = 0;
+	host_progress_us = now_us;
+
+	bsp_sp_init(&app_func_command_parser, NULL);
+	app_func_command_req_parser_set(&sim_req_parser);
+	app_func_command_resp_parser_set(&sim_resp_parser);
+	host_send();
+
+	double access_us = now_us + BLE_ACCESS_TIME_US;
+	while((now_us - start_us) < SIM_DURATION_US) {
+		if (now_us >= access_us) {
+			//The BLE access polls the BLE state, the handler runs until a command is parsed
+			uint8_t req[LEN_REQ_HEADER + LEN_CRC] = {OP_BLE_STAT_GET, 0};
+			uint16_t crc = crc16(req, LEN_REQ_HEADER);
+			(void)memcpy(&req[LEN_REQ_HEADER], &crc, LEN_CRC);
+			bsp_sp_cmd_send(req, (uint8_t)sizeof(req));
+			while((bsp_sp_cmd_handler() == false) && ((now_us - host_progress_us) < SIM_STALL_US)) {
+				HAL_Delay(1);
+			}
+			access_us = now_us + BLE_ACCESS_TIME_US;
+		}
+#ifndef SIM_POLL_ONLY
+		else if (bsp_sp_cmd_is_requested()) {
+			(void)bsp_sp_cmd_handler();
+		}
+#endif
+		else {
+			__NOP();
+		}
+		now_us += MAIN_LOOP_US;
+		link_run();
+		if ((now_us - host_progress_us) > SIM_STALL_US) {
+			result.stalled = true;
+			break;
+		}
+	}
+	result.cmd_per_s = host_done / ((now_us - start_us) / 1000000.0);
+	result.errors = host_errors;
+	result.busy = host_busy;
+	return result;
+}
+
+static bool sim_report(const char* p_name, const Sim_Result_t* p_result) {
+	(void)printf("  %-26s %9.1f /s  %lu errors%s", p_name, p_result->cmd_per_s, (unsigned long)p_result->errors,
+			p_result->stalled ? ", STALLED" : "");
+	if (p_result->busy > 0U) {
+		(void)printf(", %lu busy", (unsigned long)p_result->busy);
+	}
+	(void)printf("\n");
+	return ((p_result->errors == 0U) && (p_result->stalled == false));
+}
+
+int main(int argc, char** argv) {
+	Sim_Config_t config = {
+			.ci_us = 15000.0,
+			.latency_us = 3000.0,
+			.service_us = 300.0,
+			.packets = 4,
+			.window = 1,
+			.seq = false,
+			.req_len = 0,
+			.resp_len = 7,
+			.pack = false,
+	};
+	bool pass = true;
+
+	if (argc > 1) {
+		for(int i=1;i<argc;i++) {
+			char key[16];
+			double value = 0;
+			if (sscanf(argv[i], "%15[^=]=%lf", key, &value) != 2) {
+				(void)fprintf(stderr, "Unknown argument %s\n", argv[i]);
+				return 2;
+			}
+			if (strcmp(key, "ci") == 0) { config.ci_us = value * 1000.0; }
+			else if (strcmp(key, "lat") == 0) { config.latency_us = value * 1000.0; }
+			else if (strcmp(key, "svc") == 0) { config.service_us = value; }
+			else if (strcmp(key, "pkt") == 0) { config.packets = (uint32_t)value; }
+			else if (strcmp(key, "win") == 0) { config.window = (uint32_t)value; }
+			else if (strcmp(key, "seq") == 0) { config.seq = (value != 0.0); }
+			else if (strcmp(key, "req") == 0) { config.req_len = (uint8_t)value; }
+			else if (strcmp(key, "resp") == 0) { config.resp_len = (uint8_t)value; }
+			else if (strcmp(key, "pack") == 0) { config.pack = (value != 0.0); }
+			else {
+				(void)fprintf(stderr, "Unknown argument %s\n", argv[i]);
+				return 2;
+			}
+		}
+		Sim_Result_t result = sim_run(&config);
+		pass = sim_report("case", &result);
+		return pass ? 0 : 1;
+	}
+
+	static const double intervals_ms[] = {7.5, 15.0, 30.0};
+	static const uint32_t windows[] = {1, 2, 4};
+	(void)printf("sim_cmd_pipeline: %.0f ms host latency, %lu packets per event, %.0f us service time\n",
+			config.latency_us / 1000.0, (unsigned long)config.packets, config.service_us);
+	for(uint32_t i=0;i<(sizeof(intervals_ms) / sizeof(intervals_ms[0]));i++) {
+		for(uint32_t j=0;j<(sizeof(windows) / sizeof(windows[0]));j++) {
+			char name[64];
+			config.ci_us = intervals_ms[i] * 1000.0;
+			config.window = windows[j];
+			config.seq = (windows[j] > 1U);
+			(void)snprintf(name, sizeof(name), "CI %4.1f ms, %s %lu", intervals_ms[i], config.seq ? "SEQ window" : "lockstep", (unsigned long)windows[j]);
+			Sim_Result_t result = sim_run(&config);
+			pass = sim_report(name, &result) && pass;
+		}
+	}
+
+	//Requests of 200 bytes are split where the SPIS ring wraps
+	config.ci_us = 7500.0;
+	config.window = 4;
+	config.seq = true;
+	config.req_len = 200;
+	Sim_Result_t result = sim_run(&config);
+	pass = sim_report("CI  7.5 ms, SEQ 4, 200 B", &result) && pass;
+
+	//More commands outstanding than the response queue holds, the ones not run are replied busy and sent again.
+	//The firmware before the busy status dropped the oldest response silently, and the host waited for it.
+	config.window = 16;
+	config.req_len = 100;
+	result = sim_run(&config);
+	pass = sim_report("CI  7.5 ms, SEQ 16, 100 B", &result) && pass;
+
+	return pass ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file sim_fram_erase.c
+ * @brief Simulation of the erase time of the log region in FRAM, against the real bsp_serialport.c
+ *
+ * The polled SPI transfers take the time of their bytes at the 5 MHz SPI clock plus the time the HAL takes to set up
+ * and end each call, which is an assumption to be replaced by the one measured on the board. The erase of bsp_serialport.c,
+ * which streams blocks of a constant pattern, is run against the erase of earlier firmware, one HAL call per byte, which
+ * is kept here as it was. The CY15B108QN is modelled from the bytes clocked out while its CS is low: a write is only
+ * taken after WREN. Both erases must clear exactly the range asked, for the log region and for ranges of random sizes
+ * around the block size, and no HAL call may take longer than its 5 ms timeout.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include "app_config.h"
+
+#define SIM_NS_PER_BYTE			1600.0		/*!< 8 bits at the 5 MHz SPI clock */
+#define SIM_HAL_CALL_US			3.0			/*!< Setting up and ending one polled HAL_SPI_Transmit at 160 MHz, assumed */
+#define SIM_HAL_TIMEOUT_US		5000.0		/*!< The timeout given to HAL_SPI_Transmit by the erase */
+#define SIM_IWDG_US				4000000.0	/*!< The IWDG window, the erase does not refresh it */
+#define SIM_FRAM_SIZE			(CY15B108QN_MAX_ADDR + 1UL)
+#define SIM_RANGES				200U		/*!< Erases of random ranges, checked byte by byte */
+#define SIM_RANGE_MAX			1100U
+#define SIM_FILL				0xA5U
+
+typedef struct {
+	const char*	Name;
+	void		(*Erase)(uint32_t addr, uint32_t erase_size);
+} Erase_Case_t;
+
+static uint8_t fram[SIM_FRAM_SIZE];
+static double now_us = 0.0;
+static uint32_t hal_calls = 0;
+static double hal_call_max_us = 0.0;
+static uint32_t rng_state = 1;
+static uint32_t failures = 0;
+
+static GPIO_PinState fram_cs = GPIO_PIN_SET;
+static bool fram_wel = false;				/*!< The write enable latch */
+static uint8_t fram_cmd[4];
+static uint32_t fram_cmd_len = 0;
+static uint32_t fram_addr = 0;
+
+static uint32_t rng_next(uint32_t range) {
+	rng_state = (rng_state * 1103515245UL) + 12345UL;
+	return (rng_state >> 8) % range;
+}
+
+/**
+ * @brief The bytes clocked out to the CY15B108QN while its CS is low
+ *
+ */
+static void fram_bytes(const uint8_t* p_data, uint16_t size) {
+	for (uint16_t i = 0; i < size; i++) {
+		if (fram_cmd_len < sizeof(fram_cmd)) {
+			fram_cmd[fram_cmd_len++] = p_data[i];
+			if ((fram_cmd_len == 1U) && (fram_cmd[0] == CY15B108QN_CMD_WREN)) {
+				fram_wel = true;
+			}
+			if (fram_cmd_len == sizeof(fram_cmd)) {
+				fram_addr = ((uint32_t)fram_cmd[1] << 16) | ((uint32_t)fram_cmd[2] << 8) | fram_cmd[3];
+			}
+			continue;
+		}
+		if (fram_cmd[0] == CY15B108QN_CMD_WRITE) {
+			if (!fram_wel) {
+				(void)printf("FAIL FRAM write at 0x%05lX without WREN\n", (unsigned long)fram_addr);
+				failures++;
+			}
+			fram[fram_addr % SIM_FRAM_SIZE] = p_data[i];
+			fram_addr++;
+		}
+	}
+}
+
+void HAL_GPIO_WritePin(uint32_t port, uint16_t pin, GPIO_PinState state) {
+	UNUSED(port);
+	if ((pin == SPI1_FRAM_CSn_Pin) && (state != fram_cs)) {
+		if ((state == GPIO_PIN_SET) && (fram_cmd_len == sizeof(fram_cmd)) && (fram_cmd[0] == CY15B108QN_CMD_WRITE)) {
+			fram_wel = false;
+		}
+		fram_cmd_len = 0;
+		fram_cs = state;
+	}
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, const uint8_t* p_data, uint16_t size, uint32_t timeout) {
+	UNUSED(hspi);
+	double call_us = SIM_HAL_CALL_US + ((double)size * SIM_NS_PER_BYTE / 1000.0);
+	if (call_us > ((double)timeout * 1000.0)) {
+		(void)printf("FAIL HAL_SPI_Transmit of %u bytes takes %.1f us, the timeout is %lu ms\n", size, call_us,
+				(unsigned long)timeout);
+		failures++;
+	}
+	hal_call_max_us = (call_us > hal_call_max_us) ? call_us : hal_call_max_us;
+	now_us += call_us;
+	hal_calls++;
+	if (fram_cs == GPIO_PIN_RESET) {
+		fram_bytes(p_data, size);
+	}
+	return HAL_OK;
+}
+
+/**
+ * @brief The erase of earlier firmware, one HAL call for each byte after the first one
+ *
+ */
+static void sim_erase_per_byte(uint32_t addr, uint32_t erase_size) {
+	uint8_t CY15B108QN_mem_erase_buffer[5] = {0,0,0,0,0};
+	uint8_t CY15B108QN_mem_erase_data = 0x00;
+	(void)CY15B108QN_write_spi_frame_get(CY15B108QN_mem_erase_buffer, addr, &CY15B108QN_mem_erase_data, 1);
+
+	uint8_t wren = CY15B108QN_CMD_WREN;
+	HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_RESET);
+	HAL_ERROR_CHECK(HAL_SPI_Transmit(&HANDLE_NRF52810_CY15B108QN_SPI, &wren, 1, 5));
+	HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_SET);
+
+	HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_RESET);
+	HAL_ERROR_CHECK(HAL_SPI_Transmit(&HANDLE_NRF52810_CY15B108QN_SPI, CY15B108QN_mem_erase_buffer, 5, 5));
+	for(uint32_t i = (addr + 1U);i<(addr+erase_size);i++) {
+		HAL_ERROR_CHECK(HAL_SPI_Transmit(&HANDLE_NRF52810_CY15B108QN_SPI, &CY15B108QN_mem_erase_data, 1, 5));
+	}
+	HAL_GPIO_WritePin(SPI1_FRAM_CSn_GPIO_Port, SPI1_FRAM_CSn_Pin, GPIO_PIN_SET);
+}
+
+/**
+ * @brief Erase a range of the FRAM filled with a pattern, only the range must be cleared
+ *
+ */
+static void sim_erase_check(const Erase_Case_t* p_case, uint32_t addr, uint32_t erase_size) {
+	uint32_t start = (addr > 16U) ? (addr - 16U) : 0U;
+	uint32_t end = addr + erase_size + 16U;
+	(void)memset(&fram[start], SIM_FILL, end - start);
+	p_case->Erase(addr, erase_size);
+	for (uint32_t a = start; a < end; a++) {
+		uint8_t expected = ((a >= addr) && (a < (addr + erase_size))) ? 0x00U : SIM_FILL;
+		if (fram[a] != expected) {
+			(void)printf("FAIL %s: erase of 0x%05lX + %lu left 0x%02X at 0x%05lX\n", p_case->Name, (unsigned long)addr,
+					(unsigned long)erase_size, fram[a], (unsigned long)a);
+			failures++;
+			break;
+		}
+	}
+}
+
+int main(void) {
+	const Erase_Case_t erase_cases[] = {
+		{"one call per byte", &sim_erase_per_byte},
+		{"blocks", &bsp_sp_CY15B108QN_erase},
+	};
+	double erase_us[2] = {0.0, 0.0};
+
+	(void)printf("sim_fram_erase: log region of %lu bytes at 5 MHz SPI, %.1f us per HAL call\n", (unsigned long)SIZE_LOG,
+			SIM_HAL_CALL_US);
+	(void)printf("  %-20s %11s %10s %14s %13s\n", "Erase", "time", "HAL calls", "longest call", "IWDG margin");
+	for (uint32_t c = 0; c < (sizeof(erase_cases) / sizeof(erase_cases[0])); c++) {
+		now_us = 0.0;
+		hal_calls = 0;
+		hal_call_max_us = 0.0;
+		sim_erase_check(&erase_cases[c], ADDR_LOG_BASE, SIZE_LOG);
+		erase_us[c] = now_us;
+		(void)printf("  %-20s %8.1f ms %10lu %11.1f us %10.1f ms\n", erase_cases[c].Name, now_us / 1000.0,
+				(unsigned long)hal_calls, hal_call_max_us, (SIM_IWDG_US - now_us) / 1000.0);
+		if (now_us >= SIM_IWDG_US) {
+			(void)printf("FAIL %s: the erase takes longer than the IWDG window\n", erase_cases[c].Name);
+			failures++;
+		}
+
+		//Ranges around the block size, the last block is shorter
+		rng_state = 1;
+		for (uint32_t r = 0; r < SIM_RANGES; r++) {
+			uint32_t addr = ADDR_LOG_BASE + 16U + rng_next(SIZE_LOG - SIM_RANGE_MAX - 32U);
+			sim_erase_check(&erase_cases[c], addr, 1U + rng_next(SIM_RANGE_MAX));
+		}
+	}
+	double bus_us = (4.0 + (double)SIZE_LOG) * SIM_NS_PER_BYTE / 1000.0;
+	(void)printf("  %-20s %8.1f ms\n", "bytes on the bus", bus_us / 1000.0);
+	(void)printf("  speedup %.2fx, blocks at %.1f%% of the bus time\n", erase_us[0] / erase_us[1], (bus_us * 100.0) / erase_us[1]);
+
+	(void)printf("sim_fram_erase: %lu failures\n", (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
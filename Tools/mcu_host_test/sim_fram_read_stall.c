@@ -0,0 +1,282 @@
+/**
+ * @file sim_fram_read_stall.c
+ * @brief Simulation of the main-loop stall of a 64 KB FRAM read, against the real bsp_fram.c and bsp_serialport.c
+ *
+ * A 64 KB image is read and hashed as the firmware image verify does, with the blocking bsp_fram_read and with the
+ * non-blocking bsp_fram_read_IT, which reads the next chunk while the last one is hashed. The SPI bus runs on a virtual
+ * clock at 5 MHz. A polled HAL call takes the time of its bytes plus the time the HAL takes to set it up, and a
+ * non-blocking receive takes an interrupt for each byte, which is taken from the main loop; both costs are assumptions
+ * to be replaced by the ones measured on the board. A blocking read must finish within the 5 ms timeout the firmware
+ * gives HAL_SPI_Receive, so it is done in chunks of 2 KB.
+ * The stall is the time the main loop spends inside the FRAM calls. The simulation fails if the data read is not the
+ * data in the FRAM or a HAL call takes longer than its timeout.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include "app_config.h"
+
+#define SIM_NS_PER_BYTE			1600.0		/*!< 8 bits at the 5 MHz SPI clock */
+#define SIM_HAL_CALL_US			3.0			/*!< Setting up and ending one HAL SPI call at 160 MHz, assumed */
+#define SIM_RX_IRQ_US			0.5			/*!< One RXP interrupt of HAL_SPI_Receive_IT, 80 cycles at 160 MHz, assumed */
+#define SIM_HASH_US_PER_BYTE	0.1			/*!< Hashing one byte of the image, assumed */
+#define SIM_WAIT_US				1.0			/*!< One pass of a wait loop in the main context */
+#define SIM_FRAM_SIZE			(CY15B108QN_MAX_ADDR + 1UL)
+#define SIM_READ_SIZE			0x10000UL	/*!< 64 KB */
+#define SIM_CHUNK_SIZE			2048U		/*!< The largest power of two a blocking read moves within its 5 ms timeout */
+
+static uint8_t fram[SIM_FRAM_SIZE];
+static uint8_t chunks[2][SIM_CHUNK_SIZE];
+static double now_us = 0.0;
+static double stall_us = 0.0;				/*!< The time spent inside the FRAM calls */
+static double stall_max_us = 0.0;
+static double irq_us = 0.0;
+static uint32_t failures = 0;
+
+static GPIO_PinState fram_cs = GPIO_PIN_SET;
+static uint8_t fram_cmd[4];
+static uint32_t fram_cmd_len = 0;
+static uint32_t fram_addr = 0;
+
+static HAL_SPI_StateTypeDef spi_state = HAL_SPI_STATE_READY;
+static uint8_t* p_rx_data = NULL;
+static uint16_t rx_len = 0;
+static double rx_done_us = 0.0;
+static uint32_t primask = 0;
+static bool in_isr = false;
+static volatile bool read_done = false;
+
+/**
+ * @brief The bytes clocked out to the CY15B108QN while its CS is low, only the address of a READ is kept
+ *
+ */
+static void fram_bytes(const uint8_t* p_data, uint16_t size) {
+	for (uint16_t i = 0; (i < size) && (fram_cmd_len < sizeof(fram_cmd)); i++) {
+		fram_cmd[fram_cmd_len++] = p_data[i];
+		if (fram_cmd_len == sizeof(fram_cmd)) {
+			fram_addr = ((uint32_t)fram_cmd[1] << 16) | ((uint32_t)fram_cmd[2] << 8) | fram_cmd[3];
+		}
+	}
+}
+
+/**
+ * @brief The bytes clocked in from the CY15B108QN after a READ
+ *
+ */
+static void fram_bytes_in(uint8_t* p_data, uint16_t size) {
+	if ((fram_cmd_len != sizeof(fram_cmd)) || (fram_cmd[0] != CY15B108QN_CMD_READ)) {
+		(void)printf("FAIL receive of %u bytes without a READ\n", size);
+		failures++;
+		return;
+	}
+	for (uint16_t i = 0; i < size; i++) {
+		p_data[i] = fram[fram_addr % SIM_FRAM_SIZE];
+		fram_addr++;
+	}
+}
+
+void HAL_GPIO_WritePin(uint32_t port, uint16_t pin, GPIO_PinState state) {
+	UNUSED(port);
+	if ((pin == SPI1_FRAM_CSn_Pin) && (state != fram_cs)) {
+		fram_cmd_len = 0;
+		fram_cs = state;
+	}
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(const SPI_HandleTypeDef* hspi) {
+	UNUSED(hspi);
+	return spi_state;
+}
+
+/**
+ * @brief The time of a polled HAL call, it must finish within its timeout
+ *
+ */
+static void sim_polled_call(uint16_t size, uint32_t timeout) {
+	double call_us = SIM_HAL_CALL_US + ((double)size * SIM_NS_PER_BYTE / 1000.0);
+	if (call_us > ((double)timeout * 1000.0)) {
+		(void)printf("FAIL HAL call of %u bytes takes %.1f us, the timeout is %lu ms\n", size, call_us, (unsigned long)timeout);
+		failures++;
+	}
+	now_us += call_us;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, const uint8_t* p_data, uint16_t size, uint32_t timeout) {
+	UNUSED(hspi);
+	sim_polled_call(size, timeout);
+	if (fram_cs == GPIO_PIN_RESET) {
+		fram_bytes(p_data, size);
+	}
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef* hspi, uint8_t* p_data, uint16_t size, uint32_t timeout) {
+	UNUSED(hspi);
+	sim_polled_call(size, timeout);
+	fram_bytes_in(p_data, size);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive_IT(SPI_HandleTypeDef* hspi, uint8_t* p_data, uint16_t size) {
+	UNUSED(hspi);
+	if (spi_state != HAL_SPI_STATE_READY) {
+		return HAL_BUSY;
+	}
+	now_us += SIM_HAL_CALL_US;
+	spi_state = HAL_SPI_STATE_BUSY;
+	p_rx_data = p_data;
+	rx_len = size;
+	rx_done_us = now_us + ((double)size * SIM_NS_PER_BYTE / 1000.0);
+	return HAL_OK;
+}
+
+/**
+ * @brief Run the completion of the receive if it is done, or wait for it
+ *
+ */
+static void spi_irq_run(bool wait) {
+	if ((spi_state == HAL_SPI_STATE_BUSY) && (wait || (rx_done_us <= now_us))) {
+		now_us = (rx_done_us > now_us) ? rx_done_us : now_us;
+		fram_bytes_in(p_rx_data, rx_len);
+		spi_state = HAL_SPI_STATE_READY;
+		in_isr = true;
+		HAL_SPI_RxCpltCallback(&hspi1);
+		in_isr = false;
+	}
+}
+
+/**
+ * @brief Work in the main context, slowed by the interrupt of each byte received while a receive is in flight
+ *
+ */
+static void sim_work(double work_us) {
+	double byte_us = SIM_NS_PER_BYTE / 1000.0;
+	while (work_us > 0.0) {
+		if (spi_state != HAL_SPI_STATE_BUSY) {
+			now_us += work_us;
+			break;
+		}
+		//Each byte time leaves byte_us - SIM_RX_IRQ_US to the main context
+		double free_us = (rx_done_us - now_us) * ((byte_us - SIM_RX_IRQ_US) / byte_us);
+		if (work_us < free_us) {
+			double wall_us = work_us * (byte_us / (byte_us - SIM_RX_IRQ_US));
+			irq_us += wall_us - work_us;
+			now_us += wall_us;
+			break;
+		}
+		irq_us += (rx_done_us - now_us) - free_us;
+		work_us -= free_us;
+		spi_irq_run(true);
+	}
+}
+
+void hal_stub_irq_disable(void) {
+	primask = 1U;
+}
+
+uint32_t hal_stub_primask_get(void) {
+	return primask;
+}
+
+/**
+ * @brief A wait loop of the main context polls with the interrupts masked, the receive completes when the mask is cleared
+ *
+ */
+void hal_stub_primask_set(uint32_t mask) {
+	primask = mask;
+	if ((mask == 0U) && (in_isr == false)) {
+		sim_work(SIM_WAIT_US);
+		spi_irq_run(false);
+	}
+}
+
+static void sim_read_cplt_cb(uint32_t read_addr, uint16_t read_size) {
+	read_done = true;
+}
+
+static void sim_hash(const uint8_t* p_data, uint16_t len, uint32_t offset) {
+	sim_work((double)len * SIM_HASH_US_PER_BYTE);
+	if (memcmp(p_data, &fram[ADDR_FW_IMG_BASE + offset], len) != 0) {
+		(void)printf("FAIL chunk at 0x%05lX differs from the FRAM\n", (unsigned long)offset);
+		failures++;
+	}
+}
+
+/**
+ * @brief Count the time spent in a FRAM call as a stall of the main loop
+ *
+ */
+static void sim_stall_end(double start_us) {
+	double call_us = now_us - start_us;
+	stall_us += call_us;
+	stall_max_us = (call_us > stall_max_us) ? call_us : stall_max_us;
+}
+
+static void sim_read_blocking(void) {
+	for (uint32_t offset = 0; offset < SIM_READ_SIZE; offset += SIM_CHUNK_SIZE) {
+		double start_us = now_us;
+		bsp_fram_read(ADDR_FW_IMG_BASE + offset, chunks[0], SIM_CHUNK_SIZE);
+		sim_stall_end(start_us);
+		sim_hash(chunks[0], SIM_CHUNK_SIZE, offset);
+	}
+}
+
+/**
+ * @brief The next chunk is read into the other buffer while the last one is hashed
+ *
+ */
+static void sim_read_double_buffered(void) {
+	double start_us = now_us;
+	read_done = false;
+	bsp_fram_read_IT(ADDR_FW_IMG_BASE, chunks[0], SIM_CHUNK_SIZE, &sim_read_cplt_cb);
+	sim_stall_end(start_us);
+	uint8_t cur = 0;
+	for (uint32_t offset = 0; offset < SIM_READ_SIZE; offset += SIM_CHUNK_SIZE) {
+		//The main loop is free while it waits, it only polls the flag
+		while (!read_done) {
+			sim_work(SIM_WAIT_US);
+			spi_irq_run(false);
+		}
+		read_done = false;
+		if ((offset + SIM_CHUNK_SIZE) < SIM_READ_SIZE) {
+			start_us = now_us;
+			bsp_fram_read_IT(ADDR_FW_IMG_BASE + offset + SIM_CHUNK_SIZE, chunks[cur ^ 1U], SIM_CHUNK_SIZE, &sim_read_cplt_cb);
+			sim_stall_end(start_us);
+		}
+		else {
+			read_done = true;
+		}
+		sim_hash(chunks[cur], SIM_CHUNK_SIZE, offset);
+		cur ^= 1U;
+	}
+}
+
+int main(void) {
+	const struct {
+		const char*	Name;
+		void		(*Read)(void);
+	} cases[] = {
+		{"blocking", &sim_read_blocking},
+		{"non-blocking", &sim_read_double_buffered},
+	};
+
+	for (uint32_t i = 0; i < SIZE_FW_IMG; i++) {
+		fram[ADDR_FW_IMG_BASE + i] = (uint8_t)((i * 7U) + (i >> 8));
+	}
+
+	(void)printf("sim_fram_read_stall: %lu KB read and hashed in chunks of %u bytes at 5 MHz SPI\n",
+			(unsigned long)(SIM_READ_SIZE / 1024U), SIM_CHUNK_SIZE);
+	(void)printf("  %-14s %10s %10s %14s %12s\n", "Read", "total", "stall", "longest stall", "interrupts");
+	for (uint32_t c = 0; c < (sizeof(cases) / sizeof(cases[0])); c++) {
+		now_us = 0.0;
+		stall_us = 0.0;
+		stall_max_us = 0.0;
+		irq_us = 0.0;
+		cases[c].Read();
+		(void)printf("  %-14s %7.1f ms %7.1f ms %11.1f us %9.1f ms\n", cases[c].Name, now_us / 1000.0, stall_us / 1000.0,
+				stall_max_us, irq_us / 1000.0);
+	}
+	(void)printf("  bytes on the bus %.1f ms\n", (double)SIM_READ_SIZE * SIM_NS_PER_BYTE / 1e6);
+
+	(void)printf("sim_fram_read_stall: %lu failures\n", (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+/**
+ * @file sim_imp_survey.c
+ * @brief Simulation of the impedance survey against one impedance test per electrode pair, against the real app_mode_impedance_test.c
+ *
+ * The stimulation and measurement functions take the time of the firmware they stand for on a virtual clock: the
+ * HAL_Delay calls, the ADC sampling of both channels and the I2C writes of the supplies and the DAC. The load of
+ * each pair comes from a table that also holds a NaN, a negative and an out-of-range impedance, so the saturation
+ * to uint16_t is checked on the survey matrix and on the last impedance. The pair is found from the sinks set by
+ * app_func_stim_curr_src_set and the cathode set by app_func_meas_imp_sel_set, as the hardware would see it.
+ * The simulation fails if a pair is measured out of order or its impedance is not the saturated one.
+ * @copyright Copyright (c) 2024
+ */
+#include <math.h>
+#include <stdio.h>
+#include "app_config.h"
+
+#define SIM_I2C_WRITE_US		100.0		/*!< One I2C write to the HV supply or the DAC at 400 kHz */
+#define SIM_LOG_WRITE_US		20.0		/*!< Formatting a log, the FRAM write is queued and not waited for */
+
+static double now_us = 0.0;
+static uint32_t failures = 0;
+static uint32_t log_num = 0;
+
+static uint8_t pair_sinks = 0;				/*!< The sinks set by app_func_stim_curr_src_set, both electrodes of the pair */
+static uint8_t pair_snkN = 0;				/*!< The cathode set by app_func_meas_imp_sel_set */
+static uint8_t pair_order[IMP_SURVEY_PAIR_NUM][2];
+static uint8_t pair_meas_num = 0;
+static uint8_t seq_snkP = 1;				/*!< The pair returned by SNS_ANODE/CATHODE_ELECTRODE_NUMBER */
+static uint8_t seq_snkN = 2;
+
+/**
+ * @brief The impedance of a pair, with the values the uint16_t conversion has to saturate
+ *
+ */
+static _Float64 sim_load_ohm(uint8_t snkP, uint8_t snkN) {
+	if ((snkP == 1U) && (snkN == 2U)) {
+		return NAN;						/* Open lead, both channels read the same voltage */
+	}
+	else if ((snkP == 1U) && (snkN == 3U)) {
+		return -35.0;					/* The offset of the ADC is larger than the load voltage */
+	}
+	else if ((snkP == 2U) && (snkN == 5U)) {
+		return 81234.0;
+	}
+	else {
+		return 500.0 + (100.0 * snkP) + (10.0 * snkN) + 0.75;
+	}
+}
+
+static uint16_t sim_saturated(_Float64 impedance) {
+	if (isnan(impedance) || (impedance <= 0.0)) {
+		return 0U;
+	}
+	return (impedance >= (_Float64)UINT16_MAX) ? UINT16_MAX : (uint16_t)impedance;
+}
+
+void HAL_Delay(uint32_t delay) {
+	now_us += (double)delay * 1000.0;
+}
+
+void bsp_wdg_refresh(void) {
+}
+
+void app_func_para_data_get(const uint8_t* p_id, uint8_t* p_data, uint8_t buff_size) {
+	_Float64 val = 1.0;
+	if (memcmp(p_id, SPID_SNS_ANODE_ELECTRODE_NUMBER, LEN_ID) == 0) {
+		val = (_Float64)seq_snkP;
+	}
+	else if (memcmp(p_id, SPID_SNS_CATHODE_ELECTRODE_NUMBER, LEN_ID) == 0) {
+		val = (_Float64)seq_snkN;
+	}
+	(void)memcpy(p_data, (uint8_t*)&val, buff_size);
+}
+
+void app_func_para_data_set(const uint8_t* p_id, uint8_t* p_data) {
+}
+
+_Float64 app_func_para_val_quant_clip(const uint8_t* p_id, _Float64 val) {
+	return val;
+}
+
+void app_func_logs_event_write(const char* event_type, Log_Event_Write_Callback callback) {
+	now_us += SIM_LOG_WRITE_US;
+	log_num++;
+}
+
+void app_func_logs_imped_write(uint32_t imp) {
+	now_us += SIM_LOG_WRITE_US;
+	log_num++;
+}
+
+void app_func_logs_imped_survey_write(const uint16_t* p_imp, uint8_t num) {
+	now_us += SIM_LOG_WRITE_US;
+	log_num++;
+}
+
+void app_func_sm_current_state_set(uint16_t state) {
+}
+
+void app_func_sm_impedance_timer_enable(void) {
+}
+
+void app_func_stim_hv_supply_set(bool turnon, bool enable) {
+}
+
+uint8_t app_func_stim_hv_sup_volt_set(uint16_t voltage_mv) {
+	now_us += SIM_I2C_WRITE_US;
+	return HAL_OK;
+}
+
+void app_func_stim_vdds_sup_enable(bool enable) {
+}
+
+uint8_t app_func_stim_dac_init(void) {
+	now_us += SIM_I2C_WRITE_US * 2.0;
+	return HAL_OK;
+}
+
+uint8_t app_func_stim_dac_volt_set(uint16_t voltageA_mv, uint16_t voltageB_mv) {
+	now_us += SIM_I2C_WRITE_US * 2.0;
+	return HAL_OK;
+}
+
+_Float64 app_func_stim_iout_to_dac(_Float64 iout_mA) {
+	return iout_mA * 100.0;
+}
+
+void app_func_stim_curr_src_set(Current_Sources_t current_sources) {
+	pair_sinks = (uint8_t)((current_sources.snk1 ? 0x01U : 0U) | (current_sources.snk2 ? 0x02U : 0U)
+			| (current_sources.snk3 ? 0x04U : 0U) | (current_sources.snk4 ? 0x08U : 0U) | (current_sources.snk5 ? 0x10U : 0U));
+}
+
+void app_func_stim_circuit_para1_set(Stimulus_Waveform_t stimulus_waveform) {
+}
+
+void app_func_stim_sel_set(Stim_Sel_t sel) {
+}
+
+void app_func_stim_stimulus_enable(bool enable) {
+}
+
+void app_func_stim_mux_enable(bool enable) {
+}
+
+void app_func_stim_off(void) {
+}
+
+void app_func_stim_stim1_start(bool imc_en) {
+}
+
+void app_func_stim_stim1_stop(void) {
+}
+
+void app_func_stim_sync(void) {
+}
+
+void app_func_meas_imp_enable(bool enable) {
+}
+
+void app_func_meas_imp_sel_set(bool impin_n_sel0, bool impin_n_sel1, bool impin_n_sel2, bool impin_p_sel) {
+	pair_snkN = (uint8_t)((impin_n_sel0 ? 1U : 0U) | (impin_n_sel1 ? 2U : 0U) | (impin_n_sel2 ? 4U : 0U)) + 1U;
+}
+
+uint16_t app_func_meas_imp_sampPoints_get(uint32_t samplingFrequency_hz, uint32_t samplingTime_us) {
+	uint32_t samplingPoints = (uint32_t)((samplingFrequency_hz * (samplingTime_us * 1e-6)) + 0.5);
+	return (samplingPoints == 0U) ? 1U : (uint16_t)samplingPoints;
+}
+
+void app_func_meas_imp_volt_meas(uint32_t channel, uint16_t voltageBuffer[], uint16_t samplingPoints, uint16_t samplingFrequency_hz) {
+	now_us += ((double)samplingPoints * 1e6) / (double)samplingFrequency_hz;
+}
+
+_Float64 app_func_meas_imp_volt_calc(uint16_t voltageBuffer[], uint16_t periodPoints, uint16_t widthPoints) {
+	return 0.0;
+}
+
+/**
+ * @brief The load of the pair the hardware is set to, the measured pairs are recorded in order.
+ * The anode is the sink that is not the cathode.
+ *
+ */
+_Float64 app_func_meas_imp_calc(_Float64 vdac_mV, _Float64 vload_mV) {
+	uint8_t pair_snkP = 0U;
+	for (uint8_t i = 0; i < IMP_ELECTRODE_NUM; i++) {
+		if ((((pair_sinks >> i) & 0x01U) != 0U) && ((i + 1U) != pair_snkN)) {
+			pair_snkP = i + 1U;
+		}
+	}
+	if (pair_meas_num < IMP_SURVEY_PAIR_NUM) {
+		pair_order[pair_meas_num][0] = pair_snkP;
+		pair_order[pair_meas_num][1] = pair_snkN;
+	}
+	pair_meas_num++;
+	return sim_load_ohm(pair_snkP, pair_snkN);
+}
+
+/**
+ * @brief Check the pairs were measured in the documented order, (1,2),(1,3),...,(4,5)
+ *
+ */
+static void sim_order_check(const char* name) {
+	uint8_t i = 0;
+	for (uint8_t p = 1U; p < IMP_ELECTRODE_NUM; p++) {
+		for (uint8_t n = p + 1U; n <= IMP_ELECTRODE_NUM; n++) {
+			if ((pair_order[i][0] != p) || (pair_order[i][1] != n)) {
+				(void)printf("FAIL %s: pair %u measured (%u,%u), expected (%u,%u)\n", name, i, pair_order[i][0],
+						pair_order[i][1], p, n);
+				failures++;
+			}
+			i++;
+		}
+	}
+}
+
+int main(void) {
+	uint16_t imp_matrix[IMP_SURVEY_PAIR_NUM];
+
+	/* One impedance test per pair, as the app did before the survey */
+	now_us = 0.0;
+	log_num = 0;
+	pair_meas_num = 0;
+	for (seq_snkP = 1U; seq_snkP < IMP_ELECTRODE_NUM; seq_snkP++) {
+		for (seq_snkN = seq_snkP + 1U; seq_snkN <= IMP_ELECTRODE_NUM; seq_snkN++) {
+			(void)app_mode_impedance_test_get();
+			uint16_t imp_last = 0;
+			(void)app_mode_impedance_test_last_get(&imp_last);
+			uint16_t expected = sim_saturated(sim_load_ohm(seq_snkP, seq_snkN));
+			if (imp_last != expected) {
+				(void)printf("FAIL sequential: pair (%u,%u) last impedance %u, expected %u\n", seq_snkP, seq_snkN,
+						imp_last, expected);
+				failures++;
+			}
+		}
+	}
+	sim_order_check("sequential");
+	double seq_us = now_us;
+	uint32_t seq_logs = log_num;
+
+	/* The survey, the supplies stay up and only the switch matrix changes between pairs */
+	now_us = 0.0;
+	log_num = 0;
+	pair_meas_num = 0;
+	(void)memset(imp_matrix, 0xA5, sizeof(imp_matrix));
+	uint8_t pair_num = app_mode_impedance_test_survey(imp_matrix);
+	sim_order_check("survey");
+	if (pair_num != IMP_SURVEY_PAIR_NUM) {
+		(void)printf("FAIL survey: %u pairs measured\n", pair_num);
+		failures++;
+	}
+	for (uint8_t i = 0; i < IMP_SURVEY_PAIR_NUM; i++) {
+		uint16_t expected = sim_saturated(sim_load_ohm(pair_order[i][0], pair_order[i][1]));
+		if (imp_matrix[i] != expected) {
+			(void)printf("FAIL survey: pair (%u,%u) impedance %u, expected %u\n", pair_order[i][0], pair_order[i][1],
+					imp_matrix[i], expected);
+			failures++;
+		}
+	}
+	double survey_us = now_us;
+
+	(void)printf("sim_imp_survey: %u electrode pairs\n", IMP_SURVEY_PAIR_NUM);
+	(void)printf("  %-26s %10s %10s %6s\n", "Method", "total", "per pair", "logs");
+	(void)printf("  %-26s %7.1f ms %7.1f ms %6lu\n", "one test per pair", seq_us / 1000.0,
+			seq_us / 1000.0 / IMP_SURVEY_PAIR_NUM, (unsigned long)seq_logs);
+	(void)printf("  %-26s %7.1f ms %7.1f ms %6lu\n", "survey", survey_us / 1000.0,
+			survey_us / 1000.0 / IMP_SURVEY_PAIR_NUM, (unsigned long)log_num);
+	(void)printf("  speedup %.2fx\n", seq_us / survey_us);
+
+	(void)printf("sim_imp_survey: %lu failures\n", (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
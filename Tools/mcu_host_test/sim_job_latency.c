@@ -0,0 +1,181 @@
+/**
+ * @file sim_job_latency.c
+ * @brief Simulation of the latency of JOB_STATUS while a job runs, against the real app_func_job.c and app_func_command.c
+ *
+ * The BLE connection mode runs one step of the job and then serves the commands received, so a command waits
+ * at most for the step that is running. The steps take the time of the firmware they stand for, from its delays,
+ * sampling and FRAM reads, on a virtual clock. JOB_STATUS requests arrive at random times and the time until they
+ * are served is measured, against the time a request waits behind the blocking command.
+ * The simulation fails if a status or a JOB_NOTIFY is wrong, or the job does not finish.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include "app_config.h"
+
+#define SIM_LOOP_US				1000.0		/*!< One pass of bsp_sp_cmd_handler in the main loop */
+#define SIM_TAKE_US				1000.0		/*!< The time until the nRF52810 takes the response command */
+#define SIM_QUERY_MIN_US		20000U		/*!< The shortest time between two JOB_STATUS requests */
+#define SIM_QUERY_RANGE_US		80000U		/*!< The random part of the time between two JOB_STATUS requests */
+#define SIM_TIMEOUT_US			60000000.0
+#define SIM_RUNS				50U			/*!< The runs of each job, the requests start at a random time */
+#define SIM_RESULT				0xABU
+
+typedef struct {
+	const char*	Name;
+	uint8_t		Opcode;
+	uint8_t		PayloadLen;
+	uint32_t	Steps;
+	double		FirstUs;		/*!< The first step, with the power-up of the measurement */
+	double		StepUs;
+} Job_Model_t;
+
+static const Job_Model_t job_models[] = {
+	/* HAL_Delay(10) settle, then 5 samples of each battery at BATT_MON_SAMPLE_FREQ per step, 100 samples in total */
+	{"MEASURE_BATTERY_VOLTAGE",		OP_MEASURE_BATTERY_VOLTAGE,		0U, 20U,	110000.0,	100000.0},
+	/* 2 x HAL_Delay(100) power-up, then per pair 10 ms settle, 200 ms train and 2 x 500 samples at 50 kHz */
+	{"MEASURE_IMPEDANCE_SURVEY",	OP_MEASURE_IMPEDANCE_SURVEY,	0U, 10U,	430000.0,	230000.0},
+	/* 2 x HAL_Delay(100), 200 ms train and 2 x 500 samples at 50 kHz, in one step */
+	{"MEASURE_IMPEDANCE",			OP_MEASURE_IMPEDANCE,			0U, 1U,		420000.0,	420000.0},
+	/* 256 KB image, 64 packets of 128 B per step, each read from FRAM at 5 MHz SPI while the last one is hashed */
+	{"VERIFY_FW_IMAGE (256 KB)",	OP_VERIFY_FW_IMAGE,				4U, 32U,	13520.0,	13520.0},
+};
+
+static const Job_Model_t* p_model = NULL;
+static uint32_t step_count = 0;
+static double now_us = 0.0;
+static double taken_us = 0.0;				/*!< The time the nRF52810 takes the last response command */
+static uint32_t rng_state = 1;
+static uint32_t failures = 0;
+
+static uint32_t notify_num = 0;
+static uint8_t notify_last[LEN_CMD_MAX];
+static uint8_t notify_progress = 0;
+
+static uint32_t rng_next(uint32_t range) {
+	rng_state = (rng_state * 1103515245UL) + 12345UL;
+	return (rng_state >> 8) % range;
+}
+
+bool bsp_sp_cmd_is_pending(void) {
+	return (now_us < taken_us);
+}
+
+/**
+ * @brief Only the job sends commands by itself, so every command sent is a JOB_NOTIFY
+ *
+ */
+void bsp_sp_cmd_send(const uint8_t* data, uint8_t data_len) {
+	(void)memcpy(notify_last, data, data_len);
+	taken_us = now_us + SIM_TAKE_US;
+	notify_num++;
+	if ((data[0] != OP_JOB_NOTIFY) || (data[LEN_RESP_HEADER + 3U] < notify_progress)) {
+		(void)printf("FAIL %s: JOB_NOTIFY 0x%02X progress %u after %u\n", p_model->Name, data[0],
+				data[LEN_RESP_HEADER + 3U], notify_progress);
+		failures++;
+	}
+	notify_progress = data[LEN_RESP_HEADER + 3U];
+}
+
+static bool sim_job_step(Cmd_Resp_t* p_result, uint8_t* p_progress) {
+	now_us += (step_count == 0U) ? p_model->FirstUs : p_model->StepUs;
+	step_count++;
+	*p_progress = (uint8_t)((step_count * 100U) / p_model->Steps);
+	if (step_count < p_model->Steps) {
+		return false;
+	}
+	p_result->Status = STATUS_SUCCESS;
+	p_result->Payload[0] = SIM_RESULT;
+	p_result->PayloadLen = 1U;
+	return true;
+}
+
+static void sim_job_cmd(const Cmd_Req_t* p_req, Cmd_Resp_t* p_resp) {
+	step_count = 0;
+	app_func_job_start(p_req->Opcode, &sim_job_step, NULL, USER_CLASS_ADMIN, p_resp);
+}
+
+static Cmd_Entry_t job_entries[256];
+static const Cmd_Table_t job_tables[] = {
+	{job_entries, 0U, 255U},
+};
+
+/**
+ * @brief Run the job once with JOB_STATUS requests from a random time, as the BLE connection mode does
+ *
+ * @param p_lat_max The longest wait of a request, updated
+ * @param p_lat_sum The sum of the waits, updated
+ * @param p_lat_num The number of requests, updated
+ */
+static void sim_run(double* p_lat_max, double* p_lat_sum, uint32_t* p_lat_num) {
+	uint8_t req_payload[1U + sizeof(uint32_t)] = {p_model->Opcode, 0U, 0U, 0U, 0U};
+	uint8_t resp_payload[LEN_RESP_PAYLOAD_MAX];
+	Cmd_Req_t req = {OP_JOB_START, req_payload, (uint8_t)(1U + p_model->PayloadLen)};
+	Cmd_Resp_t resp = {OP_JOB_START, STATUS_SUCCESS, resp_payload, 0U};
+
+	now_us = 0.0;
+	taken_us = 0.0;
+	notify_num = 0;
+	notify_progress = 0;
+	app_func_job_cmd_start(job_tables, 1U, USER_CLASS_ADMIN, &req, &resp);
+	if ((resp.Status != STATUS_SUCCESS) || (resp_payload[2] != JOB_STATE_RUNNING)) {
+		(void)printf("FAIL %s: JOB_START status 0x%02X state %u\n", p_model->Name, resp.Status, resp_payload[2]);
+		failures++;
+		return;
+	}
+	uint8_t job_id = resp_payload[0];
+	now_us += SIM_LOOP_US;
+
+	double query_us = (double)rng_next(SIM_QUERY_MIN_US + SIM_QUERY_RANGE_US);
+	bool busy = true;
+	while (busy && (now_us < SIM_TIMEOUT_US)) {
+		busy = app_func_job_handler();
+		now_us += SIM_LOOP_US;
+		while (query_us <= now_us) {
+			uint8_t id = job_id;
+			Cmd_Req_t status_req = {OP_JOB_STATUS, &id, 1U};
+			Cmd_Resp_t status_resp = {OP_JOB_STATUS, STATUS_SUCCESS, resp_payload, 0U};
+			app_func_job_cmd_status(USER_CLASS_ADMIN, &status_req, &status_resp);
+			if ((status_resp.Status != STATUS_SUCCESS) || (resp_payload[0] != job_id)) {
+				(void)printf("FAIL %s: JOB_STATUS status 0x%02X ID %u\n", p_model->Name, status_resp.Status, resp_payload[0]);
+				failures++;
+			}
+			double lat_us = now_us - query_us;
+			*p_lat_max = (lat_us > *p_lat_max) ? lat_us : *p_lat_max;
+			*p_lat_sum += lat_us;
+			(*p_lat_num)++;
+			query_us += (double)(SIM_QUERY_MIN_US + rng_next(SIM_QUERY_RANGE_US));
+		}
+	}
+
+	if (busy || (notify_last[LEN_RESP_HEADER + 2U] != JOB_STATE_DONE) || (notify_last[LEN_RESP_HEADER + 3U] != 100U)
+			|| (notify_last[LEN_RESP_HEADER + LEN_JOB_INFO] != SIM_RESULT)) {
+		(void)printf("FAIL %s: the job did not finish with its result\n", p_model->Name);
+		failures++;
+	}
+}
+
+int main(void) {
+	for (uint32_t m = 0; m < (sizeof(job_models) / sizeof(job_models[0])); m++) {
+		job_entries[job_models[m].Opcode] = (Cmd_Entry_t){&sim_job_cmd, job_models[m].PayloadLen, job_models[m].PayloadLen, USER_CLASS_ADMIN};
+	}
+
+	(void)printf("sim_job_latency: JOB_STATUS every %u~%u ms, %u runs per job\n", SIM_QUERY_MIN_US / 1000U,
+			(SIM_QUERY_MIN_US + SIM_QUERY_RANGE_US) / 1000U, SIM_RUNS);
+	(void)printf("  %-26s %6s %11s %11s %14s %9s\n", "Job", "steps", "status max", "status avg", "blocking max", "notifies");
+	for (uint32_t m = 0; m < (sizeof(job_models) / sizeof(job_models[0])); m++) {
+		p_model = &job_models[m];
+		double lat_max = 0.0;
+		double lat_sum = 0.0;
+		uint32_t lat_num = 0;
+		for (uint32_t r = 0; r < SIM_RUNS; r++) {
+			sim_run(&lat_max, &lat_sum, &lat_num);
+		}
+		double blocking_us = p_model->FirstUs + (p_model->StepUs * (double)(p_model->Steps - 1U));
+		(void)printf("  %-26s %6lu %8.1f ms %8.1f ms %11.1f ms %9lu\n", p_model->Name, (unsigned long)p_model->Steps,
+				lat_max / 1000.0, (lat_num > 0U) ? (lat_sum / lat_num / 1000.0) : 0.0, blocking_us / 1000.0,
+				(unsigned long)notify_num);
+	}
+
+	(void)printf("sim_job_latency: %lu failures\n", (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
@@ -0,0 +1,297 @@
+/**
+ * @file sim_para_batch_link.c
+ * @brief Simulation of loading a full therapy profile over the BLE link, one parameter per command against batches, against
+ * the real app_mode_ble_connection.c and app_func_parameter.c
+ *
+ * The host writes every stimulation parameter of the therapy profile to new data and reads them all back, first with one
+ * WRITE_STIMULATION_PARAMETERS and one READ_STIMULATION_PARAMETERS per parameter, then with WRITE_PARAMETERS_BATCH and
+ * READ_PARAMETERS_BATCH frames filled up to the maximum payload. The requests go through the real parser of the BLE
+ * connection mode and the parameters are kept in the FRAM image, as on the board.
+ * The host sends a request when it has the response to the last one. The request reaches the nRF52810 after the latency
+ * of the host BLE stack and is sent at the next connection event, the MCU reads it, serves it and writes the response,
+ * which is sent at the next connection event after that and reaches the host after the latency again. The SPI transfers
+ * to the nRF52810 and the FRAM take the time of their bytes at 5 MHz plus the time of the HAL call, assumed as in
+ * sim_para_latency. The simulation fails if a response is not a success or the data read back is not the data written.
+ * @copyright Copyright (c) 2024
+ */
+#include <math.h>
+#include "app_mode_ble_connection.c"
+
+#define SIM_NS_PER_BYTE			1600.0		/*!< 8 bits at the 5 MHz SPI clock */
+#define SIM_HAL_CALL_US			3.0			/*!< Setting up and ending one HAL SPI call at 160 MHz, assumed */
+#define SIM_PARSE_US			20.0		/*!< Checking and parsing one request and building its response, assumed */
+#define SIM_LATENCY_US			3000.0		/*!< The latency of the host BLE stack each way, as in sim_cmd_pipeline */
+#define SIM_PARA_NUM_MAX		64U
+
+typedef struct {
+	const char*	Name;
+	uint8_t		OpWrite;
+	uint8_t		OpRead;
+	bool		Batch;
+} Load_Case_t;
+
+bool vnsb_en = false;
+
+static uint8_t fram[CY15B108QN_MAX_ADDR + 1UL];
+static double mcu_us = 0.0;					/*!< The time the MCU spends on a request */
+static double mcu_total_us = 0.0;
+static uint32_t round_trips = 0;
+static double now_us = 0.0;
+static double ci_us = 7500.0;
+static uint32_t failures = 0;
+
+static const uint8_t* para_ids[SIM_PARA_NUM_MAX];
+static uint8_t para_num = 0;
+static uint8_t para_data[SIM_PARA_NUM_MAX][LEN_RESP_PAYLOAD_MAX];	/*!< The data the host writes, in the format of the requests */
+static uint8_t para_len[SIM_PARA_NUM_MAX];							/*!< The length of the data the host writes */
+
+extern Parameter_t parameters_list[];
+extern const uint16_t parameters_list_size;
+
+/* ---- Fakes of the functions the modules call, all of them succeed ---- */
+
+uint8_t app_mode_ble_act_userclass_get(void) { return USER_CLASS_ADMIN; }
+bool app_func_auth_verify_sign_admin(ECDSA_Data_t ecdsa_data) { return true; }
+uint8_t app_func_ble_curr_state_get(void) { return BLE_STATE_INVALID; }
+void app_func_ble_disconnect(void) { }
+void app_func_ble_enable(bool enable) { }
+void app_func_ble_new_state_get(void) { }
+void app_func_logs_erase(void) { }
+bool app_func_logs_event_search(const char* event_type) { return false; }
+void app_func_logs_event_write(const char* event_type, Log_Event_Write_Callback callback) { }
+void app_func_logs_flush(void) { }
+void app_func_logs_parameter_write(uint8_t* p_id, uint8_t data_format, const uint8_t* p_data, uint16_t data_len) { }
+uint8_t app_func_logs_read(const uint8_t* p_timestamp, uint8_t* p_data) { return 0; }
+void app_func_meas_batt_mon_enable(bool enable) { }
+void app_func_meas_batt_mon_meas(uint16_t* p_vbatA, uint16_t* p_vbatB) { *p_vbatA = 0; *p_vbatB = 0; }
+void app_func_meas_sensor_continue(void) { }
+void app_func_meas_sensor_enable(uint8_t sensorID, bool enable) { }
+void app_func_meas_sensor_sampling(uint8_t sensorID, uint8_t* buff, uint8_t bufferSize, float samplingFrequency_hz) { }
+void app_func_meas_vdda_sup_enable(bool enable) { }
+void app_mode_battery_test_volt_abort(void) { }
+void app_mode_battery_test_volt_get(uint16_t* p_vbatA, uint16_t* p_vbatB) { *p_vbatA = 0; *p_vbatB = 0; }
+bool app_mode_battery_test_volt_step(uint16_t* p_vbatA, uint16_t* p_vbatB, uint8_t* p_progress) { return false; }
+uint8_t app_mode_dvt_acc_data_get(DeviceID_t deviceID, uint8_t* dataBuffer, uint8_t* dataSize) { *dataSize = 0; return STATUS_SUCCESS; }
+uint8_t app_mode_dvt_acc_start(FreqModeDeviceID_t freqModedeviceID, uint8_t* dataBuffer, uint8_t* dataSize) { *dataSize = 0; return STATUS_SUCCESS; }
+uint8_t app_mode_dvt_acc_stop(DeviceID_t deviceID, uint8_t* dataBuffer, uint8_t* dataSize) { *dataSize = 0; return STATUS_SUCCESS; }
+_Float64 app_mode_impedance_test_get(void) { return 0.0; }
+uint8_t app_mode_impedance_test_survey(uint16_t* p_imp_matrix) { return 0; }
+void app_mode_impedance_test_survey_abort(void) { }
+bool app_mode_impedance_test_survey_step(uint16_t* p_imp_matrix, uint8_t* p_pair_num, uint8_t* p_progress) { return false; }
+bool app_mode_therapy_confirm(void) { return true; }
+bool app_mode_therapy_start(void) { return true; }
+void app_mode_therapy_stop(void) { }
+bool bsp_adc_sampling_is_completed(void) { return false; }
+bool bsp_sp_cmd_handler(void) { return true; }
+bool bsp_sp_cmd_is_pending(void) { return false; }
+bool bsp_sp_cmd_is_requested(void) { return false; }
+void bsp_sp_cmd_send(const uint8_t* data, uint8_t data_len) { }
+void bsp_wdg_refresh(void) { }
+
+void bsp_fram_write(uint32_t addr, const uint8_t* p_data, uint16_t data_len, bool waitfor_cplt) {
+	(void)memcpy(&fram[addr], p_data, data_len);
+	mcu_us += SIM_HAL_CALL_US + ((4.0 + (double)data_len) * SIM_NS_PER_BYTE / 1000.0);
+}
+
+void bsp_fram_read(uint32_t addr, uint8_t* p_data, uint16_t data_len) {
+	(void)memcpy(p_data, &fram[addr], data_len);
+	mcu_us += SIM_HAL_CALL_US + ((4.0 + (double)data_len) * SIM_NS_PER_BYTE / 1000.0);
+}
+
+/* ---- The link ---- */
+
+/**
+ * @brief The first connection event at or after this time
+ *
+ */
+static double event_next(double time_us) {
+	return ceil(time_us / ci_us) * ci_us;
+}
+
+/**
+ * @brief One round trip of a request over the link, served by the parser of the BLE connection mode
+ *
+ * @return uint8_t The length of the response payload, 0 if the response is not a success
+ */
+static uint8_t request(uint8_t opcode, uint8_t* p_payload, uint8_t len, uint8_t* p_resp_payload) {
+	Cmd_Req_t req = {
+			.Opcode = opcode,
+			.Payload = p_payload,
+			.PayloadLen = len,
+	};
+	Cmd_Resp_t resp = {
+			.Opcode = opcode,
+			.Status = STATUS_SUCCESS,
+			.Payload = p_resp_payload,
+			.PayloadLen = 0,
+	};
+	double event_req = event_next(now_us + SIM_LATENCY_US);
+	mcu_us = SIM_HAL_CALL_US + ((double)(LEN_REQ_HEADER + len + LEN_CRC) * SIM_NS_PER_BYTE / 1000.0) + SIM_PARSE_US;
+	app_mode_ble_conn_cmd_parser(&req, &resp);
+	mcu_us += SIM_HAL_CALL_US + ((double)(LEN_RESP_HEADER + resp.PayloadLen + LEN_CRC) * SIM_NS_PER_BYTE / 1000.0);
+	//The response goes at the next connection event after it is written to the nRF52810
+	double event_resp = event_next(event_req + mcu_us);
+	if (event_resp <= event_req) {
+		event_resp = event_req + ci_us;
+	}
+	now_us = event_resp + SIM_LATENCY_US;
+	mcu_total_us += mcu_us;
+	round_trips++;
+
+	if (resp.Status != STATUS_SUCCESS) {
+		(void)printf("FAIL opcode 0x%02X with %u bytes: status 0x%02X\n", opcode, len, resp.Status);
+		failures++;
+		return 0;
+	}
+	return resp.PayloadLen;
+}
+
+/* ---- The host ---- */
+
+/**
+ * @brief New data for every stimulation parameter, a step away from the data of the profile where the range allows
+ *
+ */
+static void profile_data_new(uint8_t seed) {
+	for (uint8_t p = 0; p < para_num; p++) {
+		const uint8_t* p_id = para_ids[p];
+		if (app_func_para_datatype_get(p_id) == FORMAT_TYPE_VALUE) {
+			_Float64 val = 0.0;
+			app_func_para_profile_data_get(THERAPY_PROFILE_ACTIVE, p_id, (uint8_t*)&val, (uint8_t)sizeof(val));
+			_Float64 stepsize = app_func_para_stepsize_get(p_id);
+			uint16_t steps = (uint16_t)((val / stepsize) + 0.5);
+			if (app_func_para_val_in_range(p_id, (_Float64)(steps + 1U) * stepsize)) {
+				steps++;
+			}
+			else if (app_func_para_val_in_range(p_id, (_Float64)(steps - 1U) * stepsize)) {
+				steps--;
+			}
+			else {
+				//The range has a single value, the same data is written again
+			}
+			(void)memcpy(para_data[p], (uint8_t*)&steps, LEN_STEP);
+			para_len[p] = (uint8_t)LEN_STEP;
+		}
+		else {
+			para_len[p] = app_func_para_datalen_get(p_id);
+			for (uint8_t i = 0; i < para_len[p]; i++) {
+				para_data[p][i] = (uint8_t)(seed + (p * 7U) + i);
+			}
+		}
+	}
+}
+
+/**
+ * @brief The data read back must be the data written, in the same format
+ *
+ * @return uint8_t The length of the ID and data checked
+ */
+static uint8_t readback_check(const Load_Case_t* p_case, uint8_t p, const uint8_t* p_resp) {
+	if ((memcmp(p_resp, para_ids[p], LEN_ID) != 0) || (memcmp(&p_resp[LEN_ID], para_data[p], para_len[p]) != 0)) {
+		(void)printf("FAIL %s: %.4s read back differs from the data written\n", p_case->Name, (const char*)para_ids[p]);
+		failures++;
+	}
+	return (uint8_t)(LEN_ID + para_len[p]);
+}
+
+static void profile_load_single(const Load_Case_t* p_case) {
+	uint8_t payload[LEN_REQ_PAYLOAD_MAX];
+	uint8_t resp[LEN_RESP_PAYLOAD_MAX];
+	for (uint8_t p = 0; p < para_num; p++) {
+		(void)memcpy(payload, para_ids[p], LEN_ID);
+		(void)memcpy(&payload[LEN_ID], para_data[p], para_len[p]);
+		(void)request(p_case->OpWrite, payload, (uint8_t)(LEN_ID + para_len[p]), resp);
+	}
+	for (uint8_t p = 0; p < para_num; p++) {
+		(void)memcpy(payload, para_ids[p], LEN_ID);
+		if (request(p_case->OpRead, payload, LEN_ID, resp) > 0U) {
+			(void)readback_check(p_case, p, resp);
+		}
+	}
+}
+
+static void profile_load_batch(const Load_Case_t* p_case) {
+	uint8_t payload[LEN_REQ_PAYLOAD_MAX];
+	uint8_t resp[LEN_RESP_PAYLOAD_MAX];
+	uint8_t p = 0;
+	while (p < para_num) {
+		uint8_t len = 0;
+		uint8_t num = 0;
+		while ((p < para_num) && (num < PARA_BATCH_NUM_MAX) && ((len + LEN_ID + para_len[p]) <= LEN_REQ_PAYLOAD_MAX)) {
+			(void)memcpy(&payload[len], para_ids[p], LEN_ID);
+			(void)memcpy(&payload[len + LEN_ID], para_data[p], para_len[p]);
+			len += (uint8_t)(LEN_ID + para_len[p]);
+			num++;
+			p++;
+		}
+		(void)request(p_case->OpWrite, payload, len, resp);
+	}
+
+	//A read batch is cut where its response would not fit into one frame
+	p = 0;
+	while (p < para_num) {
+		uint8_t first = p;
+		uint8_t len = 0;
+		uint16_t len_resp = 0;
+		while ((p < para_num) && ((len + LEN_ID) <= LEN_REQ_PAYLOAD_MAX) && ((len_resp + LEN_ID + para_len[p]) <= LEN_RESP_PAYLOAD_MAX)) {
+			(void)memcpy(&payload[len], para_ids[p], LEN_ID);
+			len += LEN_ID;
+			len_resp += (uint16_t)(LEN_ID + para_len[p]);
+			p++;
+		}
+		if (request(p_case->OpRead, payload, len, resp) > 0U) {
+			uint8_t offset = 0;
+			for (uint8_t i = first; i < p; i++) {
+				offset += readback_check(p_case, i, &resp[offset]);
+			}
+		}
+	}
+}
+
+int main(void) {
+	const Load_Case_t cases[] = {
+		{"one per command", OP_WRITE_STIMULATION_PARAMETERS, OP_READ_STIMULATION_PARAMETERS, false},
+		{"batches", OP_WRITE_PARAMETERS_BATCH, OP_READ_PARAMETERS_BATCH, true},
+	};
+	const double intervals_ms[] = {7.5, 15.0, 30.0};
+
+	(void)memset(fram, 0xFF, sizeof(fram));
+	app_func_para_init();
+	app_mode_ble_conn_init();
+
+	uint16_t profile_bytes = 0;
+	for (uint16_t i = 0; i < parameters_list_size; i++) {
+		if (app_func_para_profile_contains(parameters_list[i].id) && (para_num < SIM_PARA_NUM_MAX)) {
+			para_ids[para_num++] = parameters_list[i].id;
+		}
+	}
+
+	(void)printf("sim_para_batch_link: %u stimulation parameters written and read back, host latency %.1f ms each way\n",
+			para_num, SIM_LATENCY_US / 1000.0);
+	(void)printf("  %-8s %-16s %12s %10s %10s %10s\n", "CI", "Load", "round trips", "wall time", "per para", "MCU time");
+	uint8_t seed = 0;
+	for (uint32_t c = 0; c < (sizeof(intervals_ms) / sizeof(intervals_ms[0])); c++) {
+		ci_us = intervals_ms[c] * 1000.0;
+		for (uint32_t l = 0; l < (sizeof(cases) / sizeof(cases[0])); l++) {
+			profile_data_new(seed++);
+			now_us = 0.0;
+			round_trips = 0;
+			mcu_total_us = 0.0;
+			if (cases[l].Batch) {
+				profile_load_batch(&cases[l]);
+			}
+			else {
+				profile_load_single(&cases[l]);
+			}
+			(void)printf("  %5.1f ms %-16s %12lu %7.1f ms %7.2f ms %7.2f ms\n", intervals_ms[c], cases[l].Name,
+					(unsigned long)round_trips, now_us / 1000.0, now_us / 1000.0 / (double)para_num, mcu_total_us / 1000.0);
+		}
+	}
+	for (uint8_t p = 0; p < para_num; p++) {
+		profile_bytes += (uint16_t)(LEN_ID + para_len[p]);
+	}
+	(void)printf("  %u bytes of IDs and data, %u bytes of payload per frame\n", profile_bytes, (unsigned)LEN_REQ_PAYLOAD_MAX);
+
+	(void)printf("sim_para_batch_link: %lu failures\n", (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
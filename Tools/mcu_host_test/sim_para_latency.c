@@ -0,0 +1,424 @@
+/**
+ * @file sim_para_latency.c
+ * @brief Simulation of the read, write and boot latency of the parameters, against the real app_func_parameter.c
+ *
+ * The same workload of random single-parameter writes and reads runs on three stores:
+ * - the EEPROM emulation of earlier firmware with the page erase in the write that triggers the page transfer,
+ * - the same with the erase deferred to the idle loop, as app_func_para_cleanup_process did,
+ * - the parameter image in FRAM of app_func_parameter.c, with both copies written on every set.
+ * The EEPROM emulation is a model of the middleware in Middlewares/EEPROM_Emul with the configuration of the
+ * firmware: 8 KB pages of 16 B elements, NB_OF_VARIABLES variables and 2 guard pages, one element per 8 bytes of
+ * parameter data. It follows WriteVariable, FindPage, PagesTransfer (which reads every virtual address up to
+ * NB_OF_VARIABLES) and EE_CleanUp, and times the flash reads, programs and erases with the figures below, which
+ * are assumptions to be replaced by the ones measured on the board.
+ * The FRAM store is the real code on a model of the CY15B108QN at 5 MHz SPI, every write waited for.
+ * The boot is EE_Init with the scan of every variable, against app_func_para_init with a valid image.
+ * The simulation fails if a value read back is not the last one written, from either store and after a reboot.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "app_config.h"
+
+#define SIM_WRITES				20000U		/*!< Random single-parameter writes, each followed by a random read */
+#define SIM_SPI_BYTE_US			1.6			/*!< One byte at 5 MHz SPI */
+#define SIM_FRAM_STAGE_US		1.0			/*!< The interrupt and chip select of each SPI stage of a queued write */
+#define SIM_CRC_BYTE_US			0.025		/*!< One byte through HAL_CRC_Calculate, 4 cycles at 160 MHz */
+#define SIM_RAM_READ_US			1.0			/*!< A binary search of the parameter list and a copy from RAM */
+
+#define SIM_FLASH_READ_US		0.05		/*!< Reading one 16 B element through the ICACHE */
+#define SIM_FLASH_CRC_US		0.5			/*!< The CRC check of an element found */
+#define SIM_FLASH_PROG_US		118.0		/*!< Programming one quad-word, assumed */
+#define SIM_FLASH_ERASE_US		1500.0		/*!< Erasing one 8 KB page, assumed */
+#define SIM_ICACHE_INV_US		10.0		/*!< HAL_ICACHE_Invalidate and the refill of the cache */
+
+#define EE_PAGE_ELEMENTS		((8192U / 16U) - 4U)	/*!< NB_MAX_ELEMENTS_BY_PAGE, the page header takes 4 elements */
+#define EE_VARIABLES			1000U		/*!< NB_OF_VARIABLES of eeprom_emul_conf.h */
+#define EE_PAGES				((((EE_VARIABLES + EE_PAGE_ELEMENTS - 1U) / EE_PAGE_ELEMENTS) * 2U) + 2U)	/*!< PAGES_NUMBER */
+#define EE_MAX_WRITTEN			((EE_PAGE_ELEMENTS * EE_PAGES) / 2U)	/*!< NB_MAX_WRITTEN_ELEMENTS */
+#define EE_BYTE_PER_ADDRESS		8U
+
+typedef enum {
+	SIM_PAGE_ERASED = 0,
+	SIM_PAGE_RECEIVE,
+	SIM_PAGE_ACTIVE,
+	SIM_PAGE_VALID,
+	SIM_PAGE_ERASING
+} Sim_Page_State_t;
+
+typedef struct {
+	uint16_t	VirtAddress;
+	uint32_t	Version;			/*!< Stands for the data, the last version written must be read back */
+} Sim_Element_t;
+
+typedef struct {
+	const char*	Name;
+	bool		DeferCleanup;
+} Sim_Ee_Case_t;
+
+extern Parameter_t parameters_list[];
+extern const uint16_t parameters_list_size;
+
+static uint8_t fram[2U * SIZE_PARA];
+static double fram_us = 0.0;
+static uint32_t fram_write_num = 0;
+static uint32_t fram_write_bytes = 0;
+
+static Sim_Page_State_t ee_state[EE_PAGES];
+static Sim_Element_t ee_elements[EE_PAGES][EE_PAGE_ELEMENTS];
+static uint32_t ee_cur = 0;
+static uint32_t ee_next = 0;
+static uint32_t ee_written = 0;
+static bool ee_cleanup_pending = false;
+static double ee_us = 0.0;
+static uint32_t ee_version[EE_VARIABLES + 1U];
+static uint32_t ee_forced_cleanups = 0;
+
+static uint16_t para_virt_addr[256];
+static uint8_t para_elements[256];
+static uint16_t para_elements_num = 0;
+
+static uint32_t rng_state = 1;
+static uint32_t failures = 0;
+
+static uint32_t rng_next(uint32_t range) {
+	rng_state = (rng_state * 1103515245UL) + 12345UL;
+	return (rng_state >> 8) % range;
+}
+
+static int sim_cmp(const void* p_a, const void* p_b) {
+	double a = *(const double*)p_a;
+	double b = *(const double*)p_b;
+	return (a > b) - (a < b);
+}
+
+/**
+ * @brief Sort the latencies and print p50, p99 and max
+ *
+ */
+static void sim_print_lat(double* p_lat, uint32_t num) {
+	qsort(p_lat, num, sizeof(double), &sim_cmp);
+	(void)printf(" %9.1f %9.1f %9.1f", p_lat[num / 2U], p_lat[(num * 99U) / 100U], p_lat[num - 1U]);
+}
+
+void bsp_fram_write(uint32_t addr, const uint8_t* p_data, uint16_t data_len, bool waitfor_cplt) {
+	if ((addr < ADDR_PARA_BASE) || ((addr + data_len) > (ADDR_PARA_BASE + sizeof(fram)))) {
+		(void)printf("FAIL bsp_fram_write: 0x%05lX + %u is out of the parameters\n", (unsigned long)addr, data_len);
+		failures++;
+		return;
+	}
+	(void)memcpy(&fram[addr - ADDR_PARA_BASE], p_data, data_len);
+	//WREN, then the header and the data, every write of the parameters is waited for
+	fram_us += (3.0 * SIM_FRAM_STAGE_US) + ((1.0 + 4.0 + (double)data_len) * SIM_SPI_BYTE_US);
+	fram_write_num++;
+	fram_write_bytes += data_len;
+}
+
+void bsp_fram_read(uint32_t addr, uint8_t* p_data, uint16_t data_len) {
+	if ((addr < ADDR_PARA_BASE) || ((addr + data_len) > (ADDR_PARA_BASE + sizeof(fram)))) {
+		(void)memset(p_data, 0, data_len);
+		return;
+	}
+	(void)memcpy(p_data, &fram[addr - ADDR_PARA_BASE], data_len);
+	fram_us += SIM_FRAM_STAGE_US + ((4.0 + (double)data_len) * SIM_SPI_BYTE_US);
+}
+
+static void ee_state_set(uint32_t page, Sim_Page_State_t state) {
+	ee_state[page] = state;
+	ee_us += SIM_FLASH_PROG_US;
+}
+
+/**
+ * @brief EE_CleanUp, the half of the pages in erasing state is erased
+ *
+ */
+static void ee_cleanup(void) {
+	for (uint32_t first = 0; first < EE_PAGES; first += (EE_PAGES / 2U)) {
+		if (ee_state[first] == SIM_PAGE_ERASING) {
+			for (uint32_t page = first; page < (first + (EE_PAGES / 2U)); page++) {
+				ee_state[page] = SIM_PAGE_ERASED;
+				ee_us += SIM_FLASH_ERASE_US;
+			}
+		}
+	}
+	ee_cleanup_pending = false;
+}
+
+/**
+ * @brief FindPage(FIND_WRITE_PAGE), the next page is taken when the current one is full
+ *
+ */
+static void ee_write_page_find(void) {
+	if (ee_next < EE_PAGE_ELEMENTS) {
+		return;
+	}
+	uint32_t following = (ee_cur + 1U) % EE_PAGES;
+	if (ee_state[following] == SIM_PAGE_ERASING) {
+		ee_forced_cleanups++;
+		ee_cleanup();
+	}
+	Sim_Page_State_t state = ee_state[ee_cur];
+	ee_state_set(ee_cur, SIM_PAGE_VALID);
+	ee_state_set(following, state);
+	ee_cur = following;
+	ee_next = 0;
+}
+
+/**
+ * @brief VerifyPagesFullWriteVariable
+ *
+ * @return false The pages are full, a page transfer is needed
+ */
+static bool ee_element_write(uint16_t virt_addr, uint32_t version, bool transfer) {
+	if (!transfer && (ee_written >= EE_MAX_WRITTEN)) {
+		return false;
+	}
+	ee_write_page_find();
+	ee_elements[ee_cur][ee_next] = (Sim_Element_t){virt_addr, version};
+	ee_next++;
+	ee_written++;
+	ee_us += SIM_FLASH_PROG_US;
+	return true;
+}
+
+/**
+ * @brief ReadVariable, every element of the active, valid and erasing pages is read from the last one back
+ *
+ * @return true The variable is found, its version is returned
+ */
+static bool ee_element_read(uint16_t virt_addr, uint32_t* p_version) {
+	uint32_t page = (ee_state[ee_cur] == SIM_PAGE_RECEIVE) ? ((ee_cur + EE_PAGES - 1U) % EE_PAGES) : ee_cur;
+	for (uint32_t n = 0; n < EE_PAGES; n++) {
+		if ((ee_state[page] != SIM_PAGE_ACTIVE) && (ee_state[page] != SIM_PAGE_VALID) && (ee_state[page] != SIM_PAGE_ERASING)) {
+			break;
+		}
+		uint32_t used = (page == ee_cur) ? ee_next : EE_PAGE_ELEMENTS;
+		for (uint32_t i = EE_PAGE_ELEMENTS; i > 0U; i--) {
+			ee_us += SIM_FLASH_READ_US;
+			if (((i - 1U) < used) && (ee_elements[page][i - 1U].VirtAddress == virt_addr)) {
+				ee_us += SIM_FLASH_CRC_US;
+				*p_version = ee_elements[page][i - 1U].Version;
+				return true;
+			}
+		}
+		page = (page + EE_PAGES - 1U) % EE_PAGES;
+	}
+	return false;
+}
+
+/**
+ * @brief PagesTransfer, the variable is written to the next page and every other variable is copied behind it
+ *
+ */
+static void ee_transfer(uint16_t virt_addr, uint32_t version) {
+	uint32_t page = (ee_cur + 1U) % EE_PAGES;
+	if (ee_state[page] != SIM_PAGE_ERASED) {
+		(void)printf("FAIL EEPROM: no erased page for the transfer\n");
+		failures++;
+		return;
+	}
+	ee_written = 0;
+	ee_cur = page;
+	ee_next = 0;
+	ee_state_set(page, SIM_PAGE_RECEIVE);
+	page = (page + EE_PAGES - 1U) % EE_PAGES;
+	while ((ee_state[page] == SIM_PAGE_ACTIVE) || (ee_state[page] == SIM_PAGE_VALID)) {
+		ee_state_set(page, SIM_PAGE_ERASING);
+		page = (page + EE_PAGES - 1U) % EE_PAGES;
+	}
+
+	(void)ee_element_write(virt_addr, version, true);
+	for (uint16_t v = 1U; v <= EE_VARIABLES; v++) {
+		uint32_t version_old = 0;
+		if ((v != virt_addr) && ee_element_read(v, &version_old)) {
+			(void)ee_element_write(v, version_old, true);
+		}
+	}
+	ee_state_set(ee_cur, SIM_PAGE_ACTIVE);
+	ee_cleanup_pending = true;
+}
+
+/**
+ * @brief Write the data of a parameter, one element per 8 bytes, as app_func_para_write did
+ *
+ */
+static void ee_para_write(uint16_t index, bool defer_cleanup) {
+	for (uint8_t e = 0; e < para_elements[index]; e++) {
+		uint16_t virt_addr = para_virt_addr[index] + e;
+		ee_version[virt_addr]++;
+		if (!ee_element_write(virt_addr, ee_version[virt_addr], false)) {
+			ee_transfer(virt_addr, ee_version[virt_addr]);
+			if (!defer_cleanup) {
+				ee_cleanup();
+			}
+		}
+	}
+	ee_us += SIM_ICACHE_INV_US;
+}
+
+static void ee_para_read(uint16_t index) {
+	for (uint8_t e = 0; e < para_elements[index]; e++) {
+		uint16_t virt_addr = para_virt_addr[index] + e;
+		uint32_t version = 0;
+		if (!ee_element_read(virt_addr, &version) || (version != ee_version[virt_addr])) {
+			(void)printf("FAIL EEPROM: virtual address %u read version %lu, written %lu\n", virt_addr,
+					(unsigned long)version, (unsigned long)ee_version[virt_addr]);
+			failures++;
+		}
+	}
+}
+
+/**
+ * @brief EE_Format, then the default data of every parameter is written as the first boot of earlier firmware did
+ *
+ */
+static void ee_format(void) {
+	(void)memset(ee_state, 0, sizeof(ee_state));
+	(void)memset(ee_version, 0, sizeof(ee_version));
+	ee_state[0] = SIM_PAGE_ACTIVE;
+	ee_cur = 0;
+	ee_next = 0;
+	ee_written = 0;
+	ee_cleanup_pending = false;
+	ee_forced_cleanups = 0;
+	for (uint16_t i = 0; i < parameters_list_size; i++) {
+		ee_para_write(i, false);
+	}
+}
+
+/**
+ * @brief EE_Init reads every page, then every virtual address is read until one is not found, as the init did
+ *
+ */
+static double ee_boot(void) {
+	ee_us = 0.0;
+	ee_us += (double)(EE_PAGES * (EE_PAGE_ELEMENTS + 4U)) * SIM_FLASH_READ_US;
+	if (ee_cleanup_pending) {
+		ee_cleanup();
+	}
+	for (uint16_t v = 1U; v <= (para_elements_num + 1U); v++) {
+		uint32_t version = 0;
+		(void)ee_element_read(v, &version);
+	}
+	return ee_us;
+}
+
+static void sim_para_data_random(uint8_t* p_data, uint8_t datalen) {
+	for (uint8_t i = 0; i < datalen; i++) {
+		p_data[i] = (uint8_t)rng_next(256U);
+	}
+}
+
+int main(void) {
+	static double wr_lat[SIM_WRITES];
+	static double rd_lat[SIM_WRITES];
+	static uint8_t shadow[256][UINT8_MAX];
+	const Sim_Ee_Case_t ee_cases[] = {
+		{"EEPROM, erase in the write", false},
+		{"EEPROM, erase at idle", true},
+	};
+
+	uint16_t virt_addr = 1U;
+	for (uint16_t i = 0; i < parameters_list_size; i++) {
+		uint8_t datalen = app_func_para_datalen_get(parameters_list[i].id);
+		para_virt_addr[i] = virt_addr;
+		para_elements[i] = (uint8_t)((datalen + EE_BYTE_PER_ADDRESS - 1U) / EE_BYTE_PER_ADDRESS);
+		virt_addr += para_elements[i];
+	}
+	para_elements_num = virt_addr - 1U;
+
+	(void)printf("sim_para_latency: %u parameters in %u EEPROM variables, %u writes and reads, latency in us\n",
+			parameters_list_size, para_elements_num, SIM_WRITES);
+	(void)printf("  %-28s %9s %9s %9s %9s %9s %9s %9s\n", "Store", "wr p50", "wr p99", "wr max", "rd p50", "rd p99",
+			"rd max", "boot");
+
+	for (uint32_t c = 0; c < (sizeof(ee_cases) / sizeof(ee_cases[0])); c++) {
+		rng_state = 1;
+		ee_format();
+		for (uint32_t n = 0; n < SIM_WRITES; n++) {
+			uint16_t index = (uint16_t)rng_next(parameters_list_size);
+			ee_us = 0.0;
+			ee_para_write(index, ee_cases[c].DeferCleanup);
+			wr_lat[n] = ee_us;
+			//The idle loop runs between the commands
+			if (ee_cases[c].DeferCleanup && ee_cleanup_pending) {
+				ee_cleanup();
+			}
+			index = (uint16_t)rng_next(parameters_list_size);
+			ee_us = 0.0;
+			ee_para_read(index);
+			rd_lat[n] = ee_us;
+		}
+		(void)printf("  %-28s", ee_cases[c].Name);
+		sim_print_lat(wr_lat, SIM_WRITES);
+		sim_print_lat(rd_lat, SIM_WRITES);
+		(void)printf(" %9.1f\n", ee_boot());
+		if (ee_forced_cleanups > 0U) {
+			(void)printf("    %lu erases forced by a full page\n", (unsigned long)ee_forced_cleanups);
+		}
+	}
+
+	//FRAM: the first boot writes the defaults, the workload then runs on the RAM image
+	rng_state = 1;
+	(void)memset(fram, 0xFF, sizeof(fram));
+	app_func_para_init();
+	double crc_us_sum = 0.0;
+	double fram_us_sum = 0.0;
+	uint32_t fram_write_num_start = fram_write_num;
+	uint32_t fram_write_bytes_start = fram_write_bytes;
+	for (uint32_t n = 0; n < SIM_WRITES; n++) {
+		uint16_t index = (uint16_t)rng_next(parameters_list_size);
+		uint8_t datalen = app_func_para_datalen_get(parameters_list[index].id);
+		sim_para_data_random(shadow[index], datalen);
+		//The FW version is set again by app_func_para_init, it is left as it is
+		if (memcmp(parameters_list[index].id, HPID_IPG_FW_VERSION, LEN_ID) == 0) {
+			app_func_para_data_get(parameters_list[index].id, shadow[index], datalen);
+		}
+		fram_us = 0.0;
+		hal_stub_crc_bytes = 0;
+		app_func_para_data_set(parameters_list[index].id, shadow[index]);
+		double crc_us = (double)hal_stub_crc_bytes * SIM_CRC_BYTE_US;
+		wr_lat[n] = fram_us + crc_us;
+		crc_us_sum += crc_us;
+		fram_us_sum += fram_us;
+
+		index = (uint16_t)rng_next(parameters_list_size);
+		uint8_t data[UINT8_MAX];
+		fram_us = 0.0;
+		app_func_para_data_get(parameters_list[index].id, data, (uint8_t)sizeof(data));
+		rd_lat[n] = fram_us + SIM_RAM_READ_US;
+	}
+	uint32_t set_writes = fram_write_num - fram_write_num_start;
+	uint32_t set_bytes = fram_write_bytes - fram_write_bytes_start;
+
+	fram_us = 0.0;
+	hal_stub_crc_bytes = 0;
+	app_func_para_init();
+	double boot_us = fram_us + ((double)hal_stub_crc_bytes * SIM_CRC_BYTE_US);
+	(void)printf("  %-28s", "FRAM image, both copies");
+	sim_print_lat(wr_lat, SIM_WRITES);
+	sim_print_lat(rd_lat, SIM_WRITES);
+	(void)printf(" %9.1f\n", boot_us);
+
+	//Every value written must be read back after the reboot
+	for (uint16_t i = 0; i < parameters_list_size; i++) {
+		uint8_t datalen = app_func_para_datalen_get(parameters_list[i].id);
+		uint8_t data[UINT8_MAX];
+		bool written = false;
+		for (uint8_t b = 0; b < datalen; b++) {
+			written = written || (shadow[i][b] != 0U);
+		}
+		app_func_para_data_get(parameters_list[i].id, data, (uint8_t)sizeof(data));
+		if (written && (memcmp(data, shadow[i], datalen) != 0)) {
+			(void)printf("FAIL FRAM: parameter %.4s differs after the reboot\n", (const char*)parameters_list[i].id);
+			failures++;
+		}
+	}
+
+	(void)printf("  FRAM set: %.1f waited writes, %.1f B, %.1f us SPI and %.1f us CRC of the %u B image on average\n",
+			(double)set_writes / SIM_WRITES, (double)set_bytes / SIM_WRITES, fram_us_sum / SIM_WRITES,
+			crc_us_sum / SIM_WRITES, (unsigned)(sizeof(Parameter_Image_Header_t) + LEN_PARA_DATA_MAX));
+
+	(void)printf("sim_para_latency: %lu failures\n", (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file app_config.h
+ * @brief Host stand-in for the application configuration, it includes the same project headers as the firmware
+ * @copyright Copyright (c) 2024
+ */
+#ifndef MCU_HOST_TEST_APP_CONFIG_H_
+#define MCU_HOST_TEST_APP_CONFIG_H_
+
+#include "bsp_config.h"
+
+#include "app_func_authentication.h"
+#include "app_func_ble.h"
+#include "app_func_command.h"
+#include "app_func_job.h"
+#include "app_func_logs.h"
+#include "app_func_measurement.h"
+#include "app_func_parameter.h"
+#include "app_func_state_machine.h"
+#include "app_func_stimulation.h"
+
+#include "app_mode_battery_test.h"
+#include "app_mode_ble_active.h"
+#include "app_mode_ble_connection.h"
+#include "app_mode_bsl.h"
+#include "app_mode_impedance_test.h"
+#include "app_mode_oad.h"
+#include "app_mode_therapy_session.h"
+#include "app_mode_dvt.h"
+#include "app_mode_wpt.h"
+#include "app_state.h"
+#include "app.h"
+
+#include "eeprom_emul.h"
+#include "ecc_publickey.h"
+#include "prime256v1.h"
+
+#define APP_FW_VER_STR					{'2','6','0','1','0','1'}
+#define	DEFAULT_STATE					STATE_ACT_MODE_BLE_ACT
+
+#endif /* MCU_HOST_TEST_APP_CONFIG_H_ */
@@ -0,0 +1,222 @@
+/**
+ * @file bsp_config.h
+ * @brief Host stand-in for the BSP configuration, with the HAL reduced to what the tested sources use
+ * @copyright Copyright (c) 2024
+ */
+#ifndef MCU_HOST_TEST_BSP_CONFIG_H_
+#define MCU_HOST_TEST_BSP_CONFIG_H_
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "bsp_adc.h"
+#include "bsp_fram.h"
+#include "bsp_magnet.h"
+#include "bsp_serialport.h"
+#include "bsp_watchdog.h"
+
+#include "CY15B108QN_driver.h"
+#include "DAC8050x_driver.h"
+#include "LT1615_driver.h"
+#include "ISL23315T_driver.h"
+#include "MIS2DHTR_driver.h"
+
+#define HW_VERSION						21
+
+typedef enum {
+	HAL_OK			= 0x00U,
+	HAL_ERROR		= 0x01U,
+	HAL_BUSY		= 0x02U,
+	HAL_TIMEOUT		= 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum {
+	GPIO_PIN_RESET	= 0U,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef enum {
+	HAL_SPI_STATE_RESET		= 0x00U,
+	HAL_SPI_STATE_READY		= 0x01U,
+	HAL_SPI_STATE_BUSY		= 0x02U
+} HAL_SPI_StateTypeDef;
+
+typedef struct { uint32_t Instance; } SPI_HandleTypeDef;
+typedef struct { uint32_t Instance; } I2C_HandleTypeDef;
+typedef struct { uint32_t Instance; } UART_HandleTypeDef;
+typedef struct { uint32_t Instance; } RTC_HandleTypeDef;
+
+typedef struct {
+	uint32_t	DR;
+	uint32_t	INIT;
+} CRC_TypeDef;
+
+typedef struct {
+	uint32_t	InitValue;
+} CRC_InitTypeDef;
+
+typedef struct {
+	CRC_TypeDef*	Instance;
+	CRC_InitTypeDef	Init;
+} CRC_HandleTypeDef;
+
+typedef struct {
+	uint8_t		Hours;
+	uint8_t		Minutes;
+	uint8_t		Seconds;
+	uint32_t	SubSeconds;
+} RTC_TimeTypeDef;
+
+typedef struct {
+	uint8_t		WeekDay;
+	uint8_t		Month;
+	uint8_t		Date;
+	uint8_t		Year;
+} RTC_DateTypeDef;
+
+#define RTC_FORMAT_BIN					0U
+
+#define IS_RTC_YEAR(YEAR)				((YEAR) <= 99U)
+#define IS_RTC_MONTH(MONTH)				(((MONTH) >= 1U) && ((MONTH) <= 12U))
+#define IS_RTC_DATE(DATE)				(((DATE) >= 1U) && ((DATE) <= 31U))
+#define IS_RTC_HOUR24(HOUR)				((HOUR) <= 23U)
+#define IS_RTC_MINUTES(MINUTES)			((MINUTES) <= 59U)
+#define IS_RTC_SECONDS(SECONDS)			((SECONDS) <= 59U)
+
+#define RTC_BKP_DR1						1U
+#define RTC_BKP_DR2						2U
+#define RTC_WAKEUPCLOCK_CK_SPRE_16BITS	4U
+
+//No reset flag is set, the MCU always starts from a power-on reset
+#define RCC_FLAG_IWDGRST				1U
+#define RCC_FLAG_OBLRST					2U
+#define __HAL_RCC_GET_FLAG(FLAG)		(0U)
+#define __HAL_RCC_CLEAR_RESET_FLAGS()	((void)0)
+
+extern SPI_HandleTypeDef hspi1;
+extern I2C_HandleTypeDef hi2c2;
+extern I2C_HandleTypeDef hi2c3;
+extern UART_HandleTypeDef huart1;
+extern RTC_HandleTypeDef hrtc;
+extern CRC_HandleTypeDef hcrc;
+
+#define HANDLE_NRF52810_CY15B108QN_SPI	hspi1		/*!< SPI handle for nRF52810 and CY15B108QN */
+#define HANDLE_ISL23315T_DAC8050x_I2C	hi2c2		/*!< I2C handle for ISL23315T and DAC80502 */
+#define HANDLE_ACC_I2C					hi2c3		/*!< I2C handle for ACC Connector */
+#define HANDLE_DEBUG_UART				huart1		/*!< UART handle for debug */
+
+//The pins only need distinct numbers, the port is not used
+#define GPIO_PORT_STUB					0U
+#define BLE_RDY_GPIO_Port				GPIO_PORT_STUB
+#define BLE_RDY_Pin						1U
+#define BLE_REQ_GPIO_Port				GPIO_PORT_STUB
+#define BLE_REQ_Pin						2U
+#define SPI1_BLE_CSn_GPIO_Port			GPIO_PORT_STUB
+#define SPI1_BLE_CSn_Pin				3U
+#define SPI1_FRAM_CSn_GPIO_Port			GPIO_PORT_STUB
+#define SPI1_FRAM_CSn_Pin				4U
+#define FRAM_EN_GPIO_Port				GPIO_PORT_STUB
+#define FRAM_EN_Pin						5U
+#define ACC_EN_GPIO_Port				GPIO_PORT_STUB
+#define ACC_EN_Pin						6U
+#define CB_EN_GPIO_Port					GPIO_PORT_STUB
+#define CB_EN_Pin						7U
+#define VCHG_PGOOD_GPIO_Port			GPIO_PORT_STUB
+#define VCHG_PGOOD_Pin					8U
+
+//The ADC channels only need distinct numbers, the sampling is modelled by the tests
+#define ADC_CHANNEL_1					1U
+#define ADC_CHANNEL_2					2U
+#define ADC_CHANNEL_3					3U
+#define ADC_CHANNEL_5					5U
+#define ADC_CHANNEL_6					6U
+#define ADC_CHANNEL_7					7U
+#define ADC_CHANNEL_15					15U
+#define ADC_CHANNEL_16					16U
+#define ADC_CHANNEL_17					17U
+#define ADC_CHANNEL_22					22U
+#define ADC_CHANNEL_VBAT				0x100U
+
+#define	BSP_ISL23315T_DEVICE_ADDR		ISL23315T_DEVICE_ADDR_00		/*!< Device address of ISL23315T */
+#define	BSP_DAC80502_DEVICE_ADDR		DAC8050x_DEVICE_ADDR_AGND		/*!< Device address of DAC80502 */
+#define I2C_MEMADD_SIZE_8BIT			1U
+
+#define __weak							__attribute__((weak))
+#define __NOP()							((void)0)
+#define __disable_irq()					hal_stub_irq_disable()
+#define __get_PRIMASK()					hal_stub_primask_get()
+#define __set_PRIMASK(PRIMASK)			hal_stub_primask_set(PRIMASK)
+#define UNUSED(X)						((void)(X))
+
+//A write of CRC_INIT also loads CRC_DR, as on the CRC peripheral
+#define __HAL_CRC_DR_RESET(HANDLE)							((HANDLE)->Instance->DR = (HANDLE)->Instance->INIT)
+#define __HAL_CRC_INITIALCRCVALUE_CONFIG(HANDLE, INIT_VAL)	((HANDLE)->Instance->INIT = (INIT_VAL), (HANDLE)->Instance->DR = (INIT_VAL))
+
+void Error_Handler(void);
+
+//The interrupt mask, a test that models interrupts runs the pending ones when the mask is cleared
+void hal_stub_irq_disable(void);
+uint32_t hal_stub_primask_get(void);
+void hal_stub_primask_set(uint32_t primask);
+
+//The bytes given to the CRC peripheral, the cost of a CRC on the MCU
+extern uint64_t hal_stub_crc_bytes;
+
+GPIO_PinState HAL_GPIO_ReadPin(uint32_t port, uint16_t pin);
+void HAL_GPIO_WritePin(uint32_t port, uint16_t pin, GPIO_PinState state);
+void HAL_Delay(uint32_t delay);
+uint32_t HAL_GetTick(void);
+uint32_t HAL_RCC_GetSysClockFreq(void);
+void HAL_NVIC_SystemReset(void);
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, const uint8_t* p_data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef* hspi, uint8_t* p_data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_SPI_Transmit_IT(SPI_HandleTypeDef* hspi, const uint8_t* p_data, uint16_t size);
+HAL_StatusTypeDef HAL_SPI_Receive_IT(SPI_HandleTypeDef* hspi, uint8_t* p_data, uint16_t size);
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef* hspi);
+HAL_SPI_StateTypeDef HAL_SPI_GetState(const SPI_HandleTypeDef* hspi);
+HAL_StatusTypeDef HAL_SPI_Abort_IT(SPI_HandleTypeDef* hspi);
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi);
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef* hspi);
+void HAL_SPI_MspInit(SPI_HandleTypeDef* hspi);
+void HAL_SPI_MspDeInit(SPI_HandleTypeDef* hspi);
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef* hi2c, uint16_t dev_addr, uint16_t mem_addr, uint16_t mem_addr_size, uint8_t* p_data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef* hi2c, uint16_t dev_addr, uint16_t mem_addr, uint16_t mem_addr_size, uint8_t* p_data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef* hi2c, uint16_t dev_addr, uint16_t mem_addr, uint16_t mem_addr_size, uint8_t* p_data, uint16_t size);
+void HAL_I2C_MspInit(I2C_HandleTypeDef* hi2c);
+void HAL_I2C_MspDeInit(I2C_HandleTypeDef* hi2c);
+
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, const uint8_t* p_data, uint16_t size);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_IT(UART_HandleTypeDef* huart, uint8_t* p_data, uint16_t size);
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_Abort_IT(UART_HandleTypeDef* huart);
+void HAL_UART_MspInit(UART_HandleTypeDef* huart);
+void HAL_UART_MspDeInit(UART_HandleTypeDef* huart);
+
+HAL_StatusTypeDef HAL_RTC_GetTime(RTC_HandleTypeDef* hrtc, RTC_TimeTypeDef* p_time, uint32_t format);
+HAL_StatusTypeDef HAL_RTC_GetDate(RTC_HandleTypeDef* hrtc, RTC_DateTypeDef* p_date, uint32_t format);
+HAL_StatusTypeDef HAL_RTC_SetTime(RTC_HandleTypeDef* hrtc, RTC_TimeTypeDef* p_time, uint32_t format);
+HAL_StatusTypeDef HAL_RTC_SetDate(RTC_HandleTypeDef* hrtc, RTC_DateTypeDef* p_date, uint32_t format);
+uint32_t HAL_RTCEx_BKUPRead(RTC_HandleTypeDef* hrtc, uint32_t backup_register);
+void HAL_RTCEx_BKUPWrite(RTC_HandleTypeDef* hrtc, uint32_t backup_register, uint32_t data);
+HAL_StatusTypeDef HAL_RTCEx_SetWakeUpTimer_IT(RTC_HandleTypeDef* hrtc, uint32_t counter, uint32_t clock, uint32_t auto_clr);
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef* hcrc, uint32_t* p_buffer, uint32_t length);
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef* hcrc, uint32_t* p_buffer, uint32_t length);
+
+/**@brief Macro for calling error handler function if supplied error code any other than HAL_OK.
+ *
+ * @param[in] ERR_CODE Error code supplied to the error handler.
+ */
+#define HAL_ERROR_CHECK(ERR_CODE)                           \
+        if ((uint8_t)(ERR_CODE) != HAL_OK)                  \
+        {                                                   \
+            Error_Handler();              					\
+        }
+#endif /* MCU_HOST_TEST_BSP_CONFIG_H_ */
@@ -0,0 +1,17 @@
+/**
+ * @file eeprom_emul.h
+ * @brief Host stand-in for the EEPROM emulation of earlier firmware, with the types of the middleware
+ * @copyright Copyright (c) 2024
+ */
+#ifndef MCU_HOST_TEST_EEPROM_EMUL_H_
+#define MCU_HOST_TEST_EEPROM_EMUL_H_
+#include <stdint.h>
+#include "eeprom_emul_types.h"
+
+EE_Status EE_Format(EE_Erase_type EraseType);
+EE_Status EE_Init(EE_Erase_type EraseType);
+EE_Status EE_ReadVariable96bits(uint16_t VirtAddress, uint64_t* pData);
+EE_Status EE_WriteVariable96bits(uint16_t VirtAddress, uint64_t* Data);
+EE_Status EE_CleanUp(void);
+
+#endif /* MCU_HOST_TEST_EEPROM_EMUL_H_ */
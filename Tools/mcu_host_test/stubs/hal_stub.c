@@ -0,0 +1,309 @@
+/**
+ * @file hal_stub.c
+ * @brief Default host implementations of the HAL functions used by the tested sources.
+ * Every function is weak, so a test replaces the ones it models.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include "bsp_config.h"
+#include "eeprom_emul.h"
+
+SPI_HandleTypeDef hspi1;
+I2C_HandleTypeDef hi2c2;
+I2C_HandleTypeDef hi2c3;
+UART_HandleTypeDef huart1;
+RTC_HandleTypeDef hrtc;
+static CRC_TypeDef hal_crc_regs = {0xFFFFU, 0xFFFFU};
+CRC_HandleTypeDef hcrc = {&hal_crc_regs, {0xFFFFU}};
+
+static uint32_t hal_tick = 0;
+static uint32_t hal_primask = 0;
+uint64_t hal_stub_crc_bytes = 0;
+
+/**
+ * @brief Stop the test, the firmware would reset here
+ *
+ */
+__weak void Error_Handler(void) {
+	(void)fprintf(stderr, "Error_Handler called\n");
+	abort();
+}
+
+__weak void hal_stub_irq_disable(void) {
+	hal_primask = 1U;
+}
+
+__weak uint32_t hal_stub_primask_get(void) {
+	return hal_primask;
+}
+
+__weak void hal_stub_primask_set(uint32_t primask) {
+	hal_primask = primask;
+}
+
+__weak GPIO_PinState HAL_GPIO_ReadPin(uint32_t port, uint16_t pin) {
+	UNUSED(port);
+	UNUSED(pin);
+	return GPIO_PIN_RESET;
+}
+
+__weak void HAL_GPIO_WritePin(uint32_t port, uint16_t pin, GPIO_PinState state) {
+	UNUSED(port);
+	UNUSED(pin);
+	UNUSED(state);
+}
+
+__weak void HAL_Delay(uint32_t delay) {
+	hal_tick += delay;
+}
+
+__weak uint32_t HAL_GetTick(void) {
+	return hal_tick;
+}
+
+__weak uint32_t HAL_RCC_GetSysClockFreq(void) {
+	return 160000000UL;
+}
+
+/**
+ * @brief Stop the test, the firmware would reset here
+ *
+ */
+__weak void HAL_NVIC_SystemReset(void) {
+	(void)fprintf(stderr, "HAL_NVIC_SystemReset called\n");
+	abort();
+}
+
+__weak HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, const uint8_t* p_data, uint16_t size, uint32_t timeout) {
+	UNUSED(hspi);
+	UNUSED(p_data);
+	UNUSED(size);
+	UNUSED(timeout);
+	return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef* hspi, uint8_t* p_data, uint16_t size, uint32_t timeout) {
+	UNUSED(hspi);
+	UNUSED(timeout);
+	(void)memset(p_data, 0, size);
+	return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_SPI_Transmit_IT(SPI_HandleTypeDef* hspi, const uint8_t* p_data, uint16_t size) {
+	UNUSED(hspi);
+	UNUSED(p_data);
+	UNUSED(size);
+	return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_SPI_Receive_IT(SPI_HandleTypeDef* hspi, uint8_t* p_data, uint16_t size) {
+	UNUSED(hspi);
+	(void)memset(p_data, 0, size);
+	return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef* hspi) {
+	UNUSED(hspi);
+	return HAL_OK;
+}
+
+__weak HAL_SPI_StateTypeDef HAL_SPI_GetState(const SPI_HandleTypeDef* hspi) {
+	UNUSED(hspi);
+	return HAL_SPI_STATE_READY;
+}
+
+__weak HAL_StatusTypeDef HAL_SPI_Abort_IT(SPI_HandleTypeDef* hspi) {
+	UNUSED(hspi);
+	return HAL_OK;
+}
+
+__weak void HAL_SPI_MspInit(SPI_HandleTypeDef* hspi) {
+	UNUSED(hspi);
+}
+
+__weak void HAL_SPI_MspDeInit(SPI_HandleTypeDef* hspi) {
+	UNUSED(hspi);
+}
+
+__weak HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef* hi2c, uint16_t dev_addr, uint16_t mem_addr, uint16_t mem_addr_size, uint8_t* p_data, uint16_t size, uint32_t timeout) {
+	UNUSED(hi2c);
+	UNUSED(dev_addr);
+	UNUSED(mem_addr);
+	UNUSED(mem_addr_size);
+	UNUSED(p_data);
+	UNUSED(size);
+	UNUSED(timeout);
+	return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef* hi2c, uint16_t dev_addr, uint16_t mem_addr, uint16_t mem_addr_size, uint8_t* p_data, uint16_t size, uint32_t timeout) {
+	UNUSED(hi2c);
+	UNUSED(dev_addr);
+	UNUSED(mem_addr);
+	UNUSED(mem_addr_size);
+	UNUSED(timeout);
+	(void)memset(p_data, 0, size);
+	return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef* hi2c, uint16_t dev_addr, uint16_t mem_addr, uint16_t mem_addr_size, uint8_t* p_data, uint16_t size) {
+	UNUSED(hi2c);
+	UNUSED(dev_addr);
+	UNUSED(mem_addr);
+	UNUSED(mem_addr_size);
+	UNUSED(p_data);
+	UNUSED(size);
+	return HAL_OK;
+}
+
+__weak void HAL_I2C_MspInit(I2C_HandleTypeDef* hi2c) {
+	UNUSED(hi2c);
+}
+
+__weak void HAL_I2C_MspDeInit(I2C_HandleTypeDef* hi2c) {
+	UNUSED(hi2c);
+}
+
+__weak HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, const uint8_t* p_data, uint16_t size) {
+	UNUSED(huart);
+	UNUSED(p_data);
+	UNUSED(size);
+	return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_IT(UART_HandleTypeDef* huart, uint8_t* p_data, uint16_t size) {
+	UNUSED(huart);
+	UNUSED(p_data);
+	UNUSED(size);
+	return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef* huart) {
+	UNUSED(huart);
+	return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_UART_Abort_IT(UART_HandleTypeDef* huart) {
+	UNUSED(huart);
+	return HAL_OK;
+}
+
+__weak void HAL_UART_MspInit(UART_HandleTypeDef* huart) {
+	UNUSED(huart);
+}
+
+__weak void HAL_UART_MspDeInit(UART_HandleTypeDef* huart) {
+	UNUSED(huart);
+}
+
+__weak HAL_StatusTypeDef HAL_RTC_GetTime(RTC_HandleTypeDef* hrtc_, RTC_TimeTypeDef* p_time, uint32_t format) {
+	UNUSED(hrtc_);
+	UNUSED(format);
+	(void)memset(p_time, 0, sizeof(RTC_TimeTypeDef));
+	return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_RTC_GetDate(RTC_HandleTypeDef* hrtc_, RTC_DateTypeDef* p_date, uint32_t format) {
+	UNUSED(hrtc_);
+	UNUSED(format);
+	(void)memset(p_date, 0, sizeof(RTC_DateTypeDef));
+	return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_RTC_SetTime(RTC_HandleTypeDef* hrtc_, RTC_TimeTypeDef* p_time, uint32_t format) {
+	UNUSED(hrtc_);
+	UNUSED(p_time);
+	UNUSED(format);
+	return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_RTC_SetDate(RTC_HandleTypeDef* hrtc_, RTC_DateTypeDef* p_date, uint32_t format) {
+	UNUSED(hrtc_);
+	UNUSED(p_date);
+	UNUSED(format);
+	return HAL_OK;
+}
+
+static uint32_t hal_rtc_bkp[32];
+
+__weak uint32_t HAL_RTCEx_BKUPRead(RTC_HandleTypeDef* hrtc_, uint32_t backup_register) {
+	UNUSED(hrtc_);
+	return hal_rtc_bkp[backup_register % 32U];
+}
+
+__weak void HAL_RTCEx_BKUPWrite(RTC_HandleTypeDef* hrtc_, uint32_t backup_register, uint32_t data) {
+	UNUSED(hrtc_);
+	hal_rtc_bkp[backup_register % 32U] = data;
+}
+
+__weak HAL_StatusTypeDef HAL_RTCEx_SetWakeUpTimer_IT(RTC_HandleTypeDef* hrtc_, uint32_t counter, uint32_t clock, uint32_t auto_clr) {
+	UNUSED(hrtc_);
+	UNUSED(counter);
+	UNUSED(clock);
+	UNUSED(auto_clr);
+	return HAL_OK;
+}
+
+/**
+ * @brief CRC-16/CCITT over bytes, as the CRC peripheral is configured by the firmware
+ *
+ */
+static uint16_t hal_crc_update(uint16_t crc, const uint8_t* p_data, uint32_t length) {
+	for(uint32_t i=0;i<length;i++) {
+		crc ^= (uint16_t)((uint16_t)p_data[i] << 8);
+		for(uint8_t b=0;b<8U;b++) {
+			crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((uint16_t)(crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+__weak uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef* hcrc_, uint32_t* p_buffer, uint32_t length) {
+	hal_stub_crc_bytes += length;
+	hcrc_->Instance->DR = hal_crc_update((uint16_t)hcrc_->Instance->INIT, (const uint8_t*)p_buffer, length);
+	return hcrc_->Instance->DR;
+}
+
+__weak uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef* hcrc_, uint32_t* p_buffer, uint32_t length) {
+	hal_stub_crc_bytes += length;
+	hcrc_->Instance->DR = hal_crc_update((uint16_t)hcrc_->Instance->DR, (const uint8_t*)p_buffer, length);
+	return hcrc_->Instance->DR;
+}
+
+__weak HAL_StatusTypeDef HAL_FLASH_Unlock(void) {
+	return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_FLASH_Lock(void) {
+	return HAL_OK;
+}
+
+/**
+ * @brief The EEPROM emulation of earlier firmware is empty
+ *
+ */
+__weak EE_Status EE_Init(EE_Erase_type EraseType) {
+	UNUSED(EraseType);
+	return EE_OK;
+}
+
+__weak EE_Status EE_Format(EE_Erase_type EraseType) {
+	UNUSED(EraseType);
+	return EE_OK;
+}
+
+__weak EE_Status EE_ReadVariable96bits(uint16_t VirtAddress, uint64_t* pData) {
+	UNUSED(VirtAddress);
+	UNUSED(pData);
+	return EE_NO_DATA;
+}
+
+__weak EE_Status EE_WriteVariable96bits(uint16_t VirtAddress, uint64_t* Data) {
+	UNUSED(VirtAddress);
+	UNUSED(Data);
+	return EE_OK;
+}
+
+__weak EE_Status EE_CleanUp(void) {
+	return EE_OK;
+}
@@ -0,0 +1,350 @@
+/**
+ * @file test_ble_conn_dispatch.c
+ * @brief Table-driven test of the command tables of the BLE connection mode, against the real app_mode_ble_connection.c
+ *
+ * The expected opcodes, handlers, payload lengths and user classes are those of the switch the tables replaced,
+ * plus the job commands. Every request goes through the real parser, so the lookup, the length check, the user
+ * class check and the handler are all run. The functions the handlers call are faked to succeed.
+ * The switch checked the length of MEASURE_SENSOR_VOLTAGE and of the batch reads fully before the user class,
+ * the tables only check the range first, so those requests from a lower user class now get USER_CLASS_ERR.
+ * @copyright Copyright (c) 2024
+ */
+#include "app_mode_ble_connection.c"
+
+typedef void (*Case_Prepare)(uint8_t* p_payload);
+
+typedef struct {
+	uint8_t			Opcode;
+	Cmd_Req_Parser	Handler;		/*!< The handler expected in the table */
+	uint8_t			LenMin;
+	uint8_t			LenMax;
+	uint8_t			UserClass;
+	uint8_t			Len;			/*!< The length of a valid request */
+	const uint8_t*	Payload;		/*!< The payload of a valid request, NULL for zeros */
+	Case_Prepare	Prepare;		/*!< Completes the valid request at run time, NULL if not needed */
+} Dispatch_Case_t;
+
+bool vnsb_en = false;
+
+static uint8_t remote_user_class = USER_CLASS_INVALID;
+static uint32_t failures = 0;
+
+#define CHECK_EQ(EXPECTED, ACTUAL, ...)											\
+	do {																		\
+		if ((uint32_t)(EXPECTED) != (uint32_t)(ACTUAL)) {						\
+			(void)printf("FAIL %s:%d expected 0x%02lX, got 0x%02lX: ", __FILE__, __LINE__, \
+					(unsigned long)(EXPECTED), (unsigned long)(ACTUAL));		\
+			(void)printf(__VA_ARGS__);											\
+			(void)printf("\n");													\
+			failures++;															\
+		}																		\
+	} while(0)
+
+/* ---- Fakes of the functions called by the handlers, all of them succeed ---- */
+
+uint8_t app_mode_ble_act_userclass_get(void) { return remote_user_class; }
+bool app_func_auth_verify_sign_admin(ECDSA_Data_t ecdsa_data) { return true; }
+uint8_t app_func_ble_curr_state_get(void) { return BLE_STATE_INVALID; }
+void app_func_ble_disconnect(void) { }
+void app_func_ble_enable(bool enable) { }
+void app_func_ble_new_state_get(void) { }
+void app_func_logs_erase(void) { }
+void app_func_logs_event_write(const char* event_type, Log_Event_Write_Callback callback) { }
+void app_func_logs_flush(void) { }
+void app_func_logs_parameter_write(uint8_t* p_id, uint8_t data_format, const uint8_t* p_data, uint16_t data_len) { }
+uint8_t app_func_logs_read(const uint8_t* p_timestamp, uint8_t* p_data) { return 0; }
+void app_func_meas_sensor_continue(void) { }
+void app_func_meas_sensor_enable(uint8_t sensorID, bool enable) { }
+void app_func_meas_sensor_sampling(uint8_t sensorID, uint8_t* buff, uint8_t bufferSize, float samplingFrequency_hz) { }
+void app_func_meas_vdda_sup_enable(bool enable) { }
+void app_func_para_data_get(const uint8_t* p_id, uint8_t* p_data, uint8_t buff_size) { (void)memset(p_data, 0, buff_size); }
+void app_func_para_data_set(const uint8_t* p_id, uint8_t* p_data) { }
+uint8_t app_func_para_datalen_get(const uint8_t* p_id) { return 1U; }
+uint8_t app_func_para_datatype_get(const uint8_t* p_id) { return FORMAT_TYPE_RAWDATA; }
+bool app_func_para_profile_contains(const uint8_t* p_id) { return true; }
+void app_func_para_profile_data_get(uint8_t profile, const uint8_t* p_id, uint8_t* p_data, uint8_t buff_size) { (void)memset(p_data, 0, buff_size); }
+void app_func_para_profile_data_set_batch(uint8_t profile, const uint8_t* const p_ids[], const uint8_t* const p_datas[], uint8_t num) { }
+uint8_t app_func_para_profile_get(void) { return 0; }
+bool app_func_para_profile_select(uint8_t profile) { return true; }
+_Float64 app_func_para_stepsize_get(const uint8_t* p_id) { return 1.0; }
+bool app_func_para_subscribe(const uint8_t* p_id, Parameter_Change_Callback callback) { return true; }
+bool app_func_para_val_in_range(const uint8_t* p_id, _Float64 val) { return true; }
+void app_func_sm_active_eos_check(void) { }
+uint16_t app_func_sm_current_state_get(void) { return STATE_ACT_MODE_BLE_CONN; }
+void app_func_sm_current_state_set(uint16_t state) { }
+void app_func_sm_schd_therapy_enable(bool enable) { }
+void app_mode_battery_test_volt_abort(void) { }
+void app_mode_battery_test_volt_get(uint16_t* p_vbatA, uint16_t* p_vbatB) { *p_vbatA = 0; *p_vbatB = 0; }
+bool app_mode_battery_test_volt_step(uint16_t* p_vbatA, uint16_t* p_vbatB, uint8_t* p_progress) { return false; }
+uint8_t app_mode_dvt_acc_data_get(DeviceID_t deviceID, uint8_t* dataBuffer, uint8_t* dataSize) { *dataSize = 0; return STATUS_SUCCESS; }
+uint8_t app_mode_dvt_acc_start(FreqModeDeviceID_t freqModedeviceID, uint8_t* dataBuffer, uint8_t* dataSize) { *dataSize = 0; return STATUS_SUCCESS; }
+uint8_t app_mode_dvt_acc_stop(DeviceID_t deviceID, uint8_t* dataBuffer, uint8_t* dataSize) { *dataSize = 0; return STATUS_SUCCESS; }
+_Float64 app_mode_impedance_test_get(void) { return 0.0; }
+uint8_t app_mode_impedance_test_survey(uint16_t* p_imp_matrix) { return 0; }
+void app_mode_impedance_test_survey_abort(void) { }
+bool app_mode_impedance_test_survey_step(uint16_t* p_imp_matrix, uint8_t* p_pair_num, uint8_t* p_progress) { return false; }
+bool app_mode_therapy_confirm(void) { return false; }
+bool app_mode_therapy_start(void) { return true; }
+void app_mode_therapy_stop(void) { }
+bool bsp_adc_sampling_is_completed(void) { return false; }
+void bsp_fram_write(uint32_t addr, const uint8_t* p_data, uint16_t data_len, bool waitfor_cplt) { }
+bool bsp_sp_cmd_handler(void) { return true; }
+bool bsp_sp_cmd_is_pending(void) { return false; }
+bool bsp_sp_cmd_is_requested(void) { return false; }
+void bsp_sp_cmd_send(const uint8_t* data, uint8_t data_len) { }
+void bsp_wdg_refresh(void) { }
+
+/* ---- The requests ---- */
+
+/**
+ * @brief Send a request through the parser of the BLE connection mode, the response is prepared as app_func_command_parser does
+ *
+ * @return uint8_t The status of the response
+ */
+static uint8_t request(uint8_t opcode, uint8_t* p_payload, uint8_t len, uint8_t user_class, Cmd_Resp_t* p_resp) {
+	static uint8_t resp_payload[LEN_RESP_PAYLOAD_MAX];
+	Cmd_Req_t req = {
+			.Opcode = opcode,
+			.Payload = p_payload,
+			.PayloadLen = len,
+	};
+	p_resp->Opcode = opcode;
+	p_resp->Status = STATUS_SUCCESS;
+	p_resp->Payload = resp_payload;
+	p_resp->PayloadLen = 0;
+	remote_user_class = user_class;
+	app_mode_ble_conn_cmd_parser(&req, p_resp);
+	return p_resp->Status;
+}
+
+/**
+ * @brief Start a job, so the job commands have a job ID to work on
+ *
+ */
+static void job_prepare(uint8_t* p_payload) {
+	uint8_t start[1] = {OP_MEASURE_IMPEDANCE};
+	Cmd_Resp_t resp;
+	CHECK_EQ(STATUS_SUCCESS, request(OP_JOB_START, start, 1U, USER_CLASS_ADMIN, &resp), "JOB_START before a job command");
+	p_payload[0] = resp.Payload[0];
+}
+
+/**
+ * @brief Put the state back, so each request is run as the first one after the connection
+ *
+ */
+static void state_reset(void) {
+	app_func_job_clear();
+	sens_en = false;
+	stim_en = false;
+	sw_reset = false;
+}
+
+static const Dispatch_Case_t dispatch_cases[] = {
+	{OP_SHUTDOWN_SYSTEM, &app_mode_ble_conn_cmd_shutdown_system, 0, 0, USER_CLASS_ADMIN, 0, NULL, NULL},
+	{OP_REBOOT_SYSTEM, &app_mode_ble_conn_cmd_reboot_system, 0, 0, USER_CLASS_ADMIN, 0, NULL, NULL},
+	{OP_BLE_DISCONNECT_REQUEST, &app_mode_ble_conn_cmd_ble_disconnect_request, 0, 0, USER_CLASS_ADMIN, 0, NULL, NULL},
+	{OP_START_SCHED_THERAPY_SESSION, &app_mode_ble_conn_cmd_start_sched_therapy_session, 0, 1, USER_CLASS_PATIENT, 1, (const uint8_t[]){1}, NULL},
+	{OP_END_SCHED_THERAPY_SESSION, &app_mode_ble_conn_cmd_end_sched_therapy_session, 0, 0, USER_CLASS_PATIENT, 0, NULL, NULL},
+	{OP_START_MANUAL_THERAPY_SESSION, &app_mode_ble_conn_cmd_start_manual_therapy_session, 0, 1, USER_CLASS_ADMIN, 1, (const uint8_t[]){1}, NULL},
+	{OP_STOP_MANUAL_THERAPY_SESSION, &app_mode_ble_conn_cmd_stop_manual_therapy_session, 0, 0, USER_CLASS_ADMIN, 0, NULL, NULL},
+	{OP_MEASURE_IMPEDANCE, &app_mode_ble_conn_cmd_measure_impedance, 0, 0, USER_CLASS_ADMIN, 0, NULL, NULL},
+	{OP_MEASURE_BATTERY_VOLTAGE, &app_mode_ble_conn_cmd_measure_battery_voltage, 0, 0, USER_CLASS_ADMIN, 0, NULL, NULL},
+	{OP_MEASURE_SENSOR_VOLTAGE, &app_mode_ble_conn_cmd_measure_sensor_voltage, 1, 5, USER_CLASS_ADMIN, 1, (const uint8_t[]){SENSOR_ID_IDLE}, NULL},
+	{OP_READ_HARDWARE_PARAMETERS, &app_mode_ble_conn_cmd_read_parameters, LEN_ID, LEN_ID, USER_CLASS_ADMIN, LEN_ID, (const uint8_t*)"HP01", NULL},
+	{OP_WRITE_HARDWARE_PARAMETERS, &app_mode_ble_conn_cmd_write_parameters, LEN_ID, LEN_REQ_PAYLOAD_MAX, USER_CLASS_ADMIN, LEN_ID + 1U, (const uint8_t*)"HP01\x01", NULL},
+	{OP_READ_STIMULATION_PARAMETERS, &app_mode_ble_conn_cmd_read_parameters, LEN_ID, LEN_ID, USER_CLASS_CLINICIAN, LEN_ID, (const uint8_t*)"SP01", NULL},
+	{OP_WRITE_STIMULATION_PARAMETERS, &app_mode_ble_conn_cmd_write_parameters, LEN_ID, LEN_REQ_PAYLOAD_MAX, USER_CLASS_CLINICIAN, LEN_ID + 1U, (const uint8_t*)"SP01\x01", NULL},
+	{OP_READ_IPG_LOG, &app_mode_ble_conn_cmd_read_ipg_log, 7, 7, USER_CLASS_ADMIN, 7, NULL, NULL},
+	{OP_ERASE_IPG_LOG, &app_mode_ble_conn_cmd_erase_ipg_log, 0, 0, USER_CLASS_ADMIN, 0, NULL, NULL},
+	{OP_READ_TIME_AND_DATE, &app_mode_ble_conn_cmd_read_time_and_date, 0, 0, USER_CLASS_ADMIN, 0, NULL, NULL},
+	{OP_WRITE_TIME_AND_DATE, &app_mode_ble_conn_cmd_write_time_and_date, 6, 6, USER_CLASS_ADMIN, 6, (const uint8_t[]){26, 1, 31, 23, 59, 59}, NULL},
+	{OP_MEASURE_IMPEDANCE_SURVEY, &app_mode_ble_conn_cmd_measure_impedance_survey, 0, 0, USER_CLASS_ADMIN, 0, NULL, NULL},
+	{OP_READ_PARAMETERS_BATCH, &app_mode_ble_conn_cmd_read_parameters_batch, LEN_ID, LEN_REQ_PAYLOAD_MAX, USER_CLASS_CLINICIAN, 2U * LEN_ID, (const uint8_t*)"SP01ST01", NULL},
+	{OP_WRITE_PARAMETERS_BATCH, &app_mode_ble_conn_cmd_write_parameters_batch, LEN_ID + 1U, LEN_REQ_PAYLOAD_MAX, USER_CLASS_CLINICIAN, 2U * (LEN_ID + 1U), (const uint8_t*)"SP01\x01ST01\x02", NULL},
+	{OP_SELECT_THERAPY_PROFILE, &app_mode_ble_conn_cmd_select_therapy_profile, 1, 1, USER_CLASS_CLINICIAN, 1, (const uint8_t[]){THERAPY_PROFILE_NUM - 1U}, NULL},
+	{OP_READ_THERAPY_PROFILE, &app_mode_ble_conn_cmd_read_parameters_batch, 1U + LEN_ID, LEN_REQ_PAYLOAD_MAX, USER_CLASS_CLINICIAN, 1U + LEN_ID, (const uint8_t*)"\x00SP01", NULL},
+	{OP_WRITE_THERAPY_PROFILE, &app_mode_ble_conn_cmd_write_parameters_batch, 1U + LEN_ID + 1U, LEN_REQ_PAYLOAD_MAX, USER_CLASS_CLINICIAN, 1U + LEN_ID + 1U, (const uint8_t*)"\x01SP01\x01", NULL},
+	{OP_JOB_START, &app_mode_ble_conn_cmd_job_start, 1, LEN_REQ_PAYLOAD_MAX, USER_CLASS_PATIENT, 1, (const uint8_t[]){OP_MEASURE_BATTERY_VOLTAGE}, NULL},
+	{OP_JOB_STATUS, &app_mode_ble_conn_cmd_job_status, 1, 1, USER_CLASS_PATIENT, 1, NULL, &job_prepare},
+	{OP_JOB_ABORT, &app_mode_ble_conn_cmd_job_abort, 1, 1, USER_CLASS_PATIENT, 1, NULL, &job_prepare},
+	{OP_READ_BLE_ADVANCE, &app_mode_ble_conn_cmd_read_ble_advance, 0, 0, USER_CLASS_ADMIN, 0, NULL, NULL},
+	{OP_WRITE_BLE_ADVANCE, &app_mode_ble_conn_cmd_write_ble_advance, sizeof(BLE_Advance_t), sizeof(BLE_Advance_t), USER_CLASS_ADMIN, sizeof(BLE_Advance_t), NULL, NULL},
+	{OP_AUTH_FW_IMAGE, &app_mode_ble_conn_cmd_auth_fw_image, sizeof(ECDSA_Data_t), sizeof(ECDSA_Data_t), USER_CLASS_ADMIN, sizeof(ECDSA_Data_t), NULL, NULL},
+	{OP_SET_START_STATE, &app_mode_ble_conn_cmd_set_start_state, 2, 2, USER_CLASS_ADMIN, 2, (const uint8_t[]){(uint8_t)STATE_ACT, (uint8_t)(STATE_ACT >> 8)}, NULL},
+	{OP_START_ACC, &app_mode_ble_conn_cmd_start_acc, 2, 2, USER_CLASS_ADMIN, 2, NULL, NULL},
+	{OP_GET_DATA_ACC, &app_mode_ble_conn_cmd_get_data_acc, 1, 1, USER_CLASS_ADMIN, 1, NULL, NULL},
+	{OP_STOP_ACC, &app_mode_ble_conn_cmd_stop_acc, 1, 1, USER_CLASS_ADMIN, 1, NULL, NULL},
+};
+#define DISPATCH_CASE_NUM	(sizeof(dispatch_cases) / sizeof(dispatch_cases[0]))
+
+/**
+ * @brief The long-running commands started by JOB_START, checked by the same rules
+ *
+ */
+static const Dispatch_Case_t job_cases[] = {
+	{OP_MEASURE_IMPEDANCE, &app_mode_ble_conn_job_cmd_measure_impedance, 0, 0, USER_CLASS_ADMIN, 0, NULL, NULL},
+	{OP_MEASURE_BATTERY_VOLTAGE, &app_mode_ble_conn_job_cmd_measure_battery_voltage, 0, 0, USER_CLASS_ADMIN, 0, NULL, NULL},
+	{OP_MEASURE_IMPEDANCE_SURVEY, &app_mode_ble_conn_job_cmd_measure_impedance, 0, 0, USER_CLASS_ADMIN, 0, NULL, NULL},
+};
+#define JOB_CASE_NUM	(sizeof(job_cases) / sizeof(job_cases[0]))
+
+/**
+ * @brief Find the entry of the opcode in the tables, as app_func_command_dispatch does
+ *
+ */
+static const Cmd_Entry_t* entry_find(const Cmd_Table_t* p_tables, uint8_t table_num, uint8_t opcode) {
+	for(uint8_t i=0;i<table_num;i++) {
+		if ((opcode >= p_tables[i].OpcodeFirst) && ((uint8_t)(opcode - p_tables[i].OpcodeFirst) < p_tables[i].Num)) {
+			return &p_tables[i].Entries[opcode - p_tables[i].OpcodeFirst];
+		}
+	}
+	return NULL;
+}
+
+static uint8_t user_class_below(uint8_t user_class) {
+	if (user_class == USER_CLASS_ADMIN) {
+		return USER_CLASS_CLINICIAN;
+	}
+	return user_class - 1U;
+}
+
+/**
+ * @brief Check the entry of the case, then send requests one byte too short, one byte too long,
+ * from a user class too low and a valid request from the admin
+ *
+ * @param p_case The case to be checked
+ * @param job The opcode is started by JOB_START
+ * @return uint32_t The number of requests sent
+ */
+static uint32_t case_check(const Dispatch_Case_t* p_case, bool job) {
+	uint8_t payload[LEN_REQ_PAYLOAD_MAX + 2U];
+	uint8_t* p_payload = job ? &payload[1] : payload;
+	uint8_t opcode = job ? OP_JOB_START : p_case->Opcode;
+	uint8_t len_job = job ? 1U : 0U;
+	uint32_t requests = 0;
+	Cmd_Resp_t resp;
+
+	const Cmd_Entry_t* p_entry = job ? entry_find(ble_conn_job_cmd_tables, BLE_CONN_JOB_CMD_TABLE_NUM, p_case->Opcode)
+			: entry_find(ble_conn_cmd_tables, BLE_CONN_CMD_TABLE_NUM, p_case->Opcode);
+	if (p_entry == NULL) {
+		CHECK_EQ(p_case->Opcode, 0xFFFFU, "opcode 0x%02X has no entry", p_case->Opcode);
+		return 0;
+	}
+	CHECK_EQ((uintptr_t)p_case->Handler, (uintptr_t)p_entry->Handler, "handler of opcode 0x%02X", p_case->Opcode);
+	CHECK_EQ(p_case->LenMin, p_entry->LenMin, "minimum length of opcode 0x%02X", p_case->Opcode);
+	CHECK_EQ(p_case->LenMax, p_entry->LenMax, "maximum length of opcode 0x%02X", p_case->Opcode);
+	CHECK_EQ(p_case->UserClass, p_entry->UserClass, "user class of opcode 0x%02X", p_case->Opcode);
+
+	payload[0] = p_case->Opcode;
+	(void)memset(p_payload, 0, LEN_REQ_PAYLOAD_MAX);
+	if (p_case->LenMin > 0U) {
+		state_reset();
+		CHECK_EQ(STATUS_PAYLOAD_LEN_ERR, request(opcode, payload, len_job + p_case->LenMin - 1U, USER_CLASS_ADMIN, &resp),
+				"opcode 0x%02X one byte too short", p_case->Opcode);
+		requests++;
+	}
+	if ((p_case->LenMax + len_job) < LEN_REQ_PAYLOAD_MAX) {
+		state_reset();
+		CHECK_EQ(STATUS_PAYLOAD_LEN_ERR, request(opcode, payload, len_job + p_case->LenMax + 1U, USER_CLASS_ADMIN, &resp),
+				"opcode 0x%02X one byte too long", p_case->Opcode);
+		requests++;
+	}
+
+	if (p_case->Payload != NULL) {
+		(void)memcpy(p_payload, p_case->Payload, p_case->Len);
+	}
+	if (p_case->Prepare != NULL) {
+		state_reset();
+		p_case->Prepare(p_payload);
+	}
+	uint8_t user_class = user_class_below(p_case->UserClass);
+	CHECK_EQ(STATUS_USER_CLASS_ERR, request(opcode, payload, len_job + p_case->Len, user_class, &resp),
+			"opcode 0x%02X from user class 0x%02X", p_case->Opcode, user_class);
+	requests++;
+
+	if (p_case->Prepare == NULL) {
+		state_reset();
+	}
+	CHECK_EQ(STATUS_SUCCESS, request(opcode, payload, len_job + p_case->Len, USER_CLASS_ADMIN, &resp),
+			"valid request of opcode 0x%02X", p_case->Opcode);
+	requests++;
+	return requests;
+}
+
+/**
+ * @brief The requests whose result changed when the switch was replaced by the tables
+ *
+ */
+static uint32_t order_check(void) {
+	uint8_t payload[LEN_REQ_PAYLOAD_MAX] = {0};
+	Cmd_Resp_t resp;
+
+	//A payload length within the range of the entry, but not one of those the handler takes
+	state_reset();
+	CHECK_EQ(STATUS_USER_CLASS_ERR, request(OP_MEASURE_SENSOR_VOLTAGE, payload, 2U, USER_CLASS_PATIENT, &resp), "MEASURE_SENSOR_VOLTAGE of 2 bytes from the patient");
+	CHECK_EQ(STATUS_PAYLOAD_LEN_ERR, request(OP_MEASURE_SENSOR_VOLTAGE, payload, 2U, USER_CLASS_ADMIN, &resp), "MEASURE_SENSOR_VOLTAGE of 2 bytes from the admin");
+
+	(void)memcpy(payload, "SP01S", LEN_ID + 1U);
+	CHECK_EQ(STATUS_USER_CLASS_ERR, request(OP_READ_PARAMETERS_BATCH, payload, LEN_ID + 1U, USER_CLASS_PATIENT, &resp), "READ_PARAMETERS_BATCH not aligned from the patient");
+	CHECK_EQ(STATUS_PAYLOAD_LEN_ERR, request(OP_READ_PARAMETERS_BATCH, payload, LEN_ID + 1U, USER_CLASS_CLINICIAN, &resp), "READ_PARAMETERS_BATCH not aligned from the clinician");
+
+	(void)memcpy(payload, "\x00SP01S", 1U + LEN_ID + 1U);
+	CHECK_EQ(STATUS_USER_CLASS_ERR, request(OP_READ_THERAPY_PROFILE, payload, 1U + LEN_ID + 1U, USER_CLASS_PATIENT, &resp), "READ_THERAPY_PROFILE not aligned from the patient");
+	CHECK_EQ(STATUS_PAYLOAD_LEN_ERR, request(OP_READ_THERAPY_PROFILE, payload, 1U + LEN_ID + 1U, USER_CLASS_CLINICIAN, &resp), "READ_THERAPY_PROFILE not aligned from the clinician");
+	return 6;
+}
+
+/**
+ * @brief Every opcode without a case is answered with OPCODE_ERR, whatever the length and user class
+ *
+ */
+static uint32_t opcode_check(void) {
+	uint8_t payload[LEN_REQ_PAYLOAD_MAX] = {0};
+	uint32_t requests = 0;
+	Cmd_Resp_t resp;
+
+	for(uint32_t opcode=0;opcode<=UINT8_MAX;opcode++) {
+		bool known = false;
+		for(uint32_t i=0;i<DISPATCH_CASE_NUM;i++) {
+			known = known || (dispatch_cases[i].Opcode == opcode);
+		}
+		if (!known) {
+			state_reset();
+			CHECK_EQ(STATUS_OPCODE_ERR, request((uint8_t)opcode, payload, 0U, USER_CLASS_ADMIN, &resp), "opcode 0x%02X", (unsigned)opcode);
+			CHECK_EQ(STATUS_OPCODE_ERR, request((uint8_t)opcode, payload, LEN_REQ_PAYLOAD_MAX, USER_CLASS_INVALID, &resp), "opcode 0x%02X", (unsigned)opcode);
+			requests += 2U;
+		}
+	}
+
+	//JOB_START of a command that is not long-running
+	payload[0] = OP_READ_TIME_AND_DATE;
+	state_reset();
+	CHECK_EQ(STATUS_OPCODE_ERR, request(OP_JOB_START, payload, 1U, USER_CLASS_ADMIN, &resp), "JOB_START of READ_TIME_AND_DATE");
+	return requests + 1U;
+}
+
+int main(void) {
+	uint32_t requests = 0;
+
+	for(uint32_t i=0;i<DISPATCH_CASE_NUM;i++) {
+		requests += case_check(&dispatch_cases[i], false);
+	}
+	for(uint32_t i=0;i<JOB_CASE_NUM;i++) {
+		requests += case_check(&job_cases[i], true);
+	}
+	requests += order_check();
+	requests += opcode_check();
+
+	//Every entry of the tables has a case
+	uint32_t entries = 0;
+	for(uint8_t i=0;i<BLE_CONN_CMD_TABLE_NUM;i++) {
+		for(uint8_t j=0;j<ble_conn_cmd_tables[i].Num;j++) {
+			entries += (ble_conn_cmd_tables[i].Entries[j].Handler != NULL) ? 1U : 0U;
+		}
+	}
+	CHECK_EQ(DISPATCH_CASE_NUM, entries, "entries in the command tables");
+
+	(void)printf("test_ble_conn_dispatch: %lu opcodes, %lu requests, %lu failures\n",
+			(unsigned long)(DISPATCH_CASE_NUM + JOB_CASE_NUM), (unsigned long)requests, (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
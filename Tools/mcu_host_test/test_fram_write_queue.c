@@ -0,0 +1,443 @@
+/**
+ * @file test_fram_write_queue.c
+ * @brief Burst stress test of the non-blocking FRAM write queue, against the real bsp_serialport.c, bsp_fram.c and app_func_logs.c
+ *
+ * The SPI bus runs on a virtual clock at 5 MHz, and the CY15B108QN is modelled from the bytes clocked out while its CS is low:
+ * a write is only taken after WREN, and both chip selects must never be low together. The interrupts masked by the firmware
+ * run when the mask is cleared, each pass of a wait loop of the main context takes 1 us.
+ * Bursts of writes of random sizes are queued from the main context, some waited for, while an interrupt queues more writes
+ * during the blocking transfers to the nRF52810. The FRAM must end with the data of every write in order, a write queued
+ * while the serial port is taken must wait for it, and a full queue must refuse a write without waiting. A burst of logs
+ * must never find the queue full. The throughput, the deepest queue and the most caller data held by the queue are reported.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include "app_config.h"
+
+#define SIM_NS_PER_BYTE			1600.0		/*!< 8 bits at the 5 MHz SPI clock */
+#define SIM_IRQ_US				2.0			/*!< Entry and exit of the SPI interrupt and its callback */
+#define SIM_WAIT_US				1.0			/*!< One pass of a wait loop in the main context */
+#define SIM_FRAM_SIZE			(CY15B108QN_MAX_ADDR + 1UL)
+#define SIM_AREA_BASE			ADDR_FW_IMG_BASE	/*!< The random writes go to the firmware image area */
+#define SIM_AREA_SIZE			SIZE_FW_IMG
+#define SIM_WRITE_MAX			256U
+#define SIM_BUFFERS				8U			/*!< Caller buffers, each reused only after its write completes */
+#define SIM_WRITES				20000U
+#define SIM_LOGS				4000U		/*!< More than the log ring holds, so it wraps */
+#define SIM_QUEUE_SIZE			12U			/*!< CY15B108QN_WR_QUEUE_SIZE of bsp_serialport.c */
+#define SIM_LEN_TIMESTAMP		27U			/*!< The timestamp at the start of each log, "[20YY-MM-DDThh:mm:ssZ(uuu)]" */
+#define SIM_CMD_WREN			0x06U
+#define SIM_CMD_WRITE			0x02U
+#define SIM_CMD_READ			0x03U
+
+bool __real_bsp_sp_CY15B108QN_write_IT(uint32_t addr, const uint8_t* p_data, uint16_t data_len);
+
+static uint8_t fram[SIM_FRAM_SIZE];
+static uint8_t shadow[SIM_AREA_SIZE];		/*!< The area as it must end, updated in the order the writes are queued */
+static double now_us = 0.0;
+static uint32_t rng_state = 1;
+static uint32_t failures = 0;
+
+static GPIO_PinState pins[8] = {GPIO_PIN_RESET, GPIO_PIN_RESET, GPIO_PIN_RESET, GPIO_PIN_SET, GPIO_PIN_SET};
+static uint32_t primask = 0;
+static bool in_isr = false;
+
+static HAL_SPI_StateTypeDef spi_state = HAL_SPI_STATE_READY;
+static const uint8_t* p_it_data = NULL;
+static uint16_t it_len = 0;
+static double it_done_us = 0.0;
+
+static bool fram_wel = false;				/*!< The write enable latch */
+static uint8_t fram_cmd[4];
+static uint32_t fram_cmd_len = 0;
+static uint32_t fram_addr = 0;
+
+static uint32_t queue_depth = 0;
+static uint32_t queue_depth_max = 0;
+static uint32_t queue_bytes = 0;
+static uint32_t queue_bytes_max = 0;
+static uint32_t queue_bytes_total = 0;
+static uint32_t queue_refused = 0;
+static uint32_t queue_written = 0;
+static uint32_t isr_writes = 0;
+static bool log_writes = false;
+
+static uint8_t buffers[SIM_BUFFERS][SIM_WRITE_MAX];
+static bool buffer_busy[SIM_BUFFERS];
+static uint8_t buffer_order[SIM_BUFFERS];	/*!< The buffers in the order of their writes, the writes complete in that order */
+static uint32_t buffer_queued = 0;
+static uint32_t buffer_written = 0;
+static uint8_t isr_buffer[16];
+
+#define CHECK_EQ(EXPECTED, ACTUAL, ...)											\
+	do {																		\
+		if ((uint32_t)(EXPECTED) != (uint32_t)(ACTUAL)) {						\
+			(void)printf("FAIL %s:%d expected %lu, got %lu: ", __FILE__, __LINE__, \
+					(unsigned long)(EXPECTED), (unsigned long)(ACTUAL));		\
+			(void)printf(__VA_ARGS__);											\
+			(void)printf("\n");													\
+			failures++;															\
+		}																		\
+	} while(0)
+
+static uint32_t rng_next(uint32_t range) {
+	rng_state = (rng_state * 1103515245UL) + 12345UL;
+	return (rng_state >> 8) % range;
+}
+
+void bsp_wdg_refresh(void) {
+}
+
+HAL_StatusTypeDef HAL_RTC_GetTime(RTC_HandleTypeDef* hrtc_, RTC_TimeTypeDef* p_time, uint32_t format) {
+	UNUSED(hrtc_);
+	UNUSED(format);
+	uint32_t seconds = (uint32_t)(now_us / 1e6);
+	p_time->Hours = (uint8_t)((seconds / 3600U) % 24U);
+	p_time->Minutes = (uint8_t)((seconds / 60U) % 60U);
+	p_time->Seconds = (uint8_t)(seconds % 60U);
+	p_time->SubSeconds = 255U;
+	return HAL_OK;
+}
+
+/**
+ * @brief The bytes clocked out to the CY15B108QN while its CS is low
+ *
+ */
+static void fram_bytes(const uint8_t* p_data, uint16_t size) {
+	for (uint16_t i = 0; i < size; i++) {
+		if (fram_cmd_len < sizeof(fram_cmd)) {
+			fram_cmd[fram_cmd_len++] = p_data[i];
+			if ((fram_cmd_len == 1U) && (fram_cmd[0] == SIM_CMD_WREN)) {
+				fram_wel = true;
+			}
+			if (fram_cmd_len == sizeof(fram_cmd)) {
+				fram_addr = ((uint32_t)fram_cmd[1] << 16) | ((uint32_t)fram_cmd[2] << 8) | fram_cmd[3];
+			}
+			continue;
+		}
+		if (fram_cmd[0] == SIM_CMD_WRITE) {
+			CHECK_EQ(true, fram_wel, "FRAM write at 0x%05lX without WREN", (unsigned long)fram_addr);
+			fram[fram_addr % SIM_FRAM_SIZE] = p_data[i];
+			fram_addr++;
+		}
+	}
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(uint32_t port, uint16_t pin) {
+	UNUSED(port);
+	return pins[pin];
+}
+
+void HAL_GPIO_WritePin(uint32_t port, uint16_t pin, GPIO_PinState state) {
+	UNUSED(port);
+	if ((pin == SPI1_FRAM_CSn_Pin) && (state != pins[pin])) {
+		if ((state == GPIO_PIN_SET) && (fram_cmd_len == sizeof(fram_cmd)) && (fram_cmd[0] == SIM_CMD_WRITE)) {
+			fram_wel = false;
+		}
+		fram_cmd_len = 0;
+	}
+	pins[pin] = state;
+	CHECK_EQ(true, (pins[SPI1_FRAM_CSn_Pin] == GPIO_PIN_SET) || (pins[SPI1_BLE_CSn_Pin] == GPIO_PIN_SET),
+			"both chip selects low at %.1f us", now_us);
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(const SPI_HandleTypeDef* hspi) {
+	UNUSED(hspi);
+	return spi_state;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_IT(SPI_HandleTypeDef* hspi, const uint8_t* p_data, uint16_t size) {
+	UNUSED(hspi);
+	if (spi_state != HAL_SPI_STATE_READY) {
+		return HAL_BUSY;
+	}
+	CHECK_EQ(GPIO_PIN_RESET, pins[SPI1_FRAM_CSn_Pin], "non-blocking transfer without the FRAM selected");
+	spi_state = HAL_SPI_STATE_BUSY;
+	p_it_data = p_data;
+	it_len = size;
+	it_done_us = now_us + ((double)size * SIM_NS_PER_BYTE / 1000.0);
+	return HAL_OK;
+}
+
+/**
+ * @brief Run the SPI interrupt if its transfer is done, or wait for it
+ *
+ */
+static void spi_irq_run(bool wait) {
+	while ((spi_state == HAL_SPI_STATE_BUSY) && (wait || (it_done_us <= now_us))) {
+		now_us = ((it_done_us > now_us) ? it_done_us : now_us) + SIM_IRQ_US;
+		fram_bytes(p_it_data, it_len);
+		spi_state = HAL_SPI_STATE_READY;
+		in_isr = true;
+		HAL_SPI_TxCpltCallback(&hspi1);
+		in_isr = false;
+		wait = false;
+	}
+}
+
+void hal_stub_irq_disable(void) {
+	primask = 1U;
+}
+
+uint32_t hal_stub_primask_get(void) {
+	return primask;
+}
+
+/**
+ * @brief The interrupts pending while they were masked run when the mask is cleared in the main context
+ *
+ */
+void hal_stub_primask_set(uint32_t mask) {
+	primask = mask;
+	if ((mask == 0U) && (in_isr == false)) {
+		now_us += SIM_WAIT_US;
+		spi_irq_run(false);
+	}
+}
+
+void HAL_Delay(uint32_t delay) {
+	double end_us = now_us + ((double)delay * 1000.0);
+	while ((spi_state == HAL_SPI_STATE_BUSY) && (it_done_us <= end_us)) {
+		spi_irq_run(true);
+	}
+	now_us = (end_us > now_us) ? end_us : now_us;
+}
+
+uint32_t HAL_GetTick(void) {
+	return (uint32_t)(now_us / 1000.0);
+}
+
+/**
+ * @brief An interrupt queues a write while the main context holds the nRF52810 selected
+ *
+ */
+static void isr_write(void) {
+	in_isr = true;
+	uint32_t offset = SIM_AREA_SIZE - sizeof(isr_buffer);
+	for (uint8_t i = 0; i < sizeof(isr_buffer); i++) {
+		isr_buffer[i] = (uint8_t)(isr_writes + i);
+	}
+	uint32_t written = queue_written;
+	bsp_fram_write(SIM_AREA_BASE + offset, isr_buffer, (uint16_t)sizeof(isr_buffer), false);
+	(void)memcpy(&shadow[offset], isr_buffer, sizeof(isr_buffer));
+	CHECK_EQ(GPIO_PIN_SET, pins[SPI1_FRAM_CSn_Pin], "write started while the nRF52810 is selected");
+	CHECK_EQ(written, queue_written, "write completed while the nRF52810 is selected");
+	isr_writes++;
+	in_isr = false;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, const uint8_t* p_data, uint16_t size, uint32_t timeout) {
+	UNUSED(hspi);
+	UNUSED(timeout);
+	CHECK_EQ(HAL_SPI_STATE_READY, spi_state, "blocking transfer while a write is in flight");
+	now_us += (double)size * SIM_NS_PER_BYTE / 1000.0;
+	if (pins[SPI1_FRAM_CSn_Pin] == GPIO_PIN_RESET) {
+		fram_bytes(p_data, size);
+	}
+	else if (pins[SPI1_BLE_CSn_Pin] == GPIO_PIN_RESET) {
+		isr_write();
+	}
+	else {
+		__NOP();
+	}
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef* hspi, uint8_t* p_data, uint16_t size, uint32_t timeout) {
+	UNUSED(hspi);
+	UNUSED(timeout);
+	CHECK_EQ(HAL_SPI_STATE_READY, spi_state, "blocking transfer while a write is in flight");
+	now_us += (double)size * SIM_NS_PER_BYTE / 1000.0;
+	if ((pins[SPI1_FRAM_CSn_Pin] == GPIO_PIN_RESET) && (fram_cmd[0] == SIM_CMD_READ)) {
+		(void)memcpy(p_data, &fram[fram_addr], size);
+		fram_addr += size;
+	}
+	else {
+		(void)memset(p_data, 0, size);
+	}
+	return HAL_OK;
+}
+
+/**
+ * @brief Count the writes queued, the queue holds the caller data until the write completes
+ *
+ */
+bool __wrap_bsp_sp_CY15B108QN_write_IT(uint32_t addr, const uint8_t* p_data, uint16_t data_len) {
+	bool queued = __real_bsp_sp_CY15B108QN_write_IT(addr, p_data, data_len);
+	if (queued) {
+		queue_depth++;
+		queue_bytes += data_len;
+		queue_bytes_total += data_len;
+		queue_depth_max = (queue_depth > queue_depth_max) ? queue_depth : queue_depth_max;
+		queue_bytes_max = (queue_bytes > queue_bytes_max) ? queue_bytes : queue_bytes_max;
+	}
+	else {
+		queue_refused++;
+	}
+	return queued;
+}
+
+static void write_cplt_cb(uint32_t write_addr, uint16_t write_size) {
+	queue_depth--;
+	queue_bytes -= write_size;
+	queue_written++;
+	if ((write_addr >= SIM_AREA_BASE) && (write_addr < (SIM_AREA_BASE + SIM_AREA_SIZE - sizeof(isr_buffer)))
+			&& (buffer_written != buffer_queued)) {
+		buffer_busy[buffer_order[buffer_written % SIM_BUFFERS]] = false;
+		buffer_written++;
+	}
+	if (log_writes) {
+		app_func_logs_write_cplt_cb(write_addr, write_size);
+	}
+}
+
+static void queue_reset(void) {
+	HAL_Delay(10);
+	CHECK_EQ(0, queue_depth, "writes left in the queue");
+	queue_depth_max = 0;
+	queue_bytes_max = 0;
+	queue_written = 0;
+	queue_bytes_total = 0;
+	now_us = 0.0;
+}
+
+/**
+ * @brief Random writes from caller buffers, a write of a buffer completes before the buffer is used again
+ *
+ */
+static void test_burst(void) {
+	uint32_t waited = 0;
+	for (uint32_t w = 0; w < SIM_WRITES; w++) {
+		uint32_t b = rng_next(SIM_BUFFERS);
+		while (buffer_busy[b]) {
+			(void)bsp_fram_is_busy();
+		}
+		uint16_t len = (uint16_t)(1U + rng_next(SIM_WRITE_MAX));
+		uint32_t offset = rng_next(SIM_AREA_SIZE - SIM_WRITE_MAX - sizeof(isr_buffer));
+		for (uint16_t i = 0; i < len; i++) {
+			buffers[b][i] = (uint8_t)rng_next(256U);
+		}
+		(void)memcpy(&shadow[offset], buffers[b], len);
+		buffer_busy[b] = true;
+		buffer_order[buffer_queued % SIM_BUFFERS] = (uint8_t)b;
+		buffer_queued++;
+		bool wait = (rng_next(10U) == 0U);
+		waited += wait ? 1U : 0U;
+		bsp_fram_write(SIM_AREA_BASE + offset, buffers[b], len, wait);
+		if (rng_next(8U) == 0U) {
+			//The command handler waits for the FRAM before it selects the nRF52810
+			while (bsp_fram_is_busy()) {
+				__NOP();
+			}
+			uint8_t frame[32] = {0};
+			bsp_sp_nRF52810_write(frame, (uint16_t)sizeof(frame));
+		}
+	}
+	double burst_us = now_us;
+	uint32_t bytes_total = queue_bytes_total;
+	HAL_Delay(10);
+	uint32_t mismatch = 0;
+	for (uint32_t i = 0; i < SIM_AREA_SIZE; i++) {
+		mismatch += (fram[SIM_AREA_BASE + i] != shadow[i]) ? 1U : 0U;
+	}
+	CHECK_EQ(0, mismatch, "bytes of the FRAM differ from the writes queued");
+	CHECK_EQ(0, queue_refused, "writes refused in the burst");
+	(void)printf("  %-22s %6u writes %5u waited %5lu from an interrupt %7.1f KB/s %3lu/%u deep %6lu B held\n",
+			"random 1~256 B", SIM_WRITES, waited, (unsigned long)isr_writes,
+			(double)bytes_total / burst_us * 1e6 / 1024.0, (unsigned long)queue_depth_max, SIM_QUEUE_SIZE,
+			(unsigned long)queue_bytes_max);
+	queue_reset();
+}
+
+/**
+ * @brief A full queue refuses a write from an interrupt at once, the write is queued again once there is room
+ *
+ */
+static void test_full(void) {
+	static uint8_t data[SIM_QUEUE_SIZE + 1U][SIM_WRITE_MAX];
+	for (uint32_t w = 0; w < SIM_QUEUE_SIZE; w++) {
+		(void)memset(data[w], (int)(0x40U + w), SIM_WRITE_MAX);
+		(void)memcpy(&shadow[w * SIM_WRITE_MAX], data[w], SIM_WRITE_MAX);
+		bsp_fram_write(SIM_AREA_BASE + (w * SIM_WRITE_MAX), data[w], SIM_WRITE_MAX, false);
+	}
+	CHECK_EQ(SIM_QUEUE_SIZE, queue_depth, "writes queued to fill the queue");
+	(void)memset(data[SIM_QUEUE_SIZE], 0x5A, SIM_WRITE_MAX);
+	in_isr = true;
+	bool queued = bsp_sp_CY15B108QN_write_IT(SIM_AREA_BASE + (SIM_QUEUE_SIZE * SIM_WRITE_MAX), data[SIM_QUEUE_SIZE], SIM_WRITE_MAX);
+	in_isr = false;
+	CHECK_EQ(false, queued, "write to a full queue");
+	CHECK_EQ(1, queue_refused, "writes refused");
+	//The main context waits for room instead
+	(void)memcpy(&shadow[SIM_QUEUE_SIZE * SIM_WRITE_MAX], data[SIM_QUEUE_SIZE], SIM_WRITE_MAX);
+	bsp_fram_write(SIM_AREA_BASE + (SIM_QUEUE_SIZE * SIM_WRITE_MAX), data[SIM_QUEUE_SIZE], SIM_WRITE_MAX, true);
+	CHECK_EQ(0, memcmp(&fram[SIM_AREA_BASE], shadow, (SIM_QUEUE_SIZE + 1U) * SIM_WRITE_MAX), "FRAM after the full queue");
+	(void)printf("  %-22s %6u writes, the %uth refused from an interrupt and queued again by the main context\n",
+			"full queue", SIM_QUEUE_SIZE + 1U, SIM_QUEUE_SIZE + 1U);
+	queue_refused = 0;
+	queue_reset();
+}
+
+/**
+ * @brief Logs as fast as the main context writes them, with the log pointer saved from the completion callback
+ *
+ */
+static void test_logs(void) {
+	log_writes = true;
+	app_func_logs_init();
+	queue_reset();
+	double log_us_max = 0.0;
+	for (uint32_t l = 0; l < SIM_LOGS; l++) {
+		double start_us = now_us;
+		app_func_logs_event_write("BURST_EVT", NULL);
+		log_us_max = ((now_us - start_us) > log_us_max) ? (now_us - start_us) : log_us_max;
+	}
+	double burst_us = now_us;
+	uint32_t bytes_total = queue_bytes_total;
+	app_func_logs_flush();
+	Log_Info_t log_info;
+	(void)memcpy(&log_info, &fram[ADDR_LOG_INFO], sizeof(log_info));
+
+	//The newest logs run back to back from the base to the log pointer
+	uint32_t logs = 0;
+	uint32_t addr = ADDR_LOG_BASE;
+	while ((addr < log_info.LogPointer) && (fram[addr] == (uint8_t)'[')) {
+		addr += (uint32_t)strcspn((const char*)&fram[addr], "\n") + 1U;
+		logs++;
+	}
+	CHECK_EQ(log_info.LogPointer, addr, "end of the logs written after the wrap");
+	CHECK_EQ(0, fram[log_info.LogPointer], "end of the last log");
+	//The older logs run back to back from the first one after the log pointer, the tail after them is cleared
+	addr = log_info.LogPointer + 1U;
+	while ((fram[addr] != (uint8_t)'[') || (fram[addr + SIM_LEN_TIMESTAMP - 1U] != (uint8_t)']')) {
+		addr++;
+	}
+	while (fram[addr] == (uint8_t)'[') {
+		addr += (uint32_t)strcspn((const char*)&fram[addr], "\n") + 1U;
+		logs++;
+	}
+	uint32_t tail = 0;
+	for (; addr < (ADDR_LOG_BASE + SIZE_LOG); addr++) {
+		tail += (fram[addr] != 0U) ? 1U : 0U;
+	}
+	CHECK_EQ(0, tail, "bytes left in the tail cleared at the wrap");
+	CHECK_EQ(0, queue_refused, "log writes refused");
+	(void)printf("  %-22s %6u logs, %4lu in the ring after the wrap, %5.0f us the longest %7.1f KB/s %3lu/%u deep %6lu B held\n",
+			"logs", SIM_LOGS, (unsigned long)logs, log_us_max, (double)bytes_total / burst_us * 1e6 / 1024.0,
+			(unsigned long)queue_depth_max, SIM_QUEUE_SIZE, (unsigned long)queue_bytes_max);
+	log_writes = false;
+	queue_reset();
+}
+
+int main(void) {
+	bsp_sp_init(NULL, &bsp_fram_write_cplt_cb);
+	bsp_fram_init(&write_cplt_cb);
+
+	(void)printf("test_fram_write_queue: SPI at 5 MHz (%.0f KB/s), queue of %u writes\n",
+			1e9 / SIM_NS_PER_BYTE / 1024.0, SIM_QUEUE_SIZE);
+	test_burst();
+	test_full();
+	test_logs();
+
+	(void)printf("test_fram_write_queue: %lu failures\n", (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file test_logs_recover.c
+ * @brief Power-cut recovery test of the log pointer, against the real app_func_logs.c
+ *
+ * The FRAM is modelled as an array. The log pointer is only saved every 16 logs, so after
+ * a power cut app_func_logs_init must find the logs written since then from their content.
+ * Power is cut after every byte of a log in turn, also after the ring has wrapped over older logs.
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include "app_config.h"
+
+#define FRAM_SIZE				(ADDR_LOG_INFO + sizeof(Log_Info_t))
+#define POWER_ALWAYS_ON			UINT32_MAX
+
+extern Log_Info_t logInfo;
+
+static uint8_t fram[FRAM_SIZE];
+static uint32_t power_budget = POWER_ALWAYS_ON;	/*!< The number of bytes written to FRAM before the power is cut */
+static uint32_t last_log_end = ADDR_LOG_BASE;	/*!< The end of the last log completely in FRAM */
+static uint32_t log_body_end = ADDR_LOG_BASE;	/*!< The end of the last log whose first byte is not written yet */
+static uint32_t rtc_seconds = 0;
+static uint32_t failures = 0;
+
+#define CHECK_EQ(EXPECTED, ACTUAL, ...)											\
+	do {																		\
+		if ((uint32_t)(EXPECTED) != (uint32_t)(ACTUAL)) {						\
+			(void)printf("FAIL %s:%d expected 0x%05lX, got 0x%05lX: ", __FILE__, __LINE__, \
+					(unsigned long)(EXPECTED), (unsigned long)(ACTUAL));		\
+			(void)printf(__VA_ARGS__);											\
+			(void)printf("\n");													\
+			failures++;															\
+		}																		\
+	} while(0)
+
+void bsp_wdg_refresh(void) {
+}
+
+HAL_StatusTypeDef HAL_RTC_GetTime(RTC_HandleTypeDef* hrtc_, RTC_TimeTypeDef* p_time, uint32_t format) {
+	UNUSED(hrtc_);
+	UNUSED(format);
+	//Each log gets a newer time, a day is enough for all the logs of a test
+	rtc_seconds++;
+	p_time->Hours = (uint8_t)((rtc_seconds / 3600U) % 24U);
+	p_time->Minutes = (uint8_t)((rtc_seconds / 60U) % 60U);
+	p_time->Seconds = (uint8_t)(rtc_seconds % 60U);
+	p_time->SubSeconds = 255U;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_GetDate(RTC_HandleTypeDef* hrtc_, RTC_DateTypeDef* p_date, uint32_t format) {
+	UNUSED(hrtc_);
+	UNUSED(format);
+	p_date->Year = 26U;
+	p_date->Month = 1U;
+	p_date->Date = (uint8_t)(1U + (rtc_seconds / 86400U));
+	return HAL_OK;
+}
+
+/**
+ * @brief Write to the FRAM model, the bytes beyond the power budget are lost
+ *
+ */
+void bsp_fram_write(uint32_t addr, const uint8_t* p_data, uint16_t data_len, bool waitfor_cplt) {
+	UNUSED(waitfor_cplt);
+	uint32_t len = data_len;
+	if (len > power_budget) {
+		len = power_budget;
+	}
+	(void)memcpy(&fram[addr], p_data, len);
+	if (power_budget != POWER_ALWAYS_ON) {
+		power_budget -= len;
+	}
+	if (len == data_len) {
+		//The zeros written to clear the ring when it wraps are not logs.
+		//The rest of a log is written first, its first byte completes it
+		if ((addr < (ADDR_LOG_BASE + SIZE_LOG)) && (p_data[0] == 0U)) {
+			__NOP();
+		}
+		else if ((addr < (ADDR_LOG_BASE + SIZE_LOG)) && (data_len > 1U)) {
+			log_body_end = addr + data_len - 1U;
+		}
+		else if (addr < (ADDR_LOG_BASE + SIZE_LOG)) {
+			last_log_end = log_body_end;
+		}
+		else {
+			__NOP();
+		}
+		app_func_logs_write_cplt_cb(addr, data_len);
+	}
+}
+
+void bsp_fram_read(uint32_t addr, uint8_t* p_data, uint16_t data_len) {
+	(void)memcpy(p_data, &fram[addr], data_len);
+}
+
+bool bsp_fram_is_busy(void) {
+	return false;
+}
+
+void bsp_fram_erase(uint32_t addr, uint32_t erase_size) {
+	if (power_budget > 0U) {
+		(void)memset(&fram[addr], 0, erase_size);
+	}
+}
+
+/**
+ * @brief Write a log of a length picked by the number, from 39 to 165 bytes
+ *
+ */
+static void log_write(uint32_t n) {
+	if ((n % 3U) == 0U) {
+		app_func_logs_event_write(EVENT_STIM_START, NULL);
+	}
+	else {
+		uint8_t data[64];
+		for(uint8_t i=0;i<sizeof(data);i++) {
+			data[i] = (uint8_t)(n + i);
+		}
+		uint8_t id[LEN_ID] = {'T','P','0','1'};
+		app_func_logs_parameter_write(id, FORMAT_TYPE_RAWDATA, data, (uint16_t)(1U + ((n * 7U) % sizeof(data))));
+	}
+}
+
+/**
+ * @brief Boot again from the FRAM content, as after a power cut
+ *
+ */
+static void reboot(void) {
+	power_budget = POWER_ALWAYS_ON;
+	(void)memset(&logInfo, 0xFF, sizeof(logInfo));
+	app_func_logs_init();
+}
+
+/**
+ * @brief Write logs, cut the power after a number of bytes of the next log, and check the recovered log pointer
+ *
+ * @param num_logs The number of logs written before the cut
+ * @param cut The number of bytes of the next log written before the cut
+ */
+static void power_cut_check(uint32_t num_logs, uint32_t cut) {
+	for(uint32_t n=0;n<num_logs;n++) {
+		log_write(n);
+	}
+	uint32_t end_before = last_log_end;
+	power_budget = cut;
+	log_write(num_logs);
+	bool complete = (last_log_end != end_before);
+	reboot();
+
+	if (complete) {
+		CHECK_EQ(last_log_end, logInfo.LogPointer, "%lu logs, power cut after the log", (unsigned long)num_logs);
+	}
+	else {
+		CHECK_EQ(end_before, logInfo.LogPointer, "%lu logs, power cut after %lu bytes of the next log", (unsigned long)num_logs, (unsigned long)cut);
+	}
+
+	//The next log goes right after the last complete log and is found again
+	log_write(num_logs + 1U);
+	reboot();
+	CHECK_EQ(last_log_end, logInfo.LogPointer, "%lu logs, log written after the recovery", (unsigned long)num_logs);
+}
+
+/**
+ * @brief Start from an empty log
+ *
+ */
+static void fram_clear(void) {
+	power_budget = POWER_ALWAYS_ON;
+	(void)memset(fram, 0, sizeof(fram));
+	app_func_logs_erase();
+	last_log_end = ADDR_LOG_BASE;
+	reboot();
+}
+
+int main(void) {
+	uint32_t cases = 0;
+
+	//More than 256 bytes of logs since the last save of the log pointer, and a cut after every byte of the next log
+	for(uint32_t num_logs=1;num_logs<=40U;num_logs++) {
+		for(uint32_t cut=0;cut<=170U;cut++) {
+			fram_clear();
+			power_cut_check(num_logs, cut);
+			cases++;
+		}
+	}
+
+	//The ring wraps over older logs, the bytes after a log cut by the power loss are left from older logs
+	fram_clear();
+	uint32_t n = 0;
+	uint32_t end_prev = last_log_end;
+	while(last_log_end >= end_prev) {
+		end_prev = last_log_end;
+		log_write(n++);
+	}
+	for(uint32_t round=0;round<200U;round++) {
+		for(uint32_t cut=0;cut<=170U;cut+=7U) {
+			power_cut_check(round % 37U, cut);
+			cases++;
+		}
+	}
+
+	(void)printf("test_logs_recover: %lu cases, %lu failures\n", (unsigned long)cases, (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
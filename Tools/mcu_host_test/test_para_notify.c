@@ -0,0 +1,305 @@
+/**
+ * @file test_para_notify.c
+ * @brief Test of the parameter change notifications, from a BLE write to the copies kept by the modules, against the real
+ * app_func_parameter.c, app_mode_ble_connection.c, app_mode_therapy_session.c and app_func_state_machine.c
+ *
+ * The parameters are written with the requests of the BLE connection mode, through its real parser, and the copy each
+ * module keeps must follow in the same request: the idle connection time of the BLE connection mode, the RTC interrupt
+ * period of the therapy session and the test intervals of the state machine. A subscriber of a stimulation parameter
+ * must be notified by a write of the active therapy profile and by a profile select, and not by a write of an inactive
+ * profile. A request that changes no parameter must not read any, the modules use their copies.
+ * app_state.c subscribes to the RTC interrupt period as the therapy session does, it needs more of the HAL than the
+ * stubs have and is not linked.
+ * @copyright Copyright (c) 2024
+ */
+#include "app_mode_ble_connection.c"
+#include "app_mode_therapy_session.c"
+
+void __real_app_func_para_data_get(const uint8_t* p_id, uint8_t* p_data, uint8_t buff_size);
+
+static uint8_t fram[CY15B108QN_MAX_ADDR + 1UL];
+static uint8_t remote_user_class = USER_CLASS_ADMIN;
+static uint32_t para_read_num = 0;				/*!< The reads of the parameters from outside app_func_parameter.c */
+static uint32_t stim_notify_num = 0;
+static _Float64 stim_notify_val = 0.0;			/*!< The data read by the subscriber of the stimulation parameter */
+static const uint8_t* p_stim_id = NULL;
+static uint32_t failures = 0;
+
+#define CHECK_EQ(EXPECTED, ACTUAL, ...)											\
+	do {																		\
+		if ((EXPECTED) != (ACTUAL)) {											\
+			(void)printf("FAIL %s:%d expected %g, got %g: ", __FILE__, __LINE__, \
+					(double)(EXPECTED), (double)(ACTUAL));						\
+			(void)printf(__VA_ARGS__);											\
+			(void)printf("\n");													\
+			failures++;															\
+		}																		\
+	} while(0)
+
+extern int32_t impedance_test_hour_timer;
+extern int32_t battery_test_hour_timer;
+extern Parameter_t parameters_list[];
+extern const uint16_t parameters_list_size;
+
+/* ---- Fakes of the functions the modules call, all of them succeed ---- */
+
+uint8_t app_mode_ble_act_userclass_get(void) { return remote_user_class; }
+bool app_func_auth_verify_sign_admin(ECDSA_Data_t ecdsa_data) { return true; }
+uint8_t app_func_ble_curr_state_get(void) { return BLE_STATE_INVALID; }
+void app_func_ble_disconnect(void) { }
+void app_func_ble_enable(bool enable) { }
+void app_func_ble_new_state_get(void) { }
+void app_func_logs_erase(void) { }
+bool app_func_logs_event_search(const char* event_type) { return false; }
+void app_func_logs_event_write(const char* event_type, Log_Event_Write_Callback callback) { }
+void app_func_logs_flush(void) { }
+void app_func_logs_parameter_write(uint8_t* p_id, uint8_t data_format, const uint8_t* p_data, uint16_t data_len) { }
+uint8_t app_func_logs_read(const uint8_t* p_timestamp, uint8_t* p_data) { return 0; }
+void app_func_meas_batt_mon_enable(bool enable) { }
+void app_func_meas_batt_mon_meas(uint16_t* p_vbatA, uint16_t* p_vbatB) { *p_vbatA = 0; *p_vbatB = 0; }
+void app_func_meas_sensor_continue(void) { }
+void app_func_meas_sensor_enable(uint8_t sensorID, bool enable) { }
+void app_func_meas_sensor_sampling(uint8_t sensorID, uint8_t* buff, uint8_t bufferSize, float samplingFrequency_hz) { }
+void app_func_meas_vdda_sup_enable(bool enable) { }
+void app_func_stim_circuit_para1_set(Stimulus_Waveform_t stimulus_waveform) { }
+void app_func_stim_curr_src_set(Current_Sources_t current_sources) { }
+void app_func_stim_dac1_ramp_set(uint32_t ramp_up_duration_ms, uint32_t ramp_down_duration_ms, uint16_t voltage_mv) { }
+uint8_t app_func_stim_dac_init(void) { return HAL_OK; }
+uint8_t app_func_stim_dac_volt_set(uint16_t voltageA_mv, uint16_t voltageB_mv) { return HAL_OK; }
+uint8_t app_func_stim_hv_sup_volt_set(uint16_t voltage_mv) { return HAL_OK; }
+void app_func_stim_hv_supply_set(bool turnon, bool enable) { }
+_Float64 app_func_stim_iout_to_dac(_Float64 iout_mA) { return iout_mA; }
+void app_func_stim_mux_enable(bool enable) { }
+void app_func_stim_off(void) { }
+void app_func_stim_sel_set(Stim_Sel_t sel) { }
+void app_func_stim_sine_para_set(NerveBlock_Waveform_t nerveBlock_waveform) { }
+void app_func_stim_sine_start(void) { }
+void app_func_stim_stim1_start(bool imc_en) { }
+void app_func_stim_stimulus_enable(bool enable) { }
+void app_func_stim_sync(void) { }
+void app_func_stim_vdds_sup_enable(bool enable) { }
+void app_mode_battery_test_volt_abort(void) { }
+void app_mode_battery_test_volt_get(uint16_t* p_vbatA, uint16_t* p_vbatB) { *p_vbatA = 0; *p_vbatB = 0; }
+bool app_mode_battery_test_volt_step(uint16_t* p_vbatA, uint16_t* p_vbatB, uint8_t* p_progress) { return false; }
+uint8_t app_mode_dvt_acc_data_get(DeviceID_t deviceID, uint8_t* dataBuffer, uint8_t* dataSize) { *dataSize = 0; return STATUS_SUCCESS; }
+uint8_t app_mode_dvt_acc_start(FreqModeDeviceID_t freqModedeviceID, uint8_t* dataBuffer, uint8_t* dataSize) { *dataSize = 0; return STATUS_SUCCESS; }
+uint8_t app_mode_dvt_acc_stop(DeviceID_t deviceID, uint8_t* dataBuffer, uint8_t* dataSize) { *dataSize = 0; return STATUS_SUCCESS; }
+_Float64 app_mode_impedance_test_get(void) { return 0.0; }
+uint8_t app_mode_impedance_test_survey(uint16_t* p_imp_matrix) { return 0; }
+void app_mode_impedance_test_survey_abort(void) { }
+bool app_mode_impedance_test_survey_step(uint16_t* p_imp_matrix, uint8_t* p_pair_num, uint8_t* p_progress) { return false; }
+bool bsp_adc_sampling_is_completed(void) { return false; }
+bool bsp_sp_cmd_handler(void) { return true; }
+bool bsp_sp_cmd_is_pending(void) { return false; }
+bool bsp_sp_cmd_is_requested(void) { return false; }
+void bsp_sp_cmd_send(const uint8_t* data, uint8_t data_len) { }
+void bsp_wdg_refresh(void) { }
+
+void bsp_fram_write(uint32_t addr, const uint8_t* p_data, uint16_t data_len, bool waitfor_cplt) {
+	(void)memcpy(&fram[addr], p_data, data_len);
+}
+
+void bsp_fram_read(uint32_t addr, uint8_t* p_data, uint16_t data_len) {
+	(void)memcpy(p_data, &fram[addr], data_len);
+}
+
+/**
+ * @brief Count the reads of the parameters by the modules, the reads inside app_func_parameter.c are not wrapped
+ *
+ */
+void __wrap_app_func_para_data_get(const uint8_t* p_id, uint8_t* p_data, uint8_t buff_size) {
+	para_read_num++;
+	__real_app_func_para_data_get(p_id, p_data, buff_size);
+}
+
+/**
+ * @brief The subscriber of a stimulation parameter, as a mode that keeps a copy of it
+ *
+ */
+static void stim_para_change_cb(const uint8_t* p_id) {
+	stim_notify_num++;
+	app_func_para_data_get(p_id, (uint8_t*)&stim_notify_val, (uint8_t)sizeof(stim_notify_val));
+}
+
+/* ---- The requests ---- */
+
+/**
+ * @brief Send a request through the parser of the BLE connection mode, the response is prepared as app_func_command_parser does
+ *
+ * @return uint8_t The status of the response
+ */
+static uint8_t request(uint8_t opcode, uint8_t* p_payload, uint8_t len) {
+	static uint8_t resp_payload[LEN_RESP_PAYLOAD_MAX];
+	Cmd_Req_t req = {
+			.Opcode = opcode,
+			.Payload = p_payload,
+			.PayloadLen = len,
+	};
+	Cmd_Resp_t resp = {
+			.Opcode = opcode,
+			.Status = STATUS_SUCCESS,
+			.Payload = resp_payload,
+			.PayloadLen = 0,
+	};
+	app_mode_ble_conn_cmd_parser(&req, &resp);
+	return resp.Status;
+}
+
+/**
+ * @brief A number of steps of the parameter in its range, different from the data of the therapy profile if the range allows
+ *
+ */
+static uint16_t para_steps_next(uint8_t profile, const uint8_t* p_id) {
+	_Float64 val = 0.0;
+	app_func_para_profile_data_get(profile, p_id, (uint8_t*)&val, (uint8_t)sizeof(val));
+	_Float64 stepsize = app_func_para_stepsize_get(p_id);
+	uint16_t steps = (uint16_t)((val / stepsize) + 0.5);
+	if (app_func_para_val_in_range(p_id, (_Float64)(steps + 1U) * stepsize)) {
+		steps++;
+	}
+	else if (app_func_para_val_in_range(p_id, (_Float64)(steps - 1U) * stepsize)) {
+		steps--;
+	}
+	else {
+		//The range has a single value, the same data is written again
+	}
+	return steps;
+}
+
+/**
+ * @brief Put the ID and the steps of a value parameter into a request payload
+ *
+ * @return uint8_t The length put into the payload
+ */
+static uint8_t para_encode(uint8_t* p_payload, const uint8_t* p_id, uint16_t steps) {
+	(void)memcpy(p_payload, p_id, LEN_ID);
+	(void)memcpy(&p_payload[LEN_ID], (uint8_t*)&steps, sizeof(steps));
+	return (uint8_t)(LEN_ID + LEN_STEP);
+}
+
+/**
+ * @brief Write a hardware parameter over BLE and return the value the modules must now use
+ *
+ */
+static _Float64 hw_para_write(const char* p_id) {
+	uint8_t payload[LEN_ID + LEN_STEP];
+	uint16_t steps = para_steps_next(THERAPY_PROFILE_ACTIVE, (const uint8_t*)p_id);
+	uint8_t len = para_encode(payload, (const uint8_t*)p_id, steps);
+	CHECK_EQ(STATUS_SUCCESS, request(OP_WRITE_HARDWARE_PARAMETERS, payload, len), "WRITE_HARDWARE_PARAMETERS %.4s", p_id);
+	return (_Float64)steps * app_func_para_stepsize_get((const uint8_t*)p_id);
+}
+
+static void test_hw_para(void) {
+	//The idle timer of a connection that is open follows the new idle time at once
+	idle_connection_ms_timer = 1;
+	_Float64 idle_s = hw_para_write(HPID_BLE_IDLE_CONNECTION);
+	CHECK_EQ(idle_s * 1000.0, ble_idle_connection_f, "BLE connection mode idle time");
+	CHECK_EQ((int32_t)(idle_s * 1000.0), idle_connection_ms_timer, "BLE connection mode idle timer");
+
+	//The RTC interrupt period has a single value, so the copy is cleared to see it written again
+	rtc_interrupt_period = 0;
+	_Float64 period = hw_para_write(HPID_RTC_INTERRUPT_PERIOD);
+	CHECK_EQ((uint32_t)period, rtc_interrupt_period, "therapy session RTC interrupt period");
+
+	_Float64 interval = hw_para_write(HPID_IMPEDANCE_TEST_INTERVAL);
+	app_func_sm_impedance_timer_enable();
+	CHECK_EQ((int32_t)interval, impedance_test_hour_timer, "state machine impedance test timer");
+
+	//A batch notifies every parameter of it
+	uint8_t payload[2U * (LEN_ID + LEN_STEP)];
+	uint16_t steps_battery = para_steps_next(THERAPY_PROFILE_ACTIVE, (const uint8_t*)HPID_BATTERY_TEST_INTERVAL);
+	uint16_t steps_idle = para_steps_next(THERAPY_PROFILE_ACTIVE, (const uint8_t*)HPID_BLE_IDLE_CONNECTION);
+	uint8_t len = para_encode(payload, (const uint8_t*)HPID_BATTERY_TEST_INTERVAL, steps_battery);
+	len += para_encode(&payload[len], (const uint8_t*)HPID_BLE_IDLE_CONNECTION, steps_idle);
+	CHECK_EQ(STATUS_SUCCESS, request(OP_WRITE_PARAMETERS_BATCH, payload, len), "WRITE_PARAMETERS_BATCH");
+	app_func_sm_battery_timer_enable();
+	CHECK_EQ((int32_t)((_Float64)steps_battery * app_func_para_stepsize_get((const uint8_t*)HPID_BATTERY_TEST_INTERVAL)),
+			battery_test_hour_timer, "state machine battery test timer after a batch");
+	CHECK_EQ((_Float64)steps_idle * app_func_para_stepsize_get((const uint8_t*)HPID_BLE_IDLE_CONNECTION) * 1000.0,
+			ble_idle_connection_f, "BLE connection mode idle time after a batch");
+}
+
+static void test_profile_para(void) {
+	uint8_t active = app_func_para_profile_get();
+	uint8_t inactive = (uint8_t)((active + 1U) % THERAPY_PROFILE_NUM);
+	uint8_t payload[1U + LEN_ID + LEN_STEP];
+	_Float64 stepsize = app_func_para_stepsize_get(p_stim_id);
+
+	//A write of the active profile
+	uint16_t steps = para_steps_next(THERAPY_PROFILE_ACTIVE, p_stim_id);
+	uint8_t len = para_encode(payload, p_stim_id, steps);
+	uint32_t notify_num = stim_notify_num;
+	CHECK_EQ(STATUS_SUCCESS, request(OP_WRITE_STIMULATION_PARAMETERS, payload, len), "WRITE_STIMULATION_PARAMETERS");
+	CHECK_EQ(notify_num + 1U, stim_notify_num, "notifications of a write of the active profile");
+	CHECK_EQ((_Float64)steps * stepsize, stim_notify_val, "data of the active profile");
+	_Float64 val_active = stim_notify_val;
+
+	//A write of an inactive profile is kept for that profile only
+	payload[0] = inactive;
+	steps = para_steps_next(inactive, p_stim_id);
+	if ((_Float64)steps * stepsize == val_active) {
+		steps++;
+	}
+	len = (uint8_t)(1U + para_encode(&payload[1], p_stim_id, steps));
+	notify_num = stim_notify_num;
+	CHECK_EQ(STATUS_SUCCESS, request(OP_WRITE_THERAPY_PROFILE, payload, len), "WRITE_THERAPY_PROFILE of an inactive profile");
+	CHECK_EQ(notify_num, stim_notify_num, "notifications of a write of an inactive profile");
+	CHECK_EQ(val_active, stim_notify_val, "data of the active profile after a write of an inactive profile");
+	_Float64 val = 0.0;
+	app_func_para_profile_data_get(inactive, p_stim_id, (uint8_t*)&val, (uint8_t)sizeof(val));
+	CHECK_EQ((_Float64)steps * stepsize, val, "data of the inactive profile");
+
+	//The same request for the active profile notifies
+	payload[0] = active;
+	notify_num = stim_notify_num;
+	CHECK_EQ(STATUS_SUCCESS, request(OP_WRITE_THERAPY_PROFILE, payload, len), "WRITE_THERAPY_PROFILE of the active profile");
+	CHECK_EQ(notify_num + 1U, stim_notify_num, "notifications of a write of the active profile by its index");
+	CHECK_EQ((_Float64)steps * stepsize, stim_notify_val, "data of the active profile written by its index");
+
+	//Selecting the other profile gives its data to the subscriber
+	uint16_t steps_other = para_steps_next(inactive, p_stim_id);
+	payload[0] = inactive;
+	len = (uint8_t)(1U + para_encode(&payload[1], p_stim_id, steps_other));
+	CHECK_EQ(STATUS_SUCCESS, request(OP_WRITE_THERAPY_PROFILE, payload, len), "WRITE_THERAPY_PROFILE before the select");
+	notify_num = stim_notify_num;
+	CHECK_EQ(STATUS_SUCCESS, request(OP_SELECT_THERAPY_PROFILE, &inactive, 1U), "SELECT_THERAPY_PROFILE");
+	CHECK_EQ(notify_num + 1U, stim_notify_num, "notifications of a profile select");
+	CHECK_EQ((_Float64)steps_other * stepsize, stim_notify_val, "data of the selected profile");
+	CHECK_EQ(inactive, app_func_para_profile_get(), "active profile after the select");
+}
+
+static void test_hot_path(void) {
+	//Selecting the active profile again changes nothing, so neither the parser nor a subscriber reads a parameter
+	uint8_t active = app_func_para_profile_get();
+	para_read_num = 0;
+	for (uint32_t i = 0; i < 100U; i++) {
+		CHECK_EQ(STATUS_SUCCESS, request(OP_SELECT_THERAPY_PROFILE, &active, 1U), "SELECT_THERAPY_PROFILE of the active profile");
+	}
+	CHECK_EQ(0U, para_read_num, "parameter reads in 100 requests that change no parameter");
+}
+
+int main(void) {
+	(void)memset(fram, 0xFF, sizeof(fram));
+	app_func_para_init();
+	app_func_sm_init();
+	app_mode_therapy_init();
+	app_mode_ble_conn_init();
+
+	for (uint16_t i = 0; (i < parameters_list_size) && (p_stim_id == NULL); i++) {
+		if (app_func_para_profile_contains(parameters_list[i].id) && (app_func_para_datatype_get(parameters_list[i].id) == FORMAT_TYPE_VALUE)) {
+			p_stim_id = parameters_list[i].id;
+		}
+	}
+	if (p_stim_id == NULL) {
+		(void)printf("FAIL: no stimulation parameter with a value\n");
+		return 1;
+	}
+	(void)app_func_para_subscribe(p_stim_id, &stim_para_change_cb);
+
+	test_hw_para();
+	test_profile_para();
+	test_hot_path();
+
+	(void)printf("test_para_notify: %lu failures\n", (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
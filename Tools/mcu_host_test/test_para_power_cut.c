@@ -0,0 +1,296 @@
+/**
+ * @file test_para_power_cut.c
+ * @brief Power-cut test of the therapy profiles in the parameter image, against the real app_func_parameter.c
+ *
+ * Each operation on the parameters is run once to count the bytes it writes to FRAM, then again from the same state
+ * with the power cut after every byte of it: the write in progress stops at that byte and nothing after it runs. The
+ * firmware then boots with app_func_para_init, which is itself cut at a few points of its repair and booted again.
+ * After the last boot every parameter of every therapy profile and the active profile must be all as before or all as
+ * after the operation, and the base and backup copies in FRAM must be identical. The operations are a profile select,
+ * a set of a stimulation parameter of the active profile, a batch of an inactive profile and a set of a shared parameter.
+ * The time of a profile select is reported against copying the stimulation parameters of a profile, at 5 MHz SPI.
+ * @copyright Copyright (c) 2024
+ */
+#include <setjmp.h>
+#include <stdio.h>
+#include "app_config.h"
+
+#define SIM_SPI_BYTE_US			1.6			/*!< One byte at 5 MHz SPI */
+#define SIM_FRAM_STAGE_US		1.0			/*!< The interrupt and chip select of each SPI stage of a write */
+#define SIM_CRC_BYTE_US			0.025		/*!< One byte through HAL_CRC_Calculate, 4 cycles at 160 MHz */
+#define SIM_REPAIR_CUT_STEP		97U			/*!< The repair at boot is cut every this many bytes, and at its last bytes */
+#define SIM_LEN_PARA_IMAGE_CRC	2U			/*!< LEN_PARA_IMAGE_CRC of app_func_parameter.c */
+#define SIM_PROFILE_PARA_MAX	64U
+#define SIM_STATE_SIZE			(1U + (THERAPY_PROFILE_NUM * LEN_PARA_DATA_MAX))
+
+typedef struct {
+	const char*	Name;
+	void		(*Run)(void);
+} Op_t;
+
+extern Parameter_t parameters_list[];
+extern const uint16_t parameters_list_size;
+
+static uint8_t fram[2U * SIZE_PARA];
+static uint8_t fram_before[2U * SIZE_PARA];
+static double fram_us = 0.0;
+static uint32_t fram_bytes = 0;				/*!< The bytes written since the last reset of the count */
+static bool cut_armed = false;
+static uint32_t cut_budget = 0;				/*!< The bytes written before the power is cut */
+static jmp_buf cut_jmp;
+
+static const uint8_t* profile_ids[SIM_PROFILE_PARA_MAX];
+static uint8_t profile_id_num = 0;
+static const uint8_t* shared_id = NULL;
+static uint8_t op_seed = 0;
+static uint32_t failures = 0;
+
+void bsp_fram_write(uint32_t addr, const uint8_t* p_data, uint16_t data_len, bool waitfor_cplt) {
+	if ((addr < ADDR_PARA_BASE) || ((addr + data_len) > (ADDR_PARA_BASE + sizeof(fram)))) {
+		(void)printf("FAIL bsp_fram_write: 0x%05lX + %u is out of the parameters\n", (unsigned long)addr, data_len);
+		failures++;
+		return;
+	}
+	uint16_t len = data_len;
+	if (cut_armed && (cut_budget < len)) {
+		len = (uint16_t)cut_budget;
+	}
+	(void)memcpy(&fram[addr - ADDR_PARA_BASE], p_data, len);
+	fram_us += (3.0 * SIM_FRAM_STAGE_US) + ((1.0 + 4.0 + (double)data_len) * SIM_SPI_BYTE_US);
+	fram_bytes += len;
+	if (cut_armed) {
+		cut_budget -= len;
+		if (len < data_len) {
+			cut_armed = false;
+			longjmp(cut_jmp, 1);
+		}
+	}
+}
+
+void bsp_fram_read(uint32_t addr, uint8_t* p_data, uint16_t data_len) {
+	if ((addr < ADDR_PARA_BASE) || ((addr + data_len) > (ADDR_PARA_BASE + sizeof(fram)))) {
+		(void)memset(p_data, 0, data_len);
+		return;
+	}
+	(void)memcpy(p_data, &fram[addr - ADDR_PARA_BASE], data_len);
+	fram_us += SIM_FRAM_STAGE_US + ((4.0 + (double)data_len) * SIM_SPI_BYTE_US);
+}
+
+/**
+ * @brief Run a function with the power cut after the given number of bytes written
+ *
+ * @return true The power was cut before the function returned
+ */
+static bool sim_run_cut(void (*run)(void), uint32_t budget) {
+	cut_budget = budget;
+	cut_armed = true;
+	if (setjmp(cut_jmp) != 0) {
+		return true;
+	}
+	run();
+	cut_armed = false;
+	return false;
+}
+
+/**
+ * @brief The active profile and the data of every parameter of every therapy profile, as the firmware reads them
+ *
+ */
+static void sim_state_get(uint8_t* p_state) {
+	uint32_t pos = 0;
+	p_state[pos++] = app_func_para_profile_get();
+	for (uint8_t p = 0; p < THERAPY_PROFILE_NUM; p++) {
+		for (uint16_t i = 0; i < parameters_list_size; i++) {
+			uint8_t datalen = app_func_para_datalen_get(parameters_list[i].id);
+			app_func_para_profile_data_get(p, parameters_list[i].id, &p_state[pos], datalen);
+			pos += datalen;
+		}
+	}
+}
+
+static void sim_pattern(uint8_t* p_data, uint8_t datalen, uint8_t seed) {
+	for (uint8_t i = 0; i < datalen; i++) {
+		p_data[i] = (uint8_t)((seed * 31U) + (i * 7U) + 1U);
+	}
+}
+
+static void op_profile_select(void) {
+	(void)app_func_para_profile_select((uint8_t)((app_func_para_profile_get() + 1U) % THERAPY_PROFILE_NUM));
+}
+
+static void op_profile_para_set(void) {
+	uint8_t data[UINT8_MAX];
+	sim_pattern(data, app_func_para_datalen_get(profile_ids[0]), op_seed);
+	app_func_para_data_set(profile_ids[0], data);
+}
+
+static void op_inactive_batch_set(void) {
+	static uint8_t datas[SIM_PROFILE_PARA_MAX][UINT8_MAX];
+	const uint8_t* p_datas[SIM_PROFILE_PARA_MAX];
+	for (uint8_t i = 0; i < profile_id_num; i++) {
+		sim_pattern(datas[i], app_func_para_datalen_get(profile_ids[i]), (uint8_t)(op_seed + i));
+		p_datas[i] = datas[i];
+	}
+	uint8_t profile = (uint8_t)((app_func_para_profile_get() + 2U) % THERAPY_PROFILE_NUM);
+	app_func_para_profile_data_set_batch(profile, profile_ids, p_datas, profile_id_num);
+}
+
+static void op_shared_para_set(void) {
+	uint8_t data[UINT8_MAX];
+	sim_pattern(data, app_func_para_datalen_get(shared_id), op_seed);
+	app_func_para_data_set(shared_id, data);
+}
+
+/**
+ * @brief The base and backup copies of the parameter image with their CRC must be identical
+ *
+ */
+static bool sim_copies_equal(void) {
+	Parameter_Image_Header_t header;
+	(void)memcpy(&header, fram, sizeof(header));
+	uint32_t len = sizeof(header) + header.DataLen + SIM_LEN_PARA_IMAGE_CRC;
+	return (len <= SIZE_PARA) && (memcmp(fram, &fram[SIZE_PARA], len) == 0);
+}
+
+/**
+ * @brief Cut the operation after every byte it writes, then check the boot finds it all done or not done at all
+ *
+ * @return uint32_t The bytes written by the operation
+ */
+static uint32_t sim_op_check(const Op_t* p_op) {
+	static uint8_t state_before[SIM_STATE_SIZE];
+	static uint8_t state_after[SIM_STATE_SIZE];
+	static uint8_t state[SIM_STATE_SIZE];
+
+	//The operation runs without a cut, to know the state after it and the bytes it writes
+	(void)memcpy(fram_before, fram, sizeof(fram));
+	app_func_para_init();
+	sim_state_get(state_before);
+	fram_bytes = 0;
+	p_op->Run();
+	uint32_t op_bytes = fram_bytes;
+	sim_state_get(state_after);
+	if (memcmp(state_before, state_after, SIM_STATE_SIZE) == 0) {
+		(void)printf("FAIL %s: the operation changes nothing\n", p_op->Name);
+		failures++;
+	}
+	static uint8_t fram_after[sizeof(fram)];
+	(void)memcpy(fram_after, fram, sizeof(fram));
+
+	uint32_t cut_num = 0;
+	for (uint32_t cut = 0; cut < op_bytes; cut++) {
+		(void)memcpy(fram, fram_before, sizeof(fram));
+		app_func_para_init();
+		if (!sim_run_cut(p_op->Run, cut)) {
+			(void)printf("FAIL %s: not cut after %lu of %lu bytes\n", p_op->Name, (unsigned long)cut, (unsigned long)op_bytes);
+			failures++;
+		}
+		//The boot is cut too, at points of its repair, before the one that completes
+		static uint8_t fram_cut[sizeof(fram)];
+		(void)memcpy(fram_cut, fram, sizeof(fram));
+		fram_bytes = 0;
+		app_func_para_init();
+		uint32_t repair_bytes = fram_bytes;
+		for (uint32_t repair_cut = 0; repair_cut < repair_bytes; repair_cut++) {
+			if (((repair_cut % SIM_REPAIR_CUT_STEP) != 0U) && ((repair_cut + 3U) < repair_bytes)) {
+				continue;
+			}
+			(void)memcpy(fram, fram_cut, sizeof(fram));
+			(void)sim_run_cut(&app_func_para_init, repair_cut);
+			app_func_para_init();
+			sim_state_get(state);
+			if ((memcmp(state, state_before, SIM_STATE_SIZE) != 0) && (memcmp(state, state_after, SIM_STATE_SIZE) != 0)) {
+				(void)printf("FAIL %s: cut after %lu bytes and the repair after %lu, the boot finds a mixed state\n",
+						p_op->Name, (unsigned long)cut, (unsigned long)repair_cut);
+				failures++;
+			}
+			cut_num++;
+		}
+		(void)memcpy(fram, fram_cut, sizeof(fram));
+		app_func_para_init();
+		sim_state_get(state);
+		if ((memcmp(state, state_before, SIM_STATE_SIZE) != 0) && (memcmp(state, state_after, SIM_STATE_SIZE) != 0)) {
+			(void)printf("FAIL %s: cut after %lu of %lu bytes, the boot finds a mixed state\n", p_op->Name,
+					(unsigned long)cut, (unsigned long)op_bytes);
+			failures++;
+		}
+		if (!sim_copies_equal()) {
+			(void)printf("FAIL %s: cut after %lu bytes, the copies differ after the boot\n", p_op->Name, (unsigned long)cut);
+			failures++;
+		}
+		cut_num++;
+	}
+	(void)printf("  %-26s %6lu bytes %8lu cuts\n", p_op->Name, (unsigned long)op_bytes, (unsigned long)cut_num);
+
+	(void)memcpy(fram, fram_after, sizeof(fram));
+	return op_bytes;
+}
+
+int main(void) {
+	const Op_t ops[] = {
+		{"profile select",				&op_profile_select},
+		{"active profile parameter",	&op_profile_para_set},
+		{"inactive profile batch",		&op_inactive_batch_set},
+		{"shared parameter",			&op_shared_para_set},
+	};
+
+	(void)memset(fram, 0xFF, sizeof(fram));
+	app_func_para_init();
+	for (uint16_t i = 0; i < parameters_list_size; i++) {
+		if (app_func_para_profile_contains(parameters_list[i].id)) {
+			if (profile_id_num < SIM_PROFILE_PARA_MAX) {
+				profile_ids[profile_id_num++] = parameters_list[i].id;
+			}
+		}
+		else if ((shared_id == NULL) && (memcmp(parameters_list[i].id, HPID_IPG_FW_VERSION, LEN_ID) != 0)) {
+			shared_id = parameters_list[i].id;
+		}
+	}
+	if ((profile_id_num == 0U) || (shared_id == NULL)) {
+		(void)printf("FAIL: no stimulation or shared parameter in the list\n");
+		return 1;
+	}
+
+	//Every profile gets its own stimulation parameters, so a wrong profile is seen
+	for (uint8_t p = 0; p < THERAPY_PROFILE_NUM; p++) {
+		op_seed = (uint8_t)(0x40U + (p * 0x10U));
+		static uint8_t datas[SIM_PROFILE_PARA_MAX][UINT8_MAX];
+		const uint8_t* p_datas[SIM_PROFILE_PARA_MAX];
+		for (uint8_t i = 0; i < profile_id_num; i++) {
+			sim_pattern(datas[i], app_func_para_datalen_get(profile_ids[i]), (uint8_t)(op_seed + i));
+			p_datas[i] = datas[i];
+		}
+		app_func_para_profile_data_set_batch(p, profile_ids, p_datas, profile_id_num);
+	}
+
+	(void)printf("test_para_power_cut: %u therapy profiles of %u stimulation parameters\n", THERAPY_PROFILE_NUM, profile_id_num);
+	for (uint32_t o = 0; o < (sizeof(ops) / sizeof(ops[0])); o++) {
+		op_seed = (uint8_t)(0x90U + o);
+		(void)sim_op_check(&ops[o]);
+	}
+
+	//The profile select writes the profile index only, a copy of the stimulation parameters writes the whole profile
+	app_func_para_init();
+	fram_us = 0.0;
+	fram_bytes = 0;
+	hal_stub_crc_bytes = 0;
+	op_profile_select();
+	double select_us = fram_us + ((double)hal_stub_crc_bytes * SIM_CRC_BYTE_US);
+	uint32_t select_bytes = fram_bytes;
+	fram_us = 0.0;
+	fram_bytes = 0;
+	hal_stub_crc_bytes = 0;
+	op_seed++;
+	op_inactive_batch_set();
+	double copy_us = fram_us + ((double)hal_stub_crc_bytes * SIM_CRC_BYTE_US);
+	uint32_t copy_bytes = fram_bytes;
+	(void)printf("  profile switch: select %.1f us and %lu bytes, copy of a profile %.1f us and %lu bytes\n",
+			select_us, (unsigned long)select_bytes, copy_us, (unsigned long)copy_bytes);
+	if (select_bytes != (2U * (sizeof(uint8_t) + SIM_LEN_PARA_IMAGE_CRC))) {
+		(void)printf("FAIL profile switch: %lu bytes written\n", (unsigned long)select_bytes);
+		failures++;
+	}
+
+	(void)printf("test_para_power_cut: %lu failures\n", (unsigned long)failures);
+	return (failures == 0U) ? 0 : 1;
+}
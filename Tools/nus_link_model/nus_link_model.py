@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""
+OpenNerve IPG Gen2 — NUS Forwarding Link Model
+Firmware source: FW-BLE/app/app_sp.c :: app_sp_ble_handler()
+
+Estimates the highest rate of MCU frames the nRF52810 forwards to the central
+without losing a frame or holding the MCU back, for the forwarding path before
+and after the SoftDevice retry, with and without packing:
+
+  BEFORE   one notification per main-loop pass, the frame is dropped when the
+           SoftDevice has no room, event length of NRF_SDH_BLE_GAP_EVENT_LENGTH
+  AFTER    notifications are sent until NRF_ERROR_RESOURCES and the frames are
+           kept for a retry, the connection event length extension is enabled
+  PACKED   AFTER, with consecutive frames packed up to the data length
+           (APP_BLE_NUS_PACK_ENABLE, off by default)
+
+Link model (1M PHY, data length extension, defaults can be changed on the
+command line):
+  - a notification of n bytes takes (n + 17) * 8 us on air, plus the empty ack
+    and two inter-frame spaces (380 us)
+  - the SoftDevice takes SD_QUEUE notifications before NRF_ERROR_RESOURCES;
+    the real number depends on the event length and is to be measured on the board
+  - every HVN_TX_COMPLETE runs the main loop once, so the forwarding buffer is
+    sent from again within the same connection event
+  - the forwarding buffer holds DATA_BUFFER_GROUP_COUNT frames; a frame that
+    does not fit would hold the MCU, and counts as a failure of the rate
+"""
+
+import argparse
+
+DATA_LEN = 244                  # ATT payload of a notification at MTU 247
+EVENT_LENGTH_US = 7500          # NRF_SDH_BLE_GAP_EVENT_LENGTH 6, in 1.25 ms units
+FWD_FRAMES = 10                 # DATA_BUFFER_GROUP_COUNT
+
+CASES = [
+    # (frame bytes, connection interval ms)
+    (206, 7.5), (206, 15.0), (206, 20.0),
+    (40, 7.5), (40, 15.0), (40, 20.0),
+]
+
+MODES = ("BEFORE", "AFTER", "PACKED")
+
+
+# ── Model ────────────────────────────────────────────────────────────────────
+
+def packet_us(length, overhead_us):
+    return (length + 17) * 8 + overhead_us
+
+
+def run(mode, ci_ms, frame_len, period_us, sd_queue, overhead_us, duration_s):
+    """Return True when every frame offered at the period is sent, none dropped or held."""
+    ci_us = int(ci_ms * 1000)
+    event_us = ci_us if mode != "BEFORE" else min(ci_us, EVENT_LENGTH_US)
+    fwd = []                    # lengths of the frames in the forwarding buffer
+    sd = []                     # lengths of the notifications queued in the SoftDevice
+    failed = False
+
+    def handler():
+        nonlocal failed
+        while fwd:
+            size = fwd[0]
+            count = 1
+            if mode == "PACKED":
+                while count < len(fwd) and size + fwd[count] <= DATA_LEN:
+                    size += fwd[count]
+                    count += 1
+            if len(sd) >= sd_queue:
+                if mode == "BEFORE":
+                    fwd.pop(0)
+                    failed = True
+                return
+            sd.append(size)
+            del fwd[:count]
+            if mode == "BEFORE":
+                return
+
+    end_us = duration_s * 1_000_000
+    next_frame = 0
+    next_event = 0
+    while next_frame < end_us and not failed:
+        if next_frame <= next_event:
+            next_frame += period_us
+            if len(fwd) >= FWD_FRAMES:
+                return False
+            fwd.append(frame_len)
+            handler()
+        else:
+            next_event += ci_us
+            air_us = 0
+            while sd and air_us + packet_us(sd[0], overhead_us) <= event_us:
+                air_us += packet_us(sd.pop(0), overhead_us)
+                handler()       # BLE_GATTS_EVT_HVN_TX_COMPLETE wakes the main loop
+    return not failed
+
+
+def best_rate(mode, ci_ms, frame_len, sd_queue, overhead_us, duration_s):
+    """Return the highest forwarded rate in kB/s, over frame periods in 50 us steps."""
+    best = 0.0
+    for period_us in range(20000, 199, -50):
+        if run(mode, ci_ms, frame_len, period_us, sd_queue, overhead_us, duration_s):
+            best = max(best, frame_len / period_us * 1000.0)
+    return best
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Highest frame rate the NUS forwarding path sustains.")
+    parser.add_argument("--sd-queue", type=int, default=3,
+                        help="notifications the SoftDevice takes before NRF_ERROR_RESOURCES (default: 3)")
+    parser.add_argument("--overhead-us", type=float, default=380.0,
+                        help="radio time of the empty ack and the inter-frame spaces (default: 380)")
+    parser.add_argument("--duration-s", type=int, default=10,
+                        help="simulated time of each rate (default: 10)")
+    args = parser.parse_args()
+
+    print(f"  {'Frame':>6} {'CI':>7} " + " ".join(f"{m:>11}" for m in MODES))
+    print(f"  {'-' * 6} {'-' * 7} " + " ".join("-" * 11 for _ in MODES))
+    for frame_len, ci_ms in CASES:
+        rates = [best_rate(m, ci_ms, frame_len, args.sd_queue, args.overhead_us, args.duration_s) for m in MODES]
+        print(f"  {frame_len:>4} B {ci_ms:>4.1f} ms " + " ".join(f"{r:>6.1f} kB/s" for r in rates))
+
+
+if __name__ == "__main__":
+    main()
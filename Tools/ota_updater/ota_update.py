@@ -104,6 +104,10 @@ OP_AUTH              = 0xF0
 OP_AUTH_FW_IMAGE     = 0xF3
 OP_DOWNLOAD_FW_IMAGE = 0xF4
 OP_VERIFY_FW_IMAGE   = 0xF5
+OP_JOB_START         = 0xB8
+OP_JOB_STATUS        = 0xB9
+OP_JOB_NOTIFY        = 0xBB     # device → client only, never a reply to a request
+OP_SEQ               = 0xBC
 
 # ── Status codes ──────────────────────────────────────────────────────────────
 STATUS_SUCCESS         = 0x00
@@ -112,14 +116,32 @@ STATUS_CRC_ERR         = 0xF0
 STATUS_PAYLOAD_LEN_ERR = 0xF1
 STATUS_OPCODE_ERR      = 0xF2
 STATUS_USER_CLASS_ERR  = 0xF3
+STATUS_BUSY            = 0xF4
 
 USER_CLASS_ADMIN = 0xFF
 
+# ── Jobs (from app_func_job.h) ────────────────────────────────────────────────
+# OP_JOB_START [opcode][payload] is acknowledged at once with the job information
+# [job id][opcode][state][progress]; OP_JOB_NOTIFY carries the same information
+# on progress and, when the job is done, the result of the command after it.
+JOB_INFO_LEN      = 4
+JOB_STATE_RUNNING = 0x01
+JOB_STATE_DONE    = 0x02
+JOB_STATE_ABORTED = 0x03
+
+# ── Sequence numbers (from app_func_command.h) ────────────────────────────────
+# OP_SEQ [seq][opcode][payload] carries another command and is answered with
+# [seq][opcode][payload of the response], so several commands can be outstanding
+# and their responses matched. Firmware without it answers OPCODE_ERROR.
+SEQ_HEADER_LEN  = 2
+PIPELINE_WINDOW = 4             # commands outstanding, the device queues up to 4 responses
+
 # ── Protocol constants ────────────────────────────────────────────────────────
 FRAM_MAX_SIZE       = 262_144   # 256 KB maximum firmware image size
 CHUNK_SIZE          = 128       # bytes per download packet (OP_DOWNLOAD_FW_IMAGE)
 CMD_TIMEOUT_S       = 30.0      # seconds to wait for a response
 VERIFY_TIMEOUT_S    = 30.0      # verify can be slow (device computes SHA-256 of FRAM)
+JOB_POLL_S          = 5.0       # poll OP_JOB_STATUS when no OP_JOB_NOTIFY arrives for this long
 MAX_VERIFY_ATTEMPTS = 3
 DEFAULT_DEVICE_NAME = "CARSS"
 
@@ -142,6 +164,7 @@ _STATUS_NAMES = {
     STATUS_PAYLOAD_LEN_ERR: "PAYLOAD_LEN_ERROR",
     STATUS_OPCODE_ERR:      "OPCODE_ERROR",
     STATUS_USER_CLASS_ERR:  "USER_CLASS_ERROR",
+    STATUS_BUSY:            "BUSY",
 }
 
 
@@ -162,6 +185,31 @@ def _build_packet(opcode: int, payload: bytes) -> bytes:
     return header + payload + struct.pack("<H", crc)
 
 
+def _download_payload(firmware_bytes: bytes, offset: int) -> bytes:
+    """Payload of OP_DOWNLOAD_FW_IMAGE: offset(4 LE) + data(CHUNK_SIZE), the last chunk zero-padded."""
+    chunk = firmware_bytes[offset : offset + CHUNK_SIZE]
+    return struct.pack("<I", offset) + chunk.ljust(CHUNK_SIZE, b"\x00")
+
+
+def _split_responses(data: bytes) -> list[bytes]:
+    """
+    Split a notification into response packets of [opcode][len][status][payload][crc16].
+    Trailing bytes that do not form a whole packet are kept as the last item, so
+    _parse_response reports them.
+    """
+    frames = []
+    offset = 0
+    while len(data) - offset >= 5:
+        size = 5 + data[offset + 1]
+        if len(data) - offset < size:
+            break
+        frames.append(data[offset : offset + size])
+        offset += size
+    if offset < len(data):
+        frames.append(data[offset:])
+    return frames
+
+
 def _parse_response(data: bytes) -> tuple[int, int, bytes]:
     """
     Parse a response packet. Returns (opcode, status, payload).
@@ -234,12 +282,24 @@ class OTASession:
         self._client = client
         self._private_key = private_key
         self._rx_queue: asyncio.Queue[bytes] = asyncio.Queue()
+        self._job_queue: asyncio.Queue[bytes] = asyncio.Queue()
+        self._seq_queue: asyncio.Queue[bytes] = asyncio.Queue()
+        self._seq_supported: "bool | None" = None
         self._disc_event = disc_event or asyncio.Event()
         self._last_good_offset: int = 0
 
     def _on_notify(self, _sender: object, data: bytearray) -> None:
         #print(f"  [dbg] notification received: {bytes(data).hex()}")
-        self._rx_queue.put_nowait(bytes(data))
+        # The device may pack several responses into one notification; split them by length.
+        # Job notifications are not replies, so they are kept apart from the responses,
+        # and so are the responses of pipelined commands, matched by their sequence number.
+        for frame in _split_responses(bytes(data)):
+            if frame[0] == OP_JOB_NOTIFY:
+                self._job_queue.put_nowait(frame)
+            elif frame[0] == OP_SEQ:
+                self._seq_queue.put_nowait(frame)
+            else:
+                self._rx_queue.put_nowait(frame)
         #print("[dbg]Put byte in queue")
 
     async def _reinitialize(self) -> None:
@@ -299,7 +359,20 @@ class OTASession:
         Raises TimeoutError on timeout, _OadDisconnectedError on BLE disconnect,
         ValueError on CRC/opcode mismatch.
         """
-        packet = _build_packet(opcode, payload)
+        await self._write(_build_packet(opcode, payload))
+        raw = await self._receive(self._rx_queue, timeout, f"response to opcode 0x{opcode:02X}")
+        resp_opcode, status, resp_payload = _parse_response(raw)
+        if resp_opcode != opcode:
+            raise ValueError(
+                f"Opcode mismatch: sent 0x{opcode:02X}, received 0x{resp_opcode:02X}"
+            )
+        return status, resp_payload
+
+    async def _write(self, packet: bytes) -> None:
+        """
+        Write one packet to the device without waiting for its response.
+        Raises _OadDisconnectedError on BLE disconnect.
+        """
         try:
             await self._client.write_gatt_char(NUS_RX_CHAR_UUID, packet, response=False)
         except BleakError as e:
@@ -311,8 +384,23 @@ class OTASession:
         except asyncio.TimeoutError:
             pass  # write-without-response delivered; response may already be queued
 
+    async def _probe_seq(self) -> bool:
+        """
+        Check whether the device takes OP_SEQ, by asking the status of job 0, which never exists.
+        Firmware with sequence numbers echoes them; older firmware answers OPCODE_ERROR without them.
+        """
+        await self._write(_build_packet(OP_SEQ, bytes([0, OP_JOB_STATUS, 0])))
+        raw = await self._receive(self._seq_queue, CMD_TIMEOUT_S, "response to OP_SEQ")
+        _, _, resp_payload = _parse_response(raw)
+        return len(resp_payload) >= SEQ_HEADER_LEN and resp_payload[:SEQ_HEADER_LEN] == bytes([0, OP_JOB_STATUS])
+
+    async def _receive(self, queue: "asyncio.Queue[bytes]", timeout: float, what: str) -> bytes:
+        """
+        Wait for the next frame in `queue`.
+        Raises TimeoutError on timeout, _OadDisconnectedError on BLE disconnect.
+        """
         # Race: response notification vs. BLE disconnect event.
-        rx_task   = asyncio.ensure_future(self._rx_queue.get())
+        rx_task   = asyncio.ensure_future(queue.get())
         disc_task = asyncio.ensure_future(self._disc_event.wait())
         try:
             done, _ = await asyncio.wait(
@@ -328,20 +416,37 @@ class OTASession:
                 disc_task.cancel()
 
         if not done:
-            raise TimeoutError(f"No response to opcode 0x{opcode:02X} within {timeout:.0f}s")
+            raise TimeoutError(f"No {what} within {timeout:.0f}s")
 
         # If we got a real response AND a disconnect simultaneously, prefer the response.
         if rx_task in done:
-            raw = rx_task.result()
-        else:
-            raise _OadDisconnectedError(self._last_good_offset)
+            return rx_task.result()
+        raise _OadDisconnectedError(self._last_good_offset)
 
-        resp_opcode, status, resp_payload = _parse_response(raw)
-        if resp_opcode != opcode:
-            raise ValueError(
-                f"Opcode mismatch: sent 0x{opcode:02X}, received 0x{resp_opcode:02X}"
-            )
-        return status, resp_payload
+    async def _wait_job(self, job_id: int, timeout: float) -> tuple[int, int, bytes]:
+        """
+        Wait until the job finishes, showing its progress.
+        Returns (state, status, result_payload); state is JOB_STATE_DONE or JOB_STATE_ABORTED.
+        The device sends only the latest notification, so the status is polled when none arrives.
+        """
+        loop = asyncio.get_running_loop()
+        deadline = loop.time() + timeout
+        while True:
+            remaining = deadline - loop.time()
+            if remaining <= 0:
+                raise TimeoutError(f"Job {job_id} not finished within {timeout:.0f}s")
+            try:
+                raw = await self._receive(self._job_queue, min(JOB_POLL_S, remaining), "job notification")
+                _, status, payload = _parse_response(raw)
+            except TimeoutError:
+                status, payload = await self._send(OP_JOB_STATUS, bytes([job_id]))
+            if len(payload) < JOB_INFO_LEN or payload[0] != job_id:
+                continue
+            state, progress = payload[2], payload[3]
+            _print_progress(progress, 100, unit="%")
+            if state != JOB_STATE_RUNNING:
+                print()
+                return state, status, payload[JOB_INFO_LEN:]
 
     async def authenticate_admin(self) -> None:
         """
@@ -451,6 +556,9 @@ class OTASession:
 
         start_offset > 0 skips already-written FRAM pages (idempotent write means
         re-sending them is safe, but skipping saves time).
+
+        When the device takes OP_SEQ, PIPELINE_WINDOW packets are kept outstanding
+        instead of waiting for each response in turn.
         """
         image_size = len(firmware_bytes)
         total_packets = math.ceil(image_size / CHUNK_SIZE)
@@ -458,10 +566,14 @@ class OTASession:
         offset = (start_offset // CHUNK_SIZE) * CHUNK_SIZE
         packet_num = offset // CHUNK_SIZE
         self._last_good_offset = offset
+        if self._seq_supported is None:
+            self._seq_supported = await self._probe_seq()
+        if self._seq_supported:
+            await self._download_pipelined(firmware_bytes, offset)
+            print()  # newline after progress bar
+            return
         while offset < image_size:
-            chunk = firmware_bytes[offset : offset + CHUNK_SIZE]
-            chunk = chunk.ljust(CHUNK_SIZE, b"\x00")
-            pkt_payload = struct.pack("<I", offset) + chunk
+            pkt_payload = _download_payload(firmware_bytes, offset)
             for attempt in range(3):
                 try:
                     status, _ = await self._send(OP_DOWNLOAD_FW_IMAGE, pkt_payload)
@@ -490,15 +602,88 @@ class OTASession:
             _print_progress(packet_num, total_packets)
         print()  # newline after progress bar
 
+    async def _download_pipelined(self, firmware_bytes: bytes, offset: int) -> None:
+        """
+        Download from `offset` with up to PIPELINE_WINDOW OP_SEQ packets outstanding.
+        The responses may come in any order; a failed or timed-out packet is sent
+        again like in download_firmware, while the others stay outstanding.
+        _last_good_offset only advances over packets acknowledged without a gap.
+        """
+        loop = asyncio.get_running_loop()
+        image_size = len(firmware_bytes)
+        total_packets = math.ceil(image_size / CHUNK_SIZE)
+        packet_num = offset // CHUNK_SIZE
+        pending: dict[int, tuple[int, int, float]] = {}    # seq -> (offset, attempt, deadline)
+        retries: list[tuple[int, int]] = []
+        acked: set[int] = set()
+        seq = 0
+        while offset < image_size or pending or retries:
+            while len(pending) < PIPELINE_WINDOW and (retries or offset < image_size):
+                if retries:
+                    pkt_offset, attempt = retries.pop(0)
+                else:
+                    pkt_offset, attempt = offset, 0
+                    offset += CHUNK_SIZE
+                payload = bytes([seq, OP_DOWNLOAD_FW_IMAGE]) + _download_payload(firmware_bytes, pkt_offset)
+                await self._write(_build_packet(OP_SEQ, payload))
+                pending[seq] = (pkt_offset, attempt, loop.time() + CMD_TIMEOUT_S)
+                seq = (seq + 1) & 0xFF
+
+            oldest = min(pending, key=lambda k: pending[k][2])
+            try:
+                raw = await self._receive(self._seq_queue, max(0.0, pending[oldest][2] - loop.time()),
+                                          "pipelined download response")
+            except TimeoutError:
+                pkt_offset, attempt, _ = pending.pop(oldest)
+                if attempt >= 2:
+                    raise
+                print(f"\n  Packet {pkt_offset // CHUNK_SIZE} (offset {pkt_offset}) timed out, retrying...")
+                retries.append((pkt_offset, attempt + 1))
+                continue
+
+            _, status, resp_payload = _parse_response(raw)
+            if len(resp_payload) < SEQ_HEADER_LEN or resp_payload[0] not in pending:
+                continue    # late response of a packet already sent again
+            pkt_offset, attempt, _ = pending.pop(resp_payload[0])
+            if status == STATUS_SUCCESS:
+                acked.add(pkt_offset)
+                while self._last_good_offset in acked:
+                    acked.discard(self._last_good_offset)
+                    self._last_good_offset += CHUNK_SIZE
+                packet_num += 1
+                _print_progress(packet_num, total_packets)
+            elif status == STATUS_BUSY:
+                retries.append((pkt_offset, attempt))   # not run, too many responses were waiting
+            elif attempt < 2:
+                print(
+                    f"\n  Packet {pkt_offset // CHUNK_SIZE} (offset {pkt_offset}) failed "
+                    f"({_status_name(status)}), retrying..."
+                )
+                retries.append((pkt_offset, attempt + 1))
+            else:
+                raise RuntimeError(
+                    f"Download failed at byte offset {pkt_offset} "
+                    f"after retry: {_status_name(status)}"
+                )
+
     async def verify_firmware(self, image_size: int) -> None:
         """
         Step 6: Verify the downloaded image with OP_VERIFY_FW_IMAGE (0xF5).
 
         Payload (4 bytes): image_size as uint32 LE.
+        The verification is started as a job (OP_JOB_START), so the device keeps
+        answering while it hashes the image; firmware without jobs answers
+        OPCODE_ERROR and the blocking command is sent instead.
         On success, the device immediately begins BSL flashing and reboots.
         """
         payload = struct.pack("<I", image_size)
-        status, resp_payload = await self._send(OP_VERIFY_FW_IMAGE, payload, timeout=VERIFY_TIMEOUT_S)
+        status, resp_payload = await self._send(OP_JOB_START, bytes([OP_VERIFY_FW_IMAGE]) + payload)
+        if status == STATUS_OPCODE_ERR:
+            status, resp_payload = await self._send(OP_VERIFY_FW_IMAGE, payload, timeout=VERIFY_TIMEOUT_S)
+        elif status == STATUS_SUCCESS:
+            state, status, resp_payload = await self._wait_job(resp_payload[0], VERIFY_TIMEOUT_S)
+            if state == JOB_STATE_ABORTED:
+                raise _VerifyFailedError("Image verification was aborted by the device.")
         if status != STATUS_SUCCESS:
             fail_count = resp_payload[0] if resp_payload and resp_payload != b'\0x00' else "?"
             raise _VerifyFailedError(
@@ -730,11 +915,11 @@ async def _find_device(device_name: str) -> "tuple[BLEDevice | str, bool]":
 
 # ── Progress bar ──────────────────────────────────────────────────────────────
 
-def _print_progress(done: int, total: int, width: int = 40) -> None:
+def _print_progress(done: int, total: int, width: int = 40, unit: str = "packets") -> None:
     pct = done / total
     filled = int(width * pct)
     bar = "█" * filled + "░" * (width - filled)
-    print(f"\r  [{bar}] {pct * 100:5.1f}%  {done}/{total} packets", end="", flush=True)
+    print(f"\r  [{bar}] {pct * 100:5.1f}%  {done}/{total} {unit}", end="", flush=True)
 
 
 # ── Main OTA flow ─────────────────────────────────────────────────────────────
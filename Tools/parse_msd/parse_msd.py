@@ -13,9 +13,20 @@ MSD layout (24 bytes, LEN_BLE_MSD_MAX = 24):
   [6]     Therm Out      10 mV / LSB
   [7]     Therm Offset   10 mV / LSB
   [8]     GPIO flags lo  (bits 0-7)
-  [9]     GPIO flags hi  (bits 8-13)
-  [10-22] BLE ID         (variable, up to 13 bytes)
+  [9]     GPIO flags hi  (bits 8-13, bit 14 WPT active, bit 15 WPT paused)
+  [10-13] BLE ID         (4 bytes)
+  [14]    Layout version (0 = no status layout, bytes 10-22 are the BLE ID)
   [23]    HW Version     (raw byte; current firmware = 21)
+
+Status layout, version 1 (MSD_IDX_xxx in app_mode_ble_active.h):
+  [15]    Therapy        bits 0-3 state mode, bit 4 session active,
+                         bit 5 scheduled therapy, bit 6 VNSB enabled
+  [16]    Battery A      10 mV / LSB above 2000 mV
+  [17]    Battery B      10 mV / LSB above 2000 mV
+  [18-19] Impedance      ohm, little-endian, last impedance test since reset
+  [20]    Temperature    0.25 °C / LSB above 20 °C, 0xFF = thermistor unpowered
+  [21]    Fault flags    (see FAULT_BITS)
+  [22]    Change count   incremented every time the firmware changes the MSD
 """
 
 import math
@@ -24,6 +35,14 @@ import textwrap
 
 LEN_MSD = 24
 
+MSD_LAYOUT_VERSION = 1
+MSD_IDX_BLE_ID = 10
+MSD_IDX_LAYOUT_VERSION = 14
+MSD_BATT_BASE_MV = 2000
+MSD_TEMP_BASE_C = 20.0
+MSD_TEMP_INVALID = 0xFF
+LEN_BLE_ID = 4
+
 # ── Thermistor temperature calculation ───────────────────────────────────────
 # Mirrors app_mode_wpt_calc_temperature() in app_mode_wpt.c
 #
@@ -84,8 +103,129 @@ GPIO_BITS = [
     (11, "ECG_RR_SDNn",   True,  "ECG resp-rate IC shutdown (active-low enable)"),
     (12, "TEMP_EN",       False, "Temperature measurement enabled"),
     (13, "IMP_EN",        False, "Impedance measurement enabled"),
+    (14, "WPT_ACTIVE",    False, "WPT charging state (charging or paused)"),
+    (15, "WPT_PAUSED",    False, "WPT charging paused"),
+]
+
+# (bit_index, name, description) of the fault flags, MSD_FAULT_xxx in firmware
+FAULT_BITS = [
+    (0, "SHORT_CIRCUIT", "Last impedance test found a short circuit"),
+    (1, "HIGH_IMPED",    "Last impedance test found a high impedance"),
+    (2, "BATT_ER",       "Battery at the elective replacement level"),
+    (3, "CHG1_OVP",      "Charger 1 over-voltage error"),
+    (4, "CHG2_OVP",      "Charger 2 over-voltage error"),
+    (5, "VRECT_OVP",     "Wireless rectifier over-voltage"),
+    (6, "OVER_TEMP",     "Temperature above the WPT pause threshold"),
+    (7, "WPT_PAUSED",    "WPT charging paused"),
 ]
 
+# Low nibble of the firmware state (STATE_ACT_MODE_xxx)
+STATE_MODES = {
+    0x0: "ACT",
+    0x1: "BLE_ACT",
+    0x2: "BLE_CONN",
+    0x3: "THERAPY_SESSION",
+    0x4: "IMPED_TEST",
+    0x5: "BATT_TEST",
+    0x6: "OAD",
+    0x7: "BSL",
+    0x8: "DVT",
+    0x9: "WPT_HIGH",
+    0xA: "WPT_PAUSED",
+}
+
+
+# ── Encode / decode ──────────────────────────────────────────────────────────
+# decode_msd() returns the values in engineering units, encode_msd() quantises
+# them the same way as the firmware, so encode_msd(decode_msd(msd)) == msd.
+
+def decode_msd(data: bytes) -> dict:
+    """Decode a 24-byte MSD into a dict of values in engineering units."""
+    if len(data) != LEN_MSD:
+        raise ValueError(f"MSD must be {LEN_MSD} bytes, got {len(data)}")
+
+    fields = {
+        "dvdd_mv":       data[0] * 100,
+        "batt_a_mv":     data[1] * 100,
+        "batt_b_mv":     data[2] * 100,
+        "imp_a_mv":      data[3] * 10,
+        "imp_b_mv":      data[4] * 10,
+        "therm_ref_mv":  data[5] * 10,
+        "therm_out_mv":  data[6] * 10,
+        "therm_ofst_mv": data[7] * 10,
+        "gpio":          data[8] | (data[9] << 8),
+        "layout":        data[MSD_IDX_LAYOUT_VERSION],
+        "hw_version":    data[23],
+    }
+
+    if fields["layout"] == 0:
+        fields["ble_id"] = bytes(data[MSD_IDX_BLE_ID:23])
+        return fields
+
+    fields["ble_id"] = bytes(data[MSD_IDX_BLE_ID:MSD_IDX_BLE_ID + LEN_BLE_ID])
+    therapy = data[15]
+    temp = data[20]
+    fields.update({
+        "mode":              therapy & 0x0F,
+        "therapy_active":    bool(therapy & 0x10),
+        "therapy_scheduled": bool(therapy & 0x20),
+        "vnsb":              bool(therapy & 0x40),
+        "batt_a_fine_mv":    MSD_BATT_BASE_MV + data[16] * 10,
+        "batt_b_fine_mv":    MSD_BATT_BASE_MV + data[17] * 10,
+        "impedance_ohm":     data[18] | (data[19] << 8),
+        "temperature_c":     None if temp == MSD_TEMP_INVALID else MSD_TEMP_BASE_C + temp * 0.25,
+        "faults":            data[21],
+        "change_count":      data[22],
+    })
+    return fields
+
+
+def _clamp(value, lo, hi):
+    return max(lo, min(hi, value))
+
+
+def encode_msd(fields: dict) -> bytes:
+    """Encode a dict as returned by decode_msd() into a 24-byte MSD."""
+    msd = bytearray(LEN_MSD)
+    msd[0] = _clamp(int(fields["dvdd_mv"]) // 100, 0, 0xFF)
+    msd[1] = _clamp(int(fields["batt_a_mv"]) // 100, 0, 0xFF)
+    msd[2] = _clamp(int(fields["batt_b_mv"]) // 100, 0, 0xFF)
+    msd[3] = _clamp(int(fields["imp_a_mv"]) // 10, 0, 0xFF)
+    msd[4] = _clamp(int(fields["imp_b_mv"]) // 10, 0, 0xFF)
+    msd[5] = _clamp(int(fields["therm_ref_mv"]) // 10, 0, 0xFF)
+    msd[6] = _clamp(int(fields["therm_out_mv"]) // 10, 0, 0xFF)
+    msd[7] = _clamp(int(fields["therm_ofst_mv"]) // 10, 0, 0xFF)
+    msd[8] = fields["gpio"] & 0xFF
+    msd[9] = (fields["gpio"] >> 8) & 0xFF
+    msd[23] = fields["hw_version"]
+
+    layout = fields.get("layout", MSD_LAYOUT_VERSION)
+    if layout == 0:
+        ble_id = bytes(fields["ble_id"])[:23 - MSD_IDX_BLE_ID]
+        msd[MSD_IDX_BLE_ID:MSD_IDX_BLE_ID + len(ble_id)] = ble_id
+        return bytes(msd)
+
+    ble_id = bytes(fields["ble_id"])[:LEN_BLE_ID]
+    msd[MSD_IDX_BLE_ID:MSD_IDX_BLE_ID + len(ble_id)] = ble_id
+    msd[MSD_IDX_LAYOUT_VERSION] = layout
+    msd[15] = ((fields["mode"] & 0x0F)
+               | (0x10 if fields["therapy_active"] else 0)
+               | (0x20 if fields["therapy_scheduled"] else 0)
+               | (0x40 if fields["vnsb"] else 0))
+    msd[16] = _clamp((int(fields["batt_a_fine_mv"]) - MSD_BATT_BASE_MV) // 10, 0, 0xFF)
+    msd[17] = _clamp((int(fields["batt_b_fine_mv"]) - MSD_BATT_BASE_MV) // 10, 0, 0xFF)
+    imp = _clamp(int(fields["impedance_ohm"]), 0, 0xFFFF)
+    msd[18] = imp & 0xFF
+    msd[19] = imp >> 8
+    temp_c = fields["temperature_c"]
+    if temp_c is None or temp_c < MSD_TEMP_BASE_C:
+        msd[20] = MSD_TEMP_INVALID
+    else:
+        msd[20] = _clamp(int((temp_c - MSD_TEMP_BASE_C) * 4.0 + 0.5), 0, MSD_TEMP_INVALID - 1)
+    msd[21] = fields["faults"] & 0xFF
+    msd[22] = fields["change_count"] & 0xFF
+    return bytes(msd)
+
 
 def parse_msd(data: bytes) -> None:
     n = len(data)
@@ -145,7 +285,7 @@ def parse_msd(data: bytes) -> None:
             print(f"      → Temperature    : -- (thermistor unpowered or invalid voltages)")
 
     # ── GPIO flag bits ───────────────────────────────────────────
-    print("\n  ── GPIO Flags  (bytes 8-9, 14 bits) ─────────────────")
+    print("\n  ── GPIO Flags  (bytes 8-9, 16 bits) ─────────────────")
 
     gpio_lo = byte(8, 0)
     gpio_hi = byte(9, 0)
@@ -160,9 +300,13 @@ def parse_msd(data: bytes) -> None:
         al_tag    = " (active-low)" if active_low else ""
         print(f"  bit {bit_idx:>2}  {name:<18}{al_tag:<14}  raw={raw}  →  {indicator:<8}  {desc}")
 
+    layout = byte(MSD_IDX_LAYOUT_VERSION, 0)
+
     # ── BLE ID ──────────────────────────────────────────────────
     if n > 10:
         ble_id_end = min(n - 1, 23)   # byte 23 reserved for HW_VERSION
+        if layout != 0:
+            ble_id_end = min(ble_id_end, MSD_IDX_BLE_ID + LEN_BLE_ID)
         ble_id = data[10:ble_id_end]
         if ble_id:
             print(f"\n  ── BLE ID  (bytes 10-{ble_id_end - 1}) ─────────────────────────────")
@@ -171,6 +315,29 @@ def parse_msd(data: bytes) -> None:
             print(f"  hex   : {hex_str}")
             print(f"  ascii : {ascii_str}")
 
+    # ── Status layout ───────────────────────────────────────────
+    if layout != 0 and n == LEN_MSD:
+        print(f"\n  ── Status  (bytes 14-22, layout version {layout}) ────────────")
+        if layout > MSD_LAYOUT_VERSION:
+            print(f"  [!] Newer layout than this parser ({MSD_LAYOUT_VERSION}), decoding as version {MSD_LAYOUT_VERSION}")
+        f = decode_msd(data)
+        mode = STATE_MODES.get(f["mode"], f"0x{f['mode']:x}")
+        print(f"  [15] Mode            : {mode}")
+        print(f"       Therapy         : {'ACTIVE' if f['therapy_active'] else 'off'}"
+              f"  scheduled={'yes' if f['therapy_scheduled'] else 'no'}"
+              f"  VNSB={'yes' if f['vnsb'] else 'no'}")
+        print(f"  [16] Battery A       : {f['batt_a_fine_mv']:4d} mV" + ("  (absent / below)" if data[16] == 0 else ""))
+        print(f"  [17] Battery B       : {f['batt_b_fine_mv']:4d} mV" + ("  (absent / below)" if data[17] == 0 else ""))
+        imp = f["impedance_ohm"]
+        print(f"  [18] Impedance       : " + ("-- (not measured since reset)" if imp == 0 else f"{imp} Ω"))
+        temp_c = f["temperature_c"]
+        print(f"  [20] Temperature     : " + ("-- (thermistor unpowered)" if temp_c is None else f"{temp_c:.2f} °C"))
+        print(f"  [21] Faults          : 0x{f['faults']:02x}")
+        for bit_idx, name, desc in FAULT_BITS:
+            if f["faults"] & (1 << bit_idx):
+                print(f"       bit {bit_idx}  {name:<14}  {desc}")
+        print(f"  [22] Change count    : {f['change_count']}")
+
     # ── HW Version ──────────────────────────────────────────────
     hw = byte(23)
     if hw is not None:
@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""
+Round-trip tests of the MSD encoder / decoder in parse_msd.py.
+
+Run: python3 -m unittest test_parse_msd   (from Tools/parse_msd)
+"""
+
+import random
+import unittest
+
+from parse_msd import LEN_MSD, MSD_LAYOUT_VERSION, decode_msd, encode_msd
+
+
+def _status_fields(**overrides):
+    fields = {
+        "dvdd_mv": 1800, "batt_a_mv": 3900, "batt_b_mv": 3800,
+        "imp_a_mv": 120, "imp_b_mv": 110,
+        "therm_ref_mv": 1800, "therm_out_mv": 1200, "therm_ofst_mv": 100,
+        "gpio": 0x4ABC, "ble_id": b"\x12\x34\x56\x78", "hw_version": 21,
+        "layout": MSD_LAYOUT_VERSION,
+        "mode": 0x9, "therapy_active": False, "therapy_scheduled": True, "vnsb": False,
+        "batt_a_fine_mv": 3970, "batt_b_fine_mv": 3850,
+        "impedance_ohm": 1234, "temperature_c": 37.25,
+        "faults": 0x24, "change_count": 7,
+    }
+    fields.update(overrides)
+    return fields
+
+
+class MsdRoundTripTest(unittest.TestCase):
+
+    def test_bytes_round_trip(self):
+        rng = random.Random(48)
+        for _ in range(2000):
+            msd = bytearray(rng.randrange(256) for _ in range(LEN_MSD))
+            msd[14] = MSD_LAYOUT_VERSION
+            msd[15] &= 0x7F     # bit 7 of the therapy byte is reserved
+            self.assertEqual(encode_msd(decode_msd(bytes(msd))), bytes(msd))
+
+    def test_legacy_bytes_round_trip(self):
+        rng = random.Random(0)
+        for _ in range(200):
+            msd = bytearray(rng.randrange(256) for _ in range(LEN_MSD))
+            msd[14] = 0
+            self.assertEqual(encode_msd(decode_msd(bytes(msd))), bytes(msd))
+
+    def test_fields_round_trip(self):
+        fields = _status_fields()
+        decoded = decode_msd(encode_msd(fields))
+        for key, value in fields.items():
+            self.assertEqual(decoded[key], value, key)
+
+    def test_quantisation(self):
+        decoded = decode_msd(encode_msd(_status_fields(batt_a_fine_mv=3977, temperature_c=36.9)))
+        self.assertEqual(decoded["batt_a_fine_mv"], 3970)
+        self.assertEqual(decoded["temperature_c"], 37.0)
+
+    def test_clamping(self):
+        decoded = decode_msd(encode_msd(_status_fields(
+            batt_a_fine_mv=1500, batt_b_fine_mv=9000, impedance_ohm=100000, temperature_c=None)))
+        self.assertEqual(decoded["batt_a_fine_mv"], 2000)
+        self.assertEqual(decoded["batt_b_fine_mv"], 2000 + 255 * 10)
+        self.assertEqual(decoded["impedance_ohm"], 0xFFFF)
+        self.assertIsNone(decoded["temperature_c"])
+
+    def test_layout_offsets(self):
+        msd = encode_msd(_status_fields())
+        self.assertEqual(msd[10:14], b"\x12\x34\x56\x78")
+        self.assertEqual(msd[14], MSD_LAYOUT_VERSION)
+        self.assertEqual(msd[18:20], (1234).to_bytes(2, "little"))
+        self.assertEqual(msd[20], int((37.25 - 20.0) * 4))
+        self.assertEqual(msd[23], 21)
+
+    def test_wrong_length(self):
+        with self.assertRaises(ValueError):
+            decode_msd(bytes(LEN_MSD - 1))
+
+
+if __name__ == "__main__":
+    unittest.main()